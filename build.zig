@@ -159,12 +159,509 @@ pub fn build(b: *std.Build) void {
     // Link with runtime library
     extended_test.linkLibrary(runtime_lib);
 
+    // Lock-free queue and epoch reclamation stress test
+    const epoch_test = b.addExecutable(.{
+        .name = "epoch_queue_stress_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    epoch_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/epoch_queue_stress_test.c",
+            "src/runtime/safety/goo_concurrency.c",
+            "src/runtime/safety/goo_epoch.c",
+            "src/runtime/memory/goo_concurrent_pool.c",
+        },
+        .flags = c_flags,
+    });
+
+    epoch_test.addIncludePath(.{ .cwd_relative = "include" });
+    epoch_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    epoch_test.addIncludePath(.{ .cwd_relative = "src/runtime/memory" });
+    epoch_test.linkLibC();
+
+    // Typed allocation test: size-class pools and their malloc fallback
+    const typed_alloc_test = b.addExecutable(.{
+        .name = "typed_alloc_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    typed_alloc_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/typed_alloc_test.c",
+            "src/runtime/memory/goo_typed_pool.c",
+            "src/runtime/memory/goo_concurrent_pool.c",
+        },
+        .flags = c_flags,
+    });
+
+    typed_alloc_test.addIncludePath(.{ .cwd_relative = "include" });
+    typed_alloc_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    typed_alloc_test.addIncludePath(.{ .cwd_relative = "src/runtime/memory" });
+    typed_alloc_test.linkLibC();
+
+    // Memory statistics test: per-thread counters and breakdowns
+    const memory_stats_test = b.addExecutable(.{
+        .name = "memory_stats_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    memory_stats_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/memory_stats_test.c",
+            "src/runtime/memory/goo_memory_stats.c",
+        },
+        .flags = c_flags,
+    });
+
+    memory_stats_test.addIncludePath(.{ .cwd_relative = "include" });
+    memory_stats_test.linkLibC();
+
+    // Heap profiler test; exports its symbols so folded stacks can name them
+    const heap_profile_test = b.addExecutable(.{
+        .name = "heap_profile_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    heap_profile_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/heap_profile_test.c",
+            "src/runtime/memory/goo_heap_profile.c",
+        },
+        .flags = c_flags,
+    });
+
+    heap_profile_test.addIncludePath(.{ .cwd_relative = "include" });
+    heap_profile_test.rdynamic = true;
+    heap_profile_test.linkSystemLibrary("m");
+    heap_profile_test.linkLibC();
+
+    // Scope cleanup stack test; goo_free is stubbed in the test
+    const scope_stack_test = b.addExecutable(.{
+        .name = "scope_stack_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    scope_stack_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/scope_stack_test.c",
+            "src/runtime/scope/scope.c",
+        },
+        .flags = c_flags,
+    });
+
+    scope_stack_test.addIncludePath(.{ .cwd_relative = "src/include" });
+    scope_stack_test.linkLibC();
+
+    // GooString and intern table test; goo_alloc is stubbed in the test
+    const lang_string_test = b.addExecutable(.{
+        .name = "lang_string_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    lang_string_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/lang_string_test.c",
+            "src/runtime/lang/goo_lang_memory.c",
+        },
+        .flags = c_flags,
+    });
+
+    lang_string_test.addIncludePath(.{ .cwd_relative = "src/include" });
+    addByteScan(b, lang_string_test);
+    lang_string_test.linkLibC();
+
+    // Task groups and futures on a mock two-worker goroutine pool
+    const task_group_test = b.addExecutable(.{
+        .name = "task_group_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    task_group_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/task_group_test.c",
+            "tests/runtime/goroutine_pool_mock.c",
+            "src/runtime/goo_task_group.c",
+        },
+        .flags = c_flags,
+    });
+
+    // The mock goo_runtime.h must shadow include/goo_runtime.h
+    task_group_test.addIncludePath(.{ .cwd_relative = "tests/runtime/mock" });
+    task_group_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    task_group_test.linkLibC();
+
+    // SIMD kernels against the scalar reference; the worker pool is mocked
+    const vectorization_test = b.addExecutable(.{
+        .name = "vectorization_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    vectorization_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/vectorization_test.c",
+            "tests/runtime/parallel_serial_mock.c",
+            "src/runtime/concurrency/goo_vectorization.c",
+        },
+        .flags = c_flags,
+    });
+
+    vectorization_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    vectorization_test.addIncludePath(.{ .cwd_relative = "include" });
+    vectorization_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    vectorization_test.linkLibC();
+
+    // Block loop and vectorized loops on the real worker pool
+    const parallel_chunks_test = b.addExecutable(.{
+        .name = "parallel_chunks_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    parallel_chunks_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/parallel_chunks_test.c",
+            "src/runtime/concurrency/goo_parallel.c",
+            "src/runtime/concurrency/goo_work_distribution.c",
+            "src/runtime/concurrency/goo_adaptive_schedule.c",
+            "src/runtime/concurrency/goo_vectorization.c",
+        },
+        .flags = c_flags,
+    });
+
+    parallel_chunks_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    parallel_chunks_test.addIncludePath(.{ .cwd_relative = "include" });
+    parallel_chunks_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    parallel_chunks_test.linkLibC();
+
+    // Concurrent and nested parallel loops on the real worker pool
+    const parallel_for_test = b.addExecutable(.{
+        .name = "parallel_for_stress_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    parallel_for_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/parallel_for_stress_test.c",
+            "src/runtime/concurrency/goo_parallel.c",
+            "src/runtime/concurrency/goo_work_distribution.c",
+            "src/runtime/concurrency/goo_adaptive_schedule.c",
+        },
+        .flags = c_flags,
+    });
+
+    parallel_for_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    parallel_for_test.addIncludePath(.{ .cwd_relative = "include" });
+    parallel_for_test.linkLibC();
+
+    // Parallel sort, scan, partition and histogram against serial references
+    const parallel_algorithms_test = b.addExecutable(.{
+        .name = "parallel_algorithms_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    parallel_algorithms_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/parallel_algorithms_test.c",
+            "src/runtime/concurrency/goo_parallel_algorithms.c",
+            "src/runtime/concurrency/goo_parallel.c",
+            "src/runtime/concurrency/goo_work_distribution.c",
+            "src/runtime/concurrency/goo_adaptive_schedule.c",
+        },
+        .flags = c_flags,
+    });
+
+    parallel_algorithms_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    parallel_algorithms_test.addIncludePath(.{ .cwd_relative = "include" });
+    parallel_algorithms_test.linkLibC();
+
+    // Adaptive scheduling on simulated loops, then fed by goo_parallel_for
+    const adaptive_schedule_test = b.addExecutable(.{
+        .name = "adaptive_schedule_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    adaptive_schedule_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/adaptive_schedule_test.c",
+            "src/runtime/concurrency/goo_adaptive_schedule.c",
+            "src/runtime/concurrency/goo_parallel.c",
+            "src/runtime/concurrency/goo_work_distribution.c",
+        },
+        .flags = c_flags,
+    });
+
+    adaptive_schedule_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    adaptive_schedule_test.addIncludePath(.{ .cwd_relative = "include" });
+    adaptive_schedule_test.linkSystemLibrary("m");
+    adaptive_schedule_test.linkLibC();
+
+    // Zig @Vector kernels against the C scalar kernels
+    const zig_vectorization_test = b.addTest(.{
+        .root_source_file = b.path("src/runtime/concurrency/zig/vectorization.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+
+    zig_vectorization_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/parallel_serial_mock.c",
+            "src/runtime/concurrency/goo_vectorization.c",
+        },
+        .flags = c_flags,
+    });
+
+    zig_vectorization_test.addIncludePath(.{ .cwd_relative = "src/runtime/concurrency" });
+    zig_vectorization_test.addIncludePath(.{ .cwd_relative = "include" });
+    zig_vectorization_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    zig_vectorization_test.linkLibC();
+
+    // Slab allocator unit tests (cross-thread frees, span reuse, madvise)
+    const slab_allocator_test = b.addTest(.{
+        .root_source_file = b.path("src/runtime/memory/goo_slab_allocator.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+
+    slab_allocator_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "src/runtime/memory/goo_heap_profile.c",
+        },
+        .flags = c_flags,
+    });
+
+    slab_allocator_test.addIncludePath(.{ .cwd_relative = "include" });
+    slab_allocator_test.linkLibC();
+
+    // Virtual range unit tests (commit on demand, discard)
+    const virtual_memory_test = b.addTest(.{
+        .root_source_file = b.path("src/runtime/memory/goo_virtual_memory.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+
+    virtual_memory_test.linkLibC();
+
+    // Region allocator unit tests (ownership of mapped and malloc'd regions)
+    const region_allocator_test = b.addTest(.{
+        .root_source_file = b.path("src/runtime/memory/goo_region_allocator.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+
+    region_allocator_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "src/runtime/memory/goo_heap_profile.c",
+        },
+        .flags = c_flags,
+    });
+
+    region_allocator_test.addIncludePath(.{ .cwd_relative = "include" });
+    region_allocator_test.linkLibC();
+
+    // Zig allocators (core, slab, region) for C tests that need the real ones
+    const region_allocator_lib = b.addStaticLibrary(.{
+        .name = "goo_region_allocator",
+        .root_source_file = b.path("src/runtime/memory/goo_region_allocator.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+
+    region_allocator_lib.linkLibC();
+
+    // Goroutine regions: promotion out of a region that is then reset
+    const task_region_test = b.addExecutable(.{
+        .name = "task_region_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    task_region_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/task_region_test.c",
+            "src/runtime/goo_task_region.c",
+            "src/runtime/memory/goo_heap_profile.c",
+        },
+        .flags = c_flags,
+    });
+
+    task_region_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    task_region_test.addIncludePath(.{ .cwd_relative = "include" });
+    task_region_test.linkLibrary(region_allocator_lib);
+    task_region_test.linkLibC();
+
+    // Preemption monitor against a hot loop; the thread pool handoff is stubbed
+    const preempt_test = b.addExecutable(.{
+        .name = "preempt_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    preempt_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/runtime/preempt_test.c",
+            "src/runtime/goo_preempt.c",
+        },
+        .flags = c_flags,
+    });
+
+    // The mock goo_runtime.h must shadow include/goo_runtime.h
+    preempt_test.addIncludePath(.{ .cwd_relative = "tests/runtime/mock" });
+    preempt_test.addIncludePath(.{ .cwd_relative = "src/runtime" });
+    preempt_test.linkLibC();
+
+    // Parallel backend against the serial one; codegen.c is mocked
+    const parallel_codegen_test = b.addExecutable(.{
+        .name = "parallel_codegen_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    parallel_codegen_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/backend/parallel_codegen_test.c",
+            "src/compiler/backend/codegen_parallel.c",
+            "src/compiler/backend/passes/pass_manager.c",
+            "src/compiler/backend/passes/channel_opt.c",
+        },
+        .flags = c_flags,
+    });
+
+    parallel_codegen_test.addIncludePath(.{ .cwd_relative = "tests/backend/mock" });
+    parallel_codegen_test.addIncludePath(.{ .cwd_relative = "src/compiler/backend" });
+    parallel_codegen_test.addIncludePath(.{ .cwd_relative = "include" });
+    parallel_codegen_test.addIncludePath(.{ .cwd_relative = "/usr/lib/llvm-14/include" });
+    parallel_codegen_test.addLibraryPath(.{ .cwd_relative = "/usr/lib/llvm-14/lib" });
+    parallel_codegen_test.linkSystemLibrary("LLVM-14");
+    parallel_codegen_test.linkLibC();
+
+    // Escape analysis through allocation placement; codegen.c is mocked
+    const escape_placement_test = b.addExecutable(.{
+        .name = "escape_placement_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    escape_placement_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/backend/escape_placement_test.c",
+            "src/compiler/backend/codegen_memory.c",
+            "src/compiler/optimizer/escape_analysis.c",
+        },
+        .flags = c_flags,
+    });
+
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "tests/backend/mock" });
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "src/compiler/backend" });
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "src/compiler/optimizer" });
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "include" });
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "src/include" });
+    escape_placement_test.addIncludePath(.{ .cwd_relative = "/usr/lib/llvm-14/include" });
+    escape_placement_test.addLibraryPath(.{ .cwd_relative = "/usr/lib/llvm-14/lib" });
+    escape_placement_test.linkSystemLibrary("LLVM-14");
+    escape_placement_test.linkLibC();
+
+    // Safepoint polls in emitted and compiled loops; codegen.c is mocked
+    const safepoint_codegen_test = b.addExecutable(.{
+        .name = "safepoint_codegen_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    safepoint_codegen_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/backend/safepoint_codegen_test.c",
+            "src/compiler/backend/codegen_safepoint.c",
+        },
+        .flags = c_flags,
+    });
+
+    safepoint_codegen_test.addIncludePath(.{ .cwd_relative = "tests/backend/mock" });
+    safepoint_codegen_test.addIncludePath(.{ .cwd_relative = "src/compiler/backend" });
+    safepoint_codegen_test.addIncludePath(.{ .cwd_relative = "include" });
+    safepoint_codegen_test.addIncludePath(.{ .cwd_relative = "src/include" });
+    safepoint_codegen_test.addIncludePath(.{ .cwd_relative = "/usr/lib/llvm-14/include" });
+    safepoint_codegen_test.addLibraryPath(.{ .cwd_relative = "/usr/lib/llvm-14/lib" });
+    safepoint_codegen_test.linkSystemLibrary("LLVM-14");
+    safepoint_codegen_test.linkLibC();
+
+    const simd_codegen_test = b.addExecutable(.{
+        .name = "simd_codegen_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    simd_codegen_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/backend/simd_codegen_test.c",
+            "src/compiler/backend/codegen_simd.c",
+        },
+        .flags = c_flags,
+    });
+
+    simd_codegen_test.addIncludePath(.{ .cwd_relative = "tests/backend/mock" });
+    simd_codegen_test.addIncludePath(.{ .cwd_relative = "src/compiler/backend" });
+    simd_codegen_test.addIncludePath(.{ .cwd_relative = "include" });
+    simd_codegen_test.addIncludePath(.{ .cwd_relative = "src/include" });
+    simd_codegen_test.addIncludePath(.{ .cwd_relative = "/usr/lib/llvm-14/include" });
+    simd_codegen_test.addLibraryPath(.{ .cwd_relative = "/usr/lib/llvm-14/lib" });
+    simd_codegen_test.linkSystemLibrary("LLVM-14");
+    simd_codegen_test.linkSystemLibrary("m");
+    simd_codegen_test.linkLibC();
+
+    const pass_manager_test = b.addExecutable(.{
+        .name = "pass_manager_test",
+        .target = target,
+        .optimize = optimize,
+    });
+
+    pass_manager_test.addCSourceFiles(.{
+        .files = &[_][]const u8{
+            "tests/backend/pass_manager_test.c",
+            "src/compiler/backend/passes/pass_manager.c",
+            "src/compiler/backend/passes/channel_opt.c",
+        },
+        .flags = c_flags,
+    });
+
+    pass_manager_test.addIncludePath(.{ .cwd_relative = "src/compiler/backend" });
+    pass_manager_test.addIncludePath(.{ .cwd_relative = "/usr/lib/llvm-14/include" });
+    pass_manager_test.addLibraryPath(.{ .cwd_relative = "/usr/lib/llvm-14/lib" });
+    pass_manager_test.linkSystemLibrary("LLVM-14");
+    pass_manager_test.linkLibC();
+
     // =======================================
     // Install Runtime Artifacts
     // =======================================
     b.installArtifact(runtime_lib);
     b.installArtifact(test_exe);
     b.installArtifact(extended_test);
+    b.installArtifact(epoch_test);
+    b.installArtifact(typed_alloc_test);
+    b.installArtifact(memory_stats_test);
+    b.installArtifact(heap_profile_test);
+    b.installArtifact(vectorization_test);
+    b.installArtifact(parallel_chunks_test);
+    b.installArtifact(parallel_for_test);
+    b.installArtifact(parallel_algorithms_test);
+    b.installArtifact(adaptive_schedule_test);
+    b.installArtifact(parallel_codegen_test);
+    b.installArtifact(escape_placement_test);
+    b.installArtifact(preempt_test);
+    b.installArtifact(safepoint_codegen_test);
+    b.installArtifact(simd_codegen_test);
+    b.installArtifact(pass_manager_test);
 
     // =======================================
     // Install Diagnostics Artifacts
@@ -259,6 +756,140 @@ pub fn build(b: *std.Build) void {
     const run_extended_step = b.step("run-extended", "Run the extended memory test");
     run_extended_step.dependOn(&run_extended_cmd.step);
 
+    // Epoch stress test run step
+    const run_epoch_cmd = b.addRunArtifact(epoch_test);
+    run_epoch_cmd.step.dependOn(b.getInstallStep());
+    const run_epoch_step = b.step("test-epoch", "Run the lock-free queue and epoch stress test");
+    run_epoch_step.dependOn(&run_epoch_cmd.step);
+
+    // Typed allocation test run step
+    const run_typed_alloc_cmd = b.addRunArtifact(typed_alloc_test);
+    run_typed_alloc_cmd.step.dependOn(b.getInstallStep());
+    const run_typed_alloc_step = b.step("test-typed-alloc", "Run the typed allocation pool tests");
+    run_typed_alloc_step.dependOn(&run_typed_alloc_cmd.step);
+
+    // Memory statistics test run step
+    const run_memory_stats_cmd = b.addRunArtifact(memory_stats_test);
+    run_memory_stats_cmd.step.dependOn(b.getInstallStep());
+    const run_memory_stats_step = b.step("test-memory-stats", "Run the per-thread memory statistics tests");
+    run_memory_stats_step.dependOn(&run_memory_stats_cmd.step);
+
+    // Heap profiler test run step
+    const run_heap_profile_cmd = b.addRunArtifact(heap_profile_test);
+    run_heap_profile_cmd.step.dependOn(b.getInstallStep());
+    const run_heap_profile_step = b.step("test-heap-profile", "Run the sampling heap profiler tests");
+    run_heap_profile_step.dependOn(&run_heap_profile_cmd.step);
+
+    // Scope stack test run step
+    const run_scope_stack_cmd = b.addRunArtifact(scope_stack_test);
+    run_scope_stack_cmd.step.dependOn(b.getInstallStep());
+    const run_scope_stack_step = b.step("test-scope-stack", "Run the scope cleanup stack tests");
+    run_scope_stack_step.dependOn(&run_scope_stack_cmd.step);
+
+    // GooString test run step
+    const run_lang_string_cmd = b.addRunArtifact(lang_string_test);
+    run_lang_string_cmd.step.dependOn(b.getInstallStep());
+    const run_lang_string_step = b.step("test-lang-string", "Run the GooString and intern table tests");
+    run_lang_string_step.dependOn(&run_lang_string_cmd.step);
+
+    // Task group test run step
+    const run_task_group_cmd = b.addRunArtifact(task_group_test);
+    run_task_group_cmd.step.dependOn(b.getInstallStep());
+    const run_task_group_step = b.step("test-task-group", "Run the task group and future tests");
+    run_task_group_step.dependOn(&run_task_group_cmd.step);
+
+    // Vectorization test run step
+    const run_vectorization_cmd = b.addRunArtifact(vectorization_test);
+    run_vectorization_cmd.step.dependOn(b.getInstallStep());
+    const run_vectorization_step = b.step("test-vectorization", "Compare the SIMD kernels against scalar");
+    run_vectorization_step.dependOn(&run_vectorization_cmd.step);
+
+    // Parallel block loop test run step
+    const run_parallel_chunks_cmd = b.addRunArtifact(parallel_chunks_test);
+    run_parallel_chunks_cmd.step.dependOn(b.getInstallStep());
+    const run_parallel_chunks_step = b.step("test-parallel-chunks", "Run the parallel block loop tests");
+    run_parallel_chunks_step.dependOn(&run_parallel_chunks_cmd.step);
+
+    // Parallel loop stress test run step
+    const run_parallel_for_cmd = b.addRunArtifact(parallel_for_test);
+    run_parallel_for_cmd.step.dependOn(b.getInstallStep());
+    const run_parallel_for_step = b.step("test-parallel-for", "Stress concurrent and nested parallel loops");
+    run_parallel_for_step.dependOn(&run_parallel_for_cmd.step);
+
+    // Parallel algorithms test run step
+    const run_parallel_algorithms_cmd = b.addRunArtifact(parallel_algorithms_test);
+    run_parallel_algorithms_cmd.step.dependOn(b.getInstallStep());
+    const run_parallel_algorithms_step = b.step("test-parallel-algorithms", "Compare the parallel algorithms against serial ones");
+    run_parallel_algorithms_step.dependOn(&run_parallel_algorithms_cmd.step);
+
+    // Adaptive scheduling test run step
+    const run_adaptive_schedule_cmd = b.addRunArtifact(adaptive_schedule_test);
+    run_adaptive_schedule_cmd.step.dependOn(b.getInstallStep());
+    const run_adaptive_schedule_step = b.step("test-adaptive-schedule", "Check how loops learn their schedule and chunk size");
+    run_adaptive_schedule_step.dependOn(&run_adaptive_schedule_cmd.step);
+
+    // Zig vectorization test run step
+    const run_zig_vectorization_cmd = b.addRunArtifact(zig_vectorization_test);
+    const run_zig_vectorization_step = b.step("test-zig-vectorization", "Compare the Zig SIMD kernels against the C scalar kernels");
+    run_zig_vectorization_step.dependOn(&run_zig_vectorization_cmd.step);
+
+    // Slab allocator test run step
+    const run_slab_allocator_cmd = b.addRunArtifact(slab_allocator_test);
+    const run_slab_allocator_step = b.step("test-slab-allocator", "Run the slab allocator unit tests");
+    run_slab_allocator_step.dependOn(&run_slab_allocator_cmd.step);
+
+    // Virtual range test run step
+    const run_virtual_memory_cmd = b.addRunArtifact(virtual_memory_test);
+    const run_virtual_memory_step = b.step("test-virtual-memory", "Run the reserved virtual range unit tests");
+    run_virtual_memory_step.dependOn(&run_virtual_memory_cmd.step);
+
+    // Region allocator test run step
+    const run_region_allocator_cmd = b.addRunArtifact(region_allocator_test);
+    const run_region_allocator_step = b.step("test-region-allocator", "Run the region allocator unit tests");
+    run_region_allocator_step.dependOn(&run_region_allocator_cmd.step);
+
+    // Goroutine region test run step
+    const run_task_region_cmd = b.addRunArtifact(task_region_test);
+    run_task_region_cmd.step.dependOn(b.getInstallStep());
+    const run_task_region_step = b.step("test-task-region", "Promote values out of goroutine regions");
+    run_task_region_step.dependOn(&run_task_region_cmd.step);
+
+    // Preemption test run step
+    const run_preempt_cmd = b.addRunArtifact(preempt_test);
+    run_preempt_cmd.step.dependOn(b.getInstallStep());
+    const run_preempt_step = b.step("test-preempt", "Check that hot loops are asked to yield");
+    run_preempt_step.dependOn(&run_preempt_cmd.step);
+
+    // Parallel backend test run step
+    const run_parallel_codegen_cmd = b.addRunArtifact(parallel_codegen_test);
+    run_parallel_codegen_cmd.step.dependOn(b.getInstallStep());
+    const run_parallel_codegen_step = b.step("test-parallel-codegen", "Compare parallel and serial backend builds");
+    run_parallel_codegen_step.dependOn(&run_parallel_codegen_cmd.step);
+
+    // Escape placement test run step
+    const run_escape_placement_cmd = b.addRunArtifact(escape_placement_test);
+    run_escape_placement_cmd.step.dependOn(b.getInstallStep());
+    const run_escape_placement_step = b.step("test-escape-placement", "Check stack and arena placement in emitted IR");
+    run_escape_placement_step.dependOn(&run_escape_placement_cmd.step);
+
+    // Safepoint codegen test run step
+    const run_safepoint_codegen_cmd = b.addRunArtifact(safepoint_codegen_test);
+    run_safepoint_codegen_cmd.step.dependOn(b.getInstallStep());
+    const run_safepoint_codegen_step = b.step("test-safepoint-codegen", "Check safepoint polls in emitted and compiled loops");
+    run_safepoint_codegen_step.dependOn(&run_safepoint_codegen_cmd.step);
+
+    // SIMD codegen test run step
+    const run_simd_codegen_cmd = b.addRunArtifact(simd_codegen_test);
+    run_simd_codegen_cmd.step.dependOn(b.getInstallStep());
+    const run_simd_codegen_step = b.step("test-simd-codegen", "Check SIMD lowering in emitted vector IR");
+    run_simd_codegen_step.dependOn(&run_simd_codegen_cmd.step);
+
+    // Pass manager test run step
+    const run_pass_manager_cmd = b.addRunArtifact(pass_manager_test);
+    run_pass_manager_cmd.step.dependOn(b.getInstallStep());
+    const run_pass_manager_step = b.step("test-pass-manager", "Run Goo and LLVM passes through the pass manager pipelines");
+    run_pass_manager_step.dependOn(&run_pass_manager_cmd.step);
+
     // =======================================
     // Run Steps for Diagnostics Examples
     // =======================================
@@ -313,6 +944,7 @@ pub fn build(b: *std.Build) void {
 
     // Add the lexer module to the library
     lexer_lib.root_module.addImport("lexer", lexer_module);
+    addByteScan(b, lexer_lib);
     lexer_lib.linkLibC();
 
     // Lexer test executable
@@ -328,6 +960,7 @@ pub fn build(b: *std.Build) void {
 
     // Add the lexer module to the lexer test
     lexer_test.root_module.addImport("lexer", lexer_module);
+    addByteScan(b, lexer_test);
 
     // =======================================
     // Install Lexer Components
@@ -355,6 +988,7 @@ pub fn build(b: *std.Build) void {
         .optimize = optimize,
     });
     lexer_error_test.root_module.addImport("lexer", lexer_module);
+    addByteScan(b, lexer_error_test);
     b.installArtifact(lexer_error_test);
 
     // Run step for lexer error handling test
@@ -374,6 +1008,7 @@ pub fn build(b: *std.Build) void {
         .optimize = optimize,
     });
     lexer_edge_test.root_module.addImport("lexer", lexer_module);
+    addByteScan(b, lexer_edge_test);
     b.installArtifact(lexer_edge_test);
 
     // Run step for lexer edge case test
@@ -382,11 +1017,25 @@ pub fn build(b: *std.Build) void {
     const run_lexer_edge_step = b.step("test-lexer-edge-cases", "Run the lexer edge case tests");
     run_lexer_edge_step.dependOn(&run_lexer_edge_cmd.step);
 
+    // Lexer unit tests (test blocks in lexer.zig and the files it imports)
+    const lexer_unit_tests = b.addTest(.{
+        .root_source_file = b.path("src/compiler/frontend/lexer/zig/lexer.zig"),
+        .target = target,
+        .optimize = optimize,
+    });
+    addByteScan(b, lexer_unit_tests);
+
+    // Run step for lexer unit tests
+    const run_lexer_unit_cmd = b.addRunArtifact(lexer_unit_tests);
+    const run_lexer_unit_step = b.step("test-lexer-unit", "Run the lexer unit tests");
+    run_lexer_unit_step.dependOn(&run_lexer_unit_cmd.step);
+
     // Combined lexer tests step (runs both regular lexer tests and error handling tests)
     const combined_lexer_tests_step = b.step("test-lexer-all", "Run all lexer tests including error handling");
     combined_lexer_tests_step.dependOn(&run_lexer_cmd.step);
     combined_lexer_tests_step.dependOn(&run_lexer_error_cmd.step);
     combined_lexer_tests_step.dependOn(&run_lexer_edge_cmd.step);
+    combined_lexer_tests_step.dependOn(&run_lexer_unit_cmd.step);
 
     // Component-specific build steps
     const lexer_step = b.step("lexer", "Build only the lexer component");
@@ -674,3 +1323,12 @@ pub fn build(b: *std.Build) void {
     const type_checker_diag_test_step = b.step("run-type-checker-diag-test", "Run type checker diagnostics integration test");
     type_checker_diag_test_step.dependOn(&run_type_checker_diag_test.step);
 }
+
+// Byte-class scanning kernels the lexer shares with the runtime's GooString
+fn addByteScan(b: *std.Build, step: *std.Build.Step.Compile) void {
+    step.addCSourceFile(.{
+        .file = b.path("src/runtime/lang/goo_byte_scan.c"),
+        .flags = &.{"-std=c11"},
+    });
+    step.addIncludePath(b.path("src/include"));
+}
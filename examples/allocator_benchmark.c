@@ -0,0 +1,223 @@
+/**
+ * allocator_benchmark.c
+ *
+ * Benchmarks Goo's slab allocator (goo_alloc/goo_free) against glibc
+ * malloc/free on allocation patterns typical of the runtime: channel
+ * messages freed by a different thread, short-lived task objects, and
+ * variable-length strings that grow.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "../src/runtime/memory/goo_allocator.h"
+
+// Benchmark parameters
+#define NUM_THREADS 4
+#define MESSAGES_PER_PRODUCER 2000000
+#define TASK_ROUNDS 20000
+#define TASK_BATCH 256
+#define STRING_OPS 2000000
+#define STRING_SLOTS 4096
+#define RING_SIZE 1024
+
+// Allocator under test
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void *(*realloc)(void *ptr, size_t old_size, size_t new_size);
+    void (*free)(void *ptr, size_t size);
+} BenchAllocator;
+
+static void *libc_alloc(size_t size) { return malloc(size); }
+static void *libc_realloc(void *ptr, size_t old_size, size_t new_size) {
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+static void libc_free(void *ptr, size_t size) { (void)size; free(ptr); }
+
+static const BenchAllocator allocators[] = {
+    { "glibc malloc", libc_alloc, libc_realloc, libc_free },
+    { "goo slab", goo_alloc, goo_realloc, goo_free },
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// ----------------------------------------------------------------------------
+// Channel messages: a producer allocates, a consumer on another thread frees
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    _Atomic(void *) slots[RING_SIZE];
+    const BenchAllocator *allocator;
+    uint64_t seed;
+} MessageRing;
+
+static void *message_producer(void *arg) {
+    MessageRing *ring = arg;
+    uint64_t state = ring->seed;
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+        size_t size = 64 + (next_random(&state) % 193);
+        uint32_t *msg = ring->allocator->alloc(size);
+        msg[0] = (uint32_t)size;
+        _Atomic(void *) *slot = &ring->slots[i % RING_SIZE];
+        while (atomic_load_explicit(slot, memory_order_acquire) != NULL) {
+            // Consumer is behind
+        }
+        atomic_store_explicit(slot, msg, memory_order_release);
+    }
+    return NULL;
+}
+
+static void *message_consumer(void *arg) {
+    MessageRing *ring = arg;
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+        _Atomic(void *) *slot = &ring->slots[i % RING_SIZE];
+        void *msg;
+        while ((msg = atomic_load_explicit(slot, memory_order_acquire)) == NULL) {
+            // Producer is behind
+        }
+        atomic_store_explicit(slot, NULL, memory_order_release);
+        ring->allocator->free(msg, *(uint32_t *)msg);
+    }
+    return NULL;
+}
+
+static double bench_messages(const BenchAllocator *allocator) {
+    MessageRing *rings = calloc(NUM_THREADS / 2, sizeof(MessageRing));
+    pthread_t threads[NUM_THREADS];
+
+    double t0 = now_seconds();
+    for (int p = 0; p < NUM_THREADS / 2; p++) {
+        rings[p].allocator = allocator;
+        rings[p].seed = 0x9E3779B97F4A7C15ull + (uint64_t)p;
+        pthread_create(&threads[2 * p], NULL, message_producer, &rings[p]);
+        pthread_create(&threads[2 * p + 1], NULL, message_consumer, &rings[p]);
+    }
+    for (int t = 0; t < NUM_THREADS; t++) pthread_join(threads[t], NULL);
+    double elapsed = now_seconds() - t0;
+
+    free(rings);
+    return elapsed;
+}
+
+// ----------------------------------------------------------------------------
+// Tasks: each worker allocates a batch of task objects, then frees them
+// ----------------------------------------------------------------------------
+
+static void *task_worker(void *arg) {
+    const BenchAllocator *allocator = arg;
+    void *batch[TASK_BATCH];
+    for (int round = 0; round < TASK_ROUNDS; round++) {
+        for (int i = 0; i < TASK_BATCH; i++) {
+            batch[i] = allocator->alloc(128);
+            memset(batch[i], 0, 32);
+        }
+        for (int i = TASK_BATCH - 1; i >= 0; i--) allocator->free(batch[i], 128);
+    }
+    return NULL;
+}
+
+static double bench_tasks(const BenchAllocator *allocator) {
+    pthread_t threads[NUM_THREADS];
+    double t0 = now_seconds();
+    for (int t = 0; t < NUM_THREADS; t++) {
+        pthread_create(&threads[t], NULL, task_worker, (void *)allocator);
+    }
+    for (int t = 0; t < NUM_THREADS; t++) pthread_join(threads[t], NULL);
+    return now_seconds() - t0;
+}
+
+// ----------------------------------------------------------------------------
+// Strings: random lengths with frequent growth, single thread
+// ----------------------------------------------------------------------------
+
+static double bench_strings(const BenchAllocator *allocator) {
+    char **slots = calloc(STRING_SLOTS, sizeof(char *));
+    size_t *sizes = calloc(STRING_SLOTS, sizeof(size_t));
+    uint64_t state = 0xD1B54A32D192ED03ull;
+
+    double t0 = now_seconds();
+    for (int op = 0; op < STRING_OPS; op++) {
+        uint64_t r = next_random(&state);
+        size_t slot = r % STRING_SLOTS;
+        if (!slots[slot]) {
+            sizes[slot] = 8 + ((r >> 16) % 505);
+            slots[slot] = allocator->alloc(sizes[slot]);
+            memset(slots[slot], 'a', sizes[slot]);
+        } else if ((r >> 32) % 4 == 0 && sizes[slot] < 4096) {
+            size_t grown = sizes[slot] * 2;
+            slots[slot] = allocator->realloc(slots[slot], sizes[slot], grown);
+            memset(slots[slot] + sizes[slot], 'b', grown - sizes[slot]);
+            sizes[slot] = grown;
+        } else {
+            allocator->free(slots[slot], sizes[slot]);
+            slots[slot] = NULL;
+        }
+    }
+    for (size_t i = 0; i < STRING_SLOTS; i++) {
+        if (slots[i]) allocator->free(slots[i], sizes[i]);
+    }
+    double elapsed = now_seconds() - t0;
+
+    free(slots);
+    free(sizes);
+    return elapsed;
+}
+
+// ----------------------------------------------------------------------------
+
+static void report(const char *name, double libc, double slab, double ops) {
+    printf("| %-10s | %11.1f | %11.1f | %6.2fx |\n",
+           name, ops / libc / 1.0e6, ops / slab / 1.0e6, libc / slab);
+}
+
+int main(void) {
+    if (!goo_memory_init()) {
+        printf("Failed to initialize memory subsystem\n");
+        return 1;
+    }
+    goo_set_default_allocator(goo_slab_allocator_get());
+
+    printf("Allocator benchmark (%d threads)\n\n", NUM_THREADS);
+    printf("| workload   | glibc Mop/s |   goo Mop/s | speedup |\n");
+    printf("|------------|-------------|-------------|---------|\n");
+
+    double libc, slab;
+
+    libc = bench_messages(&allocators[0]);
+    slab = bench_messages(&allocators[1]);
+    report("messages", libc, slab, (double)MESSAGES_PER_PRODUCER * (NUM_THREADS / 2));
+
+    libc = bench_tasks(&allocators[0]);
+    slab = bench_tasks(&allocators[1]);
+    report("tasks", libc, slab, (double)TASK_ROUNDS * TASK_BATCH * NUM_THREADS);
+
+    libc = bench_strings(&allocators[0]);
+    slab = bench_strings(&allocators[1]);
+    report("strings", libc, slab, (double)STRING_OPS);
+
+    GooSlabStats stats = goo_slab_allocator_get_stats();
+    printf("\nslab allocator: %zu KB mapped, %zu KB returned to the OS, %zu slabs (%zu released)\n",
+           stats.bytes_mapped / 1024, stats.bytes_released / 1024,
+           stats.slabs, stats.released_slabs);
+
+    goo_memory_cleanup();
+    return 0;
+}
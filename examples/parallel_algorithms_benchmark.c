@@ -0,0 +1,229 @@
+/**
+ * parallel_algorithms_benchmark.c
+ *
+ * Benchmarks Goo's parallel algorithms (sort, radix sort, scan, stable
+ * partition, histogram) against straightforward single-threaded baselines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../src/runtime/concurrency/goo_parallel.h"
+#include "../src/runtime/concurrency/goo_parallel_algorithms.h"
+
+// Benchmark parameters
+#define ARRAY_SIZE 10000000
+#define NUM_ITERATIONS 5
+#define HISTOGRAM_BINS 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void fill_random_u32(uint32_t *data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        data[i] = (uint32_t)next_random();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Single-threaded baselines
+// ----------------------------------------------------------------------------
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void baseline_radix_sort_u32(uint32_t *keys, uint32_t *scratch, size_t count) {
+    uint32_t *src = keys, *dst = scratch;
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        size_t counts[256] = {0};
+        for (size_t i = 0; i < count; i++) counts[(src[i] >> shift) & 0xFF]++;
+        size_t sum = 0;
+        for (int d = 0; d < 256; d++) { size_t c = counts[d]; counts[d] = sum; sum += c; }
+        for (size_t i = 0; i < count; i++) dst[counts[(src[i] >> shift) & 0xFF]++] = src[i];
+        uint32_t *tmp = src; src = dst; dst = tmp;
+    }
+}
+
+static void baseline_inclusive_scan_i64(const int64_t *in, int64_t *out, size_t count) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < count; i++) {
+        acc += in[i];
+        out[i] = acc;
+    }
+}
+
+static bool is_even(const void *elem, void *context) {
+    (void)context;
+    return (*(const uint32_t*)elem & 1) == 0;
+}
+
+static size_t baseline_stable_partition(uint32_t *data, uint32_t *scratch, size_t count) {
+    size_t t = 0;
+    for (size_t i = 0; i < count; i++) if (is_even(&data[i], NULL)) scratch[t++] = data[i];
+    size_t split = t;
+    for (size_t i = 0; i < count; i++) if (!is_even(&data[i], NULL)) scratch[t++] = data[i];
+    memcpy(data, scratch, count * sizeof(uint32_t));
+    return split;
+}
+
+static size_t low_byte_bin(const void *elem, void *context) {
+    (void)context;
+    return *(const uint32_t*)elem & (HISTOGRAM_BINS - 1);
+}
+
+static void baseline_histogram(const uint32_t *data, size_t count, uint64_t *bins) {
+    memset(bins, 0, HISTOGRAM_BINS * sizeof(uint64_t));
+    for (size_t i = 0; i < count; i++) bins[low_byte_bin(&data[i], NULL)]++;
+}
+
+// ----------------------------------------------------------------------------
+// Benchmarks
+// ----------------------------------------------------------------------------
+
+static void report(const char *name, double baseline, double parallel) {
+    printf("%-20s baseline: %8.4f s   parallel: %8.4f s   speedup: %5.2fx\n",
+           name, baseline, parallel, baseline / parallel);
+}
+
+static bool is_sorted_u32(const uint32_t *data, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        if (data[i - 1] > data[i]) return false;
+    }
+    return true;
+}
+
+int main(void) {
+    if (!goo_parallel_init(0)) {
+        printf("Failed to initialize parallel subsystem\n");
+        return 1;
+    }
+
+    printf("Parallel algorithms benchmark\n");
+    printf("-----------------------------\n");
+    printf("Elements: %d, iterations: %d, threads: %d\n\n",
+           ARRAY_SIZE, NUM_ITERATIONS, goo_parallel_get_num_threads());
+
+    uint32_t *data = malloc(ARRAY_SIZE * sizeof(uint32_t));
+    uint32_t *work = malloc(ARRAY_SIZE * sizeof(uint32_t));
+    uint32_t *scratch = malloc(ARRAY_SIZE * sizeof(uint32_t));
+    int64_t *values = malloc(ARRAY_SIZE * sizeof(int64_t));
+    int64_t *sums = malloc(ARRAY_SIZE * sizeof(int64_t));
+    if (!data || !work || !scratch || !values || !sums) {
+        printf("Failed to allocate memory\n");
+        return 1;
+    }
+
+    fill_random_u32(data, ARRAY_SIZE);
+    for (size_t i = 0; i < ARRAY_SIZE; i++) values[i] = (int64_t)(data[i] % 1000);
+
+    double base_total, par_total, t0;
+    bool ok = true;
+
+    // Comparison sort
+    base_total = par_total = 0.0;
+    for (int it = 0; it < NUM_ITERATIONS; it++) {
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        t0 = now_seconds();
+        qsort(work, ARRAY_SIZE, sizeof(uint32_t), compare_u32);
+        base_total += now_seconds() - t0;
+
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        t0 = now_seconds();
+        goo_parallel_sort(work, ARRAY_SIZE, sizeof(uint32_t), compare_u32);
+        par_total += now_seconds() - t0;
+        ok &= is_sorted_u32(work, ARRAY_SIZE);
+    }
+    report("sort", base_total / NUM_ITERATIONS, par_total / NUM_ITERATIONS);
+
+    // Radix sort
+    base_total = par_total = 0.0;
+    for (int it = 0; it < NUM_ITERATIONS; it++) {
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        t0 = now_seconds();
+        baseline_radix_sort_u32(work, scratch, ARRAY_SIZE);
+        base_total += now_seconds() - t0;
+
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        t0 = now_seconds();
+        goo_parallel_radix_sort_u32(work, ARRAY_SIZE);
+        par_total += now_seconds() - t0;
+        ok &= is_sorted_u32(work, ARRAY_SIZE);
+    }
+    report("radix_sort_u32", base_total / NUM_ITERATIONS, par_total / NUM_ITERATIONS);
+
+    // Inclusive scan
+    base_total = par_total = 0.0;
+    for (int it = 0; it < NUM_ITERATIONS; it++) {
+        t0 = now_seconds();
+        baseline_inclusive_scan_i64(values, sums, ARRAY_SIZE);
+        base_total += now_seconds() - t0;
+        int64_t expected = sums[ARRAY_SIZE - 1];
+
+        t0 = now_seconds();
+        goo_parallel_inclusive_scan_i64(values, sums, ARRAY_SIZE);
+        par_total += now_seconds() - t0;
+        ok &= sums[ARRAY_SIZE - 1] == expected;
+    }
+    report("inclusive_scan_i64", base_total / NUM_ITERATIONS, par_total / NUM_ITERATIONS);
+
+    // Stable partition
+    base_total = par_total = 0.0;
+    for (int it = 0; it < NUM_ITERATIONS; it++) {
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        t0 = now_seconds();
+        size_t expected = baseline_stable_partition(work, scratch, ARRAY_SIZE);
+        base_total += now_seconds() - t0;
+
+        memcpy(work, data, ARRAY_SIZE * sizeof(uint32_t));
+        size_t split = 0;
+        t0 = now_seconds();
+        goo_parallel_stable_partition(work, ARRAY_SIZE, sizeof(uint32_t), is_even, NULL, &split);
+        par_total += now_seconds() - t0;
+        ok &= split == expected && memcmp(work, scratch, ARRAY_SIZE * sizeof(uint32_t)) == 0;
+    }
+    report("stable_partition", base_total / NUM_ITERATIONS, par_total / NUM_ITERATIONS);
+
+    // Histogram
+    uint64_t base_bins[HISTOGRAM_BINS], par_bins[HISTOGRAM_BINS];
+    base_total = par_total = 0.0;
+    for (int it = 0; it < NUM_ITERATIONS; it++) {
+        t0 = now_seconds();
+        baseline_histogram(data, ARRAY_SIZE, base_bins);
+        base_total += now_seconds() - t0;
+
+        t0 = now_seconds();
+        goo_parallel_histogram(data, ARRAY_SIZE, sizeof(uint32_t), low_byte_bin, NULL,
+                               par_bins, HISTOGRAM_BINS);
+        par_total += now_seconds() - t0;
+        ok &= memcmp(base_bins, par_bins, sizeof(base_bins)) == 0;
+    }
+    report("histogram", base_total / NUM_ITERATIONS, par_total / NUM_ITERATIONS);
+
+    printf("\nResults %s\n", ok ? "match the baselines" : "DIFFER from the baselines");
+
+    free(sums);
+    free(values);
+    free(scratch);
+    free(work);
+    free(data);
+    goo_parallel_cleanup();
+    return ok ? 0 : 1;
+}
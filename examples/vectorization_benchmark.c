@@ -0,0 +1,204 @@
+/**
+ * vectorization_benchmark.c
+ *
+ * Compares the scalar, SSE2, AVX2 and AVX-512 kernels behind
+ * goo_vectorization_execute across element types, operations and array
+ * sizes. Each cell is throughput in millions of elements per second, with
+ * the speedup over scalar in parentheses. Levels the host or build does not
+ * support are shown as n/a.
+ *
+ * Usage: vectorization_benchmark [offset]
+ * offset shifts every buffer by that many bytes from 64-byte alignment, to
+ * measure the kernels on unaligned data such as slices of network frames.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../src/runtime/concurrency/goo_vectorization.h"
+
+// Elements processed per measurement, spread over repeated runs
+#define TARGET_ELEMENTS (64u * 1024 * 1024)
+
+static const size_t array_sizes[] = { 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024 };
+#define NUM_SIZES (sizeof(array_sizes) / sizeof(array_sizes[0]))
+
+static const struct {
+    GooSIMDType simd;
+    const char *name;
+} levels[] = {
+    { GOO_SIMD_SCALAR, "scalar" },
+    { GOO_SIMD_SSE2,   "SSE2" },
+    { GOO_SIMD_AVX2,   "AVX2" },
+    { GOO_SIMD_AVX512, "AVX-512" },
+};
+#define NUM_LEVELS (sizeof(levels) / sizeof(levels[0]))
+
+static const struct {
+    GooVectorDataType type;
+    size_t elem_size;
+    const char *name;
+} types[] = {
+    { GOO_VEC_FLOAT,  4, "f32" },
+    { GOO_VEC_DOUBLE, 8, "f64" },
+    { GOO_VEC_INT8,   1, "i8" },
+    { GOO_VEC_UINT8,  1, "u8" },
+    { GOO_VEC_INT16,  2, "i16" },
+    { GOO_VEC_UINT16, 2, "u16" },
+    { GOO_VEC_INT32,  4, "i32" },
+    { GOO_VEC_UINT32, 4, "u32" },
+    { GOO_VEC_INT64,  8, "i64" },
+    { GOO_VEC_UINT64, 8, "u64" },
+};
+#define NUM_TYPES (sizeof(types) / sizeof(types[0]))
+
+static const struct {
+    GooVectorOp op;
+    const char *name;
+} ops[] = {
+    { GOO_VECTOR_ADD, "add" },
+    { GOO_VECTOR_SUB, "sub" },
+    { GOO_VECTOR_MUL, "mul" },
+    { GOO_VECTOR_DIV, "div" },
+};
+#define NUM_OPS (sizeof(ops) / sizeof(ops[0]))
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Fill with small non-zero values so divisions never take the guarded path
+static void fill_operand(void *data, GooVectorDataType type, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        int value = (int)(next_random() % 100) + 1;
+        switch (type) {
+            case GOO_VEC_FLOAT:  ((float*)data)[i] = (float)value; break;
+            case GOO_VEC_DOUBLE: ((double*)data)[i] = (double)value; break;
+            case GOO_VEC_INT8:   ((int8_t*)data)[i] = (int8_t)value; break;
+            case GOO_VEC_UINT8:  ((uint8_t*)data)[i] = (uint8_t)value; break;
+            case GOO_VEC_INT16:  ((int16_t*)data)[i] = (int16_t)value; break;
+            case GOO_VEC_UINT16: ((uint16_t*)data)[i] = (uint16_t)value; break;
+            case GOO_VEC_INT32:  ((int32_t*)data)[i] = value; break;
+            case GOO_VEC_UINT32: ((uint32_t*)data)[i] = (uint32_t)value; break;
+            case GOO_VEC_INT64:  ((int64_t*)data)[i] = value; break;
+            case GOO_VEC_UINT64: ((uint64_t*)data)[i] = (uint64_t)value; break;
+        }
+    }
+}
+
+// Returns millions of elements per second, or a negative value on failure
+static double measure(GooVectorOperation *op) {
+    size_t runs = TARGET_ELEMENTS / op->base.length;
+    if (runs == 0) runs = 1;
+
+    // Warm caches and page in the destination
+    if (!goo_vectorization_execute(op)) return -1.0;
+
+    double start = now_seconds();
+    for (size_t r = 0; r < runs; r++) {
+        goo_vectorization_execute(op);
+    }
+    double elapsed = now_seconds() - start;
+
+    return (double)runs * (double)op->base.length / elapsed / 1.0e6;
+}
+
+int main(int argc, char **argv) {
+    GooSIMDType available = goo_vectorization_detect_simd();
+    goo_vectorization_init(GOO_SIMD_AUTO);
+
+    size_t offset = argc > 1 ? strtoul(argv[1], NULL, 10) % 64 : 0;
+    size_t max_size = array_sizes[NUM_SIZES - 1];
+    size_t buffer_size = max_size * sizeof(uint64_t) + 64;
+    char *src1_base = goo_vectorization_alloc_aligned(buffer_size, GOO_SIMD_AVX512);
+    char *src2_base = goo_vectorization_alloc_aligned(buffer_size, GOO_SIMD_AVX512);
+    char *dst_base = goo_vectorization_alloc_aligned(buffer_size, GOO_SIMD_AVX512);
+    if (!src1_base || !src2_base || !dst_base) {
+        fprintf(stderr, "Error: Failed to allocate benchmark buffers\n");
+        return 1;
+    }
+    void *src1 = src1_base + offset;
+    void *src2 = src2_base + offset;
+    void *dst = dst_base + offset;
+
+    printf("Goo Vectorization Benchmark (Melem/s, speedup vs scalar)\n");
+    const char *available_name = levels[0].name;
+    for (size_t l = 0; l < NUM_LEVELS; l++) {
+        if (levels[l].simd <= available) available_name = levels[l].name;
+    }
+    printf("Best available SIMD level: %s\n", available_name);
+    printf("Buffer offset from 64-byte alignment: %zu bytes\n\n", offset);
+
+    printf("%-4s %-4s %9s", "type", "op", "elements");
+    for (size_t l = 0; l < NUM_LEVELS; l++) {
+        printf(" %18s", levels[l].name);
+    }
+    printf("\n");
+
+    for (size_t t = 0; t < NUM_TYPES; t++) {
+        fill_operand(src1, types[t].type, max_size);
+        fill_operand(src2, types[t].type, max_size);
+
+        for (size_t o = 0; o < NUM_OPS; o++) {
+            for (size_t s = 0; s < NUM_SIZES; s++) {
+                GooVectorOperation op = {
+                    .base = {
+                        .src1 = src1,
+                        .src2 = src2,
+                        .dst = dst,
+                        .elem_size = types[t].elem_size,
+                        .length = array_sizes[s],
+                        .op = ops[o].op,
+                    },
+                    .data_type = types[t].type,
+                    .aligned = offset == 0,
+                };
+
+                printf("%-4s %-4s %9zu", types[t].name, ops[o].name, array_sizes[s]);
+
+                double scalar_rate = 0.0;
+                for (size_t l = 0; l < NUM_LEVELS; l++) {
+                    if (levels[l].simd != GOO_SIMD_SCALAR && levels[l].simd > available) {
+                        printf(" %18s", "n/a");
+                        continue;
+                    }
+
+                    op.simd_type = levels[l].simd;
+                    double rate = measure(&op);
+                    if (rate < 0.0) {
+                        printf(" %18s", "failed");
+                        continue;
+                    }
+
+                    if (levels[l].simd == GOO_SIMD_SCALAR) {
+                        scalar_rate = rate;
+                        printf(" %18.1f", rate);
+                    } else {
+                        printf(" %10.1f (%4.1fx)", rate, scalar_rate > 0.0 ? rate / scalar_rate : 0.0);
+                    }
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    goo_vectorization_free_aligned(src1_base);
+    goo_vectorization_free_aligned(src2_base);
+    goo_vectorization_free_aligned(dst_base);
+    goo_vectorization_cleanup();
+    return 0;
+}
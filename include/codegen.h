@@ -7,6 +7,7 @@
 #include <llvm-c/Analysis.h>
 #include <llvm-c/ExecutionEngine.h>
 #include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
 #include <llvm-c/BitWriter.h>
 
 // Try to include Scalar.h if available
@@ -48,6 +49,33 @@ typedef struct {
     GooCodegenContext* context;
 } GooInterpreterState;
 
+// Maximum number of placed allocations tracked per function
+#define GOO_MAX_PLACED_ALLOCS 256
+
+// Where an allocation was placed
+typedef enum {
+    GOO_ALLOC_PLACE_HEAP,   // Runtime allocator: outlives the call
+    GOO_ALLOC_PLACE_ARENA,  // Per-call arena: local, too large for the frame
+    GOO_ALLOC_PLACE_STACK,  // alloca: known size, dies with the call
+} GooAllocPlacement;
+
+// Allocation placement state for the function being generated
+typedef struct {
+    LLVMValueRef function;            // Function being generated
+    const char* function_name;        // Its name, for escape analysis lookups
+    LLVMValueRef arena_mark;          // Call arena mark taken on entry (NULL until needed)
+    int loop_depth;                   // Loops enclosing the current insertion point
+    unsigned stack_allocs;            // Allocations lowered to alloca
+    unsigned arena_allocs;            // Allocations moved to the call arena
+    unsigned heap_allocs;             // Allocations left on the heap
+    unsigned elided_frees;            // Frees dropped for stack and arena allocations
+    struct {
+        const char* name;             // Variable bound to the allocation
+        GooAllocPlacement placement;  // Where it went
+    } placed[GOO_MAX_PLACED_ALLOCS];
+    int placed_count;
+} GooAllocPlacementState;
+
 // Code generator context
 typedef struct {
     GooNode* root;                    // Root node to generate code from
@@ -69,6 +97,7 @@ typedef struct {
     int thread_pool_size;             // Thread pool size for goroutines
     GooSupervisionPolicy supervision_policy; // Default supervision policy
     char* runtime_lib_path;           // Path to the runtime library
+    bool emit_safepoints;             // Poll for preemption in loops and prologues
     
     // Debug information
     bool debug_mode;                  // Whether to generate debug info
@@ -81,6 +110,9 @@ typedef struct {
     
     // Optimization level
     bool optimize;                     // Enable optimization
+    
+    // Escape-analysis-driven allocation placement
+    GooAllocPlacementState alloc_placement;
 } GooCodegenContext;
 
 // Initialize the code generator
@@ -107,6 +139,19 @@ bool goo_codegen_verify_module(GooCodegenContext* context);
 // Emit the generated module to a file
 bool goo_codegen_emit(GooCodegenContext* context, const char* filename);
 
+// Generate code for the context's AST without optimizing it
+bool goo_codegen_generate_unoptimized(GooCodegenContext* context);
+
+// Run the optimization pipeline for the context's level on the module
+bool goo_codegen_optimize(GooCodegenContext* context);
+
+// Target machine for the context's triple, CPU, features and level; the
+// caller disposes it
+LLVMTargetMachineRef goo_codegen_get_target_machine(GooCodegenContext* context);
+
+// Compile the module to an object file
+bool goo_codegen_generate_object_file(GooCodegenContext* context, const char* output_file);
+
 // JIT compilation and execution
 bool goo_codegen_init_jit(GooCodegenContext* context);
 LLVMValueRef goo_codegen_jit_get_function(GooCodegenContext* context, const char* name);
@@ -158,6 +203,8 @@ LLVMValueRef goo_codegen_call_expr(GooCodegenContext* context, GooCallExprNode*
 LLVMValueRef goo_codegen_literal(GooCodegenContext* context, GooNode* node);
 LLVMValueRef goo_codegen_identifier(GooCodegenContext* context, GooNode* node);
 LLVMValueRef goo_codegen_range_literal(GooCodegenContext* context, GooRangeLiteralNode* node);
+LLVMValueRef goo_codegen_alloc_expr(GooCodegenContext* context, GooAllocExprNode* node, const char* var_name);
+LLVMValueRef goo_codegen_free_expr(GooCodegenContext* context, GooFreeExprNode* node);
 LLVMValueRef goo_codegen_channel_send(GooCodegenContext* context, GooChannelSendNode* node);
 LLVMValueRef goo_codegen_channel_recv(GooCodegenContext* context, GooChannelRecvNode* node);
 LLVMValueRef goo_codegen_go_stmt(GooCodegenContext* context, GooGoStmtNode* node);
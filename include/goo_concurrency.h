@@ -99,6 +99,9 @@ typedef struct GooQueueNode {
 
 /**
  * @brief Lock-free queue implementation
+ *
+ * Michael-Scott queue. Nodes come from a shared concurrent pool and popped
+ * nodes are reclaimed through goo_epoch_retire.
  */
 typedef struct {
     _Atomic(GooQueueNode*) head; /**< Head of the queue */
@@ -240,7 +243,8 @@ int goo_lockfree_queue_push(GooLockFreeQueue* queue, void* data);
  * 
  * @param queue Pointer to the queue
  * @param data_out Pointer to store the popped data
- * @return int 0 on success, error code on failure (including empty queue)
+ * @return int 0 on success, ENODATA if the queue is empty (not recorded as a
+ *         thread error), or another error code on failure
  */
 int goo_lockfree_queue_pop(GooLockFreeQueue* queue, void** data_out);
 
@@ -252,6 +256,48 @@ int goo_lockfree_queue_pop(GooLockFreeQueue* queue, void** data_out);
  */
 bool goo_lockfree_queue_is_empty(GooLockFreeQueue* queue);
 
+/* Epoch-based memory reclamation */
+
+/**
+ * @brief Function that frees a retired object
+ */
+typedef void (*GooReclaimFn)(void* ptr);
+
+/**
+ * @brief Pin the calling thread before dereferencing shared nodes
+ *
+ * Nodes retired after the pin are not reclaimed until the matching
+ * goo_epoch_exit. Pins nest.
+ */
+void goo_epoch_enter(void);
+
+/**
+ * @brief Unpin the calling thread
+ */
+void goo_epoch_exit(void);
+
+/**
+ * @brief Defer reclaiming an unlinked object until no pinned thread can see it
+ * 
+ * @param ptr Object that is no longer reachable from the shared structure
+ * @param reclaim Function called with ptr once it is safe to free
+ */
+void goo_epoch_retire(void* ptr, GooReclaimFn reclaim);
+
+/**
+ * @brief Try to advance the global epoch
+ * 
+ * @return bool true if the epoch advanced, false if a pinned thread lags
+ */
+bool goo_epoch_try_advance(void);
+
+/**
+ * @brief Wait until everything the calling thread retired has been reclaimed
+ * 
+ * @return int 0 on success, EDEADLK if the calling thread is pinned
+ */
+int goo_epoch_synchronize(void);
+
 /* Thread-local error handling */
 
 /**
@@ -0,0 +1,117 @@
+#ifndef GOO_HEAP_PROFILE_H
+#define GOO_HEAP_PROFILE_H
+
+/**
+ * Sampling Heap Profiler for Goo
+ *
+ * The allocator samples roughly one allocation per rate bytes on a Poisson
+ * schedule, records its call stack, and tracks whether it is still live.
+ * Profiles can be written on demand or when a signal arrives, in pprof
+ * protobuf or folded-stack format.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default mean bytes between samples
+#define GOO_HEAP_PROFILE_DEFAULT_RATE (512 * 1024)
+
+// Deepest stack recorded per sample
+#define GOO_HEAP_PROFILE_MAX_DEPTH 32
+
+// Output formats
+typedef enum {
+    GOO_HEAP_PROFILE_PPROF,         // pprof protobuf (alloc and inuse objects/space)
+    GOO_HEAP_PROFILE_FOLDED_INUSE,  // "frame;frame;frame bytes" of live memory
+    GOO_HEAP_PROFILE_FOLDED_ALLOC   // "frame;frame;frame bytes" of all allocated memory
+} GooHeapProfileFormat;
+
+// Totals across all stacks, scaled to estimate the full heap
+typedef struct GooHeapProfileStats {
+    uint64_t samples;           // Allocations sampled
+    uint64_t live_samples;      // Sampled allocations not yet freed
+    uint64_t dropped_samples;   // Samples lost to allocation failure
+    uint64_t alloc_bytes;       // Estimated bytes allocated
+    uint64_t inuse_bytes;       // Estimated bytes still live
+    size_t stacks;              // Distinct stacks recorded
+} GooHeapProfileStats;
+
+/**
+ * Set the mean sampling interval
+ *
+ * @param rate Mean bytes between samples; 0 disables sampling
+ */
+void goo_heap_profile_set_rate(size_t rate);
+
+/**
+ * Get the mean sampling interval (0 when disabled)
+ */
+size_t goo_heap_profile_get_rate(void);
+
+/**
+ * Write the current profile to a file descriptor
+ *
+ * @param fd Destination
+ * @param format Output format
+ * @return true if the whole profile was written
+ */
+bool goo_heap_profile_write_fd(int fd, GooHeapProfileFormat format);
+
+/**
+ * Write the current profile to a file
+ *
+ * @param path Destination path (truncated)
+ * @param format Output format
+ * @return true if the whole profile was written
+ */
+bool goo_heap_profile_write(const char* path, GooHeapProfileFormat format);
+
+/**
+ * Write a profile to path each time signum is delivered
+ *
+ * The handler only wakes a background thread, which does the writing.
+ *
+ * @param signum Signal to install the handler for (e.g. SIGUSR2)
+ * @param path Destination path, rewritten on every signal
+ * @param format Output format
+ * @return true if the handler was installed
+ */
+bool goo_heap_profile_dump_on_signal(int signum, const char* path, GooHeapProfileFormat format);
+
+/**
+ * Configure from the environment: GOO_HEAP_PROFILE_RATE sets the rate and
+ * GOO_HEAP_PROFILE_PATH dumps there on SIGUSR2 (folded if it ends in
+ * ".folded", pprof otherwise). Setting only the path uses the default rate.
+ *
+ * @return false if the signal handler could not be installed
+ */
+bool goo_heap_profile_init_from_env(void);
+
+/**
+ * Get profile totals
+ */
+GooHeapProfileStats goo_heap_profile_get_stats(void);
+
+/**
+ * Forget all samples and stacks
+ */
+void goo_heap_profile_reset(void);
+
+// Allocator hooks: the allocator counts down bytes per thread and calls
+// sample when the countdown goes negative; free is only called while live
+// samples exist
+extern size_t goo_heap_profile_rate;
+extern size_t goo_heap_profile_live_count;
+int64_t goo_heap_profile_sample(void* ptr, size_t size);
+void goo_heap_profile_free(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GOO_HEAP_PROFILE_H
@@ -22,6 +22,13 @@ extern "C" {
 bool goo_runtime_integration_init(void);
 void goo_runtime_integration_cleanup(void);
 
+// Typed allocation. Objects of up to 1 KiB with a type name come from
+// thread-safe size-class pools; free with the same size and type name
+typedef struct GooConcurrentPool GooConcurrentPool;
+GooConcurrentPool* goo_runtime_get_type_pool(size_t obj_size, const char* type_name);
+void* goo_runtime_typed_alloc(size_t size, const char* type_name);
+void goo_runtime_typed_free(void* ptr, const char* type_name, size_t size);
+
 // Zig runtime integration
 bool goo_initialize_zig_runtime(void);
 void goo_cleanup_zig_runtime(void);
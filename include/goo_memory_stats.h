@@ -7,6 +7,7 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -47,6 +48,71 @@ void goo_memory_stats_track_free(size_t size);
  */
 void goo_memory_stats_track_realloc(size_t old_size, size_t new_size);
 
+// Maximum number of allocators with their own breakdown (id 0 is "default")
+#define GOO_STATS_MAX_ALLOCATORS 16
+
+// Size classes: <= 8 bytes, one per power of two up to 16 MB, then larger
+#define GOO_STATS_SIZE_CLASSES 23
+
+// Counters for one allocator
+typedef struct GooAllocatorStatsEntry {
+    char name[32];
+    uint64_t bytes_allocated;
+    uint64_t bytes_freed;
+    uint64_t allocations;
+    uint64_t frees;
+} GooAllocatorStatsEntry;
+
+// Counters for one size class
+typedef struct GooSizeClassStats {
+    size_t max_size;            // Largest size in the class (SIZE_MAX for the last)
+    uint64_t allocations;
+    uint64_t frees;
+} GooSizeClassStats;
+
+// Aggregated view of all per-thread counters
+typedef struct GooMemoryStatsSnapshot {
+    size_t total_allocated;     // Live bytes
+    size_t peak_allocated;      // Peak live bytes (as of the last merge)
+    size_t allocation_count;    // Live allocations
+    uint64_t total_allocations;
+    uint64_t total_frees;
+    int thread_count;           // Threads currently owning counters
+    int allocator_count;
+    GooAllocatorStatsEntry allocators[GOO_STATS_MAX_ALLOCATORS];
+    GooSizeClassStats size_classes[GOO_STATS_SIZE_CLASSES];
+} GooMemoryStatsSnapshot;
+
+/**
+ * Register a named allocator for the per-allocator breakdown
+ * 
+ * @param name Allocator name (registering the same name returns the same id)
+ * @return Allocator id, or -1 if the table is full
+ */
+int goo_memory_stats_register_allocator(const char* name);
+
+/**
+ * Track an allocation or deallocation made by a registered allocator
+ * 
+ * @param allocator_id Id from goo_memory_stats_register_allocator
+ * @param size Size of allocation in bytes
+ */
+void goo_memory_stats_track_alloc_for(int allocator_id, size_t size);
+void goo_memory_stats_track_free_for(int allocator_id, size_t size);
+
+/**
+ * Aggregate all per-thread counters
+ * 
+ * @param snapshot Receives the totals and breakdowns
+ * @return true on success
+ */
+bool goo_memory_stats_snapshot(GooMemoryStatsSnapshot* snapshot);
+
+/**
+ * Print totals with per-allocator and per-size-class breakdowns
+ */
+void goo_memory_stats_print(void);
+
 // Public API is exposed through goo_memory.h
 
 #ifdef __cplusplus
@@ -95,7 +95,10 @@ typedef struct GooSuperviseChild {
     GooSupervisor* supervisor;
 } GooSuperviseChild;
 
-typedef struct GooSupervisor {
+// goo_supervision.c defines its own, larger supervisor and sets
+// GOO_SUPERVISOR_PRIVATE so this layout is left out
+#ifndef GOO_SUPERVISOR_PRIVATE
+struct GooSupervisor {
     GooSuperviseChild** children;
     int child_count;
     GooSupervisionPolicy restart_policy;
@@ -104,7 +107,8 @@ typedef struct GooSupervisor {
     int restart_count;
     time_t last_restart_time;
     pthread_mutex_t mutex;
-} GooSupervisor;
+};
+#endif
 
 // ===== Thread Pool Functions =====
 
@@ -113,10 +117,21 @@ void goo_thread_pool_cleanup(void);
 
 bool goo_schedule_task(GooTask* task);
 
+// Hand queued goroutines to a spare worker (called from preemption safepoints)
+void goo_thread_pool_handoff(void);
+
 // ===== Goroutine Functions =====
 
 bool goo_goroutine_spawn(GooTaskFunc func, void* arg, GooSupervisor* supervisor);
 
+// Run goroutines started from now on in a region of reserve_size bytes
+// (0 turns region mode off). The region is the task's thread allocator and is
+// released in one shot when the task returns, panics or is restarted.
+void goo_goroutine_set_region_mode(size_t reserve_size);
+
+// Copy a value out of the running goroutine's region so it outlives the task
+void* goo_goroutine_promote(const void* ptr, size_t size);
+
 // ===== Channel Functions =====
 
 GooChannel* goo_channel_create(size_t element_size, size_t capacity, GooChannelPattern type);
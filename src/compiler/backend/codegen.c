@@ -5,16 +5,11 @@
 #include <llvm-c/Analysis.h>
 #include <llvm-c/BitWriter.h>
 
-// Try to include Scalar.h if available
-#if __has_include(<llvm-c/Transforms/Scalar.h>)
-#include <llvm-c/Transforms/Scalar.h>
-#endif
-
-#if __has_include(<llvm-c/Transforms/IPO.h>)
-#include <llvm-c/Transforms/IPO.h>
-#endif
-
 #include "codegen.h"
+#include "codegen_memory.h"
+#include "codegen_safepoint.h"
+#include "codegen_simd.h"
+#include "passes/pass_manager.h"
 #include "ast_helpers.h"
 #include "ast.h"
 #include "runtime.h"
@@ -44,6 +39,8 @@ GooCodegenContext* goo_codegen_init(GooAst* ast, GooContext* ctx, const char* mo
     context->ast = ast;
     context->goo_context = ctx;
     context->debug_mode = false;
+    context->emit_safepoints = true;
+    memset(&context->alloc_placement, 0, sizeof(context->alloc_placement));
 
     // Initialize language types
     context->string_type = NULL;
@@ -168,6 +165,12 @@ LLVMValueRef goo_codegen_node(GooCodegenContext* context, GooNode* node) {
         case GOO_NODE_IDENTIFIER:
             return goo_codegen_identifier(context, node);
 
+        case GOO_NODE_ALLOC_EXPR:
+            return goo_codegen_alloc_expr(context, (GooAllocExprNode*)node, NULL);
+
+        case GOO_NODE_FREE_EXPR:
+            return goo_codegen_free_expr(context, (GooFreeExprNode*)node);
+
         case GOO_NODE_INT_LITERAL:
         case GOO_NODE_FLOAT_LITERAL:
         case GOO_NODE_STRING_LITERAL:
@@ -326,6 +329,9 @@ LLVMValueRef goo_codegen_function(GooCodegenContext* context, GooFunctionNode* n
     LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(context->context, function, "entry");
     LLVMPositionBuilderAtEnd(context->builder, entry);
     
+    // Allocations in the body are placed using escape analysis results
+    goo_codegen_memory_function_begin(context, function, func_name);
+    
     // Create a new scope for the function
     goo_symbol_table_enter_scope(context->symbol_table, true);
     
@@ -347,6 +353,9 @@ LLVMValueRef goo_codegen_function(GooCodegenContext* context, GooFunctionNode* n
                           (GooNode*)param_node, param_types[i]);
     }
     
+    // Prologue safepoint bounds the time between polls in recursive code
+    goo_codegen_safepoint(context);
+    
     // Generate code for function body
     LLVMValueRef body_value = goo_codegen_block(context, node->body);
     
@@ -371,6 +380,9 @@ LLVMValueRef goo_codegen_function(GooCodegenContext* context, GooFunctionNode* n
         }
     }
     
+    // Release the call arena on every return and record placement counters
+    goo_codegen_memory_function_end(context);
+    
     // Exit function scope
     goo_symbol_table_exit_scope(context->symbol_table);
     
@@ -443,7 +455,16 @@ LLVMValueRef goo_codegen_var_decl(GooCodegenContext* context, GooVarDeclNode* no
     
     // If there's an initializer expression, generate code for it and assign to the variable
     if (node->init_expr) {
-        LLVMValueRef init_value = goo_codegen_node(context, node->init_expr);
+        LLVMValueRef init_value;
+        if (node->init_expr->type == GOO_NODE_ALLOC_EXPR) {
+            // Bound allocations are placed by the variable's escape state
+            init_value = goo_codegen_alloc_expr(context, (GooAllocExprNode*)node->init_expr, var_name);
+            if (init_value && LLVMGetTypeKind(var_type) == LLVMPointerTypeKind) {
+                init_value = LLVMBuildBitCast(context->builder, init_value, var_type, "alloc_cast");
+            }
+        } else {
+            init_value = goo_codegen_node(context, node->init_expr);
+        }
         if (!init_value) {
             fprintf(stderr, "Failed to generate code for initializer expression\n");
             return var_alloca;
@@ -571,12 +592,16 @@ LLVMValueRef goo_codegen_for(GooCodegenContext* context, GooForStmtNode* node) {
     // Generate code for the preheader block
     LLVMPositionBuilderAtEnd(context->builder, preheader_block);
     
+    // Allocations from here to the back edge repeat per iteration
+    context->alloc_placement.loop_depth++;
+    
     // Generate code for the condition if it exists
     LLVMValueRef condition = NULL;
     if (node->condition) {
         condition = goo_codegen_node(context, node->condition);
         if (!condition) {
             fprintf(stderr, "Failed to generate code for loop condition\n");
+            context->alloc_placement.loop_depth--;
             return NULL;
         }
     } else {
@@ -594,6 +619,7 @@ LLVMValueRef goo_codegen_for(GooCodegenContext* context, GooForStmtNode* node) {
     LLVMValueRef body_value = goo_codegen_node(context, (GooNode*)node->body);
     if (!body_value) {
         fprintf(stderr, "Failed to generate code for loop body\n");
+        context->alloc_placement.loop_depth--;
         return NULL;
     }
     
@@ -602,10 +628,16 @@ LLVMValueRef goo_codegen_for(GooCodegenContext* context, GooForStmtNode* node) {
         LLVMValueRef increment_value = goo_codegen_node(context, node->increment);
         if (!increment_value) {
             fprintf(stderr, "Failed to generate code for loop increment\n");
+            context->alloc_placement.loop_depth--;
             return NULL;
         }
     }
     
+    // Back-edge safepoint so a long-running loop can be preempted
+    goo_codegen_safepoint(context);
+    
+    context->alloc_placement.loop_depth--;
+    
     // Branch back to the preheader block
     LLVMBuildBr(context->builder, preheader_block);
     
@@ -935,6 +967,69 @@ LLVMValueRef goo_codegen_range_literal(GooCodegenContext* context, GooRangeLiter
     return range;
 }
 
+// Function for implementing allocation expressions; var_name is the variable
+// the result is bound to, which decides stack, arena or heap placement
+LLVMValueRef goo_codegen_alloc_expr(GooCodegenContext* context, GooAllocExprNode* node, const char* var_name) {
+    if (!context || !node || !node->type) return NULL;
+    
+    LLVMTypeRef elem_type = goo_type_to_llvm_type(context, node->type);
+    if (!elem_type) {
+        fprintf(stderr, "Failed to resolve type for allocation\n");
+        return NULL;
+    }
+    
+    // Fold the size when the element count is a literal so placement sees a constant
+    LLVMTypeRef size_t_type = LLVMInt64TypeInContext(context->context);
+    unsigned long long elem_size = LLVMABISizeOfType(LLVMGetModuleDataLayout(context->module), elem_type);
+    LLVMValueRef size_val = LLVMConstInt(size_t_type, elem_size, false);
+    
+    if (node->size) {
+        if (node->size->type == GOO_NODE_INT_LITERAL) {
+            int64_t count = ((GooIntLiteralNode*)node->size)->value;
+            size_val = LLVMConstInt(size_t_type, elem_size * (unsigned long long)(count > 0 ? count : 0), false);
+        } else {
+            LLVMValueRef count = goo_codegen_node(context, node->size);
+            if (!count) {
+                fprintf(stderr, "Failed to generate code for allocation size\n");
+                return NULL;
+            }
+            count = LLVMBuildIntCast2(context->builder, count, size_t_type, false, "alloc_count");
+            size_val = LLVMBuildMul(context->builder, size_val, count, "alloc_size");
+        }
+    }
+    
+    // Explicit allocators keep their allocation on the heap path
+    if (node->allocator) {
+        var_name = NULL;
+    }
+    
+    return goo_codegen_memory_alloc_var(context, var_name, size_val);
+}
+
+// Function for implementing free expressions
+LLVMValueRef goo_codegen_free_expr(GooCodegenContext* context, GooFreeExprNode* node) {
+    if (!context || !node || !node->expr) return NULL;
+    
+    LLVMValueRef ptr = goo_codegen_node(context, node->expr);
+    if (!ptr) {
+        fprintf(stderr, "Failed to generate code for freed expression\n");
+        return NULL;
+    }
+    
+    LLVMTypeRef i8_ptr_type = LLVMPointerType(LLVMInt8TypeInContext(context->context), 0);
+    if (LLVMTypeOf(ptr) != i8_ptr_type) {
+        ptr = LLVMBuildBitCast(context->builder, ptr, i8_ptr_type, "free_ptr");
+    }
+    
+    // The runtime finds the size from the pointer
+    const char* var_name = node->expr->type == GOO_NODE_IDENTIFIER ? ((GooIdentifierNode*)node->expr)->name : NULL;
+    LLVMValueRef size_val = LLVMConstInt(LLVMInt64TypeInContext(context->context), 0, false);
+    LLVMValueRef result = goo_codegen_memory_free_var(context, var_name, ptr, size_val);
+    
+    // A dropped free still yields a value so callers don't treat it as a failure
+    return result ? result : ptr;
+}
+
 // Enhanced channel send operation with memory management
 LLVMValueRef goo_codegen_channel_send(GooCodegenContext* context, GooChannelSendNode* node) {
     if (!context || !node) return NULL;
@@ -1671,64 +1766,27 @@ LLVMValueRef goo_codegen_go_stmt(GooCodegenContext* context, GooGoStmtNode* node
 bool goo_codegen_optimize(GooCodegenContext* context) {
     if (!context || !context->module) return false;
     
-    // Create a pass manager
-    LLVMPassManagerRef pass_manager = LLVMCreatePassManager();
-    if (!pass_manager) {
-        fprintf(stderr, "Failed to create pass manager\n");
-        return false;
+    if (!context->goo_context->optimize) {
+        return true;
     }
     
-    // Add optimization passes based on the optimization level
+    // Levels above -O3 select the custom pipeline
     int opt_level = context->goo_context->opt_level;
-    bool optimize = context->goo_context->optimize;
-    
-    if (optimize) {
-        // Add function analysis passes
-        LLVMPassManagerBuilderRef builder = LLVMPassManagerBuilderCreate();
-        LLVMPassManagerBuilderSetOptLevel(builder, opt_level);
-        
-        // Set size level (0 = none, 1 = optimize for size, 2 = optimize for size aggressively)
-        LLVMPassManagerBuilderSetSizeLevel(builder, 0);
-        
-        // Populate the pass manager with the passes specified by the optimization level
-        LLVMPassManagerBuilderPopulateModulePassManager(builder, pass_manager);
-        
-        // Add specific passes based on optimization level
-        if (opt_level >= 1) {
-            // Basic optimizations
-            LLVMAddPromoteMemoryToRegisterPass(pass_manager);
-            LLVMAddInstructionCombiningPass(pass_manager);
-            LLVMAddReassociatePass(pass_manager);
-            LLVMAddGVNPass(pass_manager);
-            LLVMAddCFGSimplificationPass(pass_manager);
-        }
-        
-        if (opt_level >= 2) {
-            // Intermediate optimizations
-            LLVMAddTailCallEliminationPass(pass_manager);
-            LLVMAddConstantPropagationPass(pass_manager);
-            LLVMAddSCCPPass(pass_manager);
-            LLVMAddDeadStoreEliminationPass(pass_manager);
-            LLVMAddAggressiveDCEPass(pass_manager);
-        }
-        
-        if (opt_level >= 3) {
-            // Advanced optimizations
-            LLVMAddFunctionInliningPass(pass_manager);
-            LLVMAddJumpThreadingPass(pass_manager);
-            LLVMAddLoopUnrollPass(pass_manager);
-            LLVMAddLoopVectorizePass(pass_manager);
-            LLVMAddSLPVectorizePass(pass_manager);
-        }
-        
-        LLVMPassManagerBuilderDispose(builder);
-    }
+    GooOptimizationLevel level = opt_level <= 0 ? GOO_OPT_NONE :
+                                 opt_level >= GOO_OPT_CUSTOM ? GOO_OPT_CUSTOM :
+                                 (GooOptimizationLevel)opt_level;
+    
+    // The vectorizers and cost models need the target; without one the
+    // pipeline still runs, just without target-specific tuning
+    LLVMTargetMachineRef target_machine = goo_codegen_get_target_machine(context);
     
-    // Run the pass manager on the module
-    bool result = LLVMRunPassManager(pass_manager, context->module);
+    // Every default pipeline starts with the always-inliner, which folds the
+    // SIMD helpers before anything else runs
+    bool result = goo_run_module_optimizations(context->module, level, target_machine);
     
-    // Clean up
-    LLVMDisposePassManager(pass_manager);
+    if (target_machine) {
+        LLVMDisposeTargetMachine(target_machine);
+    }
     
     return result;
 }
@@ -1762,10 +1820,8 @@ bool goo_codegen_apply_context_settings(GooCodegenContext* context) {
     return true;
 }
 
-// Enhanced function to generate optimized code
-bool goo_codegen_generate_optimized(GooCodegenContext* context) {
-    if (!context || !context->ast) return false;
-    
+// Apply the context settings and generate code for the whole AST
+static bool generate_module(GooCodegenContext* context) {
     // Apply context settings to the code generator
     if (!goo_codegen_apply_context_settings(context)) {
         fprintf(stderr, "Failed to apply context settings\n");
@@ -1778,6 +1834,17 @@ bool goo_codegen_generate_optimized(GooCodegenContext* context) {
         return false;
     }
     
+    return true;
+}
+
+// Enhanced function to generate optimized code
+bool goo_codegen_generate_optimized(GooCodegenContext* context) {
+    if (!context || !context->ast) return false;
+    
+    if (!generate_module(context)) {
+        return false;
+    }
+    
     // Run optimization passes if optimization is enabled
     if (context->goo_context->optimize) {
         if (!goo_codegen_optimize(context)) {
@@ -1790,6 +1857,14 @@ bool goo_codegen_generate_optimized(GooCodegenContext* context) {
     return goo_codegen_verify_module(context);
 }
 
+// Generate code without optimizing it, for backends that optimize the module
+// themselves (see codegen_parallel.c)
+bool goo_codegen_generate_unoptimized(GooCodegenContext* context) {
+    if (!context || !context->ast) return false;
+    
+    return generate_module(context) && goo_codegen_verify_module(context);
+}
+
 // Function to emit LLVM IR if requested
 bool goo_codegen_emit_llvm(GooCodegenContext* context) {
     if (!context || !context->module || !context->goo_context) return false;
@@ -2505,6 +2580,7 @@ GooCodegenContext* goo_codegen_init(GooAst* ast, GooContext* goo_ctx, const char
     context->di_compile_unit = NULL;
     context->next_goroutine_id = 0;
     context->next_supervision_id = 0;
+    memset(&context->alloc_placement, 0, sizeof(context->alloc_placement));
     
     // Declare runtime functions
     declare_runtime_functions(context);
@@ -2850,6 +2926,9 @@ bool goo_codegen_init_runtime(GooCodegenContext* context) {
         LLVMFunctionType(LLVMVoidTypeInContext(context->context),
             NULL, 0, 0));
     
+    // Preemption safepoints: per-worker request flag and yield slow path
+    goo_codegen_safepoint_declare_runtime(context);
+    
     // Runtime initialization and cleanup
     LLVMAddFunction(context->module, "goo_runtime_init",
         LLVMFunctionType(LLVMInt1TypeInContext(context->context),
@@ -3500,6 +3579,15 @@ void goo_codegen_init_main_runtime(GooCodegenContext* context, LLVMValueRef main
     LLVMBuildCall(builder, cleanup_func, NULL, 0, "");
 }
 
+// Register a SIMD helper under its name so Goo code can call it
+static void simd_register_helper(GooCodegenContext* context, GooSIMDTypeNode* type_node,
+                                 LLVMValueRef func) {
+    if (func) {
+        goo_symbol_table_add(context->symbol_table, LLVMGetValueName(func), GOO_SYMBOL_FUNCTION,
+                             func, (GooNode*)type_node, LLVMGlobalGetValueType(func));
+    }
+}
+
 // Function for implementing compile-time SIMD blocks
 LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node) {
     if (!context || !node) return NULL;
@@ -3532,6 +3620,9 @@ LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node
         simd_ctx = context->runtime_context->simd_ctx;
     }
     
+    // Helpers are emitted as separate functions; resume here afterwards
+    LLVMBasicBlockRef saved_block = LLVMGetInsertBlock(context->builder);
+    
     // Process each declaration in the SIMD block
     GooNode* decl = simd_node->block;
     while (decl) {
@@ -3568,45 +3659,22 @@ LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node
                 
                 // Add the type name to the symbol table
                 // This allows the type to be used by name in the code
-                LLVMTypeRef llvm_type = NULL;
-                
-                // Create an LLVM vector type based on the element type and width
-                LLVMTypeRef elem_type = NULL;
-                switch (type_node->data_type) {
-                    case GOO_VEC_INT8:
-                    case GOO_VEC_UINT8:
-                        elem_type = LLVMInt8TypeInContext(context->context);
-                        break;
-                    case GOO_VEC_INT16:
-                    case GOO_VEC_UINT16:
-                        elem_type = LLVMInt16TypeInContext(context->context);
-                        break;
-                    case GOO_VEC_INT32:
-                    case GOO_VEC_UINT32:
-                        elem_type = LLVMInt32TypeInContext(context->context);
-                        break;
-                    case GOO_VEC_INT64:
-                    case GOO_VEC_UINT64:
-                        elem_type = LLVMInt64TypeInContext(context->context);
-                        break;
-                    case GOO_VEC_FLOAT:
-                        elem_type = LLVMFloatTypeInContext(context->context);
-                        break;
-                    case GOO_VEC_DOUBLE:
-                        elem_type = LLVMDoubleTypeInContext(context->context);
-                        break;
-                    default:
-                        fprintf(stderr, "Unsupported vector element type\n");
-                        break;
+                LLVMTypeRef llvm_type = goo_codegen_simd_vector_type(context, type_node);
+                if (!llvm_type) {
+                    break;
                 }
                 
-                if (elem_type) {
-                    // Create the vector type
-                    llvm_type = LLVMVectorType(elem_type, type_node->vector_width);
-                    
-                    // Add it to the symbol table
-                    goo_symbol_table_add(context->symbol_table, type_node->name, GOO_SYMBOL_TYPE, 
-                                     NULL, (GooNode*)type_node, llvm_type);
+                // Native vector type, e.g. <4 x float>, plus its helpers
+                goo_symbol_table_add(context->symbol_table, type_node->name, GOO_SYMBOL_TYPE, 
+                                 NULL, (GooNode*)type_node, llvm_type);
+                GooSIMDTypeHelpers helpers;
+                goo_codegen_simd_emit_type_helpers(context, type_node, llvm_type, &helpers);
+                LLVMValueRef helper_funcs[] = {
+                    helpers.load, helpers.store, helpers.masked_load, helpers.masked_store,
+                    helpers.reduce_add, helpers.reduce_min, helpers.reduce_max
+                };
+                for (size_t i = 0; i < sizeof(helper_funcs) / sizeof(helper_funcs[0]); i++) {
+                    simd_register_helper(context, type_node, helper_funcs[i]);
                 }
                 break;
             }
@@ -3614,11 +3682,7 @@ LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node
             case GOO_NODE_SIMD_OP_DECL: {
                 GooSIMDOpNode* op_node = (GooSIMDOpNode*)decl;
                 
-                // Process the operation declaration
-                // In a real implementation, we would analyze the operation and generate
-                // appropriate LLVM IR for it. For simplicity, we're just recording it.
-                
-                // Add the operation to the symbol table
+                // Record the operation
                 GooComptimeSIMDOperation* simd_op = malloc(sizeof(GooComptimeSIMDOperation));
                 if (!simd_op) {
                     fprintf(stderr, "Failed to allocate memory for SIMD operation\n");
@@ -3629,29 +3693,46 @@ LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node
                 simd_op->op = op_node->op;
                 simd_op->has_mask = op_node->is_masked;
                 simd_op->is_fused = op_node->is_fused;
+                simd_op->vec_type = NULL;
+                simd_op->is_safe = false;
                 
                 // Find the vector type for this operation
+                GooSymbol* sym = NULL;
                 if (op_node->vec_type && op_node->vec_type->type == GOO_NODE_IDENTIFIER) {
                     char* type_name = ((struct GooIdentifierNode*)op_node->vec_type)->name;
                     
                     // Look up the type in the symbol table
-                    GooSymbol* sym = goo_symbol_table_lookup(context->symbol_table, type_name);
-                    if (sym && sym->kind == GOO_SYMBOL_TYPE) {
+                    sym = goo_symbol_table_lookup(context->symbol_table, type_name);
+                    if (sym && sym->kind == GOO_SYMBOL_TYPE && sym->llvm_type) {
                         // Find the corresponding comptime SIMD type
                         for (size_t i = 0; i < simd_ctx->type_count; i++) {
-                            GooSIMDTypeNode* type_node = (GooSIMDTypeNode*)sym->node;
-                            if (strcmp(type_node->name, type_name) == 0) {
+                            GooSIMDTypeNode* type_node = (GooSIMDTypeNode*)sym->ast_node;
+                            if (simd_ctx->types[i]->data_type == type_node->data_type &&
+                                simd_ctx->types[i]->vector_width == type_node->vector_width) {
                                 simd_op->vec_type = simd_ctx->types[i];
                                 simd_op->is_safe = simd_ctx->types[i]->is_safe;
                                 break;
                             }
                         }
+                    } else {
+                        sym = NULL;
                     }
                 }
                 
+                // Lower the operation to vector IR; calls to it inline into the caller
+                LLVMValueRef op_func = NULL;
+                if (sym) {
+                    op_func = goo_codegen_simd_emit_operation(context, op_node,
+                                                              (GooSIMDTypeNode*)sym->ast_node,
+                                                              sym->llvm_type);
+                } else {
+                    fprintf(stderr, "SIMD operation %s has no declared vector type\n", op_node->name);
+                }
+                
                 // Add operation to symbol table
                 goo_symbol_table_add(context->symbol_table, op_node->name, GOO_SYMBOL_FUNCTION, 
-                                   NULL, (GooNode*)op_node, NULL);
+                                   op_func, (GooNode*)op_node,
+                                   op_func ? LLVMGlobalGetValueType(op_func) : NULL);
                 break;
             }
             
@@ -3663,6 +3744,10 @@ LLVMValueRef goo_codegen_comptime_simd(GooCodegenContext* context, GooNode* node
         decl = decl->next;
     }
     
+    if (saved_block) {
+        LLVMPositionBuilderAtEnd(context->builder, saved_block);
+    }
+    
     // Return a dummy value (SIMD blocks don't produce values at runtime)
     return LLVMConstInt(LLVMInt32TypeInContext(context->context), 0, 0);
 }
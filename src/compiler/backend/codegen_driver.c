@@ -9,7 +9,9 @@
 #include "parser.h"
 #include "lexer.h"
 #include "codegen.h"
+#include "codegen_parallel.h"
 #include "context.h"
+#include "../optimizer/escape_analysis.h"
 
 // Parse a file and return the AST
 static GooAst* parse_file(const char* filename) {
@@ -53,6 +55,7 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "  -O<level>           Set optimization level (0-3, default: 2)\n");
         fprintf(stderr, "  -emit-llvm          Emit LLVM IR in addition to object code\n");
         fprintf(stderr, "  -S                  Emit assembly instead of object code\n");
+        fprintf(stderr, "  -j <jobs>           Optimize and compile on this many threads (default: 1)\n");
         fprintf(stderr, "  -target <triple>    Specify target triple\n");
         fprintf(stderr, "  -cpu <cpu>          Specify target CPU\n");
         fprintf(stderr, "  -features <features> Specify target features\n");
@@ -68,6 +71,7 @@ int main(int argc, char *argv[]) {
     int opt_level = 2;
     bool emit_llvm = false;
     bool emit_assembly = false;
+    int jobs = 1;
     
     // Configure the context with defaults
     goo_context_set_mode(goo_ctx, GOO_MODE_COMPILE);
@@ -109,6 +113,14 @@ int main(int argc, char *argv[]) {
                 if (dot) *dot = '\0';
                 strcat(output_file, ".s");
             }
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+            if (jobs < 1 || jobs > GOO_CODEGEN_MAX_JOBS) {
+                fprintf(stderr, "Invalid job count: %d (must be 1-%d)\n", jobs, GOO_CODEGEN_MAX_JOBS);
+                free(output_file);
+                goo_context_free(goo_ctx);
+                return 1;
+            }
         } else if (strcmp(argv[i], "-target") == 0 && i + 1 < argc) {
             goo_context_set_target_triple(goo_ctx, argv[++i]);
         } else if (strcmp(argv[i], "-cpu") == 0 && i + 1 < argc) {
@@ -152,6 +164,10 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    // Escape analysis decides which allocations code generation may put on
+    // the stack or in the call arena
+    optimize_escape_analysis(ast);
+    
     // Initialize the code generator
     GooCodegenContext* codegen_ctx = goo_codegen_init(ast, goo_ctx, goo_ctx->module_name);
     if (!codegen_ctx) {
@@ -162,6 +178,23 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    // Object files can be optimized and compiled in parallel partitions; the
+    // other outputs need the whole optimized module
+    if (jobs > 1 && !emit_llvm && !emit_assembly && goo_ctx->mode == GOO_MODE_COMPILE) {
+        bool compiled = goo_codegen_compile_parallel(codegen_ctx, output_file, jobs);
+        goo_codegen_free(codegen_ctx);
+        free_ast(ast);
+        free(output_file);
+        if (!compiled) {
+            fprintf(stderr, "Failed to compile in parallel\n");
+            goo_context_free(goo_ctx);
+            return 1;
+        }
+        printf("Compilation successful: %s -> %s\n", input_file, goo_ctx->output_file);
+        goo_context_free(goo_ctx);
+        return 0;
+    }
+    
     // Generate optimized code
     if (!goo_codegen_generate_optimized(codegen_ctx)) {
         fprintf(stderr, "Failed to generate optimized code\n");
@@ -4,6 +4,7 @@
  * Implementation of memory management functions for the Goo compiler's code generation.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -11,6 +12,47 @@
 #include "codegen.h"
 #include "codegen_memory.h"
 #include "../../include/memory.h"
+#include "../optimizer/escape_analysis.h"
+
+// Largest constant-size allocation lowered to alloca
+#define GOO_STACK_ALLOC_MAX 4096
+
+// Largest constant-size allocation placed in the call arena
+#define GOO_ARENA_ALLOC_MAX (256 * 1024)
+
+// Declare a runtime function on first use
+static LLVMValueRef get_runtime_function(GooCodegenContext* context, const char* name, LLVMTypeRef type) {
+    LLVMValueRef func = LLVMGetNamedFunction(context->module, name);
+    if (!func) {
+        func = LLVMAddFunction(context->module, name, type);
+    }
+    return func;
+}
+
+// Builder positioned at the top of the current function's entry block, so
+// allocas and the arena mark dominate every use
+static LLVMBuilderRef create_entry_builder(GooCodegenContext* context) {
+    LLVMBasicBlockRef entry = LLVMGetEntryBasicBlock(context->alloc_placement.function);
+    LLVMBuilderRef builder = LLVMCreateBuilderInContext(context->context);
+    
+    LLVMValueRef first = LLVMGetFirstInstruction(entry);
+    if (first) {
+        LLVMPositionBuilderBefore(builder, first);
+    } else {
+        LLVMPositionBuilderAtEnd(builder, entry);
+    }
+    return builder;
+}
+
+// Whether a block of size_val bytes runs at most once per call with a size
+// no larger than max. Frees of placed memory are dropped, so a placement
+// inside a loop or of dynamic size would grow the frame without bound.
+static bool fits_frame(GooCodegenContext* context, LLVMValueRef size_val, unsigned long long max) {
+    return context->alloc_placement.function &&
+           context->alloc_placement.loop_depth == 0 &&
+           LLVMIsAConstantInt(size_val) &&
+           LLVMConstIntGetZExtValue(size_val) <= max;
+}
 
 LLVMValueRef goo_codegen_memory_init(GooCodegenContext* context) {
     if (!context) return NULL;
@@ -120,6 +162,11 @@ LLVMValueRef goo_codegen_memory_auto_alloc(GooCodegenContext* context, LLVMValue
                                          const char* name) {
     if (!context || !size_val) return NULL;
     
+    // A small fixed-size block that escape analysis proves local needs no cleanup
+    if (goo_codegen_memory_placement(context, name, size_val) == GOO_ALLOC_PLACE_STACK) {
+        return goo_codegen_memory_alloc_placed(context, size_val, GOO_ALLOC_PLACE_STACK, name);
+    }
+    
     // First allocate memory
     LLVMValueRef mem_ptr = goo_codegen_memory_alloc(context, size_val, name);
     if (!mem_ptr) return NULL;
@@ -171,4 +218,199 @@ LLVMValueRef goo_codegen_memory_auto_cleanup(GooCodegenContext* context, LLVMVal
     };
     
     return LLVMBuildCall2(context->builder, LLVMGetElementType(LLVMTypeOf(func)), func, args, 2, "cleanup_registration");
-} 
\ No newline at end of file
+} 
+
+void goo_codegen_memory_function_begin(GooCodegenContext* context, LLVMValueRef function, const char* name) {
+    if (!context) return;
+    
+    memset(&context->alloc_placement, 0, sizeof(context->alloc_placement));
+    context->alloc_placement.function = function;
+    context->alloc_placement.function_name = name;
+}
+
+void goo_codegen_memory_function_end(GooCodegenContext* context) {
+    if (!context || !context->alloc_placement.function) return;
+    
+    GooAllocPlacementState* state = &context->alloc_placement;
+    
+    // Release the call arena on every return path
+    if (state->arena_mark) {
+        LLVMTypeRef i64_type = LLVMInt64TypeInContext(context->context);
+        LLVMTypeRef release_type = LLVMFunctionType(LLVMVoidTypeInContext(context->context), &i64_type, 1, false);
+        LLVMValueRef release_func = get_runtime_function(context, "goo_call_arena_release", release_type);
+        LLVMBuilderRef builder = LLVMCreateBuilderInContext(context->context);
+        
+        for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(state->function); block;
+             block = LLVMGetNextBasicBlock(block)) {
+            LLVMValueRef terminator = LLVMGetBasicBlockTerminator(block);
+            if (terminator && LLVMGetInstructionOpcode(terminator) == LLVMRet) {
+                LLVMPositionBuilderBefore(builder, terminator);
+                LLVMBuildCall2(builder, release_type, release_func, &state->arena_mark, 1, "");
+            }
+        }
+        
+        LLVMDisposeBuilder(builder);
+    }
+    
+    // Keep the counters with the function so they show up in emitted IR
+    unsigned eliminated = state->stack_allocs + state->arena_allocs;
+    if (eliminated > 0) {
+        char value[16];
+        snprintf(value, sizeof(value), "%u", eliminated);
+        const char* key = "goo-heap-allocs-eliminated";
+        LLVMAttributeRef attr = LLVMCreateStringAttribute(context->context, key, (unsigned)strlen(key),
+                                                          value, (unsigned)strlen(value));
+        LLVMAddAttributeAtIndex(state->function, LLVMAttributeFunctionIndex, attr);
+    }
+    
+    if (context->mode == GOO_MODE_PROFILE && (eliminated > 0 || state->heap_allocs > 0)) {
+        printf("Allocation placement: %s: %u stack, %u arena, %u heap (%u frees dropped)\n",
+               state->function_name ? state->function_name : "<anonymous>",
+               state->stack_allocs, state->arena_allocs, state->heap_allocs, state->elided_frees);
+    }
+    
+    memset(state, 0, sizeof(*state));
+}
+
+GooAllocPlacement goo_codegen_memory_placement(GooCodegenContext* context, const char* var_name, 
+                                             LLVMValueRef size_val) {
+    if (!context || !var_name || !size_val) return GOO_ALLOC_PLACE_HEAP;
+    
+    AllocEscapeState escape;
+    if (!escape_analysis_lookup(context->alloc_placement.function_name, var_name, &escape)) {
+        return GOO_ALLOC_PLACE_HEAP;
+    }
+    
+    // Only allocations proven local to the call may die with it. Arguments
+    // are not followed into callees, so a callee (or a deferred call) may
+    // keep the pointer past the return; unanalyzed ones may escape anyhow.
+    if (escape != ALLOC_NO_ESCAPE) {
+        return GOO_ALLOC_PLACE_HEAP;
+    }
+    
+    // Local and small: one frame slot
+    if (fits_frame(context, size_val, GOO_STACK_ALLOC_MAX)) {
+        return GOO_ALLOC_PLACE_STACK;
+    }
+    
+    // Local but too large for the frame
+    if (fits_frame(context, size_val, GOO_ARENA_ALLOC_MAX)) {
+        return GOO_ALLOC_PLACE_ARENA;
+    }
+    
+    // In a loop, of dynamic size, or too large to bound
+    return GOO_ALLOC_PLACE_HEAP;
+}
+
+LLVMValueRef goo_codegen_memory_alloc_placed(GooCodegenContext* context, LLVMValueRef size_val, 
+                                           GooAllocPlacement placement, const char* name) {
+    if (!context || !size_val) return NULL;
+    
+    GooAllocPlacementState* state = &context->alloc_placement;
+    LLVMTypeRef i8_type = LLVMInt8TypeInContext(context->context);
+    LLVMTypeRef i8_ptr_type = LLVMPointerType(i8_type, 0);
+    LLVMTypeRef i64_type = LLVMInt64TypeInContext(context->context);
+    
+    // Placement needs a function to put the slot or arena mark in
+    if (!state->function) {
+        placement = GOO_ALLOC_PLACE_HEAP;
+    }
+    
+    switch (placement) {
+        case GOO_ALLOC_PLACE_STACK: {
+            unsigned long long size = LLVMConstIntGetZExtValue(size_val);
+            LLVMBuilderRef builder = create_entry_builder(context);
+            LLVMTypeRef slot_type = LLVMArrayType(i8_type, size > 0 ? (unsigned)size : 1);
+            LLVMValueRef slot = LLVMBuildAlloca(builder, slot_type, name ? name : "stack_alloc");
+            LLVMSetAlignment(slot, 16);
+            LLVMValueRef ptr = LLVMBuildBitCast(builder, slot, i8_ptr_type, "stack_ptr");
+            LLVMDisposeBuilder(builder);
+            
+            state->stack_allocs++;
+            return ptr;
+        }
+        
+        case GOO_ALLOC_PLACE_ARENA: {
+            // Mark the arena once per call, on entry
+            if (!state->arena_mark) {
+                LLVMTypeRef mark_type = LLVMFunctionType(i64_type, NULL, 0, false);
+                LLVMValueRef mark_func = get_runtime_function(context, "goo_call_arena_mark", mark_type);
+                LLVMBuilderRef builder = create_entry_builder(context);
+                state->arena_mark = LLVMBuildCall2(builder, mark_type, mark_func, NULL, 0, "arena_mark");
+                LLVMDisposeBuilder(builder);
+            }
+            
+            LLVMTypeRef alloc_type = LLVMFunctionType(i8_ptr_type, &i64_type, 1, false);
+            LLVMValueRef alloc_func = get_runtime_function(context, "goo_call_arena_alloc", alloc_type);
+            
+            state->arena_allocs++;
+            LLVMValueRef ptr = LLVMBuildCall2(context->builder, alloc_type, alloc_func, &size_val, 1,
+                                              name ? name : "arena_alloc");
+            
+            // Deep recursion can still exhaust the arena
+            LLVMBasicBlockRef oom_block = LLVMAppendBasicBlockInContext(context->context, state->function,
+                                                                        "arena_oom");
+            LLVMBasicBlockRef ok_block = LLVMAppendBasicBlockInContext(context->context, state->function,
+                                                                       "arena_ok");
+            LLVMValueRef is_null = LLVMBuildIsNull(context->builder, ptr, "arena_failed");
+            LLVMBuildCondBr(context->builder, is_null, oom_block, ok_block);
+            
+            LLVMPositionBuilderAtEnd(context->builder, oom_block);
+            LLVMTypeRef oom_type = LLVMFunctionType(LLVMVoidTypeInContext(context->context), &i64_type, 1, false);
+            LLVMValueRef oom_func = get_runtime_function(context, "goo_runtime_out_of_memory", oom_type);
+            LLVMBuildCall2(context->builder, oom_type, oom_func, &size_val, 1, "");
+            LLVMBuildUnreachable(context->builder);
+            
+            LLVMPositionBuilderAtEnd(context->builder, ok_block);
+            return ptr;
+        }
+        
+        case GOO_ALLOC_PLACE_HEAP:
+        default:
+            state->heap_allocs++;
+            return goo_codegen_memory_alloc(context, size_val, name);
+    }
+}
+
+LLVMValueRef goo_codegen_memory_alloc_var(GooCodegenContext* context, const char* var_name, 
+                                        LLVMValueRef size_val) {
+    if (!context || !size_val) return NULL;
+    
+    GooAllocPlacementState* state = &context->alloc_placement;
+    GooAllocPlacement placement = goo_codegen_memory_placement(context, var_name, size_val);
+    
+    // Frees are matched by variable; without room to remember it, stay on the heap
+    if (var_name && state->placed_count >= GOO_MAX_PLACED_ALLOCS) {
+        placement = GOO_ALLOC_PLACE_HEAP;
+    }
+    
+    LLVMValueRef ptr = goo_codegen_memory_alloc_placed(context, size_val, placement, var_name);
+    if (!ptr) return NULL;
+    
+    if (var_name && state->placed_count < GOO_MAX_PLACED_ALLOCS) {
+        state->placed[state->placed_count].name = var_name;
+        state->placed[state->placed_count].placement = placement;
+        state->placed_count++;
+    }
+    
+    return ptr;
+}
+
+LLVMValueRef goo_codegen_memory_free_var(GooCodegenContext* context, const char* var_name, 
+                                       LLVMValueRef ptr_val, LLVMValueRef size_val) {
+    if (!context || !ptr_val || !size_val) return NULL;
+    
+    // Latest binding first, so an inner variable shadows an outer one
+    GooAllocPlacementState* state = &context->alloc_placement;
+    if (var_name) {
+        for (int i = state->placed_count - 1; i >= 0; i--) {
+            if (strcmp(state->placed[i].name, var_name) == 0) {
+                if (state->placed[i].placement == GOO_ALLOC_PLACE_HEAP) break;
+                state->elided_frees++;
+                return NULL;
+            }
+        }
+    }
+    
+    return goo_codegen_memory_free(context, ptr_val, size_val);
+}
@@ -128,6 +128,72 @@ LLVMValueRef goo_codegen_memory_alloc_or_panic(GooCodegenContext* context, LLVMV
 LLVMValueRef goo_codegen_memory_auto_alloc(GooCodegenContext* context, LLVMValueRef size_val, 
                                          const char* name);
 
+/**
+ * Start allocation placement for a function whose entry block exists.
+ * 
+ * @param context The code generation context
+ * @param function The function being generated
+ * @param name The function name, used to look up escape analysis results
+ */
+void goo_codegen_memory_function_begin(GooCodegenContext* context, LLVMValueRef function, const char* name);
+
+/**
+ * Finish allocation placement for the current function: release the call
+ * arena before every return and record the placement counters.
+ * 
+ * @param context The code generation context
+ */
+void goo_codegen_memory_function_end(GooCodegenContext* context);
+
+/**
+ * Decide where an allocation bound to a variable can live, based on its
+ * escape state, its size and whether it is inside a loop.
+ * 
+ * @param context The code generation context
+ * @param var_name The variable the allocation is bound to (NULL if unbound)
+ * @param size_val The LLVM value representing the size to allocate
+ * @return The placement for the allocation
+ */
+GooAllocPlacement goo_codegen_memory_placement(GooCodegenContext* context, const char* var_name, 
+                                             LLVMValueRef size_val);
+
+/**
+ * Generate code to allocate memory with the given placement.
+ * 
+ * @param context The code generation context
+ * @param size_val The LLVM value representing the size to allocate
+ * @param placement Where the memory lives
+ * @param name The name for the result variable
+ * @return The LLVM value representing the allocated memory
+ */
+LLVMValueRef goo_codegen_memory_alloc_placed(GooCodegenContext* context, LLVMValueRef size_val, 
+                                           GooAllocPlacement placement, const char* name);
+
+/**
+ * Generate code to allocate memory bound to a variable, placed according to
+ * escape analysis, and remember the placement for later frees.
+ * 
+ * @param context The code generation context
+ * @param var_name The variable the allocation is bound to (NULL if unbound)
+ * @param size_val The LLVM value representing the size to allocate
+ * @return The LLVM value representing the allocated memory
+ */
+LLVMValueRef goo_codegen_memory_alloc_var(GooCodegenContext* context, const char* var_name, 
+                                        LLVMValueRef size_val);
+
+/**
+ * Generate code to free memory bound to a variable. Frees of stack and
+ * arena allocations are dropped.
+ * 
+ * @param context The code generation context
+ * @param var_name The variable holding the pointer (NULL if not a variable)
+ * @param ptr_val The LLVM value representing the pointer to free
+ * @param size_val The LLVM value representing the size of the allocation
+ * @return The LLVM value representing the result of the free, or NULL if dropped
+ */
+LLVMValueRef goo_codegen_memory_free_var(GooCodegenContext* context, const char* var_name, 
+                                       LLVMValueRef ptr_val, LLVMValueRef size_val);
+
 /**
  * Generate code to register a cleanup function for automatically managed memory.
  * 
@@ -0,0 +1,802 @@
+/**
+ * codegen_parallel.c
+ *
+ * Parallel backend for the Goo compiler.
+ *
+ * Code generation itself stays serial. The finished module is split into
+ * partitions by grouping symbols with a union-find, so that no partition
+ * needs another partition's local symbols: internal functions and globals
+ * join every symbol that uses them, and alwaysinline callees join their
+ * callers. Groups are then spread over the partitions by instruction count,
+ * largest first. Module-level state (non-local global variables, constructor
+ * lists) lives in partition 0.
+ *
+ * Small functions called from another partition are copied into the caller's
+ * partition as available_externally, so the inliner still sees them while
+ * only their owner emits them.
+ *
+ * Every partition is rebuilt in its own LLVMContext from one bitcode image of
+ * the module, so symbols are matched by their position in the module. The
+ * Goo passes of the pipeline run once on the whole module before it is split,
+ * since they analyze the whole program and keep process-wide state; the
+ * partitions then run only the LLVM passes, and are compiled on a pool of
+ * threads. The objects are combined with a relocatable link (ld -r).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
+#include <llvm-c/Comdat.h>
+#include <llvm-c/TargetMachine.h>
+#include "codegen.h"
+#include "codegen_parallel.h"
+#include "passes/pass_manager.h"
+
+// Largest function (in instructions) copied into calling partitions
+#define PARALLEL_IMPORT_LIMIT 40
+
+// Symbol and its union-find node
+typedef struct {
+    LLVMValueRef symbol;
+    size_t node;
+} SymbolEntry;
+
+// Call from one function node to a defined, non-local function node
+typedef struct {
+    size_t caller;
+    size_t callee;
+} CallEdge;
+
+// Grouping state for one module. Node 0 anchors partition 0; functions and
+// then global variables follow in module order.
+typedef struct {
+    size_t function_count;
+    size_t global_count;
+    LLVMValueRef* symbols;        // By node; NULL for the anchor
+    SymbolEntry* index;           // Sorted by symbol
+    size_t* parent;
+    size_t* weight;               // Instructions per function node
+    bool* uses_local;             // Function body refers to a local symbol
+    CallEdge* calls;
+    size_t call_count;
+    size_t call_capacity;
+    unsigned always_inline_kind;
+} PartitionBuilder;
+
+// Everything the worker threads need to build and compile partitions
+typedef struct {
+    LLVMMemoryBufferRef bitcode;  // Unoptimized module
+    int partitions;
+    size_t function_count;
+    size_t global_count;
+    int* function_owner;          // Partition per function; -1 for declarations
+    int* global_owner;            // Partition per global; -1 for declarations
+    bool* imported;               // partitions x function_count
+    bool optimize;
+    const char* pipeline;         // LLVM passes to run per partition
+    LLVMTargetMachineRef* machines; // One per partition
+    char** object_files;
+    atomic_int next_partition;
+    atomic_bool failed;
+} ParallelPlan;
+
+static bool is_local(LLVMValueRef symbol) {
+    LLVMLinkage linkage = LLVMGetLinkage(symbol);
+    return linkage == LLVMInternalLinkage || linkage == LLVMPrivateLinkage;
+}
+
+static int compare_symbols(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t)((const SymbolEntry*)a)->symbol;
+    uintptr_t y = (uintptr_t)((const SymbolEntry*)b)->symbol;
+    return x < y ? -1 : x > y;
+}
+
+// Node of a function or global variable, or 0 if it isn't one
+static size_t find_node(const PartitionBuilder* builder, LLVMValueRef symbol) {
+    SymbolEntry key = { symbol, 0 };
+    size_t count = builder->function_count + builder->global_count;
+    SymbolEntry* entry = bsearch(&key, builder->index, count, sizeof(SymbolEntry), compare_symbols);
+    return entry ? entry->node : 0;
+}
+
+static size_t find_root(PartitionBuilder* builder, size_t node) {
+    while (builder->parent[node] != node) {
+        builder->parent[node] = builder->parent[builder->parent[node]];
+        node = builder->parent[node];
+    }
+    return node;
+}
+
+// Keep two nodes in the same partition; the smaller root wins so the anchor
+// always stays a root
+static void unite(PartitionBuilder* builder, size_t a, size_t b) {
+    a = find_root(builder, a);
+    b = find_root(builder, b);
+    if (a == b) return;
+    if (a < b) {
+        builder->parent[b] = a;
+    } else {
+        builder->parent[a] = b;
+    }
+}
+
+static bool is_function_node(const PartitionBuilder* builder, size_t node) {
+    return node >= 1 && node <= builder->function_count;
+}
+
+static bool add_call(PartitionBuilder* builder, size_t caller, size_t callee) {
+    if (builder->call_count == builder->call_capacity) {
+        size_t capacity = builder->call_capacity ? builder->call_capacity * 2 : 64;
+        CallEdge* calls = realloc(builder->calls, capacity * sizeof(CallEdge));
+        if (!calls) return false;
+        builder->calls = calls;
+        builder->call_capacity = capacity;
+    }
+    builder->calls[builder->call_count++] = (CallEdge){ caller, callee };
+    return true;
+}
+
+// Record that a node refers to a symbol
+static bool add_reference(PartitionBuilder* builder, size_t user, LLVMValueRef symbol) {
+    size_t node = find_node(builder, symbol);
+    if (node == 0) return true;
+
+    if (is_local(symbol)) {
+        unite(builder, user, node);
+        if (is_function_node(builder, user)) {
+            builder->uses_local[user] = true;
+        }
+        return true;
+    }
+
+    if (!is_function_node(builder, node) || LLVMIsDeclaration(symbol)) {
+        return true;
+    }
+
+    // alwaysinline callees must be inlined, so they can't live elsewhere
+    if (LLVMGetEnumAttributeAtIndex(symbol, LLVMAttributeFunctionIndex,
+                                    builder->always_inline_kind)) {
+        unite(builder, user, node);
+        return true;
+    }
+
+    return !is_function_node(builder, user) || add_call(builder, user, node);
+}
+
+// Record the symbols an operand refers to, looking through constant
+// expressions and aggregates
+static bool scan_value(PartitionBuilder* builder, size_t user, LLVMValueRef value) {
+    if (LLVMIsAGlobalValue(value)) {
+        return add_reference(builder, user, value);
+    }
+
+    // A block address needs the function's body in the same module
+    if (LLVMIsABlockAddress(value)) {
+        unite(builder, user, find_node(builder, LLVMGetOperand(value, 0)));
+        return true;
+    }
+
+    if (!LLVMIsAConstant(value)) return true;
+
+    int count = LLVMGetNumOperands(value);
+    for (int i = 0; i < count; i++) {
+        if (!scan_value(builder, user, LLVMGetOperand(value, i))) return false;
+    }
+    return true;
+}
+
+static bool scan_function(PartitionBuilder* builder, size_t node, LLVMValueRef func) {
+    size_t instructions = 0;
+
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block;
+         block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst;
+             inst = LLVMGetNextInstruction(inst)) {
+            int count = LLVMGetNumOperands(inst);
+            for (int i = 0; i < count; i++) {
+                if (!scan_value(builder, node, LLVMGetOperand(inst, i))) return false;
+            }
+            instructions++;
+        }
+    }
+
+    builder->weight[node] = instructions;
+    return true;
+}
+
+static void free_builder(PartitionBuilder* builder) {
+    free(builder->symbols);
+    free(builder->index);
+    free(builder->parent);
+    free(builder->weight);
+    free(builder->uses_local);
+    free(builder->calls);
+}
+
+// Group the module's symbols; false if the module can't be split
+static bool build_groups(PartitionBuilder* builder, LLVMModuleRef module) {
+    memset(builder, 0, sizeof(PartitionBuilder));
+
+    // Aliases would have to follow their aliasees, and personality functions
+    // need their landing pads; neither is generated by Goo today
+    if (LLVMGetFirstGlobalAlias(module) || LLVMGetFirstGlobalIFunc(module)) {
+        return false;
+    }
+
+    for (LLVMValueRef func = LLVMGetFirstFunction(module); func; func = LLVMGetNextFunction(func)) {
+        if (LLVMHasPersonalityFn(func)) return false;
+        builder->function_count++;
+    }
+    for (LLVMValueRef global = LLVMGetFirstGlobal(module); global; global = LLVMGetNextGlobal(global)) {
+        builder->global_count++;
+    }
+
+    size_t count = builder->function_count + builder->global_count;
+    builder->symbols = calloc(count + 1, sizeof(LLVMValueRef));
+    builder->index = malloc((count + 1) * sizeof(SymbolEntry));
+    builder->parent = malloc((count + 1) * sizeof(size_t));
+    builder->weight = calloc(count + 1, sizeof(size_t));
+    builder->uses_local = calloc(count + 1, sizeof(bool));
+    if (!builder->symbols || !builder->index || !builder->parent ||
+        !builder->weight || !builder->uses_local) {
+        fprintf(stderr, "Error: Failed to allocate partition state\n");
+        return false;
+    }
+
+    size_t node = 1;
+    for (LLVMValueRef func = LLVMGetFirstFunction(module); func; func = LLVMGetNextFunction(func)) {
+        builder->symbols[node++] = func;
+    }
+    for (LLVMValueRef global = LLVMGetFirstGlobal(module); global; global = LLVMGetNextGlobal(global)) {
+        builder->symbols[node++] = global;
+    }
+    for (size_t i = 0; i <= count; i++) {
+        builder->parent[i] = i;
+        if (i > 0) {
+            builder->index[i - 1] = (SymbolEntry){ builder->symbols[i], i };
+        }
+    }
+    qsort(builder->index, count, sizeof(SymbolEntry), compare_symbols);
+
+    builder->always_inline_kind = LLVMGetEnumAttributeKindForName("alwaysinline", strlen("alwaysinline"));
+
+    for (size_t i = 1; i <= builder->function_count; i++) {
+        if (!scan_function(builder, i, builder->symbols[i])) return false;
+    }
+
+    for (size_t i = builder->function_count + 1; i <= count; i++) {
+        LLVMValueRef global = builder->symbols[i];
+
+        // Non-local variables and constructor lists stay with the anchor
+        if (!is_local(global)) {
+            unite(builder, 0, i);
+        }
+
+        LLVMValueRef init = LLVMGetInitializer(global);
+        if (init && !scan_value(builder, i, init)) return false;
+    }
+
+    return true;
+}
+
+typedef struct {
+    size_t root;
+    size_t weight;
+} GroupWeight;
+
+static int compare_weights(const void* a, const void* b) {
+    size_t x = ((const GroupWeight*)a)->weight;
+    size_t y = ((const GroupWeight*)b)->weight;
+    return x > y ? -1 : x < y;
+}
+
+// Only the owner emits a function, so a copy elsewhere must be equivalent
+// to it: no overridable linkage, no comdat, no local symbols
+static bool is_importable(const PartitionBuilder* builder, size_t node) {
+    LLVMValueRef func = builder->symbols[node];
+    LLVMLinkage linkage = LLVMGetLinkage(func);
+
+    if (linkage != LLVMExternalLinkage && linkage != LLVMLinkOnceODRLinkage &&
+        linkage != LLVMWeakODRLinkage) {
+        return false;
+    }
+
+    unsigned no_inline = LLVMGetEnumAttributeKindForName("noinline", strlen("noinline"));
+    return builder->weight[node] <= PARALLEL_IMPORT_LIMIT && !builder->uses_local[node] &&
+           !LLVMGetComdat(func) &&
+           !LLVMGetEnumAttributeAtIndex(func, LLVMAttributeFunctionIndex, no_inline);
+}
+
+// Assign every group to a partition and pick the functions to import
+static bool assign_partitions(PartitionBuilder* builder, ParallelPlan* plan, int jobs) {
+    size_t count = builder->function_count + builder->global_count;
+    size_t* group_weight = calloc(count + 1, sizeof(size_t));
+    int* group_partition = malloc((count + 1) * sizeof(int));
+    GroupWeight* groups = malloc((count + 1) * sizeof(GroupWeight));
+    bool* has_code = calloc(count + 1, sizeof(bool));
+    size_t* load = calloc((size_t)jobs, sizeof(size_t));
+    int* renumber = malloc((size_t)jobs * sizeof(int));
+    bool result = false;
+
+    if (!group_weight || !group_partition || !groups || !has_code || !load || !renumber) {
+        fprintf(stderr, "Error: Failed to allocate partition state\n");
+        goto cleanup;
+    }
+
+    // Only groups with code are worth spreading; the rest go with the anchor
+    for (size_t i = 1; i <= builder->function_count; i++) {
+        if (LLVMIsDeclaration(builder->symbols[i])) continue;
+        size_t root = find_root(builder, i);
+        group_weight[root] += builder->weight[i] + 1;
+        has_code[root] = true;
+    }
+
+    size_t group_count = 0;
+    for (size_t i = 1; i <= count; i++) {
+        if (find_root(builder, i) == i && has_code[i]) {
+            group_partition[i] = 0;
+            group_count++;
+        } else {
+            group_partition[i] = -1;
+        }
+    }
+    for (size_t i = 1, g = 0; i <= count; i++) {
+        if (group_partition[i] == 0) {
+            groups[g++] = (GroupWeight){ i, group_weight[i] };
+        }
+    }
+    qsort(groups, group_count, sizeof(GroupWeight), compare_weights);
+
+    // Largest group first onto the least loaded partition
+    group_partition[0] = 0;
+    load[0] = group_weight[0];
+    for (size_t g = 0; g < group_count; g++) {
+        int best = 0;
+        for (int p = 1; p < jobs; p++) {
+            if (load[p] < load[best]) best = p;
+        }
+        group_partition[groups[g].root] = best;
+        load[best] += groups[g].weight;
+    }
+
+    // Drop empty partitions; partition 0 always exists for the anchor
+    plan->partitions = 0;
+    for (int p = 0; p < jobs; p++) {
+        renumber[p] = (p == 0 || load[p] > 0) ? plan->partitions++ : -1;
+    }
+
+    plan->function_count = builder->function_count;
+    plan->global_count = builder->global_count;
+    plan->function_owner = malloc((builder->function_count + 1) * sizeof(int));
+    plan->global_owner = malloc((builder->global_count + 1) * sizeof(int));
+    plan->imported = calloc((size_t)plan->partitions * builder->function_count + 1, sizeof(bool));
+    if (!plan->function_owner || !plan->global_owner || !plan->imported) {
+        fprintf(stderr, "Error: Failed to allocate partition state\n");
+        goto cleanup;
+    }
+
+    for (size_t i = 1; i <= count; i++) {
+        int owner = -1;
+        if (!LLVMIsDeclaration(builder->symbols[i])) {
+            int partition = group_partition[find_root(builder, i)];
+            owner = renumber[partition < 0 ? 0 : partition];
+        }
+        if (is_function_node(builder, i)) {
+            plan->function_owner[i - 1] = owner;
+        } else {
+            plan->global_owner[i - 1 - builder->function_count] = owner;
+        }
+    }
+
+    // Unoptimized builds never inline, so there is nothing to import
+    for (size_t e = 0; plan->optimize && e < builder->call_count; e++) {
+        size_t caller = builder->calls[e].caller;
+        size_t callee = builder->calls[e].callee;
+        int partition = plan->function_owner[caller - 1];
+
+        if (partition < 0 || partition == plan->function_owner[callee - 1] ||
+            !is_importable(builder, callee)) {
+            continue;
+        }
+        plan->imported[(size_t)partition * builder->function_count + callee - 1] = true;
+    }
+
+    result = true;
+
+cleanup:
+    free(group_weight);
+    free(group_partition);
+    free(groups);
+    free(has_code);
+    free(load);
+    free(renumber);
+    return result;
+}
+
+// Turn a global variable into a declaration. There is no C API to clear an
+// initializer, so a declaration replaces it.
+static void drop_initializer(LLVMModuleRef module, LLVMValueRef global) {
+    LLVMValueRef decl = LLVMAddGlobalInAddressSpace(module, LLVMGlobalGetValueType(global), "",
+                                                    LLVMGetPointerAddressSpace(LLVMTypeOf(global)));
+    LLVMSetThreadLocalMode(decl, LLVMGetThreadLocalMode(global));
+    LLVMSetGlobalConstant(decl, LLVMIsGlobalConstant(global));
+    LLVMSetExternallyInitialized(decl, LLVMIsExternallyInitialized(global));
+    LLVMSetVisibility(decl, LLVMGetVisibility(global));
+    LLVMSetDLLStorageClass(decl, LLVMGetDLLStorageClass(global));
+    LLVMSetAlignment(decl, LLVMGetAlignment(global));
+
+    size_t length;
+    const char* name = LLVMGetValueName2(global, &length);
+    char* saved = strndup(name, length);
+
+    LLVMReplaceAllUsesWith(global, decl);
+    LLVMDeleteGlobal(global);
+    LLVMSetValueName2(decl, saved, length);
+    free(saved);
+}
+
+// Turn a function into a declaration
+static void strip_body(LLVMValueRef func) {
+    // Values may be used across blocks, so drop every use before erasing
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block;
+         block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst;
+             inst = LLVMGetNextInstruction(inst)) {
+            LLVMTypeRef type = LLVMTypeOf(inst);
+            if (LLVMGetTypeKind(type) != LLVMVoidTypeKind) {
+                LLVMReplaceAllUsesWith(inst, LLVMGetUndef(type));
+            }
+        }
+    }
+
+    LLVMBasicBlockRef block;
+    while ((block = LLVMGetFirstBasicBlock(func))) {
+        LLVMValueRef inst;
+        while ((inst = LLVMGetFirstInstruction(block))) {
+            LLVMInstructionEraseFromParent(inst);
+        }
+        LLVMDeleteBasicBlock(block);
+    }
+
+    LLVMSetLinkage(func, LLVMExternalLinkage);
+    LLVMSetComdat(func, NULL);
+    LLVMGlobalClearMetadata(func);
+}
+
+// Keep a symbol its partition owns even if nothing in the partition uses it
+static void keep_owned(LLVMValueRef symbol) {
+    LLVMLinkage linkage = LLVMGetLinkage(symbol);
+    if (linkage == LLVMLinkOnceAnyLinkage) {
+        LLVMSetLinkage(symbol, LLVMWeakAnyLinkage);
+    } else if (linkage == LLVMLinkOnceODRLinkage) {
+        LLVMSetLinkage(symbol, LLVMWeakODRLinkage);
+    }
+}
+
+// Reduce a copy of the whole module to one partition
+static bool build_partition(const ParallelPlan* plan, LLVMModuleRef module, int partition) {
+    size_t function_count = 0;
+    size_t global_count = 0;
+    for (LLVMValueRef func = LLVMGetFirstFunction(module); func; func = LLVMGetNextFunction(func)) {
+        function_count++;
+    }
+    for (LLVMValueRef global = LLVMGetFirstGlobal(module); global; global = LLVMGetNextGlobal(global)) {
+        global_count++;
+    }
+    if (function_count != plan->function_count || global_count != plan->global_count) {
+        fprintf(stderr, "Error: Partition %d does not match the module\n", partition);
+        return false;
+    }
+
+    // Collect first; symbols are replaced and deleted below
+    LLVMValueRef* functions = malloc((function_count + 1) * sizeof(LLVMValueRef));
+    LLVMValueRef* globals = malloc((global_count + 1) * sizeof(LLVMValueRef));
+    if (!functions || !globals) {
+        fprintf(stderr, "Error: Failed to allocate partition %d\n", partition);
+        free(functions);
+        free(globals);
+        return false;
+    }
+
+    size_t i = 0;
+    for (LLVMValueRef func = LLVMGetFirstFunction(module); func; func = LLVMGetNextFunction(func)) {
+        functions[i++] = func;
+    }
+    i = 0;
+    for (LLVMValueRef global = LLVMGetFirstGlobal(module); global; global = LLVMGetNextGlobal(global)) {
+        globals[i++] = global;
+    }
+
+    // Local symbols of other partitions are only used by those partitions'
+    // symbols, which lose their bodies and initializers here anyway
+    for (i = 0; i < function_count; i++) {
+        int owner = plan->function_owner[i];
+        if (owner >= 0 && owner != partition && is_local(functions[i])) {
+            LLVMReplaceAllUsesWith(functions[i], LLVMGetUndef(LLVMTypeOf(functions[i])));
+            LLVMDeleteFunction(functions[i]);
+            functions[i] = NULL;
+        }
+    }
+    for (i = 0; i < global_count; i++) {
+        int owner = plan->global_owner[i];
+        if (owner >= 0 && owner != partition &&
+            (is_local(globals[i]) || LLVMGetLinkage(globals[i]) == LLVMAppendingLinkage)) {
+            LLVMReplaceAllUsesWith(globals[i], LLVMGetUndef(LLVMTypeOf(globals[i])));
+            LLVMDeleteGlobal(globals[i]);
+            globals[i] = NULL;
+        }
+    }
+
+    for (i = 0; i < function_count; i++) {
+        int owner = plan->function_owner[i];
+        if (!functions[i] || owner < 0) continue;
+
+        if (owner == partition) {
+            keep_owned(functions[i]);
+        } else if (plan->imported[(size_t)partition * function_count + i]) {
+            LLVMSetLinkage(functions[i], LLVMAvailableExternallyLinkage);
+        } else {
+            strip_body(functions[i]);
+        }
+    }
+    for (i = 0; i < global_count; i++) {
+        int owner = plan->global_owner[i];
+        if (!globals[i] || owner < 0) continue;
+
+        if (owner == partition) {
+            keep_owned(globals[i]);
+        } else {
+            drop_initializer(module, globals[i]);
+        }
+    }
+
+    // Module-level assembly may define symbols; emit it once
+    if (partition != 0) {
+        LLVMSetModuleInlineAsm2(module, "", 0);
+    }
+
+    free(functions);
+    free(globals);
+    return true;
+}
+
+// Build, optimize and emit one partition in a context of its own
+static bool compile_partition(ParallelPlan* plan, int partition) {
+    LLVMContextRef llvm_context = LLVMContextCreate();
+    LLVMModuleRef module = NULL;
+    bool result = false;
+
+    if (LLVMParseBitcodeInContext2(llvm_context, plan->bitcode, &module)) {
+        fprintf(stderr, "Error: Failed to load partition %d\n", partition);
+        LLVMContextDispose(llvm_context);
+        return false;
+    }
+
+    if (!build_partition(plan, module, partition)) {
+        goto cleanup;
+    }
+
+    char* error = NULL;
+    if (LLVMVerifyModule(module, LLVMReturnStatusAction, &error)) {
+        fprintf(stderr, "Error: Partition %d is invalid: %s\n", partition, error);
+        LLVMDisposeMessage(error);
+        goto cleanup;
+    }
+    LLVMDisposeMessage(error);
+    error = NULL;
+
+    if (plan->optimize &&
+        !goo_run_pipeline_llvm_passes(module, plan->pipeline, plan->machines[partition])) {
+        fprintf(stderr, "Error: Failed to optimize partition %d\n", partition);
+        goto cleanup;
+    }
+
+    if (LLVMTargetMachineEmitToFile(plan->machines[partition], module,
+                                    plan->object_files[partition], LLVMObjectFile, &error)) {
+        fprintf(stderr, "Could not emit object file: %s\n", error);
+        LLVMDisposeMessage(error);
+        goto cleanup;
+    }
+
+    result = true;
+
+cleanup:
+    LLVMDisposeModule(module);
+    LLVMContextDispose(llvm_context);
+    return result;
+}
+
+static void* partition_worker(void* arg) {
+    ParallelPlan* plan = (ParallelPlan*)arg;
+
+    for (;;) {
+        int partition = atomic_fetch_add(&plan->next_partition, 1);
+        if (partition >= plan->partitions || atomic_load(&plan->failed)) break;
+
+        if (!compile_partition(plan, partition)) {
+            atomic_store(&plan->failed, true);
+        }
+    }
+
+    return NULL;
+}
+
+// Combine the partition objects into one relocatable object
+static bool link_objects(const ParallelPlan* plan, const char* output_file) {
+    const char** args = malloc(((size_t)plan->partitions + 5) * sizeof(char*));
+    if (!args) return false;
+
+    int argc = 0;
+    args[argc++] = "ld";
+    args[argc++] = "-r";
+    args[argc++] = "-o";
+    args[argc++] = output_file;
+    for (int p = 0; p < plan->partitions; p++) {
+        args[argc++] = plan->object_files[p];
+    }
+    args[argc] = NULL;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        execvp(args[0], (char* const*)args);
+        _exit(127);
+    }
+    free(args);
+
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Error: Failed to link partitions into %s\n", output_file);
+        return false;
+    }
+    return true;
+}
+
+static void free_plan(ParallelPlan* plan) {
+    for (int p = 0; p < plan->partitions; p++) {
+        if (plan->machines && plan->machines[p]) {
+            LLVMDisposeTargetMachine(plan->machines[p]);
+        }
+        if (plan->object_files && plan->object_files[p]) {
+            remove(plan->object_files[p]);
+            free(plan->object_files[p]);
+        }
+    }
+    free(plan->machines);
+    free(plan->object_files);
+    free(plan->function_owner);
+    free(plan->global_owner);
+    free(plan->imported);
+    if (plan->bitcode) {
+        LLVMDisposeMemoryBuffer(plan->bitcode);
+    }
+}
+
+// Serial path for modules that aren't worth or able to be split. When the
+// Goo passes of pipeline have already run, only its LLVM passes are left.
+static bool compile_serial(GooCodegenContext* context, const char* output_file,
+                           const char* pipeline) {
+    bool optimized;
+    if (pipeline) {
+        LLVMTargetMachineRef target_machine = goo_codegen_get_target_machine(context);
+        optimized = goo_run_pipeline_llvm_passes(context->module, pipeline, target_machine);
+        if (target_machine) {
+            LLVMDisposeTargetMachine(target_machine);
+        }
+    } else {
+        optimized = goo_codegen_optimize(context);
+    }
+    
+    if (!optimized) {
+        fprintf(stderr, "Failed to optimize code\n");
+        return false;
+    }
+    return goo_codegen_generate_object_file(context, output_file);
+}
+
+bool goo_codegen_compile_parallel(GooCodegenContext* context, const char* output_file, int jobs) {
+    if (!context || !context->goo_context || !output_file) return false;
+
+    if (!goo_codegen_generate_unoptimized(context)) {
+        return false;
+    }
+
+    if (jobs > GOO_CODEGEN_MAX_JOBS) jobs = GOO_CODEGEN_MAX_JOBS;
+    if (jobs <= 1) {
+        return compile_serial(context, output_file, NULL);
+    }
+
+    // Partitions inherit the triple and data layout through the bitcode
+    LLVMTargetMachineRef target_machine = goo_codegen_get_target_machine(context);
+    if (!target_machine) {
+        fprintf(stderr, "Failed to get target machine\n");
+        return false;
+    }
+    char* target_triple = LLVMGetTargetMachineTriple(target_machine);
+    LLVMSetTarget(context->module, target_triple);
+    LLVMDisposeMessage(target_triple);
+    LLVMTargetDataRef data_layout = LLVMCreateTargetDataLayout(target_machine);
+    LLVMSetModuleDataLayout(context->module, data_layout);
+    LLVMDisposeTargetData(data_layout);
+    LLVMDisposeTargetMachine(target_machine);
+
+    ParallelPlan plan;
+    memset(&plan, 0, sizeof(ParallelPlan));
+    plan.optimize = context->goo_context->optimize;
+    if (plan.optimize) {
+        int opt_level = context->goo_context->opt_level;
+        GooOptimizationLevel level = opt_level <= 0 ? GOO_OPT_NONE :
+                                     opt_level >= GOO_OPT_CUSTOM ? GOO_OPT_CUSTOM :
+                                     (GooOptimizationLevel)opt_level;
+        plan.pipeline = goo_get_pipeline(level);
+        
+        // Whole-module Goo passes first, on this thread, before the split
+        if (!plan.pipeline || !goo_run_pipeline_goo_passes(context->module, plan.pipeline)) {
+            fprintf(stderr, "Failed to optimize code\n");
+            return false;
+        }
+    }
+
+    PartitionBuilder builder;
+    bool split = build_groups(&builder, context->module) &&
+                 assign_partitions(&builder, &plan, jobs) && plan.partitions > 1;
+    free_builder(&builder);
+    if (!split) {
+        const char* pipeline = plan.pipeline;
+        free_plan(&plan);
+        return compile_serial(context, output_file, pipeline);
+    }
+
+    plan.bitcode = LLVMWriteBitcodeToMemoryBuffer(context->module);
+    plan.machines = calloc((size_t)plan.partitions, sizeof(LLVMTargetMachineRef));
+    plan.object_files = calloc((size_t)plan.partitions, sizeof(char*));
+    if (!plan.bitcode || !plan.machines || !plan.object_files) {
+        fprintf(stderr, "Error: Failed to prepare partitions\n");
+        free_plan(&plan);
+        return false;
+    }
+
+    // Target machines aren't thread-safe; each partition gets its own
+    size_t name_length = strlen(output_file) + 32;
+    for (int p = 0; p < plan.partitions; p++) {
+        plan.machines[p] = goo_codegen_get_target_machine(context);
+        plan.object_files[p] = malloc(name_length);
+        if (!plan.machines[p] || !plan.object_files[p]) {
+            fprintf(stderr, "Error: Failed to prepare partition %d\n", p);
+            free_plan(&plan);
+            return false;
+        }
+        snprintf(plan.object_files[p], name_length, "%s.part%d.o", output_file, p);
+    }
+
+    atomic_init(&plan.next_partition, 0);
+    atomic_init(&plan.failed, false);
+
+    int thread_count = jobs < plan.partitions ? jobs : plan.partitions;
+    pthread_t threads[GOO_CODEGEN_MAX_JOBS];
+    int started = 0;
+    for (int t = 0; t < thread_count; t++) {
+        if (pthread_create(&threads[t], NULL, partition_worker, &plan) != 0) break;
+        started++;
+    }
+
+    // Without any thread the partitions still compile, just one at a time
+    if (started == 0) {
+        partition_worker(&plan);
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    bool result = !atomic_load(&plan.failed) && link_objects(&plan, output_file);
+    free_plan(&plan);
+    return result;
+}
@@ -0,0 +1,39 @@
+/**
+ * codegen_parallel.h
+ *
+ * Parallel backend for the Goo compiler.
+ * The generated module is split into partitions, each with its own LLVM
+ * context, which are optimized and compiled to objects on separate threads
+ * and then linked into a single relocatable object.
+ */
+
+#ifndef GOO_CODEGEN_PARALLEL_H
+#define GOO_CODEGEN_PARALLEL_H
+
+#include <stdbool.h>
+#include "codegen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most partitions (and threads) one compilation is split into
+#define GOO_CODEGEN_MAX_JOBS 64
+
+/**
+ * Generate, optimize and compile the context's AST to an object file using
+ * up to jobs threads. Falls back to the serial backend when the module can't
+ * be split (a single function, aliases, exception handling).
+ *
+ * @param context The code generation context
+ * @param output_file The object file to write
+ * @param jobs The number of partitions and threads
+ * @return true on success
+ */
+bool goo_codegen_compile_parallel(GooCodegenContext* context, const char* output_file, int jobs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOO_CODEGEN_PARALLEL_H */
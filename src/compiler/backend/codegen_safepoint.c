@@ -0,0 +1,81 @@
+/**
+ * codegen_safepoint.c
+ * 
+ * Implementation of preemption safepoints for the Goo compiler.
+ */
+
+#include <llvm-c/Core.h>
+#include "codegen.h"
+#include "codegen_safepoint.h"
+
+/**
+ * Declare the preemption flag and the yield slow path.
+ */
+void goo_codegen_safepoint_declare_runtime(GooCodegenContext* context) {
+    if (!context) return;
+    
+    // Per-worker request flag, set by the runtime's preemption monitor
+    LLVMValueRef preempt_flag = LLVMGetNamedGlobal(context->module, "goo_preempt_requested");
+    if (!preempt_flag) {
+        preempt_flag = LLVMAddGlobal(context->module,
+            LLVMInt32TypeInContext(context->context), "goo_preempt_requested");
+        LLVMSetLinkage(preempt_flag, LLVMExternalLinkage);
+        LLVMSetThreadLocal(preempt_flag, 1);
+        LLVMSetThreadLocalMode(preempt_flag, LLVMInitialExecTLSModel);
+    }
+    
+    if (LLVMGetNamedFunction(context->module, "goo_safepoint_yield")) return;
+    
+    LLVMValueRef safepoint_yield_func = LLVMAddFunction(context->module, "goo_safepoint_yield",
+        LLVMFunctionType(LLVMVoidTypeInContext(context->context),
+            NULL, 0, 0));
+    
+    // The slow path is rare; keep it out of the hot instruction stream
+    LLVMAddAttributeAtIndex(safepoint_yield_func, LLVMAttributeFunctionIndex,
+        LLVMCreateEnumAttribute(context->context,
+            LLVMGetEnumAttributeKindForName("cold", 4), 0));
+}
+
+// Emit a preemption safepoint: poll the worker's request flag and call the
+// yield slow path only when it is set. The branch is weighted as almost never
+// taken, so the fast path costs one thread-local load and a predicted branch.
+void goo_codegen_safepoint(GooCodegenContext* context) {
+    if (!context || !context->emit_safepoints) return;
+    
+    LLVMValueRef flag = LLVMGetNamedGlobal(context->module, "goo_preempt_requested");
+    LLVMValueRef yield_func = LLVMGetNamedFunction(context->module, "goo_safepoint_yield");
+    if (!flag || !yield_func) return;
+    
+    LLVMBasicBlockRef current_block = LLVMGetInsertBlock(context->builder);
+    if (LLVMGetBasicBlockTerminator(current_block)) return;
+    LLVMValueRef function = LLVMGetBasicBlockParent(current_block);
+    
+    LLVMBasicBlockRef yield_block = LLVMAppendBasicBlockInContext(context->context, function, "safepoint.yield");
+    LLVMBasicBlockRef continue_block = LLVMAppendBasicBlockInContext(context->context, function, "safepoint.cont");
+    
+    // Relaxed atomic load: a plain mov on x86 and AArch64, but never hoisted out of the loop
+    LLVMTypeRef i32_type = LLVMInt32TypeInContext(context->context);
+    LLVMValueRef requested = LLVMBuildLoad2(context->builder, i32_type, flag, "preempt.requested");
+    LLVMSetOrdering(requested, LLVMAtomicOrderingMonotonic);
+    LLVMSetAlignment(requested, 4);
+    
+    LLVMValueRef is_requested = LLVMBuildICmp(context->builder, LLVMIntNE, requested,
+                                              LLVMConstInt(i32_type, 0, 0), "preempt.check");
+    LLVMValueRef branch = LLVMBuildCondBr(context->builder, is_requested, yield_block, continue_block);
+    
+    // !prof !{"branch_weights", i32 1, i32 2000}
+    LLVMMetadataRef weights[] = {
+        LLVMMDStringInContext2(context->context, "branch_weights", 14),
+        LLVMValueAsMetadata(LLVMConstInt(i32_type, 1, 0)),
+        LLVMValueAsMetadata(LLVMConstInt(i32_type, 2000, 0))
+    };
+    LLVMMetadataRef prof = LLVMMDNodeInContext2(context->context, weights, 3);
+    LLVMSetMetadata(branch, LLVMGetMDKindIDInContext(context->context, "prof", 4),
+                    LLVMMetadataAsValue(context->context, prof));
+    
+    LLVMPositionBuilderAtEnd(context->builder, yield_block);
+    LLVMBuildCall2(context->builder, LLVMGlobalGetValueType(yield_func), yield_func, NULL, 0, "");
+    LLVMBuildBr(context->builder, continue_block);
+    
+    LLVMPositionBuilderAtEnd(context->builder, continue_block);
+}
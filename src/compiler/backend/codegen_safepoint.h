@@ -0,0 +1,40 @@
+/**
+ * codegen_safepoint.h
+ * 
+ * Preemption safepoints for the Goo compiler's code generation.
+ * Compiled loops and function prologues poll the runtime's per-worker
+ * goo_preempt_requested flag and call goo_safepoint_yield when it is set.
+ */
+
+#ifndef GOO_CODEGEN_SAFEPOINT_H
+#define GOO_CODEGEN_SAFEPOINT_H
+
+#include <llvm-c/Core.h>
+#include "codegen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Declare the preemption flag and the yield slow path in the module.
+ * 
+ * @param context The code generation context
+ */
+void goo_codegen_safepoint_declare_runtime(GooCodegenContext* context);
+
+/**
+ * Emit a safepoint poll at the builder's position. The builder is left at
+ * the start of the block that continues after the poll. Nothing is emitted
+ * when safepoints are off, the runtime declarations are missing, or the
+ * current block is already terminated.
+ * 
+ * @param context The code generation context
+ */
+void goo_codegen_safepoint(GooCodegenContext* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOO_CODEGEN_SAFEPOINT_H */
@@ -0,0 +1,462 @@
+/**
+ * codegen_simd.c
+ * 
+ * Lowering of comptime SIMD declarations to LLVM vector IR for the Goo
+ * compiler.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <llvm-c/Core.h>
+#include "codegen.h"
+#include "codegen_simd.h"
+
+// Element type of a comptime SIMD vector, or NULL if unsupported
+static LLVMTypeRef simd_element_type(GooCodegenContext* context, GooVectorDataType data_type) {
+    switch (data_type) {
+        case GOO_VEC_INT8:
+        case GOO_VEC_UINT8:
+            return LLVMInt8TypeInContext(context->context);
+        case GOO_VEC_INT16:
+        case GOO_VEC_UINT16:
+            return LLVMInt16TypeInContext(context->context);
+        case GOO_VEC_INT32:
+        case GOO_VEC_UINT32:
+            return LLVMInt32TypeInContext(context->context);
+        case GOO_VEC_INT64:
+        case GOO_VEC_UINT64:
+            return LLVMInt64TypeInContext(context->context);
+        case GOO_VEC_FLOAT:
+            return LLVMFloatTypeInContext(context->context);
+        case GOO_VEC_DOUBLE:
+            return LLVMDoubleTypeInContext(context->context);
+        default:
+            return NULL;
+    }
+}
+
+static bool simd_is_float(GooVectorDataType data_type) {
+    return data_type == GOO_VEC_FLOAT || data_type == GOO_VEC_DOUBLE;
+}
+
+static bool simd_is_unsigned(GooVectorDataType data_type) {
+    return data_type == GOO_VEC_UINT8 || data_type == GOO_VEC_UINT16 ||
+           data_type == GOO_VEC_UINT32 || data_type == GOO_VEC_UINT64;
+}
+
+// Native vector type of a declared SIMD type, e.g. <4 x float>
+LLVMTypeRef goo_codegen_simd_vector_type(GooCodegenContext* context, GooSIMDTypeNode* type_node) {
+    if (!context || !type_node) return NULL;
+    
+    LLVMTypeRef elem_type = simd_element_type(context, type_node->data_type);
+    if (!elem_type) {
+        fprintf(stderr, "Unsupported vector element type\n");
+        return NULL;
+    }
+    if (type_node->vector_width < 1 || type_node->vector_width > 64) {
+        fprintf(stderr, "SIMD type %s: vector width must be between 1 and 64\n",
+                type_node->name);
+        return NULL;
+    }
+    
+    return LLVMVectorType(elem_type, (unsigned)type_node->vector_width);
+}
+
+// Mask vector for a SIMD type: one integer of the element width per lane
+static LLVMTypeRef simd_mask_type(GooCodegenContext* context, LLVMTypeRef vec_type) {
+    LLVMTypeRef elem_type = LLVMGetElementType(vec_type);
+    unsigned bits;
+    switch (LLVMGetTypeKind(elem_type)) {
+        case LLVMFloatTypeKind:
+            bits = 32;
+            break;
+        case LLVMDoubleTypeKind:
+            bits = 64;
+            break;
+        default:
+            bits = LLVMGetIntTypeWidth(elem_type);
+            break;
+    }
+    return LLVMVectorType(LLVMIntTypeInContext(context->context, bits), LLVMGetVectorSize(vec_type));
+}
+
+// Call an intrinsic overloaded on the given types, e.g. llvm.fma.v4f32
+static LLVMValueRef simd_call_intrinsic(GooCodegenContext* context, const char* name,
+                                        LLVMTypeRef* overloads, size_t overload_count,
+                                        LLVMValueRef* args, unsigned arg_count, const char* label) {
+    unsigned id = LLVMLookupIntrinsicID(name, strlen(name));
+    if (id == 0) {
+        fprintf(stderr, "Unknown LLVM intrinsic %s\n", name);
+        return NULL;
+    }
+    
+    LLVMValueRef func = LLVMGetIntrinsicDeclaration(context->module, id, overloads, overload_count);
+    LLVMTypeRef func_type = LLVMIntrinsicGetType(context->context, id, overloads, overload_count);
+    return LLVMBuildCall2(context->builder, func_type, func, args, arg_count, label);
+}
+
+// Add an internal, always-inlined helper and position the builder in its
+// entry block. Calls fold into the caller, so vectors stay in registers
+static LLVMValueRef simd_begin_helper(GooCodegenContext* context, const char* name,
+                                      LLVMTypeRef return_type, LLVMTypeRef* params,
+                                      unsigned param_count) {
+    if (LLVMGetNamedFunction(context->module, name)) {
+        fprintf(stderr, "SIMD helper %s is already defined\n", name);
+        return NULL;
+    }
+    
+    LLVMValueRef func = LLVMAddFunction(context->module, name,
+        LLVMFunctionType(return_type, params, param_count, 0));
+    LLVMSetLinkage(func, LLVMInternalLinkage);
+    LLVMAddAttributeAtIndex(func, LLVMAttributeFunctionIndex,
+        LLVMCreateEnumAttribute(context->context,
+            LLVMGetEnumAttributeKindForName("alwaysinline", 12), 0));
+    
+    LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(context->context, func, "entry");
+    LLVMPositionBuilderAtEnd(context->builder, entry);
+    return func;
+}
+
+// Masks are integer vectors of the element width; a lane is set when nonzero,
+// as in the runtime's GooVectorMask
+static LLVMValueRef simd_mask_bits(GooCodegenContext* context, LLVMValueRef mask) {
+    return LLVMBuildICmp(context->builder, LLVMIntNE, mask,
+                         LLVMConstNull(LLVMTypeOf(mask)), "mask.bits");
+}
+
+// Pairwise sum of a power-of-two vector: log2(width) shuffles and adds
+// instead of the strictly ordered llvm.vector.reduce.fadd
+static LLVMValueRef simd_tree_fadd(GooCodegenContext* context, LLVMValueRef vec, unsigned width) {
+    LLVMTypeRef i32_type = LLVMInt32TypeInContext(context->context);
+    LLVMValueRef lanes[64];
+    
+    for (unsigned half = width / 2; half >= 1; half /= 2) {
+        for (unsigned i = 0; i < width; i++) {
+            lanes[i] = i < half ? LLVMConstInt(i32_type, i + half, 0) : LLVMGetUndef(i32_type);
+        }
+        LLVMValueRef upper = LLVMBuildShuffleVector(context->builder, vec,
+            LLVMGetUndef(LLVMTypeOf(vec)), LLVMConstVector(lanes, width), "reduce.upper");
+        vec = LLVMBuildFAdd(context->builder, vec, upper, "reduce.sum");
+    }
+    
+    return LLVMBuildExtractElement(context->builder, vec,
+                                   LLVMConstInt(i32_type, 0, 0), "reduce.result");
+}
+
+// Emit one horizontal reduction helper: SUM, MIN or MAX
+static LLVMValueRef simd_emit_reduce(GooCodegenContext* context, const char* name,
+                                     const char* reduction, GooSIMDTypeNode* type_node,
+                                     LLVMTypeRef vec_type, LLVMTypeRef elem_type) {
+    LLVMValueRef func = simd_begin_helper(context, name, elem_type, &vec_type, 1);
+    if (!func) return NULL;
+    
+    LLVMValueRef vec = LLVMGetParam(func, 0);
+    GooVectorDataType data_type = type_node->data_type;
+    unsigned width = (unsigned)type_node->vector_width;
+    LLVMValueRef result;
+    char intrinsic[64];
+    
+    if (strcmp(reduction, "add") == 0) {
+        if (!simd_is_float(data_type)) {
+            result = simd_call_intrinsic(context, "llvm.vector.reduce.add", &vec_type, 1,
+                                         &vec, 1, "reduce");
+        } else if ((width & (width - 1)) == 0 && width <= 64) {
+            result = simd_tree_fadd(context, vec, width);
+        } else {
+            LLVMValueRef args[] = { LLVMConstReal(elem_type, -0.0), vec };
+            result = simd_call_intrinsic(context, "llvm.vector.reduce.fadd", &vec_type, 1,
+                                         args, 2, "reduce");
+        }
+    } else {
+        // fmin/fmax ignore NaN lanes, matching goo_vectorization_reduce
+        snprintf(intrinsic, sizeof(intrinsic), "llvm.vector.reduce.%s%s",
+                 simd_is_float(data_type) ? "f" : simd_is_unsigned(data_type) ? "u" : "s",
+                 reduction);
+        result = simd_call_intrinsic(context, intrinsic, &vec_type, 1, &vec, 1, "reduce");
+    }
+    
+    if (!result) {
+        LLVMDeleteFunction(func);
+        return NULL;
+    }
+    LLVMBuildRet(context->builder, result);
+    return func;
+}
+
+// Emit the memory and reduction helpers of a declared SIMD type
+void goo_codegen_simd_emit_type_helpers(GooCodegenContext* context, GooSIMDTypeNode* type_node,
+                                        LLVMTypeRef vec_type, GooSIMDTypeHelpers* helpers) {
+    memset(helpers, 0, sizeof(*helpers));
+    if (!context || !type_node || !vec_type) return;
+    
+    LLVMBuilderRef builder = context->builder;
+    LLVMTypeRef elem_type = LLVMGetElementType(vec_type);
+    LLVMTypeRef i32_type = LLVMInt32TypeInContext(context->context);
+    LLVMTypeRef void_type = LLVMVoidTypeInContext(context->context);
+    LLVMTypeRef elem_ptr_type = LLVMPointerType(elem_type, 0);
+    LLVMTypeRef vec_ptr_type = LLVMPointerType(vec_type, 0);
+    LLVMTypeRef mask_type = simd_mask_type(context, vec_type);
+    unsigned alignment = type_node->alignment > 0 ? (unsigned)type_node->alignment :
+        LLVMGetIntTypeWidth(LLVMGetElementType(mask_type)) / 8;
+    LLVMTypeRef overloads[] = { vec_type, vec_ptr_type };
+    char name[160];
+    
+    // Load(elem* p) -> vec
+    snprintf(name, sizeof(name), "%sLoad", type_node->name);
+    LLVMValueRef func = simd_begin_helper(context, name, vec_type, &elem_ptr_type, 1);
+    if (func) {
+        LLVMValueRef ptr = LLVMBuildBitCast(builder, LLVMGetParam(func, 0), vec_ptr_type, "vec.ptr");
+        LLVMValueRef value = LLVMBuildLoad2(builder, vec_type, ptr, "vec");
+        LLVMSetAlignment(value, alignment);
+        LLVMBuildRet(builder, value);
+        helpers->load = func;
+    }
+    
+    // Store(elem* p, vec v)
+    snprintf(name, sizeof(name), "%sStore", type_node->name);
+    LLVMTypeRef store_params[] = { elem_ptr_type, vec_type };
+    func = simd_begin_helper(context, name, void_type, store_params, 2);
+    if (func) {
+        LLVMValueRef ptr = LLVMBuildBitCast(builder, LLVMGetParam(func, 0), vec_ptr_type, "vec.ptr");
+        LLVMValueRef store = LLVMBuildStore(builder, LLVMGetParam(func, 1), ptr);
+        LLVMSetAlignment(store, alignment);
+        LLVMBuildRetVoid(builder);
+        helpers->store = func;
+    }
+    
+    // MaskedLoad(elem* p, mask m, vec passthru) -> vec
+    snprintf(name, sizeof(name), "%sMaskedLoad", type_node->name);
+    LLVMTypeRef masked_load_params[] = { elem_ptr_type, mask_type, vec_type };
+    func = simd_begin_helper(context, name, vec_type, masked_load_params, 3);
+    if (func) {
+        LLVMValueRef args[] = {
+            LLVMBuildBitCast(builder, LLVMGetParam(func, 0), vec_ptr_type, "vec.ptr"),
+            LLVMConstInt(i32_type, alignment, 0),
+            simd_mask_bits(context, LLVMGetParam(func, 1)),
+            LLVMGetParam(func, 2)
+        };
+        LLVMValueRef value = simd_call_intrinsic(context, "llvm.masked.load", overloads, 2,
+                                                 args, 4, "vec");
+        LLVMBuildRet(builder, value);
+        helpers->masked_load = func;
+    }
+    
+    // MaskedStore(elem* p, vec v, mask m)
+    snprintf(name, sizeof(name), "%sMaskedStore", type_node->name);
+    LLVMTypeRef masked_store_params[] = { elem_ptr_type, vec_type, mask_type };
+    func = simd_begin_helper(context, name, void_type, masked_store_params, 3);
+    if (func) {
+        LLVMValueRef args[] = {
+            LLVMGetParam(func, 1),
+            LLVMBuildBitCast(builder, LLVMGetParam(func, 0), vec_ptr_type, "vec.ptr"),
+            LLVMConstInt(i32_type, alignment, 0),
+            simd_mask_bits(context, LLVMGetParam(func, 2))
+        };
+        simd_call_intrinsic(context, "llvm.masked.store", overloads, 2, args, 4, "");
+        LLVMBuildRetVoid(builder);
+        helpers->masked_store = func;
+    }
+    
+    struct { const char* suffix; const char* reduction; LLVMValueRef* func; } reductions[] = {
+        { "ReduceAdd", "add", &helpers->reduce_add },
+        { "ReduceMin", "min", &helpers->reduce_min },
+        { "ReduceMax", "max", &helpers->reduce_max },
+    };
+    for (size_t i = 0; i < sizeof(reductions) / sizeof(reductions[0]); i++) {
+        snprintf(name, sizeof(name), "%s%s", type_node->name, reductions[i].suffix);
+        *reductions[i].func = simd_emit_reduce(context, name, reductions[i].reduction, type_node,
+                                               vec_type, elem_type);
+    }
+}
+
+// Constant vector with every lane set to value
+static LLVMValueRef simd_splat(LLVMValueRef value, unsigned width) {
+    LLVMValueRef lanes[64];
+    for (unsigned i = 0; i < width; i++) {
+        lanes[i] = value;
+    }
+    return LLVMConstVector(lanes, width);
+}
+
+// Integer division with the runtime's guards: a zero divisor gives 0 and
+// signed MIN / -1 gives MAX, instead of undefined behavior
+static LLVMValueRef simd_build_int_div(GooCodegenContext* context, LLVMValueRef a,
+                                       LLVMValueRef b, bool is_unsigned) {
+    LLVMBuilderRef builder = context->builder;
+    LLVMTypeRef vec_type = LLVMTypeOf(a);
+    LLVMTypeRef elem_type = LLVMGetElementType(vec_type);
+    unsigned width = LLVMGetVectorSize(vec_type);
+    unsigned long long min_bits = 1ULL << (LLVMGetIntTypeWidth(elem_type) - 1);
+    LLVMValueRef zero = LLVMConstNull(vec_type);
+    LLVMValueRef one_vec = simd_splat(LLVMConstInt(elem_type, 1, 0), width);
+    
+    LLVMValueRef is_zero = LLVMBuildICmp(builder, LLVMIntEQ, b, zero, "div.zero");
+    LLVMValueRef divisor = LLVMBuildSelect(builder, is_zero, one_vec, b, "div.divisor");
+    
+    if (is_unsigned) {
+        LLVMValueRef quotient = LLVMBuildUDiv(builder, a, divisor, "div");
+        return LLVMBuildSelect(builder, is_zero, zero, quotient, "div.result");
+    }
+    
+    LLVMValueRef min_vec = simd_splat(LLVMConstInt(elem_type, min_bits, 0), width);
+    LLVMValueRef max_vec = simd_splat(LLVMConstInt(elem_type, min_bits - 1, 0), width);
+    LLVMValueRef overflow = LLVMBuildAnd(builder,
+        LLVMBuildICmp(builder, LLVMIntEQ, a, min_vec, "div.is_min"),
+        LLVMBuildICmp(builder, LLVMIntEQ, b, LLVMConstAllOnes(vec_type), "div.is_neg1"),
+        "div.overflow");
+    divisor = LLVMBuildSelect(builder, overflow, one_vec, divisor, "div.divisor");
+    
+    LLVMValueRef quotient = LLVMBuildSDiv(builder, a, divisor, "div");
+    quotient = LLVMBuildSelect(builder, overflow, max_vec, quotient, "div.saturated");
+    return LLVMBuildSelect(builder, is_zero, zero, quotient, "div.result");
+}
+
+// Integer multiply clamped to the lane range, as the runtime's safe kernels
+// do; the fixed-point intrinsic with scale 0 is a plain saturating multiply
+static LLVMValueRef simd_build_sat_mul(GooCodegenContext* context, LLVMTypeRef vec_type,
+                                       LLVMValueRef a, LLVMValueRef b, bool is_unsigned) {
+    LLVMValueRef args[] = { a, b, LLVMConstInt(LLVMInt32TypeInContext(context->context), 0, 0) };
+    return simd_call_intrinsic(context, is_unsigned ? "llvm.umul.fix.sat" : "llvm.smul.fix.sat",
+                               &vec_type, 1, args, 3, "vmul");
+}
+
+// Emit a declared SIMD operation as an inlinable function on vector values
+LLVMValueRef goo_codegen_simd_emit_operation(GooCodegenContext* context, GooSIMDOpNode* op_node,
+                                             GooSIMDTypeNode* type_node, LLVMTypeRef vec_type) {
+    if (!context || !op_node || !type_node || !vec_type) return NULL;
+    
+    LLVMBuilderRef builder = context->builder;
+    GooVectorDataType data_type = type_node->data_type;
+    bool is_float = simd_is_float(data_type);
+    bool is_unsigned = simd_is_unsigned(data_type);
+    GooVectorOp op = op_node->op;
+    
+    if (op == GOO_VECTOR_MUL && op_node->is_fused) {
+        op = GOO_VECTOR_FMA;
+    }
+    
+    unsigned arity;
+    switch (op) {
+        case GOO_VECTOR_ADD:
+        case GOO_VECTOR_SUB:
+        case GOO_VECTOR_MUL:
+        case GOO_VECTOR_DIV:
+            arity = 2;
+            break;
+        case GOO_VECTOR_FMA:
+            arity = 3;
+            break;
+        case GOO_VECTOR_ABS:
+            arity = 1;
+            break;
+        case GOO_VECTOR_SQRT:
+            if (!is_float) {
+                fprintf(stderr, "SIMD operation %s: SQRT requires a floating-point vector type\n",
+                        op_node->name);
+                return NULL;
+            }
+            arity = 1;
+            break;
+        default:
+            // Custom operations are supplied by the program, not generated
+            return NULL;
+    }
+    
+    LLVMTypeRef params[4] = { vec_type, vec_type, vec_type, vec_type };
+    unsigned param_count = arity;
+    if (op_node->is_masked) {
+        params[param_count++] = simd_mask_type(context, vec_type);
+    }
+    
+    LLVMValueRef func = simd_begin_helper(context, op_node->name, vec_type, params, param_count);
+    if (!func) return NULL;
+    
+    LLVMValueRef a = LLVMGetParam(func, 0);
+    LLVMValueRef b = arity > 1 ? LLVMGetParam(func, 1) : NULL;
+    const char* saturating = NULL;
+    LLVMValueRef result = NULL;
+    
+    switch (op) {
+        case GOO_VECTOR_ADD:
+            if (is_float) {
+                result = LLVMBuildFAdd(builder, a, b, "vadd");
+            } else if (type_node->is_safe) {
+                saturating = is_unsigned ? "llvm.uadd.sat" : "llvm.sadd.sat";
+            } else {
+                result = LLVMBuildAdd(builder, a, b, "vadd");
+            }
+            break;
+        case GOO_VECTOR_SUB:
+            if (is_float) {
+                result = LLVMBuildFSub(builder, a, b, "vsub");
+            } else if (type_node->is_safe) {
+                saturating = is_unsigned ? "llvm.usub.sat" : "llvm.ssub.sat";
+            } else {
+                result = LLVMBuildSub(builder, a, b, "vsub");
+            }
+            break;
+        case GOO_VECTOR_MUL:
+            if (is_float) {
+                result = LLVMBuildFMul(builder, a, b, "vmul");
+            } else if (type_node->is_safe) {
+                result = simd_build_sat_mul(context, vec_type, a, b, is_unsigned);
+            } else {
+                result = LLVMBuildMul(builder, a, b, "vmul");
+            }
+            break;
+        case GOO_VECTOR_DIV:
+            result = is_float ? LLVMBuildFDiv(builder, a, b, "vdiv") :
+                                simd_build_int_div(context, a, b, is_unsigned);
+            break;
+        case GOO_VECTOR_FMA: {
+            LLVMValueRef c = LLVMGetParam(func, 2);
+            if (is_float) {
+                LLVMValueRef args[] = { a, b, c };
+                result = simd_call_intrinsic(context, "llvm.fma", &vec_type, 1, args, 3, "vfma");
+            } else if (type_node->is_safe) {
+                // Clamp the product before the add, so a * b + c saturates
+                // the same way a MUL followed by an ADD would
+                LLVMValueRef args[] = { simd_build_sat_mul(context, vec_type, a, b, is_unsigned), c };
+                if (args[0]) {
+                    result = simd_call_intrinsic(context, is_unsigned ? "llvm.uadd.sat" : "llvm.sadd.sat",
+                                                 &vec_type, 1, args, 2, "vfma");
+                }
+            } else {
+                result = LLVMBuildAdd(builder, LLVMBuildMul(builder, a, b, "vmul"), c, "vfma");
+            }
+            break;
+        }
+        case GOO_VECTOR_ABS:
+            if (is_float) {
+                result = simd_call_intrinsic(context, "llvm.fabs", &vec_type, 1, &a, 1, "vabs");
+            } else if (is_unsigned) {
+                result = a;
+            } else {
+                // INT_MIN stays INT_MIN rather than being poison
+                LLVMValueRef args[] = { a, LLVMConstInt(LLVMInt1TypeInContext(context->context), 0, 0) };
+                result = simd_call_intrinsic(context, "llvm.abs", &vec_type, 1, args, 2, "vabs");
+            }
+            break;
+        default:
+            result = simd_call_intrinsic(context, "llvm.sqrt", &vec_type, 1, &a, 1, "vsqrt");
+            break;
+    }
+    
+    if (saturating) {
+        LLVMValueRef args[] = { a, b };
+        result = simd_call_intrinsic(context, saturating, &vec_type, 1, args, 2, "vsat");
+    }
+    
+    if (!result) {
+        LLVMDeleteFunction(func);
+        return NULL;
+    }
+    
+    if (op_node->is_masked) {
+        LLVMValueRef mask = simd_mask_bits(context, LLVMGetParam(func, arity));
+        result = LLVMBuildSelect(builder, mask, result, a, "vmasked");
+    }
+    
+    LLVMBuildRet(builder, result);
+    return func;
+}
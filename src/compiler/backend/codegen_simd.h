@@ -0,0 +1,76 @@
+/**
+ * codegen_simd.h
+ *
+ * Lowering of comptime SIMD declarations to LLVM vector IR for the Goo
+ * compiler. Declared types become native vectors such as <4 x float> and
+ * their operations become internal, always-inlined functions on vector
+ * values, so chained operations stay in registers.
+ */
+
+#ifndef GOO_CODEGEN_SIMD_H
+#define GOO_CODEGEN_SIMD_H
+
+#include <llvm-c/Core.h>
+#include "codegen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Helpers generated for a declared SIMD type, named "<Type><Suffix>";
+// NULL where a helper could not be emitted
+typedef struct {
+    LLVMValueRef load;          // Load(elem* p) -> vec
+    LLVMValueRef store;         // Store(elem* p, vec v)
+    LLVMValueRef masked_load;   // MaskedLoad(elem* p, mask m, vec passthru) -> vec
+    LLVMValueRef masked_store;  // MaskedStore(elem* p, vec v, mask m)
+    LLVMValueRef reduce_add;    // ReduceAdd(vec v) -> elem
+    LLVMValueRef reduce_min;    // ReduceMin(vec v) -> elem
+    LLVMValueRef reduce_max;    // ReduceMax(vec v) -> elem
+} GooSIMDTypeHelpers;
+
+/**
+ * Get the native vector type of a declared SIMD type.
+ *
+ * @param context The code generation context
+ * @param type_node The SIMD type declaration
+ * @return The vector type, or NULL if the element type or width is unsupported
+ */
+LLVMTypeRef goo_codegen_simd_vector_type(GooCodegenContext* context, GooSIMDTypeNode* type_node);
+
+/**
+ * Emit the memory and reduction helpers of a declared SIMD type. Masked
+ * loads and stores leave inactive lanes untouched, so array tails need no
+ * scalar loop. Masks are integer vectors of the element width, as in the
+ * runtime's GooVectorMask. The builder is left in the last helper.
+ *
+ * @param context The code generation context
+ * @param type_node The SIMD type declaration
+ * @param vec_type The type's vector type
+ * @param helpers Receives the emitted helpers
+ */
+void goo_codegen_simd_emit_type_helpers(GooCodegenContext* context, GooSIMDTypeNode* type_node,
+                                        LLVMTypeRef vec_type, GooSIMDTypeHelpers* helpers);
+
+/**
+ * Emit a declared SIMD operation as a function on vector values. Binary ops
+ * take (a, b), FMA (a, b, c) computing a * b + c, ABS and SQRT (a); masked
+ * ops take a trailing mask and keep a's lanes where it is unset. Integer
+ * add, subtract, multiply and FMA saturate on safe types, and integer
+ * division by zero gives 0, as the runtime does. The builder is left in the
+ * emitted function.
+ *
+ * @param context The code generation context
+ * @param op_node The SIMD operation declaration
+ * @param type_node The declaration of the operation's vector type
+ * @param vec_type The type's vector type
+ * @return The function, or NULL for custom operations and errors
+ */
+LLVMValueRef goo_codegen_simd_emit_operation(GooCodegenContext* context, GooSIMDOpNode* op_node,
+                                             GooSIMDTypeNode* type_node, LLVMTypeRef vec_type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOO_CODEGEN_SIMD_H */
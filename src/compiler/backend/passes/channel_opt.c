@@ -453,13 +453,13 @@ bool goo_optimize_channel_op(LLVMModuleRef module, LLVMValueRef channel_op) {
     return true;
 }
 
-// Add the channel optimization pass to a pass manager
-bool goo_add_channel_opt_pass(LLVMPassManagerRef pass_manager) {
-    // Create a module pass that applies all channel optimizations
-    // Note: LLVM-C doesn't provide direct access to create custom passes,
-    // so we would need to use a callback function that applies our optimizations
+// Run the channel optimization pass on a module
+bool goo_channel_opt_run(LLVMModuleRef module) {
+    if (!module) {
+        return false;
+    }
     
-    // In a real implementation, we would register a custom pass using the LLVM C++ API
-    // and then expose it through the C API. For now, we'll just return true.
-    return true;
-} 
\ No newline at end of file
+    return goo_optimize_local_channels(module) &&
+           goo_optimize_channel_buffers(module) &&
+           goo_optimize_channel_batching(module);
+}
@@ -7,8 +7,8 @@
 // Initialize the channel optimization pass
 bool goo_channel_opt_init(void);
 
-// Add the channel optimization pass to a pass manager
-bool goo_add_channel_opt_pass(LLVMPassManagerRef pass_manager);
+// Run the channel optimization pass on a module ("goo-channel-opt" in pipelines)
+bool goo_channel_opt_run(LLVMModuleRef module);
 
 // Clean up resources used by the channel optimization pass
 void goo_channel_opt_cleanup(void);
@@ -7,9 +7,6 @@
 // Initialize the goroutine optimization pass
 bool goo_goroutine_opt_init(void);
 
-// Add the goroutine optimization pass to a pass manager
-bool goo_add_goroutine_opt_pass(LLVMPassManagerRef pass_manager);
-
 // Clean up resources used by the goroutine optimization pass
 void goo_goroutine_opt_cleanup(void);
 
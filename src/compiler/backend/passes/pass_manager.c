@@ -2,16 +2,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <llvm-c/Core.h>
-#include <llvm-c/Analysis.h>
+#include <llvm-c/Error.h>
 #include <llvm-c/Target.h>
-#include <llvm-c/Transforms/Scalar.h>
-#include <llvm-c/Transforms/Vectorize.h>
-#include <llvm-c/Transforms/IPO.h>
-#include <llvm-c/Transforms/PassManagerBuilder.h>
+#include <llvm-c/Transforms/PassBuilder.h>
 #include "pass_manager.h"
 #include "channel_opt.h"
-#include "goroutine_opt.h"
-#include "parallel_opt.h"
 
 // Structure to track pass configuration
 typedef struct {
@@ -56,8 +51,6 @@ static GooPassConfig vectorization_passes[] = {
 
 static GooPassConfig custom_passes[] = {
     {"channel-opt", true, "Optimize channel operations"},
-    {"goroutine-opt", true, "Optimize goroutine spawning and execution"},
-    {"parallel-opt", true, "Optimize parallel execution blocks"},
     {NULL, false, NULL}
 };
 
@@ -79,6 +72,26 @@ static GooPassConfig* get_pass_config_for_group(GooPassGroup group) {
     }
 }
 
+// Goo pass that pipelines can name
+typedef struct {
+    const char* name;
+    GooModulePassFn run;
+    const GooPassConfig* config;   // Enable flag, or NULL if always enabled
+} GooModulePass;
+
+// Built-in passes, followed by the ones registered at run time
+#define BUILTIN_MODULE_PASSES 1
+
+static GooModulePass module_passes[GOO_MAX_MODULE_PASSES] = {
+    {"goo-channel-opt", goo_channel_opt_run, &custom_passes[0]},
+};
+static int module_pass_count = BUILTIN_MODULE_PASSES;
+
+// Goo passes first, so LLVM cleans up after their rewrites
+#define DEFAULT_CUSTOM_PIPELINE "goo-channel-opt,default<O3>"
+
+static char* custom_pipeline = NULL;
+
 // Initialize the pass manager system
 bool goo_pass_manager_init(void) {
     // Initialize LLVM targets
@@ -90,162 +103,210 @@ bool goo_pass_manager_init(void) {
     
     // Initialize custom passes
     goo_channel_opt_init();
-    goo_goroutine_opt_init();
-    goo_parallel_opt_init();
     
     return true;
 }
 
-// Create a pass manager for module-level optimizations
-LLVMPassManagerRef goo_create_module_pass_manager(void) {
-    return LLVMCreatePassManager();
-}
-
-// Create a pass manager for function-level optimizations
-LLVMPassManagerRef goo_create_function_pass_manager(LLVMModuleRef module) {
-    return LLVMCreateFunctionPassManagerForModule(module);
+static const GooModulePass* find_module_pass(const char* name, size_t length) {
+    for (int i = 0; i < module_pass_count; i++) {
+        if (strlen(module_passes[i].name) == length &&
+            strncmp(module_passes[i].name, name, length) == 0) {
+            return &module_passes[i];
+        }
+    }
+    return NULL;
 }
 
-// Add standard optimization passes based on specified level
-bool goo_add_optimization_passes(LLVMPassManagerRef pass_manager, 
-                               GooOptimizationLevel level,
-                               LLVMTargetMachineRef target_machine) {
-    
-    // If optimization is disabled, do nothing
-    if (level == GOO_OPT_NONE) {
-        return true;
+// Register a Goo pass under a name that pipeline strings can use
+bool goo_register_module_pass(const char* name, GooModulePassFn run) {
+    if (!name || !*name || !run) {
+        return false;
     }
     
-    // Create a pass manager builder
-    LLVMPassManagerBuilderRef builder = LLVMPassManagerBuilderCreate();
-    
-    // Configure the pass manager builder based on optimization level
-    switch (level) {
-        case GOO_OPT_BASIC:
-            LLVMPassManagerBuilderSetOptLevel(builder, 1);
-            LLVMPassManagerBuilderSetSizeLevel(builder, 0);
-            break;
-            
-        case GOO_OPT_MODERATE:
-            LLVMPassManagerBuilderSetOptLevel(builder, 2);
-            LLVMPassManagerBuilderSetSizeLevel(builder, 0);
-            LLVMPassManagerBuilderUseInlinerWithThreshold(builder, 225);
-            break;
-            
-        case GOO_OPT_AGGRESSIVE:
-        case GOO_OPT_CUSTOM:  // Custom level includes all aggressive opts
-            LLVMPassManagerBuilderSetOptLevel(builder, 3);
-            LLVMPassManagerBuilderSetSizeLevel(builder, 0);
-            LLVMPassManagerBuilderUseInlinerWithThreshold(builder, 275);
-            break;
-            
-        default:
-            break;
+    if (find_module_pass(name, strlen(name))) {
+        fprintf(stderr, "Error: Pass '%s' is already registered\n", name);
+        return false;
     }
     
-    // Add target-specific passes
-    if (target_machine) {
-        LLVMAddAnalysisPasses(target_machine, pass_manager);
+    if (module_pass_count == GOO_MAX_MODULE_PASSES) {
+        fprintf(stderr, "Error: Too many registered passes\n");
+        return false;
     }
     
-    // Populate the pass manager with standard optimization passes
-    LLVMPassManagerBuilderPopulateModulePassManager(builder, pass_manager);
-    
-    // Add Goo-specific passes for the custom optimization level
-    if (level == GOO_OPT_CUSTOM) {
-        // Add custom passes
-        goo_add_channel_optimization_pass(pass_manager);
-        goo_add_goroutine_optimization_pass(pass_manager);
-        goo_add_parallel_optimization_pass(pass_manager);
+    char* copy = strdup(name);
+    if (!copy) {
+        return false;
     }
     
-    // Clean up
-    LLVMPassManagerBuilderDispose(builder);
-    
+    module_passes[module_pass_count].name = copy;
+    module_passes[module_pass_count].run = run;
+    module_passes[module_pass_count].config = NULL;
+    module_pass_count++;
     return true;
 }
 
-// Add channel optimization pass
-bool goo_add_channel_optimization_pass(LLVMPassManagerRef pass_manager) {
-    // Check if the pass is enabled
-    if (!custom_passes[0].enabled) {
-        return true;
+// Pipeline text for an optimization level
+const char* goo_get_pipeline(GooOptimizationLevel level) {
+    switch (level) {
+        case GOO_OPT_NONE:
+            return "default<O0>";
+        case GOO_OPT_BASIC:
+            return "default<O1>";
+        case GOO_OPT_MODERATE:
+            return "default<O2>";
+        case GOO_OPT_AGGRESSIVE:
+            return "default<O3>";
+        case GOO_OPT_CUSTOM:
+            return custom_pipeline ? custom_pipeline : DEFAULT_CUSTOM_PIPELINE;
+        default:
+            return NULL;
     }
-    
-    // Add the channel optimization pass
-    return goo_add_channel_opt_pass(pass_manager);
 }
 
-// Add goroutine optimization pass
-bool goo_add_goroutine_optimization_pass(LLVMPassManagerRef pass_manager) {
-    // Check if the pass is enabled
-    if (!custom_passes[1].enabled) {
-        return true;
+// Set the pipeline GOO_OPT_CUSTOM runs
+bool goo_set_custom_pipeline(const char* pipeline) {
+    char* copy = NULL;
+    if (pipeline) {
+        copy = strdup(pipeline);
+        if (!copy) {
+            return false;
+        }
     }
     
-    // Add the goroutine optimization pass
-    return goo_add_goroutine_opt_pass(pass_manager);
+    free(custom_pipeline);
+    custom_pipeline = copy;
+    return true;
 }
 
-// Add parallel optimization pass
-bool goo_add_parallel_optimization_pass(LLVMPassManagerRef pass_manager) {
-    // Check if the pass is enabled
-    if (!custom_passes[2].enabled) {
-        return true;
+static bool is_pass_enabled(GooPassConfig* config, const char* name) {
+    for (int i = 0; config[i].name != NULL; i++) {
+        if (strcmp(config[i].name, name) == 0) {
+            return config[i].enabled;
+        }
     }
-    
-    // Add the parallel optimization pass
-    return goo_add_parallel_opt_pass(pass_manager);
+    return true;
 }
 
-// Run optimization passes on a module
-bool goo_run_module_optimizations(GooCodegenContext* context, GooOptimizationLevel level) {
-    if (!context || !context->module) {
-        return false;
-    }
-    
-    // Create a module pass manager
-    LLVMPassManagerRef pass_manager = goo_create_module_pass_manager();
+// Run a run of LLVM pipeline elements
+static bool run_llvm_passes(LLVMModuleRef module, const char* passes,
+                            LLVMTargetMachineRef target_machine) {
+    LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
     
-    // Add optimization passes
-    goo_add_optimization_passes(pass_manager, level, context->target_machine);
+    // Tunables from the pass configuration
+    LLVMPassBuilderOptionsSetLoopVectorization(options, is_pass_enabled(vectorization_passes, "loop-vectorize"));
+    LLVMPassBuilderOptionsSetSLPVectorization(options, is_pass_enabled(vectorization_passes, "slp-vectorize"));
+    LLVMPassBuilderOptionsSetLoopUnrolling(options, is_pass_enabled(loop_passes, "loop-unroll"));
+    LLVMPassBuilderOptionsSetLoopInterleaving(options, is_pass_enabled(vectorization_passes, "loop-vectorize"));
     
-    // Run the passes
-    LLVMRunPassManager(pass_manager, context->module);
+    LLVMErrorRef error = LLVMRunPasses(module, passes, target_machine, options);
+    LLVMDisposePassBuilderOptions(options);
     
-    // Clean up
-    LLVMDisposePassManager(pass_manager);
+    if (error) {
+        char* message = LLVMGetErrorMessage(error);
+        fprintf(stderr, "Error: Failed to run passes \"%s\": %s\n", passes, message);
+        LLVMDisposeErrorMessage(message);
+        return false;
+    }
     
     return true;
 }
 
-// Run optimization passes on a function
-bool goo_run_function_optimizations(GooCodegenContext* context, 
-                                  LLVMValueRef function,
-                                  GooOptimizationLevel level) {
-    if (!context || !context->module || !function) {
+// Run the Goo passes, the LLVM passes, or both, of a pipeline on a module
+static bool run_pipeline(LLVMModuleRef module, const char* pipeline,
+                         LLVMTargetMachineRef target_machine,
+                         bool run_goo, bool run_llvm) {
+    if (!module || !pipeline) {
         return false;
     }
     
-    // Create a function pass manager
-    LLVMPassManagerRef pass_manager = goo_create_function_pass_manager(context->module);
-    
-    // Add optimization passes
-    goo_add_optimization_passes(pass_manager, level, context->target_machine);
-    
-    // Initialize the pass manager
-    LLVMInitializeFunctionPassManager(pass_manager);
+    // LLVM elements between Goo passes are collected and run together
+    size_t length = strlen(pipeline);
+    char* pending = malloc(length + 1);
+    if (!pending) {
+        return false;
+    }
+    size_t pending_length = 0;
+    bool ok = true;
     
-    // Run the passes on the function
-    LLVMRunFunctionPassManager(pass_manager, function);
+    const char* element = pipeline;
+    while (ok && *element) {
+        while (*element == ' ') element++;
+        
+        // Find the end of this top-level element
+        const char* end = element;
+        int depth = 0;
+        for (; *end && (depth > 0 || *end != ','); end++) {
+            if (*end == '(' || *end == '<') depth++;
+            if ((*end == ')' || *end == '>') && depth > 0) depth--;
+        }
+        
+        size_t element_length = (size_t)(end - element);
+        while (element_length > 0 && element[element_length - 1] == ' ') element_length--;
+        if (element_length == 0) {
+            element = *end ? end + 1 : end;
+            continue;
+        }
+        
+        const GooModulePass* pass = find_module_pass(element, element_length);
+        if (!pass) {
+            if (!run_llvm) {
+                element = *end ? end + 1 : end;
+                continue;
+            }
+            if (pending_length > 0) pending[pending_length++] = ',';
+            memcpy(pending + pending_length, element, element_length);
+            pending_length += element_length;
+        } else {
+            if (pending_length > 0) {
+                pending[pending_length] = '\0';
+                ok = run_llvm_passes(module, pending, target_machine);
+                pending_length = 0;
+            }
+            
+            if (ok && run_goo && (!pass->config || pass->config->enabled) && !pass->run(module)) {
+                fprintf(stderr, "Error: Pass '%s' failed\n", pass->name);
+                ok = false;
+            }
+        }
+        
+        element = *end ? end + 1 : end;
+    }
     
-    // Finalize the pass manager
-    LLVMFinalizeFunctionPassManager(pass_manager);
+    if (ok && pending_length > 0) {
+        pending[pending_length] = '\0';
+        ok = run_llvm_passes(module, pending, target_machine);
+    }
     
-    // Clean up
-    LLVMDisposePassManager(pass_manager);
+    free(pending);
+    return ok;
+}
+
+// Run a pipeline on a module
+bool goo_run_pipeline(LLVMModuleRef module, const char* pipeline,
+                      LLVMTargetMachineRef target_machine) {
+    return run_pipeline(module, pipeline, target_machine, true, true);
+}
+
+// Run only the Goo passes a pipeline names
+bool goo_run_pipeline_goo_passes(LLVMModuleRef module, const char* pipeline) {
+    return run_pipeline(module, pipeline, NULL, true, false);
+}
+
+// Run a pipeline with its Goo passes left out
+bool goo_run_pipeline_llvm_passes(LLVMModuleRef module, const char* pipeline,
+                                  LLVMTargetMachineRef target_machine) {
+    return run_pipeline(module, pipeline, target_machine, false, true);
+}
+
+// Run the pipeline for an optimization level on a module
+bool goo_run_module_optimizations(LLVMModuleRef module, GooOptimizationLevel level,
+                                  LLVMTargetMachineRef target_machine) {
+    const char* pipeline = goo_get_pipeline(level);
+    if (!module || !pipeline) {
+        return false;
+    }
     
-    return true;
+    return goo_run_pipeline(module, pipeline, target_machine);
 }
 
 // Configure which passes are enabled/disabled
@@ -287,6 +348,14 @@ const char* goo_get_pass_description(GooPassGroup group, const char* pass_name)
 void goo_pass_manager_cleanup(void) {
     // Clean up custom passes
     goo_channel_opt_cleanup();
-    goo_goroutine_opt_cleanup();
-    goo_parallel_opt_cleanup();
+    
+    // Forget the passes registered at run time
+    for (int i = BUILTIN_MODULE_PASSES; i < module_pass_count; i++) {
+        free((char*)module_passes[i].name);
+        module_passes[i].name = NULL;
+        module_passes[i].run = NULL;
+    }
+    module_pass_count = BUILTIN_MODULE_PASSES;
+    
+    goo_set_custom_pipeline(NULL);
 } 
\ No newline at end of file
@@ -3,11 +3,7 @@
 
 #include <stdbool.h>
 #include <llvm-c/Core.h>
-#include <llvm-c/Analysis.h>
-#include <llvm-c/Transforms/Scalar.h>
-#include <llvm-c/Transforms/Vectorize.h>
-#include <llvm-c/Transforms/IPO.h>
-#include "../../include/codegen.h"
+#include <llvm-c/TargetMachine.h>
 
 // Optimization level definitions
 typedef enum {
@@ -27,34 +23,50 @@ typedef enum {
     GOO_PASS_GROUP_CUSTOM       // Goo-specific optimizations
 } GooPassGroup;
 
+// Goo pass over a whole module; returns false on failure
+typedef bool (*GooModulePassFn)(LLVMModuleRef module);
+
+// Most Goo passes that can be registered, including the built-in ones
+#define GOO_MAX_MODULE_PASSES 16
+
 // Initialize the pass manager system
 bool goo_pass_manager_init(void);
 
-// Create a pass manager for module-level optimizations
-LLVMPassManagerRef goo_create_module_pass_manager(void);
+// Register a Goo pass under a name that pipeline strings can use; the name
+// is copied
+bool goo_register_module_pass(const char* name, GooModulePassFn run);
 
-// Create a pass manager for function-level optimizations
-LLVMPassManagerRef goo_create_function_pass_manager(LLVMModuleRef module);
+// Pipeline text for a level: "default<O0>" to "default<O3>", or the custom
+// pipeline for GOO_OPT_CUSTOM
+const char* goo_get_pipeline(GooOptimizationLevel level);
 
-// Add optimization passes based on specified level
-bool goo_add_optimization_passes(LLVMPassManagerRef pass_manager, 
-                                GooOptimizationLevel level,
-                                LLVMTargetMachineRef target_machine);
+// Set the pipeline GOO_OPT_CUSTOM runs; NULL restores the default, which
+// runs the Goo passes and then default<O3>
+bool goo_set_custom_pipeline(const char* pipeline);
 
-// Add Goo-specific optimization passes
-bool goo_add_channel_optimization_pass(LLVMPassManagerRef pass_manager);
-bool goo_add_goroutine_optimization_pass(LLVMPassManagerRef pass_manager);
-bool goo_add_parallel_optimization_pass(LLVMPassManagerRef pass_manager);
+// Run a pipeline on a module. The text uses LLVM's new pass manager syntax,
+// e.g. "default<O2>" or "function(sroa,instcombine),globaldce"; registered Goo
+// pass names may appear as top-level elements, and run in order with the LLVM
+// passes around them. The target machine may be NULL, but the vectorizers
+// need it to know the vector width.
+bool goo_run_pipeline(LLVMModuleRef module, const char* pipeline,
+                      LLVMTargetMachineRef target_machine);
 
-// Run optimization passes on a module
-bool goo_run_module_optimizations(GooCodegenContext* context, GooOptimizationLevel level);
+// Split a pipeline for backends that optimize a module in pieces: the Goo
+// passes analyze the whole module and keep process-wide state, so they run
+// once, in order, before the LLVM passes run on each piece. Neither runs the
+// other's elements.
+bool goo_run_pipeline_goo_passes(LLVMModuleRef module, const char* pipeline);
+bool goo_run_pipeline_llvm_passes(LLVMModuleRef module, const char* pipeline,
+                                  LLVMTargetMachineRef target_machine);
 
-// Run optimization passes on a function
-bool goo_run_function_optimizations(GooCodegenContext* context, 
-                                  LLVMValueRef function,
-                                  GooOptimizationLevel level);
+// Run the pipeline for an optimization level on a module
+bool goo_run_module_optimizations(LLVMModuleRef module, GooOptimizationLevel level,
+                                  LLVMTargetMachineRef target_machine);
 
-// Configure which passes are enabled/disabled
+// Configure which passes are enabled/disabled. LLVM 14 sets both vectorizers
+// for a default<On> element from its level, so there only the unrolling
+// switch changes what LLVM runs
 bool goo_configure_pass(GooPassGroup group, const char* pass_name, bool enabled);
 
 // Get description of available passes
@@ -20,6 +20,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, lib);
     b.installArtifact(lib);
 
     // Create a shared library
@@ -29,6 +30,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, dylib);
     b.installArtifact(dylib);
 
     // Generate the C header
@@ -42,6 +44,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, test_lexer_exe);
     b.installArtifact(test_lexer_exe);
 
     // Add a step for the lexer error handling test program
@@ -51,6 +54,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, test_lexer_errors_exe);
     b.installArtifact(test_lexer_errors_exe);
 
     // Add a step for the lexer edge cases test program
@@ -60,6 +64,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, test_lexer_edge_cases_exe);
     b.installArtifact(test_lexer_edge_cases_exe);
 
     // Add a run step for the test program
@@ -99,6 +104,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, memory_test);
 
     const run_memory_test = b.addRunArtifact(memory_test);
     // Don't depend on install step which includes the header installation
@@ -111,7 +117,17 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = optimize,
     });
+    addByteScan(b, unit_tests);
     const run_unit_tests = b.addRunArtifact(unit_tests);
     const test_step = b.step("test", "Run unit tests");
     test_step.dependOn(&run_unit_tests.step);
 }
+
+// Byte-class scanning kernels shared with the runtime's GooString
+fn addByteScan(b: *std.Build, step: *std.Build.Step.Compile) void {
+    step.addCSourceFile(.{
+        .file = b.path("../../../../runtime/lang/goo_byte_scan.c"),
+        .flags = &.{"-std=c11"},
+    });
+    step.addIncludePath(b.path("../../../../include"));
+}
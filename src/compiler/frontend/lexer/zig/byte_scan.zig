@@ -0,0 +1,100 @@
+const std = @import("std");
+
+// Byte-class scanning from src/runtime/lang/goo_byte_scan.c, shared with the
+// runtime's GooString. Each call checks 16 bytes per step with SSE2 or NEON.
+const ByteClass = enum(c_int) {
+    whitespace = 0,
+    ident = 1,
+};
+
+extern fn goo_byte_scan_skip(bytes: [*]const u8, length: usize, byte_class: ByteClass) usize;
+extern fn goo_byte_scan_find_quote(bytes: [*]const u8, length: usize, quote: u8) usize;
+extern fn goo_byte_scan_count_newlines(bytes: [*]const u8, length: usize) usize;
+
+/// Number of leading bytes that are whitespace (see character_utils.isWhitespace)
+pub fn skipWhitespace(bytes: []const u8) usize {
+    return goo_byte_scan_skip(bytes.ptr, bytes.len, .whitespace);
+}
+
+/// Number of leading bytes that are identifier characters (see character_utils.isIdentChar)
+pub fn skipIdentifier(bytes: []const u8) usize {
+    return goo_byte_scan_skip(bytes.ptr, bytes.len, .ident);
+}
+
+/// Index of the first quote or backslash, or bytes.len
+pub fn findQuoteOrBackslash(bytes: []const u8, quote: u8) usize {
+    return goo_byte_scan_find_quote(bytes.ptr, bytes.len, quote);
+}
+
+/// Number of '\n' bytes
+pub fn countNewlines(bytes: []const u8) usize {
+    return goo_byte_scan_count_newlines(bytes.ptr, bytes.len);
+}
+
+/// Source position in lines and columns
+pub const Position = struct {
+    line: usize,
+    column: usize,
+};
+
+/// Position after consuming bytes, where a newline moves to column 1 of the
+/// next line and any other byte moves one column right
+pub fn advancePosition(bytes: []const u8, line: usize, column: usize) Position {
+    const newlines = countNewlines(bytes);
+    if (newlines == 0) {
+        return .{ .line = line, .column = column + bytes.len };
+    }
+
+    const last_newline = std.mem.lastIndexOfScalar(u8, bytes, '\n').?;
+    return .{ .line = line + newlines, .column = bytes.len - last_newline };
+}
+
+const char_utils = @import("character_utils.zig");
+
+// Random bytes biased towards the classes the scanners look for, so runs of
+// every length show up on both sides of the 16-byte blocks
+fn fillScanInput(rng: std.Random, bytes: []u8) void {
+    const alphabet = " \t\n\r\x0b\x0c\x85\xa0aZ_09\"\\'/\x00\xff";
+    for (bytes) |*b| {
+        b.* = if (rng.uintLessThan(u8, 4) == 0) rng.int(u8) else alphabet[rng.uintLessThan(usize, alphabet.len)];
+    }
+}
+
+test "scanners match byte-at-a-time loops" {
+    var prng = std.Random.DefaultPrng.init(0x9e3779b97f4a7c15);
+    const rng = prng.random();
+    var buf: [96]u8 = undefined;
+
+    for (0..2000) |_| {
+        fillScanInput(rng, &buf);
+        const start = rng.uintLessThan(usize, 17);
+        const bytes = buf[start..][0..rng.uintLessThan(usize, buf.len - start + 1)];
+
+        var whitespace: usize = 0;
+        while (whitespace < bytes.len and char_utils.isWhitespace(bytes[whitespace])) whitespace += 1;
+        try std.testing.expectEqual(whitespace, skipWhitespace(bytes));
+
+        var ident: usize = 0;
+        while (ident < bytes.len and char_utils.isIdentChar(bytes[ident])) ident += 1;
+        try std.testing.expectEqual(ident, skipIdentifier(bytes));
+
+        const quote = std.mem.indexOfAny(u8, bytes, "\"\\") orelse bytes.len;
+        try std.testing.expectEqual(quote, findQuoteOrBackslash(bytes, '"'));
+
+        try std.testing.expectEqual(std.mem.count(u8, bytes, "\n"), countNewlines(bytes));
+
+        var line: usize = 3;
+        var column: usize = 7;
+        for (bytes) |b| {
+            if (b == '\n') {
+                line += 1;
+                column = 1;
+            } else {
+                column += 1;
+            }
+        }
+        const pos = advancePosition(bytes, 3, 7);
+        try std.testing.expectEqual(line, pos.line);
+        try std.testing.expectEqual(column, pos.column);
+    }
+}
@@ -65,3 +65,9 @@ pub fn formatToken(tok: Token, allocator: std.mem.Allocator) ![]u8 {
 
 // Re-export for tests or other modules that need it
 pub const std_lib = std;
+
+test {
+    _ = lexer_core;
+    _ = token_reader;
+    _ = @import("byte_scan.zig");
+}
@@ -2,6 +2,7 @@ const std = @import("std");
 const token = @import("token.zig");
 const token_reader = @import("token_reader.zig");
 const char_utils = @import("character_utils.zig");
+const byte_scan = @import("byte_scan.zig");
 const keywords = @import("keywords.zig");
 const errors_module = @import("errors.zig");
 
@@ -96,6 +97,29 @@ pub const Lexer = struct {
         }
     }
 
+    /// Advance to target, leaving the same state as calling readChar until
+    /// position reaches it
+    fn advanceTo(self: *Lexer, target: usize) void {
+        if (target <= self.position) return;
+
+        const end = @min(target + 1, self.input.len);
+        if (self.read_position < end) {
+            const pos = byte_scan.advancePosition(self.input[self.read_position..end], self.line, self.column);
+            self.line = pos.line;
+            self.column = pos.column;
+        }
+
+        if (target >= self.input.len) {
+            self.ch = 0; // End of file
+            self.column += 1;
+        } else {
+            self.ch = self.input[target];
+        }
+
+        self.position = target;
+        self.read_position = target + 1;
+    }
+
     /// Peek at the next character without consuming it
     fn peekChar(self: *Lexer) u8 {
         if (self.read_position >= self.input.len) {
@@ -107,9 +131,10 @@ pub const Lexer = struct {
 
     /// Skip whitespace characters
     fn skipWhitespace(self: *Lexer) !void {
-        while (char_utils.isWhitespace(self.ch)) {
-            try self.readChar();
-        }
+        if (!char_utils.isWhitespace(self.ch)) return;
+
+        const run = byte_scan.skipWhitespace(self.input[self.position..]);
+        self.advanceTo(self.position + run);
     }
 
     /// Report an error from the lexer
@@ -134,9 +159,7 @@ pub const Lexer = struct {
         const reader_result = token_reader.readIdentifier(self.input, start_pos, self.line, start_column);
 
         // Advance the lexer position to match the end position returned by the reader
-        while (self.position < reader_result.end_pos) {
-            try self.readChar();
-        }
+        self.advanceTo(reader_result.end_pos);
 
         // IMPORTANT MEMORY NOTE:
         // Identifier tokens contain string slices that point to the original source.
@@ -157,9 +180,7 @@ pub const Lexer = struct {
         }
 
         // Advance the lexer position to match the end position returned by the reader
-        while (self.position < reader_result.end_pos) {
-            try self.readChar();
-        }
+        self.advanceTo(reader_result.end_pos);
 
         return reader_result.token;
     }
@@ -179,9 +200,7 @@ pub const Lexer = struct {
         }
 
         // Update lexer state to match the end state returned by the reader
-        while (self.position < reader_result.end_pos) {
-            try self.readChar();
-        }
+        self.advanceTo(reader_result.end_pos);
 
         self.line = reader_result.new_line;
         self.column = reader_result.new_column;
@@ -243,9 +262,10 @@ pub const Lexer = struct {
         try self.readChar(); // Skip the opening '/'
         try self.readChar(); // Skip the opening '/'
 
-        while (self.ch != 0 and self.ch != '\n') {
-            try self.readChar();
-        }
+        if (self.position >= self.input.len) return;
+
+        const rest = self.input[self.position..];
+        self.advanceTo(self.position + (std.mem.indexOfAny(u8, rest, "\n\x00") orelse rest.len));
     }
 
     /// Get the next token from the input
@@ -527,3 +547,144 @@ pub const Lexer = struct {
         return try self.error_reporter.getFormattedErrors();
     }
 };
+
+// Sources mixing whitespace runs (some longer than one 16-byte scan block),
+// identifiers, line comments and strings spanning lines. Other tokens are
+// single characters so the reference below can step over them
+const position_test_sources = [_][]const u8{
+    "",
+    "x",
+    "   \t  x  \n\n  y",
+    "alpha beta_gamma\n\tdelta_epsilon_zeta_eta_theta_iota   \n",
+    "                                        \n                    z",
+    "name\r\n\r\n  \x0b\x0c\xa0 other",
+    "a // comment to end of line\nb // another\n\n// only a comment",
+    "x // comment with NUL \x00 y\nz",
+    "a //",
+    "s = \"one\ntwo\n\nthree\" ; t",
+    "\"esc\\tape\\\ncontinued\" u",
+    "\"a\n\" x\n\"\n\"",
+    "\"unterminated\nstring",
+    "f(a, b) { g; }\n",
+};
+
+fn expectSameState(expected: Lexer, actual: Lexer) !void {
+    try std.testing.expectEqual(expected.position, actual.position);
+    try std.testing.expectEqual(expected.read_position, actual.read_position);
+    try std.testing.expectEqual(expected.ch, actual.ch);
+    try std.testing.expectEqual(expected.line, actual.line);
+    try std.testing.expectEqual(expected.column, actual.column);
+}
+
+test "advanceTo leaves the state repeated readChar calls leave" {
+    for (position_test_sources) |source| {
+        for (0..source.len + 1) |start| {
+            var base = try Lexer.init(std.testing.allocator, source);
+            defer base.deinit();
+            while (base.position < start) try base.readChar();
+
+            // Copies share base's buffers, which readChar and advanceTo don't touch
+            for (start..source.len + 1) |target| {
+                var expected = base;
+                var actual = base;
+                while (expected.position < target) try expected.readChar();
+                actual.advanceTo(target);
+                try expectSameState(expected, actual);
+            }
+        }
+    }
+}
+
+const Position = struct {
+    line: usize,
+    column: usize,
+};
+
+// Token positions as the lexer produced them before advanceTo and the
+// scanning readers: every skip is a readChar loop and strings are read one
+// byte at a time
+fn referencePositions(allocator: std.mem.Allocator, source: []const u8) ![]Position {
+    var positions = std.ArrayList(Position).init(allocator);
+    errdefer positions.deinit();
+    var lexer = try Lexer.init(allocator, source);
+    defer lexer.deinit();
+
+    while (true) {
+        while (char_utils.isWhitespace(lexer.ch)) try lexer.readChar();
+
+        if (lexer.ch == 0) {
+            try positions.append(.{ .line = lexer.line, .column = lexer.column });
+            return positions.toOwnedSlice();
+        }
+
+        if (lexer.ch == '/' and lexer.peekChar() == '/') {
+            try lexer.readChar();
+            try lexer.readChar();
+            while (lexer.ch != 0 and lexer.ch != '\n') try lexer.readChar();
+            continue;
+        }
+
+        try positions.append(.{ .line = lexer.line, .column = lexer.column });
+
+        if (char_utils.isLetter(lexer.ch)) {
+            var end = lexer.position;
+            while (end < source.len and char_utils.isIdentChar(source[end])) end += 1;
+            while (lexer.position < end) try lexer.readChar();
+        } else if (lexer.ch == '"') {
+            var line = lexer.line;
+            var column = lexer.column + 1;
+            var pos = lexer.position + 1;
+            while (pos < source.len) : (pos += 1) {
+                const ch = source[pos];
+                if (ch == '"') {
+                    column += 1;
+                    pos += 1;
+                    break;
+                } else if (ch == '\\' and pos + 1 < source.len) {
+                    pos += 1;
+                    column += 1;
+                    if (source[pos] == '\n') {
+                        line += 1;
+                        column = 1;
+                    }
+                } else if (ch == '\n') {
+                    line += 1;
+                    column = 1;
+                } else {
+                    column += 1;
+                }
+            }
+            while (lexer.position < pos) try lexer.readChar();
+            lexer.line = line;
+            lexer.column = column;
+        } else {
+            try lexer.readChar();
+        }
+    }
+}
+
+test "token lines and columns match the readChar loop" {
+    // Error tokens are leaked by design, so everything goes in an arena
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    for (position_test_sources) |source| {
+        const expected = try referencePositions(allocator, source);
+
+        var lexer = try Lexer.init(allocator, source);
+        defer lexer.deinit();
+
+        var count: usize = 0;
+        while (true) : (count += 1) {
+            const tok = try lexer.nextToken();
+            try std.testing.expect(count < expected.len);
+            if (expected[count].line != tok.line or expected[count].column != tok.column) {
+                std.debug.print("token {d} of \"{s}\" at {d}:{d}, expected {d}:{d}\n", .{ count, source, tok.line, tok.column, expected[count].line, expected[count].column });
+                return error.TestExpectedEqual;
+            }
+            if (tok.type == .EOF) break;
+        }
+        try std.testing.expectEqual(expected.len, count + 1);
+    }
+}
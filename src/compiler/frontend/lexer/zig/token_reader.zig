@@ -1,6 +1,7 @@
 const std = @import("std");
 const token = @import("token.zig");
 const char_utils = @import("character_utils.zig");
+const byte_scan = @import("byte_scan.zig");
 const keywords = @import("keywords.zig");
 
 const TokenType = token.TokenType;
@@ -15,12 +16,8 @@ pub const IdentifierResult = struct {
 
 /// Read an identifier from the input stream
 pub fn readIdentifier(source: []const u8, start_pos: usize, start_line: usize, start_column: usize) IdentifierResult {
-    var current_pos = start_pos;
-
     // Read until we hit a non-identifier character
-    while (current_pos < source.len and char_utils.isIdentChar(source[current_pos])) {
-        current_pos += 1;
-    }
+    const current_pos = start_pos + byte_scan.skipIdentifier(source[start_pos..]);
 
     const identifier = source[start_pos..current_pos];
     const token_type = keywords.lookupIdentifier(identifier);
@@ -284,6 +281,18 @@ pub fn readString(source: []const u8, start_pos: usize, start_line: usize, start
     var found_closing_quote = false;
 
     while (current_pos < source.len) {
+        // Copy plain text up to the next quote or escape in one step
+        const run = byte_scan.findQuoteOrBackslash(source[current_pos..], '"');
+        if (run > 0) {
+            const text = source[current_pos..][0..run];
+            try buffer.appendSlice(text);
+            const pos = byte_scan.advancePosition(text, current_line, current_column);
+            current_line = pos.line;
+            current_column = pos.column;
+            current_pos += run;
+            continue;
+        }
+
         const ch = source[current_pos];
 
         if (ch == '"') {
@@ -456,3 +465,18 @@ pub fn readString(source: []const u8, start_pos: usize, start_line: usize, start
         .error_message = error_message,
     };
 }
+
+test "readString copies text around escapes and tracks lines" {
+    const allocator = std.testing.allocator;
+    const source = "x \"first line\nsecond \\\"quoted\\\"\\tand\\\nmore\" y";
+
+    const result = try readString(source, 2, 1, 4, allocator);
+    defer allocator.free(result.token.value.string_val);
+
+    try std.testing.expect(result.error_message == null);
+    try std.testing.expectEqual(TokenType.STRING_LITERAL, result.token.type);
+    try std.testing.expectEqualStrings("first line\nsecond \"quoted\"\tandmore", result.token.value.string_val);
+    try std.testing.expectEqual(source.len - 2, result.end_pos);
+    try std.testing.expectEqual(@as(usize, 3), result.new_line);
+    try std.testing.expectEqual(@as(usize, 6), result.new_column);
+}
@@ -2,46 +2,92 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include "../ast/ast.h"
-#include "optimizer.h"
+#include "ast.h"
+#include "escape_analysis.h"
 
-// Object allocation state
-typedef enum {
-    ALLOC_UNKNOWN,       // Initial state, unknown if escapes
-    ALLOC_NO_ESCAPE,     // Object does not escape its allocating function
-    ALLOC_ARG_ESCAPE,    // Object escapes as an argument to another function
-    ALLOC_RETURN_ESCAPE, // Object escapes by being returned
-    ALLOC_GLOBAL_ESCAPE, // Object escapes to global scope (or stored in global)
-    ALLOC_GOROUTINE_ESCAPE // Object escapes to a goroutine
-} AllocEscapeState;
+// Identifier node as built by the parser (see ast_helpers.c)
+typedef struct {
+    GooNode base;
+    char* name;
+} EscapeIdentNode;
 
 // Structure to track variable escape status
 typedef struct VarEscapeInfo {
     char* name;                // Variable name
     AllocEscapeState state;    // Current escape state
-    ASTNode* alloc_node;       // Node where allocation happens
+    GooNode* alloc_node;       // Node where allocation happens
     struct VarEscapeInfo* next; // Next in linked list
 } VarEscapeInfo;
 
 // Analysis context for a function
 typedef struct {
     VarEscapeInfo* vars;       // List of tracked variables
-    ASTNode* current_function; // Function being analyzed
-    bool has_defer;            // Whether function has defer statements
+    GooFunctionNode* current_function; // Function being analyzed
+    int concurrent_depth;      // Enclosing go, go parallel and supervise bodies
     bool has_goroutines;       // Whether function spawns goroutines
-    bool has_closures;         // Whether function creates closures
+    bool has_opaque_nodes;     // Whether the body has nodes the analysis can't see into
 } EscapeAnalysisContext;
 
+// Final escape state of one allocation, kept for code generation
+typedef struct EscapeResult {
+    char* function_name;       // Allocating function
+    char* var_name;            // Variable the allocation is bound to
+    AllocEscapeState state;    // Escape state when analysis finished
+    struct EscapeResult* next; // Next in linked list
+} EscapeResult;
+
+static EscapeResult* escape_results = NULL;
+
+// Record the final state of a tracked variable
+static void record_result(const char* function_name, VarEscapeInfo* var) {
+    EscapeResult* result = malloc(sizeof(EscapeResult));
+    if (!result) return;
+    
+    result->function_name = strdup(function_name);
+    result->var_name = strdup(var->name);
+    result->state = var->state;
+    result->next = escape_results;
+    escape_results = result;
+}
+
+bool escape_analysis_lookup(const char* function_name, const char* var_name, AllocEscapeState* state) {
+    if (!function_name || !var_name) return false;
+    
+    EscapeResult* result = escape_results;
+    while (result) {
+        if (strcmp(result->var_name, var_name) == 0 &&
+            strcmp(result->function_name, function_name) == 0) {
+            if (state) *state = result->state;
+            return true;
+        }
+        result = result->next;
+    }
+    
+    return false;
+}
+
+void escape_analysis_clear_results(void) {
+    EscapeResult* result = escape_results;
+    while (result) {
+        EscapeResult* next = result->next;
+        free(result->function_name);
+        free(result->var_name);
+        free(result);
+        result = next;
+    }
+    escape_results = NULL;
+}
+
 // Create a new escape analysis context
-static EscapeAnalysisContext* create_context(ASTNode* func) {
+static EscapeAnalysisContext* create_context(GooFunctionNode* func) {
     EscapeAnalysisContext* ctx = malloc(sizeof(EscapeAnalysisContext));
     if (!ctx) return NULL;
     
     ctx->vars = NULL;
     ctx->current_function = func;
-    ctx->has_defer = false;
+    ctx->concurrent_depth = 0;
     ctx->has_goroutines = false;
-    ctx->has_closures = false;
+    ctx->has_opaque_nodes = false;
     
     return ctx;
 }
@@ -63,7 +109,7 @@ static void free_context(EscapeAnalysisContext* ctx) {
 }
 
 // Track a variable in the context
-static VarEscapeInfo* track_variable(EscapeAnalysisContext* ctx, const char* name, ASTNode* alloc_node) {
+static VarEscapeInfo* track_variable(EscapeAnalysisContext* ctx, const char* name, GooNode* alloc_node) {
     if (!ctx || !name) return NULL;
     
     // Check if variable is already tracked
@@ -80,7 +126,7 @@ static VarEscapeInfo* track_variable(EscapeAnalysisContext* ctx, const char* nam
     if (!var) return NULL;
     
     var->name = strdup(name);
-    var->state = ALLOC_UNKNOWN;
+    var->state = ALLOC_NO_ESCAPE;
     var->alloc_node = alloc_node;
     var->next = ctx->vars;
     ctx->vars = var;
@@ -114,406 +160,258 @@ static void update_escape_state(VarEscapeInfo* var, AllocEscapeState new_state)
 }
 
 // Forward declarations for recursive functions
-static void analyze_expression(EscapeAnalysisContext* ctx, ASTNode* expr);
-static void analyze_statement(EscapeAnalysisContext* ctx, ASTNode* stmt);
-static void analyze_block(EscapeAnalysisContext* ctx, ASTNode* block);
+static void analyze_expression(EscapeAnalysisContext* ctx, GooNode* expr);
+static void analyze_statement(EscapeAnalysisContext* ctx, GooNode* stmt);
+static void analyze_block(EscapeAnalysisContext* ctx, GooNode* block);
 
-// Analyze a variable reference
-static void analyze_var_ref(EscapeAnalysisContext* ctx, ASTNode* var_ref) {
-    if (!ctx || !var_ref || var_ref->type != AST_VAR_REF) {
+// Analyze an expression whose value flows to a place that keeps it in the
+// given state. Only a bare tracked variable takes that state; anything
+// else is analyzed on its own.
+static void analyze_use(EscapeAnalysisContext* ctx, GooNode* expr, AllocEscapeState use) {
+    if (!ctx || !expr) return;
+    
+    if (expr->type != GOO_NODE_IDENTIFIER) {
+        analyze_expression(ctx, expr);
         return;
     }
     
-    const char* var_name = var_ref->var_ref.name;
-    VarEscapeInfo* var = get_variable(ctx, var_name);
-    
-    // Variable isn't tracked (may not be heap allocated)
+    VarEscapeInfo* var = get_variable(ctx, ((EscapeIdentNode*)expr)->name);
     if (!var) return;
     
-    // The use of the variable will be analyzed in the parent context
-}
-
-// Analyze a binary expression
-static void analyze_binary_expr(EscapeAnalysisContext* ctx, ASTNode* binary) {
-    if (!ctx || !binary || binary->type != AST_BINARY_EXPR) {
-        return;
-    }
-    
-    // Analyze both sides of the expression
-    analyze_expression(ctx, binary->binary_expr.left);
-    analyze_expression(ctx, binary->binary_expr.right);
-}
-
-// Analyze a unary expression
-static void analyze_unary_expr(EscapeAnalysisContext* ctx, ASTNode* unary) {
-    if (!ctx || !unary || unary->type != AST_UNARY_EXPR) {
-        return;
+    // Code spawned from here may run after the function returns
+    if (ctx->concurrent_depth > 0) {
+        use = ALLOC_GOROUTINE_ESCAPE;
     }
     
-    analyze_expression(ctx, unary->unary_expr.expr);
+    update_escape_state(var, use);
 }
 
 // Analyze a function call
-static void analyze_call_expr(EscapeAnalysisContext* ctx, ASTNode* call) {
-    if (!ctx || !call || call->type != AST_CALL_EXPR) {
-        return;
-    }
-    
-    // Analyze the function expression
-    analyze_expression(ctx, call->call_expr.func);
+static void analyze_call_expr(EscapeAnalysisContext* ctx, GooCallExprNode* call) {
+    // A pointer used as the callee is copied out of our sight
+    analyze_use(ctx, call->func, ALLOC_GLOBAL_ESCAPE);
     
-    // Analyze arguments - they may escape through the call
-    ASTNode* arg = call->call_expr.args;
-    while (arg) {
-        analyze_expression(ctx, arg);
-        
-        // If the argument is a variable reference, mark it as escaping to an argument
-        if (arg->type == AST_VAR_REF) {
-            VarEscapeInfo* var = get_variable(ctx, arg->var_ref.name);
-            if (var) {
-                update_escape_state(var, ALLOC_ARG_ESCAPE);
-            }
-        }
-        
-        arg = arg->next;
+    // Arguments are not followed into the callee
+    for (GooNode* arg = call->args; arg; arg = arg->next) {
+        analyze_use(ctx, arg, ALLOC_ARG_ESCAPE);
     }
 }
 
-// Analyze a goroutine spawn
-static void analyze_go_expr(EscapeAnalysisContext* ctx, ASTNode* go_expr) {
-    if (!ctx || !go_expr || go_expr->type != AST_GO_EXPR) {
-        return;
+// Analyze an allocation expression that isn't bound to a variable
+static void analyze_alloc_expr(EscapeAnalysisContext* ctx, GooAllocExprNode* alloc) {
+    if (alloc->size) {
+        analyze_use(ctx, alloc->size, ALLOC_GLOBAL_ESCAPE);
     }
-    
-    ctx->has_goroutines = true;
-    
-    // Any variable used in a goroutine must be considered as escaping
-    analyze_expression(ctx, go_expr->go_expr.call);
-    
-    // If the goroutine call has arguments, mark them as goroutine escapes
-    if (go_expr->go_expr.call->type == AST_CALL_EXPR) {
-        ASTNode* args = go_expr->go_expr.call->call_expr.args;
-        while (args) {
-            if (args->type == AST_VAR_REF) {
-                VarEscapeInfo* var = get_variable(ctx, args->var_ref.name);
-                if (var) {
-                    update_escape_state(var, ALLOC_GOROUTINE_ESCAPE);
-                }
-            }
-            args = args->next;
-        }
+    if (alloc->allocator) {
+        analyze_use(ctx, alloc->allocator, ALLOC_GLOBAL_ESCAPE);
     }
 }
 
-// Analyze an allocation expression
-static void analyze_alloc_expr(EscapeAnalysisContext* ctx, ASTNode* alloc, const char* var_name) {
-    if (!ctx || !alloc) {
+// Analyze an expression. A tracked variable reached here is used in a way
+// the analysis doesn't follow (an alias, arithmetic, a store through an
+// operator), so it is treated as escaping to global scope.
+static void analyze_expression(EscapeAnalysisContext* ctx, GooNode* expr) {
+    if (!ctx || !expr) {
         return;
     }
     
-    if (var_name) {
-        // Register this as a tracked allocation
-        track_variable(ctx, var_name, alloc);
-    }
-    
-    // Analyze any subexpressions within the allocation
-    if (alloc->type == AST_NEW_EXPR) {
-        // Nothing to analyze for the type
-    } else if (alloc->type == AST_MAKE_EXPR) {
-        // Analyze size expressions
-        if (alloc->make_expr.size) {
-            analyze_expression(ctx, alloc->make_expr.size);
+    switch (expr->type) {
+        case GOO_NODE_IDENTIFIER:
+            analyze_use(ctx, expr, ALLOC_GLOBAL_ESCAPE);
+            break;
+            
+        case GOO_NODE_BINARY_EXPR: {
+            GooBinaryExprNode* binary = (GooBinaryExprNode*)expr;
+            analyze_use(ctx, binary->left, ALLOC_GLOBAL_ESCAPE);
+            analyze_use(ctx, binary->right, ALLOC_GLOBAL_ESCAPE);
+            break;
         }
-        if (alloc->make_expr.capacity) {
-            analyze_expression(ctx, alloc->make_expr.capacity);
+        
+        case GOO_NODE_UNARY_EXPR: {
+            GooUnaryExprNode* unary = (GooUnaryExprNode*)expr;
+            // A truth test reads the pointer without copying it
+            analyze_use(ctx, unary->expr, unary->operator == '!' ? ALLOC_NO_ESCAPE : ALLOC_GLOBAL_ESCAPE);
+            break;
         }
-    }
-}
-
-// Analyze an assignment statement
-static void analyze_assignment(EscapeAnalysisContext* ctx, ASTNode* assign) {
-    if (!ctx || !assign || assign->type != AST_ASSIGN_STMT) {
-        return;
-    }
-    
-    // Analyze right side first
-    analyze_expression(ctx, assign->assign_stmt.right);
-    
-    // Check for allocation on the right side
-    bool is_alloc = false;
-    if (assign->assign_stmt.right->type == AST_NEW_EXPR ||
-        assign->assign_stmt.right->type == AST_MAKE_EXPR) {
-        is_alloc = true;
-    }
-    
-    // Handle the left side
-    if (assign->assign_stmt.left->type == AST_VAR_REF) {
-        const char* var_name = assign->assign_stmt.left->var_ref.name;
         
-        if (is_alloc) {
-            // This is an allocation being assigned to a variable
-            analyze_alloc_expr(ctx, assign->assign_stmt.right, var_name);
-        } else {
-            // This could be assigning one tracked variable to another
-            VarEscapeInfo* var = get_variable(ctx, var_name);
+        case GOO_NODE_CALL_EXPR:
+            analyze_call_expr(ctx, (GooCallExprNode*)expr);
+            break;
             
-            // If we're assigning from another variable
-            if (assign->assign_stmt.right->type == AST_VAR_REF) {
-                const char* right_name = assign->assign_stmt.right->var_ref.name;
-                VarEscapeInfo* right_var = get_variable(ctx, right_name);
-                
-                if (right_var && var) {
-                    // Propagate escape state
-                    update_escape_state(var, right_var->state);
-                }
+        case GOO_NODE_ALLOC_EXPR:
+            analyze_alloc_expr(ctx, (GooAllocExprNode*)expr);
+            break;
+            
+        case GOO_NODE_FREE_EXPR: {
+            GooFreeExprNode* free_expr = (GooFreeExprNode*)expr;
+            // Freeing a variable doesn't keep it; code generation drops the
+            // free when the allocation isn't on the heap
+            analyze_use(ctx, free_expr->expr, ALLOC_NO_ESCAPE);
+            if (free_expr->allocator) {
+                analyze_use(ctx, free_expr->allocator, ALLOC_GLOBAL_ESCAPE);
             }
+            break;
         }
-    }
-    
-    // Handle struct field assignments that could cause escape
-    if (assign->assign_stmt.left->type == AST_FIELD_ACCESS) {
-        ASTNode* object = assign->assign_stmt.left->field_access.object;
         
-        if (object->type == AST_VAR_REF) {
-            // Accessing a field of a variable
-            VarEscapeInfo* var = get_variable(ctx, object->var_ref.name);
-            if (var) {
-                // Check if we're assigning to a global structure
-                if (is_global_variable(object->var_ref.name)) {
-                    update_escape_state(var, ALLOC_GLOBAL_ESCAPE);
-                }
-            }
+        case GOO_NODE_CHANNEL_SEND: {
+            GooChannelSendNode* send = (GooChannelSendNode*)expr;
+            // Whoever receives the value may be another goroutine
+            analyze_use(ctx, send->channel, ALLOC_GOROUTINE_ESCAPE);
+            analyze_use(ctx, send->value, ALLOC_GOROUTINE_ESCAPE);
+            break;
         }
-    }
-}
-
-// Analyze a return statement
-static void analyze_return_stmt(EscapeAnalysisContext* ctx, ASTNode* ret) {
-    if (!ctx || !ret || ret->type != AST_RETURN_STMT) {
-        return;
-    }
-    
-    // Analyze the return expression
-    if (ret->return_stmt.expr) {
-        analyze_expression(ctx, ret->return_stmt.expr);
         
-        // If returning a variable, mark it as return-escaping
-        if (ret->return_stmt.expr->type == AST_VAR_REF) {
-            VarEscapeInfo* var = get_variable(ctx, ret->return_stmt.expr->var_ref.name);
-            if (var) {
-                update_escape_state(var, ALLOC_RETURN_ESCAPE);
-            }
-        }
-    }
-}
-
-// Analyze an if statement
-static void analyze_if_stmt(EscapeAnalysisContext* ctx, ASTNode* if_stmt) {
-    if (!ctx || !if_stmt || if_stmt->type != AST_IF_STMT) {
-        return;
-    }
-    
-    // Analyze condition
-    analyze_expression(ctx, if_stmt->if_stmt.condition);
-    
-    // Analyze true branch
-    analyze_statement(ctx, if_stmt->if_stmt.then_stmt);
-    
-    // Analyze else branch if present
-    if (if_stmt->if_stmt.else_stmt) {
-        analyze_statement(ctx, if_stmt->if_stmt.else_stmt);
-    }
-}
-
-// Analyze a for loop
-static void analyze_for_stmt(EscapeAnalysisContext* ctx, ASTNode* for_stmt) {
-    if (!ctx || !for_stmt || for_stmt->type != AST_FOR_STMT) {
-        return;
-    }
-    
-    // Analyze initializer if present
-    if (for_stmt->for_stmt.init) {
-        analyze_statement(ctx, for_stmt->for_stmt.init);
-    }
-    
-    // Analyze condition if present
-    if (for_stmt->for_stmt.condition) {
-        analyze_expression(ctx, for_stmt->for_stmt.condition);
-    }
-    
-    // Analyze post statement if present
-    if (for_stmt->for_stmt.post) {
-        analyze_statement(ctx, for_stmt->for_stmt.post);
+        case GOO_NODE_CHANNEL_RECV:
+            analyze_use(ctx, ((GooChannelRecvNode*)expr)->channel, ALLOC_GOROUTINE_ESCAPE);
+            break;
+            
+        case GOO_NODE_SUPER_EXPR:
+            analyze_use(ctx, ((GooSuperExprNode*)expr)->expr, ALLOC_GLOBAL_ESCAPE);
+            break;
+            
+        case GOO_NODE_INT_LITERAL:
+        case GOO_NODE_FLOAT_LITERAL:
+        case GOO_NODE_BOOL_LITERAL:
+        case GOO_NODE_STRING_LITERAL:
+        case GOO_NODE_RANGE_LITERAL:
+        case GOO_NODE_TYPE_EXPR:
+            // No variables inside
+            break;
+            
+        default:
+            // A variable could be hidden inside; nothing may stay local
+            ctx->has_opaque_nodes = true;
+            break;
     }
-    
-    // Analyze loop body
-    analyze_statement(ctx, for_stmt->for_stmt.body);
 }
 
-// Analyze a switch statement
-static void analyze_switch_stmt(EscapeAnalysisContext* ctx, ASTNode* switch_stmt) {
-    if (!ctx || !switch_stmt || switch_stmt->type != AST_SWITCH_STMT) {
+// Analyze a variable declaration
+static void analyze_var_decl(EscapeAnalysisContext* ctx, GooVarDeclNode* decl) {
+    GooNode* init = decl->init_expr;
+    
+    // Redeclaring a tracked name would mix two values under one result
+    VarEscapeInfo* shadowed = get_variable(ctx, decl->name);
+    
+    if (init && init->type == GOO_NODE_ALLOC_EXPR &&
+        !decl->allocator && !((GooAllocExprNode*)init)->allocator) {
+        // Code generation places this allocation by the variable's state
+        analyze_alloc_expr(ctx, (GooAllocExprNode*)init);
+        track_variable(ctx, decl->name, init);
         return;
     }
     
-    // Analyze switch expression
-    if (switch_stmt->switch_stmt.expr) {
-        analyze_expression(ctx, switch_stmt->switch_stmt.expr);
-    }
+    update_escape_state(shadowed, ALLOC_GLOBAL_ESCAPE);
     
-    // Analyze cases
-    ASTNode* current_case = switch_stmt->switch_stmt.cases;
-    while (current_case) {
-        if (current_case->type == AST_CASE_CLAUSE) {
-            // Analyze case expression
-            if (current_case->case_clause.expr) {
-                analyze_expression(ctx, current_case->case_clause.expr);
-            }
-            
-            // Analyze case body
-            analyze_block(ctx, current_case->case_clause.body);
-        }
-        current_case = current_case->next;
+    // Aliases aren't followed: q := p makes p escape
+    analyze_use(ctx, init, ALLOC_GLOBAL_ESCAPE);
+    if (decl->allocator) {
+        analyze_use(ctx, decl->allocator, ALLOC_GLOBAL_ESCAPE);
     }
 }
 
-// Analyze a defer statement
-static void analyze_defer_stmt(EscapeAnalysisContext* ctx, ASTNode* defer_stmt) {
-    if (!ctx || !defer_stmt || defer_stmt->type != AST_DEFER_STMT) {
-        return;
-    }
-    
-    ctx->has_defer = true;
-    
-    // Any variable used in a defer must be considered as escaping
-    analyze_expression(ctx, defer_stmt->defer_stmt.call);
-    
-    // If the defer call has arguments, mark them as escaping
-    if (defer_stmt->defer_stmt.call->type == AST_CALL_EXPR) {
-        ASTNode* args = defer_stmt->defer_stmt.call->call_expr.args;
-        while (args) {
-            if (args->type == AST_VAR_REF) {
-                VarEscapeInfo* var = get_variable(ctx, args->var_ref.name);
-                if (var) {
-                    update_escape_state(var, ALLOC_ARG_ESCAPE);
-                }
-            }
-            args = args->next;
-        }
+// Analyze a return statement
+static void analyze_return_stmt(EscapeAnalysisContext* ctx, GooReturnStmtNode* ret) {
+    if (ret->expr) {
+        analyze_use(ctx, ret->expr, ALLOC_RETURN_ESCAPE);
     }
 }
 
-// Analyze an expression
-static void analyze_expression(EscapeAnalysisContext* ctx, ASTNode* expr) {
-    if (!ctx || !expr) {
-        return;
-    }
-    
-    switch (expr->type) {
-        case AST_VAR_REF:
-            analyze_var_ref(ctx, expr);
-            break;
-            
-        case AST_BINARY_EXPR:
-            analyze_binary_expr(ctx, expr);
-            break;
-            
-        case AST_UNARY_EXPR:
-            analyze_unary_expr(ctx, expr);
-            break;
-            
-        case AST_CALL_EXPR:
-            analyze_call_expr(ctx, expr);
-            break;
-            
-        case AST_GO_EXPR:
-            analyze_go_expr(ctx, expr);
-            break;
-            
-        case AST_FIELD_ACCESS:
-            // Analyze the object being accessed
-            analyze_expression(ctx, expr->field_access.object);
-            break;
-            
-        case AST_INDEX_EXPR:
-            // Analyze the array/map and index
-            analyze_expression(ctx, expr->index_expr.array);
-            analyze_expression(ctx, expr->index_expr.index);
-            break;
-            
-        case AST_SLICE_EXPR:
-            // Analyze the array and indices
-            analyze_expression(ctx, expr->slice_expr.array);
-            if (expr->slice_expr.low) {
-                analyze_expression(ctx, expr->slice_expr.low);
-            }
-            if (expr->slice_expr.high) {
-                analyze_expression(ctx, expr->slice_expr.high);
-            }
-            if (expr->slice_expr.max) {
-                analyze_expression(ctx, expr->slice_expr.max);
-            }
-            break;
-            
-        default:
-            // Other expression types don't affect escape analysis
-            break;
-    }
+// Analyze a body that runs concurrently with (or after) the function
+static void analyze_concurrent(EscapeAnalysisContext* ctx, GooNode* node) {
+    ctx->concurrent_depth++;
+    ctx->has_goroutines = true;
+    analyze_statement(ctx, node);
+    ctx->concurrent_depth--;
 }
 
 // Analyze a statement
-static void analyze_statement(EscapeAnalysisContext* ctx, ASTNode* stmt) {
+static void analyze_statement(EscapeAnalysisContext* ctx, GooNode* stmt) {
     if (!ctx || !stmt) {
         return;
     }
     
     switch (stmt->type) {
-        case AST_BLOCK:
+        case GOO_NODE_BLOCK_STMT:
             analyze_block(ctx, stmt);
             break;
             
-        case AST_ASSIGN_STMT:
-            analyze_assignment(ctx, stmt);
+        case GOO_NODE_VAR_DECL:
+            analyze_var_decl(ctx, (GooVarDeclNode*)stmt);
             break;
             
-        case AST_RETURN_STMT:
-            analyze_return_stmt(ctx, stmt);
+        case GOO_NODE_RETURN_STMT:
+            analyze_return_stmt(ctx, (GooReturnStmtNode*)stmt);
             break;
             
-        case AST_IF_STMT:
-            analyze_if_stmt(ctx, stmt);
+        case GOO_NODE_IF_STMT: {
+            GooIfStmtNode* if_stmt = (GooIfStmtNode*)stmt;
+            analyze_expression(ctx, if_stmt->condition);
+            analyze_statement(ctx, if_stmt->then_block);
+            analyze_statement(ctx, if_stmt->else_block);
             break;
-            
-        case AST_FOR_STMT:
-            analyze_for_stmt(ctx, stmt);
+        }
+        
+        case GOO_NODE_FOR_STMT: {
+            GooForStmtNode* for_stmt = (GooForStmtNode*)stmt;
+            analyze_statement(ctx, for_stmt->init_expr);
+            analyze_expression(ctx, for_stmt->condition);
+            analyze_statement(ctx, for_stmt->update_expr);
+            analyze_statement(ctx, for_stmt->body);
             break;
-            
-        case AST_SWITCH_STMT:
-            analyze_switch_stmt(ctx, stmt);
+        }
+        
+        case GOO_NODE_GO_STMT:
+            analyze_concurrent(ctx, ((GooGoStmtNode*)stmt)->expr);
             break;
             
-        case AST_DEFER_STMT:
-            analyze_defer_stmt(ctx, stmt);
+        case GOO_NODE_GO_PARALLEL: {
+            GooGoParallelNode* parallel = (GooGoParallelNode*)stmt;
+            // Shared and private options name variables in nodes the
+            // analysis doesn't read
+            if (parallel->options) {
+                ctx->has_opaque_nodes = true;
+            }
+            analyze_concurrent(ctx, parallel->body);
+            break;
+        }
+        
+        case GOO_NODE_SUPERVISE_STMT:
+            analyze_concurrent(ctx, ((GooSuperviseStmtNode*)stmt)->expr);
             break;
             
-        case AST_EXPR_STMT:
-            analyze_expression(ctx, stmt->expr_stmt.expr);
+        case GOO_NODE_TRY_STMT: {
+            GooTryStmtNode* try_stmt = (GooTryStmtNode*)stmt;
+            analyze_statement(ctx, try_stmt->expr);
+            analyze_statement(ctx, try_stmt->recover_block);
+            break;
+        }
+        
+        case GOO_NODE_SCOPE_BLOCK: {
+            GooScopeBlockNode* scope = (GooScopeBlockNode*)stmt;
+            analyze_use(ctx, scope->allocator, ALLOC_GLOBAL_ESCAPE);
+            analyze_statement(ctx, scope->body);
+            break;
+        }
+        
+        case GOO_NODE_CHANNEL_DECL:
+            // Declares a channel; no expressions
             break;
             
         default:
-            // Other statement types don't affect escape analysis
+            // Expression statements
+            analyze_expression(ctx, stmt);
             break;
     }
 }
 
 // Analyze a block of statements
-static void analyze_block(EscapeAnalysisContext* ctx, ASTNode* block) {
-    if (!ctx || !block || block->type != AST_BLOCK) {
+static void analyze_block(EscapeAnalysisContext* ctx, GooNode* block) {
+    if (!ctx || !block || block->type != GOO_NODE_BLOCK_STMT) {
         return;
     }
     
     // Analyze each statement in the block
-    ASTNode* stmt = block->block.stmts;
+    GooNode* stmt = ((GooBlockStmtNode*)block)->statements;
     while (stmt) {
         analyze_statement(ctx, stmt);
         stmt = stmt->next;
@@ -521,8 +419,8 @@ static void analyze_block(EscapeAnalysisContext* ctx, ASTNode* block) {
 }
 
 // Analyze a function and determine allocation escapes
-static void analyze_function(ASTNode* func) {
-    if (!func || (func->type != AST_FUNC_DECL && func->type != AST_FUNC_LIT)) {
+static void analyze_function(GooFunctionNode* func) {
+    if (!func || !func->name || !func->body) {
         return;
     }
     
@@ -530,38 +428,17 @@ static void analyze_function(ASTNode* func) {
     EscapeAnalysisContext* ctx = create_context(func);
     if (!ctx) return;
     
-    // Get function body
-    ASTNode* body = NULL;
-    if (func->type == AST_FUNC_DECL) {
-        body = func->func_decl.body;
-    } else if (func->type == AST_FUNC_LIT) {
-        body = func->func_lit.body;
-        // Function literals can close over variables
-        ctx->has_closures = true;
-    }
-    
-    // Analyze function body if present
-    if (body) {
-        analyze_block(ctx, body);
-    }
+    analyze_statement(ctx, func->body);
     
-    // Process results and apply optimizations
     VarEscapeInfo* var = ctx->vars;
     while (var) {
-        // If the allocation doesn't escape, mark it for stack allocation
-        if (var->state == ALLOC_UNKNOWN || var->state == ALLOC_NO_ESCAPE) {
-            if (var->alloc_node) {
-                // Add a stack allocation hint to the AST node
-                if (var->alloc_node->type == AST_NEW_EXPR) {
-                    var->alloc_node->new_expr.stack_allocate = true;
-                } else if (var->alloc_node->type == AST_MAKE_EXPR) {
-                    var->alloc_node->make_expr.stack_allocate = true;
-                }
-                
-                // Add optimization note
-                printf("Escape Analysis: Variable '%s' can be stack-allocated\n", var->name);
-            }
+        // Anything the analysis couldn't see may have taken the pointer
+        if (ctx->has_opaque_nodes) {
+            update_escape_state(var, ALLOC_GLOBAL_ESCAPE);
         }
+        
+        // Keep the final state for placement during code generation
+        record_result(func->name, var);
         var = var->next;
     }
     
@@ -569,23 +446,24 @@ static void analyze_function(ASTNode* func) {
     free_context(ctx);
 }
 
-// Check if a name refers to a global variable
-bool is_global_variable(const char* name) {
-    // This is a simplification - in a real compiler we'd check symbol tables
-    // For now, assume identifiers starting with uppercase are globals
-    return name && name[0] >= 'A' && name[0] <= 'Z';
+// Analyze the functions in a declaration list, including module bodies
+static void analyze_declarations(GooNode* node) {
+    while (node) {
+        if (node->type == GOO_NODE_FUNCTION_DECL) {
+            analyze_function((GooFunctionNode*)node);
+        } else if (node->type == GOO_NODE_MODULE_DECL) {
+            analyze_declarations(((GooModuleDeclNode*)node)->declarations);
+        }
+        node = node->next;
+    }
 }
 
 // Entry point for escape analysis optimization
-void optimize_escape_analysis(ASTNode* root) {
-    if (!root) return;
+void optimize_escape_analysis(GooAst* ast) {
+    if (!ast) return;
+    
+    escape_analysis_clear_results();
     
     // Process all functions in the module
-    ASTNode* node = root;
-    while (node) {
-        if (node->type == AST_FUNC_DECL) {
-            analyze_function(node);
-        }
-        node = node->next;
-    }
-} 
\ No newline at end of file
+    analyze_declarations(ast->declarations ? ast->declarations : ast->root);
+}
@@ -0,0 +1,36 @@
+#ifndef GOO_ESCAPE_ANALYSIS_H
+#define GOO_ESCAPE_ANALYSIS_H
+
+#include <stdbool.h>
+#include "ast.h"
+
+/**
+ * Escape analysis results shared with code generation.
+ *
+ * optimize_escape_analysis() records the final escape state of every
+ * allocation bound to a variable, keyed by function and variable name, so
+ * the code generator can place each allocation on the stack, in the
+ * per-call arena, or on the heap. Any use the analysis doesn't follow (an
+ * alias, an operator, a node it can't see into) counts as an escape.
+ */
+
+// Object allocation state, ordered from least to most escaped
+typedef enum {
+    ALLOC_UNKNOWN,       // Initial state, unknown if escapes
+    ALLOC_NO_ESCAPE,     // Object does not escape its allocating function
+    ALLOC_ARG_ESCAPE,    // Object escapes as an argument to another function
+    ALLOC_RETURN_ESCAPE, // Object escapes by being returned
+    ALLOC_GLOBAL_ESCAPE, // Object escapes to global scope (or stored in global)
+    ALLOC_GOROUTINE_ESCAPE // Object escapes to a goroutine
+} AllocEscapeState;
+
+// Analyze every function in the AST, replacing earlier results
+void optimize_escape_analysis(GooAst* ast);
+
+// Look up the escape state recorded for a variable; false if it was not analyzed
+bool escape_analysis_lookup(const char* function_name, const char* var_name, AllocEscapeState* state);
+
+// Drop all recorded results
+void escape_analysis_clear_results(void);
+
+#endif // GOO_ESCAPE_ANALYSIS_H
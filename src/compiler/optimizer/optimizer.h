@@ -16,11 +16,7 @@ struct ASTNode;
 
 // ===== Escape Analysis =====
 
-// Check if a name refers to a global variable
-bool is_global_variable(const char* name);
-
-// Perform escape analysis to identify heap allocations that can be moved to the stack
-void optimize_escape_analysis(ASTNode* root);
+// Escape analysis runs on the compiler AST; see escape_analysis.h
 
 // ===== Channel Optimization =====
 
@@ -0,0 +1,69 @@
+/**
+ * goo_byte_scan.h
+ *
+ * Byte-class scanning for the Goo lexer and runtime strings.
+ * Each scan checks 16 bytes per step with SSE2 or NEON where available and
+ * falls back to a byte loop elsewhere. Inputs need no alignment and no
+ * padding: nothing past bytes + length is read.
+ */
+
+#ifndef GOO_BYTE_SCAN_H
+#define GOO_BYTE_SCAN_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Byte classes for goo_byte_scan_skip
+typedef enum {
+    GOO_BYTE_CLASS_WHITESPACE = 0,  // ' ', \t, \n, \r, \v, \f, 0x85, 0xA0
+    GOO_BYTE_CLASS_IDENT = 1        // ASCII letters, digits and '_'
+} GooByteClass;
+
+/**
+ * Find the first byte that is not in a class.
+ *
+ * @param bytes The bytes to scan
+ * @param length The number of bytes
+ * @param byte_class The class to skip
+ * @return The index of the first byte outside the class, or length
+ */
+size_t goo_byte_scan_skip(const char* bytes, size_t length, GooByteClass byte_class);
+
+/**
+ * Find the first quote or backslash.
+ *
+ * @param bytes The bytes to scan
+ * @param length The number of bytes
+ * @param quote The quote character that ends the literal
+ * @return The index of the first quote or backslash, or length
+ */
+size_t goo_byte_scan_find_quote(const char* bytes, size_t length, char quote);
+
+/**
+ * Count newline bytes.
+ *
+ * @param bytes The bytes to scan
+ * @param length The number of bytes
+ * @return The number of '\n' bytes
+ */
+size_t goo_byte_scan_count_newlines(const char* bytes, size_t length);
+
+/**
+ * Check that bytes are well-formed UTF-8.
+ * Overlong encodings, surrogates and code points above U+10FFFF are rejected.
+ *
+ * @param bytes The bytes to check
+ * @param length The number of bytes
+ * @return true if the bytes are valid UTF-8
+ */
+bool goo_byte_scan_validate_utf8(const char* bytes, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOO_BYTE_SCAN_H */
@@ -15,12 +15,33 @@
 extern "C" {
 #endif
 
+// Longest string stored inline in the GooString header
+#define GOO_STRING_INLINE_CAPACITY 22
+
+// String flags (last byte of the header in both representations)
+#define GOO_STRING_FLAG_HEAP 0x80      // Bytes live in a separate allocation
+#define GOO_STRING_FLAG_INTERNED 0x40  // Owned by the intern table; compare by pointer
+#define GOO_STRING_SMALL_LENGTH_MASK 0x1f
+
 /**
  * Goo string structure.
+ * Strings of up to GOO_STRING_INLINE_CAPACITY bytes are stored in the
+ * header itself; longer ones point at a heap buffer. Use goo_string_data()
+ * and goo_string_length() rather than the fields.
  */
 typedef struct {
-    char* data;     // String data (null-terminated)
-    size_t length;  // String length (excluding null terminator)
+    union {
+        struct {
+            char* data;         // String data (null-terminated)
+            size_t length;      // String length (excluding null terminator)
+            char reserved[7];
+            unsigned char flags;
+        } heap;
+        struct {
+            char data[GOO_STRING_INLINE_CAPACITY + 1]; // Inline data and null terminator
+            unsigned char flags;                       // Length in the low bits
+        } small;
+    };
 } GooString;
 
 /**
@@ -58,12 +79,97 @@ void goo_string_free(char* str, size_t length);
 GooString* goo_string_create(const char* cstr);
 
 /**
- * Destroy a Goo string.
+ * Create a new Goo string from bytes that need not be null-terminated.
+ * 
+ * @param bytes The bytes to copy
+ * @param length The number of bytes
+ * @return A new Goo string
+ */
+GooString* goo_string_create_n(const char* bytes, size_t length);
+
+/**
+ * Destroy a Goo string. Interned strings are never destroyed.
  * 
  * @param str The string to destroy
  */
 void goo_string_destroy(GooString* str);
 
+/**
+ * Get the null-terminated bytes of a Goo string.
+ * 
+ * @param str The string
+ * @return The string data
+ */
+static inline const char* goo_string_data(const GooString* str) {
+    return (str->small.flags & GOO_STRING_FLAG_HEAP) ? str->heap.data : str->small.data;
+}
+
+/**
+ * Get the length of a Goo string.
+ * 
+ * @param str The string
+ * @return The length in bytes, excluding the null terminator
+ */
+static inline size_t goo_string_length(const GooString* str) {
+    return (str->small.flags & GOO_STRING_FLAG_HEAP) ? str->heap.length
+                                                     : (size_t)(str->small.flags & GOO_STRING_SMALL_LENGTH_MASK);
+}
+
+/**
+ * Check whether a Goo string is interned.
+ * 
+ * @param str The string
+ * @return true if the string is owned by the intern table
+ */
+static inline bool goo_string_is_interned(const GooString* str) {
+    return (str->small.flags & GOO_STRING_FLAG_INTERNED) != 0;
+}
+
+/**
+ * Get the canonical interned string for a C string.
+ * Equal strings always intern to the same pointer. Interned strings live
+ * until the process exits.
+ * 
+ * @param cstr The C string
+ * @return The interned string, or NULL on allocation failure
+ */
+GooString* goo_string_intern(const char* cstr);
+
+/**
+ * Get the canonical interned string for a byte range.
+ * 
+ * @param bytes The bytes
+ * @param length The number of bytes
+ * @return The interned string, or NULL on allocation failure
+ */
+GooString* goo_string_intern_n(const char* bytes, size_t length);
+
+/**
+ * Compare two Goo strings for equality.
+ * Two interned strings are compared by pointer only.
+ * 
+ * @param a The first string
+ * @param b The second string
+ * @return true if the strings hold the same bytes
+ */
+bool goo_string_equals(const GooString* a, const GooString* b);
+
+/**
+ * Check that a Goo string holds well-formed UTF-8.
+ * 
+ * @param str The string
+ * @return true if the bytes are valid UTF-8
+ */
+bool goo_string_is_valid_utf8(const GooString* str);
+
+/**
+ * Count the newline bytes in a Goo string.
+ * 
+ * @param str The string
+ * @return The number of '\n' bytes
+ */
+size_t goo_string_count_newlines(const GooString* str);
+
 /**
  * Allocate memory for a Goo array.
  * 
@@ -9,6 +9,7 @@
 #define GOO_SCOPE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,7 +46,8 @@ void goo_scope_exit(void);
 
 /**
  * Register a cleanup function for the current scope.
- * This function will be called when the scope is exited.
+ * This function will be called when the scope is exited. A cleanup that
+ * registers another one while running adds it to the parent scope.
  * 
  * @param data User data to pass to the cleanup function
  * @param cleanup_fn Function to call when the scope exits
@@ -53,6 +55,17 @@ void goo_scope_exit(void);
  */
 bool goo_scope_register_cleanup(void* data, void (*cleanup_fn)(void*));
 
+/**
+ * Register memory to free when the current scope exits.
+ * The entry is stored inline, so registration does not allocate.
+ * 
+ * @param ptr Memory to free with goo_free (or goo_free_aligned)
+ * @param size Size of the allocation
+ * @param alignment Alignment of the allocation (0 for default)
+ * @return true if registration was successful, false otherwise
+ */
+bool goo_scope_register_memory(void* ptr, size_t size, size_t alignment);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,358 @@
+/**
+ * goo_adaptive_schedule.c
+ *
+ * Feedback-driven scheduling for goo_parallel_for.
+ *
+ * Every call site learns in three phases. While probing, consecutive
+ * executions try static, dynamic and guided scheduling with a chunk size
+ * derived from the measured cost per iteration. While tuning, the chunk size
+ * of the fastest strategy is hill-climbed in powers of two until neither
+ * direction improves the makespan. Once converged, the learned parameters
+ * are reused, and learning restarts if the makespan drifts well away from
+ * the best one observed.
+ *
+ * Static scheduling still steals from other participants once its own block
+ * runs dry, so it doubles as the work-stealing strategy.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "goo_adaptive_schedule.h"
+
+// Strategies tried while probing
+#define PROBE_COUNT 3
+
+// A trial must beat the best makespan by this factor to be accepted
+#define IMPROVEMENT_FACTOR 0.97
+
+// Converged sites relearn when the makespan grows by this factor
+#define DRIFT_FACTOR 1.5
+
+// Converged samples to average before checking for drift
+#define DRIFT_MIN_SAMPLES 4
+
+// Weight of the newest sample in moving averages
+#define EWMA_WEIGHT 0.25
+
+// Upper bound on chunk size trials per tuning pass
+#define MAX_TUNING_STEPS 16
+
+static const GooScheduleType probe_schedules[PROBE_COUNT] = {
+    GOO_SCHEDULE_STATIC,
+    GOO_SCHEDULE_DYNAMIC,
+    GOO_SCHEDULE_GUIDED
+};
+
+// Learning state of one call site
+typedef struct AdaptiveSite {
+    GooAdaptiveSiteStats stats;          // Inspectable state
+    double probe_scores[PROBE_COUNT];    // Makespan per iteration of each probe
+    int probe_index;                     // Next strategy to probe
+    int trial_chunk;                     // Chunk size under trial while tuning
+    int direction;                       // 1 = growing, -1 = shrinking
+    bool moved;                          // A trial has been accepted in this direction
+    int tuning_steps;                    // Trials made in this tuning pass
+    double recent_ns_per_iteration;      // Moving average while converged
+    int converged_samples;               // Samples since converging
+    uint64_t generation;                 // Bumped whenever the plan changes
+    bool used;
+} AdaptiveSite;
+
+static AdaptiveSite sites[GOO_ADAPTIVE_MAX_SITES];
+static pthread_mutex_t sites_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *schedule_name(GooScheduleType schedule) {
+    switch (schedule) {
+        case GOO_SCHEDULE_STATIC:  return "static";
+        case GOO_SCHEDULE_DYNAMIC: return "dynamic";
+        case GOO_SCHEDULE_GUIDED:  return "guided";
+        case GOO_SCHEDULE_AUTO:    return "auto";
+    }
+    return "unknown";
+}
+
+static const char *phase_name(GooAdaptivePhase phase) {
+    switch (phase) {
+        case GOO_ADAPTIVE_PROBING:   return "probing";
+        case GOO_ADAPTIVE_TUNING:    return "tuning";
+        case GOO_ADAPTIVE_CONVERGED: return "converged";
+    }
+    return "unknown";
+}
+
+// Find a site's slot by open addressing, optionally claiming a free one (mutex held)
+static AdaptiveSite *find_site(const void *site, bool create) {
+    uint64_t hash = (uint64_t)(uintptr_t)site * 0x9E3779B97F4A7C15ull;
+    size_t start = (size_t)(hash >> 32) % GOO_ADAPTIVE_MAX_SITES;
+
+    for (size_t n = 0; n < GOO_ADAPTIVE_MAX_SITES; n++) {
+        AdaptiveSite *entry = &sites[(start + n) % GOO_ADAPTIVE_MAX_SITES];
+        if (entry->used && entry->stats.site == site) {
+            return entry;
+        }
+        if (!entry->used) {
+            if (!create) {
+                return NULL;
+            }
+            memset(entry, 0, sizeof(*entry));
+            entry->used = true;
+            entry->stats.site = site;
+            entry->stats.phase = GOO_ADAPTIVE_PROBING;
+            entry->stats.schedule = probe_schedules[0];
+            entry->stats.chunk_size = 1;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Chunk size that makes one chunk take about GOO_ADAPTIVE_TARGET_CHUNK_NS
+static int cost_based_chunk(const AdaptiveSite *entry, uint64_t iterations, int participants) {
+    uint64_t limit = iterations / ((uint64_t)participants * 2);
+    uint64_t chunk;
+
+    if (entry->stats.ns_per_iteration > 0.0) {
+        chunk = (uint64_t)(GOO_ADAPTIVE_TARGET_CHUNK_NS / entry->stats.ns_per_iteration);
+    } else {
+        // No measurement yet: about eight chunks per participant
+        chunk = iterations / ((uint64_t)participants * 8);
+    }
+
+    if (chunk > limit) chunk = limit;
+    if (chunk > INT_MAX) chunk = INT_MAX;
+    return chunk < 1 ? 1 : (int)chunk;
+}
+
+// Start a fresh learning pass (mutex held)
+static void restart_learning(AdaptiveSite *entry) {
+    entry->stats.phase = GOO_ADAPTIVE_PROBING;
+    entry->probe_index = 0;
+    entry->converged_samples = 0;
+    entry->generation++;
+}
+
+static void converge(AdaptiveSite *entry) {
+    entry->stats.phase = GOO_ADAPTIVE_CONVERGED;
+    entry->recent_ns_per_iteration = entry->stats.best_ns_per_iteration;
+    entry->converged_samples = 0;
+}
+
+// Choose a strategy and chunk size for one execution
+bool goo_adaptive_schedule_plan(const void *site, uint64_t iterations, int participants,
+                                GooAdaptivePlan *plan) {
+    if (site == NULL || plan == NULL || iterations == 0 || participants <= 0) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sites_mutex);
+
+    AdaptiveSite *entry = find_site(site, true);
+    if (entry == NULL) {
+        pthread_mutex_unlock(&sites_mutex);
+        return false;
+    }
+    entry->stats.calls++;
+
+    switch (entry->stats.phase) {
+        case GOO_ADAPTIVE_PROBING:
+            plan->schedule = probe_schedules[entry->probe_index];
+            plan->chunk_size = cost_based_chunk(entry, iterations, participants);
+            break;
+        case GOO_ADAPTIVE_TUNING:
+            plan->schedule = entry->stats.schedule;
+            plan->chunk_size = entry->trial_chunk;
+            break;
+        case GOO_ADAPTIVE_CONVERGED:
+            plan->schedule = entry->stats.schedule;
+            plan->chunk_size = entry->stats.chunk_size;
+            break;
+    }
+    plan->generation = entry->generation;
+
+    pthread_mutex_unlock(&sites_mutex);
+
+    if ((uint64_t)plan->chunk_size > iterations) {
+        plan->chunk_size = (int)iterations;
+    }
+    return true;
+}
+
+// Advance the tuning hill-climb with one sample (mutex held)
+static void tune_step(AdaptiveSite *entry, const GooAdaptivePlan *plan, double score) {
+    if (score < entry->stats.best_ns_per_iteration * IMPROVEMENT_FACTOR) {
+        entry->stats.chunk_size = plan->chunk_size;
+        entry->stats.best_ns_per_iteration = score;
+        entry->moved = true;
+    } else if (entry->direction > 0 && !entry->moved) {
+        // Larger chunks did not help; try smaller ones
+        entry->direction = -1;
+    } else {
+        converge(entry);
+        return;
+    }
+
+    if (++entry->tuning_steps >= MAX_TUNING_STEPS) {
+        converge(entry);
+        return;
+    }
+
+    if (entry->direction > 0) {
+        entry->trial_chunk = entry->stats.chunk_size > INT_MAX / 2 ?
+                             INT_MAX : entry->stats.chunk_size * 2;
+    } else {
+        entry->trial_chunk = entry->stats.chunk_size / 2;
+    }
+
+    if (entry->trial_chunk < 1 || entry->trial_chunk == entry->stats.chunk_size) {
+        converge(entry);
+    }
+}
+
+// Learn from the measured makespan of one execution
+void goo_adaptive_schedule_record(const void *site, const GooAdaptivePlan *plan,
+                                  uint64_t iterations, int participants, uint64_t elapsed_ns) {
+    if (site == NULL || plan == NULL || iterations == 0 || participants <= 0 ||
+        elapsed_ns < GOO_ADAPTIVE_MIN_SAMPLE_NS) {
+        return;
+    }
+
+    double score = (double)elapsed_ns / (double)iterations;
+    double cost = score * participants;
+
+    pthread_mutex_lock(&sites_mutex);
+
+    AdaptiveSite *entry = find_site(site, false);
+    if (entry == NULL) {
+        pthread_mutex_unlock(&sites_mutex);
+        return;
+    }
+
+    entry->stats.samples++;
+    if (entry->stats.ns_per_iteration <= 0.0) {
+        entry->stats.ns_per_iteration = cost;
+    } else {
+        entry->stats.ns_per_iteration += EWMA_WEIGHT * (cost - entry->stats.ns_per_iteration);
+    }
+
+    // Ignore samples from plans made before the last state change
+    if (plan->generation != entry->generation) {
+        pthread_mutex_unlock(&sites_mutex);
+        return;
+    }
+
+    switch (entry->stats.phase) {
+        case GOO_ADAPTIVE_PROBING: {
+            entry->probe_scores[entry->probe_index++] = score;
+            entry->generation++;
+            if (entry->probe_index < PROBE_COUNT) {
+                break;
+            }
+
+            int best = 0;
+            for (int i = 1; i < PROBE_COUNT; i++) {
+                if (entry->probe_scores[i] < entry->probe_scores[best]) {
+                    best = i;
+                }
+            }
+            entry->stats.schedule = probe_schedules[best];
+            entry->stats.best_ns_per_iteration = entry->probe_scores[best];
+            entry->stats.chunk_size = plan->chunk_size;
+
+            if (entry->stats.schedule == GOO_SCHEDULE_STATIC) {
+                // Static blocks ignore the chunk size; nothing to tune
+                converge(entry);
+            } else {
+                entry->stats.phase = GOO_ADAPTIVE_TUNING;
+                entry->direction = 1;
+                entry->moved = false;
+                entry->tuning_steps = 0;
+                entry->trial_chunk = entry->stats.chunk_size > INT_MAX / 2 ?
+                                     INT_MAX : entry->stats.chunk_size * 2;
+            }
+            break;
+        }
+
+        case GOO_ADAPTIVE_TUNING:
+            tune_step(entry, plan, score);
+            entry->generation++;
+            break;
+
+        case GOO_ADAPTIVE_CONVERGED:
+            entry->recent_ns_per_iteration +=
+                EWMA_WEIGHT * (score - entry->recent_ns_per_iteration);
+            if (score < entry->stats.best_ns_per_iteration) {
+                entry->stats.best_ns_per_iteration = score;
+            }
+            if (++entry->converged_samples >= DRIFT_MIN_SAMPLES &&
+                entry->recent_ns_per_iteration > entry->stats.best_ns_per_iteration * DRIFT_FACTOR) {
+                // The workload changed; what we learned no longer applies
+                restart_learning(entry);
+            }
+            break;
+    }
+
+    pthread_mutex_unlock(&sites_mutex);
+}
+
+// Get the learned state of a call site
+bool goo_adaptive_schedule_lookup(const void *site, GooAdaptiveSiteStats *stats) {
+    if (site == NULL || stats == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sites_mutex);
+    AdaptiveSite *entry = find_site(site, false);
+    if (entry != NULL) {
+        *stats = entry->stats;
+    }
+    pthread_mutex_unlock(&sites_mutex);
+
+    return entry != NULL;
+}
+
+// Copy the state of all tracked call sites
+int goo_adaptive_schedule_snapshot(GooAdaptiveSiteStats *stats, int max_sites) {
+    if (stats == NULL || max_sites <= 0) {
+        return 0;
+    }
+
+    int count = 0;
+    pthread_mutex_lock(&sites_mutex);
+    for (int i = 0; i < GOO_ADAPTIVE_MAX_SITES && count < max_sites; i++) {
+        if (sites[i].used) {
+            stats[count++] = sites[i].stats;
+        }
+    }
+    pthread_mutex_unlock(&sites_mutex);
+
+    return count;
+}
+
+// Print the learned parameters of every call site
+void goo_adaptive_schedule_print(void) {
+    GooAdaptiveSiteStats stats[GOO_ADAPTIVE_MAX_SITES];
+    int count = goo_adaptive_schedule_snapshot(stats, GOO_ADAPTIVE_MAX_SITES);
+
+    fprintf(stderr, "%-18s %10s %10s %14s %-10s %-8s %10s\n",
+            "site", "calls", "samples", "ns/iteration", "phase", "schedule", "chunk");
+    for (int i = 0; i < count; i++) {
+        fprintf(stderr, "%-18p %10llu %10llu %14.1f %-10s %-8s %10d\n",
+                stats[i].site,
+                (unsigned long long)stats[i].calls,
+                (unsigned long long)stats[i].samples,
+                stats[i].ns_per_iteration,
+                phase_name(stats[i].phase),
+                schedule_name(stats[i].schedule),
+                stats[i].chunk_size);
+    }
+}
+
+// Forget all learned state
+void goo_adaptive_schedule_reset(void) {
+    pthread_mutex_lock(&sites_mutex);
+    memset(sites, 0, sizeof(sites));
+    pthread_mutex_unlock(&sites_mutex);
+}
@@ -0,0 +1,91 @@
+/**
+ * goo_adaptive_schedule.h
+ *
+ * Feedback-driven scheduling for goo_parallel_for.
+ * Each loop call site (identified by its body function) keeps timing history,
+ * and the scheduler uses it to pick the strategy and chunk size that minimize
+ * the loop's makespan.
+ */
+
+#ifndef GOO_ADAPTIVE_SCHEDULE_H
+#define GOO_ADAPTIVE_SCHEDULE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "goo_parallel.h"
+
+// Maximum number of call sites tracked at once
+#define GOO_ADAPTIVE_MAX_SITES 256
+
+// Desired duration of one chunk; long enough to amortize a claim
+#define GOO_ADAPTIVE_TARGET_CHUNK_NS 20000
+
+// Loops shorter than this are too noisy to learn from
+#define GOO_ADAPTIVE_MIN_SAMPLE_NS 20000
+
+// Learning phase of a call site
+typedef enum {
+    GOO_ADAPTIVE_PROBING,   // Trying each strategy in turn
+    GOO_ADAPTIVE_TUNING,    // Hill-climbing the chunk size of the best strategy
+    GOO_ADAPTIVE_CONVERGED  // Using the learned parameters
+} GooAdaptivePhase;
+
+// Parameters chosen for one loop execution
+typedef struct GooAdaptivePlan {
+    GooScheduleType schedule;   // Strategy to run with
+    int chunk_size;             // Chunk size to run with
+    uint64_t generation;        // Learning state the plan was made from
+} GooAdaptivePlan;
+
+// Learned state of one call site
+typedef struct GooAdaptiveSiteStats {
+    const void *site;           // Body function pointer
+    uint64_t calls;             // Loop executions seen
+    uint64_t samples;           // Executions long enough to learn from
+    double ns_per_iteration;    // Moving average of single-thread cost per iteration
+    GooAdaptivePhase phase;     // Learning phase
+    GooScheduleType schedule;   // Best strategy so far
+    int chunk_size;             // Best chunk size so far
+    double best_ns_per_iteration; // Makespan per iteration with the best parameters
+} GooAdaptiveSiteStats;
+
+/**
+ * Choose a strategy and chunk size for one execution of a loop.
+ *
+ * @param site Body function of the loop
+ * @param iterations Number of loop iterations
+ * @param participants Number of threads that will run the loop
+ * @param plan Receives the chosen parameters
+ * @return false if the site cannot be tracked; the caller should fall back
+ *         to its static heuristics
+ */
+bool goo_adaptive_schedule_plan(const void *site, uint64_t iterations, int participants,
+                                GooAdaptivePlan *plan);
+
+/**
+ * Report the measured makespan of a loop execution made with a plan.
+ */
+void goo_adaptive_schedule_record(const void *site, const GooAdaptivePlan *plan,
+                                  uint64_t iterations, int participants, uint64_t elapsed_ns);
+
+/**
+ * Get the learned state of a call site. Returns false if the site is unknown.
+ */
+bool goo_adaptive_schedule_lookup(const void *site, GooAdaptiveSiteStats *stats);
+
+/**
+ * Copy the state of up to max_sites tracked call sites. Returns the number copied.
+ */
+int goo_adaptive_schedule_snapshot(GooAdaptiveSiteStats *stats, int max_sites);
+
+/**
+ * Print the learned parameters of every tracked call site to stderr.
+ */
+void goo_adaptive_schedule_print(void);
+
+/**
+ * Forget all learned state.
+ */
+void goo_adaptive_schedule_reset(void);
+
+#endif // GOO_ADAPTIVE_SCHEDULE_H
@@ -1,5 +1,9 @@
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
 #include "goo_parallel.h"
 #include "goo_work_distribution.h"
+#include "goo_adaptive_schedule.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -8,6 +12,7 @@
 #include <unistd.h>
 #include <stdatomic.h>
 #include <time.h>
+#include <errno.h>
 
 // Thread pool implementation
 typedef struct GooThreadPoolTask {
@@ -317,9 +322,107 @@ bool goo_parallel_init(int num_threads) {
     return init_thread_pool(num_threads);
 }
 
+// Shared state of one parallel loop. Helper tasks may start after the loop
+// has already finished, so the loop is reference counted and freed by the
+// last participant to leave.
+typedef struct ParallelForLoop {
+    _Atomic int refs;                   // Caller plus queued helper tasks
+    GooWorkDistribution *dist;          // Per-loop work distribution
+    void (*body)(uint64_t, void*);      // Loop body function
+    void *context;                      // Loop body context
+} ParallelForLoop;
+
+static void parallel_for_release(ParallelForLoop *loop) {
+    if (atomic_fetch_sub_explicit(&loop->refs, 1, memory_order_acq_rel) == 1) {
+        goo_work_distribution_destroy(loop->dist);
+        free(loop);
+    }
+}
+
+// Join the loop and run iterations until no work is left anywhere
+static void parallel_for_participate(ParallelForLoop *loop) {
+    int slot = goo_work_distribution_join(loop->dist);
+    if (slot < 0) {
+        return;
+    }
+
+    uint64_t index;
+    while (goo_work_distribution_next(loop->dist, slot, &index)) {
+        loop->body(index, loop->context);
+    }
+}
+
+// Pool task entry point for loop helpers
+static void parallel_for_helper(uint64_t unused, void *arg) {
+    (void)unused;
+    ParallelForLoop *loop = (ParallelForLoop*)arg;
+    parallel_for_participate(loop);
+    parallel_for_release(loop);
+}
+
+// Run one segment of a loop that fits in a single distribution context.
+// The calling thread always participates, so nested loops make progress
+// even when every pool worker is busy in an outer loop.
+static bool parallel_for_segment(uint64_t start, uint64_t end, uint64_t step,
+                                 void (*body)(uint64_t, void*), void *context,
+                                 GooScheduleType schedule, int chunk_size,
+                                 int num_helpers) {
+    ParallelForLoop *loop = (ParallelForLoop*)malloc(sizeof(ParallelForLoop));
+    if (loop == NULL) {
+        fprintf(stderr, "Error: Failed to allocate parallel loop\n");
+        return false;
+    }
+
+    loop->dist = goo_work_distribution_create(start, end, step, schedule, chunk_size,
+                                              num_helpers + 1);
+    if (loop->dist == NULL) {
+        fprintf(stderr, "Error: Failed to initialize work distribution\n");
+        free(loop);
+        return false;
+    }
+    loop->body = body;
+    loop->context = context;
+    atomic_init(&loop->refs, 1);
+
+    pthread_mutex_lock(&global_thread_pool->queue_mutex);
+    for (int i = 0; i < num_helpers; i++) {
+        GooThreadPoolTask *task = (GooThreadPoolTask*)malloc(sizeof(GooThreadPoolTask));
+        if (!task) {
+            // Run with the helpers queued so far; the caller covers the rest
+            fprintf(stderr, "Warning: Failed to allocate helper task for parallel loop\n");
+            break;
+        }
+
+        task->function = parallel_for_helper;
+        task->context = loop;
+        task->start = 0;
+        task->end = 1;
+        task->step = 1;
+        task->priority = 0;
+        task->next = NULL;
+        atomic_fetch_add_explicit(&loop->refs, 1, memory_order_relaxed);
+
+        if (global_thread_pool->task_queue == NULL) {
+            global_thread_pool->task_queue = task;
+            global_thread_pool->task_queue_tail = task;
+        } else {
+            global_thread_pool->task_queue_tail->next = task;
+            global_thread_pool->task_queue_tail = task;
+        }
+        global_thread_pool->tasks_count++;
+    }
+    pthread_cond_broadcast(&global_thread_pool->queue_cond);
+    pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+
+    parallel_for_participate(loop);
+    goo_work_distribution_wait(loop->dist);
+    parallel_for_release(loop);
+    return true;
+}
+
 // Execute a parallel for loop (blocking version)
-bool goo_parallel_for(size_t start, size_t end, size_t step,
-                      goo_loop_body_t body, void *context,
+bool goo_parallel_for(uint64_t start, uint64_t end, uint64_t step,
+                      void (*body)(uint64_t, void*), void *context,
                       GooScheduleType schedule, int chunk_size, int num_threads) {
     // If not initialized, initialize with auto thread count
     if (global_thread_pool == NULL) {
@@ -347,13 +450,32 @@ bool goo_parallel_for(size_t start, size_t end, size_t step,
     }
     
     // Calculate iterations to prevent overflow
-    size_t max_iterations;
+    uint64_t max_iterations;
     if (__builtin_sub_overflow(end, start, &max_iterations) || 
-        __builtin_add_overflow(max_iterations, step - 1, &max_iterations) ||
-        __builtin_div_overflow(max_iterations, step, &max_iterations)) {
+        __builtin_add_overflow(max_iterations, step - 1, &max_iterations)) {
         fprintf(stderr, "Error: Loop bounds would cause integer overflow\n");
         return false;
     }
+    max_iterations /= step;
+    if (max_iterations == 0) {
+        return true;
+    }
+    
+    // The caller is one participant; pool workers join as helpers
+    int participants = num_threads > 0 ? num_threads : global_thread_pool->num_threads + 1;
+    if ((uint64_t)participants > max_iterations) {
+        participants = (int)max_iterations;
+    }
+    
+    // AUTO without a chunk size learns both from earlier runs of the same body
+    GooAdaptivePlan plan;
+    bool adaptive = schedule == GOO_SCHEDULE_AUTO && chunk_size <= 0 &&
+                    goo_adaptive_schedule_plan((const void*)body, max_iterations,
+                                               participants, &plan);
+    if (adaptive) {
+        schedule = plan.schedule;
+        chunk_size = plan.chunk_size;
+    }
     
     // Use default chunk size if not specified or invalid
     if (chunk_size <= 0) {
@@ -375,74 +497,103 @@ bool goo_parallel_for(size_t start, size_t end, size_t step,
         if (chunk_size < 1) chunk_size = 1;
     }
     
-    // Set up the work distribution
-    if (!goo_work_distribution_init(start, end, step, max_iterations, 
-                                  schedule, chunk_size, global_thread_pool->num_threads)) {
-        fprintf(stderr, "Error: Failed to initialize work distribution\n");
-        return false;
+    struct timespec started;
+    if (adaptive) {
+        clock_gettime(CLOCK_MONOTONIC, &started);
     }
     
-    // Create tasks and submit to thread pool
-    int task_count = (schedule == GOO_SCHEDULE_STATIC) ? global_thread_pool->num_threads : 
-                                                       (int)((max_iterations + chunk_size - 1) / chunk_size);
-                                                       
-    pthread_mutex_lock(&global_thread_pool->queue_mutex);
-    
-    // Create task objects for each chunk
-    for (int i = 0; i < task_count; i++) {
-        GooThreadPoolTask *task = (GooThreadPoolTask*)malloc(sizeof(GooThreadPoolTask));
-        if (!task) {
-            fprintf(stderr, "Error: Failed to allocate task for parallel loop\n");
-            pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+    // Loops larger than one distribution context run as consecutive segments
+    uint64_t segment_iterations = GOO_WORK_DISTRIBUTION_MAX_ITERATIONS;
+    for (uint64_t done = 0; done < max_iterations; done += segment_iterations) {
+        uint64_t count = max_iterations - done < segment_iterations ?
+                         max_iterations - done : segment_iterations;
+        uint64_t seg_start = start + done * step;
+        uint64_t seg_end = seg_start + (count - 1) * step + 1;
+        if (!parallel_for_segment(seg_start, seg_end, step, body, context,
+                                  schedule, chunk_size, participants - 1)) {
             return false;
         }
-        
-        // Set up task parameters
-        task->function = body;
-        task->context = context;
-        task->start = 0;  // Will be determined by work distribution
-        task->end = 0;    // Will be determined by work distribution
-        task->step = step;
-        task->priority = 0;
-        task->next = NULL;
-        
-        // Add to task queue
-        if (global_thread_pool->task_queue == NULL) {
-            global_thread_pool->task_queue = task;
-            global_thread_pool->task_queue_tail = task;
-        } else {
-            global_thread_pool->task_queue_tail->next = task;
-            global_thread_pool->task_queue_tail = task;
-        }
-        
-        global_thread_pool->tasks_count++;
     }
     
-    // Notify all threads that work is available
-    pthread_cond_broadcast(&global_thread_pool->queue_cond);
+    if (adaptive) {
+        struct timespec finished;
+        clock_gettime(CLOCK_MONOTONIC, &finished);
+        uint64_t elapsed_ns = (uint64_t)(finished.tv_sec - started.tv_sec) * 1000000000ull +
+                              (uint64_t)(finished.tv_nsec - started.tv_nsec);
+        goo_adaptive_schedule_record((const void*)body, &plan, max_iterations,
+                                     participants, elapsed_ns);
+    }
     
-    // Wait for all tasks to complete
-    while (global_thread_pool->tasks_count > 0 || global_thread_pool->working_count > 0) {
-        pthread_cond_wait(&global_thread_pool->complete_cond, &global_thread_pool->queue_mutex);
+    return true;
+}
+
+// Shared state of a block loop; each iteration of the underlying loop is one
+// grain-aligned block
+typedef struct ParallelChunkLoop {
+    uint64_t start;                             // First index
+    uint64_t end;                               // One past the last index
+    uint64_t grain;                             // Block size
+    void (*body)(uint64_t, uint64_t, void*);    // Block body function
+    void *context;                              // Block body context
+} ParallelChunkLoop;
+
+static void parallel_chunk_body(uint64_t block, void *arg) {
+    ParallelChunkLoop *loop = (ParallelChunkLoop*)arg;
+    uint64_t begin = block * loop->grain;
+    uint64_t end = loop->end - begin > loop->grain ? begin + loop->grain : loop->end;
+    if (begin < loop->start) {
+        begin = loop->start;
+    }
+    loop->body(begin, end, loop->context);
+}
+
+// Execute a parallel loop over contiguous, grain-aligned blocks
+bool goo_parallel_for_chunks(uint64_t start, uint64_t end, uint64_t grain,
+                             void (*body)(uint64_t, uint64_t, void*), void *context,
+                             int num_threads) {
+    if (body == NULL) {
+        fprintf(stderr, "Error: Null function pointer provided to goo_parallel_for_chunks\n");
+        return false;
     }
     
-    pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+    if (grain == 0) {
+        fprintf(stderr, "Error: Block size cannot be zero in goo_parallel_for_chunks\n");
+        return false;
+    }
     
-    // Clean up the work distribution
-    goo_work_distribution_cleanup();
+    if (start >= end) {
+        return true;
+    }
     
-    return true;
+    // A single block is not worth waking the pool for
+    uint64_t first = start / grain;
+    uint64_t last = (end - 1) / grain;
+    if (first == last || num_threads == 1) {
+        body(start, end, context);
+        return true;
+    }
+    
+    ParallelChunkLoop loop = {
+        .start = start,
+        .end = end,
+        .grain = grain,
+        .body = body,
+        .context = context,
+    };
+    return goo_parallel_for(first, last + 1, 1, parallel_chunk_body, &loop,
+                            GOO_SCHEDULE_DYNAMIC, 1, num_threads);
 }
 
 // Parallel barrier synchronization
-void goo_parallel_barrier(void) {
+bool goo_parallel_barrier(void) {
     int result;
+    bool ok = true;
     
     // Acquire the barrier mutex
     result = pthread_mutex_lock(&barrier_mutex);
     if (result != 0) {
         fprintf(stderr, "Error: Failed to lock barrier mutex: %s\n", strerror(result));
-        return;
+        return false;
     }
     
     // Increment barrier count atomically
@@ -461,8 +612,10 @@ void goo_parallel_barrier(void) {
             // Reset the barrier in case of deadlock
             barrier_count = 0;
             pthread_cond_broadcast(&barrier_cond);
+            ok = false;
         } else if (result != 0) {
             fprintf(stderr, "Error: Barrier wait failed: %s\n", strerror(result));
+            ok = false;
         }
     } else {
         // All threads have arrived, reset and wake everyone
@@ -473,6 +626,7 @@ void goo_parallel_barrier(void) {
         if (result != 0) {
             fprintf(stderr, "Error: Failed to broadcast barrier condition: %s\n", 
                    strerror(result));
+            ok = false;
         }
     }
     
@@ -480,7 +634,10 @@ void goo_parallel_barrier(void) {
     result = pthread_mutex_unlock(&barrier_mutex);
     if (result != 0) {
         fprintf(stderr, "Error: Failed to unlock barrier mutex: %s\n", strerror(result));
+        ok = false;
     }
+    
+    return ok;
 }
 
 // Placeholder stubs for remaining functions with proper handling of unused parameters
@@ -512,13 +669,6 @@ bool goo_parallel_begin(int num_threads, GooSharedVar *shared_vars, int var_coun
     return false;
 }
 
-// Forward to the vectorization implementation
-bool goo_vector_execute(GooVector *vec_op) {
-    // This will be implemented in goo_vectorization.c
-    (void)vec_op;  // Mark as used
-    return false;
-}
-
 void goo_parallel_set_threads(int num_threads) {
     (void)num_threads;  // Mark as used
 }
@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include "../../../include/goo/core/types.h"
 
 // Forward declarations
 struct GooThreadPool;
@@ -48,15 +49,6 @@ typedef enum {
     GOO_REDUCE_CUSTOM      // Custom reduction function
 } GooReductionOp;
 
-// Vector operations for SIMD support
-typedef enum {
-    GOO_VECTOR_ADD,        // Vector addition
-    GOO_VECTOR_SUB,        // Vector subtraction
-    GOO_VECTOR_MUL,        // Vector multiplication
-    GOO_VECTOR_DIV,        // Vector division
-    GOO_VECTOR_CUSTOM      // Custom vector operation
-} GooVectorOp;
-
 // Parallel loop configuration
 typedef struct GooParallelLoop {
     GooParallelMode mode;          // Type of parallelism
@@ -105,6 +97,13 @@ bool goo_parallel_for(uint64_t start, uint64_t end, uint64_t step,
                      void (*body)(uint64_t, void*), void *context,
                      GooScheduleType schedule, int chunk_size, int num_threads);
 
+// Execute a parallel loop over contiguous blocks. body receives [begin, end)
+// ranges whose interior boundaries fall on multiples of grain, so blocks of
+// an aligned array start aligned.
+bool goo_parallel_for_chunks(uint64_t start, uint64_t end, uint64_t grain,
+                             void (*body)(uint64_t, uint64_t, void*), void *context,
+                             int num_threads);
+
 // Execute a parallel foreach loop
 bool goo_parallel_foreach(void *items, size_t count, size_t item_size,
                          void (*body)(void*, void*), void *context,
@@ -116,7 +115,8 @@ bool goo_parallel_begin(int num_threads, GooSharedVar *shared_vars, int var_coun
 // End a parallel region
 void goo_parallel_end(void);
 
-// Execute a vector operation (SIMD)
+// Execute a vector operation (SIMD), splitting large arrays across the
+// worker pool; implemented in goo_vectorization.c
 bool goo_vector_execute(GooVector *vec_op);
 
 // Set the maximum number of threads
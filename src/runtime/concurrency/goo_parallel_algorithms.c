@@ -0,0 +1,746 @@
+/**
+ * goo_parallel_algorithms.c
+ *
+ * Parallel algorithm building blocks for the Goo runtime.
+ * Every algorithm splits its input into blocks and runs the per-block work
+ * through goo_parallel_for, with short sequential phases in between to
+ * combine per-block results.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "goo_parallel.h"
+#include "goo_parallel_algorithms.h"
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+#define BLOCKS_PER_THREAD 4
+#define MIN_MERGE_SEGMENT 1024
+#define HISTOGRAM_MERGE_CHUNK 1024
+
+// Number of workers available to the algorithms
+static int algo_num_threads(void) {
+    if (!goo_parallel_init(0)) {
+        return 1;
+    }
+    int n = goo_parallel_get_num_threads();
+    return n > 0 ? n : 1;
+}
+
+// Choose a block count: a few blocks per worker, but never blocks smaller than min_block
+static size_t algo_block_count(size_t count, size_t min_block, size_t per_thread) {
+    if (count < GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF) {
+        return 1;
+    }
+    size_t target = (size_t)algo_num_threads() * per_thread;
+    size_t max_blocks = count / min_block;
+    if (max_blocks == 0) {
+        max_blocks = 1;
+    }
+    return target < max_blocks ? target : max_blocks;
+}
+
+// First element of block b when count elements are split into nblocks near-equal blocks
+static inline size_t block_begin(size_t b, size_t nblocks, size_t count) {
+    size_t base = count / nblocks;
+    size_t extra = count % nblocks;
+    return b * base + (b < extra ? b : extra);
+}
+
+// Run body for each block index, falling back to the calling thread if the pool is unavailable
+static void run_blocks(size_t nblocks, void (*body)(uint64_t, void*), void *context) {
+    if (nblocks > 1 &&
+        goo_parallel_for(0, nblocks, 1, body, context, GOO_SCHEDULE_DYNAMIC, 1, 0)) {
+        return;
+    }
+    for (size_t b = 0; b < nblocks; b++) {
+        body(b, context);
+    }
+}
+
+// ============================================================================
+// Parallel merge sort
+// ============================================================================
+
+typedef struct {
+    char *src;              // Runs being merged
+    char *dst;              // Merge output
+    size_t count;           // Number of elements
+    size_t elem_size;       // Element size in bytes
+    GooCompareFn cmp;       // Comparison function
+    size_t width;           // Current run width
+    size_t segments;        // Merge-path segments per run pair
+} SortContext;
+
+// Sort one initial run in place
+static void sort_run_body(uint64_t run, void *arg) {
+    SortContext *ctx = (SortContext*)arg;
+    size_t begin = run * ctx->width;
+    size_t end = begin + ctx->width < ctx->count ? begin + ctx->width : ctx->count;
+    if (begin < end) {
+        qsort(ctx->src + begin * ctx->elem_size, end - begin, ctx->elem_size, ctx->cmp);
+    }
+}
+
+// Number of elements taken from a among the first k merged elements (ties favour a)
+static size_t merge_co_rank(size_t k, const char *a, size_t m, const char *b, size_t n,
+                            size_t es, GooCompareFn cmp) {
+    size_t lo = k > n ? k - n : 0;
+    size_t hi = k < m ? k : m;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmp(a + mid * es, b + (k - mid - 1) * es) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void merge_range(const char *a, size_t m, const char *b, size_t n, char *out,
+                        size_t es, GooCompareFn cmp) {
+    size_t i = 0, j = 0;
+    while (i < m && j < n) {
+        if (cmp(b + j * es, a + i * es) < 0) {
+            memcpy(out, b + j * es, es);
+            j++;
+        } else {
+            memcpy(out, a + i * es, es);
+            i++;
+        }
+        out += es;
+    }
+    if (i < m) {
+        memcpy(out, a + i * es, (m - i) * es);
+    } else if (j < n) {
+        memcpy(out, b + j * es, (n - j) * es);
+    }
+}
+
+// Merge one segment of one run pair; segments split the output along the merge path
+static void sort_merge_body(uint64_t unit, void *arg) {
+    SortContext *ctx = (SortContext*)arg;
+    size_t es = ctx->elem_size;
+    size_t pair = unit / ctx->segments;
+    size_t seg = unit % ctx->segments;
+
+    size_t a_begin = pair * 2 * ctx->width;
+    if (a_begin >= ctx->count) {
+        return;
+    }
+    size_t a_end = a_begin + ctx->width < ctx->count ? a_begin + ctx->width : ctx->count;
+    size_t b_end = a_end + ctx->width < ctx->count ? a_end + ctx->width : ctx->count;
+
+    const char *a = ctx->src + a_begin * es;
+    const char *b = ctx->src + a_end * es;
+    size_t m = a_end - a_begin;
+    size_t n = b_end - a_end;
+    size_t total = m + n;
+
+    size_t k0 = block_begin(seg, ctx->segments, total);
+    size_t k1 = block_begin(seg + 1, ctx->segments, total);
+    size_t i0 = merge_co_rank(k0, a, m, b, n, es, ctx->cmp);
+    size_t i1 = merge_co_rank(k1, a, m, b, n, es, ctx->cmp);
+
+    merge_range(a + i0 * es, i1 - i0, b + (k0 - i0) * es, (k1 - i1) - (k0 - i0),
+                ctx->dst + (a_begin + k0) * es, es, ctx->cmp);
+}
+
+bool goo_parallel_sort(void *base, size_t count, size_t elem_size, GooCompareFn cmp) {
+    if (base == NULL || cmp == NULL || elem_size == 0) {
+        fprintf(stderr, "Error: Invalid arguments to goo_parallel_sort\n");
+        return false;
+    }
+
+    size_t nruns = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, BLOCKS_PER_THREAD);
+    if (nruns <= 1) {
+        qsort(base, count, elem_size, cmp);
+        return true;
+    }
+
+    char *scratch = (char*)malloc(count * elem_size);
+    if (scratch == NULL) {
+        fprintf(stderr, "Error: Failed to allocate merge buffer for goo_parallel_sort\n");
+        return false;
+    }
+
+    SortContext ctx = {
+        .src = (char*)base,
+        .dst = scratch,
+        .count = count,
+        .elem_size = elem_size,
+        .cmp = cmp,
+        .width = (count + nruns - 1) / nruns,
+        .segments = 1,
+    };
+
+    // Sort the initial runs independently
+    run_blocks(nruns, sort_run_body, &ctx);
+
+    // Merge runs pairwise; fewer pairs per round means more segments per pair
+    size_t target_units = (size_t)algo_num_threads() * 2;
+    while (ctx.width < count) {
+        size_t pairs = (count + 2 * ctx.width - 1) / (2 * ctx.width);
+        size_t segments = (target_units + pairs - 1) / pairs;
+        size_t max_segments = (2 * ctx.width) / MIN_MERGE_SEGMENT;
+        if (segments > max_segments) segments = max_segments;
+        if (segments < 1) segments = 1;
+        ctx.segments = segments;
+
+        run_blocks(pairs * segments, sort_merge_body, &ctx);
+
+        char *tmp = ctx.src;
+        ctx.src = ctx.dst;
+        ctx.dst = tmp;
+        ctx.width *= 2;
+    }
+
+    if (ctx.src != (char*)base) {
+        memcpy(base, ctx.src, count * elem_size);
+    }
+
+    free(scratch);
+    return true;
+}
+
+// ============================================================================
+// Parallel LSD radix sort
+// ============================================================================
+
+typedef struct {
+    const void *src;        // Keys for this pass
+    void *dst;              // Scatter target for this pass
+    size_t count;           // Number of keys
+    size_t nblocks;         // Number of blocks
+    unsigned shift;         // Bit offset of the current digit
+    size_t *offsets;        // nblocks x RADIX_BUCKETS counts, then scatter offsets
+} RadixContext;
+
+#define GOO_DEFINE_RADIX_KERNELS(suffix, key_type)                                  \
+static void radix_count_body_##suffix(uint64_t b, void *arg) {                      \
+    RadixContext *ctx = (RadixContext*)arg;                                         \
+    const key_type *keys = (const key_type*)ctx->src;                               \
+    size_t *counts = ctx->offsets + b * RADIX_BUCKETS;                              \
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);                        \
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);                      \
+    memset(counts, 0, RADIX_BUCKETS * sizeof(size_t));                              \
+    for (size_t i = begin; i < end; i++) {                                          \
+        counts[(keys[i] >> ctx->shift) & RADIX_MASK]++;                             \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static void radix_scatter_body_##suffix(uint64_t b, void *arg) {                    \
+    RadixContext *ctx = (RadixContext*)arg;                                         \
+    const key_type *keys = (const key_type*)ctx->src;                               \
+    key_type *out = (key_type*)ctx->dst;                                            \
+    size_t offsets[RADIX_BUCKETS];                                                  \
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);                        \
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);                      \
+    memcpy(offsets, ctx->offsets + b * RADIX_BUCKETS, sizeof(offsets));             \
+    for (size_t i = begin; i < end; i++) {                                          \
+        key_type k = keys[i];                                                       \
+        out[offsets[(k >> ctx->shift) & RADIX_MASK]++] = k;                         \
+    }                                                                               \
+}
+
+GOO_DEFINE_RADIX_KERNELS(u32, uint32_t)
+GOO_DEFINE_RADIX_KERNELS(u64, uint64_t)
+
+// Turn per-block digit counts into scatter offsets (digit-major, block-minor).
+// Returns false if every key has the same digit, in which case the pass can be skipped.
+static bool radix_prefix_offsets(RadixContext *ctx) {
+    size_t sum = 0;
+    for (size_t d = 0; d < RADIX_BUCKETS; d++) {
+        size_t digit_total = 0;
+        for (size_t b = 0; b < ctx->nblocks; b++) {
+            size_t *slot = &ctx->offsets[b * RADIX_BUCKETS + d];
+            size_t c = *slot;
+            *slot = sum;
+            sum += c;
+            digit_total += c;
+        }
+        if (digit_total == ctx->count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool radix_sort(void *keys, size_t count, size_t key_size,
+                       void (*count_body)(uint64_t, void*),
+                       void (*scatter_body)(uint64_t, void*)) {
+    if (keys == NULL) {
+        fprintf(stderr, "Error: Null key array provided to radix sort\n");
+        return false;
+    }
+    if (count < 2) {
+        return true;
+    }
+
+    void *scratch = malloc(count * key_size);
+    size_t nblocks = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, 1);
+    size_t *offsets = (size_t*)malloc(nblocks * RADIX_BUCKETS * sizeof(size_t));
+    if (scratch == NULL || offsets == NULL) {
+        fprintf(stderr, "Error: Failed to allocate radix sort buffers\n");
+        free(scratch);
+        free(offsets);
+        return false;
+    }
+
+    RadixContext ctx = {
+        .src = keys,
+        .dst = scratch,
+        .count = count,
+        .nblocks = nblocks,
+        .shift = 0,
+        .offsets = offsets,
+    };
+
+    for (unsigned shift = 0; shift < key_size * 8; shift += RADIX_BITS) {
+        ctx.shift = shift;
+        run_blocks(nblocks, count_body, &ctx);
+        if (!radix_prefix_offsets(&ctx)) {
+            continue;
+        }
+        run_blocks(nblocks, scatter_body, &ctx);
+
+        const void *tmp = ctx.src;
+        ctx.src = ctx.dst;
+        ctx.dst = (void*)tmp;
+    }
+
+    if (ctx.src != keys) {
+        memcpy(keys, ctx.src, count * key_size);
+    }
+
+    free(offsets);
+    free(scratch);
+    return true;
+}
+
+bool goo_parallel_radix_sort_u32(uint32_t *keys, size_t count) {
+    return radix_sort(keys, count, sizeof(uint32_t),
+                      radix_count_body_u32, radix_scatter_body_u32);
+}
+
+bool goo_parallel_radix_sort_u64(uint64_t *keys, size_t count) {
+    return radix_sort(keys, count, sizeof(uint64_t),
+                      radix_count_body_u64, radix_scatter_body_u64);
+}
+
+// ============================================================================
+// Parallel prefix scan
+// ============================================================================
+
+typedef struct {
+    const char *in;         // Input elements
+    char *out;              // Output elements
+    size_t count;           // Number of elements
+    size_t elem_size;       // Element size in bytes
+    size_t nblocks;         // Number of blocks
+    GooScanOp op;           // Associative operation
+    const void *identity;   // Identity element
+    bool inclusive;         // Inclusive or exclusive scan
+    char *block_sums;       // Per-block totals, then per-block carry-in
+    char *scratch;          // 3 elements of scratch per block
+} ScanContext;
+
+// Phase 1: reduce each block to a single value
+static void scan_reduce_body(uint64_t b, void *arg) {
+    ScanContext *ctx = (ScanContext*)arg;
+    size_t es = ctx->elem_size;
+    char *acc = ctx->scratch + b * 3 * es;
+    char *next = acc + es;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+
+    memcpy(acc, ctx->identity, es);
+    for (size_t i = begin; i < end; i++) {
+        ctx->op(next, acc, ctx->in + i * es);
+        char *tmp = acc;
+        acc = next;
+        next = tmp;
+    }
+    memcpy(ctx->block_sums + b * es, acc, es);
+}
+
+// Phase 3: scan each block starting from its carry-in
+static void scan_apply_body(uint64_t b, void *arg) {
+    ScanContext *ctx = (ScanContext*)arg;
+    size_t es = ctx->elem_size;
+    char *acc = ctx->scratch + b * 3 * es;
+    char *next = acc + es;
+    char *elem = next + es;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+
+    memcpy(acc, ctx->block_sums + b * es, es);
+    for (size_t i = begin; i < end; i++) {
+        // Copy the input first so that in and out may alias
+        memcpy(elem, ctx->in + i * es, es);
+        ctx->op(next, acc, elem);
+        memcpy(ctx->out + i * es, ctx->inclusive ? next : acc, es);
+        char *tmp = acc;
+        acc = next;
+        next = tmp;
+    }
+}
+
+static bool scan_generic(const void *in, void *out, size_t count, size_t elem_size,
+                         GooScanOp op, const void *identity, bool inclusive) {
+    if (in == NULL || out == NULL || op == NULL || identity == NULL || elem_size == 0) {
+        fprintf(stderr, "Error: Invalid arguments to parallel scan\n");
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    size_t nblocks = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, BLOCKS_PER_THREAD);
+    // Per-block sums, per-block scratch, and scratch for the carry pass
+    char *buffers = (char*)malloc((nblocks + nblocks * 3 + 3) * elem_size);
+    if (buffers == NULL) {
+        fprintf(stderr, "Error: Failed to allocate scan buffers\n");
+        return false;
+    }
+
+    ScanContext ctx = {
+        .in = (const char*)in,
+        .out = (char*)out,
+        .count = count,
+        .elem_size = elem_size,
+        .nblocks = nblocks,
+        .op = op,
+        .identity = identity,
+        .inclusive = inclusive,
+        .block_sums = buffers,
+        .scratch = buffers + nblocks * elem_size,
+    };
+
+    if (nblocks > 1) {
+        run_blocks(nblocks, scan_reduce_body, &ctx);
+
+        // Phase 2: exclusive scan of the block sums on the calling thread
+        char *acc = ctx.scratch + nblocks * 3 * elem_size;
+        char *next = acc + elem_size;
+        char *sum = next + elem_size;
+        memcpy(acc, identity, elem_size);
+        for (size_t b = 0; b < nblocks; b++) {
+            memcpy(sum, ctx.block_sums + b * elem_size, elem_size);
+            memcpy(ctx.block_sums + b * elem_size, acc, elem_size);
+            op(next, acc, sum);
+            char *tmp = acc;
+            acc = next;
+            next = tmp;
+        }
+    } else {
+        memcpy(ctx.block_sums, identity, elem_size);
+    }
+
+    run_blocks(nblocks, scan_apply_body, &ctx);
+
+    free(buffers);
+    return true;
+}
+
+bool goo_parallel_inclusive_scan(const void *in, void *out, size_t count, size_t elem_size,
+                                GooScanOp op, const void *identity) {
+    return scan_generic(in, out, count, elem_size, op, identity, true);
+}
+
+bool goo_parallel_exclusive_scan(const void *in, void *out, size_t count, size_t elem_size,
+                                GooScanOp op, const void *identity) {
+    return scan_generic(in, out, count, elem_size, op, identity, false);
+}
+
+typedef struct {
+    const int64_t *in;      // Input elements
+    int64_t *out;           // Output elements
+    size_t count;           // Number of elements
+    size_t nblocks;         // Number of blocks
+    bool inclusive;         // Inclusive or exclusive scan
+    int64_t *block_sums;    // Per-block totals, then per-block carry-in
+} ScanI64Context;
+
+static void scan_i64_reduce_body(uint64_t b, void *arg) {
+    ScanI64Context *ctx = (ScanI64Context*)arg;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    int64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        sum += ctx->in[i];
+    }
+    ctx->block_sums[b] = sum;
+}
+
+static void scan_i64_apply_body(uint64_t b, void *arg) {
+    ScanI64Context *ctx = (ScanI64Context*)arg;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    int64_t acc = ctx->block_sums[b];
+    if (ctx->inclusive) {
+        for (size_t i = begin; i < end; i++) {
+            acc += ctx->in[i];
+            ctx->out[i] = acc;
+        }
+    } else {
+        for (size_t i = begin; i < end; i++) {
+            int64_t v = ctx->in[i];
+            ctx->out[i] = acc;
+            acc += v;
+        }
+    }
+}
+
+static bool scan_i64(const int64_t *in, int64_t *out, size_t count, bool inclusive) {
+    if (in == NULL || out == NULL) {
+        fprintf(stderr, "Error: Null array provided to parallel scan\n");
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    size_t nblocks = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, BLOCKS_PER_THREAD);
+    int64_t *block_sums = (int64_t*)calloc(nblocks, sizeof(int64_t));
+    if (block_sums == NULL) {
+        fprintf(stderr, "Error: Failed to allocate scan buffers\n");
+        return false;
+    }
+
+    ScanI64Context ctx = {
+        .in = in,
+        .out = out,
+        .count = count,
+        .nblocks = nblocks,
+        .inclusive = inclusive,
+        .block_sums = block_sums,
+    };
+
+    if (nblocks > 1) {
+        run_blocks(nblocks, scan_i64_reduce_body, &ctx);
+        int64_t acc = 0;
+        for (size_t b = 0; b < nblocks; b++) {
+            int64_t sum = block_sums[b];
+            block_sums[b] = acc;
+            acc += sum;
+        }
+    }
+
+    run_blocks(nblocks, scan_i64_apply_body, &ctx);
+
+    free(block_sums);
+    return true;
+}
+
+bool goo_parallel_inclusive_scan_i64(const int64_t *in, int64_t *out, size_t count) {
+    return scan_i64(in, out, count, true);
+}
+
+bool goo_parallel_exclusive_scan_i64(const int64_t *in, int64_t *out, size_t count) {
+    return scan_i64(in, out, count, false);
+}
+
+// ============================================================================
+// Parallel stable partition
+// ============================================================================
+
+typedef struct {
+    char *base;             // Array being partitioned
+    char *tmp;              // Scatter target
+    size_t count;           // Number of elements
+    size_t elem_size;       // Element size in bytes
+    size_t nblocks;         // Number of blocks
+    GooPredicateFn pred;    // Predicate
+    void *context;          // Predicate context
+    uint8_t *flags;         // Cached predicate results
+    size_t *true_offsets;   // Per-block true counts, then output offsets
+    size_t *false_offsets;  // Per-block output offsets for false elements
+} PartitionContext;
+
+// Phase 1: evaluate the predicate once per element and count matches per block
+static void partition_count_body(uint64_t b, void *arg) {
+    PartitionContext *ctx = (PartitionContext*)arg;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    size_t trues = 0;
+    for (size_t i = begin; i < end; i++) {
+        bool match = ctx->pred(ctx->base + i * ctx->elem_size, ctx->context);
+        ctx->flags[i] = match;
+        trues += match;
+    }
+    ctx->true_offsets[b] = trues;
+}
+
+// Phase 2: scatter each block's elements to their final positions
+static void partition_scatter_body(uint64_t b, void *arg) {
+    PartitionContext *ctx = (PartitionContext*)arg;
+    size_t es = ctx->elem_size;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    size_t t = ctx->true_offsets[b];
+    size_t f = ctx->false_offsets[b];
+    for (size_t i = begin; i < end; i++) {
+        size_t dst = ctx->flags[i] ? t++ : f++;
+        memcpy(ctx->tmp + dst * es, ctx->base + i * es, es);
+    }
+}
+
+static void partition_copy_body(uint64_t b, void *arg) {
+    PartitionContext *ctx = (PartitionContext*)arg;
+    size_t es = ctx->elem_size;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    memcpy(ctx->base + begin * es, ctx->tmp + begin * es, (end - begin) * es);
+}
+
+bool goo_parallel_stable_partition(void *base, size_t count, size_t elem_size,
+                                  GooPredicateFn pred, void *context, size_t *split) {
+    if (base == NULL || pred == NULL || elem_size == 0) {
+        fprintf(stderr, "Error: Invalid arguments to goo_parallel_stable_partition\n");
+        return false;
+    }
+    if (count == 0) {
+        if (split) *split = 0;
+        return true;
+    }
+
+    size_t nblocks = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, BLOCKS_PER_THREAD);
+    char *tmp = (char*)malloc(count * elem_size);
+    uint8_t *flags = (uint8_t*)malloc(count);
+    size_t *offsets = (size_t*)malloc(nblocks * 2 * sizeof(size_t));
+    if (tmp == NULL || flags == NULL || offsets == NULL) {
+        fprintf(stderr, "Error: Failed to allocate partition buffers\n");
+        free(tmp);
+        free(flags);
+        free(offsets);
+        return false;
+    }
+
+    PartitionContext ctx = {
+        .base = (char*)base,
+        .tmp = tmp,
+        .count = count,
+        .elem_size = elem_size,
+        .nblocks = nblocks,
+        .pred = pred,
+        .context = context,
+        .flags = flags,
+        .true_offsets = offsets,
+        .false_offsets = offsets + nblocks,
+    };
+
+    run_blocks(nblocks, partition_count_body, &ctx);
+
+    size_t total_true = 0;
+    for (size_t b = 0; b < nblocks; b++) {
+        total_true += ctx.true_offsets[b];
+    }
+    size_t true_prefix = 0;
+    for (size_t b = 0; b < nblocks; b++) {
+        size_t trues = ctx.true_offsets[b];
+        size_t begin = block_begin(b, nblocks, count);
+        ctx.true_offsets[b] = true_prefix;
+        ctx.false_offsets[b] = total_true + (begin - true_prefix);
+        true_prefix += trues;
+    }
+
+    run_blocks(nblocks, partition_scatter_body, &ctx);
+    run_blocks(nblocks, partition_copy_body, &ctx);
+
+    if (split) {
+        *split = total_true;
+    }
+
+    free(offsets);
+    free(flags);
+    free(tmp);
+    return true;
+}
+
+// ============================================================================
+// Parallel histogram
+// ============================================================================
+
+typedef struct {
+    const char *base;       // Input elements
+    size_t count;           // Number of elements
+    size_t elem_size;       // Element size in bytes
+    size_t nblocks;         // Number of blocks
+    GooBinFn bin;           // Binning function
+    void *context;          // Binning context
+    uint64_t *local;        // Private histogram per block
+    size_t stride;          // Row stride of local, padded to a cache line
+    uint64_t *bins;         // Output histogram
+    size_t num_bins;        // Number of bins
+} HistogramContext;
+
+static void histogram_fill_body(uint64_t b, void *arg) {
+    HistogramContext *ctx = (HistogramContext*)arg;
+    uint64_t *local = ctx->local + b * ctx->stride;
+    size_t begin = block_begin(b, ctx->nblocks, ctx->count);
+    size_t end = block_begin(b + 1, ctx->nblocks, ctx->count);
+    for (size_t i = begin; i < end; i++) {
+        size_t idx = ctx->bin(ctx->base + i * ctx->elem_size, ctx->context);
+        // Out-of-range bins are dropped
+        if (idx < ctx->num_bins) {
+            local[idx]++;
+        }
+    }
+}
+
+// Sum one range of bins across all private histograms
+static void histogram_merge_body(uint64_t chunk, void *arg) {
+    HistogramContext *ctx = (HistogramContext*)arg;
+    size_t begin = chunk * HISTOGRAM_MERGE_CHUNK;
+    size_t end = begin + HISTOGRAM_MERGE_CHUNK < ctx->num_bins ?
+                 begin + HISTOGRAM_MERGE_CHUNK : ctx->num_bins;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t sum = 0;
+        for (size_t b = 0; b < ctx->nblocks; b++) {
+            sum += ctx->local[b * ctx->stride + i];
+        }
+        ctx->bins[i] = sum;
+    }
+}
+
+bool goo_parallel_histogram(const void *base, size_t count, size_t elem_size,
+                           GooBinFn bin, void *context,
+                           uint64_t *bins, size_t num_bins) {
+    if (base == NULL || bin == NULL || bins == NULL || elem_size == 0 || num_bins == 0) {
+        fprintf(stderr, "Error: Invalid arguments to goo_parallel_histogram\n");
+        return false;
+    }
+
+    // One private histogram per worker keeps the merge cost bounded
+    size_t nblocks = algo_block_count(count, GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF, 1);
+    size_t stride = (num_bins + 7) & ~(size_t)7;
+    uint64_t *local = (uint64_t*)calloc(nblocks * stride, sizeof(uint64_t));
+    if (local == NULL) {
+        fprintf(stderr, "Error: Failed to allocate histogram buffers\n");
+        return false;
+    }
+
+    HistogramContext ctx = {
+        .base = (const char*)base,
+        .count = count,
+        .elem_size = elem_size,
+        .nblocks = nblocks,
+        .bin = bin,
+        .context = context,
+        .local = local,
+        .stride = stride,
+        .bins = bins,
+        .num_bins = num_bins,
+    };
+
+    run_blocks(nblocks, histogram_fill_body, &ctx);
+    run_blocks((num_bins + HISTOGRAM_MERGE_CHUNK - 1) / HISTOGRAM_MERGE_CHUNK,
+               histogram_merge_body, &ctx);
+
+    free(local);
+    return true;
+}
@@ -0,0 +1,114 @@
+/**
+ * goo_parallel_algorithms.h
+ *
+ * Parallel algorithm building blocks for the Goo runtime.
+ * Provides sorting, prefix scans, partitioning and histograms on top of
+ * the goo_parallel_for worker pool.
+ */
+
+#ifndef GOO_PARALLEL_ALGORITHMS_H
+#define GOO_PARALLEL_ALGORITHMS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Inputs smaller than this are processed on the calling thread
+#define GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF 4096
+
+// Comparison function (qsort-compatible)
+typedef int (*GooCompareFn)(const void *a, const void *b);
+
+// Associative binary operation for scans: result = lhs op rhs
+typedef void (*GooScanOp)(void *result, const void *lhs, const void *rhs);
+
+// Predicate used by stable partition
+typedef bool (*GooPredicateFn)(const void *elem, void *context);
+
+// Maps an element to a histogram bin in [0, num_bins)
+typedef size_t (*GooBinFn)(const void *elem, void *context);
+
+/**
+ * Sort an array in parallel.
+ *
+ * Blocks are sorted independently and then combined with merge-path
+ * partitioned merges, so every merge round keeps all workers busy.
+ * Equal elements keep their relative order only within a block; use a
+ * comparator with a tie-breaker if full stability is required.
+ *
+ * @param base Array to sort
+ * @param count Number of elements
+ * @param elem_size Size of each element in bytes
+ * @param cmp Comparison function
+ * @return true if successful, false otherwise
+ */
+bool goo_parallel_sort(void *base, size_t count, size_t elem_size, GooCompareFn cmp);
+
+/**
+ * Sort unsigned 32-bit keys with a parallel LSD radix sort (8-bit digits).
+ */
+bool goo_parallel_radix_sort_u32(uint32_t *keys, size_t count);
+
+/**
+ * Sort unsigned 64-bit keys with a parallel LSD radix sort (8-bit digits).
+ */
+bool goo_parallel_radix_sort_u64(uint64_t *keys, size_t count);
+
+/**
+ * Compute an inclusive prefix scan: out[i] = in[0] op ... op in[i].
+ *
+ * @param in Input array
+ * @param out Output array (may alias in)
+ * @param count Number of elements
+ * @param elem_size Size of each element in bytes
+ * @param op Associative operation
+ * @param identity Identity element of op
+ * @return true if successful, false otherwise
+ */
+bool goo_parallel_inclusive_scan(const void *in, void *out, size_t count, size_t elem_size,
+                                GooScanOp op, const void *identity);
+
+/**
+ * Compute an exclusive prefix scan: out[0] = identity, out[i] = in[0] op ... op in[i-1].
+ */
+bool goo_parallel_exclusive_scan(const void *in, void *out, size_t count, size_t elem_size,
+                                GooScanOp op, const void *identity);
+
+/**
+ * Inclusive and exclusive prefix sums over int64_t without per-element calls.
+ */
+bool goo_parallel_inclusive_scan_i64(const int64_t *in, int64_t *out, size_t count);
+bool goo_parallel_exclusive_scan_i64(const int64_t *in, int64_t *out, size_t count);
+
+/**
+ * Stably partition an array so that elements satisfying pred come first.
+ *
+ * @param base Array to partition
+ * @param count Number of elements
+ * @param elem_size Size of each element in bytes
+ * @param pred Predicate function
+ * @param context User context passed to pred
+ * @param split Receives the number of elements satisfying pred (optional)
+ * @return true if successful, false otherwise
+ */
+bool goo_parallel_stable_partition(void *base, size_t count, size_t elem_size,
+                                  GooPredicateFn pred, void *context, size_t *split);
+
+/**
+ * Build a histogram in parallel. Each worker fills a private histogram
+ * which is merged at the end, so bins are never contended.
+ *
+ * @param base Input array
+ * @param count Number of elements
+ * @param elem_size Size of each element in bytes
+ * @param bin Function mapping an element to its bin
+ * @param context User context passed to bin
+ * @param bins Output histogram (num_bins entries, overwritten)
+ * @param num_bins Number of bins
+ * @return true if successful, false otherwise
+ */
+bool goo_parallel_histogram(const void *base, size_t count, size_t elem_size,
+                           GooBinFn bin, void *context,
+                           uint64_t *bins, size_t num_bins);
+
+#endif // GOO_PARALLEL_ALGORITHMS_H
@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "goo_vectorization.h"
 
 // Platform-specific includes for SIMD intrinsics
@@ -17,43 +19,117 @@
     #include <immintrin.h>
 #elif defined(__arm__) || defined(__aarch64__)
     #include <arm_neon.h>
+    #if defined(__linux__)
+        #include <sys/auxv.h>
+        #include <asm/hwcap.h>
+    #endif
+#endif
+
+/*
+ * x86 kernels are compiled for their own instruction set with per-function
+ * target attributes, independent of the flags the file is built with, and
+ * selected at runtime from CPUID. A portable build gets AVX-512 on hosts that
+ * have it, and never executes an instruction the host lacks.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #include <cpuid.h>
+    #define GOO_VEC_X86_DISPATCH 1
+    #define GOO_TARGET_SSE2 __attribute__((target("sse2")))
+    #define GOO_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #define GOO_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
 #endif
 
+// Kernel signature shared by every instruction set
+typedef bool (*GooVectorKernel)(GooVectorOp op, void* src1, void* src2, void* dst,
+                                size_t elem_size, size_t length, GooVectorDataType type);
+
+// Kernels for one instruction set. Arguments are validated by the public
+// entry points; blend, gather and scatter only depend on the element size
+typedef struct {
+    GooVectorKernel elementwise;
+    void (*reduce)(GooVectorReduceOp op, const void* src, size_t length,
+                   GooVectorDataType type, void* result);
+    void (*dot)(const void* a, const void* b, size_t length,
+                GooVectorDataType type, void* result);
+    void (*compare)(GooVectorCompareOp cmp, const void* a, const void* b,
+                    size_t length, GooVectorDataType type, void* mask);
+    void (*blend)(const void* a, const void* b, const void* mask, void* dst,
+                  size_t length, size_t elem_size);
+    void (*gather)(const void* base, const int32_t* indices, size_t length,
+                   size_t elem_size, void* dst);
+    void (*scatter)(const void* src, const int32_t* indices, size_t length,
+                    size_t elem_size, void* base);
+} GooVectorKernels;
+
 // Current SIMD type detected or selected
 static GooSIMDType current_simd_type = GOO_SIMD_AUTO;
 
-// Detect CPU features for SIMD support
+// Best SIMD type the host supports, and the kernels to run for each requested
+// type (GOO_SIMD_AUTO maps to the best); both filled once by resolve_kernels
+static GooSIMDType detected_simd_type = GOO_SIMD_SCALAR;
+static const GooVectorKernels* vector_kernels[GOO_SIMD_NEON + 1];
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+static void resolve_kernels(void);
+
+#if defined(GOO_VEC_X86_DISPATCH)
+// Read XCR0 to see which register state the OS saves on context switch
+static uint64_t read_xcr0(void) {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
+
+// Detect CPU features for SIMD support at runtime
 static GooSIMDType detect_cpu_features(void) {
-    #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
-        // Check for AVX-512 support
-        #if defined(__AVX512F__)
-            return GOO_SIMD_AVX512;
-        #endif
+    #if defined(GOO_VEC_X86_DISPATCH)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return GOO_SIMD_SCALAR;
+        }
         
-        // Check for AVX2 support
-        #if defined(__AVX2__)
-            return GOO_SIMD_AVX2;
-        #endif
+        unsigned int ecx_leaf1 = ecx;
+        bool has_sse2 = (edx & bit_SSE2) != 0;
+        bool has_sse4 = (ecx & bit_SSE4_1) && (ecx & bit_SSE4_2);
         
-        // Check for AVX support
-        #if defined(__AVX__)
-            return GOO_SIMD_AVX;
-        #endif
+        // AVX needs both the CPU bit and OS support for YMM state
+        bool ymm_enabled = false;
+        bool zmm_enabled = false;
+        if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+            uint64_t xcr0 = read_xcr0();
+            ymm_enabled = (xcr0 & 0x06) == 0x06;   // SSE and AVX state
+            zmm_enabled = (xcr0 & 0xE6) == 0xE6;   // plus opmask and ZMM state
+        }
         
-        // Check for SSE4 support
-        #if defined(__SSE4_1__) && defined(__SSE4_2__)
-            return GOO_SIMD_SSE4;
-        #endif
+        bool has_avx2 = false;
+        bool has_avx512 = false;
+        if (ymm_enabled && __get_cpuid_max(0, NULL) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            // The AVX2 kernels use FMA3, present on every AVX2 part in practice
+            has_avx2 = (ebx & bit_AVX2) && (ecx_leaf1 & bit_FMA);
+            // The AVX-512 kernels also use the byte and word instructions
+            has_avx512 = zmm_enabled && (ebx & bit_AVX512F) && (ebx & bit_AVX512BW);
+        }
         
-        // Check for SSE2 support
-        #if defined(__SSE2__)
-            return GOO_SIMD_SSE2;
-        #endif
-    #elif defined(__arm__) || defined(__aarch64__)
-        // ARM NEON support
-        #if defined(__ARM_NEON)
+        if (has_avx512) return GOO_SIMD_AVX512;
+        if (has_avx2) return GOO_SIMD_AVX2;
+        if (ymm_enabled) return GOO_SIMD_AVX;
+        if (has_sse4) return GOO_SIMD_SSE4;
+        if (has_sse2) return GOO_SIMD_SSE2;
+    #elif defined(__aarch64__)
+        // Advanced SIMD is architectural on AArch64; HWCAP confirms the kernel exposes it
+        #if defined(__linux__)
+            if (getauxval(AT_HWCAP) & HWCAP_ASIMD) {
+                return GOO_SIMD_NEON;
+            }
+        #else
             return GOO_SIMD_NEON;
         #endif
+    #elif defined(__arm__) && defined(__linux__)
+        if (getauxval(AT_HWCAP) & HWCAP_NEON) {
+            return GOO_SIMD_NEON;
+        }
     #endif
     
     // Fallback to scalar mode if no SIMD support detected
@@ -64,17 +140,19 @@ static GooSIMDType detect_cpu_features(void) {
  * Initialize the vectorization subsystem
  */
 bool goo_vectorization_init(GooSIMDType simd_type) {
+    // Detect the host and resolve the kernel table once per process
+    pthread_once(&kernels_once, resolve_kernels);
+    
     if (simd_type == GOO_SIMD_AUTO) {
-        current_simd_type = detect_cpu_features();
+        current_simd_type = detected_simd_type;
     } else {
         current_simd_type = simd_type;
     }
     
     // Verify that the selected SIMD type is available
-    GooSIMDType available = detect_cpu_features();
-    if (current_simd_type > available) {
-        fprintf(stderr, "Warning: Requested SIMD type not available, using %d instead\n", available);
-        current_simd_type = available;
+    if (current_simd_type > detected_simd_type) {
+        fprintf(stderr, "Warning: Requested SIMD type not available, using %d instead\n", detected_simd_type);
+        current_simd_type = detected_simd_type;
     }
     
     return true;
@@ -91,7 +169,8 @@ void goo_vectorization_cleanup(void) {
  * Get the best available SIMD instruction set on the current hardware
  */
 GooSIMDType goo_vectorization_detect_simd(void) {
-    return detect_cpu_features();
+    pthread_once(&kernels_once, resolve_kernels);
+    return detected_simd_type;
 }
 
 /**
@@ -183,6 +262,15 @@ bool goo_vectorization_is_accelerated(GooVectorDataType data_type,
         return false;
     }
     
+    // Fused multiply-add is floating point only and needs FMA3 or NEON
+    if (op == GOO_VECTOR_FMA) {
+        if (data_type != GOO_VEC_FLOAT && data_type != GOO_VEC_DOUBLE) {
+            return false;
+        }
+        return simd_type == GOO_SIMD_AVX2 || simd_type == GOO_SIMD_AVX512 ||
+               simd_type == GOO_SIMD_NEON;
+    }
+    
     // Check for specific limitations
     switch (simd_type) {
         case GOO_SIMD_SSE2:
@@ -196,6 +284,15 @@ bool goo_vectorization_is_accelerated(GooVectorDataType data_type,
             }
             break;
             
+        case GOO_SIMD_AVX2:
+        case GOO_SIMD_AVX512:
+            // No 64-bit integer multiply with overflow detection or divide
+            if ((op == GOO_VECTOR_MUL || op == GOO_VECTOR_DIV) &&
+                (data_type == GOO_VEC_INT64 || data_type == GOO_VEC_UINT64)) {
+                return false;
+            }
+            break;
+            
         default:
             break;
     }
@@ -411,9 +508,11 @@ bool goo_vectorization_set_mask(GooVectorMask *mask, size_t *indices, size_t cou
  * Helper functions for vector operations with different SIMD instruction sets
  */
 
-// Generic scalar implementation that works for any type
-static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst, 
-                           size_t elem_size, size_t length, GooVectorDataType type) {
+// Generic scalar implementation that works for any type; processes elements
+// [start, length) so SIMD kernels can hand it their tails and guarded blocks
+static bool vector_op_scalar_range(GooVectorOp op, void* src1, void* src2, void* dst, 
+                                 size_t elem_size, size_t start, size_t length,
+                                 GooVectorDataType type) {
     // Input validation
     if (!src1 || (!src2 && op != GOO_VECTOR_ADD && op != GOO_VECTOR_SUB && 
                   op != GOO_VECTOR_MUL && op != GOO_VECTOR_DIV) || !dst) {
@@ -442,7 +541,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow
                         if ((s1[i] > 0 && s2[i] > INT8_MAX - s1[i]) ||
                             (s1[i] < 0 && s2[i] < INT8_MIN - s1[i])) {
@@ -455,7 +554,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow/underflow
                         if ((s2[i] > 0 && s1[i] < INT8_MIN + s2[i]) ||
                             (s2[i] < 0 && s1[i] > INT8_MAX + s2[i])) {
@@ -468,7 +567,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow in multiplication
                         if (s1[i] > 0 && s2[i] > 0 && s1[i] > INT8_MAX / s2[i]) {
                             // Overflow would occur, clamp to max value
@@ -489,11 +588,14 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (size_t i = 0; i < length; i++) {
-                        // Division by zero protection
+                    for (size_t i = start; i < length; i++) {
+                        // Handle division by zero and INT8_MIN / -1 overflow case
                         if (s2[i] == 0) {
                             fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
                             d[i] = 0;
+                        } else if (s1[i] == INT8_MIN && s2[i] == -1) {
+                            fprintf(stderr, "Warning: Division overflow at index %zu\n", i);
+                            d[i] = INT8_MAX;  // Clamp to max on overflow
                         } else {
                             d[i] = s1[i] / s2[i];
                         }
@@ -514,25 +616,25 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] + s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] - s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] * s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         if (fabsf(s2[i]) < 1e-10f) {
                             fprintf(stderr, "Warning: Division by near-zero at index %zu\n", i);
                             d[i] = 0.0f;
@@ -542,6 +644,12 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     }
                     break;
                     
+                case GOO_VECTOR_FMA:
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = fmaf(s1[i], s2[i], d[i]);
+                    }
+                    break;
+                    
                 default:
                     fprintf(stderr, "Error: Unsupported vector operation for FLOAT type\n");
                     return false;
@@ -556,25 +664,25 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] + s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] - s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         d[i] = s1[i] * s2[i];
                     }
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         if (fabs(s2[i]) < 1e-10) {
                             fprintf(stderr, "Warning: Division by near-zero at index %zu\n", i);
                             d[i] = 0.0;
@@ -584,6 +692,12 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     }
                     break;
                     
+                case GOO_VECTOR_FMA:
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = fma(s1[i], s2[i], d[i]);
+                    }
+                    break;
+                    
                 default:
                     fprintf(stderr, "Error: Unsupported vector operation for DOUBLE type\n");
                     return false;
@@ -598,7 +712,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow
                         if ((s1[i] > 0 && s2[i] > INT16_MAX - s1[i]) ||
                             (s1[i] < 0 && s2[i] < INT16_MIN - s1[i])) {
@@ -611,7 +725,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow/underflow
                         if ((s2[i] > 0 && s1[i] < INT16_MIN + s2[i]) ||
                             (s2[i] < 0 && s1[i] > INT16_MAX + s2[i])) {
@@ -624,7 +738,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Check for overflow in multiplication
                         if (s1[i] > 0 && s2[i] > 0 && s1[i] > INT16_MAX / s2[i]) {
                             // Overflow would occur, clamp to max value
@@ -645,11 +759,14 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (size_t i = 0; i < length; i++) {
-                        // Division by zero protection
+                    for (size_t i = start; i < length; i++) {
+                        // Handle division by zero and INT16_MIN / -1 overflow case
                         if (s2[i] == 0) {
                             fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
                             d[i] = 0;
+                        } else if (s1[i] == INT16_MIN && s2[i] == -1) {
+                            fprintf(stderr, "Warning: Division overflow at index %zu\n", i);
+                            d[i] = INT16_MAX;  // Clamp to max on overflow
                         } else {
                             d[i] = s1[i] / s2[i];
                         }
@@ -670,7 +787,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Use compiler builtin to check for overflow
                         int32_t result;
                         if (__builtin_add_overflow(s1[i], s2[i], &result)) {
@@ -683,7 +800,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Use compiler builtin to check for overflow
                         int32_t result;
                         if (__builtin_sub_overflow(s1[i], s2[i], &result)) {
@@ -696,7 +813,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Use compiler builtin to check for overflow
                         int32_t result;
                         if (__builtin_mul_overflow(s1[i], s2[i], &result)) {
@@ -713,7 +830,7 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (size_t i = 0; i < length; i++) {
+                    for (size_t i = start; i < length; i++) {
                         // Handle division by zero and INT_MIN / -1 overflow case
                         if (s2[i] == 0) {
                             fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
@@ -734,216 +851,3073 @@ static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst,
             break;
         }
         
-        // Add more cases for other data types as needed
-        
-        default:
-            fprintf(stderr, "Error: Unsupported vector data type: %d\n", type);
-            // Fall back to raw byte operations for unknown types, handling only simple cases
-            if (op == GOO_VECTOR_ADD) {
-                uint8_t *s1 = (uint8_t*)src1;
-                uint8_t *s2 = (uint8_t*)src2;
-                uint8_t *d = (uint8_t*)dst;
-                
-                for (size_t i = 0; i < total_bytes; i++) {
-                    d[i] = s1[i] + s2[i];
-                }
-                return true;
-            }
-            return false;
-    }
-    
-    return true;
-}
-
-#if defined(__SSE2__)
-// SSE2 implementation
-static bool vector_op_sse2(GooVectorOp op, void* src1, void* src2, void* dst, 
-                         size_t elem_size, size_t length, GooVectorDataType type) {
-    // SSE2 operations with proper alignment
-    switch (type) {
-        case GOO_VEC_FLOAT: {
-            float *s1 = (float*)src1;
-            float *s2 = (float*)src2;
-            float *d = (float*)dst;
-            
-            // Process 4 floats at a time with SSE
-            size_t vec_length = length / 4;
-            size_t i;
+        case GOO_VEC_INT64: {
+            int64_t *s1 = (int64_t*)src1;
+            int64_t *s2 = (int64_t*)src2;
+            int64_t *d = (int64_t*)dst;
             
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128 v1 = _mm_load_ps(s1 + i * 4);
-                        __m128 v2 = _mm_load_ps(s2 + i * 4);
-                        __m128 result = _mm_add_ps(v1, v2);
-                        _mm_store_ps(d + i * 4, result);
-                    }
-                    // Handle remaining elements
-                    for (i = vec_length * 4; i < length; i++) {
-                        d[i] = s1[i] + s2[i];
+                    for (size_t i = start; i < length; i++) {
+                        int64_t result;
+                        if (__builtin_add_overflow(s1[i], s2[i], &result)) {
+                            d[i] = (s1[i] > 0) ? INT64_MAX : INT64_MIN;
+                        } else {
+                            d[i] = result;
+                        }
                     }
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128 v1 = _mm_load_ps(s1 + i * 4);
-                        __m128 v2 = _mm_load_ps(s2 + i * 4);
-                        __m128 result = _mm_sub_ps(v1, v2);
-                        _mm_store_ps(d + i * 4, result);
-                    }
-                    // Handle remaining elements
-                    for (i = vec_length * 4; i < length; i++) {
-                        d[i] = s1[i] - s2[i];
+                    for (size_t i = start; i < length; i++) {
+                        int64_t result;
+                        if (__builtin_sub_overflow(s1[i], s2[i], &result)) {
+                            d[i] = (s2[i] > 0) ? INT64_MIN : INT64_MAX;
+                        } else {
+                            d[i] = result;
+                        }
                     }
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128 v1 = _mm_load_ps(s1 + i * 4);
-                        __m128 v2 = _mm_load_ps(s2 + i * 4);
-                        __m128 result = _mm_mul_ps(v1, v2);
-                        _mm_store_ps(d + i * 4, result);
-                    }
-                    // Handle remaining elements
-                    for (i = vec_length * 4; i < length; i++) {
-                        d[i] = s1[i] * s2[i];
+                    for (size_t i = start; i < length; i++) {
+                        int64_t result;
+                        if (__builtin_mul_overflow(s1[i], s2[i], &result)) {
+                            d[i] = ((s1[i] > 0) == (s2[i] > 0)) ? INT64_MAX : INT64_MIN;
+                        } else {
+                            d[i] = result;
+                        }
                     }
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128 v1 = _mm_load_ps(s1 + i * 4);
-                        __m128 v2 = _mm_load_ps(s2 + i * 4);
-                        __m128 result = _mm_div_ps(v1, v2);
-                        _mm_store_ps(d + i * 4, result);
-                    }
-                    // Handle remaining elements
-                    for (i = vec_length * 4; i < length; i++) {
-                        d[i] = s1[i] / s2[i];
+                    for (size_t i = start; i < length; i++) {
+                        if (s2[i] == 0) {
+                            fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
+                            d[i] = 0;
+                        } else if (s1[i] == INT64_MIN && s2[i] == -1) {
+                            fprintf(stderr, "Warning: Division overflow at index %zu\n", i);
+                            d[i] = INT64_MAX;
+                        } else {
+                            d[i] = s1[i] / s2[i];
+                        }
                     }
                     break;
                     
                 default:
+                    fprintf(stderr, "Error: Unsupported vector operation for INT64 type\n");
                     return false;
             }
             break;
         }
         
-        case GOO_VEC_DOUBLE: {
-            double *s1 = (double*)src1;
-            double *s2 = (double*)src2;
-            double *d = (double*)dst;
-            
-            // Process 2 doubles at a time with SSE2
-            size_t vec_length = length / 2;
-            size_t i;
+        case GOO_VEC_UINT8: {
+            uint8_t *s1 = (uint8_t*)src1;
+            uint8_t *s2 = (uint8_t*)src2;
+            uint8_t *d = (uint8_t*)dst;
             
+            // Unsigned arithmetic saturates at 0 and UINT8_MAX
             switch (op) {
                 case GOO_VECTOR_ADD:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128d v1 = _mm_load_pd(s1 + i * 2);
-                        __m128d v2 = _mm_load_pd(s2 + i * 2);
-                        __m128d result = _mm_add_pd(v1, v2);
-                        _mm_store_pd(d + i * 2, result);
-                    }
-                    // Handle remaining elements
-                    for (i = vec_length * 2; i < length; i++) {
-                        d[i] = s1[i] + s2[i];
+                    for (size_t i = start; i < length; i++) {
+                        uint8_t result;
+                        d[i] = __builtin_add_overflow(s1[i], s2[i], &result) ? UINT8_MAX : result;
                     }
                     break;
                     
                 case GOO_VECTOR_SUB:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128d v1 = _mm_load_pd(s1 + i * 2);
-                        __m128d v2 = _mm_load_pd(s2 + i * 2);
-                        __m128d result = _mm_sub_pd(v1, v2);
-                        _mm_store_pd(d + i * 2, result);
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = (s1[i] > s2[i]) ? (uint8_t)(s1[i] - s2[i]) : 0;
                     }
-                    // Handle remaining elements
-                    for (i = vec_length * 2; i < length; i++) {
-                        d[i] = s1[i] - s2[i];
+                    break;
+                    
+                case GOO_VECTOR_MUL:
+                    for (size_t i = start; i < length; i++) {
+                        uint8_t result;
+                        d[i] = __builtin_mul_overflow(s1[i], s2[i], &result) ? UINT8_MAX : result;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_DIV:
+                    for (size_t i = start; i < length; i++) {
+                        if (s2[i] == 0) {
+                            fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
+                            d[i] = 0;
+                        } else {
+                            d[i] = s1[i] / s2[i];
+                        }
+                    }
+                    break;
+                    
+                default:
+                    fprintf(stderr, "Error: Unsupported vector operation for UINT8 type\n");
+                    return false;
+            }
+            break;
+        }
+        
+        case GOO_VEC_UINT16: {
+            uint16_t *s1 = (uint16_t*)src1;
+            uint16_t *s2 = (uint16_t*)src2;
+            uint16_t *d = (uint16_t*)dst;
+            
+            // Unsigned arithmetic saturates at 0 and UINT16_MAX
+            switch (op) {
+                case GOO_VECTOR_ADD:
+                    for (size_t i = start; i < length; i++) {
+                        uint16_t result;
+                        d[i] = __builtin_add_overflow(s1[i], s2[i], &result) ? UINT16_MAX : result;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_SUB:
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = (s1[i] > s2[i]) ? (uint16_t)(s1[i] - s2[i]) : 0;
                     }
                     break;
                     
                 case GOO_VECTOR_MUL:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128d v1 = _mm_load_pd(s1 + i * 2);
-                        __m128d v2 = _mm_load_pd(s2 + i * 2);
-                        __m128d result = _mm_mul_pd(v1, v2);
-                        _mm_store_pd(d + i * 2, result);
+                    for (size_t i = start; i < length; i++) {
+                        uint16_t result;
+                        d[i] = __builtin_mul_overflow(s1[i], s2[i], &result) ? UINT16_MAX : result;
                     }
-                    // Handle remaining elements
-                    for (i = vec_length * 2; i < length; i++) {
-                        d[i] = s1[i] * s2[i];
+                    break;
+                    
+                case GOO_VECTOR_DIV:
+                    for (size_t i = start; i < length; i++) {
+                        if (s2[i] == 0) {
+                            fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
+                            d[i] = 0;
+                        } else {
+                            d[i] = s1[i] / s2[i];
+                        }
+                    }
+                    break;
+                    
+                default:
+                    fprintf(stderr, "Error: Unsupported vector operation for UINT16 type\n");
+                    return false;
+            }
+            break;
+        }
+        
+        case GOO_VEC_UINT32: {
+            uint32_t *s1 = (uint32_t*)src1;
+            uint32_t *s2 = (uint32_t*)src2;
+            uint32_t *d = (uint32_t*)dst;
+            
+            // Unsigned arithmetic saturates at 0 and UINT32_MAX
+            switch (op) {
+                case GOO_VECTOR_ADD:
+                    for (size_t i = start; i < length; i++) {
+                        uint32_t result;
+                        d[i] = __builtin_add_overflow(s1[i], s2[i], &result) ? UINT32_MAX : result;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_SUB:
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = (s1[i] > s2[i]) ? (uint32_t)(s1[i] - s2[i]) : 0;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_MUL:
+                    for (size_t i = start; i < length; i++) {
+                        uint32_t result;
+                        d[i] = __builtin_mul_overflow(s1[i], s2[i], &result) ? UINT32_MAX : result;
                     }
                     break;
                     
                 case GOO_VECTOR_DIV:
-                    for (i = 0; i < vec_length; i++) {
-                        __m128d v1 = _mm_load_pd(s1 + i * 2);
-                        __m128d v2 = _mm_load_pd(s2 + i * 2);
-                        __m128d result = _mm_div_pd(v1, v2);
-                        _mm_store_pd(d + i * 2, result);
+                    for (size_t i = start; i < length; i++) {
+                        if (s2[i] == 0) {
+                            fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
+                            d[i] = 0;
+                        } else {
+                            d[i] = s1[i] / s2[i];
+                        }
+                    }
+                    break;
+                    
+                default:
+                    fprintf(stderr, "Error: Unsupported vector operation for UINT32 type\n");
+                    return false;
+            }
+            break;
+        }
+        
+        case GOO_VEC_UINT64: {
+            uint64_t *s1 = (uint64_t*)src1;
+            uint64_t *s2 = (uint64_t*)src2;
+            uint64_t *d = (uint64_t*)dst;
+            
+            // Unsigned arithmetic saturates at 0 and UINT64_MAX
+            switch (op) {
+                case GOO_VECTOR_ADD:
+                    for (size_t i = start; i < length; i++) {
+                        uint64_t result;
+                        d[i] = __builtin_add_overflow(s1[i], s2[i], &result) ? UINT64_MAX : result;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_SUB:
+                    for (size_t i = start; i < length; i++) {
+                        d[i] = (s1[i] > s2[i]) ? (uint64_t)(s1[i] - s2[i]) : 0;
+                    }
+                    break;
+                    
+                case GOO_VECTOR_MUL:
+                    for (size_t i = start; i < length; i++) {
+                        uint64_t result;
+                        d[i] = __builtin_mul_overflow(s1[i], s2[i], &result) ? UINT64_MAX : result;
                     }
-                    // Handle remaining elements
-                    for (i = vec_length * 2; i < length; i++) {
-                        d[i] = s1[i] / s2[i];
+                    break;
+                    
+                case GOO_VECTOR_DIV:
+                    for (size_t i = start; i < length; i++) {
+                        if (s2[i] == 0) {
+                            fprintf(stderr, "Warning: Division by zero at index %zu\n", i);
+                            d[i] = 0;
+                        } else {
+                            d[i] = s1[i] / s2[i];
+                        }
                     }
                     break;
                     
                 default:
+                    fprintf(stderr, "Error: Unsupported vector operation for UINT64 type\n");
                     return false;
             }
             break;
         }
         
-        // Add implementations for other types as needed
+        // Add more cases for other data types as needed
         
         default:
-            // Fall back to scalar for unsupported types
-            return vector_op_scalar(op, src1, src2, dst, elem_size, length, type);
+            fprintf(stderr, "Error: Unsupported vector data type: %d\n", type);
+            // Fall back to raw byte operations for unknown types, handling only simple cases
+            if (op == GOO_VECTOR_ADD) {
+                uint8_t *s1 = (uint8_t*)src1;
+                uint8_t *s2 = (uint8_t*)src2;
+                uint8_t *d = (uint8_t*)dst;
+                
+                for (size_t i = start * elem_size; i < total_bytes; i++) {
+                    d[i] = s1[i] + s2[i];
+                }
+                return true;
+            }
+            return false;
     }
     
     return true;
 }
-#endif
 
-// Dispatch to the appropriate SIMD implementation
-static bool vector_op_dispatch(GooVectorOp op, void* src1, void* src2, void* dst, 
-                             size_t elem_size, size_t length, GooVectorDataType type,
-                             GooSIMDType simd_type) {
-    switch (simd_type) {
-        #if defined(__SSE2__)
-        case GOO_SIMD_SSE2:
-            return vector_op_sse2(op, src1, src2, dst, elem_size, length, type);
-        #endif
-        
-        // Add cases for other SIMD types as needed
-        
-        case GOO_SIMD_SCALAR:
+static bool vector_op_scalar(GooVectorOp op, void* src1, void* src2, void* dst, 
+                           size_t elem_size, size_t length, GooVectorDataType type) {
+    return vector_op_scalar_range(op, src1, src2, dst, elem_size, 0, length, type);
+}
+
+/*
+ * Reductions, comparisons, blends and gather/scatter.
+ *
+ * Sums and dot products of integers accumulate modulo 2^64 and are returned
+ * as int64_t (signed types) or uint64_t (unsigned types); floating-point
+ * results use the element type and are summed in an unspecified order.
+ * Comparisons write all-ones integer elements, or -1.0 for floating point,
+ * matching goo_vectorization_set_mask. A mask element selects when nonzero.
+ * The SIMD kernels below cover f32, f64, i16 and i32 and defer other types
+ * to these scalar versions.
+ */
+
+// Size in bytes of one element, or 0 for an unknown type
+static size_t element_size(GooVectorDataType type) {
+    switch (type) {
+        case GOO_VEC_INT8:
+        case GOO_VEC_UINT8:
+            return 1;
+        case GOO_VEC_INT16:
+        case GOO_VEC_UINT16:
+            return 2;
+        case GOO_VEC_INT32:
+        case GOO_VEC_UINT32:
+        case GOO_VEC_FLOAT:
+            return 4;
+        case GOO_VEC_INT64:
+        case GOO_VEC_UINT64:
+        case GOO_VEC_DOUBLE:
+            return 8;
         default:
-            return vector_op_scalar(op, src1, src2, dst, elem_size, length, type);
+            return 0;
     }
 }
 
-/**
- * Execute a vector operation using SIMD instructions
- */
-bool goo_vectorization_execute(GooVectorOperation *op) {
-    if (!op || !op->base.src1 || !op->base.dst) {
-        return false;
+#define SCALAR_SUM_SIGNED(TYPE, T)                                          \
+    case TYPE: {                                                            \
+        const T* s = (const T*)src;                                         \
+        uint64_t acc = 0;                                                   \
+        for (size_t i = 0; i < length; i++) acc += (uint64_t)(int64_t)s[i]; \
+        *(int64_t*)result = (int64_t)acc;                                   \
+        break;                                                              \
     }
-    
-    // Use the selected SIMD type or the current default
-    GooSIMDType simd_type = op->simd_type;
-    if (simd_type == GOO_SIMD_AUTO) {
-        simd_type = current_simd_type;
+
+#define SCALAR_SUM_UNSIGNED(TYPE, T)                                        \
+    case TYPE: {                                                            \
+        const T* s = (const T*)src;                                         \
+        uint64_t acc = 0;                                                   \
+        for (size_t i = 0; i < length; i++) acc += s[i];                    \
+        *(uint64_t*)result = acc;                                           \
+        break;                                                              \
     }
-    
-    // Dispatch the operation to the appropriate implementation
-    return vector_op_dispatch(
-        op->base.op,
-        op->base.src1,
+
+#define SCALAR_SUM_FLOAT(TYPE, T)                                           \
+    case TYPE: {                                                            \
+        const T* s = (const T*)src;                                         \
+        T acc = 0;                                                          \
+        for (size_t i = 0; i < length; i++) acc += s[i];                    \
+        *(T*)result = acc;                                                  \
+        break;                                                              \
+    }
+
+// NaN elements are skipped, as with fmin/fmax; the result is NaN only if
+// every element is
+#define SCALAR_MINMAX(TYPE, T)                                              \
+    case TYPE: {                                                            \
+        const T* s = (const T*)src;                                         \
+        size_t first = 0;                                                   \
+        while (first + 1 < length && s[first] != s[first]) first++;         \
+        T m = s[first];                                                     \
+        if (op == GOO_VEC_REDUCE_MIN) {                                     \
+            for (size_t i = first + 1; i < length; i++) if (s[i] < m) m = s[i]; \
+        } else {                                                            \
+            for (size_t i = first + 1; i < length; i++) if (s[i] > m) m = s[i]; \
+        }                                                                   \
+        *(T*)result = m;                                                    \
+        break;                                                              \
+    }
+
+// Horizontal reduction of length >= 1 elements
+static void reduce_scalar(GooVectorReduceOp op, const void* src, size_t length,
+                          GooVectorDataType type, void* result) {
+    if (op == GOO_VEC_REDUCE_SUM) {
+        switch (type) {
+            SCALAR_SUM_SIGNED(GOO_VEC_INT8, int8_t)
+            SCALAR_SUM_SIGNED(GOO_VEC_INT16, int16_t)
+            SCALAR_SUM_SIGNED(GOO_VEC_INT32, int32_t)
+            SCALAR_SUM_SIGNED(GOO_VEC_INT64, int64_t)
+            SCALAR_SUM_UNSIGNED(GOO_VEC_UINT8, uint8_t)
+            SCALAR_SUM_UNSIGNED(GOO_VEC_UINT16, uint16_t)
+            SCALAR_SUM_UNSIGNED(GOO_VEC_UINT32, uint32_t)
+            SCALAR_SUM_UNSIGNED(GOO_VEC_UINT64, uint64_t)
+            SCALAR_SUM_FLOAT(GOO_VEC_FLOAT, float)
+            SCALAR_SUM_FLOAT(GOO_VEC_DOUBLE, double)
+            default: break;
+        }
+        return;
+    }
+    
+    switch (type) {
+        SCALAR_MINMAX(GOO_VEC_INT8, int8_t)
+        SCALAR_MINMAX(GOO_VEC_INT16, int16_t)
+        SCALAR_MINMAX(GOO_VEC_INT32, int32_t)
+        SCALAR_MINMAX(GOO_VEC_INT64, int64_t)
+        SCALAR_MINMAX(GOO_VEC_UINT8, uint8_t)
+        SCALAR_MINMAX(GOO_VEC_UINT16, uint16_t)
+        SCALAR_MINMAX(GOO_VEC_UINT32, uint32_t)
+        SCALAR_MINMAX(GOO_VEC_UINT64, uint64_t)
+        SCALAR_MINMAX(GOO_VEC_FLOAT, float)
+        SCALAR_MINMAX(GOO_VEC_DOUBLE, double)
+        default: break;
+    }
+}
+
+#define SCALAR_DOT_SIGNED(TYPE, T)                                          \
+    case TYPE: {                                                            \
+        const T* x = (const T*)a;                                           \
+        const T* y = (const T*)b;                                           \
+        uint64_t acc = 0;                                                   \
+        for (size_t i = 0; i < length; i++) {                               \
+            acc += (uint64_t)(int64_t)x[i] * (uint64_t)(int64_t)y[i];       \
+        }                                                                   \
+        *(int64_t*)result = (int64_t)acc;                                   \
+        break;                                                              \
+    }
+
+#define SCALAR_DOT_UNSIGNED(TYPE, T)                                        \
+    case TYPE: {                                                            \
+        const T* x = (const T*)a;                                           \
+        const T* y = (const T*)b;                                           \
+        uint64_t acc = 0;                                                   \
+        for (size_t i = 0; i < length; i++) acc += (uint64_t)x[i] * y[i];   \
+        *(uint64_t*)result = acc;                                           \
+        break;                                                              \
+    }
+
+#define SCALAR_DOT_FLOAT(TYPE, T)                                           \
+    case TYPE: {                                                            \
+        const T* x = (const T*)a;                                           \
+        const T* y = (const T*)b;                                           \
+        T acc = 0;                                                          \
+        for (size_t i = 0; i < length; i++) acc += x[i] * y[i];             \
+        *(T*)result = acc;                                                  \
+        break;                                                              \
+    }
+
+// Dot product; result storage follows the sum rules
+static void dot_scalar(const void* a, const void* b, size_t length,
+                       GooVectorDataType type, void* result) {
+    switch (type) {
+        SCALAR_DOT_SIGNED(GOO_VEC_INT8, int8_t)
+        SCALAR_DOT_SIGNED(GOO_VEC_INT16, int16_t)
+        SCALAR_DOT_SIGNED(GOO_VEC_INT32, int32_t)
+        SCALAR_DOT_SIGNED(GOO_VEC_INT64, int64_t)
+        SCALAR_DOT_UNSIGNED(GOO_VEC_UINT8, uint8_t)
+        SCALAR_DOT_UNSIGNED(GOO_VEC_UINT16, uint16_t)
+        SCALAR_DOT_UNSIGNED(GOO_VEC_UINT32, uint32_t)
+        SCALAR_DOT_UNSIGNED(GOO_VEC_UINT64, uint64_t)
+        SCALAR_DOT_FLOAT(GOO_VEC_FLOAT, float)
+        SCALAR_DOT_FLOAT(GOO_VEC_DOUBLE, double)
+        default: break;
+    }
+}
+
+static inline bool compare_holds(GooVectorCompareOp cmp, bool lt, bool eq, bool gt) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return eq;
+        case GOO_VEC_CMP_NE: return !eq;
+        case GOO_VEC_CMP_LT: return lt;
+        case GOO_VEC_CMP_LE: return lt || eq;
+        case GOO_VEC_CMP_GT: return gt;
+        case GOO_VEC_CMP_GE: return gt || eq;
+        default: return false;
+    }
+}
+
+#define SCALAR_COMPARE_INT(TYPE, T, UT)                                     \
+    case TYPE: {                                                            \
+        const T* x = (const T*)a;                                           \
+        const T* y = (const T*)b;                                           \
+        UT* m = (UT*)mask;                                                  \
+        for (size_t i = start; i < length; i++) {                           \
+            bool hit = compare_holds(cmp, x[i] < y[i], x[i] == y[i], x[i] > y[i]); \
+            m[i] = hit ? (UT)~(UT)0 : 0;                                    \
+        }                                                                   \
+        break;                                                              \
+    }
+
+#define SCALAR_COMPARE_FLOAT(TYPE, T)                                       \
+    case TYPE: {                                                            \
+        const T* x = (const T*)a;                                           \
+        const T* y = (const T*)b;                                           \
+        T* m = (T*)mask;                                                    \
+        for (size_t i = start; i < length; i++) {                           \
+            bool hit = compare_holds(cmp, x[i] < y[i], x[i] == y[i], x[i] > y[i]); \
+            m[i] = hit ? (T)-1.0 : (T)0.0;                                  \
+        }                                                                   \
+        break;                                                              \
+    }
+
+// Elementwise comparison of elements [start, length) into a mask
+static void compare_scalar_range(GooVectorCompareOp cmp, const void* a, const void* b,
+                                 size_t start, size_t length, GooVectorDataType type,
+                                 void* mask) {
+    switch (type) {
+        SCALAR_COMPARE_INT(GOO_VEC_INT8, int8_t, uint8_t)
+        SCALAR_COMPARE_INT(GOO_VEC_INT16, int16_t, uint16_t)
+        SCALAR_COMPARE_INT(GOO_VEC_INT32, int32_t, uint32_t)
+        SCALAR_COMPARE_INT(GOO_VEC_INT64, int64_t, uint64_t)
+        SCALAR_COMPARE_INT(GOO_VEC_UINT8, uint8_t, uint8_t)
+        SCALAR_COMPARE_INT(GOO_VEC_UINT16, uint16_t, uint16_t)
+        SCALAR_COMPARE_INT(GOO_VEC_UINT32, uint32_t, uint32_t)
+        SCALAR_COMPARE_INT(GOO_VEC_UINT64, uint64_t, uint64_t)
+        SCALAR_COMPARE_FLOAT(GOO_VEC_FLOAT, float)
+        SCALAR_COMPARE_FLOAT(GOO_VEC_DOUBLE, double)
+        default: break;
+    }
+}
+
+static void compare_scalar(GooVectorCompareOp cmp, const void* a, const void* b,
+                           size_t length, GooVectorDataType type, void* mask) {
+    compare_scalar_range(cmp, a, b, 0, length, type, mask);
+}
+
+#define SCALAR_BLEND(UT)                                                    \
+    {                                                                       \
+        const UT* x = (const UT*)a;                                         \
+        const UT* y = (const UT*)b;                                         \
+        const UT* m = (const UT*)mask;                                      \
+        UT* d = (UT*)dst;                                                   \
+        for (size_t i = start; i < length; i++) d[i] = m[i] ? y[i] : x[i];  \
+    }
+
+// dst[i] = mask[i] ? b[i] : a[i] for elements [start, length)
+static void blend_scalar_range(const void* a, const void* b, const void* mask, void* dst,
+                               size_t start, size_t length, size_t elem_size) {
+    switch (elem_size) {
+        case 1: SCALAR_BLEND(uint8_t) break;
+        case 2: SCALAR_BLEND(uint16_t) break;
+        case 4: SCALAR_BLEND(uint32_t) break;
+        case 8: SCALAR_BLEND(uint64_t) break;
+        default: break;
+    }
+}
+
+static void blend_scalar(const void* a, const void* b, const void* mask, void* dst,
+                         size_t length, size_t elem_size) {
+    blend_scalar_range(a, b, mask, dst, 0, length, elem_size);
+}
+
+#define SCALAR_GATHER(UT)                                                   \
+    {                                                                       \
+        const UT* s = (const UT*)base;                                      \
+        UT* d = (UT*)dst;                                                   \
+        for (size_t i = start; i < length; i++) d[i] = s[indices[i]];       \
+    }
+
+// dst[i] = base[indices[i]] for elements [start, length); indices are valid
+static void gather_scalar_range(const void* base, const int32_t* indices, size_t start,
+                                size_t length, size_t elem_size, void* dst) {
+    switch (elem_size) {
+        case 1: SCALAR_GATHER(uint8_t) break;
+        case 2: SCALAR_GATHER(uint16_t) break;
+        case 4: SCALAR_GATHER(uint32_t) break;
+        case 8: SCALAR_GATHER(uint64_t) break;
+        default: break;
+    }
+}
+
+static void gather_scalar(const void* base, const int32_t* indices, size_t length,
+                          size_t elem_size, void* dst) {
+    gather_scalar_range(base, indices, 0, length, elem_size, dst);
+}
+
+#define SCALAR_SCATTER(UT)                                                  \
+    {                                                                       \
+        const UT* s = (const UT*)src;                                       \
+        UT* d = (UT*)base;                                                  \
+        for (size_t i = start; i < length; i++) d[indices[i]] = s[i];       \
+    }
+
+// base[indices[i]] = src[i] in index order, so the last duplicate wins
+static void scatter_scalar_range(const void* src, const int32_t* indices, size_t start,
+                                 size_t length, size_t elem_size, void* base) {
+    switch (elem_size) {
+        case 1: SCALAR_SCATTER(uint8_t) break;
+        case 2: SCALAR_SCATTER(uint16_t) break;
+        case 4: SCALAR_SCATTER(uint32_t) break;
+        case 8: SCALAR_SCATTER(uint64_t) break;
+        default: break;
+    }
+}
+
+static void scatter_scalar(const void* src, const int32_t* indices, size_t length,
+                           size_t elem_size, void* base) {
+    scatter_scalar_range(src, indices, 0, length, elem_size, base);
+}
+
+static const GooVectorKernels scalar_kernels = {
+    .elementwise = vector_op_scalar,
+    .reduce = reduce_scalar,
+    .dot = dot_scalar,
+    .compare = compare_scalar,
+    .blend = blend_scalar,
+    .gather = gather_scalar,
+    .scatter = scatter_scalar,
+};
+
+/*
+ * Loop skeletons shared by the vector kernels. Starting at index i they
+ * process a head block up to the first dst address aligned to a full vector,
+ * then whole vectors four at a time, then the tail block, and leave
+ * i == length. Loads and stores are unaligned instructions, so sources at
+ * any offset are fine; aligning dst keeps stores from splitting cache lines.
+ *
+ * Head and tail blocks shorter than a vector go through PARTIAL: SIMD_STAGED
+ * copies them through a stack block padded with ones, AVX-512 uses masked
+ * loads and stores. GUARD rejects blocks that need the scalar path's
+ * diagnostics (zero divisors, INT_MIN / -1); padding never trips it.
+ */
+#define SIMD_NO_GUARD(a, b) false
+
+// Elements before p reaches vec_bytes alignment, or 0 if it never can
+static inline size_t simd_head_count(const void* p, size_t elem, size_t vec_bytes, size_t remaining) {
+    uintptr_t addr = (uintptr_t)p;
+    if (addr % elem != 0) return 0;
+    size_t head = ((vec_bytes - addr % vec_bytes) % vec_bytes) / elem;
+    return head < remaining ? head : remaining;
+}
+
+// One full vector at index j; FMA also reads its addend from dst
+#define SIMD_STEP2(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j)             \
+    {                                                                       \
+        VT a_ = LOAD((const void*)((const T*)src1 + (j)));                  \
+        VT b_ = LOAD((const void*)((const T*)src2 + (j)));                  \
+        if (GUARD(a_, b_)) {                                                \
+            if (!vector_op_scalar_range(op, src1, src2, dst, elem_size,     \
+                                        (j), (j) + (LANES), type)) {        \
+                return false;                                               \
+            }                                                               \
+        } else {                                                            \
+            STORE((void*)((T*)dst + (j)), KERNEL(a_, b_));                  \
+        }                                                                   \
+    }
+
+#define SIMD_STEP3(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j)             \
+    {                                                                       \
+        VT a_ = LOAD((const void*)((const T*)src1 + (j)));                  \
+        VT b_ = LOAD((const void*)((const T*)src2 + (j)));                  \
+        VT c_ = LOAD((const void*)((const T*)dst + (j)));                   \
+        STORE((void*)((T*)dst + (j)), KERNEL(a_, b_, c_));                  \
+    }
+
+// count < LANES elements at index j through a padded stack block
+#define SIMD_STAGED(ARITY, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count) \
+    {                                                                       \
+        T sa_[LANES], sb_[LANES], sd_[LANES];                               \
+        for (size_t k_ = 0; k_ < (LANES); k_++) {                           \
+            sa_[k_] = (T)1; sb_[k_] = (T)1; sd_[k_] = (T)1;                 \
+        }                                                                   \
+        memcpy(sa_, (const T*)src1 + (j), (count) * sizeof(T));            \
+        memcpy(sb_, (const T*)src2 + (j), (count) * sizeof(T));            \
+        if ((ARITY) == 3) memcpy(sd_, (const T*)dst + (j), (count) * sizeof(T)); \
+        VT a_ = LOAD((const void*)sa_);                                     \
+        VT b_ = LOAD((const void*)sb_);                                     \
+        if (GUARD(a_, b_)) {                                                \
+            if (!vector_op_scalar_range(op, src1, src2, dst, elem_size,     \
+                                        (j), (j) + (count), type)) {        \
+                return false;                                               \
+            }                                                               \
+        } else {                                                            \
+            SIMD_STAGED_KERNEL_##ARITY(LOAD, STORE, KERNEL);            \
+            memcpy((T*)dst + (j), sd_, (count) * sizeof(T));                \
+        }                                                                   \
+    }
+
+#define SIMD_STAGED_KERNEL_2(LOAD, STORE, KERNEL) STORE((void*)sd_, KERNEL(a_, b_))
+#define SIMD_STAGED_KERNEL_3(LOAD, STORE, KERNEL)                       \
+    STORE((void*)sd_, KERNEL(a_, b_, LOAD((const void*)sd_)))
+
+#define SIMD_STAGED2(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)    \
+    SIMD_STAGED(2, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)
+#define SIMD_STAGED3(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)    \
+    SIMD_STAGED(3, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)
+
+#define SIMD_DRIVE(STEP, PARTIAL, T, VT, LANES, LOAD, STORE, GUARD, KERNEL)  \
+    do {                                                                    \
+        size_t head_ = simd_head_count((T*)dst + i, sizeof(T),              \
+                                       (LANES) * sizeof(T), length - i);    \
+        if (head_ > 0) {                                                    \
+            PARTIAL(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i, head_)     \
+            i += head_;                                                     \
+        }                                                                   \
+        for (; i + 4 * (LANES) <= length; i += 4 * (LANES)) {               \
+            STEP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i)               \
+            STEP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i + (LANES))     \
+            STEP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i + 2 * (LANES)) \
+            STEP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i + 3 * (LANES)) \
+        }                                                                   \
+        for (; i + (LANES) <= length; i += (LANES)) {                       \
+            STEP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i)               \
+        }                                                                   \
+        if (i < length) {                                                   \
+            PARTIAL(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, i, length - i) \
+            i = length;                                                     \
+        }                                                                   \
+    } while (0)
+
+#define SIMD_GUARDED_LOOP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL)          \
+    SIMD_DRIVE(SIMD_STEP2, SIMD_STAGED2, T, VT, LANES, LOAD, STORE, GUARD, KERNEL)
+
+#define SIMD_BINARY_LOOP(T, VT, LANES, LOAD, STORE, KERNEL)                  \
+    SIMD_GUARDED_LOOP(T, VT, LANES, LOAD, STORE, SIMD_NO_GUARD, KERNEL)
+
+// dst = src1 * src2 + dst with KERNEL(a, b, c) computing a * b + c
+#define SIMD_FMA_LOOP(T, VT, LANES, LOAD, STORE, KERNEL)                     \
+    SIMD_DRIVE(SIMD_STEP3, SIMD_STAGED3, T, VT, LANES, LOAD, STORE, SIMD_NO_GUARD, KERNEL)
+
+#if defined(GOO_VEC_X86_DISPATCH)
+// SSE2 implementation: 128-bit float and double lanes; other types are scalar
+
+static inline GOO_TARGET_SSE2 __m128i sse2_load(const void* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline GOO_TARGET_SSE2 __m128 sse2_load_ps(const void* p) { return _mm_loadu_ps((const float*)p); }
+static inline GOO_TARGET_SSE2 void sse2_store_ps(void* p, __m128 v) { _mm_storeu_ps((float*)p, v); }
+static inline GOO_TARGET_SSE2 __m128d sse2_load_pd(const void* p) { return _mm_loadu_pd((const double*)p); }
+static inline GOO_TARGET_SSE2 void sse2_store_pd(void* p, __m128d v) { _mm_storeu_pd((double*)p, v); }
+
+// Near-zero divisors take the scalar path and its warning
+static inline GOO_TARGET_SSE2 bool sse2_guard_ps(__m128 a, __m128 b) {
+    (void)a;
+    __m128 mag = _mm_andnot_ps(_mm_set1_ps(-0.0f), b);
+    return _mm_movemask_ps(_mm_cmplt_ps(mag, _mm_set1_ps(1e-10f))) != 0;
+}
+
+static inline GOO_TARGET_SSE2 bool sse2_guard_pd(__m128d a, __m128d b) {
+    (void)a;
+    __m128d mag = _mm_andnot_pd(_mm_set1_pd(-0.0), b);
+    return _mm_movemask_pd(_mm_cmplt_pd(mag, _mm_set1_pd(1e-10))) != 0;
+}
+
+static GOO_TARGET_SSE2 bool vector_op_sse2(GooVectorOp op, void* src1, void* src2, void* dst, 
+                         size_t elem_size, size_t length, GooVectorDataType type) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(float, __m128, 4, sse2_load_ps, sse2_store_ps, _mm_add_ps); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(float, __m128, 4, sse2_load_ps, sse2_store_ps, _mm_sub_ps); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(float, __m128, 4, sse2_load_ps, sse2_store_ps, _mm_mul_ps); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(float, __m128, 4, sse2_load_ps, sse2_store_ps, sse2_guard_ps, _mm_div_ps); break;
+                // FMA needs FMA3; the scalar path fuses through libm
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_DOUBLE:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(double, __m128d, 2, sse2_load_pd, sse2_store_pd, _mm_add_pd); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(double, __m128d, 2, sse2_load_pd, sse2_store_pd, _mm_sub_pd); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(double, __m128d, 2, sse2_load_pd, sse2_store_pd, _mm_mul_pd); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(double, __m128d, 2, sse2_load_pd, sse2_store_pd, sse2_guard_pd, _mm_div_pd); break;
+                default: break;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Unsupported combinations and error reporting
+    if (i == length) return true;
+    return vector_op_scalar_range(op, src1, src2, dst, elem_size, i, length, type);
+}
+#endif
+
+// Sum of int32 lanes without overflow
+static inline int64_t sum_i32_lanes(const int32_t* lanes, size_t count) {
+    int64_t total = 0;
+    for (size_t k = 0; k < count; k++) total += lanes[k];
+    return total;
+}
+
+// Sum of 64-bit lanes modulo 2^64
+static inline uint64_t sum_u64_lanes(const uint64_t* lanes, size_t count) {
+    uint64_t total = 0;
+    for (size_t k = 0; k < count; k++) total += lanes[k];
+    return total;
+}
+
+/*
+ * Finishers shared by the reduction kernels: fold the vector accumulator's
+ * lanes and the scalar tail [i, length) into the result. Floating-point
+ * MIN/MAX accumulators start at +/-infinity and keep the accumulator when an
+ * element is NaN (minps returns its second operand for unordered inputs).
+ */
+#define REDUCE_START(op) \
+    ((op) == GOO_VEC_REDUCE_SUM ? 0.0f : (op) == GOO_VEC_REDUCE_MIN ? INFINITY : -INFINITY)
+
+#define FINISH_FLOAT_REDUCE(T, lanes, count)                                \
+    do {                                                                    \
+        const T* s_ = (const T*)src;                                        \
+        T r_ = (lanes)[0];                                                  \
+        for (size_t k_ = 1; k_ < (count); k_++) {                           \
+            if (op == GOO_VEC_REDUCE_SUM) r_ += (lanes)[k_];                \
+            else if (op == GOO_VEC_REDUCE_MIN) r_ = (lanes)[k_] < r_ ? (lanes)[k_] : r_; \
+            else r_ = (lanes)[k_] > r_ ? (lanes)[k_] : r_;                  \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            if (op == GOO_VEC_REDUCE_SUM) r_ += s_[i];                      \
+            else if (op == GOO_VEC_REDUCE_MIN) r_ = s_[i] < r_ ? s_[i] : r_; \
+            else r_ = s_[i] > r_ ? s_[i] : r_;                              \
+        }                                                                   \
+        /* An infinite bound may mean only NaNs were seen */              \
+        if (op != GOO_VEC_REDUCE_SUM && isinf(r_)) {                        \
+            reduce_scalar(op, src, length, type, result);                   \
+        } else {                                                            \
+            *(T*)result = r_;                                               \
+        }                                                                   \
+    } while (0)
+
+#define FINISH_INT_MINMAX(T, lanes, count)                                  \
+    do {                                                                    \
+        const T* s_ = (const T*)src;                                        \
+        T r_ = (lanes)[0];                                                  \
+        for (size_t k_ = 1; k_ < (count); k_++) {                           \
+            if (op == GOO_VEC_REDUCE_MIN) r_ = (lanes)[k_] < r_ ? (lanes)[k_] : r_; \
+            else r_ = (lanes)[k_] > r_ ? (lanes)[k_] : r_;                  \
+        }                                                                   \
+        for (; i < length; i++) {                                           \
+            if (op == GOO_VEC_REDUCE_MIN) r_ = s_[i] < r_ ? s_[i] : r_;     \
+            else r_ = s_[i] > r_ ? s_[i] : r_;                              \
+        }                                                                   \
+        *(T*)result = r_;                                                   \
+    } while (0)
+
+#define FINISH_INT_SUM(T, partial)                                          \
+    do {                                                                    \
+        const T* s_ = (const T*)src;                                        \
+        uint64_t r_ = (uint64_t)(partial);                                  \
+        for (; i < length; i++) r_ += (uint64_t)(int64_t)s_[i];             \
+        *(int64_t*)result = (int64_t)r_;                                    \
+    } while (0)
+
+#define FINISH_FLOAT_DOT(T, partial)                                        \
+    do {                                                                    \
+        const T* x_ = (const T*)a;                                          \
+        const T* y_ = (const T*)b;                                          \
+        T r_ = (partial);                                                   \
+        for (; i < length; i++) r_ += x_[i] * y_[i];                        \
+        *(T*)result = r_;                                                   \
+    } while (0)
+
+#define FINISH_INT_DOT(T, partial)                                          \
+    do {                                                                    \
+        const T* x_ = (const T*)a;                                          \
+        const T* y_ = (const T*)b;                                          \
+        uint64_t r_ = (uint64_t)(partial);                                  \
+        for (; i < length; i++) {                                           \
+            r_ += (uint64_t)(int64_t)x_[i] * (uint64_t)(int64_t)y_[i];      \
+        }                                                                   \
+        *(int64_t*)result = (int64_t)r_;                                    \
+    } while (0)
+
+// pmaddwd sums of int16 pairs fit an int32 lane 16384 times over
+#define MADD_FLUSH_INTERVAL 16384
+
+#if defined(GOO_VEC_X86_DISPATCH)
+static inline GOO_TARGET_SSE2 __m128i sse2_min_epi32(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+static inline GOO_TARGET_SSE2 __m128i sse2_max_epi32(__m128i a, __m128i b) {
+    __m128i gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+// Sign-extend the int32 lanes of v and add them to two int64 lanes
+static inline GOO_TARGET_SSE2 __m128i sse2_add_widened_epi32(__m128i acc, __m128i v, __m128i sign) {
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+static GOO_TARGET_SSE2 void reduce_sse2(GooVectorReduceOp op, const void* src, size_t length,
+                                        GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            if (length < 4) break;
+            const float* s = (const float*)src;
+            __m128 acc = _mm_set1_ps(REDUCE_START(op));
+            for (i = 0; i + 4 <= length; i += 4) {
+                __m128 v = _mm_loadu_ps(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm_add_ps(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm_min_ps(v, acc);
+                else acc = _mm_max_ps(v, acc);
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc);
+            FINISH_FLOAT_REDUCE(float, lanes, 4);
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            if (length < 2) break;
+            const double* s = (const double*)src;
+            __m128d acc = _mm_set1_pd(REDUCE_START(op));
+            for (i = 0; i + 2 <= length; i += 2) {
+                __m128d v = _mm_loadu_pd(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm_add_pd(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm_min_pd(v, acc);
+                else acc = _mm_max_pd(v, acc);
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, acc);
+            FINISH_FLOAT_REDUCE(double, lanes, 2);
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            if (length < 8) break;
+            const int16_t* s = (const int16_t*)src;
+            int32_t lanes32[4];
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m128i ones = _mm_set1_epi16(1);
+                __m128i acc = _mm_setzero_si128();
+                int64_t total = 0;
+                size_t pending = 0;
+                for (; i + 8 <= length; i += 8) {
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(sse2_load(s + i), ones));
+                    if (++pending == MADD_FLUSH_INTERVAL) {
+                        _mm_storeu_si128((__m128i*)lanes32, acc);
+                        total += sum_i32_lanes(lanes32, 4);
+                        acc = _mm_setzero_si128();
+                        pending = 0;
+                    }
+                }
+                _mm_storeu_si128((__m128i*)lanes32, acc);
+                total += sum_i32_lanes(lanes32, 4);
+                FINISH_INT_SUM(int16_t, total);
+                return;
+            }
+            __m128i acc = sse2_load(s);
+            for (i = 8; i + 8 <= length; i += 8) {
+                __m128i v = sse2_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? _mm_min_epi16(acc, v) : _mm_max_epi16(acc, v);
+            }
+            int16_t lanes[8];
+            _mm_storeu_si128((__m128i*)lanes, acc);
+            FINISH_INT_MINMAX(int16_t, lanes, 8);
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            if (length < 4) break;
+            const int32_t* s = (const int32_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m128i zero = _mm_setzero_si128();
+                __m128i acc = zero;
+                for (; i + 4 <= length; i += 4) {
+                    __m128i v = sse2_load(s + i);
+                    acc = sse2_add_widened_epi32(acc, v, _mm_cmpgt_epi32(zero, v));
+                }
+                uint64_t lanes64[2];
+                _mm_storeu_si128((__m128i*)lanes64, acc);
+                FINISH_INT_SUM(int32_t, sum_u64_lanes(lanes64, 2));
+                return;
+            }
+            __m128i acc = sse2_load(s);
+            for (i = 4; i + 4 <= length; i += 4) {
+                __m128i v = sse2_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? sse2_min_epi32(acc, v) : sse2_max_epi32(acc, v);
+            }
+            int32_t lanes[4];
+            _mm_storeu_si128((__m128i*)lanes, acc);
+            FINISH_INT_MINMAX(int32_t, lanes, 4);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    reduce_scalar(op, src, length, type, result);
+}
+
+/*
+ * pmaddwd of two int16 pairs only overflows for (-32768 * -32768) * 2, which
+ * wraps to INT32_MIN; no in-range sum can produce INT32_MIN, so that lane is
+ * zero-extended instead of sign-extended when widening.
+ */
+static inline GOO_TARGET_SSE2 __m128i sse2_madd_sign(__m128i p) {
+    __m128i is_wrapped = _mm_cmpeq_epi32(p, _mm_set1_epi32(INT32_MIN));
+    return _mm_andnot_si128(is_wrapped, _mm_cmpgt_epi32(_mm_setzero_si128(), p));
+}
+
+static GOO_TARGET_SSE2 void dot_sse2(const void* a, const void* b, size_t length,
+                                     GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            const float* x = (const float*)a;
+            const float* y = (const float*)b;
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= length; i += 4) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc);
+            FINISH_FLOAT_DOT(float, (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]));
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            const double* x = (const double*)a;
+            const double* y = (const double*)b;
+            __m128d acc = _mm_setzero_pd();
+            for (; i + 2 <= length; i += 2) {
+                acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, acc);
+            FINISH_FLOAT_DOT(double, lanes[0] + lanes[1]);
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            const int16_t* x = (const int16_t*)a;
+            const int16_t* y = (const int16_t*)b;
+            __m128i acc = _mm_setzero_si128();
+            for (; i + 8 <= length; i += 8) {
+                __m128i p = _mm_madd_epi16(sse2_load(x + i), sse2_load(y + i));
+                acc = sse2_add_widened_epi32(acc, p, sse2_madd_sign(p));
+            }
+            uint64_t lanes64[2];
+            _mm_storeu_si128((__m128i*)lanes64, acc);
+            FINISH_INT_DOT(int16_t, sum_u64_lanes(lanes64, 2));
+            return;
+        }
+
+        // SSE2 has no signed 32x32->64 multiply; int32 stays scalar
+        default:
+            break;
+    }
+
+    dot_scalar(a, b, length, type, result);
+}
+
+static inline GOO_TARGET_SSE2 __m128 sse2_cmp_ps(GooVectorCompareOp cmp, __m128 a, __m128 b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm_cmpeq_ps(a, b);
+        case GOO_VEC_CMP_NE: return _mm_cmpneq_ps(a, b);
+        case GOO_VEC_CMP_LT: return _mm_cmplt_ps(a, b);
+        case GOO_VEC_CMP_LE: return _mm_cmple_ps(a, b);
+        case GOO_VEC_CMP_GT: return _mm_cmpgt_ps(a, b);
+        default:             return _mm_cmpge_ps(a, b);
+    }
+}
+
+static inline GOO_TARGET_SSE2 __m128d sse2_cmp_pd(GooVectorCompareOp cmp, __m128d a, __m128d b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm_cmpeq_pd(a, b);
+        case GOO_VEC_CMP_NE: return _mm_cmpneq_pd(a, b);
+        case GOO_VEC_CMP_LT: return _mm_cmplt_pd(a, b);
+        case GOO_VEC_CMP_LE: return _mm_cmple_pd(a, b);
+        case GOO_VEC_CMP_GT: return _mm_cmpgt_pd(a, b);
+        default:             return _mm_cmpge_pd(a, b);
+    }
+}
+
+// NE, LE and GE are the complements of EQ, GT and LT
+#define SSE2_CMP_INT(BITS)                                                  \
+    static inline GOO_TARGET_SSE2 __m128i sse2_cmp_epi##BITS(GooVectorCompareOp cmp, \
+                                                             __m128i a, __m128i b) { \
+        __m128i ones = _mm_set1_epi32(-1);                                  \
+        switch (cmp) {                                                      \
+            case GOO_VEC_CMP_EQ: return _mm_cmpeq_epi##BITS(a, b);          \
+            case GOO_VEC_CMP_NE: return _mm_xor_si128(_mm_cmpeq_epi##BITS(a, b), ones); \
+            case GOO_VEC_CMP_LT: return _mm_cmplt_epi##BITS(a, b);          \
+            case GOO_VEC_CMP_LE: return _mm_xor_si128(_mm_cmpgt_epi##BITS(a, b), ones); \
+            case GOO_VEC_CMP_GT: return _mm_cmpgt_epi##BITS(a, b);          \
+            default:             return _mm_xor_si128(_mm_cmplt_epi##BITS(a, b), ones); \
+        }                                                                   \
+    }
+
+SSE2_CMP_INT(16)
+SSE2_CMP_INT(32)
+
+static GOO_TARGET_SSE2 void compare_sse2(GooVectorCompareOp cmp, const void* a, const void* b,
+                                         size_t length, GooVectorDataType type, void* mask) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            __m128 truth = _mm_set1_ps(-1.0f);
+            for (; i + 4 <= length; i += 4) {
+                __m128 m = sse2_cmp_ps(cmp, _mm_loadu_ps((const float*)a + i), _mm_loadu_ps((const float*)b + i));
+                _mm_storeu_ps((float*)mask + i, _mm_and_ps(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            __m128d truth = _mm_set1_pd(-1.0);
+            for (; i + 2 <= length; i += 2) {
+                __m128d m = sse2_cmp_pd(cmp, _mm_loadu_pd((const double*)a + i), _mm_loadu_pd((const double*)b + i));
+                _mm_storeu_pd((double*)mask + i, _mm_and_pd(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_INT16:
+            for (; i + 8 <= length; i += 8) {
+                __m128i m = sse2_cmp_epi16(cmp, sse2_load((const int16_t*)a + i), sse2_load((const int16_t*)b + i));
+                _mm_storeu_si128((__m128i*)((int16_t*)mask + i), m);
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            for (; i + 4 <= length; i += 4) {
+                __m128i m = sse2_cmp_epi32(cmp, sse2_load((const int32_t*)a + i), sse2_load((const int32_t*)b + i));
+                _mm_storeu_si128((__m128i*)((int32_t*)mask + i), m);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    compare_scalar_range(cmp, a, b, i, length, type, mask);
+}
+
+// All-ones in each element of the given size whose mask element is zero
+static inline GOO_TARGET_SSE2 __m128i sse2_mask_is_zero(__m128i m, size_t elem_size) {
+    __m128i zero = _mm_setzero_si128();
+    switch (elem_size) {
+        case 1: return _mm_cmpeq_epi8(m, zero);
+        case 2: return _mm_cmpeq_epi16(m, zero);
+        case 4: return _mm_cmpeq_epi32(m, zero);
+        default: {
+            // No 64-bit compare in SSE2: both halves must be zero
+            __m128i eq = _mm_cmpeq_epi32(m, zero);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+}
+
+static GOO_TARGET_SSE2 void blend_sse2(const void* a, const void* b, const void* mask, void* dst,
+                                       size_t length, size_t elem_size) {
+    size_t lanes = 16 / elem_size;
+    size_t i = 0;
+
+    for (; i + lanes <= length; i += lanes) {
+        size_t offset = i * elem_size;
+        __m128i keep = sse2_mask_is_zero(sse2_load((const char*)mask + offset), elem_size);
+        __m128i va = sse2_load((const char*)a + offset);
+        __m128i vb = sse2_load((const char*)b + offset);
+        _mm_storeu_si128((__m128i*)((char*)dst + offset),
+                         _mm_or_si128(_mm_and_si128(keep, va), _mm_andnot_si128(keep, vb)));
+    }
+
+    blend_scalar_range(a, b, mask, dst, i, length, elem_size);
+}
+
+// No gather or scatter instructions before AVX2
+static const GooVectorKernels sse2_kernels = {
+    .elementwise = vector_op_sse2,
+    .reduce = reduce_sse2,
+    .dot = dot_sse2,
+    .compare = compare_sse2,
+    .blend = blend_sse2,
+    .gather = gather_scalar,
+    .scatter = scatter_scalar,
+};
+#endif
+
+#if defined(GOO_VEC_X86_DISPATCH)
+// AVX2 implementation: 256-bit lanes, same saturating semantics as scalar
+
+static inline GOO_TARGET_AVX2 __m256i avx2_load(const void* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline GOO_TARGET_AVX2 void avx2_store(void* p, __m256i v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline GOO_TARGET_AVX2 __m256 avx2_load_ps(const void* p) { return _mm256_loadu_ps((const float*)p); }
+static inline GOO_TARGET_AVX2 void avx2_store_ps(void* p, __m256 v) { _mm256_storeu_ps((float*)p, v); }
+static inline GOO_TARGET_AVX2 __m256d avx2_load_pd(const void* p) { return _mm256_loadu_pd((const double*)p); }
+static inline GOO_TARGET_AVX2 void avx2_store_pd(void* p, __m256d v) { _mm256_storeu_pd((double*)p, v); }
+
+// Restore element order after a lane-wise 256-bit pack
+static inline GOO_TARGET_AVX2 __m256i avx2_fix_pack(__m256i v) { return _mm256_permute4x64_epi64(v, 0xD8); }
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_ps(__m256 a, __m256 b) {
+    (void)a;
+    __m256 mag = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), b);
+    return _mm256_movemask_ps(_mm256_cmp_ps(mag, _mm256_set1_ps(1e-10f), _CMP_LT_OQ)) != 0;
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_pd(__m256d a, __m256d b) {
+    (void)a;
+    __m256d mag = _mm256_andnot_pd(_mm256_set1_pd(-0.0), b);
+    return _mm256_movemask_pd(_mm256_cmp_pd(mag, _mm256_set1_pd(1e-10), _CMP_LT_OQ)) != 0;
+}
+
+// 8- and 16-bit
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epi8(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mullo_epi16(_mm256_cvtepi8_epi16(_mm256_castsi256_si128(a)),
+                                    _mm256_cvtepi8_epi16(_mm256_castsi256_si128(b)));
+    __m256i hi = _mm256_mullo_epi16(_mm256_cvtepi8_epi16(_mm256_extracti128_si256(a, 1)),
+                                    _mm256_cvtepi8_epi16(_mm256_extracti128_si256(b, 1)));
+    return avx2_fix_pack(_mm256_packs_epi16(lo, hi));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epu8(__m256i a, __m256i b) {
+    __m256i max = _mm256_set1_epi16(UINT8_MAX);
+    __m256i lo = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(a)),
+                                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(b)));
+    __m256i hi = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(a, 1)),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(b, 1)));
+    return avx2_fix_pack(_mm256_packus_epi16(_mm256_min_epu16(lo, max), _mm256_min_epu16(hi, max)));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epi16(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mullo_epi16(a, b);
+    __m256i hi = _mm256_mulhi_epi16(a, b);
+    // Interleaving low and high halves gives 32-bit products in pack order
+    return _mm256_packs_epi32(_mm256_unpacklo_epi16(lo, hi), _mm256_unpackhi_epi16(lo, hi));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epu16(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mullo_epi16(a, b);
+    __m256i hi = _mm256_mulhi_epu16(a, b);
+    __m256i fits = _mm256_cmpeq_epi16(hi, _mm256_setzero_si256());
+    return _mm256_or_si256(lo, _mm256_xor_si256(fits, _mm256_set1_epi32(-1)));
+}
+
+// Divide eight 32-bit lanes in single precision; exact below 2^24
+static inline GOO_TARGET_AVX2 __m256i avx2_div32_ps(__m256i a, __m256i b) {
+    return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(a), _mm256_cvtepi32_ps(b)));
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epi8(__m256i a, __m256i b) {
+    __m256i zero = _mm256_cmpeq_epi8(b, _mm256_setzero_si256());
+    __m256i ovf = _mm256_and_si256(_mm256_cmpeq_epi8(a, _mm256_set1_epi8(INT8_MIN)),
+                                   _mm256_cmpeq_epi8(b, _mm256_set1_epi8(-1)));
+    return _mm256_movemask_epi8(_mm256_or_si256(zero, ovf)) != 0;
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epu8(__m256i a, __m256i b) {
+    (void)a;
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(b, _mm256_setzero_si256())) != 0;
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epi8(__m256i a, __m256i b) {
+    __m128i a_lo = _mm256_castsi256_si128(a), a_hi = _mm256_extracti128_si256(a, 1);
+    __m128i b_lo = _mm256_castsi256_si128(b), b_hi = _mm256_extracti128_si256(b, 1);
+    __m256i q0 = avx2_div32_ps(_mm256_cvtepi8_epi32(a_lo), _mm256_cvtepi8_epi32(b_lo));
+    __m256i q1 = avx2_div32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(a_lo, 8)),
+                               _mm256_cvtepi8_epi32(_mm_srli_si128(b_lo, 8)));
+    __m256i q2 = avx2_div32_ps(_mm256_cvtepi8_epi32(a_hi), _mm256_cvtepi8_epi32(b_hi));
+    __m256i q3 = avx2_div32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(a_hi, 8)),
+                               _mm256_cvtepi8_epi32(_mm_srli_si128(b_hi, 8)));
+    __m256i w0 = avx2_fix_pack(_mm256_packs_epi32(q0, q1));
+    __m256i w1 = avx2_fix_pack(_mm256_packs_epi32(q2, q3));
+    return avx2_fix_pack(_mm256_packs_epi16(w0, w1));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epu8(__m256i a, __m256i b) {
+    __m128i a_lo = _mm256_castsi256_si128(a), a_hi = _mm256_extracti128_si256(a, 1);
+    __m128i b_lo = _mm256_castsi256_si128(b), b_hi = _mm256_extracti128_si256(b, 1);
+    __m256i q0 = avx2_div32_ps(_mm256_cvtepu8_epi32(a_lo), _mm256_cvtepu8_epi32(b_lo));
+    __m256i q1 = avx2_div32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(a_lo, 8)),
+                               _mm256_cvtepu8_epi32(_mm_srli_si128(b_lo, 8)));
+    __m256i q2 = avx2_div32_ps(_mm256_cvtepu8_epi32(a_hi), _mm256_cvtepu8_epi32(b_hi));
+    __m256i q3 = avx2_div32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(a_hi, 8)),
+                               _mm256_cvtepu8_epi32(_mm_srli_si128(b_hi, 8)));
+    __m256i w0 = avx2_fix_pack(_mm256_packus_epi32(q0, q1));
+    __m256i w1 = avx2_fix_pack(_mm256_packus_epi32(q2, q3));
+    return avx2_fix_pack(_mm256_packus_epi16(w0, w1));
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epi16(__m256i a, __m256i b) {
+    __m256i zero = _mm256_cmpeq_epi16(b, _mm256_setzero_si256());
+    __m256i ovf = _mm256_and_si256(_mm256_cmpeq_epi16(a, _mm256_set1_epi16(INT16_MIN)),
+                                   _mm256_cmpeq_epi16(b, _mm256_set1_epi16(-1)));
+    return _mm256_movemask_epi8(_mm256_or_si256(zero, ovf)) != 0;
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epu16(__m256i a, __m256i b) {
+    (void)a;
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi16(b, _mm256_setzero_si256())) != 0;
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epi16(__m256i a, __m256i b) {
+    __m256i q0 = avx2_div32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(a)),
+                               _mm256_cvtepi16_epi32(_mm256_castsi256_si128(b)));
+    __m256i q1 = avx2_div32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(a, 1)),
+                               _mm256_cvtepi16_epi32(_mm256_extracti128_si256(b, 1)));
+    return avx2_fix_pack(_mm256_packs_epi32(q0, q1));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epu16(__m256i a, __m256i b) {
+    __m256i q0 = avx2_div32_ps(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(a)),
+                               _mm256_cvtepu16_epi32(_mm256_castsi256_si128(b)));
+    __m256i q1 = avx2_div32_ps(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(a, 1)),
+                               _mm256_cvtepu16_epi32(_mm256_extracti128_si256(b, 1)));
+    return avx2_fix_pack(_mm256_packus_epi32(q0, q1));
+}
+
+// 32-bit
+static inline GOO_TARGET_AVX2 __m256i avx2_blend_sign32(__m256i v, __m256i alt, __m256i sign) {
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(alt),
+                                                _mm256_castsi256_ps(sign)));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_adds_epi32(__m256i a, __m256i b) {
+    __m256i r = _mm256_add_epi32(a, b);
+    __m256i ovf = _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r));
+    __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    return avx2_blend_sign32(r, sat, ovf);
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_subs_epi32(__m256i a, __m256i b) {
+    __m256i r = _mm256_sub_epi32(a, b);
+    __m256i ovf = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r));
+    __m256i sat = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+    return avx2_blend_sign32(r, sat, ovf);
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_clamp_epi64_to_i32(__m256i x) {
+    __m256i max = _mm256_set1_epi64x(INT32_MAX);
+    __m256i min = _mm256_set1_epi64x(INT32_MIN);
+    x = _mm256_blendv_epi8(x, max, _mm256_cmpgt_epi64(x, max));
+    return _mm256_blendv_epi8(x, min, _mm256_cmpgt_epi64(min, x));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epi32_sat(__m256i a, __m256i b) {
+    __m256i even = avx2_clamp_epi64_to_i32(_mm256_mul_epi32(a, b));
+    __m256i odd = avx2_clamp_epi64_to_i32(_mm256_mul_epi32(_mm256_srli_epi64(a, 32),
+                                                           _mm256_srli_epi64(b, 32)));
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_adds_epu32(__m256i a, __m256i b) {
+    __m256i headroom = _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+    return _mm256_add_epi32(a, _mm256_min_epu32(b, headroom));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_subs_epu32(__m256i a, __m256i b) {
+    return _mm256_sub_epi32(_mm256_max_epu32(a, b), b);
+}
+
+// Saturate 64-bit unsigned products into their low 32 bits
+static inline GOO_TARGET_AVX2 __m256i avx2_sat_epu64_to_u32(__m256i x) {
+    __m256i fits = _mm256_cmpeq_epi64(_mm256_srli_epi64(x, 32), _mm256_setzero_si256());
+    return _mm256_or_si256(x, _mm256_xor_si256(fits, _mm256_set1_epi32(-1)));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mul_epu32_sat(__m256i a, __m256i b) {
+    __m256i even = avx2_sat_epu64_to_u32(_mm256_mul_epu32(a, b));
+    __m256i odd = avx2_sat_epu64_to_u32(_mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                                         _mm256_srli_epi64(b, 32)));
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epi32(__m256i a, __m256i b) {
+    __m256i zero = _mm256_cmpeq_epi32(b, _mm256_setzero_si256());
+    __m256i ovf = _mm256_and_si256(_mm256_cmpeq_epi32(a, _mm256_set1_epi32(INT32_MIN)),
+                                   _mm256_cmpeq_epi32(b, _mm256_set1_epi32(-1)));
+    return _mm256_movemask_epi8(_mm256_or_si256(zero, ovf)) != 0;
+}
+
+static inline GOO_TARGET_AVX2 bool avx2_guard_epu32(__m256i a, __m256i b) {
+    (void)a;
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi32(b, _mm256_setzero_si256())) != 0;
+}
+
+// 32-bit division in double precision is exact
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epi32(__m256i a, __m256i b) {
+    __m128i q0 = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                                                   _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))));
+    __m128i q1 = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                                                   _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))));
+    return _mm256_set_m128i(q1, q0);
+}
+
+static inline GOO_TARGET_AVX2 __m256d avx2_cvtepu32_pd(__m128i x) {
+    __m128i biased = _mm_xor_si128(x, _mm_set1_epi32(INT32_MIN));
+    return _mm256_add_pd(_mm256_cvtepi32_pd(biased), _mm256_set1_pd(2147483648.0));
+}
+
+static inline GOO_TARGET_AVX2 __m128i avx2_cvttpd_epu32(__m256d q) {
+    __m256d biased = _mm256_sub_pd(_mm256_floor_pd(q), _mm256_set1_pd(2147483648.0));
+    return _mm_xor_si128(_mm256_cvttpd_epi32(biased), _mm_set1_epi32(INT32_MIN));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_div_epu32(__m256i a, __m256i b) {
+    __m128i q0 = avx2_cvttpd_epu32(_mm256_div_pd(avx2_cvtepu32_pd(_mm256_castsi256_si128(a)),
+                                                 avx2_cvtepu32_pd(_mm256_castsi256_si128(b))));
+    __m128i q1 = avx2_cvttpd_epu32(_mm256_div_pd(avx2_cvtepu32_pd(_mm256_extracti128_si256(a, 1)),
+                                                 avx2_cvtepu32_pd(_mm256_extracti128_si256(b, 1))));
+    return _mm256_set_m128i(q1, q0);
+}
+
+// 64-bit
+static inline GOO_TARGET_AVX2 __m256i avx2_blend_sign64(__m256i v, __m256i alt, __m256i sign) {
+    return _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(alt),
+                                                _mm256_castsi256_pd(sign)));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_adds_epi64(__m256i a, __m256i b) {
+    __m256i r = _mm256_add_epi64(a, b);
+    __m256i ovf = _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r));
+    __m256i sat = _mm256_xor_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), a),
+                                   _mm256_set1_epi64x(INT64_MAX));
+    return avx2_blend_sign64(r, sat, ovf);
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_subs_epi64(__m256i a, __m256i b) {
+    __m256i r = _mm256_sub_epi64(a, b);
+    __m256i ovf = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r));
+    __m256i sat = _mm256_xor_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), a),
+                                   _mm256_set1_epi64x(INT64_MAX));
+    return avx2_blend_sign64(r, sat, ovf);
+}
+
+// AVX2 has no unsigned 64-bit compare; flip the sign bits and compare signed
+static inline GOO_TARGET_AVX2 __m256i avx2_cmpgt_epu64(__m256i a, __m256i b) {
+    __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_adds_epu64(__m256i a, __m256i b) {
+    __m256i r = _mm256_add_epi64(a, b);
+    return _mm256_or_si256(r, avx2_cmpgt_epu64(a, r));
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_subs_epu64(__m256i a, __m256i b) {
+    return _mm256_andnot_si256(avx2_cmpgt_epu64(b, a), _mm256_sub_epi64(a, b));
+}
+
+static GOO_TARGET_AVX2 bool vector_op_avx2(GooVectorOp op, void* src1, void* src2, void* dst,
+                         size_t elem_size, size_t length, GooVectorDataType type) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(float, __m256, 8, avx2_load_ps, avx2_store_ps, _mm256_add_ps); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(float, __m256, 8, avx2_load_ps, avx2_store_ps, _mm256_sub_ps); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(float, __m256, 8, avx2_load_ps, avx2_store_ps, _mm256_mul_ps); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(float, __m256, 8, avx2_load_ps, avx2_store_ps, avx2_guard_ps, _mm256_div_ps); break;
+                case GOO_VECTOR_FMA: SIMD_FMA_LOOP(float, __m256, 8, avx2_load_ps, avx2_store_ps, _mm256_fmadd_ps); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_DOUBLE:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(double, __m256d, 4, avx2_load_pd, avx2_store_pd, _mm256_add_pd); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(double, __m256d, 4, avx2_load_pd, avx2_store_pd, _mm256_sub_pd); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(double, __m256d, 4, avx2_load_pd, avx2_store_pd, _mm256_mul_pd); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(double, __m256d, 4, avx2_load_pd, avx2_store_pd, avx2_guard_pd, _mm256_div_pd); break;
+                case GOO_VECTOR_FMA: SIMD_FMA_LOOP(double, __m256d, 4, avx2_load_pd, avx2_store_pd, _mm256_fmadd_pd); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT8:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(int8_t, __m256i, 32, avx2_load, avx2_store, _mm256_adds_epi8); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(int8_t, __m256i, 32, avx2_load, avx2_store, _mm256_subs_epi8); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(int8_t, __m256i, 32, avx2_load, avx2_store, avx2_mul_epi8); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(int8_t, __m256i, 32, avx2_load, avx2_store, avx2_guard_epi8, avx2_div_epi8); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT8:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(uint8_t, __m256i, 32, avx2_load, avx2_store, _mm256_adds_epu8); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(uint8_t, __m256i, 32, avx2_load, avx2_store, _mm256_subs_epu8); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(uint8_t, __m256i, 32, avx2_load, avx2_store, avx2_mul_epu8); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(uint8_t, __m256i, 32, avx2_load, avx2_store, avx2_guard_epu8, avx2_div_epu8); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT16:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(int16_t, __m256i, 16, avx2_load, avx2_store, _mm256_adds_epi16); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(int16_t, __m256i, 16, avx2_load, avx2_store, _mm256_subs_epi16); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(int16_t, __m256i, 16, avx2_load, avx2_store, avx2_mul_epi16); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(int16_t, __m256i, 16, avx2_load, avx2_store, avx2_guard_epi16, avx2_div_epi16); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT16:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(uint16_t, __m256i, 16, avx2_load, avx2_store, _mm256_adds_epu16); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(uint16_t, __m256i, 16, avx2_load, avx2_store, _mm256_subs_epu16); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(uint16_t, __m256i, 16, avx2_load, avx2_store, avx2_mul_epu16); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(uint16_t, __m256i, 16, avx2_load, avx2_store, avx2_guard_epu16, avx2_div_epu16); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(int32_t, __m256i, 8, avx2_load, avx2_store, avx2_adds_epi32); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(int32_t, __m256i, 8, avx2_load, avx2_store, avx2_subs_epi32); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(int32_t, __m256i, 8, avx2_load, avx2_store, avx2_mul_epi32_sat); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(int32_t, __m256i, 8, avx2_load, avx2_store, avx2_guard_epi32, avx2_div_epi32); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT32:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(uint32_t, __m256i, 8, avx2_load, avx2_store, avx2_adds_epu32); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(uint32_t, __m256i, 8, avx2_load, avx2_store, avx2_subs_epu32); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(uint32_t, __m256i, 8, avx2_load, avx2_store, avx2_mul_epu32_sat); break;
+                case GOO_VECTOR_DIV: SIMD_GUARDED_LOOP(uint32_t, __m256i, 8, avx2_load, avx2_store, avx2_guard_epu32, avx2_div_epu32); break;
+                default: break;
+            }
+            break;
+
+        // No 64x64 multiply-high or 64-bit divide: MUL and DIV stay scalar
+        case GOO_VEC_INT64:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(int64_t, __m256i, 4, avx2_load, avx2_store, avx2_adds_epi64); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(int64_t, __m256i, 4, avx2_load, avx2_store, avx2_subs_epi64); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT64:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(uint64_t, __m256i, 4, avx2_load, avx2_store, avx2_adds_epu64); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(uint64_t, __m256i, 4, avx2_load, avx2_store, avx2_subs_epu64); break;
+                default: break;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Unsupported combinations and error reporting
+    if (i == length) return true;
+    return vector_op_scalar_range(op, src1, src2, dst, elem_size, i, length, type);
+}
+static GOO_TARGET_AVX2 void reduce_avx2(GooVectorReduceOp op, const void* src, size_t length,
+                                        GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            if (length < 8) break;
+            const float* s = (const float*)src;
+            __m256 acc = _mm256_set1_ps(REDUCE_START(op));
+            for (i = 0; i + 8 <= length; i += 8) {
+                __m256 v = _mm256_loadu_ps(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm256_add_ps(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm256_min_ps(v, acc);
+                else acc = _mm256_max_ps(v, acc);
+            }
+            float lanes[8];
+            _mm256_storeu_ps(lanes, acc);
+            FINISH_FLOAT_REDUCE(float, lanes, 8);
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            if (length < 4) break;
+            const double* s = (const double*)src;
+            __m256d acc = _mm256_set1_pd(REDUCE_START(op));
+            for (i = 0; i + 4 <= length; i += 4) {
+                __m256d v = _mm256_loadu_pd(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm256_add_pd(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm256_min_pd(v, acc);
+                else acc = _mm256_max_pd(v, acc);
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, acc);
+            FINISH_FLOAT_REDUCE(double, lanes, 4);
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            if (length < 16) break;
+            const int16_t* s = (const int16_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m256i ones = _mm256_set1_epi16(1);
+                __m256i acc = _mm256_setzero_si256();
+                int32_t lanes32[8];
+                int64_t total = 0;
+                size_t pending = 0;
+                for (; i + 16 <= length; i += 16) {
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(avx2_load(s + i), ones));
+                    if (++pending == MADD_FLUSH_INTERVAL) {
+                        _mm256_storeu_si256((__m256i*)lanes32, acc);
+                        total += sum_i32_lanes(lanes32, 8);
+                        acc = _mm256_setzero_si256();
+                        pending = 0;
+                    }
+                }
+                _mm256_storeu_si256((__m256i*)lanes32, acc);
+                total += sum_i32_lanes(lanes32, 8);
+                FINISH_INT_SUM(int16_t, total);
+                return;
+            }
+            __m256i acc = avx2_load(s);
+            for (i = 16; i + 16 <= length; i += 16) {
+                __m256i v = avx2_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? _mm256_min_epi16(acc, v) : _mm256_max_epi16(acc, v);
+            }
+            int16_t lanes[16];
+            _mm256_storeu_si256((__m256i*)lanes, acc);
+            FINISH_INT_MINMAX(int16_t, lanes, 16);
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            if (length < 8) break;
+            const int32_t* s = (const int32_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m256i acc = _mm256_setzero_si256();
+                for (; i + 8 <= length; i += 8) {
+                    __m256i v = avx2_load(s + i);
+                    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+                    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+                }
+                uint64_t lanes64[4];
+                _mm256_storeu_si256((__m256i*)lanes64, acc);
+                FINISH_INT_SUM(int32_t, sum_u64_lanes(lanes64, 4));
+                return;
+            }
+            __m256i acc = avx2_load(s);
+            for (i = 8; i + 8 <= length; i += 8) {
+                __m256i v = avx2_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? _mm256_min_epi32(acc, v) : _mm256_max_epi32(acc, v);
+            }
+            int32_t lanes[8];
+            _mm256_storeu_si256((__m256i*)lanes, acc);
+            FINISH_INT_MINMAX(int32_t, lanes, 8);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    reduce_scalar(op, src, length, type, result);
+}
+
+// Widen pmaddwd lanes to int64; see sse2_madd_sign for the INT32_MIN case
+static inline GOO_TARGET_AVX2 __m256i avx2_widen_madd(__m128i p) {
+    __m256i wide = _mm256_cvtepi32_epi64(p);
+    __m256i wrapped = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(p, _mm_set1_epi32(INT32_MIN)));
+    return _mm256_add_epi64(wide, _mm256_and_si256(wrapped, _mm256_set1_epi64x(1LL << 32)));
+}
+
+static GOO_TARGET_AVX2 void dot_avx2(const void* a, const void* b, size_t length,
+                                     GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            const float* x = (const float*)a;
+            const float* y = (const float*)b;
+            __m256 acc = _mm256_setzero_ps();
+            for (; i + 8 <= length; i += 8) {
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc);
+            }
+            float lanes[8];
+            _mm256_storeu_ps(lanes, acc);
+            float partial = 0.0f;
+            for (int k = 0; k < 8; k++) partial += lanes[k];
+            FINISH_FLOAT_DOT(float, partial);
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            const double* x = (const double*)a;
+            const double* y = (const double*)b;
+            __m256d acc = _mm256_setzero_pd();
+            for (; i + 4 <= length; i += 4) {
+                acc = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc);
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, acc);
+            FINISH_FLOAT_DOT(double, (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]));
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            const int16_t* x = (const int16_t*)a;
+            const int16_t* y = (const int16_t*)b;
+            __m256i acc = _mm256_setzero_si256();
+            for (; i + 16 <= length; i += 16) {
+                __m256i p = _mm256_madd_epi16(avx2_load(x + i), avx2_load(y + i));
+                acc = _mm256_add_epi64(acc, avx2_widen_madd(_mm256_castsi256_si128(p)));
+                acc = _mm256_add_epi64(acc, avx2_widen_madd(_mm256_extracti128_si256(p, 1)));
+            }
+            uint64_t lanes64[4];
+            _mm256_storeu_si256((__m256i*)lanes64, acc);
+            FINISH_INT_DOT(int16_t, sum_u64_lanes(lanes64, 4));
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            const int32_t* x = (const int32_t*)a;
+            const int32_t* y = (const int32_t*)b;
+            __m256i acc = _mm256_setzero_si256();
+            for (; i + 8 <= length; i += 8) {
+                __m256i va = avx2_load(x + i);
+                __m256i vb = avx2_load(y + i);
+                // vpmuldq multiplies the even lanes; shift the odd ones down
+                acc = _mm256_add_epi64(acc, _mm256_mul_epi32(va, vb));
+                acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(va, 32),
+                                                             _mm256_srli_epi64(vb, 32)));
+            }
+            uint64_t lanes64[4];
+            _mm256_storeu_si256((__m256i*)lanes64, acc);
+            FINISH_INT_DOT(int32_t, sum_u64_lanes(lanes64, 4));
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    dot_scalar(a, b, length, type, result);
+}
+
+// Ordered predicates match C's comparison operators on NaN; NE is unordered
+static inline GOO_TARGET_AVX2 __m256 avx2_cmp_ps(GooVectorCompareOp cmp, __m256 a, __m256 b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+        case GOO_VEC_CMP_NE: return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+        case GOO_VEC_CMP_LT: return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+        case GOO_VEC_CMP_LE: return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+        case GOO_VEC_CMP_GT: return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+        default:             return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+    }
+}
+
+static inline GOO_TARGET_AVX2 __m256d avx2_cmp_pd(GooVectorCompareOp cmp, __m256d a, __m256d b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+        case GOO_VEC_CMP_NE: return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ);
+        case GOO_VEC_CMP_LT: return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+        case GOO_VEC_CMP_LE: return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+        case GOO_VEC_CMP_GT: return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+        default:             return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+    }
+}
+
+#define AVX2_CMP_INT(BITS)                                                  \
+    static inline GOO_TARGET_AVX2 __m256i avx2_cmp_epi##BITS(GooVectorCompareOp cmp, \
+                                                             __m256i a, __m256i b) { \
+        __m256i ones = _mm256_set1_epi32(-1);                               \
+        switch (cmp) {                                                      \
+            case GOO_VEC_CMP_EQ: return _mm256_cmpeq_epi##BITS(a, b);       \
+            case GOO_VEC_CMP_NE: return _mm256_xor_si256(_mm256_cmpeq_epi##BITS(a, b), ones); \
+            case GOO_VEC_CMP_LT: return _mm256_cmpgt_epi##BITS(b, a);       \
+            case GOO_VEC_CMP_LE: return _mm256_xor_si256(_mm256_cmpgt_epi##BITS(a, b), ones); \
+            case GOO_VEC_CMP_GT: return _mm256_cmpgt_epi##BITS(a, b);       \
+            default:             return _mm256_xor_si256(_mm256_cmpgt_epi##BITS(b, a), ones); \
+        }                                                                   \
+    }
+
+AVX2_CMP_INT(16)
+AVX2_CMP_INT(32)
+
+static GOO_TARGET_AVX2 void compare_avx2(GooVectorCompareOp cmp, const void* a, const void* b,
+                                         size_t length, GooVectorDataType type, void* mask) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            __m256 truth = _mm256_set1_ps(-1.0f);
+            for (; i + 8 <= length; i += 8) {
+                __m256 m = avx2_cmp_ps(cmp, avx2_load_ps((const float*)a + i), avx2_load_ps((const float*)b + i));
+                avx2_store_ps((float*)mask + i, _mm256_and_ps(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            __m256d truth = _mm256_set1_pd(-1.0);
+            for (; i + 4 <= length; i += 4) {
+                __m256d m = avx2_cmp_pd(cmp, avx2_load_pd((const double*)a + i), avx2_load_pd((const double*)b + i));
+                avx2_store_pd((double*)mask + i, _mm256_and_pd(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_INT16:
+            for (; i + 16 <= length; i += 16) {
+                avx2_store((int16_t*)mask + i,
+                           avx2_cmp_epi16(cmp, avx2_load((const int16_t*)a + i), avx2_load((const int16_t*)b + i)));
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            for (; i + 8 <= length; i += 8) {
+                avx2_store((int32_t*)mask + i,
+                           avx2_cmp_epi32(cmp, avx2_load((const int32_t*)a + i), avx2_load((const int32_t*)b + i)));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    compare_scalar_range(cmp, a, b, i, length, type, mask);
+}
+
+static inline GOO_TARGET_AVX2 __m256i avx2_mask_is_zero(__m256i m, size_t elem_size) {
+    __m256i zero = _mm256_setzero_si256();
+    switch (elem_size) {
+        case 1: return _mm256_cmpeq_epi8(m, zero);
+        case 2: return _mm256_cmpeq_epi16(m, zero);
+        case 4: return _mm256_cmpeq_epi32(m, zero);
+        default: return _mm256_cmpeq_epi64(m, zero);
+    }
+}
+
+static GOO_TARGET_AVX2 void blend_avx2(const void* a, const void* b, const void* mask, void* dst,
+                                       size_t length, size_t elem_size) {
+    size_t lanes = 32 / elem_size;
+    size_t i = 0;
+
+    for (; i + lanes <= length; i += lanes) {
+        size_t offset = i * elem_size;
+        __m256i keep = avx2_mask_is_zero(avx2_load((const char*)mask + offset), elem_size);
+        avx2_store((char*)dst + offset,
+                   _mm256_blendv_epi8(avx2_load((const char*)b + offset),
+                                      avx2_load((const char*)a + offset), keep));
+    }
+
+    blend_scalar_range(a, b, mask, dst, i, length, elem_size);
+}
+
+static GOO_TARGET_AVX2 void gather_avx2(const void* base, const int32_t* indices, size_t length,
+                                        size_t elem_size, void* dst) {
+    size_t i = 0;
+
+    if (elem_size == 4) {
+        for (; i + 8 <= length; i += 8) {
+            __m256i idx = avx2_load(indices + i);
+            avx2_store((int32_t*)dst + i, _mm256_i32gather_epi32((const int*)base, idx, 4));
+        }
+    } else if (elem_size == 8) {
+        for (; i + 4 <= length; i += 4) {
+            __m128i idx = _mm_loadu_si128((const __m128i*)(indices + i));
+            avx2_store((int64_t*)dst + i, _mm256_i32gather_epi64((const long long*)base, idx, 8));
+        }
+    }
+
+    gather_scalar_range(base, indices, i, length, elem_size, dst);
+}
+
+// AVX2 has gathers but no scatters
+static const GooVectorKernels avx2_kernels = {
+    .elementwise = vector_op_avx2,
+    .reduce = reduce_avx2,
+    .dot = dot_avx2,
+    .compare = compare_avx2,
+    .blend = blend_avx2,
+    .gather = gather_avx2,
+    .scatter = scatter_scalar,
+};
+#endif
+
+#if defined(GOO_VEC_X86_DISPATCH)
+// AVX-512 implementation: 512-bit lanes with mask-register compares
+
+static inline GOO_TARGET_AVX512 __m512i avx512_load(const void* p) { return _mm512_loadu_si512(p); }
+static inline GOO_TARGET_AVX512 void avx512_store(void* p, __m512i v) { _mm512_storeu_si512(p, v); }
+static inline GOO_TARGET_AVX512 __m512 avx512_load_ps(const void* p) { return _mm512_loadu_ps(p); }
+static inline GOO_TARGET_AVX512 void avx512_store_ps(void* p, __m512 v) { _mm512_storeu_ps(p, v); }
+static inline GOO_TARGET_AVX512 __m512d avx512_load_pd(const void* p) { return _mm512_loadu_pd(p); }
+static inline GOO_TARGET_AVX512 void avx512_store_pd(void* p, __m512d v) { _mm512_storeu_pd(p, v); }
+
+// Masked head and tail blocks: inactive lanes load as 1 and are never stored
+static inline uint64_t avx512_lane_mask(size_t count) {
+    return count >= 64 ? ~0ull : (1ull << count) - 1;
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mask_load_epi8(uint64_t k, const void* p) { return _mm512_mask_loadu_epi8(_mm512_set1_epi8(1), (__mmask64)k, p); }
+static inline GOO_TARGET_AVX512 __m512i avx512_mask_load_epi16(uint64_t k, const void* p) { return _mm512_mask_loadu_epi16(_mm512_set1_epi16(1), (__mmask32)k, p); }
+static inline GOO_TARGET_AVX512 __m512i avx512_mask_load_epi32(uint64_t k, const void* p) { return _mm512_mask_loadu_epi32(_mm512_set1_epi32(1), (__mmask16)k, p); }
+static inline GOO_TARGET_AVX512 __m512i avx512_mask_load_epi64(uint64_t k, const void* p) { return _mm512_mask_loadu_epi64(_mm512_set1_epi64(1), (__mmask8)k, p); }
+static inline GOO_TARGET_AVX512 __m512 avx512_mask_load_ps(uint64_t k, const void* p) { return _mm512_mask_loadu_ps(_mm512_set1_ps(1.0f), (__mmask16)k, p); }
+static inline GOO_TARGET_AVX512 __m512d avx512_mask_load_pd(uint64_t k, const void* p) { return _mm512_mask_loadu_pd(_mm512_set1_pd(1.0), (__mmask8)k, p); }
+
+static inline GOO_TARGET_AVX512 void avx512_mask_store_epi8(void* p, uint64_t k, __m512i v) { _mm512_mask_storeu_epi8(p, (__mmask64)k, v); }
+static inline GOO_TARGET_AVX512 void avx512_mask_store_epi16(void* p, uint64_t k, __m512i v) { _mm512_mask_storeu_epi16(p, (__mmask32)k, v); }
+static inline GOO_TARGET_AVX512 void avx512_mask_store_epi32(void* p, uint64_t k, __m512i v) { _mm512_mask_storeu_epi32(p, (__mmask16)k, v); }
+static inline GOO_TARGET_AVX512 void avx512_mask_store_epi64(void* p, uint64_t k, __m512i v) { _mm512_mask_storeu_epi64(p, (__mmask8)k, v); }
+static inline GOO_TARGET_AVX512 void avx512_mask_store_ps(void* p, uint64_t k, __m512 v) { _mm512_mask_storeu_ps(p, (__mmask16)k, v); }
+static inline GOO_TARGET_AVX512 void avx512_mask_store_pd(void* p, uint64_t k, __m512d v) { _mm512_mask_storeu_pd(p, (__mmask8)k, v); }
+
+#define AVX512_MASK_LOAD(T, k, p)                                           \
+    _Generic((T*)0,                                                         \
+        int8_t*: avx512_mask_load_epi8, uint8_t*: avx512_mask_load_epi8,    \
+        int16_t*: avx512_mask_load_epi16, uint16_t*: avx512_mask_load_epi16, \
+        int32_t*: avx512_mask_load_epi32, uint32_t*: avx512_mask_load_epi32, \
+        int64_t*: avx512_mask_load_epi64, uint64_t*: avx512_mask_load_epi64, \
+        float*: avx512_mask_load_ps, double*: avx512_mask_load_pd)(k, p)
+
+#define AVX512_MASK_STORE(T, p, k, v)                                       \
+    _Generic((T*)0,                                                         \
+        int8_t*: avx512_mask_store_epi8, uint8_t*: avx512_mask_store_epi8,  \
+        int16_t*: avx512_mask_store_epi16, uint16_t*: avx512_mask_store_epi16, \
+        int32_t*: avx512_mask_store_epi32, uint32_t*: avx512_mask_store_epi32, \
+        int64_t*: avx512_mask_store_epi64, uint64_t*: avx512_mask_store_epi64, \
+        float*: avx512_mask_store_ps, double*: avx512_mask_store_pd)(p, k, v)
+
+#define AVX512_MASKED(ARITY, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count) \
+    {                                                                       \
+        uint64_t k_ = avx512_lane_mask(count);                              \
+        VT a_ = AVX512_MASK_LOAD(T, k_, (const T*)src1 + (j));              \
+        VT b_ = AVX512_MASK_LOAD(T, k_, (const T*)src2 + (j));              \
+        if (GUARD(a_, b_)) {                                                \
+            if (!vector_op_scalar_range(op, src1, src2, dst, elem_size,     \
+                                        (j), (j) + (count), type)) {        \
+                return false;                                               \
+            }                                                               \
+        } else {                                                            \
+            AVX512_MASKED_KERNEL_##ARITY(T, KERNEL, j);                     \
+        }                                                                   \
+    }
+
+#define AVX512_MASKED_KERNEL_2(T, KERNEL, j)                                \
+    AVX512_MASK_STORE(T, (T*)dst + (j), k_, KERNEL(a_, b_))
+#define AVX512_MASKED_KERNEL_3(T, KERNEL, j)                                \
+    AVX512_MASK_STORE(T, (T*)dst + (j), k_, KERNEL(a_, b_, AVX512_MASK_LOAD(T, k_, (const T*)dst + (j))))
+
+#define AVX512_MASKED2(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)  \
+    AVX512_MASKED(2, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)
+#define AVX512_MASKED3(T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)  \
+    AVX512_MASKED(3, T, VT, LANES, LOAD, STORE, GUARD, KERNEL, j, count)
+
+#define AVX512_GUARDED_LOOP(T, VT, LANES, LOAD, STORE, GUARD, KERNEL)        \
+    SIMD_DRIVE(SIMD_STEP2, AVX512_MASKED2, T, VT, LANES, LOAD, STORE, GUARD, KERNEL)
+#define AVX512_BINARY_LOOP(T, VT, LANES, LOAD, STORE, KERNEL)                \
+    AVX512_GUARDED_LOOP(T, VT, LANES, LOAD, STORE, SIMD_NO_GUARD, KERNEL)
+#define AVX512_FMA_LOOP(T, VT, LANES, LOAD, STORE, KERNEL)                   \
+    SIMD_DRIVE(SIMD_STEP3, AVX512_MASKED3, T, VT, LANES, LOAD, STORE, SIMD_NO_GUARD, KERNEL)
+
+static inline GOO_TARGET_AVX512 __m512i avx512_join256(__m256i lo, __m256i hi) {
+    return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_ps(__m512 a, __m512 b) {
+    (void)a;
+    return _mm512_cmp_ps_mask(_mm512_abs_ps(b), _mm512_set1_ps(1e-10f), _CMP_LT_OQ) != 0;
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_pd(__m512d a, __m512d b) {
+    (void)a;
+    return _mm512_cmp_pd_mask(_mm512_abs_pd(b), _mm512_set1_pd(1e-10), _CMP_LT_OQ) != 0;
+}
+
+// 8- and 16-bit: widen, operate, narrow with saturation
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epi8(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mullo_epi16(_mm512_cvtepi8_epi16(_mm512_castsi512_si256(a)),
+                                    _mm512_cvtepi8_epi16(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mullo_epi16(_mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(a, 1)),
+                                    _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtsepi16_epi8(lo), _mm512_cvtsepi16_epi8(hi));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epu8(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mullo_epi16(_mm512_cvtepu8_epi16(_mm512_castsi512_si256(a)),
+                                    _mm512_cvtepu8_epi16(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mullo_epi16(_mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(a, 1)),
+                                    _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtusepi16_epi8(lo), _mm512_cvtusepi16_epi8(hi));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epi16(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mullo_epi32(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(a)),
+                                    _mm512_cvtepi16_epi32(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mullo_epi32(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(a, 1)),
+                                    _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtsepi32_epi16(lo), _mm512_cvtsepi32_epi16(hi));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epu16(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mullo_epi32(_mm512_cvtepu16_epi32(_mm512_castsi512_si256(a)),
+                                    _mm512_cvtepu16_epi32(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mullo_epi32(_mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(a, 1)),
+                                    _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtusepi32_epi16(lo), _mm512_cvtusepi32_epi16(hi));
+}
+
+// Divide sixteen 32-bit lanes in single precision; exact below 2^24
+static inline GOO_TARGET_AVX512 __m512i avx512_div32_ps(__m512i a, __m512i b) {
+    return _mm512_cvttps_epi32(_mm512_div_ps(_mm512_cvtepi32_ps(a), _mm512_cvtepi32_ps(b)));
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epi8(__m512i a, __m512i b) {
+    __mmask64 ovf = _mm512_cmpeq_epi8_mask(a, _mm512_set1_epi8(INT8_MIN)) &
+                    _mm512_cmpeq_epi8_mask(b, _mm512_set1_epi8(-1));
+    return (_mm512_cmpeq_epi8_mask(b, _mm512_setzero_si512()) | ovf) != 0;
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epu8(__m512i a, __m512i b) {
+    (void)a;
+    return _mm512_cmpeq_epi8_mask(b, _mm512_setzero_si512()) != 0;
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epi8(__m512i a, __m512i b) {
+    __m512i r = _mm512_setzero_si512();
+    #define AVX512_DIV_EPI8_PART(k)                                                         \
+        r = _mm512_inserti32x4(r, _mm512_cvtsepi32_epi8(avx512_div32_ps(                    \
+                _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(a, k)),                      \
+                _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(b, k)))), k)
+    AVX512_DIV_EPI8_PART(0);
+    AVX512_DIV_EPI8_PART(1);
+    AVX512_DIV_EPI8_PART(2);
+    AVX512_DIV_EPI8_PART(3);
+    #undef AVX512_DIV_EPI8_PART
+    return r;
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epu8(__m512i a, __m512i b) {
+    __m512i r = _mm512_setzero_si512();
+    #define AVX512_DIV_EPU8_PART(k)                                                         \
+        r = _mm512_inserti32x4(r, _mm512_cvtusepi32_epi8(avx512_div32_ps(                   \
+                _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(a, k)),                      \
+                _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(b, k)))), k)
+    AVX512_DIV_EPU8_PART(0);
+    AVX512_DIV_EPU8_PART(1);
+    AVX512_DIV_EPU8_PART(2);
+    AVX512_DIV_EPU8_PART(3);
+    #undef AVX512_DIV_EPU8_PART
+    return r;
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epi16(__m512i a, __m512i b) {
+    __mmask32 ovf = _mm512_cmpeq_epi16_mask(a, _mm512_set1_epi16(INT16_MIN)) &
+                    _mm512_cmpeq_epi16_mask(b, _mm512_set1_epi16(-1));
+    return (_mm512_cmpeq_epi16_mask(b, _mm512_setzero_si512()) | ovf) != 0;
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epu16(__m512i a, __m512i b) {
+    (void)a;
+    return _mm512_cmpeq_epi16_mask(b, _mm512_setzero_si512()) != 0;
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epi16(__m512i a, __m512i b) {
+    __m512i lo = avx512_div32_ps(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(a)),
+                                 _mm512_cvtepi16_epi32(_mm512_castsi512_si256(b)));
+    __m512i hi = avx512_div32_ps(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(a, 1)),
+                                 _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtsepi32_epi16(lo), _mm512_cvtsepi32_epi16(hi));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epu16(__m512i a, __m512i b) {
+    __m512i lo = avx512_div32_ps(_mm512_cvtepu16_epi32(_mm512_castsi512_si256(a)),
+                                 _mm512_cvtepu16_epi32(_mm512_castsi512_si256(b)));
+    __m512i hi = avx512_div32_ps(_mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(a, 1)),
+                                 _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtusepi32_epi16(lo), _mm512_cvtusepi32_epi16(hi));
+}
+
+// 32-bit
+static inline GOO_TARGET_AVX512 __m512i avx512_adds_epi32(__m512i a, __m512i b) {
+    __m512i r = _mm512_add_epi32(a, b);
+    __mmask16 ovf = _mm512_cmplt_epi32_mask(_mm512_and_si512(_mm512_xor_si512(a, r), _mm512_xor_si512(b, r)),
+                                            _mm512_setzero_si512());
+    __m512i sat = _mm512_xor_si512(_mm512_srai_epi32(a, 31), _mm512_set1_epi32(INT32_MAX));
+    return _mm512_mask_blend_epi32(ovf, r, sat);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_subs_epi32(__m512i a, __m512i b) {
+    __m512i r = _mm512_sub_epi32(a, b);
+    __mmask16 ovf = _mm512_cmplt_epi32_mask(_mm512_and_si512(_mm512_xor_si512(a, b), _mm512_xor_si512(a, r)),
+                                            _mm512_setzero_si512());
+    __m512i sat = _mm512_xor_si512(_mm512_srai_epi32(a, 31), _mm512_set1_epi32(INT32_MAX));
+    return _mm512_mask_blend_epi32(ovf, r, sat);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epi32_sat(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mul_epi32(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(a)),
+                                  _mm512_cvtepi32_epi64(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mul_epi32(_mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(a, 1)),
+                                  _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtsepi64_epi32(lo), _mm512_cvtsepi64_epi32(hi));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_adds_epu32(__m512i a, __m512i b) {
+    __m512i headroom = _mm512_xor_si512(a, _mm512_set1_epi32(-1));
+    return _mm512_add_epi32(a, _mm512_min_epu32(b, headroom));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_subs_epu32(__m512i a, __m512i b) {
+    return _mm512_sub_epi32(_mm512_max_epu32(a, b), b);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_mul_epu32_sat(__m512i a, __m512i b) {
+    __m512i lo = _mm512_mul_epu32(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(a)),
+                                  _mm512_cvtepu32_epi64(_mm512_castsi512_si256(b)));
+    __m512i hi = _mm512_mul_epu32(_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(a, 1)),
+                                  _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(b, 1)));
+    return avx512_join256(_mm512_cvtusepi64_epi32(lo), _mm512_cvtusepi64_epi32(hi));
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epi32(__m512i a, __m512i b) {
+    __mmask16 ovf = _mm512_cmpeq_epi32_mask(a, _mm512_set1_epi32(INT32_MIN)) &
+                    _mm512_cmpeq_epi32_mask(b, _mm512_set1_epi32(-1));
+    return (_mm512_cmpeq_epi32_mask(b, _mm512_setzero_si512()) | ovf) != 0;
+}
+
+static inline GOO_TARGET_AVX512 bool avx512_guard_epu32(__m512i a, __m512i b) {
+    (void)a;
+    return _mm512_cmpeq_epi32_mask(b, _mm512_setzero_si512()) != 0;
+}
+
+// 32-bit division in double precision is exact
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epi32(__m512i a, __m512i b) {
+    __m256i lo = _mm512_cvttpd_epi32(_mm512_div_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(a)),
+                                                   _mm512_cvtepi32_pd(_mm512_castsi512_si256(b))));
+    __m256i hi = _mm512_cvttpd_epi32(_mm512_div_pd(_mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(a, 1)),
+                                                   _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(b, 1))));
+    return avx512_join256(lo, hi);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_div_epu32(__m512i a, __m512i b) {
+    __m256i lo = _mm512_cvttpd_epu32(_mm512_div_pd(_mm512_cvtepu32_pd(_mm512_castsi512_si256(a)),
+                                                   _mm512_cvtepu32_pd(_mm512_castsi512_si256(b))));
+    __m256i hi = _mm512_cvttpd_epu32(_mm512_div_pd(_mm512_cvtepu32_pd(_mm512_extracti64x4_epi64(a, 1)),
+                                                   _mm512_cvtepu32_pd(_mm512_extracti64x4_epi64(b, 1))));
+    return avx512_join256(lo, hi);
+}
+
+// 64-bit
+static inline GOO_TARGET_AVX512 __m512i avx512_adds_epi64(__m512i a, __m512i b) {
+    __m512i r = _mm512_add_epi64(a, b);
+    __mmask8 ovf = _mm512_cmplt_epi64_mask(_mm512_and_si512(_mm512_xor_si512(a, r), _mm512_xor_si512(b, r)),
+                                           _mm512_setzero_si512());
+    __m512i sat = _mm512_xor_si512(_mm512_srai_epi64(a, 63), _mm512_set1_epi64(INT64_MAX));
+    return _mm512_mask_blend_epi64(ovf, r, sat);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_subs_epi64(__m512i a, __m512i b) {
+    __m512i r = _mm512_sub_epi64(a, b);
+    __mmask8 ovf = _mm512_cmplt_epi64_mask(_mm512_and_si512(_mm512_xor_si512(a, b), _mm512_xor_si512(a, r)),
+                                           _mm512_setzero_si512());
+    __m512i sat = _mm512_xor_si512(_mm512_srai_epi64(a, 63), _mm512_set1_epi64(INT64_MAX));
+    return _mm512_mask_blend_epi64(ovf, r, sat);
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_adds_epu64(__m512i a, __m512i b) {
+    __m512i headroom = _mm512_xor_si512(a, _mm512_set1_epi64(-1));
+    return _mm512_add_epi64(a, _mm512_min_epu64(b, headroom));
+}
+
+static inline GOO_TARGET_AVX512 __m512i avx512_subs_epu64(__m512i a, __m512i b) {
+    return _mm512_sub_epi64(_mm512_max_epu64(a, b), b);
+}
+
+static GOO_TARGET_AVX512 bool vector_op_avx512(GooVectorOp op, void* src1, void* src2, void* dst,
+                           size_t elem_size, size_t length, GooVectorDataType type) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(float, __m512, 16, avx512_load_ps, avx512_store_ps, _mm512_add_ps); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(float, __m512, 16, avx512_load_ps, avx512_store_ps, _mm512_sub_ps); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(float, __m512, 16, avx512_load_ps, avx512_store_ps, _mm512_mul_ps); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(float, __m512, 16, avx512_load_ps, avx512_store_ps, avx512_guard_ps, _mm512_div_ps); break;
+                case GOO_VECTOR_FMA: AVX512_FMA_LOOP(float, __m512, 16, avx512_load_ps, avx512_store_ps, _mm512_fmadd_ps); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_DOUBLE:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(double, __m512d, 8, avx512_load_pd, avx512_store_pd, _mm512_add_pd); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(double, __m512d, 8, avx512_load_pd, avx512_store_pd, _mm512_sub_pd); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(double, __m512d, 8, avx512_load_pd, avx512_store_pd, _mm512_mul_pd); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(double, __m512d, 8, avx512_load_pd, avx512_store_pd, avx512_guard_pd, _mm512_div_pd); break;
+                case GOO_VECTOR_FMA: AVX512_FMA_LOOP(double, __m512d, 8, avx512_load_pd, avx512_store_pd, _mm512_fmadd_pd); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT8:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(int8_t, __m512i, 64, avx512_load, avx512_store, _mm512_adds_epi8); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(int8_t, __m512i, 64, avx512_load, avx512_store, _mm512_subs_epi8); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(int8_t, __m512i, 64, avx512_load, avx512_store, avx512_mul_epi8); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(int8_t, __m512i, 64, avx512_load, avx512_store, avx512_guard_epi8, avx512_div_epi8); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT8:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(uint8_t, __m512i, 64, avx512_load, avx512_store, _mm512_adds_epu8); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(uint8_t, __m512i, 64, avx512_load, avx512_store, _mm512_subs_epu8); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(uint8_t, __m512i, 64, avx512_load, avx512_store, avx512_mul_epu8); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(uint8_t, __m512i, 64, avx512_load, avx512_store, avx512_guard_epu8, avx512_div_epu8); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT16:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(int16_t, __m512i, 32, avx512_load, avx512_store, _mm512_adds_epi16); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(int16_t, __m512i, 32, avx512_load, avx512_store, _mm512_subs_epi16); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(int16_t, __m512i, 32, avx512_load, avx512_store, avx512_mul_epi16); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(int16_t, __m512i, 32, avx512_load, avx512_store, avx512_guard_epi16, avx512_div_epi16); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT16:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(uint16_t, __m512i, 32, avx512_load, avx512_store, _mm512_adds_epu16); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(uint16_t, __m512i, 32, avx512_load, avx512_store, _mm512_subs_epu16); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(uint16_t, __m512i, 32, avx512_load, avx512_store, avx512_mul_epu16); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(uint16_t, __m512i, 32, avx512_load, avx512_store, avx512_guard_epu16, avx512_div_epu16); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(int32_t, __m512i, 16, avx512_load, avx512_store, avx512_adds_epi32); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(int32_t, __m512i, 16, avx512_load, avx512_store, avx512_subs_epi32); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(int32_t, __m512i, 16, avx512_load, avx512_store, avx512_mul_epi32_sat); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(int32_t, __m512i, 16, avx512_load, avx512_store, avx512_guard_epi32, avx512_div_epi32); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT32:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(uint32_t, __m512i, 16, avx512_load, avx512_store, avx512_adds_epu32); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(uint32_t, __m512i, 16, avx512_load, avx512_store, avx512_subs_epu32); break;
+                case GOO_VECTOR_MUL: AVX512_BINARY_LOOP(uint32_t, __m512i, 16, avx512_load, avx512_store, avx512_mul_epu32_sat); break;
+                case GOO_VECTOR_DIV: AVX512_GUARDED_LOOP(uint32_t, __m512i, 16, avx512_load, avx512_store, avx512_guard_epu32, avx512_div_epu32); break;
+                default: break;
+            }
+            break;
+
+        // No 64x64 multiply-high or 64-bit divide: MUL and DIV stay scalar
+        case GOO_VEC_INT64:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(int64_t, __m512i, 8, avx512_load, avx512_store, avx512_adds_epi64); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(int64_t, __m512i, 8, avx512_load, avx512_store, avx512_subs_epi64); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_UINT64:
+            switch (op) {
+                case GOO_VECTOR_ADD: AVX512_BINARY_LOOP(uint64_t, __m512i, 8, avx512_load, avx512_store, avx512_adds_epu64); break;
+                case GOO_VECTOR_SUB: AVX512_BINARY_LOOP(uint64_t, __m512i, 8, avx512_load, avx512_store, avx512_subs_epu64); break;
+                default: break;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Unsupported combinations and error reporting
+    if (i == length) return true;
+    return vector_op_scalar_range(op, src1, src2, dst, elem_size, i, length, type);
+}
+// Lane sum modulo 2^64; GCC's _mm512_reduce_add_epi64 adds as signed
+static inline GOO_TARGET_AVX512 uint64_t avx512_sum_epi64(__m512i v) {
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, v);
+    return sum_u64_lanes(lanes, 8);
+}
+
+static GOO_TARGET_AVX512 void reduce_avx512(GooVectorReduceOp op, const void* src, size_t length,
+                                            GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            if (length < 16) break;
+            const float* s = (const float*)src;
+            __m512 acc = _mm512_set1_ps(REDUCE_START(op));
+            for (i = 0; i + 16 <= length; i += 16) {
+                __m512 v = _mm512_loadu_ps(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm512_add_ps(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm512_min_ps(v, acc);
+                else acc = _mm512_max_ps(v, acc);
+            }
+            float lanes[16];
+            _mm512_storeu_ps(lanes, acc);
+            FINISH_FLOAT_REDUCE(float, lanes, 16);
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            if (length < 8) break;
+            const double* s = (const double*)src;
+            __m512d acc = _mm512_set1_pd(REDUCE_START(op));
+            for (i = 0; i + 8 <= length; i += 8) {
+                __m512d v = _mm512_loadu_pd(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = _mm512_add_pd(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = _mm512_min_pd(v, acc);
+                else acc = _mm512_max_pd(v, acc);
+            }
+            double lanes[8];
+            _mm512_storeu_pd(lanes, acc);
+            FINISH_FLOAT_REDUCE(double, lanes, 8);
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            if (length < 32) break;
+            const int16_t* s = (const int16_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m512i ones = _mm512_set1_epi16(1);
+                __m512i acc = _mm512_setzero_si512();
+                int32_t lanes32[16];
+                int64_t total = 0;
+                size_t pending = 0;
+                for (; i + 32 <= length; i += 32) {
+                    acc = _mm512_add_epi32(acc, _mm512_madd_epi16(avx512_load(s + i), ones));
+                    if (++pending == MADD_FLUSH_INTERVAL) {
+                        _mm512_storeu_si512(lanes32, acc);
+                        total += sum_i32_lanes(lanes32, 16);
+                        acc = _mm512_setzero_si512();
+                        pending = 0;
+                    }
+                }
+                _mm512_storeu_si512(lanes32, acc);
+                total += sum_i32_lanes(lanes32, 16);
+                FINISH_INT_SUM(int16_t, total);
+                return;
+            }
+            __m512i acc = avx512_load(s);
+            for (i = 32; i + 32 <= length; i += 32) {
+                __m512i v = avx512_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? _mm512_min_epi16(acc, v) : _mm512_max_epi16(acc, v);
+            }
+            int16_t lanes[32];
+            _mm512_storeu_si512(lanes, acc);
+            FINISH_INT_MINMAX(int16_t, lanes, 32);
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            if (length < 16) break;
+            const int32_t* s = (const int32_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                __m512i acc = _mm512_setzero_si512();
+                for (; i + 16 <= length; i += 16) {
+                    __m512i v = avx512_load(s + i);
+                    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+                    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+                }
+                FINISH_INT_SUM(int32_t, avx512_sum_epi64(acc));
+                return;
+            }
+            __m512i acc = avx512_load(s);
+            for (i = 16; i + 16 <= length; i += 16) {
+                __m512i v = avx512_load(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? _mm512_min_epi32(acc, v) : _mm512_max_epi32(acc, v);
+            }
+            int32_t lanes[1] = {
+                op == GOO_VEC_REDUCE_MIN ? _mm512_reduce_min_epi32(acc) : _mm512_reduce_max_epi32(acc)
+            };
+            FINISH_INT_MINMAX(int32_t, lanes, 1);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    reduce_scalar(op, src, length, type, result);
+}
+
+// Widen pmaddwd lanes to int64; see sse2_madd_sign for the INT32_MIN case
+static inline GOO_TARGET_AVX512 __m512i avx512_widen_madd(__m256i p) {
+    __m512i wide = _mm512_cvtepi32_epi64(p);
+    __mmask8 wrapped = _mm512_cmpeq_epi64_mask(wide, _mm512_set1_epi64(INT32_MIN));
+    return _mm512_mask_add_epi64(wide, wrapped, wide, _mm512_set1_epi64(1LL << 32));
+}
+
+static GOO_TARGET_AVX512 void dot_avx512(const void* a, const void* b, size_t length,
+                                         GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            const float* x = (const float*)a;
+            const float* y = (const float*)b;
+            __m512 acc = _mm512_setzero_ps();
+            for (; i + 16 <= length; i += 16) {
+                acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc);
+            }
+            FINISH_FLOAT_DOT(float, _mm512_reduce_add_ps(acc));
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            const double* x = (const double*)a;
+            const double* y = (const double*)b;
+            __m512d acc = _mm512_setzero_pd();
+            for (; i + 8 <= length; i += 8) {
+                acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc);
+            }
+            FINISH_FLOAT_DOT(double, _mm512_reduce_add_pd(acc));
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            const int16_t* x = (const int16_t*)a;
+            const int16_t* y = (const int16_t*)b;
+            __m512i acc = _mm512_setzero_si512();
+            for (; i + 32 <= length; i += 32) {
+                __m512i p = _mm512_madd_epi16(avx512_load(x + i), avx512_load(y + i));
+                acc = _mm512_add_epi64(acc, avx512_widen_madd(_mm512_castsi512_si256(p)));
+                acc = _mm512_add_epi64(acc, avx512_widen_madd(_mm512_extracti64x4_epi64(p, 1)));
+            }
+            FINISH_INT_DOT(int16_t, avx512_sum_epi64(acc));
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            const int32_t* x = (const int32_t*)a;
+            const int32_t* y = (const int32_t*)b;
+            __m512i acc = _mm512_setzero_si512();
+            for (; i + 16 <= length; i += 16) {
+                __m512i va = avx512_load(x + i);
+                __m512i vb = avx512_load(y + i);
+                acc = _mm512_add_epi64(acc, _mm512_mul_epi32(va, vb));
+                acc = _mm512_add_epi64(acc, _mm512_mul_epi32(_mm512_srli_epi64(va, 32),
+                                                             _mm512_srli_epi64(vb, 32)));
+            }
+            FINISH_INT_DOT(int32_t, avx512_sum_epi64(acc));
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    dot_scalar(a, b, length, type, result);
+}
+
+// Comparison masks; the predicate must be an immediate, hence the switches
+static inline GOO_TARGET_AVX512 __mmask16 avx512_cmp_ps(GooVectorCompareOp cmp, __m512 a, __m512 b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+        case GOO_VEC_CMP_NE: return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ);
+        case GOO_VEC_CMP_LT: return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+        case GOO_VEC_CMP_LE: return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);
+        case GOO_VEC_CMP_GT: return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+        default:             return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ);
+    }
+}
+
+static inline GOO_TARGET_AVX512 __mmask8 avx512_cmp_pd(GooVectorCompareOp cmp, __m512d a, __m512d b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+        case GOO_VEC_CMP_NE: return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ);
+        case GOO_VEC_CMP_LT: return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+        case GOO_VEC_CMP_LE: return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);
+        case GOO_VEC_CMP_GT: return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+        default:             return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ);
+    }
+}
+
+static inline GOO_TARGET_AVX512 __mmask32 avx512_cmp_epi16(GooVectorCompareOp cmp, __m512i a, __m512i b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm512_cmpeq_epi16_mask(a, b);
+        case GOO_VEC_CMP_NE: return _mm512_cmpneq_epi16_mask(a, b);
+        case GOO_VEC_CMP_LT: return _mm512_cmplt_epi16_mask(a, b);
+        case GOO_VEC_CMP_LE: return _mm512_cmple_epi16_mask(a, b);
+        case GOO_VEC_CMP_GT: return _mm512_cmpgt_epi16_mask(a, b);
+        default:             return _mm512_cmpge_epi16_mask(a, b);
+    }
+}
+
+static inline GOO_TARGET_AVX512 __mmask16 avx512_cmp_epi32(GooVectorCompareOp cmp, __m512i a, __m512i b) {
+    switch (cmp) {
+        case GOO_VEC_CMP_EQ: return _mm512_cmpeq_epi32_mask(a, b);
+        case GOO_VEC_CMP_NE: return _mm512_cmpneq_epi32_mask(a, b);
+        case GOO_VEC_CMP_LT: return _mm512_cmplt_epi32_mask(a, b);
+        case GOO_VEC_CMP_LE: return _mm512_cmple_epi32_mask(a, b);
+        case GOO_VEC_CMP_GT: return _mm512_cmpgt_epi32_mask(a, b);
+        default:             return _mm512_cmpge_epi32_mask(a, b);
+    }
+}
+
+static GOO_TARGET_AVX512 void compare_avx512(GooVectorCompareOp cmp, const void* a, const void* b,
+                                             size_t length, GooVectorDataType type, void* mask) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            __m512 truth = _mm512_set1_ps(-1.0f);
+            for (; i + 16 <= length; i += 16) {
+                __mmask16 k = avx512_cmp_ps(cmp, avx512_load_ps((const float*)a + i), avx512_load_ps((const float*)b + i));
+                avx512_store_ps((float*)mask + i, _mm512_maskz_mov_ps(k, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            __m512d truth = _mm512_set1_pd(-1.0);
+            for (; i + 8 <= length; i += 8) {
+                __mmask8 k = avx512_cmp_pd(cmp, avx512_load_pd((const double*)a + i), avx512_load_pd((const double*)b + i));
+                avx512_store_pd((double*)mask + i, _mm512_maskz_mov_pd(k, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_INT16:
+            for (; i + 32 <= length; i += 32) {
+                __mmask32 k = avx512_cmp_epi16(cmp, avx512_load((const int16_t*)a + i), avx512_load((const int16_t*)b + i));
+                avx512_store((int16_t*)mask + i, _mm512_movm_epi16(k));
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            for (; i + 16 <= length; i += 16) {
+                __mmask16 k = avx512_cmp_epi32(cmp, avx512_load((const int32_t*)a + i), avx512_load((const int32_t*)b + i));
+                avx512_store((int32_t*)mask + i, _mm512_maskz_mov_epi32(k, _mm512_set1_epi32(-1)));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    compare_scalar_range(cmp, a, b, i, length, type, mask);
+}
+
+static GOO_TARGET_AVX512 void blend_avx512(const void* a, const void* b, const void* mask, void* dst,
+                                           size_t length, size_t elem_size) {
+    size_t lanes = 64 / elem_size;
+    size_t i = 0;
+
+    for (; i + lanes <= length; i += lanes) {
+        size_t offset = i * elem_size;
+        __m512i m = avx512_load((const char*)mask + offset);
+        __m512i va = avx512_load((const char*)a + offset);
+        __m512i vb = avx512_load((const char*)b + offset);
+        __m512i r;
+        switch (elem_size) {
+            case 1: r = _mm512_mask_blend_epi8(_mm512_test_epi8_mask(m, m), va, vb); break;
+            case 2: r = _mm512_mask_blend_epi16(_mm512_test_epi16_mask(m, m), va, vb); break;
+            case 4: r = _mm512_mask_blend_epi32(_mm512_test_epi32_mask(m, m), va, vb); break;
+            default: r = _mm512_mask_blend_epi64(_mm512_test_epi64_mask(m, m), va, vb); break;
+        }
+        avx512_store((char*)dst + offset, r);
+    }
+
+    blend_scalar_range(a, b, mask, dst, i, length, elem_size);
+}
+
+static GOO_TARGET_AVX512 void gather_avx512(const void* base, const int32_t* indices, size_t length,
+                                            size_t elem_size, void* dst) {
+    size_t i = 0;
+
+    if (elem_size == 4) {
+        for (; i + 16 <= length; i += 16) {
+            __m512i idx = avx512_load(indices + i);
+            avx512_store((int32_t*)dst + i, _mm512_i32gather_epi32(idx, base, 4));
+        }
+    } else if (elem_size == 8) {
+        for (; i + 8 <= length; i += 8) {
+            __m256i idx = _mm256_loadu_si256((const __m256i*)(indices + i));
+            avx512_store((int64_t*)dst + i, _mm512_i32gather_epi64(idx, base, 8));
+        }
+    }
+
+    gather_scalar_range(base, indices, i, length, elem_size, dst);
+}
+
+// Scatters write lanes in order, so duplicate indices keep the last value
+static GOO_TARGET_AVX512 void scatter_avx512(const void* src, const int32_t* indices, size_t length,
+                                             size_t elem_size, void* base) {
+    size_t i = 0;
+
+    if (elem_size == 4) {
+        for (; i + 16 <= length; i += 16) {
+            __m512i idx = avx512_load(indices + i);
+            _mm512_i32scatter_epi32(base, idx, avx512_load((const int32_t*)src + i), 4);
+        }
+    } else if (elem_size == 8) {
+        for (; i + 8 <= length; i += 8) {
+            __m256i idx = _mm256_loadu_si256((const __m256i*)(indices + i));
+            _mm512_i32scatter_epi64(base, idx, avx512_load((const int64_t*)src + i), 8);
+        }
+    }
+
+    scatter_scalar_range(src, indices, i, length, elem_size, base);
+}
+
+static const GooVectorKernels avx512_kernels = {
+    .elementwise = vector_op_avx512,
+    .reduce = reduce_avx512,
+    .dot = dot_avx512,
+    .compare = compare_avx512,
+    .blend = blend_avx512,
+    .gather = gather_avx512,
+    .scatter = scatter_avx512,
+};
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+/*
+ * AArch64 Advanced SIMD kernels. Floating point and saturating integer
+ * add/sub run in 128-bit vectors; integer multiply and divide and the
+ * guarded float divide use the scalar path.
+ */
+// vfmaq takes the addend first; SIMD_FMA_LOOP expects KERNEL(a, b, c) = a * b + c
+static inline float32x4_t neon_fma_f32(float32x4_t a, float32x4_t b, float32x4_t c) { return vfmaq_f32(c, a, b); }
+static inline float64x2_t neon_fma_f64(float64x2_t a, float64x2_t b, float64x2_t c) { return vfmaq_f64(c, a, b); }
+
+#define NEON_SAT_CASE(TYPE, T, VT, LANES, SUFFIX)                           \
+    case TYPE:                                                              \
+        if (op == GOO_VECTOR_ADD) {                                         \
+            SIMD_BINARY_LOOP(T, VT, LANES, vld1q_##SUFFIX, vst1q_##SUFFIX, vqaddq_##SUFFIX); \
+        } else if (op == GOO_VECTOR_SUB) {                                  \
+            SIMD_BINARY_LOOP(T, VT, LANES, vld1q_##SUFFIX, vst1q_##SUFFIX, vqsubq_##SUFFIX); \
+        }                                                                   \
+        break;
+
+static bool vector_op_neon(GooVectorOp op, void* src1, void* src2, void* dst,
+                           size_t elem_size, size_t length, GooVectorDataType type) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(float, float32x4_t, 4, vld1q_f32, vst1q_f32, vaddq_f32); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(float, float32x4_t, 4, vld1q_f32, vst1q_f32, vsubq_f32); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(float, float32x4_t, 4, vld1q_f32, vst1q_f32, vmulq_f32); break;
+                case GOO_VECTOR_FMA: SIMD_FMA_LOOP(float, float32x4_t, 4, vld1q_f32, vst1q_f32, neon_fma_f32); break;
+                default: break;
+            }
+            break;
+
+        case GOO_VEC_DOUBLE:
+            switch (op) {
+                case GOO_VECTOR_ADD: SIMD_BINARY_LOOP(double, float64x2_t, 2, vld1q_f64, vst1q_f64, vaddq_f64); break;
+                case GOO_VECTOR_SUB: SIMD_BINARY_LOOP(double, float64x2_t, 2, vld1q_f64, vst1q_f64, vsubq_f64); break;
+                case GOO_VECTOR_MUL: SIMD_BINARY_LOOP(double, float64x2_t, 2, vld1q_f64, vst1q_f64, vmulq_f64); break;
+                case GOO_VECTOR_FMA: SIMD_FMA_LOOP(double, float64x2_t, 2, vld1q_f64, vst1q_f64, neon_fma_f64); break;
+                default: break;
+            }
+            break;
+
+        NEON_SAT_CASE(GOO_VEC_INT8, int8_t, int8x16_t, 16, s8)
+        NEON_SAT_CASE(GOO_VEC_UINT8, uint8_t, uint8x16_t, 16, u8)
+        NEON_SAT_CASE(GOO_VEC_INT16, int16_t, int16x8_t, 8, s16)
+        NEON_SAT_CASE(GOO_VEC_UINT16, uint16_t, uint16x8_t, 8, u16)
+        NEON_SAT_CASE(GOO_VEC_INT32, int32_t, int32x4_t, 4, s32)
+        NEON_SAT_CASE(GOO_VEC_UINT32, uint32_t, uint32x4_t, 4, u32)
+        NEON_SAT_CASE(GOO_VEC_INT64, int64_t, int64x2_t, 2, s64)
+        NEON_SAT_CASE(GOO_VEC_UINT64, uint64_t, uint64x2_t, 2, u64)
+
+        default:
+            break;
+    }
+
+    if (i == length) return true;
+    return vector_op_scalar_range(op, src1, src2, dst, elem_size, i, length, type);
+}
+
+static void reduce_neon(GooVectorReduceOp op, const void* src, size_t length,
+                        GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            if (length < 4) break;
+            const float* s = (const float*)src;
+            float32x4_t acc = vdupq_n_f32(REDUCE_START(op));
+            for (i = 0; i + 4 <= length; i += 4) {
+                float32x4_t v = vld1q_f32(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = vaddq_f32(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = vminnmq_f32(acc, v);
+                else acc = vmaxnmq_f32(acc, v);
+            }
+            float lanes[4];
+            vst1q_f32(lanes, acc);
+            FINISH_FLOAT_REDUCE(float, lanes, 4);
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            if (length < 2) break;
+            const double* s = (const double*)src;
+            float64x2_t acc = vdupq_n_f64(REDUCE_START(op));
+            for (i = 0; i + 2 <= length; i += 2) {
+                float64x2_t v = vld1q_f64(s + i);
+                if (op == GOO_VEC_REDUCE_SUM) acc = vaddq_f64(acc, v);
+                else if (op == GOO_VEC_REDUCE_MIN) acc = vminnmq_f64(acc, v);
+                else acc = vmaxnmq_f64(acc, v);
+            }
+            double lanes[2];
+            vst1q_f64(lanes, acc);
+            FINISH_FLOAT_REDUCE(double, lanes, 2);
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            if (length < 8) break;
+            const int16_t* s = (const int16_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                // Pairwise widening adds: each int32 lane grows by at most 2^16 per step
+                int32x4_t acc = vdupq_n_s32(0);
+                int64_t total = 0;
+                size_t pending = 0;
+                for (; i + 8 <= length; i += 8) {
+                    acc = vpadalq_s16(acc, vld1q_s16(s + i));
+                    if (++pending == MADD_FLUSH_INTERVAL) {
+                        total += vaddlvq_s32(acc);
+                        acc = vdupq_n_s32(0);
+                        pending = 0;
+                    }
+                }
+                total += vaddlvq_s32(acc);
+                FINISH_INT_SUM(int16_t, total);
+                return;
+            }
+            int16x8_t acc = vld1q_s16(s);
+            for (i = 8; i + 8 <= length; i += 8) {
+                int16x8_t v = vld1q_s16(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? vminq_s16(acc, v) : vmaxq_s16(acc, v);
+            }
+            int16_t lanes[1] = { op == GOO_VEC_REDUCE_MIN ? vminvq_s16(acc) : vmaxvq_s16(acc) };
+            FINISH_INT_MINMAX(int16_t, lanes, 1);
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            if (length < 4) break;
+            const int32_t* s = (const int32_t*)src;
+            if (op == GOO_VEC_REDUCE_SUM) {
+                int64x2_t acc = vdupq_n_s64(0);
+                for (; i + 4 <= length; i += 4) {
+                    acc = vpadalq_s32(acc, vld1q_s32(s + i));
+                }
+                FINISH_INT_SUM(int32_t, vaddvq_s64(acc));
+                return;
+            }
+            int32x4_t acc = vld1q_s32(s);
+            for (i = 4; i + 4 <= length; i += 4) {
+                int32x4_t v = vld1q_s32(s + i);
+                acc = op == GOO_VEC_REDUCE_MIN ? vminq_s32(acc, v) : vmaxq_s32(acc, v);
+            }
+            int32_t lanes[1] = { op == GOO_VEC_REDUCE_MIN ? vminvq_s32(acc) : vmaxvq_s32(acc) };
+            FINISH_INT_MINMAX(int32_t, lanes, 1);
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    reduce_scalar(op, src, length, type, result);
+}
+
+static void dot_neon(const void* a, const void* b, size_t length,
+                     GooVectorDataType type, void* result) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            const float* x = (const float*)a;
+            const float* y = (const float*)b;
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (; i + 4 <= length; i += 4) {
+                acc = vfmaq_f32(acc, vld1q_f32(x + i), vld1q_f32(y + i));
+            }
+            FINISH_FLOAT_DOT(float, vaddvq_f32(acc));
+            return;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            const double* x = (const double*)a;
+            const double* y = (const double*)b;
+            float64x2_t acc = vdupq_n_f64(0.0);
+            for (; i + 2 <= length; i += 2) {
+                acc = vfmaq_f64(acc, vld1q_f64(x + i), vld1q_f64(y + i));
+            }
+            FINISH_FLOAT_DOT(double, vaddvq_f64(acc));
+            return;
+        }
+
+        case GOO_VEC_INT16: {
+            // Widening multiplies are exact in int32; accumulate pairwise into int64
+            const int16_t* x = (const int16_t*)a;
+            const int16_t* y = (const int16_t*)b;
+            int64x2_t acc = vdupq_n_s64(0);
+            for (; i + 8 <= length; i += 8) {
+                int16x8_t va = vld1q_s16(x + i);
+                int16x8_t vb = vld1q_s16(y + i);
+                acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(va), vget_low_s16(vb)));
+                acc = vpadalq_s32(acc, vmull_high_s16(va, vb));
+            }
+            FINISH_INT_DOT(int16_t, vaddvq_s64(acc));
+            return;
+        }
+
+        case GOO_VEC_INT32: {
+            // Products of int32 fit int64; wrapping adds give the sum modulo 2^64
+            const int32_t* x = (const int32_t*)a;
+            const int32_t* y = (const int32_t*)b;
+            uint64x2_t acc = vdupq_n_u64(0);
+            for (; i + 4 <= length; i += 4) {
+                int32x4_t va = vld1q_s32(x + i);
+                int32x4_t vb = vld1q_s32(y + i);
+                acc = vaddq_u64(acc, vreinterpretq_u64_s64(vmull_s32(vget_low_s32(va), vget_low_s32(vb))));
+                acc = vaddq_u64(acc, vreinterpretq_u64_s64(vmull_high_s32(va, vb)));
+            }
+            FINISH_INT_DOT(int32_t, vaddvq_u64(acc));
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    dot_scalar(a, b, length, type, result);
+}
+
+#define NEON_CMP_SWITCH(SUFFIX, MVN)                                        \
+    switch (cmp) {                                                          \
+        case GOO_VEC_CMP_EQ: return vceqq_##SUFFIX(a, b);                   \
+        case GOO_VEC_CMP_NE: return MVN(vceqq_##SUFFIX(a, b));              \
+        case GOO_VEC_CMP_LT: return vcltq_##SUFFIX(a, b);                   \
+        case GOO_VEC_CMP_LE: return vcleq_##SUFFIX(a, b);                   \
+        case GOO_VEC_CMP_GT: return vcgtq_##SUFFIX(a, b);                   \
+        default:             return vcgeq_##SUFFIX(a, b);                   \
+    }
+
+static inline uint64x2_t neon_mvn_u64(uint64x2_t v) {
+    return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(v)));
+}
+
+static inline uint32x4_t neon_cmp_f32(GooVectorCompareOp cmp, float32x4_t a, float32x4_t b) { NEON_CMP_SWITCH(f32, vmvnq_u32) }
+static inline uint64x2_t neon_cmp_f64(GooVectorCompareOp cmp, float64x2_t a, float64x2_t b) { NEON_CMP_SWITCH(f64, neon_mvn_u64) }
+static inline uint16x8_t neon_cmp_s16(GooVectorCompareOp cmp, int16x8_t a, int16x8_t b) { NEON_CMP_SWITCH(s16, vmvnq_u16) }
+static inline uint32x4_t neon_cmp_s32(GooVectorCompareOp cmp, int32x4_t a, int32x4_t b) { NEON_CMP_SWITCH(s32, vmvnq_u32) }
+
+static void compare_neon(GooVectorCompareOp cmp, const void* a, const void* b,
+                         size_t length, GooVectorDataType type, void* mask) {
+    size_t i = 0;
+
+    switch (type) {
+        case GOO_VEC_FLOAT: {
+            uint32x4_t truth = vreinterpretq_u32_f32(vdupq_n_f32(-1.0f));
+            for (; i + 4 <= length; i += 4) {
+                uint32x4_t m = neon_cmp_f32(cmp, vld1q_f32((const float*)a + i), vld1q_f32((const float*)b + i));
+                vst1q_u32((uint32_t*)mask + i, vandq_u32(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_DOUBLE: {
+            uint64x2_t truth = vreinterpretq_u64_f64(vdupq_n_f64(-1.0));
+            for (; i + 2 <= length; i += 2) {
+                uint64x2_t m = neon_cmp_f64(cmp, vld1q_f64((const double*)a + i), vld1q_f64((const double*)b + i));
+                vst1q_u64((uint64_t*)mask + i, vandq_u64(m, truth));
+            }
+            break;
+        }
+
+        case GOO_VEC_INT16:
+            for (; i + 8 <= length; i += 8) {
+                vst1q_u16((uint16_t*)mask + i,
+                          neon_cmp_s16(cmp, vld1q_s16((const int16_t*)a + i), vld1q_s16((const int16_t*)b + i)));
+            }
+            break;
+
+        case GOO_VEC_INT32:
+            for (; i + 4 <= length; i += 4) {
+                vst1q_u32((uint32_t*)mask + i,
+                          neon_cmp_s32(cmp, vld1q_s32((const int32_t*)a + i), vld1q_s32((const int32_t*)b + i)));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    compare_scalar_range(cmp, a, b, i, length, type, mask);
+}
+
+// All-ones in each element of the given size whose mask element is nonzero
+static inline uint8x16_t neon_mask_is_set(uint8x16_t m, size_t elem_size) {
+    switch (elem_size) {
+        case 1: return vtstq_u8(m, m);
+        case 2: {
+            uint16x8_t w = vreinterpretq_u16_u8(m);
+            return vreinterpretq_u8_u16(vtstq_u16(w, w));
+        }
+        case 4: {
+            uint32x4_t w = vreinterpretq_u32_u8(m);
+            return vreinterpretq_u8_u32(vtstq_u32(w, w));
+        }
+        default: {
+            uint64x2_t w = vreinterpretq_u64_u8(m);
+            return vreinterpretq_u8_u64(vtstq_u64(w, w));
+        }
+    }
+}
+
+static void blend_neon(const void* a, const void* b, const void* mask, void* dst,
+                       size_t length, size_t elem_size) {
+    size_t lanes = 16 / elem_size;
+    size_t i = 0;
+
+    for (; i + lanes <= length; i += lanes) {
+        size_t offset = i * elem_size;
+        uint8x16_t take = neon_mask_is_set(vld1q_u8((const uint8_t*)mask + offset), elem_size);
+        uint8x16_t va = vld1q_u8((const uint8_t*)a + offset);
+        uint8x16_t vb = vld1q_u8((const uint8_t*)b + offset);
+        vst1q_u8((uint8_t*)dst + offset, vbslq_u8(take, vb, va));
+    }
+
+    blend_scalar_range(a, b, mask, dst, i, length, elem_size);
+}
+
+// Advanced SIMD has no gather or scatter
+static const GooVectorKernels neon_kernels = {
+    .elementwise = vector_op_neon,
+    .reduce = reduce_neon,
+    .dot = dot_neon,
+    .compare = compare_neon,
+    .blend = blend_neon,
+    .gather = gather_scalar,
+    .scatter = scatter_scalar,
+};
+#endif
+
+#if defined(GOO_USE_ZIG_KERNELS)
+// @Vector kernels from zig/vectorization.zig, compiled for the build target
+extern bool goo_zig_vector_elementwise(GooVectorOp op, void* src1, void* src2, void* dst,
+                                       size_t elem_size, size_t length, GooVectorDataType type);
+extern void goo_zig_vector_reduce(GooVectorReduceOp op, const void* src, size_t length,
+                                  GooVectorDataType type, void* result);
+extern void goo_zig_vector_compare(GooVectorCompareOp cmp, const void* a, const void* b,
+                                   size_t length, GooVectorDataType type, void* mask);
+
+static GooVectorKernels zig_kernels;
+#endif
+
+// Widest kernels for a SIMD type the host is known to support
+static const GooVectorKernels* select_kernels(GooSIMDType simd_type) {
+    switch (simd_type) {
+        #if defined(GOO_VEC_X86_DISPATCH)
+        case GOO_SIMD_AVX512:
+            return &avx512_kernels;
+        case GOO_SIMD_AVX2:
+            return &avx2_kernels;
+        case GOO_SIMD_SSE2:
+        case GOO_SIMD_SSE4:
+        case GOO_SIMD_AVX:
+            return &sse2_kernels;
+        #endif
+        
+        #if defined(__aarch64__) && defined(__ARM_NEON)
+        case GOO_SIMD_NEON:
+            return &neon_kernels;
+        #endif
+        
+        default:
+            return &scalar_kernels;
+    }
+}
+
+// Fill the kernel table: each requested type runs the best kernels that are
+// no wider than the request and supported by the host
+static void resolve_kernels(void) {
+    detected_simd_type = detect_cpu_features();
+    
+    for (int type = GOO_SIMD_AUTO; type <= GOO_SIMD_NEON; type++) {
+        GooSIMDType usable = (GooSIMDType)type;
+        if (usable == GOO_SIMD_AUTO || usable > detected_simd_type) {
+            usable = detected_simd_type;
+        }
+        vector_kernels[type] = select_kernels(usable);
+    }
+
+#if defined(GOO_USE_ZIG_KERNELS)
+    // The Zig kernels run at the build target's width, so they only replace
+    // the host's best level; narrower explicit requests keep the C kernels
+    if (detected_simd_type != GOO_SIMD_SCALAR) {
+        zig_kernels = *select_kernels(detected_simd_type);
+        zig_kernels.elementwise = goo_zig_vector_elementwise;
+        zig_kernels.reduce = goo_zig_vector_reduce;
+        zig_kernels.compare = goo_zig_vector_compare;
+
+        for (int type = GOO_SIMD_AUTO; type <= GOO_SIMD_NEON; type++) {
+            if (vector_kernels[type] == select_kernels(detected_simd_type)) {
+                vector_kernels[type] = &zig_kernels;
+            }
+        }
+    }
+#endif
+}
+
+// Kernel set for a requested SIMD type
+static const GooVectorKernels* kernels_for(GooSIMDType simd_type) {
+    pthread_once(&kernels_once, resolve_kernels);
+    
+    if ((unsigned)simd_type > GOO_SIMD_NEON) {
+        simd_type = GOO_SIMD_SCALAR;
+    }
+    
+    return vector_kernels[simd_type];
+}
+
+// Dispatch through the kernel table
+static bool vector_op_dispatch(GooVectorOp op, void* src1, void* src2, void* dst, 
+                             size_t elem_size, size_t length, GooVectorDataType type,
+                             GooSIMDType simd_type) {
+    return kernels_for(simd_type)->elementwise(op, src1, src2, dst, elem_size, length, type);
+}
+
+// Scratch space for masked operations, processed one chunk at a time
+#define MASKED_CHUNK_BYTES 4096
+
+// Compute a chunk into scratch space, then blend it into dst where the mask
+// is set. FMA reads its addend from dst, so the scratch starts as a copy
+static bool vector_op_masked(GooVectorOperation *op, GooSIMDType simd_type) {
+    GooVector *v = &op->base;
+    GooVectorMask *mask = op->mask;
+    size_t elem_size = element_size(op->data_type);
+    
+    if (elem_size == 0 || v->elem_size != elem_size) {
+        fprintf(stderr, "Error: Element size does not match the vector data type\n");
+        return false;
+    }
+    if (!mask->mask_data || element_size(mask->type) != elem_size ||
+        mask->mask_size / elem_size < v->length) {
+        fprintf(stderr, "Error: Vector mask does not cover the operation\n");
+        return false;
+    }
+    
+    const GooVectorKernels *kernels = kernels_for(simd_type);
+    _Alignas(64) unsigned char scratch[MASKED_CHUNK_BYTES];
+    size_t chunk = MASKED_CHUNK_BYTES / elem_size;
+    
+    for (size_t start = 0; start < v->length; start += chunk) {
+        size_t count = v->length - start < chunk ? v->length - start : chunk;
+        size_t offset = start * elem_size;
+        char *dst = (char*)v->dst + offset;
+        
+        if (v->op == GOO_VECTOR_FMA) {
+            memcpy(scratch, dst, count * elem_size);
+        }
+        if (!kernels->elementwise(v->op, (char*)v->src1 + offset,
+                                  v->src2 ? (char*)v->src2 + offset : NULL,
+                                  scratch, elem_size, count, op->data_type)) {
+            return false;
+        }
+        kernels->blend(dst, scratch, (char*)mask->mask_data + offset, dst, count, elem_size);
+    }
+    
+    return true;
+}
+
+/**
+ * Execute a vector operation using SIMD instructions
+ */
+bool goo_vectorization_execute(GooVectorOperation *op) {
+    if (!op || !op->base.src1 || !op->base.dst) {
+        return false;
+    }
+    
+    // Use the selected SIMD type or the current default
+    GooSIMDType simd_type = op->simd_type;
+    if (simd_type == GOO_SIMD_AUTO) {
+        simd_type = current_simd_type;
+    }
+    
+    if (op->mask) {
+        return vector_op_masked(op, simd_type);
+    }
+    
+    // Dispatch the operation to the appropriate implementation
+    return vector_op_dispatch(
+        op->base.op,
+        op->base.src1,
         op->base.src2,
         op->base.dst,
         op->base.elem_size,
@@ -954,7 +3928,231 @@ bool goo_vectorization_execute(GooVectorOperation *op) {
 }
 
 /**
- * Apply a vector operation to loop iterations
+ * Reduce a vector to a single value
+ */
+bool goo_vectorization_reduce(GooVectorReduceOp op, const void *src, size_t length,
+                              GooVectorDataType type, void *result) {
+    if (!src || !result || length == 0) {
+        fprintf(stderr, "Error: Invalid arguments to vector reduction\n");
+        return false;
+    }
+    if (element_size(type) == 0 || (unsigned)op > GOO_VEC_REDUCE_MAX) {
+        fprintf(stderr, "Error: Unsupported vector reduction\n");
+        return false;
+    }
+    
+    kernels_for(current_simd_type)->reduce(op, src, length, type, result);
+    return true;
+}
+
+/**
+ * Dot product of two vectors
+ */
+bool goo_vectorization_dot(const void *a, const void *b, size_t length,
+                           GooVectorDataType type, void *result) {
+    if (!a || !b || !result) {
+        fprintf(stderr, "Error: Invalid arguments to vector dot product\n");
+        return false;
+    }
+    if (element_size(type) == 0) {
+        fprintf(stderr, "Error: Unsupported data type for vector dot product\n");
+        return false;
+    }
+    
+    kernels_for(current_simd_type)->dot(a, b, length, type, result);
+    return true;
+}
+
+/**
+ * Compare two vectors elementwise into a mask
+ */
+bool goo_vectorization_compare(GooVectorCompareOp cmp, const void *a, const void *b,
+                               size_t length, GooVectorDataType type, GooVectorMask *mask) {
+    size_t elem_size = element_size(type);
+    
+    if (!a || !b || !mask || !mask->mask_data) {
+        fprintf(stderr, "Error: Invalid arguments to vector compare\n");
+        return false;
+    }
+    if (elem_size == 0 || (unsigned)cmp > GOO_VEC_CMP_GE) {
+        fprintf(stderr, "Error: Unsupported vector comparison\n");
+        return false;
+    }
+    if (element_size(mask->type) != elem_size || mask->mask_size / elem_size < length) {
+        fprintf(stderr, "Error: Vector mask does not cover the comparison\n");
+        return false;
+    }
+    
+    kernels_for(current_simd_type)->compare(cmp, a, b, length, type, mask->mask_data);
+    return true;
+}
+
+/**
+ * Select elements from two vectors under a mask
+ */
+bool goo_vectorization_blend(const void *a, const void *b, const GooVectorMask *mask,
+                             void *dst, size_t length, GooVectorDataType type) {
+    size_t elem_size = element_size(type);
+    
+    if (!a || !b || !dst || !mask || !mask->mask_data) {
+        fprintf(stderr, "Error: Invalid arguments to vector blend\n");
+        return false;
+    }
+    if (elem_size == 0) {
+        fprintf(stderr, "Error: Unsupported data type for vector blend\n");
+        return false;
+    }
+    if (element_size(mask->type) != elem_size || mask->mask_size / elem_size < length) {
+        fprintf(stderr, "Error: Vector mask does not cover the blend\n");
+        return false;
+    }
+    
+    kernels_for(current_simd_type)->blend(a, b, mask->mask_data, dst, length, elem_size);
+    return true;
+}
+
+// Check every index against [0, base_length) with two reductions
+static bool indices_in_bounds(const GooVectorKernels *kernels, const int32_t *indices,
+                              size_t length, size_t base_length) {
+    int32_t lowest, highest;
+    kernels->reduce(GOO_VEC_REDUCE_MIN, indices, length, GOO_VEC_INT32, &lowest);
+    kernels->reduce(GOO_VEC_REDUCE_MAX, indices, length, GOO_VEC_INT32, &highest);
+    return lowest >= 0 && (size_t)highest < base_length;
+}
+
+/**
+ * Load elements from arbitrary indices
+ */
+bool goo_vectorization_gather(const void *base, size_t base_length, const int32_t *indices,
+                              size_t length, GooVectorDataType type, void *dst) {
+    size_t elem_size = element_size(type);
+    
+    if (!base || !indices || !dst || elem_size == 0) {
+        fprintf(stderr, "Error: Invalid arguments to vector gather\n");
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    
+    const GooVectorKernels *kernels = kernels_for(current_simd_type);
+    if (!indices_in_bounds(kernels, indices, length, base_length)) {
+        fprintf(stderr, "Error: Gather index out of bounds\n");
+        return false;
+    }
+    
+    kernels->gather(base, indices, length, elem_size, dst);
+    return true;
+}
+
+/**
+ * Store elements to arbitrary indices
+ */
+bool goo_vectorization_scatter(const void *src, const int32_t *indices, size_t length,
+                               GooVectorDataType type, void *base, size_t base_length) {
+    size_t elem_size = element_size(type);
+    
+    if (!src || !indices || !base || elem_size == 0) {
+        fprintf(stderr, "Error: Invalid arguments to vector scatter\n");
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    
+    // Validate everything first so a bad index leaves base untouched
+    const GooVectorKernels *kernels = kernels_for(current_simd_type);
+    if (!indices_in_bounds(kernels, indices, length, base_length)) {
+        fprintf(stderr, "Error: Scatter index out of bounds\n");
+        return false;
+    }
+    
+    kernels->scatter(src, indices, length, elem_size, base);
+    return true;
+}
+
+// Worker pool block loop from goo_parallel.c. goo_parallel.h cannot be
+// included here: it has its own GooVector and GooParallelLoop
+bool goo_parallel_for_chunks(uint64_t start, uint64_t end, uint64_t grain,
+                             void (*body)(uint64_t, uint64_t, void*), void *context,
+                             int num_threads);
+
+// Bytes one block touches across all of its buffers; sized to stay in L2
+#define VECTOR_BLOCK_BYTES (256 * 1024)
+
+// Ranges touching fewer bytes run on the calling thread
+#define VECTOR_PARALLEL_MIN_BYTES (1024 * 1024)
+
+// Shared state of a blocked vector operation
+typedef struct {
+    const GooVectorOperation *op;   // Operation over the whole buffers
+    _Atomic bool failed;            // Set by any block that fails
+} VectorBlockLoop;
+
+// Run the operation on elements [begin, end) of its buffers
+static bool vector_execute_range(const GooVectorOperation *op, size_t begin, size_t end) {
+    GooVectorOperation block = *op;
+    GooVectorMask mask;
+    size_t offset = begin * op->base.elem_size;
+    
+    block.base.src1 = (char*)op->base.src1 + offset;
+    block.base.src2 = op->base.src2 ? (char*)op->base.src2 + offset : NULL;
+    block.base.dst = (char*)op->base.dst + offset;
+    block.base.length = end - begin;
+    if (op->mask) {
+        mask = *op->mask;
+        mask.mask_data = (char*)mask.mask_data + offset;
+        mask.mask_size -= offset;
+        block.mask = &mask;
+    }
+    
+    return goo_vectorization_execute(&block);
+}
+
+static void vector_block_body(uint64_t begin, uint64_t end, void *arg) {
+    VectorBlockLoop *loop = (VectorBlockLoop*)arg;
+    if (!vector_execute_range(loop->op, (size_t)begin, (size_t)end)) {
+        atomic_store_explicit(&loop->failed, true, memory_order_relaxed);
+    }
+}
+
+// Split [start, end) into blocks of whole, aligned vectors and run them on
+// the worker pool. block_elems of 0 sizes blocks to VECTOR_BLOCK_BYTES
+static bool vector_execute_blocks(const GooVectorOperation *op, size_t start, size_t end,
+                                  size_t block_elems, int num_threads) {
+    size_t elem_size = op->base.elem_size;
+    size_t buffers = op->base.src2 ? 3 : 2;
+    
+    if ((end - start) * elem_size * buffers < VECTOR_PARALLEL_MIN_BYTES) {
+        return vector_execute_range(op, start, end);
+    }
+    
+    // Whole vectors at the widest alignment keep every block start aligned
+    // whenever the buffers are
+    GooSIMDType simd_type = op->simd_type == GOO_SIMD_AUTO ? current_simd_type : op->simd_type;
+    size_t lanes = goo_vectorization_get_alignment(simd_type) / elem_size;
+    if (lanes < goo_vectorization_get_width(op->data_type, simd_type)) {
+        lanes = goo_vectorization_get_width(op->data_type, simd_type);
+    }
+    if (lanes == 0) {
+        lanes = 1;
+    }
+    if (block_elems == 0) {
+        block_elems = VECTOR_BLOCK_BYTES / (elem_size * buffers);
+    }
+    block_elems = (block_elems + lanes - 1) / lanes * lanes;
+    
+    VectorBlockLoop loop = { .op = op };
+    atomic_init(&loop.failed, false);
+    if (!goo_parallel_for_chunks(start, end, block_elems, vector_block_body, &loop,
+                                 num_threads)) {
+        return false;
+    }
+    return !atomic_load_explicit(&loop.failed, memory_order_relaxed);
+}
+
+/**
+ * Run a vectorizable loop body over the worker pool
  */
 bool goo_vectorization_apply_to_loop(GooParallelLoop *loop, 
                                    GooVectorDataType data_type,
@@ -963,20 +4161,39 @@ bool goo_vectorization_apply_to_loop(GooParallelLoop *loop,
         return false;
     }
     
-    // Use the selected SIMD type or the current default
-    if (simd_type == GOO_SIMD_AUTO) {
-        simd_type = current_simd_type;
+    GooVectorOperation *body = loop->vector_body;
+    if (!body || !body->base.src1 || !body->base.dst) {
+        fprintf(stderr, "Error: Loop has no vectorizable body\n");
+        return false;
+    }
+    if (loop->step != 1) {
+        fprintf(stderr, "Error: Vectorized loops require a unit step\n");
+        return false;
+    }
+    if (element_size(data_type) == 0 || body->base.elem_size != element_size(data_type)) {
+        fprintf(stderr, "Error: Element size does not match the vector data type\n");
+        return false;
+    }
+    if (loop->end > body->base.length) {
+        fprintf(stderr, "Error: Loop range exceeds the vector buffers\n");
+        return false;
+    }
+    if (body->mask && body->mask->mask_size / body->base.elem_size < loop->end) {
+        fprintf(stderr, "Error: Vector mask does not cover the loop range\n");
+        return false;
+    }
+    if (loop->start >= loop->end) {
+        return true;
     }
     
-    // Mark the data_type as used to avoid compiler warnings
-    (void)data_type;
-    
-    // We need a custom body function to call the original with vectorized operations
-    // This will be a placeholder for now - actual implementation would be more complex
-    // and would need to analyze the loop body to determine if vectorization is possible
+    // Use the selected SIMD type or the current default
+    GooVectorOperation op = *body;
+    op.data_type = data_type;
+    op.simd_type = simd_type == GOO_SIMD_AUTO ? current_simd_type : simd_type;
     
-    // For now, just set the vectorize flag to indicate it's been processed
-    return true;
+    return vector_execute_blocks(&op, loop->start, loop->end,
+                                 loop->chunk_size > 0 ? (size_t)loop->chunk_size : 0,
+                                 loop->num_threads);
 }
 
 /**
@@ -1015,7 +4232,8 @@ bool goo_vector_execute(GooVector *vec_op) {
     if ((vec_op->op == GOO_VECTOR_ADD || 
          vec_op->op == GOO_VECTOR_SUB || 
          vec_op->op == GOO_VECTOR_MUL || 
-         vec_op->op == GOO_VECTOR_DIV) && 
+         vec_op->op == GOO_VECTOR_DIV || 
+         vec_op->op == GOO_VECTOR_FMA) && 
         !vec_op->src2) {
         fprintf(stderr, "Error: Binary vector operation missing second source buffer\n");
         return false;
@@ -1030,25 +4248,10 @@ bool goo_vector_execute(GooVector *vec_op) {
         .aligned = false // Will be set properly below
     };
     
-    // Check alignment of buffers for the current SIMD type
-    bool src1_aligned = goo_vectorization_is_aligned(vec_op->src1, current_simd_type);
-    bool dst_aligned = goo_vectorization_is_aligned(vec_op->dst, current_simd_type);
-    bool src2_aligned = vec_op->src2 ? goo_vectorization_is_aligned(vec_op->src2, current_simd_type) : true;
-    
-    op.aligned = src1_aligned && dst_aligned && src2_aligned;
-    
-    // Optional: Log alignment issues for debugging
-    if (!op.aligned && (current_simd_type != GOO_SIMD_SCALAR)) {
-        if (!src1_aligned) {
-            fprintf(stderr, "Warning: Source buffer 1 is not properly aligned for SIMD operations\n");
-        }
-        if (!dst_aligned) {
-            fprintf(stderr, "Warning: Destination buffer is not properly aligned for SIMD operations\n");
-        }
-        if (vec_op->src2 && !src2_aligned) {
-            fprintf(stderr, "Warning: Source buffer 2 is not properly aligned for SIMD operations\n");
-        }
-    }
+    // Kernels accept any alignment; the flag only records whether it was ideal
+    op.aligned = goo_vectorization_is_aligned(vec_op->src1, current_simd_type) &&
+                 goo_vectorization_is_aligned(vec_op->dst, current_simd_type) &&
+                 (!vec_op->src2 || goo_vectorization_is_aligned(vec_op->src2, current_simd_type));
     
     // Determine data type based on element size
     switch (vec_op->elem_size) {
@@ -1071,8 +4274,8 @@ bool goo_vector_execute(GooVector *vec_op) {
             break;
     }
     
-    // Execute the vector operation
-    bool result = goo_vectorization_execute(&op);
+    // Execute the vector operation, across the worker pool if it is large
+    bool result = vector_execute_blocks(&op, 0, vec_op->length, 0, 0);
     
     if (!result) {
         fprintf(stderr, "Error: Vector operation execution failed\n");
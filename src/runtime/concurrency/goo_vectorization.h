@@ -43,6 +43,7 @@ typedef struct {
     GooScheduleType schedule; // Scheduling strategy
     int chunk_size;      // Chunk size for work distribution
     int num_threads;     // Number of threads
+    struct GooVectorOperation *vector_body; // Vectorizable body: iteration i computes element i
 } GooParallelLoop;
 
 typedef struct GooVectorMask {
@@ -56,9 +57,26 @@ typedef struct GooVectorOperation {
     GooSIMDType simd_type;    // SIMD instruction set to use
     GooVectorDataType data_type; // Data type of vector elements
     GooVectorMask *mask;      // Optional mask for masked operations
-    bool aligned;             // Whether data is aligned for SIMD
+    bool aligned;             // Whether data is aligned for SIMD (informational; any element-aligned address works)
 } GooVectorOperation;
 
+// Horizontal reductions
+typedef enum {
+    GOO_VEC_REDUCE_SUM,  // Sum of all elements
+    GOO_VEC_REDUCE_MIN,  // Smallest element
+    GOO_VEC_REDUCE_MAX   // Largest element
+} GooVectorReduceOp;
+
+// Elementwise comparisons (a OP b)
+typedef enum {
+    GOO_VEC_CMP_EQ,
+    GOO_VEC_CMP_NE,
+    GOO_VEC_CMP_LT,
+    GOO_VEC_CMP_LE,
+    GOO_VEC_CMP_GT,
+    GOO_VEC_CMP_GE
+} GooVectorCompareOp;
+
 /**
  * Initialize the vectorization subsystem.
  * 
@@ -82,6 +100,8 @@ GooSIMDType goo_vectorization_detect_simd(void);
 /**
  * Execute a simple vector operation.
  * 
+ * Large arrays are split across the worker pool like a vectorized loop.
+ * 
  * @param vec_op Vector operation to execute
  * @return true if successful, false otherwise
  */
@@ -90,14 +110,79 @@ bool goo_vector_execute(GooVector *vec_op);
 /**
  * Execute a vector operation with extended features.
  * 
+ * GOO_VECTOR_FMA computes dst = src1 * src2 + dst for FLOAT and DOUBLE.
+ * With a mask, only elements whose mask element is nonzero are written; the
+ * mask type must have the element size of data_type.
+ * 
  * @param vec_op Vector operation to execute
  * @return true if successful, false otherwise
  */
 bool goo_vectorization_execute(GooVectorOperation *vec_op);
 
+/**
+ * Reduce a vector to a single value with the current SIMD type.
+ * 
+ * Sums of signed integers are written as int64_t and of unsigned integers as
+ * uint64_t, both modulo 2^64; FLOAT and DOUBLE sums use the element type and
+ * an unspecified summation order. MIN and MAX write the element type and
+ * skip NaN elements, returning NaN only if every element is NaN.
+ * 
+ * @param op Reduction to perform
+ * @param src Elements to reduce
+ * @param length Number of elements (at least 1)
+ * @param type Data type of the elements
+ * @param result Receives the reduced value
+ * @return true if successful, false otherwise
+ */
+bool goo_vectorization_reduce(GooVectorReduceOp op, const void *src, size_t length,
+                              GooVectorDataType type, void *result);
+
+/**
+ * Dot product of two vectors; result storage follows the SUM reduction.
+ */
+bool goo_vectorization_dot(const void *a, const void *b, size_t length,
+                           GooVectorDataType type, void *result);
+
+/**
+ * Compare two vectors elementwise into a mask.
+ * 
+ * True elements are all-ones for integer types and -1.0 for FLOAT and
+ * DOUBLE, false elements zero. Comparisons involving NaN are false except NE.
+ * The mask type must have the element size of type.
+ */
+bool goo_vectorization_compare(GooVectorCompareOp cmp, const void *a, const void *b,
+                               size_t length, GooVectorDataType type, GooVectorMask *mask);
+
+/**
+ * Select elements: dst[i] = mask[i] ? b[i] : a[i], where a mask element is
+ * set when nonzero. dst may alias a or b.
+ */
+bool goo_vectorization_blend(const void *a, const void *b, const GooVectorMask *mask,
+                             void *dst, size_t length, GooVectorDataType type);
+
+/**
+ * Gather: dst[i] = base[indices[i]]. Fails without writing if any index is
+ * outside [0, base_length).
+ */
+bool goo_vectorization_gather(const void *base, size_t base_length, const int32_t *indices,
+                              size_t length, GooVectorDataType type, void *dst);
+
+/**
+ * Scatter: base[indices[i]] = src[i], with the highest i winning on duplicate
+ * indices. Fails without writing if any index is outside [0, base_length).
+ */
+bool goo_vectorization_scatter(const void *src, const int32_t *indices, size_t length,
+                               GooVectorDataType type, void *base, size_t base_length);
+
 /**
  * Apply vectorization to a parallel loop.
  * 
+ * Runs loop->vector_body on elements [start, end) of its buffers, which must
+ * hold at least end elements. The range is split into cache-sized blocks,
+ * a multiple of the SIMD width, that run on the worker pool; chunk_size
+ * overrides the block size and num_threads limits the threads used. Small
+ * ranges run on the calling thread. The loop must use a unit step.
+ * 
  * @param loop Parallel loop to vectorize
  * @param data_type Data type of loop elements
  * @param simd_type SIMD instruction set to use
@@ -3,495 +3,268 @@
  * 
  * Advanced work distribution algorithms for Goo's parallel execution system.
  * Implements work stealing and guided scheduling to optimize parallel workloads.
+ *
+ * Every parallel loop owns its own distribution context. Each participant's
+ * remaining [next, end) iteration range is packed into one atomic word: the
+ * owner takes iterations with a fetch_add on the low half, and thieves split
+ * the range in two with a single CAS. No locks are taken on the hot path.
  */
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <pthread.h>
 #include <unistd.h>  // For sysconf
-#include "parallel/goo_parallel.h"
+#include "goo_parallel.h"
+#include "goo_work_distribution.h"
 
-#define MAX_THREADS 128
+#define CACHE_LINE_SIZE 64
 #define MIN_CHUNK_SIZE 1
 #define DEFAULT_GUIDED_DIVISOR 2
 
-// Thread-local storage for work distribution
+// Packed iteration range: end in the high 32 bits, next in the low 32 bits
+#define RANGE_PACK(next, end) (((uint64_t)(end) << 32) | (uint32_t)(next))
+#define RANGE_NEXT(range) ((uint32_t)(range))
+#define RANGE_END(range) ((uint32_t)((range) >> 32))
+
+// Per-participant state, one cache line each so owners never false-share
 typedef struct ThreadWorkState {
-    uint64_t next_index;      // Next work item to process
-    uint64_t end_index;       // End of current chunk
-    int chunk_size;           // Current chunk size
-    bool has_work;            // Whether this thread has work
-    pthread_mutex_t mutex;    // Mutex for work stealing
-    int thread_id;            // Thread ID
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t range; // Packed [next, end) iteration range
+    uint64_t pending;         // Iterations handed out but not yet reported complete
+    bool finished;            // Participant has seen the loop run dry
 } ThreadWorkState;
 
 // Work distribution context
-typedef struct WorkDistribution {
-    uint64_t start;             // Global start index
-    uint64_t end;               // Global end index
+struct GooWorkDistribution {
+    uint64_t start;             // Loop start index
     uint64_t step;              // Step size
-    uint64_t total_work_items;  // Total number of work items
-    uint64_t current_index;     // Current global index
-    uint64_t remaining_work;    // Remaining work items
+    uint64_t total;             // Total number of iterations
     GooScheduleType schedule;   // Scheduling strategy
-    int initial_chunk_size;     // Initial chunk size specified
-    int num_threads;            // Number of threads
-    pthread_mutex_t mutex;      // Global mutex for work distribution
-    ThreadWorkState thread_states[MAX_THREADS]; // Per-thread state
-} WorkDistribution;
-
-// Static work distribution context
-static WorkDistribution work_dist = {0};
-
-// Initialize the work distribution system
-void goo_work_distribution_init(uint64_t start, uint64_t end, uint64_t step, 
-                               GooScheduleType schedule, int chunk_size, int num_threads) {
-    // Initialize global state
-    work_dist.start = start;
-    work_dist.end = end;
-    work_dist.step = step;
-    work_dist.total_work_items = (end - start + step - 1) / step; // Ceiling division
-    work_dist.current_index = start;
-    work_dist.remaining_work = work_dist.total_work_items;
-    work_dist.schedule = schedule;
-    work_dist.initial_chunk_size = chunk_size;
-    work_dist.num_threads = num_threads > 0 ? num_threads : 1;
-    
-    pthread_mutex_init(&work_dist.mutex, NULL);
-    
-    // Initialize per-thread state
-    for (int i = 0; i < work_dist.num_threads; i++) {
-        ThreadWorkState *state = &work_dist.thread_states[i];
-        memset(state, 0, sizeof(ThreadWorkState));
-        state->thread_id = i;
-        pthread_mutex_init(&state->mutex, NULL);
+    int chunk_size;             // Chunk size for dynamic/guided claims
+    int num_slots;              // Number of participant slots
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t next_chunk; // First unclaimed iteration
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t remaining;  // Iterations not yet completed
+    _Atomic int next_slot;      // Next participant slot to hand out
+    pthread_mutex_t done_mutex; // Protects completion wait
+    pthread_cond_t done_cond;   // Signalled when remaining reaches zero
+    ThreadWorkState slots[];    // Per-participant state
+};
+
+// Create a work distribution context for one loop
+GooWorkDistribution* goo_work_distribution_create(uint64_t start, uint64_t end, uint64_t step,
+                                                  GooScheduleType schedule, int chunk_size,
+                                                  int num_slots) {
+    if (step == 0 || num_slots <= 0) {
+        return NULL;
     }
-    
-    // For static schedule, calculate chunks upfront
+
+    uint64_t total = end > start ? (end - start + step - 1) / step : 0; // Ceiling division
+    if (total > GOO_WORK_DISTRIBUTION_MAX_ITERATIONS) {
+        fprintf(stderr, "Error: Loop too large for a single work distribution context\n");
+        return NULL;
+    }
+
+    size_t size = sizeof(GooWorkDistribution) + (size_t)num_slots * sizeof(ThreadWorkState);
+    size = (size + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+    GooWorkDistribution *dist = (GooWorkDistribution*)aligned_alloc(CACHE_LINE_SIZE, size);
+    if (dist == NULL) {
+        fprintf(stderr, "Error: Failed to allocate work distribution context\n");
+        return NULL;
+    }
+    memset(dist, 0, size);
+
+    dist->start = start;
+    dist->step = step;
+    dist->total = total;
+    dist->schedule = schedule;
+    dist->chunk_size = chunk_size > 0 ? chunk_size : MIN_CHUNK_SIZE;
+    dist->num_slots = num_slots;
+    atomic_init(&dist->remaining, total);
+    atomic_init(&dist->next_slot, 0);
+    pthread_mutex_init(&dist->done_mutex, NULL);
+    pthread_cond_init(&dist->done_cond, NULL);
+
     if (schedule == GOO_SCHEDULE_STATIC) {
-        int chunk = chunk_size > 0 ? chunk_size : 
-                    (work_dist.total_work_items + work_dist.num_threads - 1) / work_dist.num_threads;
-        
-        for (int i = 0; i < work_dist.num_threads; i++) {
-            ThreadWorkState *state = &work_dist.thread_states[i];
-            state->next_index = start + i * chunk * step;
-            state->end_index = state->next_index + chunk * step;
-            
-            // Ensure end doesn't exceed global end
-            if (state->end_index > end) {
-                state->end_index = end;
-            }
-            
-            state->has_work = (state->next_index < state->end_index);
+        // Pre-assign contiguous blocks; unclaimed slots are picked up by stealing
+        uint64_t per_slot = (total + num_slots - 1) / num_slots;
+        for (int i = 0; i < num_slots; i++) {
+            uint64_t begin = (uint64_t)i * per_slot;
+            uint64_t finish = begin + per_slot;
+            if (begin > total) begin = total;
+            if (finish > total) finish = total;
+            atomic_init(&dist->slots[i].range, RANGE_PACK(begin, finish));
         }
+        atomic_init(&dist->next_chunk, total);
+    } else {
+        for (int i = 0; i < num_slots; i++) {
+            atomic_init(&dist->slots[i].range, RANGE_PACK(0, 0));
+        }
+        atomic_init(&dist->next_chunk, 0);
     }
+
+    return dist;
 }
 
-// Clean up the work distribution system
-void goo_work_distribution_cleanup(void) {
-    pthread_mutex_destroy(&work_dist.mutex);
-    
-    for (int i = 0; i < work_dist.num_threads; i++) {
-        pthread_mutex_destroy(&work_dist.thread_states[i].mutex);
+// Destroy a work distribution context
+void goo_work_distribution_destroy(GooWorkDistribution *dist) {
+    if (dist == NULL) {
+        return;
     }
-    
-    memset(&work_dist, 0, sizeof(WorkDistribution));
+    pthread_cond_destroy(&dist->done_cond);
+    pthread_mutex_destroy(&dist->done_mutex);
+    free(dist);
 }
 
-// Get the next chunk of work for dynamic scheduling
-static bool get_next_dynamic_chunk(int thread_id, uint64_t *start_index, uint64_t *end_index) {
-    pthread_mutex_lock(&work_dist.mutex);
-    
-    // Check if work is done
-    if (work_dist.current_index >= work_dist.end) {
-        pthread_mutex_unlock(&work_dist.mutex);
-        return false;
+// Claim a participant slot
+int goo_work_distribution_join(GooWorkDistribution *dist) {
+    if (dist == NULL) {
+        return -1;
     }
-    
-    // Calculate chunk size
-    int chunk_size = work_dist.initial_chunk_size > 0 ? 
-                    work_dist.initial_chunk_size : 1;
-    
-    // Assign chunk
-    *start_index = work_dist.current_index;
-    *end_index = *start_index + chunk_size * work_dist.step;
-    
-    // Ensure end doesn't exceed global end
-    if (*end_index > work_dist.end) {
-        *end_index = work_dist.end;
-    }
-    
-    // Update global state
-    work_dist.current_index = *end_index;
-    
-    pthread_mutex_unlock(&work_dist.mutex);
-    
-    // Update thread state
-    ThreadWorkState *state = &work_dist.thread_states[thread_id];
-    pthread_mutex_lock(&state->mutex);
-    state->next_index = *start_index;
-    state->end_index = *end_index;
-    state->has_work = true;
-    pthread_mutex_unlock(&state->mutex);
-    
-    return true;
+    int slot = atomic_fetch_add_explicit(&dist->next_slot, 1, memory_order_relaxed);
+    return slot < dist->num_slots ? slot : -1;
 }
 
-// Get the next chunk of work for guided scheduling
-static bool get_next_guided_chunk(int thread_id, uint64_t *start_index, uint64_t *end_index) {
-    pthread_mutex_lock(&work_dist.mutex);
-    
-    // Check if work is done
-    if (work_dist.current_index >= work_dist.end) {
-        pthread_mutex_unlock(&work_dist.mutex);
-        return false;
-    }
-    
-    // Calculate chunk size - guided decreases chunk size as work decreases
-    // Use an adaptive divisor that changes based on remaining work percentage
-    uint64_t total_items = work_dist.total_work_items;
-    uint64_t remaining = (work_dist.end - work_dist.current_index + work_dist.step - 1) / work_dist.step;
-    double remaining_ratio = (double)remaining / total_items;
-    
-    // Adaptive divisor - increases as work decreases for finer-grained scheduling
-    int guided_divisor;
-    
-    if (remaining_ratio > 0.75) {
-        // Early phase: use larger chunks (less overhead)
-        guided_divisor = 2;
-    } else if (remaining_ratio > 0.5) {
-        // Middle phase: medium chunks
-        guided_divisor = 3;
-    } else if (remaining_ratio > 0.25) {
-        // Late middle phase: smaller chunks
-        guided_divisor = 4;
-    } else {
-        // Final phase: smallest chunks (best load balancing)
-        guided_divisor = 8;
+// Report iterations completed by a participant
+static void flush_pending(GooWorkDistribution *dist, ThreadWorkState *state) {
+    if (state->pending == 0) {
+        return;
     }
-    
-    // Calculate chunk size based on remaining work and adaptive divisor
-    int chunk_size = remaining / (work_dist.num_threads * guided_divisor);
-    
-    // Apply minimum chunk size constraints
-    if (chunk_size < MIN_CHUNK_SIZE) {
-        chunk_size = MIN_CHUNK_SIZE;
+    uint64_t before = atomic_fetch_sub_explicit(&dist->remaining, state->pending,
+                                                memory_order_acq_rel);
+    if (before == state->pending) {
+        pthread_mutex_lock(&dist->done_mutex);
+        pthread_cond_broadcast(&dist->done_cond);
+        pthread_mutex_unlock(&dist->done_mutex);
     }
-    
-    // Apply initial chunk size as maximum, if specified
-    if (work_dist.initial_chunk_size > 0 && chunk_size > work_dist.initial_chunk_size) {
-        chunk_size = work_dist.initial_chunk_size;
-    }
-    
-    // For very small amounts of remaining work, distribute more aggressively
-    if (remaining < work_dist.num_threads * 4) {
-        // When little work remains, use smaller chunks to ensure work is distributed
-        chunk_size = 1;
-    }
-    
-    // Assign chunk
-    *start_index = work_dist.current_index;
-    *end_index = *start_index + chunk_size * work_dist.step;
-    
-    // Ensure end doesn't exceed global end
-    if (*end_index > work_dist.end) {
-        *end_index = work_dist.end;
+    state->pending = 0;
+}
+
+// Claim a fresh chunk from the unassigned part of the loop
+static bool claim_chunk(GooWorkDistribution *dist, ThreadWorkState *state) {
+    uint64_t begin, chunk;
+
+    if (dist->schedule == GOO_SCHEDULE_DYNAMIC) {
+        chunk = (uint64_t)dist->chunk_size;
+        begin = atomic_fetch_add_explicit(&dist->next_chunk, chunk, memory_order_relaxed);
+        if (begin >= dist->total) {
+            return false;
+        }
+    } else {
+        // Guided: chunk size shrinks with the remaining unassigned work
+        begin = atomic_load_explicit(&dist->next_chunk, memory_order_relaxed);
+        do {
+            if (begin >= dist->total) {
+                return false;
+            }
+            uint64_t unassigned = dist->total - begin;
+            chunk = unassigned / ((uint64_t)dist->num_slots * DEFAULT_GUIDED_DIVISOR);
+            if (dist->chunk_size > MIN_CHUNK_SIZE && chunk > (uint64_t)dist->chunk_size) {
+                chunk = (uint64_t)dist->chunk_size;
+            }
+            if (chunk < MIN_CHUNK_SIZE) {
+                chunk = MIN_CHUNK_SIZE;
+            }
+        } while (!atomic_compare_exchange_weak_explicit(&dist->next_chunk, &begin, begin + chunk,
+                                                        memory_order_relaxed,
+                                                        memory_order_relaxed));
     }
-    
-    // Update global state
-    work_dist.current_index = *end_index;
-    
-    pthread_mutex_unlock(&work_dist.mutex);
-    
-    // Update thread state
-    ThreadWorkState *state = &work_dist.thread_states[thread_id];
-    pthread_mutex_lock(&state->mutex);
-    state->next_index = *start_index;
-    state->end_index = *end_index;
-    state->chunk_size = chunk_size;
-    state->has_work = true;
-    pthread_mutex_unlock(&state->mutex);
-    
+
+    uint64_t finish = begin + chunk < dist->total ? begin + chunk : dist->total;
+    // Our range is empty, so no thief can be modifying it
+    atomic_store_explicit(&state->range, RANGE_PACK(begin, finish), memory_order_release);
     return true;
 }
 
-// Attempt to steal work from another thread
-static bool steal_work_from_others(int thread_id, uint64_t *start_index, uint64_t *end_index) {
-    ThreadWorkState *my_state = &work_dist.thread_states[thread_id];
-    
-    // Try to steal from other threads
-    // First attempt to steal from threads with the most work
-    uint64_t max_work = 0;
-    int best_victim = -1;
-    
-    // First pass: find the thread with the most remaining work
-    for (int i = 0; i < work_dist.num_threads; i++) {
-        // Skip myself
-        if (i == thread_id) continue;
-        
-        ThreadWorkState *other = &work_dist.thread_states[i];
-        
-        // Try to lock the other thread's work
-        if (pthread_mutex_trylock(&other->mutex) == 0) {
-            // Check if the other thread has work to steal
-            if (other->has_work && other->next_index < other->end_index) {
-                uint64_t other_remaining = (other->end_index - other->next_index) / work_dist.step;
-                
-                if (other_remaining > max_work) {
-                    max_work = other_remaining;
-                    best_victim = i;
-                }
+// Steal the upper half of the largest remaining range of another participant
+static bool steal_range(GooWorkDistribution *dist, int thief) {
+    for (;;) {
+        int victim = -1;
+        uint64_t victim_range = 0;
+        uint32_t best = 0;
+
+        for (int n = 1; n < dist->num_slots; n++) {
+            int i = (thief + n) % dist->num_slots;
+            uint64_t range = atomic_load_explicit(&dist->slots[i].range, memory_order_acquire);
+            uint32_t next = RANGE_NEXT(range), end = RANGE_END(range);
+            if (next < end && end - next > best) {
+                best = end - next;
+                victim = i;
+                victim_range = range;
             }
-            pthread_mutex_unlock(&other->mutex);
         }
-    }
-    
-    // If we found a good victim, steal from them
-    if (best_victim >= 0) {
-        ThreadWorkState *victim = &work_dist.thread_states[best_victim];
-        
-        if (pthread_mutex_trylock(&victim->mutex) == 0) {
-            // Check again if they still have work (could have changed)
-            if (victim->has_work && victim->next_index < victim->end_index) {
-                // Calculate how much to steal - more aggressive with larger workloads
-                uint64_t other_remaining = (victim->end_index - victim->next_index) / work_dist.step;
-                uint64_t steal_amount;
-                
-                if (other_remaining > 100) {
-                    // For larger workloads, steal up to 75%
-                    steal_amount = other_remaining * 3 / 4;
-                } else if (other_remaining > 10) {
-                    // For medium workloads, steal half
-                    steal_amount = other_remaining / 2;
-                } else {
-                    // For small workloads, steal just one item
-                    steal_amount = 1;
-                }
-                
-                // Ensure we steal at least one item
-                if (steal_amount < 1) {
-                    steal_amount = 1;
-                }
-                
-                // Calculate boundaries
-                uint64_t steal_boundary = victim->next_index + (steal_amount * work_dist.step);
-                *start_index = steal_boundary;
-                *end_index = victim->end_index;
-                
-                // Update the victim's end point
-                victim->end_index = steal_boundary;
-                
-                // Update my state
-                pthread_mutex_lock(&my_state->mutex);
-                my_state->next_index = *start_index;
-                my_state->end_index = *end_index;
-                my_state->has_work = true;
-                pthread_mutex_unlock(&my_state->mutex);
-                
-                pthread_mutex_unlock(&victim->mutex);
-                return true;
-            }
-            pthread_mutex_unlock(&victim->mutex);
+
+        if (victim < 0) {
+            return false;
         }
-    }
-    
-    // Fallback to original algorithm if optimal approach failed
-    for (int i = 0; i < work_dist.num_threads; i++) {
-        // Skip myself
-        if (i == thread_id) continue;
-        
-        ThreadWorkState *other = &work_dist.thread_states[i];
-        
-        // Try to lock the other thread's work
-        if (pthread_mutex_trylock(&other->mutex) == 0) {
-            // Check if the other thread has work to steal
-            if (other->has_work && other->next_index < other->end_index) {
-                // Calculate how much to steal (half of remaining work)
-                uint64_t other_remaining = (other->end_index - other->next_index) / work_dist.step;
-                uint64_t steal_amount = other_remaining / 2;
-                
-                // Ensure we steal at least one item
-                if (steal_amount < 1) {
-                    steal_amount = 1;
-                }
-                
-                // Calculate boundaries
-                uint64_t steal_boundary = other->next_index + (steal_amount * work_dist.step);
-                *start_index = steal_boundary;
-                *end_index = other->end_index;
-                
-                // Update the victim's end point
-                other->end_index = steal_boundary;
-                
-                // Update my state
-                pthread_mutex_lock(&my_state->mutex);
-                my_state->next_index = *start_index;
-                my_state->end_index = *end_index;
-                my_state->has_work = true;
-                pthread_mutex_unlock(&my_state->mutex);
-                
-                pthread_mutex_unlock(&other->mutex);
-                return true;
-            }
-            
-            pthread_mutex_unlock(&other->mutex);
+
+        uint32_t next = RANGE_NEXT(victim_range), end = RANGE_END(victim_range);
+        uint32_t mid = next + (end - next) / 2;
+        if (atomic_compare_exchange_strong_explicit(&dist->slots[victim].range, &victim_range,
+                                                    RANGE_PACK(next, mid),
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            atomic_store_explicit(&dist->slots[thief].range, RANGE_PACK(mid, end),
+                                  memory_order_release);
+            return true;
         }
+        // The victim made progress or was stolen from; rescan
     }
-    
-    return false;
 }
 
 // Get the next item to work on, based on the scheduling strategy
-bool goo_work_distribution_next(int thread_id, uint64_t *index) {
-    if (thread_id < 0 || thread_id >= work_dist.num_threads || !index) {
+bool goo_work_distribution_next(GooWorkDistribution *dist, int slot, uint64_t *index) {
+    if (dist == NULL || slot < 0 || slot >= dist->num_slots || index == NULL) {
         return false;
     }
-    
-    ThreadWorkState *state = &work_dist.thread_states[thread_id];
-    bool has_next = false;
-    
-    switch (work_dist.schedule) {
-        case GOO_SCHEDULE_STATIC: {
-            // For static scheduling, just check the pre-assigned chunk
-            pthread_mutex_lock(&state->mutex);
-            if (state->next_index < state->end_index) {
-                *index = state->next_index;
-                state->next_index += work_dist.step;
-                has_next = true;
-            } else {
-                state->has_work = false;
-            }
-            pthread_mutex_unlock(&state->mutex);
-            break;
-        }
-        
-        case GOO_SCHEDULE_DYNAMIC: {
-            // Check if we have work in our current chunk
-            pthread_mutex_lock(&state->mutex);
-            if (state->next_index < state->end_index) {
-                *index = state->next_index;
-                state->next_index += work_dist.step;
-                has_next = true;
-                pthread_mutex_unlock(&state->mutex);
-            } else {
-                // Current chunk is done, get a new one
-                state->has_work = false;
-                pthread_mutex_unlock(&state->mutex);
-                
-                uint64_t start, end;
-                has_next = get_next_dynamic_chunk(thread_id, &start, &end);
-                if (has_next) {
-                    *index = start;
-                    
-                    // Update state with the new position
-                    pthread_mutex_lock(&state->mutex);
-                    state->next_index = start + work_dist.step;
-                    pthread_mutex_unlock(&state->mutex);
-                }
-            }
-            break;
-        }
-        
-        case GOO_SCHEDULE_GUIDED: {
-            // Check if we have work in our current chunk
-            pthread_mutex_lock(&state->mutex);
-            if (state->next_index < state->end_index) {
-                *index = state->next_index;
-                state->next_index += work_dist.step;
-                has_next = true;
-                pthread_mutex_unlock(&state->mutex);
-            } else {
-                // Current chunk is done, get a new one
-                state->has_work = false;
-                pthread_mutex_unlock(&state->mutex);
-                
-                uint64_t start, end;
-                has_next = get_next_guided_chunk(thread_id, &start, &end);
-                if (has_next) {
-                    *index = start;
-                    
-                    // Update state with the new position
-                    pthread_mutex_lock(&state->mutex);
-                    state->next_index = start + work_dist.step;
-                    pthread_mutex_unlock(&state->mutex);
-                }
-            }
-            break;
+
+    ThreadWorkState *state = &dist->slots[slot];
+    if (state->finished) {
+        return false;
+    }
+
+    for (;;) {
+        uint64_t range = atomic_fetch_add_explicit(&state->range, 1, memory_order_acquire);
+        uint32_t next = RANGE_NEXT(range);
+        if (next < RANGE_END(range)) {
+            state->pending++;
+            *index = dist->start + (uint64_t)next * dist->step;
+            return true;
         }
-        
-        case GOO_SCHEDULE_AUTO:
-        default: {
-            // Enhanced auto scheduling with adaptive load balancing
-            
-            // Check if we have work in our current chunk
-            pthread_mutex_lock(&state->mutex);
-            if (state->next_index < state->end_index) {
-                *index = state->next_index;
-                state->next_index += work_dist.step;
-                has_next = true;
-                pthread_mutex_unlock(&state->mutex);
-                
-                // Periodically check for imbalance (every 16 items)
-                if ((*index % 16) == 0) {
-                    goo_work_distribution_detect_imbalance(thread_id);
-                }
-            } else {
-                // Current chunk is done
-                state->has_work = false;
-                pthread_mutex_unlock(&state->mutex);
-                
-                // First try to get a new chunk (using guided scheduling as base)
-                uint64_t start, end;
-                has_next = get_next_guided_chunk(thread_id, &start, &end);
-                
-                if (has_next) {
-                    *index = start;
-                    
-                    // Update state with the new position
-                    pthread_mutex_lock(&state->mutex);
-                    state->next_index = start + work_dist.step;
-                    pthread_mutex_unlock(&state->mutex);
-                } else {
-                    // No new chunks available, try stealing with advanced strategy
-                    has_next = steal_work_from_others(thread_id, &start, &end);
-                    if (has_next) {
-                        *index = start;
-                        
-                        // Update state with the new position
-                        pthread_mutex_lock(&state->mutex);
-                        state->next_index = start + work_dist.step;
-                        pthread_mutex_unlock(&state->mutex);
-                    } else {
-                        // Check for any imbalance and try to address it
-                        // This is our last resort before giving up
-                        if (goo_work_distribution_detect_imbalance(thread_id)) {
-                            // If imbalance detection triggered work stealing, try again
-                            has_next = steal_work_from_others(thread_id, &start, &end);
-                            if (has_next) {
-                                *index = start;
-                                
-                                // Update state with the new position
-                                pthread_mutex_lock(&state->mutex);
-                                state->next_index = start + work_dist.step;
-                                pthread_mutex_unlock(&state->mutex);
-                            }
-                        }
-                    }
-                }
-            }
-            break;
+
+        // Our range is exhausted: everything handed out so far has completed
+        flush_pending(dist, state);
+
+        if (claim_chunk(dist, state) || steal_range(dist, slot)) {
+            continue;
         }
+
+        state->finished = true;
+        return false;
     }
-    
-    return has_next;
+}
+
+// Block until every iteration has completed
+void goo_work_distribution_wait(GooWorkDistribution *dist) {
+    if (dist == NULL ||
+        atomic_load_explicit(&dist->remaining, memory_order_acquire) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&dist->done_mutex);
+    while (atomic_load_explicit(&dist->remaining, memory_order_acquire) != 0) {
+        pthread_cond_wait(&dist->done_cond, &dist->done_mutex);
+    }
+    pthread_mutex_unlock(&dist->done_mutex);
 }
 
 // Estimate the best scheduling strategy based on the workload
 GooScheduleType goo_work_distribution_auto_strategy(uint64_t start, uint64_t end, uint64_t step) {
     uint64_t total_work = (end - start + step - 1) / step; // Ceiling division
-    int num_threads = sysconf(_SC_NPROCESSORS_ONLN); // Get available CPU cores
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN); // Get available CPU cores
+    uint64_t num_threads = cpus > 0 ? (uint64_t)cpus : 1;
     
     // For very small workloads, use static scheduling to minimize overhead
     if (total_work <= num_threads * 2) {
@@ -529,29 +302,30 @@ GooScheduleType goo_work_distribution_auto_strategy(uint64_t start, uint64_t end
 int goo_work_distribution_optimal_chunk_size(uint64_t start, uint64_t end, uint64_t step, 
                                           GooScheduleType schedule, int num_threads) {
     uint64_t total_work = (end - start + step - 1) / step; // Ceiling division
+    uint64_t threads = num_threads > 0 ? (uint64_t)num_threads : 1;
     
     switch (schedule) {
         case GOO_SCHEDULE_STATIC:
             // For static scheduling, divide work evenly
-            return (total_work + num_threads - 1) / num_threads;
+            return (total_work + threads - 1) / threads;
             
         case GOO_SCHEDULE_DYNAMIC: {
             // For dynamic scheduling, use a smarter approach based on workload size
-            if (total_work < num_threads * 4) {
+            if (total_work < threads * 4) {
                 // For very small workloads, use smallest possible chunks
                 return 1;
             } else if (total_work < 100) {
                 // For small workloads, relatively small chunks
-                return (total_work / (num_threads * 8)) > 1 ? (total_work / (num_threads * 8)) : 1;
+                return (total_work / (threads * 8)) > 1 ? (total_work / (threads * 8)) : 1;
             } else if (total_work < 1000) {
                 // For medium workloads
-                return total_work / (num_threads * 6);
+                return total_work / (threads * 6);
             } else if (total_work < 10000) {
                 // For large workloads
-                return total_work / (num_threads * 4);
+                return total_work / (threads * 4);
             } else {
                 // For very large workloads, larger chunks to reduce overhead
-                return total_work / (num_threads * 2);
+                return total_work / (threads * 2);
             }
         }
             
@@ -569,13 +343,13 @@ int goo_work_distribution_optimal_chunk_size(uint64_t start, uint64_t end, uint6
             } else {
                 // Very large workloads - can start with larger chunks
                 // since guided scheduling will reduce them over time
-                return total_work / num_threads; 
+                return total_work / threads; 
             }
         }
             
         case GOO_SCHEDULE_AUTO: {
             // For auto scheduling, base decision on workload size and thread count
-            if (total_work < num_threads * 4) {
+            if (total_work < threads * 4) {
                 // Very small workloads - use 1
                 return 1;
             } else if (total_work < 100) {
@@ -584,141 +358,23 @@ int goo_work_distribution_optimal_chunk_size(uint64_t start, uint64_t end, uint6
             } else if (total_work < 1000) {
                 // Medium workloads - start with medium chunks,
                 // work stealing will balance things
-                return total_work / (num_threads * 4);
+                return total_work / (threads * 4);
             } else {
                 // Large workloads - start with larger chunks to reduce overhead
-                return total_work / (num_threads * 2);
+                return total_work / (threads * 2);
             }
         }
             
         default:
             // Default failsafe
-            return (total_work / num_threads) > 1 ? (total_work / num_threads) : 1;
+            return (total_work / threads) > 1 ? (total_work / threads) : 1;
     }
 }
 
-// Get statistics about the current work distribution
-void goo_work_distribution_stats(int *completed_items, int *total_items) {
-    if (!completed_items || !total_items) return;
-    
-    pthread_mutex_lock(&work_dist.mutex);
-    
-    *total_items = work_dist.total_work_items;
-    *completed_items = (work_dist.current_index - work_dist.start) / work_dist.step;
-    
-    // Ensure completed_items doesn't exceed total_items
-    if (*completed_items > *total_items) {
-        *completed_items = *total_items;
-    }
-    
-    pthread_mutex_unlock(&work_dist.mutex);
-}
+// Get statistics about a work distribution
+void goo_work_distribution_stats(GooWorkDistribution *dist, uint64_t *completed, uint64_t *total) {
+    if (dist == NULL || completed == NULL || total == NULL) return;
 
-// Detect workload imbalance and adjust scheduling strategy if needed
-bool goo_work_distribution_detect_imbalance(int thread_id) {
-    if (thread_id < 0 || thread_id >= work_dist.num_threads) {
-        return false;
-    }
-    
-    // This function should be called periodically by threads
-    // We'll check for signs of imbalance
-    
-    // Acquire global mutex to check overall progress
-    pthread_mutex_lock(&work_dist.mutex);
-    
-    // Calculate how much work is done and how much remains
-    uint64_t total_work = work_dist.total_work_items;
-    uint64_t completed = (work_dist.current_index - work_dist.start) / work_dist.step;
-    
-    if (completed >= total_work) {
-        // All work is already assigned, nothing to adjust
-        pthread_mutex_unlock(&work_dist.mutex);
-        return false;
-    }
-    
-    // Check imbalance by counting idle threads vs busy threads
-    int idle_threads = 0;
-    int busy_threads = 0;
-    uint64_t max_remaining_work = 0;
-    int thread_with_most_work = -1;
-    
-    // First scan: get counts of busy/idle threads and find the thread with most work
-    for (int i = 0; i < work_dist.num_threads; i++) {
-        ThreadWorkState *state = &work_dist.thread_states[i];
-        
-        if (pthread_mutex_trylock(&state->mutex) == 0) {
-            if (state->has_work && state->next_index < state->end_index) {
-                busy_threads++;
-                
-                uint64_t thread_remaining = (state->end_index - state->next_index) / work_dist.step;
-                if (thread_remaining > max_remaining_work) {
-                    max_remaining_work = thread_remaining;
-                    thread_with_most_work = i;
-                }
-            } else {
-                idle_threads++;
-            }
-            pthread_mutex_unlock(&state->mutex);
-        }
-    }
-    
-    // If we have idle threads and there's significant work remaining,
-    // adjust the schedule or recommend work stealing
-    bool made_adjustment = false;
-    
-    if (idle_threads > 0 && busy_threads > 0 && thread_with_most_work >= 0) {
-        // Significant imbalance detected
-        
-        // Scenario 1: We're using static scheduling and things are imbalanced
-        if (work_dist.schedule == GOO_SCHEDULE_STATIC) {
-            // Can't change static scheduling mid-run, but we can flag
-            // that the calling thread should try stealing
-            pthread_mutex_unlock(&work_dist.mutex);
-            
-            // Steal from the thread with most work
-            uint64_t start, end;
-            if (steal_work_from_others(thread_id, &start, &end)) {
-                return true;
-            }
-            return false;
-        }
-        
-        // Scenario 2: We're using dynamic scheduling but chunks too large
-        else if (work_dist.schedule == GOO_SCHEDULE_DYNAMIC && 
-                work_dist.initial_chunk_size > 1) {
-            // Reduce chunk size for better distribution
-            work_dist.initial_chunk_size = work_dist.initial_chunk_size / 2;
-            if (work_dist.initial_chunk_size < 1) {
-                work_dist.initial_chunk_size = 1;
-            }
-            made_adjustment = true;
-        }
-        
-        // Scenario 3: We're using guided scheduling but the ratio is wrong
-        else if (work_dist.schedule == GOO_SCHEDULE_GUIDED) {
-            // No need to adjust parameters here, guided already adapts
-            made_adjustment = false;
-        }
-    }
-    
-    pthread_mutex_unlock(&work_dist.mutex);
-    
-    // If we're the idle thread, try to steal work regardless of adjustments
-    if (idle_threads > 0) {
-        ThreadWorkState *my_state = &work_dist.thread_states[thread_id];
-        bool am_i_idle = false;
-        
-        pthread_mutex_lock(&my_state->mutex);
-        am_i_idle = !(my_state->has_work && my_state->next_index < my_state->end_index);
-        pthread_mutex_unlock(&my_state->mutex);
-        
-        if (am_i_idle) {
-            uint64_t start, end;
-            if (steal_work_from_others(thread_id, &start, &end)) {
-                return true;
-            }
-        }
-    }
-    
-    return made_adjustment;
-} 
+    *total = dist->total;
+    *completed = dist->total - atomic_load_explicit(&dist->remaining, memory_order_acquire);
+}
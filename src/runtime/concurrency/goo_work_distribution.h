@@ -14,9 +14,10 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include "goo_parallel.h"
 #include "../../../include/goo_core.h"
-#include "../../../include/goo_concurrency.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,22 +33,72 @@ typedef struct {
     unsigned int num_workers;     // Number of worker threads (0 = auto)
     bool dynamic_scaling;         // Whether to dynamically scale worker count
     unsigned int queue_size;      // Size of work queue (0 = unlimited)
-    GooSchedulingPolicy policy;   // Scheduling policy
+    GooScheduleType policy;       // Scheduling policy
 } GooWorkerPoolOptions;
 
 // Function pointer typedefs
 typedef void (*GooTaskFunc)(void* data, size_t size, void* result);
 typedef void (*GooTaskCompleteCallback)(void* result, void* user_data);
 
+// Per-loop work distribution context. Each parallel loop owns one, so
+// concurrent and nested loops never share distribution state.
+typedef struct GooWorkDistribution GooWorkDistribution;
+
+// Largest iteration count a single distribution context can hand out
+#define GOO_WORK_DISTRIBUTION_MAX_ITERATIONS ((uint64_t)UINT32_MAX - 1)
+
+/**
+ * Create a work distribution context for the loop [start, end) by step.
+ *
+ * @param start Loop start value
+ * @param end Loop end value (exclusive)
+ * @param step Loop step value
+ * @param schedule Scheduling strategy
+ * @param chunk_size Chunk size (0 = choose automatically)
+ * @param num_slots Maximum number of participating threads
+ * @return New context, or NULL on failure or if the loop has more than
+ *         GOO_WORK_DISTRIBUTION_MAX_ITERATIONS iterations
+ */
+GooWorkDistribution* goo_work_distribution_create(uint64_t start, uint64_t end, uint64_t step,
+                                                  GooScheduleType schedule, int chunk_size,
+                                                  int num_slots);
+
+/**
+ * Destroy a work distribution context. No thread may still be using it.
+ */
+void goo_work_distribution_destroy(GooWorkDistribution* dist);
+
+/**
+ * Claim a participant slot. Returns -1 once all slots are taken.
+ */
+int goo_work_distribution_join(GooWorkDistribution* dist);
+
+/**
+ * Get the next loop index for a participant. Returning false means the
+ * participant has no more work and all indices it received are complete.
+ */
+bool goo_work_distribution_next(GooWorkDistribution* dist, int slot, uint64_t* index);
+
+/**
+ * Block until every iteration of the loop has completed.
+ */
+void goo_work_distribution_wait(GooWorkDistribution* dist);
+
+/**
+ * Get completed and total iteration counts.
+ */
+void goo_work_distribution_stats(GooWorkDistribution* dist, uint64_t* completed, uint64_t* total);
+
 /**
- * Initialize the work distribution system
+ * Estimate the best scheduling strategy for a loop.
  */
-bool goo_work_distribution_init(void);
+GooScheduleType goo_work_distribution_auto_strategy(uint64_t start, uint64_t end, uint64_t step);
 
 /**
- * Clean up the work distribution system
+ * Choose a chunk size for a loop, strategy and thread count.
  */
-void goo_work_distribution_cleanup(void);
+int goo_work_distribution_optimal_chunk_size(uint64_t start, uint64_t end, uint64_t step,
+                                            GooScheduleType schedule, int num_threads);
 
 /**
  * Create a worker pool
@@ -55,14 +55,14 @@ pub const VectorMask = struct {
     pub fn create(allocator: std.mem.Allocator, size: usize, data_type: VectorDataType) !*VectorMask {
         if (size == 0) return error.InvalidSize;
 
-        var mask = try allocator.create(VectorMask);
+        const mask = try allocator.create(VectorMask);
 
         // Determine element size
         const elem_size = getElementSize(data_type);
         const total_size = size * elem_size;
 
         // Allocate mask data
-        mask.mask_data = @ptrCast(try allocator.alloc(u8, total_size));
+        mask.mask_data = (try allocator.alloc(u8, total_size)).ptr;
         mask.mask_size = total_size;
         mask.type = data_type;
 
@@ -98,21 +98,21 @@ pub const VectorMask = struct {
                 }
             },
             .INT16, .UINT16 => {
-                const mask_data = @as([*]u16, @ptrCast(self.mask_data.?));
+                const mask_data = @as([*]align(1) u16, @ptrCast(self.mask_data.?));
                 for (indices) |idx| {
                     if (idx >= max_index) continue;
                     mask_data[idx] = 0xFFFF;
                 }
             },
             .INT32, .UINT32, .FLOAT => {
-                const mask_data = @as([*]u32, @ptrCast(self.mask_data.?));
+                const mask_data = @as([*]align(1) u32, @ptrCast(self.mask_data.?));
                 for (indices) |idx| {
                     if (idx >= max_index) continue;
                     mask_data[idx] = 0xFFFFFFFF;
                 }
             },
             .INT64, .UINT64, .DOUBLE => {
-                const mask_data = @as([*]u64, @ptrCast(self.mask_data.?));
+                const mask_data = @as([*]align(1) u64, @ptrCast(self.mask_data.?));
                 for (indices) |idx| {
                     if (idx >= max_index) continue;
                     mask_data[idx] = 0xFFFFFFFFFFFFFFFF;
@@ -263,11 +263,10 @@ pub fn cleanup() void {
 
 // Allocate SIMD-aligned memory
 pub fn allocAligned(size: usize, simd_type: SIMDType) ?*anyopaque {
-    const actual_simd = if (simd_type == .AUTO) current_simd_type else simd_type;
-    const alignment = getAlignment(actual_simd);
-
-    // Use Zig's aligned allocator
-    const mem = global_allocator.alignedAlloc(u8, alignment, size) catch return null;
+    // The allocator needs a comptime alignment, so every type gets the
+    // widest one (AVX-512)
+    _ = simd_type;
+    const mem = global_allocator.alignedAlloc(u8, 64, size) catch return null;
 
     // Keep track of allocation for freeing
     // In a real implementation, we'd store this somewhere to free it later
@@ -289,170 +288,299 @@ pub fn freeAligned(ptr: ?*anyopaque) void {
     // with tracking of allocation sizes
 }
 
-// Dispatch vector operations based on SIMD type
-fn dispatch(op: VectorOp, src1: *anyopaque, src2: ?*anyopaque, dst: *anyopaque, elem_size: usize, length: usize, data_type: VectorDataType, simd_type: SIMDType, mask: ?*VectorMask) bool {
-    _ = mask; // Unused in this simplified example
+// Horizontal reductions, matching GooVectorReduceOp
+pub const ReduceOp = enum(c_int) {
+    SUM = 0,
+    MIN = 1,
+    MAX = 2,
+};
 
-    switch (simd_type) {
-        .SCALAR => return scalarOp(op, src1, src2, dst, elem_size, length, data_type),
-        .SSE2 => {
-            if (builtin.cpu.arch == .x86_64 or builtin.cpu.arch == .x86) {
-                return sse2Op(op, src1, src2, dst, elem_size, length, data_type);
-            }
-            return scalarOp(op, src1, src2, dst, elem_size, length, data_type);
-        },
-        // Additional SIMD implementations would go here
-        else => return scalarOp(op, src1, src2, dst, elem_size, length, data_type),
-    }
+// Elementwise comparisons (a OP b), matching GooVectorCompareOp
+pub const CompareOp = enum(c_int) {
+    EQ = 0,
+    NE = 1,
+    LT = 2,
+    LE = 3,
+    GT = 4,
+    GE = 5,
+};
+
+// Zig element type of a vector data type
+fn ElemType(comptime data_type: VectorDataType) type {
+    return switch (data_type) {
+        .INT8 => i8,
+        .UINT8 => u8,
+        .INT16 => i16,
+        .UINT16 => u16,
+        .INT32 => i32,
+        .UINT32 => u32,
+        .INT64 => i64,
+        .UINT64 => u64,
+        .FLOAT => f32,
+        .DOUBLE => f64,
+    };
 }
 
-// Scalar fallback implementation
-fn scalarOp(
-    op: VectorOp,
-    src1: *anyopaque,
-    src2: ?*anyopaque,
-    dst: *anyopaque,
-    elem_size: usize,
-    length: usize,
-    data_type: VectorDataType
-) bool {
-    _ = elem_size; // Actually used to determine element size by data type
-    
-    // Process each element individually based on data type
-    switch (data_type) {
-        .INT32 => {
-            const s1 = @as([*]i32, @ptrCast(src1))[0..length];
-            const d = @as([*]i32, @ptrCast(dst))[0..length];
-            
-            if (src2) |s2_ptr| {
-                const s2 = @as([*]i32, @ptrCast(s2_ptr))[0..length];
-                
-                switch (op) {
-                    .ADD => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] + s2[i];
-                        }
-                    },
-                    .SUB => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] - s2[i];
-                        }
-                    },
-                    .MUL => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] * s2[i];
-                        }
-                    },
-                    .DIV => {
-                        for (0..length) |i| {
-                            if (s2[i] == 0) {
-                                return false; // Division by zero
-                            }
-                            d[i] = @divTrunc(s1[i], s2[i]);
-                        }
-                    },
-                    .FMA => {
-                        // Not a true FMA for scalar, just a multiply-add
-                        for (0..length) |i| {
-                            d[i] = s1[i] * s2[i] + d[i];
-                        }
-                    },
-                    else => return false, // Unsupported operation
-                }
+// Lanes per vector of T for the compile target's features: 16 bytes with
+// SSE2 or NEON, 32 with AVX2, 64 with AVX-512
+fn nativeLanes(comptime T: type) comptime_int {
+    return std.simd.suggestVectorLength(T) orelse 1;
+}
+
+// Kernels for element type T at width N, with the same semantics as the C
+// kernels in goo_vectorization.c: integer add, sub and mul saturate,
+// division by zero gives 0, signed MIN / -1 gives MAX, and float division
+// by a value below 1e-10 in magnitude gives 0
+fn Kernels(comptime T: type, comptime N: comptime_int) type {
+    return struct {
+        const V = @Vector(N, T);
+        const Mask = @Vector(N, bool);
+        const is_float = T == f32 or T == f64;
+        const is_signed = !is_float and std.math.minInt(T) < 0;
+
+        // Unaligned whole-vector load and store
+        inline fn load(p: [*]align(1) const T, i: usize) V {
+            return p[i..][0..N].*;
+        }
+
+        inline fn store(p: [*]align(1) T, i: usize, v: V) void {
+            p[i..][0..N].* = v;
+        }
+
+        fn divide(a: V, b: V) V {
+            const zero: V = @splat(0);
+            if (is_float) {
+                const tiny: V = @splat(1e-10);
+                return @select(T, @abs(b) < tiny, zero, a / b);
+            } else if (!is_signed) {
+                const one: V = @splat(1);
+                const by_zero = b == zero;
+                return @select(T, by_zero, zero, @divTrunc(a, @select(T, by_zero, one, b)));
             } else {
-                // Unary operations
-                switch (op) {
-                    .ABS => {
-                        for (0..length) |i| {
-                            d[i] = if (s1[i] < 0) -s1[i] else s1[i];
-                        }
-                    },
-                    .SQRT => {
-                        for (0..length) |i| {
-                            d[i] = std.math.sqrt(s1[i]);
-                        }
-                    },
-                    else => return false, // Unsupported operation
-                }
+                const one: V = @splat(1);
+                const by_zero = b == zero;
+                const min: V = @splat(std.math.minInt(T));
+                const max: V = @splat(std.math.maxInt(T));
+                const neg_one: V = @splat(-1);
+                const no: Mask = @splat(false);
+                const overflow = @select(bool, a == min, b == neg_one, no);
+                const divisor = @select(T, by_zero, one, @select(T, overflow, one, b));
+                return @select(T, by_zero, zero, @select(T, overflow, max, @divTrunc(a, divisor)));
+            }
+        }
+
+        fn apply(comptime op: VectorOp, a: V, b: V, d: V) V {
+            return switch (op) {
+                .ADD => if (is_float) a + b else a +| b,
+                .SUB => if (is_float) a - b else a -| b,
+                .MUL => if (is_float) a * b else a *| b,
+                .DIV => divide(a, b),
+                .FMA => @mulAdd(V, a, b, d),
+                .ABS => if (is_float) @abs(a) else if (is_signed) @select(T, a < @as(V, @splat(0)), @as(V, @splat(0)) -| a, a) else a,
+                .SQRT => @sqrt(a),
+                .CUSTOM => unreachable,
+            };
+        }
+
+        // d = a OP b over n elements; unary ops ignore b. The tail runs as
+        // one vector padded with ones so guarded lanes never divide by zero
+        fn run(comptime op: VectorOp, a: [*]align(1) const T, b: [*]align(1) const T, d: [*]align(1) T, n: usize) void {
+            var i: usize = 0;
+            while (i + N <= n) : (i += N) {
+                const addend: V = if (op == .FMA) load(d, i) else undefined;
+                store(d, i, apply(op, load(a, i), load(b, i), addend));
+            }
+
+            if (i < n) {
+                const rest = n - i;
+                var ta = [_]T{1} ** N;
+                var tb = [_]T{1} ** N;
+                var td = [_]T{1} ** N;
+                @memcpy(ta[0..rest], a[i..n]);
+                @memcpy(tb[0..rest], b[i..n]);
+                @memcpy(td[0..rest], d[i..n]);
+                const result: [N]T = apply(op, ta, tb, td);
+                @memcpy(d[i..n], result[0..rest]);
+            }
+        }
+
+        pub fn elementwise(op: VectorOp, a: [*]align(1) const T, b: ?[*]align(1) const T, d: [*]align(1) T, n: usize) bool {
+            switch (op) {
+                inline .ADD, .SUB, .MUL, .DIV => |o| {
+                    run(o, a, b orelse return false, d, n);
+                },
+                .FMA => {
+                    if (is_float) run(.FMA, a, b orelse return false, d, n) else return false;
+                },
+                .ABS => run(.ABS, a, a, d, n),
+                .SQRT => {
+                    if (is_float) run(.SQRT, a, a, d, n) else return false;
+                },
+                .CUSTOM => return false,
             }
-            
             return true;
-        },
-        .FLOAT => {
-            const s1 = @as([*]f32, @ptrCast(src1))[0..length];
-            const d = @as([*]f32, @ptrCast(dst))[0..length];
-            
-            if (src2) |s2_ptr| {
-                const s2 = @as([*]f32, @ptrCast(s2_ptr))[0..length];
-                
-                switch (op) {
-                    .ADD => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] + s2[i];
-                        }
-                    },
-                    .SUB => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] - s2[i];
-                        }
-                    },
-                    .MUL => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] * s2[i];
-                        }
-                    },
-                    .DIV => {
-                        for (0..length) |i| {
-                            d[i] = s1[i] / s2[i];
-                        }
-                    },
-                    .FMA => {
-                        // Not a true FMA for scalar, just a multiply-add
-                        for (0..length) |i| {
-                            d[i] = s1[i] * s2[i] + d[i];
+        }
+
+        // Reference min/max for floats: skips NaN, NaN only if all are NaN
+        fn minMaxScalar(comptime op: ReduceOp, src: [*]align(1) const T, n: usize) T {
+            var best = std.math.nan(T);
+            for (src[0..n]) |x| {
+                if (std.math.isNan(x)) continue;
+                if (std.math.isNan(best) or (if (op == .MIN) x < best else x > best)) best = x;
+            }
+            return best;
+        }
+
+        fn minMax(comptime op: ReduceOp, src: [*]align(1) const T, n: usize) T {
+            const start: T = if (is_float)
+                (if (op == .MIN) std.math.inf(T) else -std.math.inf(T))
+            else if (op == .MIN) std.math.maxInt(T) else std.math.minInt(T);
+
+            var acc: V = @splat(start);
+            var i: usize = 0;
+            while (i + N <= n) : (i += N) {
+                const v = load(src, i);
+                // Operand order keeps acc when v is NaN
+                acc = if (op == .MIN) @select(T, v < acc, v, acc) else @select(T, v > acc, v, acc);
+            }
+
+            var best = if (op == .MIN) @reduce(.Min, acc) else @reduce(.Max, acc);
+            for (src[i..n]) |x| {
+                if (op == .MIN and x < best) best = x;
+                if (op == .MAX and x > best) best = x;
+            }
+
+            // An infinite result may mean every element was NaN
+            if (is_float and std.math.isInf(best)) return minMaxScalar(op, src, n);
+            return best;
+        }
+
+        // Sums of signed integers are written as i64 and of unsigned as u64,
+        // both wrapping; float sums use T in an unspecified order
+        pub fn reduce(op: ReduceOp, src: [*]align(1) const T, n: usize, result: *anyopaque) void {
+            switch (op) {
+                .SUM => {
+                    if (is_float) {
+                        var acc: V = @splat(0);
+                        var i: usize = 0;
+                        while (i + N <= n) : (i += N) acc += load(src, i);
+                        var sum = @reduce(.Add, acc);
+                        for (src[i..n]) |x| sum += x;
+                        @as(*align(1) T, @ptrCast(result)).* = sum;
+                    } else {
+                        const Wide = if (is_signed) i64 else u64;
+                        var acc: @Vector(N, Wide) = @splat(0);
+                        var i: usize = 0;
+                        while (i + N <= n) : (i += N) {
+                            const wide: @Vector(N, Wide) = @intCast(load(src, i));
+                            acc +%= wide;
                         }
-                    },
-                    else => return false, // Unsupported operation
-                }
-            } else {
-                // Unary operations
-                switch (op) {
-                    .ABS => {
-                        for (0..length) |i| {
-                            d[i] = if (s1[i] < 0) -s1[i] else s1[i];
-                        },
-                    },
-                    .SQRT => {
-                        for (0..length) |i| {
-                            d[i] = std.math.sqrt(s1[i]);
-                        },
-                    },
-                    else => return false, // Unsupported operation
-                }
+                        var sum = @reduce(.Add, acc);
+                        for (src[i..n]) |x| sum +%= x;
+                        @as(*align(1) Wide, @ptrCast(result)).* = sum;
+                    }
+                },
+                inline .MIN, .MAX => |o| {
+                    @as(*align(1) T, @ptrCast(result)).* = minMax(o, src, n);
+                },
             }
-            
-            return true;
-        },
-        // Additional data types would be implemented similarly
-        else => {
-            // Generic byte-by-byte implementation for unsupported types
-            // Just a placeholder - real implementation would handle all types properly
-            return false;
-        },
+        }
+
+        fn predicate(comptime cmp: CompareOp, a: V, b: V) Mask {
+            return switch (cmp) {
+                .EQ => a == b,
+                .NE => a != b,
+                .LT => a < b,
+                .LE => a <= b,
+                .GT => a > b,
+                .GE => a >= b,
+            };
+        }
+
+        // True lanes are all-ones for integers and -1.0 for floats
+        fn compareRun(comptime cmp: CompareOp, a: [*]align(1) const T, b: [*]align(1) const T, mask: [*]align(1) T, n: usize) void {
+            const on: V = @splat(if (is_float) -1.0 else if (is_signed) -1 else std.math.maxInt(T));
+            const off: V = @splat(0);
+            var i: usize = 0;
+            while (i + N <= n) : (i += N) {
+                store(mask, i, @select(T, predicate(cmp, load(a, i), load(b, i)), on, off));
+            }
+
+            if (i < n) {
+                const rest = n - i;
+                var ta = [_]T{0} ** N;
+                var tb = [_]T{0} ** N;
+                @memcpy(ta[0..rest], a[i..n]);
+                @memcpy(tb[0..rest], b[i..n]);
+                const result: [N]T = @select(T, predicate(cmp, ta, tb), on, off);
+                @memcpy(mask[i..n], result[0..rest]);
+            }
+        }
+
+        pub fn compare(cmp: CompareOp, a: [*]align(1) const T, b: [*]align(1) const T, mask: [*]align(1) T, n: usize) void {
+            switch (cmp) {
+                inline else => |c_op| compareRun(c_op, a, b, mask, n),
+            }
+        }
+
+        // d[i] = mask[i] != 0 ? s[i] : d[i]
+        pub fn blend(d: [*]align(1) T, s: [*]align(1) const T, mask: [*]align(1) const T, n: usize) void {
+            const Bits = std.meta.Int(.unsigned, @bitSizeOf(T));
+            const m: [*]align(1) const Bits = @ptrCast(mask);
+            for (0..n) |i| {
+                if (m[i] != 0) d[i] = s[i];
+            }
+        }
+    };
+}
+
+// Scratch space for masked operations, processed one chunk at a time
+const masked_chunk_bytes = 4096;
+
+// Compute a chunk into scratch space, then blend it into dst where the mask
+// is set. FMA reads its addend from dst, so the scratch starts as a copy
+fn maskedOp(comptime T: type, comptime N: comptime_int, op: VectorOp, a: [*]align(1) const T, b: ?[*]align(1) const T, d: [*]align(1) T, n: usize, mask: *VectorMask) bool {
+    const K = Kernels(T, N);
+    if (mask.mask_data == null or getElementSize(mask.type) != @sizeOf(T) or mask.mask_size / @sizeOf(T) < n) {
+        return false;
+    }
+
+    const m: [*]align(1) const T = @ptrCast(mask.mask_data.?);
+    var scratch: [masked_chunk_bytes / @sizeOf(T)]T align(64) = undefined;
+    var start: usize = 0;
+    while (start < n) : (start += scratch.len) {
+        const count = @min(n - start, scratch.len);
+        if (op == .FMA) @memcpy(scratch[0..count], d[start .. start + count]);
+        const b_chunk: ?[*]align(1) const T = if (b) |p| p + start else null;
+        if (!K.elementwise(op, a + start, b_chunk, &scratch, count)) return false;
+        K.blend(d + start, &scratch, m + start, count);
     }
+    return true;
 }
 
-// SSE2 implementation
-fn sse2Op(op: VectorOp, src1: *anyopaque, src2: ?*anyopaque, dst: *anyopaque, elem_size: usize, length: usize, data_type: VectorDataType) bool {
-    _ = elem_size; // Unused in this example
+fn typedOp(comptime T: type, comptime N: comptime_int, op: VectorOp, src1: *anyopaque, src2: ?*anyopaque, dst: *anyopaque, length: usize, mask: ?*VectorMask) bool {
+    const a: [*]align(1) const T = @ptrCast(src1);
+    const b: ?[*]align(1) const T = if (src2) |p| @ptrCast(p) else null;
+    const d: [*]align(1) T = @ptrCast(dst);
 
-    // SSE2 implementation would go here using Zig's SIMD vectors
-    // This is a placeholder that falls back to scalar for simplicity
+    if (mask) |m| return maskedOp(T, N, op, a, b, d, length, m);
+    return Kernels(T, N).elementwise(op, a, b, d, length);
+}
 
-    // In a real implementation, we'd use Zig's SIMD vectors or inline assembly
-    // to leverage SSE2 instructions
+// Dispatch on element type; SCALAR runs the kernels one lane wide, every
+// other SIMD type at the compile target's native width
+fn dispatch(op: VectorOp, src1: *anyopaque, src2: ?*anyopaque, dst: *anyopaque, elem_size: usize, length: usize, data_type: VectorDataType, simd_type: SIMDType, mask: ?*VectorMask) bool {
+    if (elem_size != getElementSize(data_type)) return false;
 
-    return scalarOp(op, src1, src2, dst, elem_size, length, data_type);
+    switch (data_type) {
+        inline else => |dt| {
+            const T = ElemType(dt);
+            if (simd_type == .SCALAR) {
+                return typedOp(T, 1, op, src1, src2, dst, length, mask);
+            }
+            return typedOp(T, nativeLanes(T), op, src1, src2, dst, length, mask);
+        },
+    }
 }
 
 // C bindings for the Zig implementation
@@ -512,6 +640,41 @@ pub export fn goo_zig_vectorization_execute(vec_op: ?*anyopaque) bool {
     return op.execute();
 }
 
+// Kernel entry points with the C kernel signatures of goo_vectorization.c,
+// so the C runtime can delegate to them (see GOO_USE_ZIG_KERNELS there)
+pub export fn goo_zig_vector_elementwise(op: c_int, src1: ?*anyopaque, src2: ?*anyopaque, dst: ?*anyopaque, elem_size: usize, length: usize, data_type: c_int) bool {
+    const vec_op = std.meta.intToEnum(VectorOp, op) catch return false;
+    const dt = std.meta.intToEnum(VectorDataType, data_type) catch return false;
+    if (src1 == null or dst == null) return false;
+    return dispatch(vec_op, src1.?, src2, dst.?, elem_size, length, dt, .AUTO, null);
+}
+
+pub export fn goo_zig_vector_reduce(op: c_int, src: ?*const anyopaque, length: usize, data_type: c_int, result: ?*anyopaque) void {
+    const reduce_op = std.meta.intToEnum(ReduceOp, op) catch return;
+    const dt = std.meta.intToEnum(VectorDataType, data_type) catch return;
+    if (src == null or result == null or length == 0) return;
+
+    switch (dt) {
+        inline else => |t| {
+            const T = ElemType(t);
+            Kernels(T, nativeLanes(T)).reduce(reduce_op, @ptrCast(src.?), length, result.?);
+        },
+    }
+}
+
+pub export fn goo_zig_vector_compare(cmp: c_int, a: ?*const anyopaque, b: ?*const anyopaque, length: usize, data_type: c_int, mask: ?*anyopaque) void {
+    const cmp_op = std.meta.intToEnum(CompareOp, cmp) catch return;
+    const dt = std.meta.intToEnum(VectorDataType, data_type) catch return;
+    if (a == null or b == null or mask == null) return;
+
+    switch (dt) {
+        inline else => |t| {
+            const T = ElemType(t);
+            Kernels(T, nativeLanes(T)).compare(cmp_op, @ptrCast(a.?), @ptrCast(b.?), @ptrCast(mask.?), length);
+        },
+    }
+}
+
 pub export fn goo_zig_vectorization_alloc_aligned(size: usize, simd_type: c_int) ?*anyopaque {
     return allocAligned(size, @enumFromInt(simd_type));
 }
@@ -519,3 +682,257 @@ pub export fn goo_zig_vectorization_alloc_aligned(size: usize, simd_type: c_int)
 pub export fn goo_zig_vectorization_free_aligned(ptr: ?*anyopaque) void {
     freeAligned(ptr);
 }
+
+// =======================================
+// Tests against the C scalar kernels
+// =======================================
+
+// The C runtime; its GOO_SIMD_SCALAR kernels are the reference
+const c_vec = @cImport({
+    @cInclude("goo_vectorization.h");
+});
+
+const test_lengths = [_]usize{ 1, 3, 17, 64, 255, 1000 };
+const max_test_length = 1000;
+
+// xorshift, as in tests/runtime/vectorization_test.c
+const TestRng = struct {
+    state: u64 = 0x9e3779b97f4a7c15,
+
+    fn next(self: *TestRng) u64 {
+        self.state ^= self.state >> 12;
+        self.state ^= self.state << 25;
+        self.state ^= self.state >> 27;
+        return self.state *% 0x2545f4914f6cdd1d;
+    }
+};
+
+// Random element with edge values (0, 1, -1, MIN, MAX, tiny, huge) mixed
+// in. Divisors are never zero or near zero; small floats are integers below
+// 1000 in magnitude so sums are exact in any order
+fn randomElement(comptime T: type, rng: *TestRng, divisor: bool, small: bool) T {
+    const r = rng.next();
+    const edge = (r & 7) == 0;
+    const which = (r >> 3) % 5;
+
+    if (T == f32 or T == f64) {
+        if (small) return @floatFromInt(@as(i64, @intCast((r >> 32) % 2001)) - 1000);
+        const edges = [_]f64{ 0.0, -0.0, 1e-30, -1e30, 1.0 };
+        var value: f64 = if (edge) edges[which] else @as(f64, @floatFromInt(@as(i32, @bitCast(@as(u32, @truncate(r >> 32)))))) / 1024.0;
+        if (divisor and @abs(value) < 1e-6) value = 1.0;
+        return @floatCast(value);
+    }
+
+    const U = std.meta.Int(.unsigned, @bitSizeOf(T));
+    var bits: U = @truncate(r >> 8);
+    if (edge) {
+        bits = switch (which) {
+            0 => 0,
+            1 => 1,
+            2 => std.math.maxInt(U),
+            3 => @bitCast(@as(T, std.math.minInt(T))),
+            else => @bitCast(@as(T, std.math.maxInt(T))),
+        };
+    }
+    if (divisor and bits == 0) bits = 1;
+    return @bitCast(bits);
+}
+
+fn fillRandom(comptime T: type, rng: *TestRng, buf: []T, divisor: bool, small: bool) void {
+    for (buf) |*x| x.* = randomElement(T, rng, divisor, small);
+}
+
+// Elements match when bit-identical, or both NaN
+fn expectSameElements(comptime T: type, expected: []const T, actual: []const T, what: []const u8) !void {
+    for (expected, actual, 0..) |e, a, i| {
+        const same = if (T == f32 or T == f64)
+            @as(std.meta.Int(.unsigned, @bitSizeOf(T)), @bitCast(e)) == @as(std.meta.Int(.unsigned, @bitSizeOf(T)), @bitCast(a)) or (std.math.isNan(e) and std.math.isNan(a))
+        else
+            e == a;
+        if (!same) {
+            std.debug.print("{s} {s} differs from C scalar at index {d} (length {d}): {any} != {any}\n", .{ @typeName(T), what, i, expected.len, a, e });
+            return error.TestExpectedEqual;
+        }
+    }
+}
+
+// Buffer whose elements start one byte past an element boundary, so the
+// Zig kernels see the unaligned pointers C callers may pass
+fn UnalignedBuffer(comptime T: type) type {
+    return struct {
+        bytes: [max_test_length * @sizeOf(T) + 1]u8 align(@alignOf(T)) = undefined,
+
+        fn ptr(self: *@This()) [*]align(1) T {
+            return @ptrCast(&self.bytes[1]);
+        }
+    };
+}
+
+fn cScalarOp(comptime dt: VectorDataType, op: VectorOp, a: ?*anyopaque, b: ?*anyopaque, d: ?*anyopaque, length: usize, mask: ?*c_vec.GooVectorMask) bool {
+    var vec_op = std.mem.zeroes(c_vec.GooVectorOperation);
+    vec_op.base.src1 = a;
+    vec_op.base.src2 = b;
+    vec_op.base.dst = d;
+    vec_op.base.elem_size = @sizeOf(ElemType(dt));
+    vec_op.base.length = length;
+    vec_op.base.op = @intCast(@intFromEnum(op));
+    vec_op.simd_type = c_vec.GOO_SIMD_SCALAR;
+    vec_op.data_type = @intCast(@intFromEnum(dt));
+    vec_op.mask = mask;
+    return c_vec.goo_vectorization_execute(&vec_op);
+}
+
+fn expectElementwiseMatchesC(comptime dt: VectorDataType, op: VectorOp) !void {
+    const T = ElemType(dt);
+    var rng = TestRng{};
+    var a: [max_test_length]T = undefined;
+    var b: [max_test_length]T = undefined;
+    var expected: [max_test_length]T = undefined;
+    var ua = UnalignedBuffer(T){};
+    var ub = UnalignedBuffer(T){};
+    var ud = UnalignedBuffer(T){};
+
+    for (test_lengths) |n| {
+        fillRandom(T, &rng, a[0..n], false, false);
+        fillRandom(T, &rng, b[0..n], op == .DIV, false);
+        @memcpy(ua.ptr()[0..n], a[0..n]);
+        @memcpy(ub.ptr()[0..n], b[0..n]);
+
+        try std.testing.expect(cScalarOp(dt, op, &a, &b, &expected, n, null));
+        try std.testing.expect(goo_zig_vector_elementwise(@intFromEnum(op), ua.ptr(), ub.ptr(), ud.ptr(), @sizeOf(T), n, @intFromEnum(dt)));
+
+        var actual: [max_test_length]T = undefined;
+        @memcpy(actual[0..n], ud.ptr()[0..n]);
+        try expectSameElements(T, expected[0..n], actual[0..n], @tagName(op));
+    }
+}
+
+fn expectMaskedAddMatchesC(comptime dt: VectorDataType) !void {
+    const T = ElemType(dt);
+    var rng = TestRng{};
+    var a: [max_test_length]T = undefined;
+    var b: [max_test_length]T = undefined;
+    var expected: [max_test_length]T = undefined;
+    var mask: [max_test_length]T = undefined;
+    var ua = UnalignedBuffer(T){};
+    var ub = UnalignedBuffer(T){};
+    var ud = UnalignedBuffer(T){};
+    var um = UnalignedBuffer(T){};
+
+    for (test_lengths) |n| {
+        fillRandom(T, &rng, a[0..n], false, false);
+        fillRandom(T, &rng, b[0..n], false, false);
+        fillRandom(T, &rng, expected[0..n], false, false);
+        for (mask[0..n]) |*m| m.* = if (rng.next() & 1 == 0) 0 else 1;
+        @memcpy(ua.ptr()[0..n], a[0..n]);
+        @memcpy(ub.ptr()[0..n], b[0..n]);
+        @memcpy(ud.ptr()[0..n], expected[0..n]);
+        @memcpy(um.ptr()[0..n], mask[0..n]);
+
+        var c_mask = c_vec.GooVectorMask{
+            .mask_data = &mask,
+            .mask_size = n * @sizeOf(T),
+            .type = @intCast(@intFromEnum(dt)),
+        };
+        try std.testing.expect(cScalarOp(dt, .ADD, &a, &b, &expected, n, &c_mask));
+
+        var zig_mask = VectorMask{ .mask_data = um.ptr(), .mask_size = n * @sizeOf(T), .type = dt };
+        try std.testing.expect(dispatch(.ADD, ua.ptr(), ub.ptr(), ud.ptr(), @sizeOf(T), n, dt, .AUTO, &zig_mask));
+
+        var actual: [max_test_length]T = undefined;
+        @memcpy(actual[0..n], ud.ptr()[0..n]);
+        try expectSameElements(T, expected[0..n], actual[0..n], "masked ADD");
+    }
+}
+
+fn expectReduceMatchesC(comptime dt: VectorDataType, op: ReduceOp) !void {
+    const T = ElemType(dt);
+    var rng = TestRng{};
+    var a: [max_test_length]T = undefined;
+    var ua = UnalignedBuffer(T){};
+
+    for (test_lengths) |n| {
+        fillRandom(T, &rng, a[0..n], false, op == .SUM);
+        @memcpy(ua.ptr()[0..n], a[0..n]);
+
+        // Integer sums are 64 bits wide, everything else an element
+        var expected: u64 = 0;
+        var actual: u64 = 0;
+        try std.testing.expect(c_vec.goo_vectorization_reduce(@intCast(@intFromEnum(op)), &a, n, @intCast(@intFromEnum(dt)), &expected));
+        goo_zig_vector_reduce(@intFromEnum(op), ua.ptr(), n, @intFromEnum(dt), &actual);
+        if (expected != actual) {
+            std.debug.print("{s} {s} differs from C scalar (length {d}): {x} != {x}\n", .{ @typeName(T), @tagName(op), n, actual, expected });
+            return error.TestExpectedEqual;
+        }
+    }
+}
+
+fn expectCompareMatchesC(comptime dt: VectorDataType, cmp: CompareOp) !void {
+    const T = ElemType(dt);
+    var rng = TestRng{};
+    var a: [max_test_length]T = undefined;
+    var b: [max_test_length]T = undefined;
+    var expected: [max_test_length]T = undefined;
+    var ua = UnalignedBuffer(T){};
+    var ub = UnalignedBuffer(T){};
+    var um = UnalignedBuffer(T){};
+
+    for (test_lengths) |n| {
+        fillRandom(T, &rng, a[0..n], false, false);
+        fillRandom(T, &rng, b[0..n], false, false);
+        // Equal pairs so EQ, LE and GE see both outcomes
+        for (a[0..n], b[0..n]) |x, *y| {
+            if (rng.next() & 3 == 0) y.* = x;
+        }
+        @memcpy(ua.ptr()[0..n], a[0..n]);
+        @memcpy(ub.ptr()[0..n], b[0..n]);
+
+        var c_mask = c_vec.GooVectorMask{
+            .mask_data = &expected,
+            .mask_size = n * @sizeOf(T),
+            .type = @intCast(@intFromEnum(dt)),
+        };
+        try std.testing.expect(c_vec.goo_vectorization_compare(@intCast(@intFromEnum(cmp)), &a, &b, n, @intCast(@intFromEnum(dt)), &c_mask));
+        goo_zig_vector_compare(@intFromEnum(cmp), ua.ptr(), ub.ptr(), n, @intFromEnum(dt), um.ptr());
+
+        var actual: [max_test_length]T = undefined;
+        @memcpy(actual[0..n], um.ptr()[0..n]);
+        try expectSameElements(T, expected[0..n], actual[0..n], @tagName(cmp));
+    }
+}
+
+test "elementwise kernels match the C scalar kernels on unaligned buffers" {
+    inline for (comptime std.enums.values(VectorDataType)) |dt| {
+        for ([_]VectorOp{ .ADD, .SUB, .MUL, .DIV }) |op| {
+            try expectElementwiseMatchesC(dt, op);
+        }
+    }
+}
+
+test "masked elementwise kernels match the C scalar kernels on unaligned buffers" {
+    inline for (comptime std.enums.values(VectorDataType)) |dt| {
+        try expectMaskedAddMatchesC(dt);
+    }
+}
+
+test "reductions match the C scalar kernels on unaligned buffers" {
+    _ = c_vec.goo_vectorization_init(c_vec.GOO_SIMD_SCALAR);
+    defer c_vec.goo_vectorization_cleanup();
+
+    inline for (comptime std.enums.values(VectorDataType)) |dt| {
+        for (std.enums.values(ReduceOp)) |op| {
+            try expectReduceMatchesC(dt, op);
+        }
+    }
+}
+
+test "comparisons match the C scalar kernels on unaligned buffers" {
+    _ = c_vec.goo_vectorization_init(c_vec.GOO_SIMD_SCALAR);
+    defer c_vec.goo_vectorization_cleanup();
+
+    inline for (comptime std.enums.values(VectorDataType)) |dt| {
+        for (std.enums.values(CompareOp)) |cmp| {
+            try expectCompareMatchesC(dt, cmp);
+        }
+    }
+}
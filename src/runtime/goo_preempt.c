@@ -0,0 +1,222 @@
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+
+#include "goo_runtime.h"
+#include "goo_preempt.h"
+
+// Per-worker preemption request flag, polled by compiled code
+__thread _Atomic int32_t goo_preempt_requested = 0;
+
+// Monitor-visible state of one worker thread
+typedef struct {
+    _Atomic int32_t* flag;            // The worker's goo_preempt_requested
+    _Atomic uint64_t slice_start_ns;  // Start of the current slice (0 = idle)
+    bool used;
+} GooPreemptSlot;
+
+// Slots are only claimed and released under slots_mutex, which the monitor
+// also holds while scanning, so it never touches an exited thread's flag
+static GooPreemptSlot preempt_slots[GOO_PREEMPT_MAX_WORKERS];
+static pthread_mutex_t slots_mutex = PTHREAD_MUTEX_INITIALIZER;
+static __thread int worker_slot = -1;
+
+// Monitor thread state
+static pthread_t monitor_thread;
+static pthread_mutex_t monitor_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t monitor_cond = PTHREAD_COND_INITIALIZER;
+static bool monitor_running = false;
+static _Atomic int time_slice_us = GOO_DEFAULT_TIME_SLICE_US;
+
+// Statistics
+static _Atomic uint64_t preempt_requests = 0;
+static _Atomic uint64_t preempt_yields = 0;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Flag every worker whose goroutine has used up its slice
+static void goo_preempt_scan(uint64_t slice_ns) {
+    uint64_t now = now_ns();
+
+    pthread_mutex_lock(&slots_mutex);
+    for (int i = 0; i < GOO_PREEMPT_MAX_WORKERS; i++) {
+        GooPreemptSlot* slot = &preempt_slots[i];
+        if (!slot->used) continue;
+
+        uint64_t start = atomic_load_explicit(&slot->slice_start_ns, memory_order_relaxed);
+        if (start == 0 || now - start < slice_ns) continue;
+
+        // Restart the slice so an ignored request is repeated one slice later
+        atomic_store_explicit(&slot->slice_start_ns, now, memory_order_relaxed);
+        atomic_store_explicit(slot->flag, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&preempt_requests, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&slots_mutex);
+}
+
+// Monitor thread: wakes twice per slice and issues preemption requests
+static void* goo_preempt_monitor(void* arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&monitor_mutex);
+    while (monitor_running) {
+        int slice = atomic_load(&time_slice_us);
+        uint64_t wait_ns = slice > 0 ? (uint64_t)slice * 500 : 100000000ull;
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)(wait_ns / 1000000000ull);
+        deadline.tv_nsec += (long)(wait_ns % 1000000000ull);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        int rc = pthread_cond_timedwait(&monitor_cond, &monitor_mutex, &deadline);
+        if (rc == ETIMEDOUT && monitor_running && slice > 0) {
+            pthread_mutex_unlock(&monitor_mutex);
+            goo_preempt_scan((uint64_t)slice * 1000);
+            pthread_mutex_lock(&monitor_mutex);
+        }
+    }
+    pthread_mutex_unlock(&monitor_mutex);
+
+    return NULL;
+}
+
+// Start the preemption monitor
+bool goo_preempt_init(int slice_us) {
+    pthread_mutex_lock(&monitor_mutex);
+
+    if (monitor_running) {
+        pthread_mutex_unlock(&monitor_mutex);
+        return true;
+    }
+
+    atomic_store(&time_slice_us, slice_us > 0 ? slice_us : GOO_DEFAULT_TIME_SLICE_US);
+    monitor_running = true;
+
+    if (pthread_create(&monitor_thread, NULL, goo_preempt_monitor, NULL) != 0) {
+        monitor_running = false;
+        pthread_mutex_unlock(&monitor_mutex);
+        fprintf(stderr, "Error: Failed to start preemption monitor\n");
+        return false;
+    }
+
+    pthread_mutex_unlock(&monitor_mutex);
+    return true;
+}
+
+// Stop the preemption monitor
+void goo_preempt_shutdown(void) {
+    pthread_mutex_lock(&monitor_mutex);
+    if (!monitor_running) {
+        pthread_mutex_unlock(&monitor_mutex);
+        return;
+    }
+    monitor_running = false;
+    pthread_cond_signal(&monitor_cond);
+    pthread_mutex_unlock(&monitor_mutex);
+
+    pthread_join(monitor_thread, NULL);
+}
+
+// Change the time slice
+void goo_preempt_set_time_slice(int slice_us) {
+    atomic_store(&time_slice_us, slice_us > 0 ? slice_us : 0);
+
+    // Apply the new slice without waiting out the old one
+    pthread_mutex_lock(&monitor_mutex);
+    pthread_cond_signal(&monitor_cond);
+    pthread_mutex_unlock(&monitor_mutex);
+}
+
+// Get the current time slice
+int goo_preempt_get_time_slice(void) {
+    return atomic_load(&time_slice_us);
+}
+
+// Register the calling thread as a worker
+bool goo_preempt_register_worker(void) {
+    if (worker_slot >= 0) return true;
+
+    pthread_mutex_lock(&slots_mutex);
+    for (int i = 0; i < GOO_PREEMPT_MAX_WORKERS; i++) {
+        if (!preempt_slots[i].used) {
+            preempt_slots[i].flag = &goo_preempt_requested;
+            atomic_store_explicit(&preempt_slots[i].slice_start_ns, 0, memory_order_relaxed);
+            preempt_slots[i].used = true;
+            worker_slot = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&slots_mutex);
+
+    // Unwatched workers still run; they just are never asked to yield
+    return worker_slot >= 0;
+}
+
+// Unregister the calling worker thread
+void goo_preempt_unregister_worker(void) {
+    if (worker_slot < 0) return;
+
+    pthread_mutex_lock(&slots_mutex);
+    preempt_slots[worker_slot].used = false;
+    preempt_slots[worker_slot].flag = NULL;
+    pthread_mutex_unlock(&slots_mutex);
+
+    worker_slot = -1;
+}
+
+// Mark the start of a goroutine on this worker
+void goo_preempt_task_begin(void) {
+    atomic_store_explicit(&goo_preempt_requested, 0, memory_order_relaxed);
+    if (worker_slot >= 0) {
+        atomic_store_explicit(&preempt_slots[worker_slot].slice_start_ns, now_ns(),
+                              memory_order_relaxed);
+    }
+}
+
+// Mark the end of a goroutine on this worker
+void goo_preempt_task_end(void) {
+    if (worker_slot >= 0) {
+        atomic_store_explicit(&preempt_slots[worker_slot].slice_start_ns, 0,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&goo_preempt_requested, 0, memory_order_relaxed);
+}
+
+// Safepoint slow path: let queued goroutines run, then continue
+void goo_safepoint_yield(void) {
+    atomic_store_explicit(&goo_preempt_requested, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&preempt_yields, 1, memory_order_relaxed);
+
+    if (worker_slot >= 0) {
+        atomic_store_explicit(&preempt_slots[worker_slot].slice_start_ns, now_ns(),
+                              memory_order_relaxed);
+    }
+
+    // Goroutines cannot be suspended mid-stack, so queued work is handed to a
+    // spare worker and the OS time-slices it against this one
+    goo_thread_pool_handoff();
+    sched_yield();
+}
+
+// Get preemption statistics
+void goo_preempt_stats(uint64_t* requests, uint64_t* yields) {
+    if (requests) *requests = atomic_load(&preempt_requests);
+    if (yields) *yields = atomic_load(&preempt_yields);
+}
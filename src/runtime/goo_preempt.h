@@ -0,0 +1,53 @@
+#ifndef GOO_PREEMPT_H
+#define GOO_PREEMPT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Cooperative preemption for goroutines.
+//
+// Compiled code polls goo_preempt_requested at loop back-edges and function
+// prologues and calls goo_safepoint_yield when it is set. A monitor thread
+// sets the flag on any worker that has run the same goroutine for longer
+// than the time slice, so a tight loop cannot starve goroutines queued
+// behind it.
+
+// Default time slice in microseconds
+#define GOO_DEFAULT_TIME_SLICE_US 10000
+
+// Maximum number of worker threads the monitor tracks
+#define GOO_PREEMPT_MAX_WORKERS 256
+
+// Per-worker preemption request flag, polled by compiled code
+extern __thread _Atomic int32_t goo_preempt_requested;
+
+// Start the preemption monitor (time_slice_us <= 0 uses the default)
+bool goo_preempt_init(int time_slice_us);
+
+// Stop the preemption monitor
+void goo_preempt_shutdown(void);
+
+// Change the time slice; 0 disables preemption requests
+void goo_preempt_set_time_slice(int time_slice_us);
+
+// Get the current time slice in microseconds
+int goo_preempt_get_time_slice(void);
+
+// Register the calling thread as a worker the monitor watches
+bool goo_preempt_register_worker(void);
+
+// Unregister the calling worker thread
+void goo_preempt_unregister_worker(void);
+
+// Mark the start and end of a goroutine on the calling worker
+void goo_preempt_task_begin(void);
+void goo_preempt_task_end(void);
+
+// Safepoint slow path, called by compiled code when the flag is set
+void goo_safepoint_yield(void);
+
+// Number of preemption requests issued and safepoint yields taken
+void goo_preempt_stats(uint64_t* requests, uint64_t* yields);
+
+#endif // GOO_PREEMPT_H
@@ -16,6 +16,7 @@
 #include <time.h>
 #include <errno.h>
 #include <setjmp.h>
+#include <stdatomic.h>
 
 #include "../include/goo_runtime.h"
 #include "../include/memory/scoped_alloc.h"
@@ -23,6 +24,9 @@
 #include "../include/meta/reflection.h"
 #include "../include/parallel/parallel.h"
 #include "../include/messaging/messaging.h"
+#include "goo_preempt.h"
+#include "goo_task_region.h"
+#include "memory/goo_allocator.h"
 
 // Forward declarations of subsystem initialization functions
 extern bool goo_memory_init(void);
@@ -37,6 +41,7 @@ __thread void* goo_panic_value = NULL;
 // Thread pool configuration
 #define GOO_DEFAULT_THREAD_POOL_SIZE 16
 #define GOO_MAX_QUEUED_TASKS 1024
+#define GOO_MAX_SPARE_WORKERS 16
 
 // Thread pool state
 typedef struct {
@@ -47,6 +52,7 @@ typedef struct {
     int queue_head;
     int queue_tail;
     int queue_size;
+    int spare_workers;  // Temporary workers started by safepoint handoffs
     bool shutdown;
 } GooThreadPool;
 
@@ -107,6 +113,11 @@ bool goo_thread_pool_init(int thread_count) {
         return false;
     }
     
+    global_thread_pool->spare_workers = 0;
+    
+    // Start the preemption monitor so long-running goroutines reach safepoints
+    goo_preempt_init(GOO_DEFAULT_TIME_SLICE_US);
+    
     // Create worker threads
     for (int i = 0; i < thread_count; i++) {
         if (pthread_create(&global_thread_pool->threads[i], NULL, goo_worker_thread, NULL) != 0) {
@@ -134,6 +145,15 @@ void goo_thread_pool_cleanup() {
         pthread_join(global_thread_pool->threads[i], NULL);
     }
     
+    // Spare workers are detached; wait for them to drain
+    pthread_mutex_lock(&global_thread_pool->queue_mutex);
+    while (global_thread_pool->spare_workers > 0) {
+        pthread_cond_wait(&global_thread_pool->queue_cond, &global_thread_pool->queue_mutex);
+    }
+    pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+    
+    goo_preempt_shutdown();
+    
     // Clean up remaining tasks
     while (global_thread_pool->queue_size > 0) {
         GooTask* task = global_thread_pool->task_queue[global_thread_pool->queue_head];
@@ -152,7 +172,40 @@ void goo_thread_pool_cleanup() {
 }
 
 // Worker thread function
+// Run one task with panic recovery
+static void goo_run_task(GooTask* task) {
+    jmp_buf recover_buf;
+    jmp_buf* old_recover_point = goo_recover_point;
+    GooAllocator* previous_allocator = NULL;
+    bool in_region = goo_task_region_enter(&previous_allocator);
+    
+    goo_preempt_task_begin();
+    
+    if (setjmp(recover_buf) == 0) {
+        goo_recover_point = &recover_buf;
+        task->func(task->arg);
+    } else {
+        // Panic occurred, handle according to supervision policy
+        if (task->supervisor) {
+            goo_supervise_handle_error(task->supervisor, task, goo_panic_value);
+        } else {
+            fprintf(stderr, "Unhandled panic in goroutine: %p\n", goo_panic_value);
+        }
+    }
+    
+    goo_preempt_task_end();
+    goo_recover_point = old_recover_point;
+    
+    // After the supervisor has seen the panic value, which may live in the region
+    if (in_region) {
+        goo_task_region_exit(previous_allocator);
+    }
+    free(task);
+}
+
 void* goo_worker_thread(void* arg) {
+    goo_preempt_register_worker();
+    
     while (true) {
         // Get a task from the queue
         pthread_mutex_lock(&global_thread_pool->queue_mutex);
@@ -163,6 +216,8 @@ void* goo_worker_thread(void* arg) {
         
         if (global_thread_pool->shutdown && global_thread_pool->queue_size == 0) {
             pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+            goo_task_region_destroy();
+            goo_preempt_unregister_worker();
             return NULL;
         }
         
@@ -172,29 +227,65 @@ void* goo_worker_thread(void* arg) {
         
         pthread_mutex_unlock(&global_thread_pool->queue_mutex);
         
-        // Execute the task with panic recovery
-        jmp_buf recover_buf;
-        jmp_buf* old_recover_point = goo_recover_point;
+        goo_run_task(task);
+    }
+    
+    return NULL;
+}
+
+// Spare worker: runs queued tasks until the queue is empty, then exits
+static void* goo_spare_worker_thread(void* arg) {
+    (void)arg;
+    goo_preempt_register_worker();
+    
+    while (true) {
+        pthread_mutex_lock(&global_thread_pool->queue_mutex);
         
-        if (setjmp(recover_buf) == 0) {
-            goo_recover_point = &recover_buf;
-            task->func(task->arg);
-        } else {
-            // Panic occurred, handle according to supervision policy
-            if (task->supervisor) {
-                goo_supervise_handle_error(task->supervisor, task, goo_panic_value);
-            } else {
-                fprintf(stderr, "Unhandled panic in goroutine: %p\n", goo_panic_value);
-            }
+        if (global_thread_pool->queue_size == 0) {
+            global_thread_pool->spare_workers--;
+            pthread_cond_broadcast(&global_thread_pool->queue_cond);
+            pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+            break;
         }
         
-        goo_recover_point = old_recover_point;
-        free(task);
+        GooTask* task = global_thread_pool->task_queue[global_thread_pool->queue_head];
+        global_thread_pool->queue_head = (global_thread_pool->queue_head + 1) % GOO_MAX_QUEUED_TASKS;
+        global_thread_pool->queue_size--;
+        
+        pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+        
+        goo_run_task(task);
     }
     
+    goo_task_region_destroy();
+    goo_preempt_unregister_worker();
     return NULL;
 }
 
+// Start a spare worker if goroutines are queued behind a preempted one
+void goo_thread_pool_handoff(void) {
+    if (!global_thread_pool) return;
+    
+    pthread_mutex_lock(&global_thread_pool->queue_mutex);
+    
+    if (global_thread_pool->queue_size == 0 ||
+        global_thread_pool->spare_workers >= GOO_MAX_SPARE_WORKERS) {
+        pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+        return;
+    }
+    
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, goo_spare_worker_thread, NULL) == 0) {
+        global_thread_pool->spare_workers++;
+    }
+    pthread_attr_destroy(&attr);
+    
+    pthread_mutex_unlock(&global_thread_pool->queue_mutex);
+}
+
 // Schedule a task to run on the thread pool
 bool goo_schedule_task(GooTask* task) {
     if (!global_thread_pool && !goo_thread_pool_init()) {
@@ -8,14 +8,18 @@
 #include <time.h>
 #include <errno.h>
 
+// The supervisor layout below replaces the one in goo_runtime.h
+#define GOO_SUPERVISOR_PRIVATE
+
 #include "goo_runtime.h"
 #include "goo_error.h"
+#include "goo_task_group.h"
 
 // Supervisor structure
 struct GooSupervisor {
     GooSuperviseChild** children;
     int child_count;
-    int restart_policy;
+    GooSupervisionPolicy restart_policy;
     int max_restarts;
     int time_window;
     int restart_count;
@@ -34,6 +38,9 @@ struct GooSupervisor {
     
     // Dynamic child creation
     bool dynamic_children; // Whether children can be added after start
+    
+    // Structured concurrency
+    GooTaskGroup* task_group; // Owns goroutines spawned by children
 };
 
 // Child task wrapper
@@ -47,6 +54,7 @@ static void* goo_supervise_child_runner(void* arg);
 static void goo_supervise_restart_child_and_dependents(GooSupervisor* supervisor, int child_index);
 static bool goo_build_dependency_tree(GooSupervisor* supervisor);
 static void goo_free_dependency_tree(GooSupervisor* supervisor);
+static void goo_supervise_reset_task_group(GooSupervisor* supervisor);
 
 // Create a new supervisor
 GooSupervisor* goo_supervise_init(void) {
@@ -70,7 +78,16 @@ GooSupervisor* goo_supervise_init(void) {
     supervisor->child_deps = NULL;
     supervisor->dynamic_children = false;
     
+    supervisor->task_group = goo_task_group_create(NULL, 0);
+    if (!supervisor->task_group) {
+        free(supervisor->name);
+        free(supervisor);
+        return NULL;
+    }
+    goo_task_group_set_supervisor(supervisor->task_group, supervisor);
+    
     if (pthread_mutex_init(&supervisor->mutex, NULL) != 0) {
+        goo_task_group_release(supervisor->task_group);
         free(supervisor->name);
         free(supervisor);
         return NULL;
@@ -83,6 +100,15 @@ GooSupervisor* goo_supervise_init(void) {
 void goo_supervise_free(GooSupervisor* supervisor) {
     if (!supervisor) return;
     
+    // Cancel and join goroutines spawned by children before tearing down
+    pthread_mutex_lock(&supervisor->mutex);
+    GooTaskGroup* task_group = supervisor->task_group;
+    supervisor->task_group = NULL;
+    pthread_mutex_unlock(&supervisor->mutex);
+    
+    goo_task_group_cancel(task_group);
+    goo_task_group_destroy(task_group);
+    
     pthread_mutex_lock(&supervisor->mutex);
     
     // Cleanup any shared state
@@ -243,7 +269,7 @@ bool goo_supervise_set_dependency(GooSupervisor* supervisor, int child_index, in
 }
 
 // Set supervisor policy
-void goo_supervise_set_policy(GooSupervisor* supervisor, int policy, int max_restarts, int time_window) {
+void goo_supervise_set_policy(GooSupervisor* supervisor, GooSupervisionPolicy policy, int max_restarts, int time_window) {
     if (!supervisor) return;
     
     pthread_mutex_lock(&supervisor->mutex);
@@ -360,7 +386,8 @@ void goo_supervise_handle_error(GooSupervisor* supervisor, GooTask* failed_task,
             break;
             
         case GOO_SUPERVISE_ONE_FOR_ALL:
-            // Restart all children
+            // Cancel everything the old children spawned, then restart all children
+            goo_supervise_reset_task_group(supervisor);
             for (int i = 0; i < supervisor->child_count; i++) {
                 goo_supervise_restart_child(supervisor, i);
             }
@@ -384,9 +411,21 @@ static void* goo_supervise_child_runner(void* arg) {
     // Free the task structure
     free(task);
     
+    // Goroutines spawned by the child go in a group under the supervisor's,
+    // so their panics are reported as failures of this child
+    pthread_mutex_lock(&child->supervisor->mutex);
+    GooTaskGroup* task_group = goo_task_group_create(child->supervisor->task_group, 0);
+    pthread_mutex_unlock(&child->supervisor->mutex);
+    goo_task_group_set_owner(task_group, child->func, child->arg);
+    GooTaskGroup* previous_group = goo_task_group_set_current(task_group);
+    
     // Run the child function
     child->func(child->arg);
     
+    // Goroutines still running keep the group alive until they exit
+    goo_task_group_set_current(previous_group);
+    goo_task_group_release(task_group);
+    
     // If we get here normally (without error), mark the child as not failed
     pthread_mutex_lock(&child->supervisor->mutex);
     if (child_index < child->supervisor->child_count && 
@@ -412,18 +451,39 @@ void goo_supervise_restart_child(GooSupervisor* supervisor, int child_index) {
     // Reset failed flag
     supervisor->children[child_index]->failed = false;
     
-    // Schedule the child task
-    GooTask goo_task = {
-        .func = goo_supervise_child_runner,
-        .arg = task,
-        .supervisor = supervisor
-    };
-    
-    if (!goo_schedule_task(&goo_task)) {
+    // Spawn the child as a goroutine; the queue takes ownership of the task,
+    // and region mode gives the restarted child a fresh region
+    if (!goo_goroutine_spawn((GooTaskFunc)goo_supervise_child_runner, task, supervisor)) {
         free(task);
     }
 }
 
+// Replace the task group with a fresh one, cancelling the old one (mutex held)
+static void goo_supervise_reset_task_group(GooSupervisor* supervisor) {
+    GooTaskGroup* fresh = goo_task_group_create(NULL, 0);
+    if (!fresh) {
+        // Keep the old group; at least stop what it is running
+        goo_task_group_cancel(supervisor->task_group);
+        return;
+    }
+    goo_task_group_set_supervisor(fresh, supervisor);
+    
+    // Orphaned children drain in the background and free the old group
+    goo_task_group_abandon(supervisor->task_group);
+    supervisor->task_group = fresh;
+}
+
+// Get the task group that owns goroutines spawned by the supervisor's children
+GooTaskGroup* goo_supervise_task_group(GooSupervisor* supervisor) {
+    if (!supervisor) return NULL;
+    
+    pthread_mutex_lock(&supervisor->mutex);
+    GooTaskGroup* task_group = supervisor->task_group;
+    pthread_mutex_unlock(&supervisor->mutex);
+    
+    return task_group;
+}
+
 // Build the dependency tree (matrix)
 static bool goo_build_dependency_tree(GooSupervisor* supervisor) {
     if (!supervisor) return false;
@@ -3,13 +3,10 @@
 
 #include <stdbool.h>
 #include "goo_runtime.h"
+#include "goo_task_group.h"
 
-// Supervision restart policies
-enum {
-    GOO_SUPERVISE_ONE_FOR_ONE = 0,  // Restart only the failed child
-    GOO_SUPERVISE_ONE_FOR_ALL,       // Restart all children when one fails
-    GOO_SUPERVISE_REST_FOR_ONE       // Restart the failed child and all that depend on it
-};
+// Supervision restart policies (GOO_SUPERVISE_ONE_FOR_ONE and friends) are the
+// GooSupervisionPolicy values from goo/core/types.h
 
 // Create a new supervisor
 GooSupervisor* goo_supervise_init(void);
@@ -34,7 +31,7 @@ bool goo_supervise_register(GooSupervisor* supervisor, GooTaskFunc func, void* a
 bool goo_supervise_set_dependency(GooSupervisor* supervisor, int child_index, int depends_on_index);
 
 // Set supervisor policy
-void goo_supervise_set_policy(GooSupervisor* supervisor, int policy, int max_restarts, int time_window);
+void goo_supervise_set_policy(GooSupervisor* supervisor, GooSupervisionPolicy policy, int max_restarts, int time_window);
 
 // Start the supervisor
 bool goo_supervise_start(GooSupervisor* supervisor);
@@ -45,6 +42,10 @@ void goo_supervise_handle_error(GooSupervisor* supervisor, GooTask* failed_task,
 // Restart a specific child
 void goo_supervise_restart_child(GooSupervisor* supervisor, int child_index);
 
+// Get the task group that owns goroutines spawned by the supervisor's children.
+// It is cancelled on a one-for-all restart and joined when the supervisor is freed.
+GooTaskGroup* goo_supervise_task_group(GooSupervisor* supervisor);
+
 // High-level supervision helper functions
 // Create a supervised worker pool (parallel workers with supervision)
 GooSupervisor* goo_create_worker_pool(int worker_count, GooTaskFunc worker_func, void* shared_data);
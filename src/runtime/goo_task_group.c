@@ -0,0 +1,551 @@
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <time.h>
+#include <errno.h>
+
+#include "goo_runtime.h"
+#include "goo_task_group.h"
+
+// Panic recovery state (goo_runtime.c)
+extern __thread jmp_buf* goo_recover_point;
+extern __thread void* goo_panic_value;
+
+// Task group structure
+struct GooTaskGroup {
+    GooTaskGroup* parent;
+    GooTaskGroup* first_child;   // Child groups (guarded by mutex)
+    GooTaskGroup* next_sibling;  // Link in the parent's child list
+    GooSupervisor* supervisor;
+    GooTaskFunc owner_func;      // Supervised task that child panics are reported as
+    void* owner_arg;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;         // Signalled when a child finishes
+    int in_flight;
+    int max_in_flight;           // 0 = unbounded
+    int failed_count;
+    void* error;                 // First panic value raised by a child
+
+    atomic_bool cancelled;
+    atomic_int refs;             // Creator + live children + child groups
+};
+
+// Future structure
+struct GooFuture {
+    GooFutureFunc func;
+    void* arg;
+    GooTaskGroup* group;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    GooFutureState state;
+    void* result;
+    void* error;
+
+    atomic_bool cancel_requested;
+    atomic_int refs;             // Caller + runner
+};
+
+// Currently running goroutine's group and future
+static __thread GooTaskGroup* current_group = NULL;
+static __thread GooFuture* current_future = NULL;
+
+// Static forward declarations
+static void goo_task_group_runner(void* arg);
+static void goo_task_group_cancel_locked(GooTaskGroup* group);
+
+// ===== Task Groups =====
+
+// Create a task group
+GooTaskGroup* goo_task_group_create(GooTaskGroup* parent, int max_in_flight) {
+    GooTaskGroup* group = (GooTaskGroup*)malloc(sizeof(GooTaskGroup));
+    if (!group) {
+        return NULL;
+    }
+
+    group->parent = parent;
+    group->first_child = NULL;
+    group->next_sibling = NULL;
+    group->supervisor = parent ? parent->supervisor : NULL;
+    group->owner_func = NULL;
+    group->owner_arg = NULL;
+    group->in_flight = 0;
+    group->max_in_flight = max_in_flight > 0 ? max_in_flight : 0;
+    group->failed_count = 0;
+    group->error = NULL;
+    atomic_init(&group->cancelled, false);
+    atomic_init(&group->refs, 1);
+
+    if (pthread_mutex_init(&group->mutex, NULL) != 0) {
+        free(group);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&group->cond, NULL) != 0) {
+        pthread_mutex_destroy(&group->mutex);
+        free(group);
+        return NULL;
+    }
+
+    // Link into the parent so cancellation propagates downwards
+    if (parent) {
+        goo_task_group_retain(parent);
+        pthread_mutex_lock(&parent->mutex);
+        group->next_sibling = parent->first_child;
+        parent->first_child = group;
+        if (atomic_load(&parent->cancelled)) {
+            atomic_store(&group->cancelled, true);
+        }
+        pthread_mutex_unlock(&parent->mutex);
+    }
+
+    return group;
+}
+
+// Take an extra reference to a group
+GooTaskGroup* goo_task_group_retain(GooTaskGroup* group) {
+    if (group) {
+        atomic_fetch_add_explicit(&group->refs, 1, memory_order_relaxed);
+    }
+    return group;
+}
+
+// Drop a reference; the last one frees the group
+void goo_task_group_release(GooTaskGroup* group) {
+    if (!group) return;
+
+    if (atomic_fetch_sub_explicit(&group->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    GooTaskGroup* parent = group->parent;
+    if (parent) {
+        pthread_mutex_lock(&parent->mutex);
+        GooTaskGroup** link = &parent->first_child;
+        while (*link && *link != group) {
+            link = &(*link)->next_sibling;
+        }
+        if (*link) {
+            *link = group->next_sibling;
+        }
+        pthread_mutex_unlock(&parent->mutex);
+    }
+
+    pthread_cond_destroy(&group->cond);
+    pthread_mutex_destroy(&group->mutex);
+    free(group);
+
+    goo_task_group_release(parent);
+}
+
+// Wait for all children, then drop the creator's reference
+void goo_task_group_destroy(GooTaskGroup* group) {
+    if (!group) return;
+
+    goo_task_group_wait(group);
+    goo_task_group_release(group);
+}
+
+// Cancel without waiting and drop the creator's reference
+void goo_task_group_abandon(GooTaskGroup* group) {
+    if (!group) return;
+
+    goo_task_group_cancel(group);
+    goo_task_group_release(group);
+}
+
+// Attach a supervisor to the group
+void goo_task_group_set_supervisor(GooTaskGroup* group, GooSupervisor* supervisor) {
+    if (!group) return;
+
+    pthread_mutex_lock(&group->mutex);
+    group->supervisor = supervisor;
+    pthread_mutex_unlock(&group->mutex);
+}
+
+// Attribute child panics to a supervised task
+void goo_task_group_set_owner(GooTaskGroup* group, GooTaskFunc func, void* arg) {
+    if (!group) return;
+
+    pthread_mutex_lock(&group->mutex);
+    group->owner_func = func;
+    group->owner_arg = arg;
+    pthread_mutex_unlock(&group->mutex);
+}
+
+// Check whether the group or any ancestor is cancelled
+bool goo_task_group_is_cancelled(const GooTaskGroup* group) {
+    // Ancestors stay alive while a descendant holds its reference
+    for (; group; group = group->parent) {
+        if (atomic_load_explicit(&group->cancelled, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cancel a group and its descendants (mutex held)
+static void goo_task_group_cancel_locked(GooTaskGroup* group) {
+    atomic_store_explicit(&group->cancelled, true, memory_order_release);
+
+    // Wake spawners blocked on backpressure
+    pthread_cond_broadcast(&group->cond);
+
+    // Parent-to-child lock order; children unlink under the parent's mutex
+    for (GooTaskGroup* child = group->first_child; child; child = child->next_sibling) {
+        pthread_mutex_lock(&child->mutex);
+        goo_task_group_cancel_locked(child);
+        pthread_mutex_unlock(&child->mutex);
+    }
+}
+
+// Cancel the group and every descendant group
+void goo_task_group_cancel(GooTaskGroup* group) {
+    if (!group) return;
+
+    pthread_mutex_lock(&group->mutex);
+    goo_task_group_cancel_locked(group);
+    pthread_mutex_unlock(&group->mutex);
+}
+
+// Reserve an in-flight slot, optionally blocking for one to free up. A
+// blocking reserve from inside a child takes a slot past the limit instead
+// and sets *run_inline: the child pins a pool worker, and if every worker
+// waited here the children holding the slots could never be scheduled.
+static bool goo_task_group_reserve(GooTaskGroup* group, bool block, bool* run_inline) {
+    *run_inline = false;
+    pthread_mutex_lock(&group->mutex);
+
+    while (group->max_in_flight > 0 && group->in_flight >= group->max_in_flight &&
+           !goo_task_group_is_cancelled(group)) {
+        if (!block) {
+            pthread_mutex_unlock(&group->mutex);
+            return false;
+        }
+        if (current_future) {
+            *run_inline = true;
+            break;
+        }
+        pthread_cond_wait(&group->cond, &group->mutex);
+    }
+
+    if (goo_task_group_is_cancelled(group)) {
+        pthread_mutex_unlock(&group->mutex);
+        return false;
+    }
+
+    group->in_flight++;
+    pthread_mutex_unlock(&group->mutex);
+    return true;
+}
+
+// Return an in-flight slot and wake waiters
+static void goo_task_group_finish_child(GooTaskGroup* group, GooFutureState state, void* error) {
+    pthread_mutex_lock(&group->mutex);
+
+    if (state == GOO_FUTURE_FAILED) {
+        if (group->failed_count++ == 0) {
+            group->error = error;
+        }
+    }
+
+    group->in_flight--;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->mutex);
+}
+
+// Release a future reference
+void goo_future_release(GooFuture* future) {
+    if (!future) return;
+
+    if (atomic_fetch_sub_explicit(&future->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    pthread_cond_destroy(&future->cond);
+    pthread_mutex_destroy(&future->mutex);
+    free(future);
+}
+
+// Shared spawn path
+static GooFuture* goo_task_group_spawn_internal(GooTaskGroup* group, GooFutureFunc func,
+                                               void* arg, bool block) {
+    if (!group) {
+        group = current_group;
+    }
+
+    if (!group || !func) {
+        return NULL;
+    }
+
+    GooFuture* future = (GooFuture*)malloc(sizeof(GooFuture));
+    if (!future) {
+        return NULL;
+    }
+
+    future->func = func;
+    future->arg = arg;
+    future->group = group;
+    future->state = GOO_FUTURE_PENDING;
+    future->result = NULL;
+    future->error = NULL;
+    atomic_init(&future->cancel_requested, false);
+    atomic_init(&future->refs, 2);
+
+    if (pthread_mutex_init(&future->mutex, NULL) != 0) {
+        free(future);
+        return NULL;
+    }
+
+    if (pthread_cond_init(&future->cond, NULL) != 0) {
+        pthread_mutex_destroy(&future->mutex);
+        free(future);
+        return NULL;
+    }
+
+    bool run_inline;
+    if (!goo_task_group_reserve(group, block, &run_inline)) {
+        pthread_cond_destroy(&future->cond);
+        pthread_mutex_destroy(&future->mutex);
+        free(future);
+        return NULL;
+    }
+
+    // The running child keeps its group alive
+    goo_task_group_retain(group);
+
+    // Over the limit inside a child: run the new child on this thread
+    if (run_inline) {
+        goo_task_group_runner(future);
+        return future;
+    }
+
+    if (!goo_goroutine_spawn(goo_task_group_runner, future, group->supervisor)) {
+        fprintf(stderr, "Error: Failed to spawn task group child\n");
+        goo_task_group_finish_child(group, GOO_FUTURE_CANCELLED, NULL);
+        goo_task_group_release(group);
+        pthread_cond_destroy(&future->cond);
+        pthread_mutex_destroy(&future->mutex);
+        free(future);
+        return NULL;
+    }
+
+    return future;
+}
+
+// Spawn a child, blocking while the group is at capacity
+GooFuture* goo_task_group_spawn(GooTaskGroup* group, GooFutureFunc func, void* arg) {
+    return goo_task_group_spawn_internal(group, func, arg, true);
+}
+
+// Spawn a child only if the group has capacity
+GooFuture* goo_task_group_try_spawn(GooTaskGroup* group, GooFutureFunc func, void* arg) {
+    return goo_task_group_spawn_internal(group, func, arg, false);
+}
+
+// Wait for all children to finish
+bool goo_task_group_wait(GooTaskGroup* group) {
+    if (!group) return false;
+
+    pthread_mutex_lock(&group->mutex);
+    while (group->in_flight > 0) {
+        pthread_cond_wait(&group->cond, &group->mutex);
+    }
+    bool ok = group->failed_count == 0;
+    pthread_mutex_unlock(&group->mutex);
+
+    return ok;
+}
+
+// Get the first child panic value
+void* goo_task_group_error(GooTaskGroup* group) {
+    if (!group) return NULL;
+
+    pthread_mutex_lock(&group->mutex);
+    void* error = group->error;
+    pthread_mutex_unlock(&group->mutex);
+
+    return error;
+}
+
+// Number of children queued or running
+int goo_task_group_in_flight(GooTaskGroup* group) {
+    if (!group) return 0;
+
+    pthread_mutex_lock(&group->mutex);
+    int count = group->in_flight;
+    pthread_mutex_unlock(&group->mutex);
+
+    return count;
+}
+
+// Group of the running goroutine
+GooTaskGroup* goo_task_group_current(void) {
+    return current_group;
+}
+
+// Make a group current for this thread
+GooTaskGroup* goo_task_group_set_current(GooTaskGroup* group) {
+    GooTaskGroup* previous = current_group;
+    current_group = group;
+    return previous;
+}
+
+// Cooperative cancellation check
+bool goo_task_cancelled(void) {
+    if (current_future && atomic_load_explicit(&current_future->cancel_requested, memory_order_acquire)) {
+        return true;
+    }
+    return goo_task_group_is_cancelled(current_group);
+}
+
+// Report a child panic to the supervisor, as a failure of the task that owns
+// the nearest group with an owner
+static void goo_task_group_report_failure(GooTaskGroup* group, void* error) {
+    // Ancestors stay alive while the failed child holds its reference
+    for (; group; group = group->parent) {
+        pthread_mutex_lock(&group->mutex);
+        GooTask failed = {
+            .func = group->owner_func,
+            .arg = group->owner_arg,
+            .supervisor = group->supervisor
+        };
+        pthread_mutex_unlock(&group->mutex);
+
+        if (failed.func && failed.supervisor) {
+            goo_supervise_handle_error(failed.supervisor, &failed, error);
+            return;
+        }
+    }
+}
+
+// Child runner: executes the future body inside its group
+static void goo_task_group_runner(void* arg) {
+    GooFuture* future = (GooFuture*)arg;
+    GooTaskGroup* group = future->group;
+
+    GooTaskGroup* previous_group = goo_task_group_set_current(group);
+    GooFuture* previous_future = current_future;
+    current_future = future;
+
+    GooFutureState state;
+    void* result = NULL;
+    void* error = NULL;
+
+    if (atomic_load_explicit(&future->cancel_requested, memory_order_acquire) ||
+        goo_task_group_is_cancelled(group)) {
+        state = GOO_FUTURE_CANCELLED;
+    } else {
+        jmp_buf recover_buf;
+        jmp_buf* old_recover_point = goo_recover_point;
+
+        if (setjmp(recover_buf) == 0) {
+            goo_recover_point = &recover_buf;
+            result = future->func(future->arg);
+            state = GOO_FUTURE_COMPLETED;
+        } else {
+            // A failing child cancels its siblings
+            state = GOO_FUTURE_FAILED;
+            error = goo_panic_value;
+            goo_panic_value = NULL;
+            goo_task_group_cancel(group);
+        }
+
+        goo_recover_point = old_recover_point;
+    }
+
+    current_future = previous_future;
+    goo_task_group_set_current(previous_group);
+
+    pthread_mutex_lock(&future->mutex);
+    future->state = state;
+    future->result = result;
+    future->error = error;
+    pthread_cond_broadcast(&future->cond);
+    pthread_mutex_unlock(&future->mutex);
+
+    goo_task_group_finish_child(group, state, error);
+
+    // The setjmp above kept the panic from goo_run_task, so pass it on here
+    if (state == GOO_FUTURE_FAILED) {
+        goo_task_group_report_failure(group, error);
+    }
+
+    goo_future_release(future);
+    goo_task_group_release(group);
+}
+
+// ===== Futures =====
+
+// Wait for a future
+GooFutureState goo_future_join(GooFuture* future, void** result) {
+    return goo_future_join_timeout(future, -1, result);
+}
+
+// Wait for a future with a timeout
+GooFutureState goo_future_join_timeout(GooFuture* future, int timeout_ms, void** result) {
+    if (!future) return GOO_FUTURE_CANCELLED;
+
+    struct timespec deadline;
+    if (timeout_ms >= 0) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&future->mutex);
+    while (future->state == GOO_FUTURE_PENDING) {
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&future->cond, &future->mutex);
+        } else if (pthread_cond_timedwait(&future->cond, &future->mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    GooFutureState state = future->state;
+    if (state == GOO_FUTURE_COMPLETED && result) {
+        *result = future->result;
+    }
+    pthread_mutex_unlock(&future->mutex);
+
+    return state;
+}
+
+// Request cancellation of a future
+void goo_future_cancel(GooFuture* future) {
+    if (!future) return;
+    atomic_store_explicit(&future->cancel_requested, true, memory_order_release);
+}
+
+// Get the current state of a future
+GooFutureState goo_future_state(GooFuture* future) {
+    if (!future) return GOO_FUTURE_CANCELLED;
+
+    pthread_mutex_lock(&future->mutex);
+    GooFutureState state = future->state;
+    pthread_mutex_unlock(&future->mutex);
+
+    return state;
+}
+
+// Get the panic value of a failed future
+void* goo_future_error(GooFuture* future) {
+    if (!future) return NULL;
+
+    pthread_mutex_lock(&future->mutex);
+    void* error = future->error;
+    pthread_mutex_unlock(&future->mutex);
+
+    return error;
+}
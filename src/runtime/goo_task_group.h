@@ -0,0 +1,109 @@
+#ifndef GOO_TASK_GROUP_H
+#define GOO_TASK_GROUP_H
+
+#include <stdbool.h>
+#include "goo_runtime.h"
+
+// Structured concurrency for goroutines.
+//
+// A task group (nursery) owns the goroutines spawned into it: waiting on
+// or destroying a group joins every child, cancelling a group cancels all
+// of its descendant groups, and a group can bound how many children are
+// in flight so that spawning applies backpressure instead of flooding the
+// thread pool.
+
+typedef struct GooTaskGroup GooTaskGroup;
+typedef struct GooFuture GooFuture;
+
+// Function type for goroutines that produce a result
+typedef void* (*GooFutureFunc)(void*);
+
+// Future states
+typedef enum GooFutureState {
+    GOO_FUTURE_PENDING = 0,    // Queued or running (also returned on join timeout)
+    GOO_FUTURE_COMPLETED,      // Finished and produced a result
+    GOO_FUTURE_FAILED,         // Panicked; the panic value is the error
+    GOO_FUTURE_CANCELLED       // Cancelled before it started
+} GooFutureState;
+
+// ===== Task Groups =====
+
+// Create a task group. Children of a cancelled parent are cancelled too.
+// max_in_flight bounds concurrently running children (0 = unbounded).
+GooTaskGroup* goo_task_group_create(GooTaskGroup* parent, int max_in_flight);
+
+// Wait for all children, then free the group. Outstanding futures stay valid
+// until released.
+void goo_task_group_destroy(GooTaskGroup* group);
+
+// Cancel the group without waiting and drop the creator's reference. The group
+// is freed once its last child exits.
+void goo_task_group_abandon(GooTaskGroup* group);
+
+// Take an extra reference to keep a group alive
+GooTaskGroup* goo_task_group_retain(GooTaskGroup* group);
+
+// Drop a reference taken with goo_task_group_retain
+void goo_task_group_release(GooTaskGroup* group);
+
+// Spawn a child, blocking while the group is at its in-flight limit. A NULL
+// group means the current goroutine's group. Called from inside a child, it
+// runs the new child on the calling thread instead of blocking a worker.
+// Returns NULL if the group is cancelled or the task could not be scheduled.
+GooFuture* goo_task_group_spawn(GooTaskGroup* group, GooFutureFunc func, void* arg);
+
+// Spawn a child only if the group is below its in-flight limit
+GooFuture* goo_task_group_try_spawn(GooTaskGroup* group, GooFutureFunc func, void* arg);
+
+// Wait for all children to finish. Returns false if any child failed.
+bool goo_task_group_wait(GooTaskGroup* group);
+
+// Cancel the group and every descendant group
+void goo_task_group_cancel(GooTaskGroup* group);
+
+// Whether the group or any of its ancestors has been cancelled
+bool goo_task_group_is_cancelled(const GooTaskGroup* group);
+
+// Get the first panic value raised by a child, or NULL
+void* goo_task_group_error(GooTaskGroup* group);
+
+// Number of children currently queued or running
+int goo_task_group_in_flight(GooTaskGroup* group);
+
+// Attach a supervisor; children are scheduled under it
+void goo_task_group_set_supervisor(GooTaskGroup* group, GooSupervisor* supervisor);
+
+// Report child panics (here or in descendant groups without an owner) to the
+// supervisor as failures of the supervised task func(arg)
+void goo_task_group_set_owner(GooTaskGroup* group, GooTaskFunc func, void* arg);
+
+// Group of the running goroutine (NULL outside task groups)
+GooTaskGroup* goo_task_group_current(void);
+
+// Make a group current for this thread; returns the previous one
+GooTaskGroup* goo_task_group_set_current(GooTaskGroup* group);
+
+// Cooperative cancellation check for the running goroutine
+bool goo_task_cancelled(void);
+
+// ===== Futures =====
+
+// Wait for a future; stores the result on completion
+GooFutureState goo_future_join(GooFuture* future, void** result);
+
+// Wait up to timeout_ms (negative = forever); returns GOO_FUTURE_PENDING on timeout
+GooFutureState goo_future_join_timeout(GooFuture* future, int timeout_ms, void** result);
+
+// Request cancellation; tasks that have not started will not run
+void goo_future_cancel(GooFuture* future);
+
+// Get the current state without blocking
+GooFutureState goo_future_state(GooFuture* future);
+
+// Get the panic value of a failed future
+void* goo_future_error(GooFuture* future);
+
+// Release the caller's reference to a future
+void goo_future_release(GooFuture* future);
+
+#endif // GOO_TASK_GROUP_H
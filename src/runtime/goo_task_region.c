@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "goo_task_region.h"
+
+// Region reserve for goroutines started from now on (0: region mode off)
+static _Atomic size_t goo_task_region_reserve = 0;
+
+// Each worker keeps one region and resets it between tasks
+static __thread GooAllocator* worker_region = NULL;
+static __thread size_t worker_region_reserve = 0;
+static __thread bool worker_region_active = false;
+
+void goo_goroutine_set_region_mode(size_t reserve_size) {
+    atomic_store_explicit(&goo_task_region_reserve, reserve_size, memory_order_relaxed);
+}
+
+// Install the worker's region as the thread allocator for one task
+bool goo_task_region_enter(GooAllocator** previous) {
+    size_t reserve = atomic_load_explicit(&goo_task_region_reserve, memory_order_relaxed);
+    if (reserve == 0) {
+        return false;
+    }
+    
+    if (worker_region && worker_region_reserve != reserve) {
+        goo_region_allocator_destroy(worker_region);
+        worker_region = NULL;
+    }
+    if (!worker_region) {
+        worker_region = goo_region_allocator_create_mapped(reserve, GOO_PAGE_NORMAL);
+        if (!worker_region) {
+            fprintf(stderr, "Error: Failed to reserve goroutine region, using default allocator\n");
+            return false;
+        }
+        worker_region_reserve = reserve;
+    }
+    
+    *previous = goo_get_thread_allocator();
+    goo_set_thread_allocator(worker_region);
+    worker_region_active = true;
+    return true;
+}
+
+// Drop everything the task allocated and restore the previous allocator
+void goo_task_region_exit(GooAllocator* previous) {
+    goo_set_thread_allocator(previous);
+    worker_region_active = false;
+    goo_region_allocator_reset(worker_region);
+}
+
+// Unmap the worker's region when the worker exits
+void goo_task_region_destroy(void) {
+    if (worker_region) {
+        goo_region_allocator_destroy(worker_region);
+        worker_region = NULL;
+    }
+}
+
+void* goo_goroutine_promote(const void* ptr, size_t size) {
+    // Outside a region task, or not region memory: nothing to do
+    if (!ptr || !worker_region_active || !goo_region_allocator_contains(worker_region, ptr)) {
+        return (void*)ptr;
+    }
+    
+    GooAllocator* heap = goo_get_default_allocator();
+    void* copy = heap->alloc(heap, size, 16, GOO_ALLOC_DEFAULT);
+    if (!copy) {
+        fprintf(stderr, "Error: Failed to promote %zu bytes out of goroutine region\n", size);
+        return NULL;
+    }
+    memcpy(copy, ptr, size);
+    return copy;
+}
@@ -0,0 +1,33 @@
+#ifndef GOO_TASK_REGION_H
+#define GOO_TASK_REGION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "memory/goo_allocator.h"
+
+// Goroutine-scoped regions.
+//
+// With region mode on, each worker keeps one mapped region allocator and
+// installs it as the thread allocator for every task it runs. When the task
+// returns or panics the region is reset in one shot, so a task costs no
+// mmap and only pages past the first commit granule go back to the OS.
+
+// Run goroutines started from now on in a region of reserve_size bytes
+// (0 turns region mode off)
+void goo_goroutine_set_region_mode(size_t reserve_size);
+
+// Copy a value out of the running goroutine's region so it outlives the task
+void* goo_goroutine_promote(const void* ptr, size_t size);
+
+// Install the worker's region for the task about to run, if region mode is
+// on. Returns false (and installs nothing) otherwise; on success stores the
+// allocator to restore in *previous.
+bool goo_task_region_enter(GooAllocator** previous);
+
+// Drop everything the task allocated and restore the previous allocator
+void goo_task_region_exit(GooAllocator* previous);
+
+// Unmap the worker's region when the worker exits
+void goo_task_region_destroy(void);
+
+#endif // GOO_TASK_REGION_H
@@ -7,10 +7,12 @@
 #include "../include/goo_memory.h"
 #include "../include/goo_capability.h"
 #include "../include/goo_error.h"
+#include "../include/goo_integration.h"
 
 #include "goo_core.h"
 #include "goo_vectorization.h"
 #include "goo_zig_runtime.h"
+#include "memory/goo_typed_pool.h"
 
 // Runtime integration status
 static struct {
@@ -18,12 +20,9 @@ static struct {
     bool subsystems_initialized;
     pthread_mutex_t init_mutex;
     GooArenaAllocator* global_arena;
-    GooPoolAllocator** type_pools;
-    int type_pool_count;
 } runtime_integration = {
     .initialized = false,
-    .subsystems_initialized = false,
-    .type_pool_count = 0
+    .subsystems_initialized = false
 };
 
 // Initialize runtime integration
@@ -53,10 +52,6 @@ bool goo_runtime_integration_init(void) {
         return false;
     }
     
-    // Initialize type pools array
-    runtime_integration.type_pools = NULL;
-    runtime_integration.type_pool_count = 0;
-    
     pthread_mutex_unlock(&runtime_integration.init_mutex);
     return true;
 }
@@ -90,54 +85,6 @@ bool goo_runtime_subsystems_init(void) {
     return true;
 }
 
-// Get or create a type-specific memory pool
-GooPoolAllocator* goo_runtime_get_type_pool(size_t obj_size, const char* type_name) {
-    if (!runtime_integration.initialized) {
-        fprintf(stderr, "Runtime integration not initialized\n");
-        return NULL;
-    }
-    
-    pthread_mutex_lock(&runtime_integration.init_mutex);
-    
-    // Search for existing pool of this size
-    for (int i = 0; i < runtime_integration.type_pool_count; i++) {
-        GooPoolAllocator* pool = runtime_integration.type_pools[i];
-        if (goo_pool_get_obj_size(pool) == obj_size) {
-            pthread_mutex_unlock(&runtime_integration.init_mutex);
-            return pool;
-        }
-    }
-    
-    // Create a new pool for this type
-    size_t initial_capacity = 32;  // Start with 32 objects
-    float growth_factor = 2.0f;   // Double when full
-    
-    GooPoolAllocator* pool = goo_pool_create(obj_size, initial_capacity, growth_factor);
-    if (!pool) {
-        fprintf(stderr, "Failed to create pool for type %s\n", type_name ? type_name : "unknown");
-        pthread_mutex_unlock(&runtime_integration.init_mutex);
-        return NULL;
-    }
-    
-    // Add the pool to our list
-    int new_count = runtime_integration.type_pool_count + 1;
-    GooPoolAllocator** new_pools = realloc(runtime_integration.type_pools, 
-                                         new_count * sizeof(GooPoolAllocator*));
-    if (!new_pools) {
-        fprintf(stderr, "Failed to expand type pools array\n");
-        goo_pool_destroy(pool);
-        pthread_mutex_unlock(&runtime_integration.init_mutex);
-        return NULL;
-    }
-    
-    runtime_integration.type_pools = new_pools;
-    runtime_integration.type_pools[runtime_integration.type_pool_count] = pool;
-    runtime_integration.type_pool_count = new_count;
-    
-    pthread_mutex_unlock(&runtime_integration.init_mutex);
-    return pool;
-}
-
 // Allocate memory with type information
 void* goo_runtime_typed_alloc(size_t size, const char* type_name) {
     if (!runtime_integration.initialized) {
@@ -146,14 +93,11 @@ void* goo_runtime_typed_alloc(size_t size, const char* type_name) {
     }
     
     // For small objects of known type, use a type-specific pool
-    if (size <= 1024 && type_name != NULL) {
-        GooPoolAllocator* pool = goo_runtime_get_type_pool(size, type_name);
-        if (pool) {
-            return goo_pool_alloc(pool);
-        }
+    if (goo_typed_pool_serves(size, type_name)) {
+        return goo_typed_pool_alloc(size, type_name);
     }
     
-    // For larger objects or when pool allocation fails, use the thread-local allocator
+    // For larger or untyped objects, use the thread-local allocator
     GooCustomAllocator* current = goo_get_current_allocator();
     if (current) {
         return goo_custom_alloc(current, size, 8);  // Default 8-byte alignment
@@ -169,18 +113,11 @@ void goo_runtime_typed_free(void* ptr, const char* type_name, size_t size) {
         return;
     }
     
-    // For small objects of known type, try to return to type-specific pool
-    // Note: In a full implementation, we'd store allocator information with the object
-    if (size <= 1024 && type_name != NULL) {
-        for (int i = 0; i < runtime_integration.type_pool_count; i++) {
-            GooPoolAllocator* pool = runtime_integration.type_pools[i];
-            if (goo_pool_get_obj_size(pool) == size) {
-                // This assumes ptr came from this pool - in real implementation,
-                // we'd need to track which pool each object came from
-                goo_pool_free(pool, ptr);
-                return;
-            }
-        }
+    // Pool-class objects go back to the pools; the caller passes the same
+    // size and type it allocated with
+    if (goo_typed_pool_serves(size, type_name)) {
+        goo_typed_pool_free(ptr);
+        return;
     }
     
     // If we can't return to a pool, try the current thread allocator
@@ -250,12 +187,7 @@ void goo_runtime_integration_shutdown(void) {
     }
     
     // Free type pools
-    for (int i = 0; i < runtime_integration.type_pool_count; i++) {
-        goo_pool_destroy(runtime_integration.type_pools[i]);
-    }
-    free(runtime_integration.type_pools);
-    runtime_integration.type_pools = NULL;
-    runtime_integration.type_pool_count = 0;
+    goo_typed_pool_shutdown();
     
     // Destroy global arena
     if (runtime_integration.global_arena) {
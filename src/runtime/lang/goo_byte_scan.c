@@ -0,0 +1,234 @@
+/**
+ * goo_byte_scan.c
+ *
+ * Byte-class scanning shared by the Zig lexer and GooString.
+ * Each block of 16 bytes is reduced to a bit mask of matching bytes (one bit
+ * per byte with SSE2, four with NEON), so the first match is a count of
+ * trailing zeros and a match count is a popcount. Tails shorter than a block
+ * run byte by byte, so no byte past the end is ever loaded.
+ */
+
+#include <stdint.h>
+#include "lang/goo_byte_scan.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define GOO_SCAN_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define GOO_SCAN_NEON
+#endif
+
+#define SCAN_BLOCK 16
+
+#if defined(GOO_SCAN_SSE2)
+typedef __m128i ScanVec;
+#define SCAN_BITS_PER_BYTE 1
+#define SCAN_ALL_BITS 0xFFFFull
+
+static inline ScanVec scan_load(const unsigned char* p) {
+    return _mm_loadu_si128((const __m128i*)p);
+}
+
+static inline ScanVec scan_eq(ScanVec v, unsigned char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8((char)c));
+}
+
+static inline ScanVec scan_or(ScanVec a, ScanVec b) {
+    return _mm_or_si128(a, b);
+}
+
+// Bytes in [lo, lo + count); shifting lo to -128 makes a signed compare work
+static inline ScanVec scan_range(ScanVec v, unsigned char lo, unsigned char count) {
+    ScanVec shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + count)));
+}
+
+static inline ScanVec scan_lower(ScanVec v) {
+    return _mm_or_si128(v, _mm_set1_epi8(0x20));
+}
+
+static inline uint64_t scan_bits(ScanVec match) {
+    return (uint64_t)(unsigned)_mm_movemask_epi8(match);
+}
+
+// Bytes with the high bit set
+static inline uint64_t scan_high_bits(ScanVec v) {
+    return (uint64_t)(unsigned)_mm_movemask_epi8(v);
+}
+#elif defined(GOO_SCAN_NEON)
+typedef uint8x16_t ScanVec;
+#define SCAN_BITS_PER_BYTE 4
+#define SCAN_ALL_BITS 0xFFFFFFFFFFFFFFFFull
+
+static inline ScanVec scan_load(const unsigned char* p) {
+    return vld1q_u8(p);
+}
+
+static inline ScanVec scan_eq(ScanVec v, unsigned char c) {
+    return vceqq_u8(v, vdupq_n_u8(c));
+}
+
+static inline ScanVec scan_or(ScanVec a, ScanVec b) {
+    return vorrq_u8(a, b);
+}
+
+static inline ScanVec scan_range(ScanVec v, unsigned char lo, unsigned char count) {
+    return vcltq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(count));
+}
+
+static inline ScanVec scan_lower(ScanVec v) {
+    return vorrq_u8(v, vdupq_n_u8(0x20));
+}
+
+// Narrowing shift keeps four bits per byte lane
+static inline uint64_t scan_bits(ScanVec match) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(match), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static inline uint64_t scan_high_bits(ScanVec v) {
+    return scan_bits(vcltq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(0)));
+}
+#endif
+
+static inline bool is_space_byte(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+           c == 0x0B || c == 0x0C || c == 0x85 || c == 0xA0;
+}
+
+static inline bool is_ident_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+static inline bool in_class(unsigned char c, GooByteClass byte_class) {
+    return byte_class == GOO_BYTE_CLASS_IDENT ? is_ident_byte(c) : is_space_byte(c);
+}
+
+#if defined(GOO_SCAN_SSE2) || defined(GOO_SCAN_NEON)
+static inline size_t scan_first(uint64_t bits) {
+    return (size_t)__builtin_ctzll(bits) / SCAN_BITS_PER_BYTE;
+}
+
+static inline ScanVec scan_space(ScanVec v) {
+    ScanVec m = scan_or(scan_eq(v, ' '), scan_range(v, '\t', 5));  // \t \n \v \f \r
+    return scan_or(m, scan_or(scan_eq(v, 0x85), scan_eq(v, 0xA0)));
+}
+
+static inline ScanVec scan_ident(ScanVec v) {
+    ScanVec m = scan_or(scan_range(scan_lower(v), 'a', 26), scan_range(v, '0', 10));
+    return scan_or(m, scan_eq(v, '_'));
+}
+#endif
+
+size_t goo_byte_scan_skip(const char* bytes, size_t length, GooByteClass byte_class) {
+    const unsigned char* s = (const unsigned char*)bytes;
+    size_t i = 0;
+
+#if defined(GOO_SCAN_SSE2) || defined(GOO_SCAN_NEON)
+    // Most identifiers and indents are short; check the first byte directly
+    if (length > 0 && !in_class(s[0], byte_class)) return 0;
+
+    for (; i + SCAN_BLOCK <= length; i += SCAN_BLOCK) {
+        ScanVec v = scan_load(s + i);
+        ScanVec m = byte_class == GOO_BYTE_CLASS_IDENT ? scan_ident(v) : scan_space(v);
+        uint64_t outside = ~scan_bits(m) & SCAN_ALL_BITS;
+        if (outside) return i + scan_first(outside);
+    }
+#endif
+
+    while (i < length && in_class(s[i], byte_class)) i++;
+    return i;
+}
+
+size_t goo_byte_scan_find_quote(const char* bytes, size_t length, char quote) {
+    const unsigned char* s = (const unsigned char*)bytes;
+    size_t i = 0;
+
+#if defined(GOO_SCAN_SSE2) || defined(GOO_SCAN_NEON)
+    for (; i + SCAN_BLOCK <= length; i += SCAN_BLOCK) {
+        ScanVec v = scan_load(s + i);
+        uint64_t bits = scan_bits(scan_or(scan_eq(v, (unsigned char)quote), scan_eq(v, '\\')));
+        if (bits) return i + scan_first(bits);
+    }
+#endif
+
+    while (i < length && s[i] != (unsigned char)quote && s[i] != '\\') i++;
+    return i;
+}
+
+size_t goo_byte_scan_count_newlines(const char* bytes, size_t length) {
+    const unsigned char* s = (const unsigned char*)bytes;
+    size_t i = 0;
+    size_t count = 0;
+
+#if defined(GOO_SCAN_SSE2) || defined(GOO_SCAN_NEON)
+    for (; i + SCAN_BLOCK <= length; i += SCAN_BLOCK) {
+        uint64_t bits = scan_bits(scan_eq(scan_load(s + i), '\n'));
+        count += (size_t)__builtin_popcountll(bits) / SCAN_BITS_PER_BYTE;
+    }
+#endif
+
+    for (; i < length; i++) {
+        count += s[i] == '\n';
+    }
+    return count;
+}
+
+// Length of the well-formed sequence starting at a non-ASCII lead byte,
+// or 0 (Unicode Table 3-7)
+static size_t utf8_sequence(const unsigned char* s, size_t remaining) {
+    unsigned char lead = s[0];
+    unsigned char lo = 0x80, hi = 0xBF;
+    size_t n;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        n = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        n = 3;
+        if (lead == 0xE0) lo = 0xA0;        // Overlong
+        if (lead == 0xED) hi = 0x9F;        // Surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        n = 4;
+        if (lead == 0xF0) lo = 0x90;        // Overlong
+        if (lead == 0xF4) hi = 0x8F;        // Above U+10FFFF
+    } else {
+        return 0;
+    }
+
+    if (remaining < n || s[1] < lo || s[1] > hi) return 0;
+    for (size_t k = 2; k < n; k++) {
+        if ((s[k] & 0xC0) != 0x80) return 0;
+    }
+    return n;
+}
+
+bool goo_byte_scan_validate_utf8(const char* bytes, size_t length) {
+    const unsigned char* s = (const unsigned char*)bytes;
+    size_t i = 0;
+
+    while (i < length) {
+#if defined(GOO_SCAN_SSE2) || defined(GOO_SCAN_NEON)
+        // Skip ASCII a block at a time, up to the next non-ASCII byte
+        if (i + SCAN_BLOCK <= length) {
+            uint64_t high = scan_high_bits(scan_load(s + i));
+            if (!high) {
+                i += SCAN_BLOCK;
+                continue;
+            }
+            i += scan_first(high);
+        }
+#endif
+
+        if (s[i] < 0x80) {
+            i++;
+            continue;
+        }
+
+        size_t n = utf8_sequence(s + i, length - i);
+        if (n == 0) return false;
+        i += n;
+    }
+    return true;
+}
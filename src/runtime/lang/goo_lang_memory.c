@@ -8,10 +8,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
-#include "memory/memory.h"
+#include <stdint.h>
+#include <stdatomic.h>
+#include "memory.h"
 #include "scope/scope.h"
 #include "runtime.h"
 #include "lang/goo_lang_memory.h"
+#include "lang/goo_byte_scan.h"
 
 /**
  * Allocate memory for a Goo string.
@@ -46,6 +49,40 @@ void goo_string_free(char* str, size_t length) {
     goo_free(str, length + 1);
 }
 
+// Buckets in the intern table; chains only ever grow, so readers need no lock
+#define STRING_INTERN_BUCKETS 65536
+
+_Static_assert(sizeof(GooString) == 24, "GooString must stay three words");
+
+// Interned string; the entry and its bytes are never freed
+typedef struct GooInternEntry {
+    struct GooInternEntry* next;
+    uint64_t hash;
+    GooString str;
+} GooInternEntry;
+
+static _Atomic(GooInternEntry**) intern_buckets = NULL;
+
+/**
+ * Fill in a string header, inline if the bytes fit.
+ */
+static bool string_init(GooString* str, const char* bytes, size_t length) {
+    if (length <= GOO_STRING_INLINE_CAPACITY) {
+        memcpy(str->small.data, bytes, length);
+        memset(str->small.data + length, 0, sizeof(str->small.data) - length);
+        str->small.flags = (unsigned char)length;
+        return true;
+    }
+
+    str->heap.data = goo_string_alloc(length);
+    if (!str->heap.data) return false;
+
+    memcpy(str->heap.data, bytes, length);
+    str->heap.length = length;
+    str->heap.flags = GOO_STRING_FLAG_HEAP;
+    return true;
+}
+
 /**
  * Create a new Goo string from a C string.
  * 
@@ -55,7 +92,18 @@ void goo_string_free(char* str, size_t length) {
 GooString* goo_string_create(const char* cstr) {
     if (!cstr) return NULL;
     
-    size_t length = strlen(cstr);
+    return goo_string_create_n(cstr, strlen(cstr));
+}
+
+/**
+ * Create a new Goo string from bytes that need not be null-terminated.
+ * 
+ * @param bytes The bytes to copy
+ * @param length The number of bytes
+ * @return A new Goo string
+ */
+GooString* goo_string_create_n(const char* bytes, size_t length) {
+    if (!bytes && length > 0) return NULL;
     
     // Allocate the string structure
     GooString* str = (GooString*)goo_alloc(sizeof(GooString));
@@ -64,17 +112,12 @@ GooString* goo_string_create(const char* cstr) {
         return NULL;
     }
     
-    // Allocate the string data
-    str->data = goo_string_alloc(length);
-    if (!str->data) {
+    // Short strings need no second allocation
+    if (!string_init(str, bytes, length)) {
         goo_free(str, sizeof(GooString));
         return NULL;
     }
     
-    // Copy the string data
-    memcpy(str->data, cstr, length);
-    str->length = length;
-    
     return str;
 }
 
@@ -84,17 +127,149 @@ GooString* goo_string_create(const char* cstr) {
  * @param str The string to destroy
  */
 void goo_string_destroy(GooString* str) {
-    if (!str) return;
+    if (!str || goo_string_is_interned(str)) return;
     
     // Free the string data
-    if (str->data) {
-        goo_string_free(str->data, str->length);
+    if (str->heap.flags & GOO_STRING_FLAG_HEAP) {
+        goo_string_free(str->heap.data, str->heap.length);
     }
     
     // Free the string structure
     goo_free(str, sizeof(GooString));
 }
 
+/**
+ * Compare two Goo strings for equality.
+ */
+bool goo_string_equals(const GooString* a, const GooString* b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+
+    // Distinct interned strings always differ
+    if (goo_string_is_interned(a) && goo_string_is_interned(b)) return false;
+
+    size_t length = goo_string_length(a);
+    return length == goo_string_length(b) &&
+           memcmp(goo_string_data(a), goo_string_data(b), length) == 0;
+}
+
+/**
+ * Check that a Goo string holds well-formed UTF-8.
+ */
+bool goo_string_is_valid_utf8(const GooString* str) {
+    if (!str) return false;
+
+    return goo_byte_scan_validate_utf8(goo_string_data(str), goo_string_length(str));
+}
+
+/**
+ * Count the newline bytes in a Goo string.
+ */
+size_t goo_string_count_newlines(const GooString* str) {
+    if (!str) return 0;
+
+    return goo_byte_scan_count_newlines(goo_string_data(str), goo_string_length(str));
+}
+
+static uint64_t string_hash(const char* bytes, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static GooInternEntry** intern_table(void) {
+    GooInternEntry** buckets = atomic_load_explicit(&intern_buckets, memory_order_acquire);
+    if (buckets) return buckets;
+
+    GooInternEntry** fresh = calloc(STRING_INTERN_BUCKETS, sizeof(GooInternEntry*));
+    if (!fresh) return NULL;
+
+    if (!atomic_compare_exchange_strong_explicit(&intern_buckets, &buckets, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        free(fresh);
+        return buckets;
+    }
+    return fresh;
+}
+
+// Search a chain from entry up to (not including) stop
+static GooInternEntry* intern_find(GooInternEntry* entry, GooInternEntry* stop, uint64_t hash,
+                                   const char* bytes, size_t length) {
+    for (; entry != stop; entry = entry->next) {
+        if (entry->hash == hash && goo_string_length(&entry->str) == length &&
+            memcmp(goo_string_data(&entry->str), bytes, length) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Get the canonical interned string for a C string.
+ */
+GooString* goo_string_intern(const char* cstr) {
+    if (!cstr) return NULL;
+
+    return goo_string_intern_n(cstr, strlen(cstr));
+}
+
+/**
+ * Get the canonical interned string for a byte range.
+ */
+GooString* goo_string_intern_n(const char* bytes, size_t length) {
+    if (!bytes && length > 0) return NULL;
+
+    GooInternEntry** buckets = intern_table();
+    if (!buckets) return NULL;
+
+    uint64_t hash = string_hash(bytes, length);
+    _Atomic(GooInternEntry*)* bucket = (_Atomic(GooInternEntry*)*)&buckets[hash & (STRING_INTERN_BUCKETS - 1)];
+
+    GooInternEntry* head = atomic_load_explicit(bucket, memory_order_acquire);
+    GooInternEntry* found = intern_find(head, NULL, hash, bytes, length);
+    if (found) return &found->str;
+
+    // Interned strings outlive any region or arena, so they use the system heap
+    size_t extra = length > GOO_STRING_INLINE_CAPACITY ? length + 1 : 0;
+    GooInternEntry* entry = malloc(sizeof(GooInternEntry) + extra);
+    if (!entry) {
+        goo_runtime_out_of_memory(sizeof(GooInternEntry) + extra);
+        return NULL;
+    }
+
+    entry->hash = hash;
+    if (extra) {
+        char* data = (char*)(entry + 1);
+        memcpy(data, bytes, length);
+        data[length] = '\0';
+        entry->str.heap.data = data;
+        entry->str.heap.length = length;
+        entry->str.heap.flags = GOO_STRING_FLAG_HEAP | GOO_STRING_FLAG_INTERNED;
+    } else {
+        string_init(&entry->str, bytes, length);
+        entry->str.small.flags |= GOO_STRING_FLAG_INTERNED;
+    }
+
+    // Publish; on a lost race, check only the entries added since the last look
+    for (;;) {
+        entry->next = head;
+        GooInternEntry* seen = head;
+        if (atomic_compare_exchange_weak_explicit(bucket, &head, entry,
+                                                  memory_order_release, memory_order_acquire)) {
+            return &entry->str;
+        }
+
+        found = intern_find(head, seen, hash, bytes, length);
+        if (found) {
+            free(entry);
+            return &found->str;
+        }
+    }
+}
+
 /**
  * Allocate memory for a Goo array.
  * 
@@ -26,6 +26,13 @@ typedef enum {
     GOO_ALLOC_NO_FAIL     = 1 << 5,  // Abort on allocation failure
 } GooAllocOptions;
 
+// Page backing for mapped arenas and regions
+typedef enum {
+    GOO_PAGE_NORMAL           = 0,  // 4 KB pages
+    GOO_PAGE_TRANSPARENT_HUGE = 1,  // Transparent 2 MB pages (MADV_HUGEPAGE)
+    GOO_PAGE_EXPLICIT_HUGE    = 2,  // hugetlb 2 MB pages, transparent if none are configured
+} GooPageMode;
+
 // Error handling strategy
 typedef enum {
     GOO_ALLOC_STRATEGY_PANIC,   // Abort process on failure
@@ -124,21 +131,66 @@ void goo_set_thread_allocator(GooAllocator* allocator);
 // Create a system allocator (malloc/free based)
 GooAllocator* goo_system_allocator_create(void);
 
+// Slab allocator statistics
+typedef struct GooSlabStats {
+    size_t bytes_mapped;        // Address space obtained with mmap
+    size_t bytes_released;      // Bytes returned to the OS with madvise
+    size_t slabs;               // Slabs created
+    size_t released_slabs;      // Slabs currently released
+    size_t large_allocations;   // Live allocations above 32 KB
+    size_t cached_spans;        // Spans parked in the span cache
+} GooSlabStats;
+
+// Get the size-class slab allocator (opt-in; see goo_set_default_allocator)
+GooAllocator* goo_slab_allocator_get(void);
+
+// Get slab allocator statistics
+GooSlabStats goo_slab_allocator_get_stats(void);
+
+// Return the calling thread's cached objects to the shared slabs
+void goo_slab_allocator_thread_flush(void);
+
+// Usable size of a slab allocation (0 if not from the slab allocator)
+size_t goo_slab_usable_size(void* ptr);
+
 // Create a memory arena allocator
 GooMemoryArena* goo_arena_allocator_create(GooAllocator* parent, size_t block_size);
 
 // Reset a memory arena (free all memory except persistent allocations)
 void goo_arena_reset(GooMemoryArena* arena);
 
+// Create an arena over one reserved address range, committed on demand;
+// resets return pages past the first commit granule to the OS
+GooAllocator* goo_arena_allocator_create_mapped(size_t reserve_size, GooPageMode mode);
+
 // Create a region allocator
 GooRegionAllocator* goo_region_allocator_create(GooAllocator* parent);
 
+// Create a region allocator over one reserved address range
+GooAllocator* goo_region_allocator_create_mapped(size_t reserve_size, GooPageMode mode);
+
+// Release everything allocated from a region allocator at once
+void goo_region_allocator_reset(GooAllocator* allocator);
+
+// Destroy a region allocator and unmap its memory
+void goo_region_allocator_destroy(GooAllocator* allocator);
+
+// Whether ptr lies in memory owned by a region allocator (for mapped regions,
+// anywhere in the reserved range)
+bool goo_region_allocator_contains(GooAllocator* allocator, const void* ptr);
+
 // Begin a new memory region
 void goo_region_begin(GooRegionAllocator* region);
 
 // End the current memory region (free all memory allocated in this region)
 void goo_region_end(GooRegionAllocator* region);
 
+// Per-thread call arena: compiled code marks it on entry, allocates frame-bounded
+// values from it, and releases to the mark on return
+size_t goo_call_arena_mark(void);
+void* goo_call_arena_alloc(size_t size);
+void goo_call_arena_release(size_t mark);
+
 // Utility functions for common allocations (using default allocator)
 void* goo_alloc(size_t size);
 void* goo_alloc_zero(size_t size);
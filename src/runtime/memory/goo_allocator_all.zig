@@ -6,6 +6,7 @@ const core = @import("goo_allocator_core.zig");
 const arena = @import("goo_arena_allocator.zig");
 const pool = @import("goo_pool_allocator.zig");
 const region = @import("goo_region_allocator.zig");
+const slab = @import("goo_slab_allocator.zig");
 
 // Re-export core functionality
 pub const Allocator = core.Allocator;
@@ -32,4 +33,5 @@ comptime {
     _ = arena;
     _ = pool;
     _ = region;
+    _ = slab;
 }
@@ -4,6 +4,7 @@ const c = @cImport({
     @cInclude("stdio.h");
     @cInclude("string.h");
 });
+const slab = @import("goo_slab_allocator.zig");
 
 // Constants
 pub const DEFAULT_ALIGNMENT = 8;
@@ -138,16 +139,27 @@ pub const Allocator = extern struct {
     track_stats: bool,
     stats: AllocStats,
 
-    // Method wrappers
+    // Method wrappers (these feed the sampling heap profiler)
     pub fn alloc(self: *Allocator, size: usize, alignment: usize, options: AllocOptions) ?*anyopaque {
-        return self.vtable.allocFn(self, size, alignment, options.toC());
+        const ptr = self.vtable.allocFn(self, size, alignment, options.toC());
+        profileAlloc(ptr, size);
+        return ptr;
     }
 
     pub fn realloc(self: *Allocator, ptr: ?*anyopaque, old_size: usize, new_size: usize, alignment: usize, options: AllocOptions) ?*anyopaque {
-        return self.vtable.reallocFn(self, ptr, old_size, new_size, alignment, options.toC());
+        const result = self.vtable.reallocFn(self, ptr, old_size, new_size, alignment, options.toC());
+
+        // A failed realloc leaves the old block (and its sample) in place
+        if (result != ptr and (result != null or new_size == 0)) {
+            profileFree(ptr);
+            profileAlloc(result, new_size);
+        }
+        return result;
     }
 
     pub fn free(self: *Allocator, ptr: ?*anyopaque, size: usize, alignment: usize) void {
+        // Before the free, so a racing reuse of ptr is never mistaken for the sample
+        profileFree(ptr);
         return self.vtable.freeFn(self, ptr, size, alignment);
     }
 
@@ -158,9 +170,38 @@ pub const Allocator = extern struct {
 
 // Global instances
 pub var g_system_allocator: SystemAllocator = undefined;
+pub var g_slab_allocator: slab.SlabAllocator = slab.SlabAllocator.init();
 pub var goo_default_allocator: ?*Allocator = null;
 pub threadlocal var goo_thread_allocator: ?*Allocator = null;
 
+// Sampling heap profiler (goo_heap_profile.c)
+extern var goo_heap_profile_rate: usize;
+extern var goo_heap_profile_live_count: usize;
+extern fn goo_heap_profile_sample(ptr: ?*anyopaque, size: usize) i64;
+extern fn goo_heap_profile_free(ptr: ?*anyopaque) void;
+extern fn goo_heap_profile_init_from_env() bool;
+
+// Bytes this thread may still allocate before the next sample
+threadlocal var profile_countdown: i64 = 0;
+
+// Count an allocation against the sampling countdown; unsampled allocations
+// cost a load and a subtraction
+inline fn profileAlloc(ptr: ?*anyopaque, size: usize) void {
+    if (@atomicLoad(usize, &goo_heap_profile_rate, .monotonic) == 0) return;
+    if (ptr == null) return;
+
+    profile_countdown -= std.math.cast(i64, size) orelse std.math.maxInt(i64);
+    if (profile_countdown < 0) {
+        profile_countdown = goo_heap_profile_sample(ptr, size);
+    }
+}
+
+// Retire ptr's sample, if it has one; free while nothing is sampled
+inline fn profileFree(ptr: ?*anyopaque) void {
+    if (@atomicLoad(usize, &goo_heap_profile_live_count, .monotonic) == 0) return;
+    goo_heap_profile_free(ptr);
+}
+
 // Default out-of-memory handler
 fn defaultOutOfMemoryHandler() callconv(.C) void {
     const stderr = std.io.getStdErr().writer();
@@ -178,9 +219,12 @@ pub fn memoryInit() bool {
 
     g_system_allocator.initialized = true;
 
-    // Set as default allocator
+    // Set as default allocator; the slab allocator is opt-in
     goo_default_allocator = &g_system_allocator.allocator;
 
+    // Production binaries opt into heap profiling through the environment
+    _ = goo_heap_profile_init_from_env();
+
     return true;
 }
 
@@ -228,7 +272,7 @@ fn alignSize(size: usize, alignment: usize) usize {
 }
 
 // Handle allocation failure based on strategy
-fn handleAllocationFailure(allocator: *Allocator, size: usize) ?*anyopaque {
+pub fn handleAllocationFailure(allocator: *Allocator, size: usize) ?*anyopaque {
     if (allocator.track_stats) {
         allocator.stats.failed_allocations += 1;
     }
@@ -455,34 +499,61 @@ export fn goo_set_out_of_mem_handler(handler: OutOfMemFn) void {
     default_allocator.out_of_mem_fn = handler;
 }
 
-// Helper utility functions (using default allocator)
+// Helper utility functions (using the thread allocator, else the default)
 export fn goo_alloc(size: usize) ?*anyopaque {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
+
+    // Skip the vtable when the slab allocator is installed
+    if (allocator == &g_slab_allocator.allocator and !allocator.track_stats and size != 0) {
+        if (slab.allocBytes(size, DEFAULT_ALIGNMENT)) |ptr| {
+            profileAlloc(ptr, size);
+            return ptr;
+        }
+    }
     return allocator.alloc(size, DEFAULT_ALIGNMENT, .{});
 }
 
 export fn goo_alloc_zero(size: usize) ?*anyopaque {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
     return allocator.alloc(size, DEFAULT_ALIGNMENT, .{ .zero = true });
 }
 
 export fn goo_realloc(ptr: ?*anyopaque, old_size: usize, new_size: usize) ?*anyopaque {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
     return allocator.realloc(ptr, old_size, new_size, DEFAULT_ALIGNMENT, .{});
 }
 
 export fn goo_free(ptr: ?*anyopaque, size: usize) void {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
+
+    // Skip the vtable when the slab allocator is installed
+    if (allocator == &g_slab_allocator.allocator and !allocator.track_stats) {
+        if (ptr) |p| {
+            profileFree(p);
+            slab.freeBytes(p);
+        }
+        return;
+    }
+
+    // Slab memory freed under a region thread allocator (allocated before the
+    // region was installed, or promoted out of it) still goes back to the slab
+    if (ptr) |p| {
+        if (allocator != getDefaultAllocator() and slab.usableSize(p) != null) {
+            profileFree(p);
+            slab.freeBytes(p);
+            return;
+        }
+    }
     return allocator.free(ptr, size, DEFAULT_ALIGNMENT);
 }
 
 export fn goo_alloc_aligned(size: usize, alignment: usize) ?*anyopaque {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
     return allocator.alloc(size, alignment, .{});
 }
 
 export fn goo_free_aligned(ptr: ?*anyopaque, size: usize, alignment: usize) void {
-    const allocator = getDefaultAllocator();
+    const allocator = getThreadAllocator();
     return allocator.free(ptr, size, alignment);
 }
 
@@ -543,7 +614,12 @@ export fn goo_system_allocator_create() ?*Allocator {
     if (goo_default_allocator == null) {
         _ = goo_memory_init();
     }
-    return goo_default_allocator;
+    return &g_system_allocator.allocator;
+}
+
+// Get the size-class slab allocator
+export fn goo_slab_allocator_get() ?*Allocator {
+    return &g_slab_allocator.allocator;
 }
 
 // GooAllocator is a wrapper around Zig's standard allocator
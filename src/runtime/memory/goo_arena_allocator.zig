@@ -8,6 +8,9 @@ const allocator_core = @import("goo_allocator_core.zig");
 const Allocator = allocator_core.Allocator;
 const AllocOptions = allocator_core.AllocOptions;
 const DEFAULT_ALIGNMENT = allocator_core.DEFAULT_ALIGNMENT;
+const virtual_memory = @import("goo_virtual_memory.zig");
+const VirtualRange = virtual_memory.VirtualRange;
+const PageMode = virtual_memory.PageMode;
 
 // Constants
 const DEFAULT_ARENA_SIZE = 64 * 1024; // 64 KB
@@ -74,6 +77,11 @@ pub const ArenaAllocator = struct {
     total_capacity: usize,
     min_block_size: usize,
 
+    // Mapped mode: one reserved range instead of malloc'd blocks
+    vm: ?VirtualRange,
+    vm_used: usize, // Bytes bumped from the start of the range
+    vm_retained: usize, // Bytes kept resident across resets
+
     // Initialize an arena allocator
     pub fn init(initial_size: usize) ?*ArenaAllocator {
         // Allocate the arena object
@@ -93,6 +101,9 @@ pub const ArenaAllocator = struct {
             .current = null,
             .total_capacity = 0,
             .min_block_size = if (initial_size > MIN_BLOCK_SIZE) initial_size else DEFAULT_BLOCK_SIZE,
+            .vm = null,
+            .vm_used = 0,
+            .vm_retained = 0,
         };
 
         // Allocate initial block
@@ -104,6 +115,37 @@ pub const ArenaAllocator = struct {
         return self;
     }
 
+    // Initialize an arena backed by a reserved virtual range of reserve_size bytes
+    pub fn initMapped(reserve_size: usize, mode: PageMode) ?*ArenaAllocator {
+        const self = @as(*ArenaAllocator, @ptrCast(@alignCast(c.malloc(@sizeOf(ArenaAllocator)) orelse return null)));
+
+        const range = VirtualRange.reserve(reserve_size, mode) orelse {
+            c.free(self);
+            return null;
+        };
+
+        self.* = .{
+            .allocator = .{
+                .vtable = &arenaVTable,
+                .strategy = .null,
+                .out_of_mem_fn = null,
+                .context = self,
+                .track_stats = true,
+                .stats = .{},
+            },
+            .head = null,
+            .current = null,
+            .total_capacity = range.reserved,
+            .min_block_size = DEFAULT_BLOCK_SIZE,
+            .vm = range,
+            .vm_used = 0,
+            .vm_retained = range.granule,
+        };
+
+        self.allocator.stats.bytes_reserved = range.reserved;
+        return self;
+    }
+
     // Add a new block to the arena
     fn addBlock(self: *ArenaAllocator, size: usize) bool {
         // Use at least min_block_size
@@ -137,6 +179,17 @@ pub const ArenaAllocator = struct {
         const self = @as(*ArenaAllocator, @ptrCast(@alignCast(allocator.context.?)));
         const actual_alignment = if (alignment == 0) DEFAULT_ALIGNMENT else alignment;
 
+        // Mapped arenas bump through their range and never add blocks
+        if (self.vm) |*vm| {
+            const ptr = vm.bump(&self.vm_used, size, actual_alignment) orelse {
+                if (allocator.track_stats) {
+                    allocator.stats.failed_allocations += 1;
+                }
+                return null;
+            };
+            return finishAlloc(allocator, ptr, size, ret_addr);
+        }
+
         // Try to allocate from current block
         if (self.current) |current| {
             if (current.alloc(size, actual_alignment)) |ptr| {
@@ -226,13 +279,41 @@ pub const ArenaAllocator = struct {
         }
     }
 
+    // Record a successful allocation (mapped path)
+    fn finishAlloc(allocator: *Allocator, ptr: *anyopaque, size: usize, options: c_int) *anyopaque {
+        if (allocator.track_stats) {
+            allocator.stats.bytes_allocated += size;
+            allocator.stats.allocation_count += 1;
+            allocator.stats.total_allocations += 1;
+
+            if (allocator.stats.bytes_allocated > allocator.stats.max_bytes_allocated) {
+                allocator.stats.max_bytes_allocated = allocator.stats.bytes_allocated;
+            }
+        }
+
+        // Pages fresh from the range are already zero, reused ones are not
+        const alloc_options = AllocOptions.fromC(options);
+        if (alloc_options.zero) {
+            @memset(@as([*]u8, @ptrCast(ptr))[0..size], 0);
+        }
+
+        return ptr;
+    }
+
     // Reset the arena, keeping blocks for reuse
     pub fn reset(self: *ArenaAllocator) void {
+        // Mapped arenas hand their pages back to the OS past the retained prefix
+        if (self.vm) |*vm| {
+            vm.discard(self.vm_retained, self.vm_used);
+            self.vm_used = 0;
+        }
+
         var block = self.head;
         while (block) |b| {
             b.size = 0;
             block = b.next;
         }
+        self.current = self.head;
 
         // Reset stats
         if (self.allocator.track_stats) {
@@ -245,6 +326,10 @@ pub const ArenaAllocator = struct {
     fn destroy(allocator: *Allocator) void {
         const self = @as(*ArenaAllocator, @ptrCast(@alignCast(allocator.context.?)));
 
+        if (self.vm) |*vm| {
+            vm.release();
+        }
+
         // Free all blocks
         var block = self.head;
         while (block != null) {
@@ -279,6 +364,16 @@ export fn goo_arena_allocator_create(initial_size: usize) ?*Allocator {
     return null;
 }
 
+export fn goo_arena_allocator_create_mapped(reserve_size: usize, page_mode: c_int) ?*Allocator {
+    const mode = std.meta.intToEnum(PageMode, page_mode) catch PageMode.normal;
+
+    if (ArenaAllocator.initMapped(reserve_size, mode)) |arena| {
+        return &arena.allocator;
+    }
+
+    return null;
+}
+
 export fn goo_arena_allocator_reset(allocator: ?*Allocator) void {
     if (allocator == null) return;
 
@@ -0,0 +1,99 @@
+/**
+ * goo_call_arena.c
+ *
+ * Per-thread call arena for the Goo programming language.
+ *
+ * The compiler places allocations that never outlive the allocating call but
+ * are too large for its frame here instead of on the heap. A function takes a
+ * mark on entry, bump-allocates from the arena, and releases back to the mark
+ * on every return, so the whole frame's allocations disappear with one store.
+ *
+ * Each thread reserves one large range up front; pages are faulted in as the
+ * top grows. When the outermost frame releases, pages a deep call left behind
+ * are handed back to the OS. A frame skipped by a panic is reclaimed by the
+ * next release of an enclosing frame.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "goo_allocator.h"
+
+#define CALL_ARENA_RESERVE (64 * 1024 * 1024)   // Address space per thread
+#define CALL_ARENA_RETAIN (1024 * 1024)         // Resident bytes kept after an outermost release
+#define CALL_ARENA_ALIGNMENT 16
+
+typedef struct {
+    char* base;         // Start of the reservation
+    size_t top;         // Bytes in use
+    size_t high_water;  // Highest top since the last trim
+} CallArena;
+
+static __thread CallArena call_arena = { NULL, 0, 0 };
+
+static pthread_key_t call_arena_key;
+static pthread_once_t call_arena_once = PTHREAD_ONCE_INIT;
+
+// Unmap a thread's arena when the thread exits
+static void call_arena_thread_exit(void* base) {
+    munmap(base, CALL_ARENA_RESERVE);
+}
+
+static void call_arena_init_key(void) {
+    pthread_key_create(&call_arena_key, call_arena_thread_exit);
+}
+
+// Reserve the calling thread's arena
+static bool call_arena_reserve(void) {
+    void* base = mmap(NULL, CALL_ARENA_RESERVE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to reserve call arena\n");
+        return false;
+    }
+
+    pthread_once(&call_arena_once, call_arena_init_key);
+    pthread_setspecific(call_arena_key, base);
+
+    call_arena.base = base;
+    call_arena.top = 0;
+    call_arena.high_water = 0;
+    return true;
+}
+
+size_t goo_call_arena_mark(void) {
+    return call_arena.top;
+}
+
+void* goo_call_arena_alloc(size_t size) {
+    if (!call_arena.base && !call_arena_reserve()) {
+        return NULL;
+    }
+
+    size_t start = (call_arena.top + CALL_ARENA_ALIGNMENT - 1) & ~(size_t)(CALL_ARENA_ALIGNMENT - 1);
+    if (size > CALL_ARENA_RESERVE - start) {
+        fprintf(stderr, "Error: Call arena exhausted (%zu bytes requested)\n", size);
+        return NULL;
+    }
+
+    call_arena.top = start + size;
+    if (call_arena.top > call_arena.high_water) {
+        call_arena.high_water = call_arena.top;
+    }
+    return call_arena.base + start;
+}
+
+void goo_call_arena_release(size_t mark) {
+    if (mark > call_arena.top) return;
+    call_arena.top = mark;
+
+    // Outermost frame: return what a deep call faulted in beyond the retained prefix
+    if (mark == 0 && call_arena.high_water > CALL_ARENA_RETAIN) {
+        madvise(call_arena.base + CALL_ARENA_RETAIN,
+                call_arena.high_water - CALL_ARENA_RETAIN, MADV_DONTNEED);
+        call_arena.high_water = CALL_ARENA_RETAIN;
+    }
+}
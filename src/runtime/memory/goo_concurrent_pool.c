@@ -0,0 +1,461 @@
+/**
+ * goo_concurrent_pool.c
+ *
+ * Thread-safe fixed-size pool allocator for the Goo programming language.
+ *
+ * Each thread keeps two magazines per pool, a loaded one and a previous one,
+ * and serves allocations and frees from them without synchronization. When
+ * both are exhausted (or both full), the thread swaps a whole magazine with
+ * the pool's depot: two lock-free stacks, one of magazines holding chunks and
+ * one of empty magazines. Only carving new chunks out of fresh blocks takes
+ * the pool mutex, and it does so one magazine's worth at a time.
+ *
+ * Depot stacks store a magazine index and a modification tag in one 64-bit
+ * word, so a pop cannot be fooled by a magazine that was popped and pushed
+ * back in between (ABA). Magazines are never freed while the pool lives.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "goo_allocator.h"
+#include "goo_concurrent_pool.h"
+
+#define CACHE_LINE_SIZE 64
+#define MAGAZINES_PER_SEGMENT 256
+#define MAX_MAGAZINE_SEGMENTS 256
+#define MIN_BLOCK_SIZE (64 * 1024)
+
+// A stack of free chunks owned by one thread or parked in the depot
+typedef struct Magazine {
+    _Atomic uint32_t next;              // Depot link: index + 1 of the next magazine (0 = none)
+    uint32_t index;                     // Position in the pool's magazine segments
+    uint32_t count;                     // Chunks held
+    void* rounds[GOO_MAGAZINE_ROUNDS];  // The chunks
+} Magazine;
+
+// Header of a block chunks are carved from
+typedef struct ConcurrentBlock {
+    struct ConcurrentBlock* next;
+    size_t size;
+} ConcurrentBlock;
+
+// Chunks freed when no magazine could be obtained
+typedef struct OverflowChunk {
+    struct OverflowChunk* next;
+} OverflowChunk;
+
+struct GooConcurrentPool {
+    GooAllocator* parent;               // Block allocator (NULL = system)
+    size_t chunk_size;                  // Size of each chunk
+    size_t alignment;                   // Alignment of each chunk
+    size_t block_size;                  // Size of each block
+    size_t header_size;                 // Block header size, rounded to alignment
+    int id;                             // Slot in the pool registry
+    uint64_t generation;                // Unique per pool, validates thread caches
+
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t full_depot;   // Magazines holding chunks
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t empty_depot;  // Empty magazines
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t depot_exchanges;
+    _Atomic uint64_t refills;
+
+    // Growth state, guarded by mutex
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t mutex;
+    ConcurrentBlock* blocks;            // All blocks, for destruction
+    char* carve_next;                   // Next uncarved chunk in the newest block
+    size_t carve_left;                  // Uncarved chunks in the newest block
+    OverflowChunk* overflow;            // Chunks freed without a magazine
+    Magazine* segments[MAX_MAGAZINE_SEGMENTS];
+    uint32_t magazine_count;
+    size_t total_chunks;
+    size_t bytes_reserved;
+};
+
+// Per-thread magazines of one pool
+typedef struct ThreadCache {
+    uint64_t generation;                // Pool generation these magazines belong to
+    Magazine* loaded;                   // Serves allocations and frees
+    Magazine* previous;                 // Swapped in before going to the depot
+} ThreadCache;
+
+// Registry of live pools, so exiting threads only flush into pools that exist
+static GooConcurrentPool* pool_registry[GOO_CONCURRENT_POOL_MAX];
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t next_generation = 1;
+
+static __thread ThreadCache thread_caches[GOO_CONCURRENT_POOL_MAX];
+static __thread bool thread_flush_registered = false;
+static pthread_key_t thread_flush_key;
+static pthread_once_t thread_flush_once = PTHREAD_ONCE_INIT;
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// ===== Depot =====
+
+static inline Magazine* magazine_at(GooConcurrentPool* pool, uint32_t index) {
+    return &pool->segments[index / MAGAZINES_PER_SEGMENT][index % MAGAZINES_PER_SEGMENT];
+}
+
+static void depot_push(_Atomic uint64_t* head, Magazine* magazine) {
+    uint64_t old_head = atomic_load_explicit(head, memory_order_acquire);
+    uint64_t new_head;
+    do {
+        atomic_store_explicit(&magazine->next, (uint32_t)old_head, memory_order_relaxed);
+        new_head = (((old_head >> 32) + 1) << 32) | (uint64_t)(magazine->index + 1);
+    } while (!atomic_compare_exchange_weak_explicit(head, &old_head, new_head,
+                                                    memory_order_release,
+                                                    memory_order_acquire));
+}
+
+static Magazine* depot_pop(GooConcurrentPool* pool, _Atomic uint64_t* head) {
+    uint64_t old_head = atomic_load_explicit(head, memory_order_acquire);
+    uint64_t new_head;
+    Magazine* magazine;
+    do {
+        uint32_t top = (uint32_t)old_head;
+        if (top == 0) {
+            return NULL;
+        }
+        magazine = magazine_at(pool, top - 1);
+        uint32_t next = atomic_load_explicit(&magazine->next, memory_order_relaxed);
+        new_head = (((old_head >> 32) + 1) << 32) | next;
+    } while (!atomic_compare_exchange_weak_explicit(head, &old_head, new_head,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire));
+    return magazine;
+}
+
+// ===== Growth (mutex held) =====
+
+static Magazine* create_magazine(GooConcurrentPool* pool) {
+    uint32_t index = pool->magazine_count;
+    if (index >= MAGAZINES_PER_SEGMENT * MAX_MAGAZINE_SEGMENTS) {
+        return NULL;
+    }
+
+    uint32_t segment = index / MAGAZINES_PER_SEGMENT;
+    if (!pool->segments[segment]) {
+        pool->segments[segment] = (Magazine*)calloc(MAGAZINES_PER_SEGMENT, sizeof(Magazine));
+        if (!pool->segments[segment]) {
+            return NULL;
+        }
+    }
+
+    Magazine* magazine = magazine_at(pool, index);
+    magazine->index = index;
+    magazine->count = 0;
+    atomic_init(&magazine->next, 0);
+    pool->magazine_count++;
+    return magazine;
+}
+
+static bool add_block(GooConcurrentPool* pool) {
+    size_t block_alignment = pool->alignment < 16 ? 16 : pool->alignment;
+    ConcurrentBlock* block;
+
+    if (pool->parent) {
+        block = pool->parent->alloc(pool->parent, pool->block_size, block_alignment, GOO_ALLOC_DEFAULT);
+    } else {
+        block = aligned_alloc(block_alignment, pool->block_size);
+    }
+    if (!block) {
+        return false;
+    }
+
+    block->next = pool->blocks;
+    block->size = pool->block_size;
+    pool->blocks = block;
+
+    size_t chunks = (pool->block_size - pool->header_size) / pool->chunk_size;
+    pool->carve_next = (char*)block + pool->header_size;
+    pool->carve_left = chunks;
+    pool->total_chunks += chunks;
+    pool->bytes_reserved += pool->block_size;
+    return true;
+}
+
+// Fill an empty magazine from overflow chunks and fresh blocks
+static void refill_magazine(GooConcurrentPool* pool, Magazine* magazine) {
+    pthread_mutex_lock(&pool->mutex);
+
+    while (magazine->count < GOO_MAGAZINE_ROUNDS && pool->overflow) {
+        OverflowChunk* chunk = pool->overflow;
+        pool->overflow = chunk->next;
+        magazine->rounds[magazine->count++] = chunk;
+    }
+
+    while (magazine->count < GOO_MAGAZINE_ROUNDS) {
+        if (pool->carve_left == 0 && !add_block(pool)) {
+            break;
+        }
+        magazine->rounds[magazine->count++] = pool->carve_next;
+        pool->carve_next += pool->chunk_size;
+        pool->carve_left--;
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+    atomic_fetch_add_explicit(&pool->refills, 1, memory_order_relaxed);
+}
+
+// Get an empty magazine from the depot or create one
+static Magazine* take_empty_magazine(GooConcurrentPool* pool) {
+    Magazine* magazine = depot_pop(pool, &pool->empty_depot);
+    if (magazine) {
+        return magazine;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    magazine = create_magazine(pool);
+    pthread_mutex_unlock(&pool->mutex);
+    return magazine;
+}
+
+// ===== Thread caches =====
+
+static void thread_flush_destructor(void* value) {
+    (void)value;
+    goo_concurrent_pool_thread_flush();
+}
+
+static void create_thread_flush_key(void) {
+    pthread_key_create(&thread_flush_key, thread_flush_destructor);
+}
+
+static ThreadCache* get_thread_cache(GooConcurrentPool* pool) {
+    ThreadCache* cache = &thread_caches[pool->id];
+    if (cache->generation == pool->generation) {
+        return cache;
+    }
+
+    // First use of this pool on this thread
+    if (!thread_flush_registered) {
+        pthread_once(&thread_flush_once, create_thread_flush_key);
+        pthread_setspecific(thread_flush_key, (void*)1);
+        thread_flush_registered = true;
+    }
+
+    Magazine* loaded = take_empty_magazine(pool);
+    Magazine* previous = loaded ? take_empty_magazine(pool) : NULL;
+    if (!previous) {
+        if (loaded) depot_push(&pool->empty_depot, loaded);
+        fprintf(stderr, "Error: Failed to create magazines for concurrent pool\n");
+        return NULL;
+    }
+
+    cache->loaded = loaded;
+    cache->previous = previous;
+    cache->generation = pool->generation;
+    return cache;
+}
+
+// Return the calling thread's magazines to their depots
+void goo_concurrent_pool_thread_flush(void) {
+    pthread_mutex_lock(&registry_mutex);
+
+    for (int i = 0; i < GOO_CONCURRENT_POOL_MAX; i++) {
+        ThreadCache* cache = &thread_caches[i];
+        GooConcurrentPool* pool = pool_registry[i];
+        if (cache->generation == 0 || !pool || pool->generation != cache->generation) {
+            cache->generation = 0;
+            continue;
+        }
+
+        Magazine* magazines[2] = { cache->loaded, cache->previous };
+        for (int m = 0; m < 2; m++) {
+            depot_push(magazines[m]->count > 0 ? &pool->full_depot : &pool->empty_depot,
+                       magazines[m]);
+        }
+        cache->generation = 0;
+    }
+
+    pthread_mutex_unlock(&registry_mutex);
+}
+
+// ===== Public API =====
+
+// Create a concurrent pool
+GooConcurrentPool* goo_concurrent_pool_create(GooAllocator* parent, size_t chunk_size,
+                                              size_t alignment) {
+    if (alignment == 0) alignment = sizeof(void*);
+    if ((alignment & (alignment - 1)) != 0) {
+        fprintf(stderr, "Error: Concurrent pool alignment must be a power of two\n");
+        return NULL;
+    }
+
+    // Chunks must hold an overflow link
+    if (chunk_size < sizeof(OverflowChunk)) chunk_size = sizeof(OverflowChunk);
+    chunk_size = align_up(chunk_size, alignment);
+
+    GooConcurrentPool* pool = (GooConcurrentPool*)aligned_alloc(CACHE_LINE_SIZE,
+        align_up(sizeof(GooConcurrentPool), CACHE_LINE_SIZE));
+    if (!pool) {
+        return NULL;
+    }
+    memset(pool, 0, sizeof(GooConcurrentPool));
+
+    pool->parent = parent;
+    pool->chunk_size = chunk_size;
+    pool->alignment = alignment;
+    pool->header_size = align_up(sizeof(ConcurrentBlock), alignment);
+    pool->block_size = pool->header_size + chunk_size * GOO_MAGAZINE_ROUNDS;
+    if (pool->block_size < MIN_BLOCK_SIZE) pool->block_size = MIN_BLOCK_SIZE;
+    pool->block_size = align_up(pool->block_size, alignment < 16 ? 16 : alignment);
+    atomic_init(&pool->full_depot, 0);
+    atomic_init(&pool->empty_depot, 0);
+    atomic_init(&pool->depot_exchanges, 0);
+    atomic_init(&pool->refills, 0);
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        free(pool);
+        return NULL;
+    }
+
+    // Claim a registry slot
+    pthread_mutex_lock(&registry_mutex);
+    pool->id = -1;
+    for (int i = 0; i < GOO_CONCURRENT_POOL_MAX; i++) {
+        if (!pool_registry[i]) {
+            pool->id = i;
+            pool->generation = next_generation++;
+            pool_registry[i] = pool;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&registry_mutex);
+
+    if (pool->id < 0) {
+        fprintf(stderr, "Error: Too many concurrent pools (max %d)\n", GOO_CONCURRENT_POOL_MAX);
+        pthread_mutex_destroy(&pool->mutex);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+// Destroy a concurrent pool
+void goo_concurrent_pool_destroy(GooConcurrentPool* pool) {
+    if (!pool) return;
+
+    // After this, exiting threads no longer flush into the pool
+    pthread_mutex_lock(&registry_mutex);
+    pool_registry[pool->id] = NULL;
+    pthread_mutex_unlock(&registry_mutex);
+
+    ConcurrentBlock* block = pool->blocks;
+    size_t block_alignment = pool->alignment < 16 ? 16 : pool->alignment;
+    while (block) {
+        ConcurrentBlock* next = block->next;
+        if (pool->parent) {
+            pool->parent->free(pool->parent, block, block->size, block_alignment);
+        } else {
+            free(block);
+        }
+        block = next;
+    }
+
+    for (int i = 0; i < MAX_MAGAZINE_SEGMENTS; i++) {
+        free(pool->segments[i]);
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+// Allocate one chunk
+void* goo_concurrent_pool_alloc(GooConcurrentPool* pool) {
+    if (!pool) return NULL;
+
+    ThreadCache* cache = get_thread_cache(pool);
+    if (!cache) return NULL;
+
+    Magazine* loaded = cache->loaded;
+    if (loaded->count == 0) {
+        if (cache->previous->count > 0) {
+            cache->loaded = cache->previous;
+            cache->previous = loaded;
+        } else {
+            Magazine* full = depot_pop(pool, &pool->full_depot);
+            if (full) {
+                // Both ours are empty: park one, take a full one
+                depot_push(&pool->empty_depot, cache->previous);
+                cache->previous = loaded;
+                cache->loaded = full;
+                atomic_fetch_add_explicit(&pool->depot_exchanges, 1, memory_order_relaxed);
+            } else {
+                refill_magazine(pool, loaded);
+                if (loaded->count == 0) {
+                    return NULL;
+                }
+            }
+        }
+        loaded = cache->loaded;
+    }
+
+    return loaded->rounds[--loaded->count];
+}
+
+// Free a chunk
+void goo_concurrent_pool_free(GooConcurrentPool* pool, void* ptr) {
+    if (!pool || !ptr) return;
+
+    ThreadCache* cache = get_thread_cache(pool);
+    Magazine* loaded = cache ? cache->loaded : NULL;
+
+    if (loaded && loaded->count == GOO_MAGAZINE_ROUNDS) {
+        if (cache->previous->count < GOO_MAGAZINE_ROUNDS) {
+            cache->loaded = cache->previous;
+            cache->previous = loaded;
+        } else {
+            Magazine* empty = take_empty_magazine(pool);
+            if (empty) {
+                // Both ours are full: park one, take an empty one
+                depot_push(&pool->full_depot, cache->previous);
+                cache->previous = loaded;
+                cache->loaded = empty;
+                atomic_fetch_add_explicit(&pool->depot_exchanges, 1, memory_order_relaxed);
+            } else {
+                loaded = NULL;
+            }
+        }
+        if (loaded) loaded = cache->loaded;
+    }
+
+    if (!loaded) {
+        // No magazine available; keep the chunk on the locked overflow list
+        OverflowChunk* chunk = (OverflowChunk*)ptr;
+        pthread_mutex_lock(&pool->mutex);
+        chunk->next = pool->overflow;
+        pool->overflow = chunk;
+        pthread_mutex_unlock(&pool->mutex);
+        return;
+    }
+
+    loaded->rounds[loaded->count++] = ptr;
+}
+
+// Get the chunk size of a pool
+size_t goo_concurrent_pool_chunk_size(const GooConcurrentPool* pool) {
+    return pool ? pool->chunk_size : 0;
+}
+
+// Get pool statistics
+void goo_concurrent_pool_get_stats(GooConcurrentPool* pool, GooConcurrentPoolStats* stats) {
+    if (!pool || !stats) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    stats->chunk_size = pool->chunk_size;
+    stats->total_chunks = pool->total_chunks;
+    stats->bytes_reserved = pool->bytes_reserved;
+    stats->magazines = pool->magazine_count;
+    pthread_mutex_unlock(&pool->mutex);
+
+    stats->depot_exchanges = atomic_load_explicit(&pool->depot_exchanges, memory_order_relaxed);
+    stats->refills = atomic_load_explicit(&pool->refills, memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+/**
+ * goo_concurrent_pool.h
+ *
+ * Thread-safe fixed-size pool allocator for the Goo programming language.
+ * Each thread allocates from and frees into private magazines (small stacks
+ * of free chunks); whole magazines are exchanged with a shared lock-free
+ * depot, so the common path never touches shared state.
+ */
+
+#ifndef GOO_CONCURRENT_POOL_H
+#define GOO_CONCURRENT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Only the block allocator handle is needed here; including goo_allocator.h
+// would clash with the public allocator declarations in goo_memory.h
+typedef struct GooAllocator GooAllocator;
+
+// Chunks held by one magazine
+#define GOO_MAGAZINE_ROUNDS 64
+
+// Maximum number of concurrent pools alive at once
+#define GOO_CONCURRENT_POOL_MAX 128
+
+typedef struct GooConcurrentPool GooConcurrentPool;
+
+// Pool statistics
+typedef struct GooConcurrentPoolStats {
+    size_t chunk_size;          // Size of each chunk
+    size_t total_chunks;        // Chunks carved from blocks
+    size_t bytes_reserved;      // Bytes obtained from the parent allocator
+    size_t magazines;           // Magazines created
+    uint64_t depot_exchanges;   // Magazines swapped with the depot
+    uint64_t refills;           // Magazines filled from blocks (locked path)
+} GooConcurrentPoolStats;
+
+/**
+ * Create a concurrent pool.
+ *
+ * @param parent Allocator for blocks (NULL = system allocator)
+ * @param chunk_size Size of each allocation
+ * @param alignment Alignment of each allocation (power of two)
+ * @return New pool, or NULL on failure
+ */
+GooConcurrentPool* goo_concurrent_pool_create(GooAllocator* parent, size_t chunk_size,
+                                              size_t alignment);
+
+/**
+ * Destroy a pool and release all its memory. No thread may still be using it;
+ * chunks cached by other threads are reclaimed with the pool's blocks.
+ */
+void goo_concurrent_pool_destroy(GooConcurrentPool* pool);
+
+/**
+ * Allocate one chunk. Safe to call from any thread.
+ */
+void* goo_concurrent_pool_alloc(GooConcurrentPool* pool);
+
+/**
+ * Free a chunk allocated from this pool. May be called from any thread,
+ * including one other than the allocating thread.
+ */
+void goo_concurrent_pool_free(GooConcurrentPool* pool, void* ptr);
+
+/**
+ * Get the chunk size of a pool.
+ */
+size_t goo_concurrent_pool_chunk_size(const GooConcurrentPool* pool);
+
+/**
+ * Get pool statistics.
+ */
+void goo_concurrent_pool_get_stats(GooConcurrentPool* pool, GooConcurrentPoolStats* stats);
+
+/**
+ * Return the calling thread's cached magazines to their depots. Runs
+ * automatically at thread exit.
+ */
+void goo_concurrent_pool_thread_flush(void);
+
+#endif // GOO_CONCURRENT_POOL_H
@@ -0,0 +1,675 @@
+/**
+ * goo_heap_profile.c
+ *
+ * Sampling heap profiler for the Goo programming language.
+ *
+ * The allocator keeps a per-thread countdown of bytes and calls in here when
+ * it goes negative, so unsampled allocations cost one subtraction. Intervals
+ * are drawn from an exponential distribution with the configured mean, which
+ * makes sampling a Poisson process over allocated bytes: each sample is
+ * weighted by 1 / (1 - e^(-size/rate)) to estimate the allocations it stands
+ * for. Frees are screened by a table of counters indexed by pointer hash and
+ * only take the lock when the pointer may have been sampled.
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#include "goo_heap_profile.h"
+
+#define PROFILE_STACK_SLOTS 4096    // Hash chains for distinct stacks
+#define PROFILE_LIVE_SLOTS 4096     // Hash chains for live samples
+#define PROFILE_FILTER_SLOTS 65536  // Counters screening frees
+#define PROFILE_SKIP_FRAMES 1       // goo_heap_profile_sample itself
+#define PROFILE_MAX_MAPPINGS 256
+
+// Allocator-visible state (see goo_heap_profile.h)
+size_t goo_heap_profile_rate = 0;
+size_t goo_heap_profile_live_count = 0;
+
+// Samples aggregated by call stack
+typedef struct ProfileStack {
+    struct ProfileStack* next;      // Hash chain
+    struct ProfileStack* all_next;  // All stacks, newest first
+    uint64_t hash;
+    int depth;
+    void* frames[GOO_HEAP_PROFILE_MAX_DEPTH];
+    double alloc_objects;           // Estimated, weighted by sample probability
+    double alloc_bytes;
+    double free_objects;
+    double free_bytes;
+} ProfileStack;
+
+// A sampled allocation that has not been freed
+typedef struct LiveSample {
+    struct LiveSample* next;
+    void* ptr;
+    size_t size;
+    double weight;
+    ProfileStack* stack;
+} LiveSample;
+
+static struct {
+    pthread_mutex_t lock;           // Guards everything below
+    ProfileStack* stacks[PROFILE_STACK_SLOTS];
+    ProfileStack* all;
+    size_t stack_count;
+    LiveSample* live[PROFILE_LIVE_SLOTS];
+    uint64_t samples;
+    uint64_t dropped;
+} profile = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// Nonzero where a live sample's pointer hashes; frees elsewhere skip the lock
+static _Atomic uint16_t sample_filter[PROFILE_FILTER_SLOTS];
+
+static __thread uint64_t sample_rng = 0;
+
+// Signal-triggered dumps: the handler writes a byte, the writer thread dumps
+static struct {
+    int pipe[2];
+    bool started;
+    char path[4096];
+    GooHeapProfileFormat format;
+} profile_signal = { { -1, -1 }, false, "", GOO_HEAP_PROFILE_PPROF };
+
+static inline uint64_t hash_pointer(const void* ptr) {
+    uint64_t x = (uint64_t)(uintptr_t)ptr;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static uint64_t hash_frames(void* const* frames, int depth) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < depth; i++) {
+        h ^= (uint64_t)(uintptr_t)frames[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Bytes until the next sample, exponentially distributed with mean rate
+static int64_t next_sample_interval(size_t rate) {
+    uint64_t x = sample_rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    sample_rng = x;
+
+    // Uniform in (0, 1]
+    double u = (double)(((x * 0x2545f4914f6cdd1dULL) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    double interval = -log(u) * (double)rate;
+    if (interval < 1.0) return 1;
+    if (interval > (double)(INT64_MAX / 2)) return INT64_MAX / 2;
+    return (int64_t)interval;
+}
+
+// Find or add the stack for frames; called with the lock held
+static ProfileStack* stack_for(void* const* frames, int depth) {
+    uint64_t hash = hash_frames(frames, depth);
+    size_t slot = hash & (PROFILE_STACK_SLOTS - 1);
+
+    for (ProfileStack* s = profile.stacks[slot]; s; s = s->next) {
+        if (s->hash == hash && s->depth == depth &&
+            memcmp(s->frames, frames, (size_t)depth * sizeof(void*)) == 0) {
+            return s;
+        }
+    }
+
+    ProfileStack* s = calloc(1, sizeof(ProfileStack));
+    if (!s) return NULL;
+    s->hash = hash;
+    s->depth = depth;
+    memcpy(s->frames, frames, (size_t)depth * sizeof(void*));
+    s->next = profile.stacks[slot];
+    profile.stacks[slot] = s;
+    s->all_next = profile.all;
+    profile.all = s;
+    profile.stack_count++;
+    return s;
+}
+
+int64_t goo_heap_profile_sample(void* ptr, size_t size) {
+    size_t rate = __atomic_load_n(&goo_heap_profile_rate, __ATOMIC_RELAXED);
+    if (rate == 0) return INT64_MAX / 2;
+
+    // A thread's first countdown only seeds its generator
+    if (sample_rng == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        sample_rng = (hash_pointer(&sample_rng) ^ (uint64_t)ts.tv_nsec) | 1;
+        return next_sample_interval(rate);
+    }
+
+    if (!ptr) return next_sample_interval(rate);
+
+    void* frames[GOO_HEAP_PROFILE_MAX_DEPTH + PROFILE_SKIP_FRAMES];
+    int depth = backtrace(frames, GOO_HEAP_PROFILE_MAX_DEPTH + PROFILE_SKIP_FRAMES) - PROFILE_SKIP_FRAMES;
+    if (depth < 0) depth = 0;
+
+    double weight = size == 0 ? 1.0 : 1.0 / (1.0 - exp(-(double)size / (double)rate));
+
+    LiveSample* sample = malloc(sizeof(LiveSample));
+
+    pthread_mutex_lock(&profile.lock);
+    ProfileStack* stack = sample ? stack_for(frames + PROFILE_SKIP_FRAMES, depth) : NULL;
+    if (!stack) {
+        profile.dropped++;
+        pthread_mutex_unlock(&profile.lock);
+        free(sample);
+        return next_sample_interval(rate);
+    }
+
+    stack->alloc_objects += weight;
+    stack->alloc_bytes += weight * (double)size;
+
+    uint64_t hash = hash_pointer(ptr);
+    sample->ptr = ptr;
+    sample->size = size;
+    sample->weight = weight;
+    sample->stack = stack;
+    sample->next = profile.live[hash & (PROFILE_LIVE_SLOTS - 1)];
+    profile.live[hash & (PROFILE_LIVE_SLOTS - 1)] = sample;
+    atomic_fetch_add_explicit(&sample_filter[hash & (PROFILE_FILTER_SLOTS - 1)], 1, memory_order_relaxed);
+    __atomic_add_fetch(&goo_heap_profile_live_count, 1, __ATOMIC_RELAXED);
+    profile.samples++;
+    pthread_mutex_unlock(&profile.lock);
+
+    return next_sample_interval(rate);
+}
+
+void goo_heap_profile_free(void* ptr) {
+    if (!ptr) return;
+
+    uint64_t hash = hash_pointer(ptr);
+    if (atomic_load_explicit(&sample_filter[hash & (PROFILE_FILTER_SLOTS - 1)], memory_order_relaxed) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&profile.lock);
+    LiveSample** link = &profile.live[hash & (PROFILE_LIVE_SLOTS - 1)];
+    while (*link && (*link)->ptr != ptr) {
+        link = &(*link)->next;
+    }
+
+    LiveSample* sample = *link;
+    if (sample) {
+        *link = sample->next;
+        sample->stack->free_objects += sample->weight;
+        sample->stack->free_bytes += sample->weight * (double)sample->size;
+        atomic_fetch_sub_explicit(&sample_filter[hash & (PROFILE_FILTER_SLOTS - 1)], 1, memory_order_relaxed);
+        __atomic_sub_fetch(&goo_heap_profile_live_count, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&profile.lock);
+
+    free(sample);
+}
+
+void goo_heap_profile_set_rate(size_t rate) {
+    // backtrace() loads its unwinder on first use; do that before any sample
+    if (rate != 0) {
+        void* frame;
+        backtrace(&frame, 1);
+    }
+    __atomic_store_n(&goo_heap_profile_rate, rate, __ATOMIC_RELAXED);
+}
+
+size_t goo_heap_profile_get_rate(void) {
+    return __atomic_load_n(&goo_heap_profile_rate, __ATOMIC_RELAXED);
+}
+
+GooHeapProfileStats goo_heap_profile_get_stats(void) {
+    GooHeapProfileStats stats = {0};
+    double alloc_bytes = 0, inuse_bytes = 0;
+
+    pthread_mutex_lock(&profile.lock);
+    for (ProfileStack* s = profile.all; s; s = s->all_next) {
+        alloc_bytes += s->alloc_bytes;
+        inuse_bytes += s->alloc_bytes - s->free_bytes;
+    }
+    stats.samples = profile.samples;
+    stats.dropped_samples = profile.dropped;
+    stats.stacks = profile.stack_count;
+    stats.live_samples = __atomic_load_n(&goo_heap_profile_live_count, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&profile.lock);
+
+    stats.alloc_bytes = (uint64_t)alloc_bytes;
+    stats.inuse_bytes = inuse_bytes > 0 ? (uint64_t)inuse_bytes : 0;
+    return stats;
+}
+
+void goo_heap_profile_reset(void) {
+    pthread_mutex_lock(&profile.lock);
+    for (size_t i = 0; i < PROFILE_LIVE_SLOTS; i++) {
+        LiveSample* sample = profile.live[i];
+        while (sample) {
+            LiveSample* next = sample->next;
+            free(sample);
+            sample = next;
+        }
+        profile.live[i] = NULL;
+    }
+
+    ProfileStack* stack = profile.all;
+    while (stack) {
+        ProfileStack* next = stack->all_next;
+        free(stack);
+        stack = next;
+    }
+    memset(profile.stacks, 0, sizeof(profile.stacks));
+    profile.all = NULL;
+    profile.stack_count = 0;
+    profile.samples = 0;
+    profile.dropped = 0;
+
+    for (size_t i = 0; i < PROFILE_FILTER_SLOTS; i++) {
+        atomic_store_explicit(&sample_filter[i], 0, memory_order_relaxed);
+    }
+    __atomic_store_n(&goo_heap_profile_live_count, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&profile.lock);
+}
+
+// ===== Output =====
+
+// Growable output buffer; failed latches on allocation failure
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} ProfileBuffer;
+
+static void buffer_put(ProfileBuffer* buf, const void* data, size_t len) {
+    if (buf->failed) return;
+    if (buf->len + len > buf->cap) {
+        size_t cap = buf->cap ? buf->cap : 4096;
+        while (cap < buf->len + len) cap *= 2;
+        uint8_t* data_new = realloc(buf->data, cap);
+        if (!data_new) {
+            buf->failed = true;
+            return;
+        }
+        buf->data = data_new;
+        buf->cap = cap;
+    }
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+static void buffer_printf(ProfileBuffer* buf, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void buffer_printf(ProfileBuffer* buf, const char* format, ...) {
+    char text[512];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (len < 0) return;
+    buffer_put(buf, text, (size_t)len < sizeof(text) ? (size_t)len : sizeof(text) - 1);
+}
+
+static void pb_varint(ProfileBuffer* buf, uint64_t value) {
+    uint8_t bytes[10];
+    size_t n = 0;
+    do {
+        bytes[n] = (uint8_t)(value & 0x7f);
+        value >>= 7;
+        if (value) bytes[n] |= 0x80;
+        n++;
+    } while (value);
+    buffer_put(buf, bytes, n);
+}
+
+static void pb_uint(ProfileBuffer* buf, int field, uint64_t value) {
+    pb_varint(buf, (uint64_t)field << 3);
+    pb_varint(buf, value);
+}
+
+static void pb_bytes(ProfileBuffer* buf, int field, const void* data, size_t len) {
+    pb_varint(buf, ((uint64_t)field << 3) | 2);
+    pb_varint(buf, len);
+    buffer_put(buf, data, len);
+}
+
+// Append msg as field of buf and clear msg for reuse
+static void pb_message(ProfileBuffer* buf, int field, ProfileBuffer* msg) {
+    if (msg->failed) buf->failed = true;
+    pb_bytes(buf, field, msg->data, msg->len);
+    msg->len = 0;
+}
+
+// Executable mappings of this process, for pprof to symbolize against
+typedef struct {
+    uintptr_t start;
+    uintptr_t limit;
+    uint64_t offset;
+    char path[256];
+} ProfileMapping;
+
+static int read_mappings(ProfileMapping* mappings, int max) {
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) return 0;
+
+    int count = 0;
+    char line[512];
+    while (count < max && fgets(line, sizeof(line), maps)) {
+        unsigned long start, limit, offset;
+        char perms[8];
+        int path_at = 0;
+        if (sscanf(line, "%lx-%lx %7s %lx %*s %*s %n", &start, &limit, perms, &offset, &path_at) < 4) continue;
+        if (perms[2] != 'x' || path_at == 0 || line[path_at] != '/') continue;
+
+        ProfileMapping* m = &mappings[count++];
+        m->start = start;
+        m->limit = limit;
+        m->offset = offset;
+        snprintf(m->path, sizeof(m->path), "%s", line + path_at);
+        m->path[strcspn(m->path, "\n")] = '\0';
+    }
+
+    fclose(maps);
+    return count;
+}
+
+// Index of s in the string table, adding it if needed
+static uint64_t string_index(const char** strings, size_t* count, size_t max, const char* s) {
+    for (size_t i = 0; i < *count; i++) {
+        if (strcmp(strings[i], s) == 0) return i;
+    }
+    if (*count == max) return 0;
+    strings[*count] = s;
+    return (*count)++;
+}
+
+// Encode the profile as a perftools.profiles.Profile message; called with the lock held
+static void encode_pprof(ProfileBuffer* out) {
+    static ProfileMapping mappings[PROFILE_MAX_MAPPINGS];
+    int mapping_count = read_mappings(mappings, PROFILE_MAX_MAPPINGS);
+
+    const char* strings[PROFILE_MAX_MAPPINGS + 16];
+    size_t string_count = 0;
+    const size_t string_max = sizeof(strings) / sizeof(strings[0]);
+    string_index(strings, &string_count, string_max, "");
+
+    ProfileBuffer msg = {0};
+    ProfileBuffer inner = {0};
+
+    // sample_type: alloc_objects, alloc_space, inuse_objects, inuse_space
+    static const char* const value_types[4][2] = {
+        { "alloc_objects", "count" }, { "alloc_space", "bytes" },
+        { "inuse_objects", "count" }, { "inuse_space", "bytes" },
+    };
+    for (int i = 0; i < 4; i++) {
+        pb_uint(&msg, 1, string_index(strings, &string_count, string_max, value_types[i][0]));
+        pb_uint(&msg, 2, string_index(strings, &string_count, string_max, value_types[i][1]));
+        pb_message(out, 1, &msg);
+    }
+
+    // Locations: one per distinct frame address, ids assigned in first-seen order
+    size_t frame_total = 0;
+    for (ProfileStack* s = profile.all; s; s = s->all_next) frame_total += (size_t)s->depth;
+    size_t table_cap = 16;
+    while (table_cap < frame_total * 2) table_cap *= 2;
+    uintptr_t* addresses = calloc(table_cap, sizeof(uintptr_t));
+    uint64_t* ids = calloc(table_cap, sizeof(uint64_t));
+    if (!addresses || !ids) {
+        out->failed = true;
+        free(addresses);
+        free(ids);
+        return;
+    }
+    uint64_t next_id = 1;
+
+    for (ProfileStack* s = profile.all; s; s = s->all_next) {
+        double inuse_objects = s->alloc_objects - s->free_objects;
+        double inuse_bytes = s->alloc_bytes - s->free_bytes;
+
+        for (int i = 0; i < s->depth; i++) {
+            // Return address minus one lands inside the call instruction
+            uintptr_t address = (uintptr_t)s->frames[i] - 1;
+            size_t slot = hash_pointer((void*)address) & (table_cap - 1);
+            while (addresses[slot] && addresses[slot] != address) {
+                slot = (slot + 1) & (table_cap - 1);
+            }
+
+            if (!addresses[slot]) {
+                addresses[slot] = address;
+                ids[slot] = next_id++;
+
+                pb_uint(&msg, 1, ids[slot]);
+                for (int m = 0; m < mapping_count; m++) {
+                    if (address >= mappings[m].start && address < mappings[m].limit) {
+                        pb_uint(&msg, 2, (uint64_t)m + 1);
+                        break;
+                    }
+                }
+                pb_uint(&msg, 3, address);
+                pb_message(out, 4, &msg);
+            }
+            pb_varint(&inner, ids[slot]);
+        }
+
+        // sample: packed location ids, packed values
+        pb_message(&msg, 1, &inner);
+        pb_varint(&inner, (uint64_t)(int64_t)llround(s->alloc_objects));
+        pb_varint(&inner, (uint64_t)(int64_t)llround(s->alloc_bytes));
+        pb_varint(&inner, (uint64_t)(int64_t)llround(inuse_objects > 0 ? inuse_objects : 0));
+        pb_varint(&inner, (uint64_t)(int64_t)llround(inuse_bytes > 0 ? inuse_bytes : 0));
+        pb_message(&msg, 2, &inner);
+        pb_message(out, 2, &msg);
+    }
+    free(addresses);
+    free(ids);
+
+    for (int m = 0; m < mapping_count; m++) {
+        pb_uint(&msg, 1, (uint64_t)m + 1);
+        pb_uint(&msg, 2, mappings[m].start);
+        pb_uint(&msg, 3, mappings[m].limit);
+        pb_uint(&msg, 4, mappings[m].offset);
+        pb_uint(&msg, 5, string_index(strings, &string_count, string_max, mappings[m].path));
+        pb_message(out, 3, &msg);
+    }
+
+    // period_type and period describe the sampling interval
+    pb_uint(&msg, 1, string_index(strings, &string_count, string_max, "space"));
+    pb_uint(&msg, 2, string_index(strings, &string_count, string_max, "bytes"));
+    pb_message(out, 11, &msg);
+    pb_uint(out, 12, goo_heap_profile_get_rate());
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    pb_uint(out, 9, (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+    pb_uint(out, 14, string_index(strings, &string_count, string_max, "inuse_space"));
+
+    for (size_t i = 0; i < string_count; i++) {
+        pb_bytes(out, 6, strings[i], strlen(strings[i]));
+    }
+
+    free(msg.data);
+    free(inner.data);
+}
+
+// Symbol name for a frame, or its address if it has none
+static void frame_name(void* frame, char* name, size_t size) {
+    Dl_info info;
+    if (dladdr((char*)frame - 1, &info) && info.dli_sname) {
+        snprintf(name, size, "%s", info.dli_sname);
+    } else {
+        snprintf(name, size, "0x%lx", (unsigned long)(uintptr_t)frame);
+    }
+}
+
+// Encode "root;...;leaf bytes" lines; called with the lock held
+static void encode_folded(ProfileBuffer* out, bool inuse) {
+    char name[256];
+
+    for (ProfileStack* s = profile.all; s; s = s->all_next) {
+        double bytes = inuse ? s->alloc_bytes - s->free_bytes : s->alloc_bytes;
+        long long value = llround(bytes);
+        if (value <= 0) continue;
+
+        for (int i = s->depth - 1; i >= 0; i--) {
+            frame_name(s->frames[i], name, sizeof(name));
+            buffer_printf(out, "%s%s", name, i > 0 ? ";" : "");
+        }
+        buffer_printf(out, " %lld\n", value);
+    }
+}
+
+bool goo_heap_profile_write_fd(int fd, GooHeapProfileFormat format) {
+    ProfileBuffer out = {0};
+
+    pthread_mutex_lock(&profile.lock);
+    switch (format) {
+        case GOO_HEAP_PROFILE_PPROF:
+            encode_pprof(&out);
+            break;
+        case GOO_HEAP_PROFILE_FOLDED_INUSE:
+            encode_folded(&out, true);
+            break;
+        case GOO_HEAP_PROFILE_FOLDED_ALLOC:
+            encode_folded(&out, false);
+            break;
+        default:
+            out.failed = true;
+            break;
+    }
+    pthread_mutex_unlock(&profile.lock);
+
+    if (out.failed) {
+        fprintf(stderr, "Error: Failed to encode heap profile\n");
+        free(out.data);
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < out.len) {
+        ssize_t n = write(fd, out.data + written, out.len - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            fprintf(stderr, "Error: Failed to write heap profile\n");
+            free(out.data);
+            return false;
+        }
+        written += (size_t)n;
+    }
+
+    free(out.data);
+    return true;
+}
+
+bool goo_heap_profile_write(const char* path, GooHeapProfileFormat format) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Failed to open heap profile %s\n", path);
+        return false;
+    }
+
+    bool ok = goo_heap_profile_write_fd(fd, format);
+    close(fd);
+    return ok;
+}
+
+static void profile_signal_handler(int signum) {
+    (void)signum;
+    int saved_errno = errno;
+    char byte = 1;
+    ssize_t ignored = write(profile_signal.pipe[1], &byte, 1);
+    (void)ignored;
+    errno = saved_errno;
+}
+
+static void* profile_signal_thread(void* arg) {
+    (void)arg;
+    char byte;
+
+    for (;;) {
+        ssize_t n = read(profile_signal.pipe[0], &byte, 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+
+        char path[sizeof(profile_signal.path)];
+        pthread_mutex_lock(&profile.lock);
+        memcpy(path, profile_signal.path, sizeof(path));
+        GooHeapProfileFormat format = profile_signal.format;
+        pthread_mutex_unlock(&profile.lock);
+
+        goo_heap_profile_write(path, format);
+    }
+    return NULL;
+}
+
+bool goo_heap_profile_dump_on_signal(int signum, const char* path, GooHeapProfileFormat format) {
+    if (!path || strlen(path) >= sizeof(profile_signal.path)) {
+        fprintf(stderr, "Error: Invalid heap profile path\n");
+        return false;
+    }
+
+    pthread_mutex_lock(&profile.lock);
+    snprintf(profile_signal.path, sizeof(profile_signal.path), "%s", path);
+    profile_signal.format = format;
+
+    if (!profile_signal.started) {
+        if (pipe2(profile_signal.pipe, O_CLOEXEC) != 0) {
+            pthread_mutex_unlock(&profile.lock);
+            fprintf(stderr, "Error: Failed to create heap profile signal pipe\n");
+            return false;
+        }
+        // A burst of signals must never block the handler
+        fcntl(profile_signal.pipe[1], F_SETFL, O_NONBLOCK);
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, profile_signal_thread, NULL) != 0) {
+            close(profile_signal.pipe[0]);
+            close(profile_signal.pipe[1]);
+            pthread_mutex_unlock(&profile.lock);
+            fprintf(stderr, "Error: Failed to start heap profile writer\n");
+            return false;
+        }
+        pthread_detach(thread);
+        profile_signal.started = true;
+    }
+    pthread_mutex_unlock(&profile.lock);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = profile_signal_handler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(signum, &action, NULL) != 0) {
+        fprintf(stderr, "Error: Failed to install heap profile signal handler\n");
+        return false;
+    }
+    return true;
+}
+
+bool goo_heap_profile_init_from_env(void) {
+    const char* rate = getenv("GOO_HEAP_PROFILE_RATE");
+    const char* path = getenv("GOO_HEAP_PROFILE_PATH");
+    if (!rate && !path) return true;
+
+    goo_heap_profile_set_rate(rate ? strtoull(rate, NULL, 10) : GOO_HEAP_PROFILE_DEFAULT_RATE);
+    if (!path) return true;
+    size_t len = strlen(path);
+    GooHeapProfileFormat format = len > 7 && strcmp(path + len - 7, ".folded") == 0
+        ? GOO_HEAP_PROFILE_FOLDED_INUSE : GOO_HEAP_PROFILE_PPROF;
+    return goo_heap_profile_dump_on_signal(SIGUSR2, path, format);
+}
@@ -1,166 +1,452 @@
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
 
 #include "goo_memory.h"
+#include "goo_memory_stats.h"
+
+// Allocations between peak merges on a thread that keeps growing
+#define STATS_MERGE_INTERVAL 1024
+
+// Counters for one allocator
+typedef struct {
+    _Atomic uint64_t bytes_allocated;
+    _Atomic uint64_t bytes_freed;
+    _Atomic uint64_t allocations;
+    _Atomic uint64_t frees;
+} StatsCounters;
+
+// Counter block owned by one thread. Only the owner writes, so updates are
+// plain load/store pairs; readers sum all blocks without stopping writers.
+typedef struct ThreadStats {
+    struct ThreadStats* next;          // Registry link (blocks are never freed)
+    _Atomic bool in_use;               // Owned by a live thread
+    _Atomic int64_t net_bytes;         // Bytes allocated minus freed by the owner
+    _Atomic int64_t high_water;        // Highest net_bytes seen
+    uint32_t since_merge;              // Allocations since the last peak merge
+    uint32_t epoch;                    // Reset epoch high_water belongs to
+    StatsCounters allocators[GOO_STATS_MAX_ALLOCATORS];
+    _Atomic uint64_t class_allocations[GOO_STATS_SIZE_CLASSES];
+    _Atomic uint64_t class_frees[GOO_STATS_SIZE_CLASSES];
+} ThreadStats;
+
+// Counters for threads past their exit destructor. Several threads may write
+// it, so its updates are atomic read-modify-writes; it stays in the registry
+// and is never handed out for reuse.
+static ThreadStats shared_stats = { .in_use = true };
 
 // Memory statistics for tracking allocations
 static struct {
-    size_t total_allocated;    // Current total bytes allocated
-    size_t peak_allocated;     // Peak allocation in bytes
-    size_t allocation_count;   // Number of active allocations
-    bool tracking_enabled;     // Whether tracking is enabled
-    pthread_mutex_t lock;      // Lock for thread-safe stats updates
-} memory_stats = {0, 0, 0, true, PTHREAD_MUTEX_INITIALIZER};
+    _Atomic bool tracking_enabled;     // Whether tracking is enabled
+    _Atomic(ThreadStats*) threads;     // All counter blocks, shared_stats last
+    pthread_mutex_t lock;              // Guards registration, names and baselines
+    char allocator_names[GOO_STATS_MAX_ALLOCATORS][32];
+    _Atomic int allocator_count;
+    _Atomic int64_t peak_allocated;    // Merged peak, relative to the baseline
+    _Atomic int64_t baseline_bytes;    // Live bytes at the last reset
+    int64_t baseline_count;            // Live allocations at the last reset
+    _Atomic uint32_t epoch;            // Bumped by every reset
+} memory_stats = {
+    .tracking_enabled = true,
+    .threads = &shared_stats,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .allocator_names = { "default" },
+    .allocator_count = 1,
+};
 
-// Initialize memory statistics tracking
-bool goo_memory_stats_init(void) {
-    memset(&memory_stats, 0, sizeof(memory_stats));
-    memory_stats.tracking_enabled = true;
-    
-    // Initialize mutex with default attributes
-    pthread_mutexattr_t attr;
-    if (pthread_mutexattr_init(&attr) != 0) {
-        return false;
+static __thread ThreadStats* thread_stats = NULL;
+static __thread bool thread_stats_released = false;
+static pthread_key_t thread_stats_key;
+static pthread_once_t thread_stats_once = PTHREAD_ONCE_INIT;
+
+static inline void counter_add(ThreadStats* block, _Atomic uint64_t* counter, uint64_t value) {
+    if (block == &shared_stats) {
+        atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+        return;
     }
-    
-    if (pthread_mutex_init(&memory_stats.lock, &attr) != 0) {
-        pthread_mutexattr_destroy(&attr);
-        return false;
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static inline int64_t signed_add(ThreadStats* block, _Atomic int64_t* counter, int64_t value) {
+    if (block == &shared_stats) {
+        return atomic_fetch_add_explicit(counter, value, memory_order_relaxed) + value;
+    }
+    int64_t result = atomic_load_explicit(counter, memory_order_relaxed) + value;
+    atomic_store_explicit(counter, result, memory_order_relaxed);
+    return result;
+}
+
+// Size class: <= 8 bytes, then one class per power of two
+static inline int size_class_of(size_t size) {
+    if (size <= 8) return 0;
+    int log2 = 64 - __builtin_clzll((unsigned long long)(size - 1));
+    int size_class = log2 - 3;
+    return size_class < GOO_STATS_SIZE_CLASSES ? size_class : GOO_STATS_SIZE_CLASSES - 1;
+}
+
+// Thread exit: leave the counters in place for the next thread to reuse.
+// Frees tracked by later destructors go to the shared counters, since the
+// block may already belong to another thread
+static void release_thread_stats(void* block) {
+    thread_stats = NULL;
+    thread_stats_released = true;
+    atomic_store_explicit(&((ThreadStats*)block)->in_use, false, memory_order_release);
+}
+
+static void create_thread_stats_key(void) {
+    pthread_key_create(&thread_stats_key, release_thread_stats);
+}
+
+// Get the calling thread's counter block, or the shared one once the thread
+// is exiting or when no block can be allocated
+static ThreadStats* get_thread_stats(void) {
+    if (thread_stats) return thread_stats;
+    if (thread_stats_released) return &shared_stats;
+
+    pthread_once(&thread_stats_once, create_thread_stats_key);
+    pthread_mutex_lock(&memory_stats.lock);
+
+    // Reuse a block left by an exited thread; its counts stay in the totals
+    ThreadStats* block = atomic_load_explicit(&memory_stats.threads, memory_order_acquire);
+    while (block && atomic_load_explicit(&block->in_use, memory_order_acquire)) {
+        block = block->next;
+    }
+
+    if (!block) {
+        block = aligned_alloc(64, (sizeof(ThreadStats) + 63) & ~(size_t)63);
+        if (!block) {
+            pthread_mutex_unlock(&memory_stats.lock);
+            return &shared_stats;
+        }
+        memset(block, 0, sizeof(ThreadStats));
+        block->next = atomic_load_explicit(&memory_stats.threads, memory_order_relaxed);
+        atomic_store_explicit(&memory_stats.threads, block, memory_order_release);
+    }
+    atomic_store_explicit(&block->in_use, true, memory_order_relaxed);
+    atomic_store_explicit(&block->high_water,
+                          atomic_load_explicit(&block->net_bytes, memory_order_relaxed),
+                          memory_order_relaxed);
+
+    pthread_mutex_unlock(&memory_stats.lock);
+
+    pthread_setspecific(thread_stats_key, block);
+    thread_stats = block;
+    return block;
+}
+
+// Sum live bytes and allocations across all threads
+static void sum_live(int64_t* bytes, int64_t* count) {
+    uint64_t allocated = 0, freed = 0, allocations = 0, frees = 0;
+
+    for (ThreadStats* block = atomic_load_explicit(&memory_stats.threads, memory_order_acquire);
+         block; block = block->next) {
+        for (int i = 0; i < GOO_STATS_MAX_ALLOCATORS; i++) {
+            StatsCounters* counters = &block->allocators[i];
+            allocated += atomic_load_explicit(&counters->bytes_allocated, memory_order_relaxed);
+            freed += atomic_load_explicit(&counters->bytes_freed, memory_order_relaxed);
+            allocations += atomic_load_explicit(&counters->allocations, memory_order_relaxed);
+            frees += atomic_load_explicit(&counters->frees, memory_order_relaxed);
+        }
+    }
+
+    if (bytes) *bytes = (int64_t)(allocated - freed);
+    if (count) *count = (int64_t)(allocations - frees);
+}
+
+// Fold the current total into the merged peak
+static int64_t merge_peak(void) {
+    int64_t live;
+    sum_live(&live, NULL);
+    live -= atomic_load_explicit(&memory_stats.baseline_bytes, memory_order_relaxed);
+
+    int64_t peak = atomic_load_explicit(&memory_stats.peak_allocated, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&memory_stats.peak_allocated, &peak, live,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
     }
-    
-    pthread_mutexattr_destroy(&attr);
+    return live > 0 ? live : 0;
+}
+
+// Make the current totals the new zero. Counters are owned by their threads,
+// so they are never cleared in place.
+static void reset_baseline(void) {
+    pthread_mutex_lock(&memory_stats.lock);
+
+    int64_t bytes, count;
+    sum_live(&bytes, &count);
+    atomic_store_explicit(&memory_stats.baseline_bytes, bytes, memory_order_relaxed);
+    memory_stats.baseline_count = count;
+    atomic_store_explicit(&memory_stats.peak_allocated, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&memory_stats.epoch, 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&memory_stats.lock);
+}
+
+// Initialize memory statistics tracking
+bool goo_memory_stats_init(void) {
+    atomic_store(&memory_stats.tracking_enabled, true);
+    reset_baseline();
     return true;
 }
 
 // Clean up memory statistics tracking
 void goo_memory_stats_cleanup(void) {
-    pthread_mutex_destroy(&memory_stats.lock);
+    // Counter blocks may still be in use by other threads and are kept
 }
 
-// Track memory allocation
-void goo_memory_stats_track_alloc(size_t size) {
-    if (!memory_stats.tracking_enabled) {
-        return;
-    }
-    
+// Register a named allocator for per-allocator breakdowns
+int goo_memory_stats_register_allocator(const char* name) {
     pthread_mutex_lock(&memory_stats.lock);
-    
-    memory_stats.total_allocated += size;
-    memory_stats.allocation_count++;
-    
-    if (memory_stats.total_allocated > memory_stats.peak_allocated) {
-        memory_stats.peak_allocated = memory_stats.total_allocated;
-    }
-    
+
+    int count = atomic_load_explicit(&memory_stats.allocator_count, memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (name && strcmp(memory_stats.allocator_names[i], name) == 0) {
+            pthread_mutex_unlock(&memory_stats.lock);
+            return i;
+        }
+    }
+
+    if (count >= GOO_STATS_MAX_ALLOCATORS) {
+        pthread_mutex_unlock(&memory_stats.lock);
+        fprintf(stderr, "Error: Too many allocators registered for statistics (max %d)\n",
+                GOO_STATS_MAX_ALLOCATORS);
+        return -1;
+    }
+
+    snprintf(memory_stats.allocator_names[count], sizeof(memory_stats.allocator_names[count]),
+             "%s", name ? name : "unnamed");
+    atomic_store_explicit(&memory_stats.allocator_count, count + 1, memory_order_release);
+
     pthread_mutex_unlock(&memory_stats.lock);
+    return count;
+}
+
+// Track an allocation made by a registered allocator
+void goo_memory_stats_track_alloc_for(int allocator_id, size_t size) {
+    if (!atomic_load_explicit(&memory_stats.tracking_enabled, memory_order_relaxed)) {
+        return;
+    }
+    if (allocator_id < 0 || allocator_id >= GOO_STATS_MAX_ALLOCATORS) allocator_id = 0;
+
+    ThreadStats* block = get_thread_stats();
+
+    StatsCounters* counters = &block->allocators[allocator_id];
+    counter_add(block, &counters->bytes_allocated, size);
+    counter_add(block, &counters->allocations, 1);
+    counter_add(block, &block->class_allocations[size_class_of(size)], 1);
+
+    // A new thread high-water mark may be a new global peak; merge periodically.
+    // After a reset, marks restart from the thread's current level.
+    int64_t net = signed_add(block, &block->net_bytes, (int64_t)size);
+    if (block == &shared_stats) return;
+    uint32_t epoch = atomic_load_explicit(&memory_stats.epoch, memory_order_relaxed);
+    if (block->epoch != epoch) {
+        block->epoch = epoch;
+        atomic_store_explicit(&block->high_water, net - (int64_t)size, memory_order_relaxed);
+    }
+    if (net > atomic_load_explicit(&block->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&block->high_water, net, memory_order_relaxed);
+        if (++block->since_merge >= STATS_MERGE_INTERVAL) {
+            block->since_merge = 0;
+            merge_peak();
+        }
+    }
+}
+
+// Track a deallocation made by a registered allocator
+void goo_memory_stats_track_free_for(int allocator_id, size_t size) {
+    if (!atomic_load_explicit(&memory_stats.tracking_enabled, memory_order_relaxed)) {
+        return;
+    }
+    if (allocator_id < 0 || allocator_id >= GOO_STATS_MAX_ALLOCATORS) allocator_id = 0;
+
+    ThreadStats* block = get_thread_stats();
+
+    StatsCounters* counters = &block->allocators[allocator_id];
+    counter_add(block, &counters->bytes_freed, size);
+    counter_add(block, &counters->frees, 1);
+    counter_add(block, &block->class_frees[size_class_of(size)], 1);
+    signed_add(block, &block->net_bytes, -(int64_t)size);
+}
+
+// Track memory allocation
+void goo_memory_stats_track_alloc(size_t size) {
+    goo_memory_stats_track_alloc_for(0, size);
 }
 
 // Track memory deallocation
 void goo_memory_stats_track_free(size_t size) {
-    if (!memory_stats.tracking_enabled) {
+    goo_memory_stats_track_free_for(0, size);
+}
+
+// Track memory reallocation
+void goo_memory_stats_track_realloc(size_t old_size, size_t new_size) {
+    if (!atomic_load_explicit(&memory_stats.tracking_enabled, memory_order_relaxed)) {
         return;
     }
-    
-    pthread_mutex_lock(&memory_stats.lock);
-    
-    if (memory_stats.total_allocated >= size) {
-        memory_stats.total_allocated -= size;
+
+    if (old_size == new_size) {
+        return; // No change in allocation size
+    }
+
+    ThreadStats* block = get_thread_stats();
+
+    StatsCounters* counters = &block->allocators[0];
+    if (new_size > old_size) {
+        // Growing allocation
+        size_t growth = new_size - old_size;
+        counter_add(block, &counters->bytes_allocated, growth);
+        int64_t net = signed_add(block, &block->net_bytes, (int64_t)growth);
+        if (block != &shared_stats && net > atomic_load_explicit(&block->high_water, memory_order_relaxed)) {
+            atomic_store_explicit(&block->high_water, net, memory_order_relaxed);
+        }
     } else {
-        // Should never happen in correct code, but guard against underflow
-        memory_stats.total_allocated = 0;
+        // Shrinking allocation
+        size_t reduction = old_size - new_size;
+        counter_add(block, &counters->bytes_freed, reduction);
+        signed_add(block, &block->net_bytes, -(int64_t)reduction);
     }
-    
-    if (memory_stats.allocation_count > 0) {
-        memory_stats.allocation_count--;
+}
+
+// Aggregate all per-thread counters
+bool goo_memory_stats_snapshot(GooMemoryStatsSnapshot* snapshot) {
+    if (!snapshot) return false;
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    int64_t live = merge_peak();
+    int64_t count;
+    sum_live(NULL, &count);
+
+    pthread_mutex_lock(&memory_stats.lock);
+    count -= memory_stats.baseline_count;
+    snapshot->allocator_count = atomic_load_explicit(&memory_stats.allocator_count, memory_order_relaxed);
+    for (int i = 0; i < snapshot->allocator_count; i++) {
+        memcpy(snapshot->allocators[i].name, memory_stats.allocator_names[i],
+               sizeof(snapshot->allocators[i].name));
     }
-    
     pthread_mutex_unlock(&memory_stats.lock);
+
+    for (int c = 0; c < GOO_STATS_SIZE_CLASSES; c++) {
+        snapshot->size_classes[c].max_size = c == GOO_STATS_SIZE_CLASSES - 1 ? SIZE_MAX : (size_t)8 << c;
+    }
+
+    for (ThreadStats* block = atomic_load_explicit(&memory_stats.threads, memory_order_acquire);
+         block; block = block->next) {
+        if (block != &shared_stats && atomic_load_explicit(&block->in_use, memory_order_relaxed)) {
+            snapshot->thread_count++;
+        }
+
+        for (int i = 0; i < snapshot->allocator_count; i++) {
+            StatsCounters* counters = &block->allocators[i];
+            GooAllocatorStatsEntry* entry = &snapshot->allocators[i];
+            entry->bytes_allocated += atomic_load_explicit(&counters->bytes_allocated, memory_order_relaxed);
+            entry->bytes_freed += atomic_load_explicit(&counters->bytes_freed, memory_order_relaxed);
+            entry->allocations += atomic_load_explicit(&counters->allocations, memory_order_relaxed);
+            entry->frees += atomic_load_explicit(&counters->frees, memory_order_relaxed);
+        }
+        for (int c = 0; c < GOO_STATS_SIZE_CLASSES; c++) {
+            snapshot->size_classes[c].allocations +=
+                atomic_load_explicit(&block->class_allocations[c], memory_order_relaxed);
+            snapshot->size_classes[c].frees +=
+                atomic_load_explicit(&block->class_frees[c], memory_order_relaxed);
+        }
+    }
+
+    for (int i = 0; i < snapshot->allocator_count; i++) {
+        snapshot->total_allocations += snapshot->allocators[i].allocations;
+        snapshot->total_frees += snapshot->allocators[i].frees;
+    }
+
+    int64_t peak = atomic_load_explicit(&memory_stats.peak_allocated, memory_order_relaxed);
+    snapshot->total_allocated = (size_t)live;
+    snapshot->peak_allocated = (size_t)(peak > live ? peak : live);
+    snapshot->allocation_count = count > 0 ? (size_t)count : 0;
+    return true;
+}
+
+// Print statistics with per-allocator and per-size-class breakdowns
+void goo_memory_stats_print(void) {
+    GooMemoryStatsSnapshot snapshot;
+    goo_memory_stats_snapshot(&snapshot);
+
+    printf("Memory statistics (%d threads)\n", snapshot.thread_count);
+    printf("  live: %zu bytes in %zu allocations, peak %zu bytes\n",
+           snapshot.total_allocated, snapshot.allocation_count, snapshot.peak_allocated);
+
+    printf("  %-16s %14s %14s %12s %12s\n", "allocator", "bytes alloc", "bytes freed",
+           "allocs", "frees");
+    for (int i = 0; i < snapshot.allocator_count; i++) {
+        GooAllocatorStatsEntry* entry = &snapshot.allocators[i];
+        if (entry->allocations == 0 && entry->bytes_allocated == 0) continue;
+        printf("  %-16s %14llu %14llu %12llu %12llu\n", entry->name,
+               (unsigned long long)entry->bytes_allocated, (unsigned long long)entry->bytes_freed,
+               (unsigned long long)entry->allocations, (unsigned long long)entry->frees);
+    }
+
+    printf("  %-16s %12s %12s %12s\n", "size class", "allocs", "frees", "live");
+    for (int c = 0; c < GOO_STATS_SIZE_CLASSES; c++) {
+        GooSizeClassStats* size_class = &snapshot.size_classes[c];
+        if (size_class->allocations == 0) continue;
+
+        char label[24];
+        if (size_class->max_size == SIZE_MAX) {
+            snprintf(label, sizeof(label), "> %zu", (size_t)8 << (GOO_STATS_SIZE_CLASSES - 2));
+        } else {
+            snprintf(label, sizeof(label), "<= %zu", size_class->max_size);
+        }
+        printf("  %-16s %12llu %12llu %12lld\n", label,
+               (unsigned long long)size_class->allocations, (unsigned long long)size_class->frees,
+               (long long)(size_class->allocations - size_class->frees));
+    }
 }
 
 // Get current memory statistics
 bool goo_memory_get_stats(size_t* total_allocated, size_t* peak_allocated, size_t* allocation_count) {
-    if (!memory_stats.tracking_enabled) {
+    if (!atomic_load_explicit(&memory_stats.tracking_enabled, memory_order_relaxed)) {
         return false;
     }
-    
+
+    int64_t live = merge_peak();
+    int64_t count;
+    sum_live(NULL, &count);
+
     pthread_mutex_lock(&memory_stats.lock);
-    
+    count -= memory_stats.baseline_count;
+    pthread_mutex_unlock(&memory_stats.lock);
+
+    int64_t peak = atomic_load_explicit(&memory_stats.peak_allocated, memory_order_relaxed);
+
     if (total_allocated) {
-        *total_allocated = memory_stats.total_allocated;
+        *total_allocated = (size_t)live;
     }
-    
+
     if (peak_allocated) {
-        *peak_allocated = memory_stats.peak_allocated;
+        *peak_allocated = (size_t)(peak > live ? peak : live);
     }
-    
+
     if (allocation_count) {
-        *allocation_count = memory_stats.allocation_count;
+        *allocation_count = count > 0 ? (size_t)count : 0;
     }
-    
-    pthread_mutex_unlock(&memory_stats.lock);
+
     return true;
 }
 
 // Reset memory statistics
 bool goo_memory_reset_stats(void) {
-    if (!memory_stats.tracking_enabled) {
+    if (!atomic_load_explicit(&memory_stats.tracking_enabled, memory_order_relaxed)) {
         return false;
     }
-    
-    pthread_mutex_lock(&memory_stats.lock);
-    
-    memory_stats.total_allocated = 0;
-    memory_stats.peak_allocated = 0;
-    memory_stats.allocation_count = 0;
-    
-    pthread_mutex_unlock(&memory_stats.lock);
+
+    reset_baseline();
     return true;
 }
 
 // Enable or disable memory tracking
 bool goo_memory_set_tracking(bool enable) {
-    pthread_mutex_lock(&memory_stats.lock);
-    bool previous = memory_stats.tracking_enabled;
-    memory_stats.tracking_enabled = enable;
-    pthread_mutex_unlock(&memory_stats.lock);
-    
-    return previous;
+    return atomic_exchange(&memory_stats.tracking_enabled, enable);
 }
-
-// Track memory reallocation
-void goo_memory_stats_track_realloc(size_t old_size, size_t new_size) {
-    if (!memory_stats.tracking_enabled) {
-        return;
-    }
-    
-    if (old_size == new_size) {
-        return; // No change in allocation size
-    }
-    
-    pthread_mutex_lock(&memory_stats.lock);
-    
-    if (new_size > old_size) {
-        // Growing allocation
-        size_t growth = new_size - old_size;
-        memory_stats.total_allocated += growth;
-        
-        if (memory_stats.total_allocated > memory_stats.peak_allocated) {
-            memory_stats.peak_allocated = memory_stats.total_allocated;
-        }
-    } else {
-        // Shrinking allocation
-        size_t reduction = old_size - new_size;
-        
-        if (memory_stats.total_allocated >= reduction) {
-            memory_stats.total_allocated -= reduction;
-        } else {
-            // Should never happen in correct code, but guard against underflow
-            memory_stats.total_allocated = 0;
-        }
-    }
-    
-    pthread_mutex_unlock(&memory_stats.lock);
-} 
\ No newline at end of file
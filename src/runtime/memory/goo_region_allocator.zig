@@ -8,6 +8,9 @@ const allocator_core = @import("goo_allocator_core.zig");
 const Allocator = allocator_core.Allocator;
 const AllocOptions = allocator_core.AllocOptions;
 const DEFAULT_ALIGNMENT = allocator_core.DEFAULT_ALIGNMENT;
+const virtual_memory = @import("goo_virtual_memory.zig");
+const VirtualRange = virtual_memory.VirtualRange;
+const PageMode = virtual_memory.PageMode;
 
 // Constants
 const DEFAULT_REGION_SIZE = 1024 * 1024; // 1 MB
@@ -88,6 +91,11 @@ pub const RegionAllocator = struct {
     region_size: usize,
     allow_large_allocations: bool,
 
+    // Mapped mode: one reserved range instead of malloc'd regions
+    vm: ?VirtualRange,
+    vm_used: usize, // Bytes bumped from the start of the range
+    vm_retained: usize, // Bytes kept resident across resets
+
     // Initialize a region allocator
     pub fn init(region_size: usize, allow_large_allocations: bool) ?*RegionAllocator {
         // Validate parameters
@@ -113,6 +121,9 @@ pub const RegionAllocator = struct {
             .current_region = null,
             .region_size = actual_region_size,
             .allow_large_allocations = allow_large_allocations,
+            .vm = null,
+            .vm_used = 0,
+            .vm_retained = 0,
         };
 
         // Allocate initial region
@@ -124,6 +135,37 @@ pub const RegionAllocator = struct {
         return self;
     }
 
+    // Initialize a region allocator backed by a reserved virtual range of reserve_size bytes
+    pub fn initMapped(reserve_size: usize, mode: PageMode) ?*RegionAllocator {
+        const self = @as(*RegionAllocator, @ptrCast(@alignCast(c.malloc(@sizeOf(RegionAllocator)) orelse return null)));
+
+        const range = VirtualRange.reserve(reserve_size, mode) orelse {
+            c.free(self);
+            return null;
+        };
+
+        self.* = .{
+            .allocator = .{
+                .vtable = &regionVTable,
+                .strategy = .null,
+                .out_of_mem_fn = null,
+                .context = self,
+                .track_stats = true,
+                .stats = .{},
+            },
+            .regions = null,
+            .current_region = null,
+            .region_size = range.reserved,
+            .allow_large_allocations = true,
+            .vm = range,
+            .vm_used = 0,
+            .vm_retained = range.granule,
+        };
+
+        self.allocator.stats.bytes_reserved = range.reserved;
+        return self;
+    }
+
     // Add a new region
     fn addRegion(self: *RegionAllocator, min_size: usize) bool {
         // Determine region size (at least min_size, but normally the default size)
@@ -168,50 +210,61 @@ pub const RegionAllocator = struct {
         const header_aligned_size = std.mem.alignForward(usize, header_size, actual_alignment);
         const total_size = header_aligned_size + size;
 
-        // Check for large allocations
-        if (total_size > self.region_size) {
-            // For very large allocations, we can either fail or create a custom-sized region
-            if (!self.allow_large_allocations) {
+        var ptr: ?*anyopaque = null;
+        if (self.vm) |*vm| {
+            // Mapped regions bump through their range and never add regions
+            ptr = vm.bump(&self.vm_used, total_size, actual_alignment);
+            if (ptr == null) {
                 if (allocator.track_stats) {
                     allocator.stats.failed_allocations += 1;
                 }
                 return null;
             }
-
-            // Create a custom-sized region
-            if (!self.addRegion(total_size)) {
-                if (allocator.track_stats) {
-                    allocator.stats.failed_allocations += 1;
+        } else {
+            // Check for large allocations
+            if (total_size > self.region_size) {
+                // For very large allocations, we can either fail or create a custom-sized region
+                if (!self.allow_large_allocations) {
+                    if (allocator.track_stats) {
+                        allocator.stats.failed_allocations += 1;
+                    }
+                    return null;
                 }
-                return null;
-            }
 
-            // The new region is now the current one
-        }
+                // Create a custom-sized region
+                if (!self.addRegion(total_size)) {
+                    if (allocator.track_stats) {
+                        allocator.stats.failed_allocations += 1;
+                    }
+                    return null;
+                }
 
-        // Try to allocate from current region
-        var ptr: ?*anyopaque = null;
-        if (self.current_region) |current| {
-            ptr = current.alloc(total_size, actual_alignment);
-        }
+                // The new region is now the current one
+            }
 
-        // If current region is full, allocate a new one
-        if (ptr == null) {
-            if (!self.addRegion(total_size)) {
-                if (allocator.track_stats) {
-                    allocator.stats.failed_allocations += 1;
-                }
-                return null;
+            // Try to allocate from current region
+            if (self.current_region) |current| {
+                ptr = current.alloc(total_size, actual_alignment);
             }
 
-            // Try again with the new region
-            ptr = self.current_region.?.alloc(total_size, actual_alignment);
+            // If current region is full, allocate a new one
             if (ptr == null) {
-                // This should never happen since we just created a region of sufficient size
-                if (allocator.track_stats) {
-                    allocator.stats.failed_allocations += 1;
+                if (!self.addRegion(total_size)) {
+                    if (allocator.track_stats) {
+                        allocator.stats.failed_allocations += 1;
+                    }
+                    return null;
+                }
+
+                // Try again with the new region
+                ptr = self.current_region.?.alloc(total_size, actual_alignment);
+                if (ptr == null) {
+                    // This should never happen since we just created a region of sufficient size
+                    if (allocator.track_stats) {
+                        allocator.stats.failed_allocations += 1;
+                    }
+                    return null;
                 }
-                return null;
             }
         }
 
@@ -287,8 +340,26 @@ pub const RegionAllocator = struct {
         }
     }
 
+    // Whether addr lies in memory this allocator hands out
+    pub fn owns(self: *const RegionAllocator, addr: usize) bool {
+        if (self.vm) |*vm| return vm.contains(addr);
+
+        var region = self.regions;
+        while (region) |r| : (region = r.next) {
+            const start = @intFromPtr(r.data);
+            if (addr >= start and addr - start < r.size) return true;
+        }
+        return false;
+    }
+
     // Reset all regions for reuse
     pub fn reset(self: *RegionAllocator) void {
+        // Mapped regions hand their pages back to the OS past the retained prefix
+        if (self.vm) |*vm| {
+            vm.discard(self.vm_retained, self.vm_used);
+            self.vm_used = 0;
+        }
+
         var region = self.regions;
         while (region) |r| {
             r.reset();
@@ -309,6 +380,10 @@ pub const RegionAllocator = struct {
     fn destroy(allocator: *Allocator) void {
         const self = @as(*RegionAllocator, @ptrCast(@alignCast(allocator.context.?)));
 
+        if (self.vm) |*vm| {
+            vm.release();
+        }
+
         // Free all regions
         var region = self.regions;
         while (region != null) {
@@ -339,6 +414,16 @@ export fn goo_region_allocator_create(region_size: usize, allow_large_allocation
     return null;
 }
 
+export fn goo_region_allocator_create_mapped(reserve_size: usize, page_mode: c_int) ?*Allocator {
+    const mode = std.meta.intToEnum(PageMode, page_mode) catch PageMode.normal;
+
+    if (RegionAllocator.initMapped(reserve_size, mode)) |region| {
+        return &region.allocator;
+    }
+
+    return null;
+}
+
 export fn goo_region_allocator_reset(allocator: ?*Allocator) void {
     if (allocator == null) return;
 
@@ -351,3 +436,69 @@ export fn goo_region_allocator_destroy(allocator: ?*Allocator) void {
 
     allocator.?.destroy();
 }
+
+export fn goo_region_allocator_contains(allocator: ?*Allocator, ptr: ?*const anyopaque) bool {
+    if (allocator == null or ptr == null) return false;
+
+    const self = @as(*RegionAllocator, @ptrCast(@alignCast(allocator.?.context.?)));
+    return self.owns(@intFromPtr(ptr));
+}
+
+test "mapped regions own their whole reservation and nothing else" {
+    const allocator = goo_region_allocator_create_mapped(4 * 1024 * 1024, @intFromEnum(PageMode.normal)).?;
+    defer goo_region_allocator_destroy(allocator);
+
+    const ptr = allocator.alloc(256, DEFAULT_ALIGNMENT, .{}).?;
+    try std.testing.expect(goo_region_allocator_contains(allocator, ptr));
+
+    // Addresses past what has been bumped still belong to the region
+    const self = @as(*RegionAllocator, @ptrCast(@alignCast(allocator.context.?)));
+    const range = self.vm.?;
+    try std.testing.expect(goo_region_allocator_contains(allocator, @ptrFromInt(range.base + range.reserved - 1)));
+    try std.testing.expect(!goo_region_allocator_contains(allocator, @ptrFromInt(range.base + range.reserved)));
+
+    const foreign = c.malloc(64).?;
+    defer c.free(foreign);
+    try std.testing.expect(!goo_region_allocator_contains(allocator, foreign));
+
+    // Reset keeps the range, so earlier pointers still test as owned
+    goo_region_allocator_reset(allocator);
+    try std.testing.expect(goo_region_allocator_contains(allocator, ptr));
+}
+
+test "malloc-backed regions own only their region blocks" {
+    const allocator = goo_region_allocator_create(MIN_REGION_SIZE, true).?;
+    defer goo_region_allocator_destroy(allocator);
+
+    const ptr = allocator.alloc(128, DEFAULT_ALIGNMENT, .{}).?;
+    try std.testing.expect(goo_region_allocator_contains(allocator, ptr));
+
+    const foreign = c.malloc(128).?;
+    defer c.free(foreign);
+    try std.testing.expect(!goo_region_allocator_contains(allocator, foreign));
+}
+
+test "mapped region reset discards pages past the retained granule" {
+    const allocator = goo_region_allocator_create_mapped(4 * 1024 * 1024, @intFromEnum(PageMode.normal)).?;
+    defer goo_region_allocator_destroy(allocator);
+
+    const self = @as(*RegionAllocator, @ptrCast(@alignCast(allocator.context.?)));
+    const size = 512 * 1024;
+    const first: [*]u8 = @ptrCast(allocator.alloc(size, DEFAULT_ALIGNMENT, .{}).?);
+    @memset(first[0..size], 0xAA);
+    try std.testing.expect(self.vm_used > self.vm_retained);
+
+    // Reset rewinds to the start of the range; the same request lands in the
+    // same place and everything past the retained granule reads as zero
+    goo_region_allocator_reset(allocator);
+    try std.testing.expectEqual(0, self.vm_used);
+    const second: [*]u8 = @ptrCast(allocator.alloc(size, DEFAULT_ALIGNMENT, .{}).?);
+    try std.testing.expectEqual(first, second);
+
+    const retained_end = self.vm.?.base + self.vm_retained;
+    for (0..size) |i| {
+        if (@intFromPtr(second + i) >= retained_end) {
+            try std.testing.expectEqual(0, second[i]);
+        }
+    }
+}
@@ -0,0 +1,804 @@
+const std = @import("std");
+const c = @cImport({
+    @cDefine("_GNU_SOURCE", "1");
+    @cInclude("stdlib.h");
+    @cInclude("string.h");
+    @cInclude("sys/mman.h");
+    @cInclude("pthread.h");
+});
+
+const allocator_core = @import("goo_allocator_core.zig");
+const Allocator = allocator_core.Allocator;
+const AllocOptions = allocator_core.AllocOptions;
+const DEFAULT_ALIGNMENT = allocator_core.DEFAULT_ALIGNMENT;
+
+// Size-class slab allocator, an opt-in general-purpose allocator (install it
+// with goo_set_default_allocator(goo_slab_allocator_get())).
+//
+// Requests up to 32 KB are rounded to one of 40 size classes and served from
+// a per-thread cache of free objects, with no locks and no atomics. Caches
+// refill from and flush to per-class slabs in batches under a per-class
+// mutex. Slabs are mmap'd spans aligned to their size; when a slab becomes
+// entirely free beyond a small reserve its pages go back to the OS with
+// madvise. Larger requests are mapped directly and recycled through a small
+// cache of released spans.
+//
+// A page map from 64 KiB address units to slabs and spans lets free find an
+// allocation's owner from the pointer alone, so callers that pass a wrong or
+// zero size (goo_scope_cleanup, for one) stay safe.
+
+// Constants for the slab allocator
+pub const MAX_SMALL_SIZE = 32 * 1024; // Largest size served from slabs
+const CLASS_COUNT = 40; // 8 classes of 16 bytes, then 4 per power of two
+const MIN_SLAB_SIZE = 64 * 1024; // Smallest slab
+const MIN_OBJECTS_PER_SLAB = 8; // Large classes get bigger slabs
+const MAX_OBJECT_ALIGNMENT = 4096; // Larger alignments go to the span path
+const THREAD_CACHE_BYTES = 64 * 1024; // Per-thread, per-class cache budget
+const EMPTY_SLABS_KEPT = 1; // Fully free slabs kept committed per class
+const SPAN_CACHE_ENTRIES = 64; // Released large spans kept for reuse
+const SPAN_CACHE_COMMITTED = 32 * 1024 * 1024; // Cached bytes kept resident
+const SPAN_ALIGNMENT = 1 << PAGE_MAP_SHIFT; // One span start per map unit
+
+// Page map geometry: 16 + 16 bits of 64 KiB units cover a 48-bit address space
+const PAGE_MAP_SHIFT = 16;
+const PAGE_MAP_LEAF_BITS = 16;
+const PAGE_MAP_ROOT_BITS = 16;
+const LARGE_SPAN_TAG: usize = 1; // Low bit set: entry holds a span length
+
+// Object sizes for each class
+const class_sizes: [CLASS_COUNT]u32 = blk: {
+    var sizes: [CLASS_COUNT]u32 = undefined;
+    var i: usize = 0;
+    while (i < 8) : (i += 1) {
+        sizes[i] = @intCast((i + 1) * 16);
+    }
+    var base: u32 = 128;
+    while (base < MAX_SMALL_SIZE) : (base *= 2) {
+        var step: u32 = 1;
+        while (step <= 4) : (step += 1) {
+            sizes[i] = base + step * (base / 4);
+            i += 1;
+        }
+    }
+    break :blk sizes;
+};
+
+// Map a size to its class (size <= MAX_SMALL_SIZE)
+inline fn sizeClass(size: usize) usize {
+    if (size <= 128) {
+        return (size -| 1) / 16;
+    }
+    const n = size - 1;
+    const log2: usize = std.math.log2_int(usize, n);
+    const base = @as(usize, 1) << @intCast(log2);
+    return 8 + (log2 - 7) * 4 + (n - base) / (base / 4);
+}
+
+// Alignment every object of a class is guaranteed to have
+inline fn classAlignment(index: usize) usize {
+    const size: usize = class_sizes[index];
+    return @min(size & (~size +% 1), MAX_OBJECT_ALIGNMENT);
+}
+
+// Slab span size for a class
+inline fn slabSize(index: usize) usize {
+    const wanted = @as(usize, class_sizes[index]) * MIN_OBJECTS_PER_SLAB;
+    return @max(MIN_SLAB_SIZE, std.math.ceilPowerOfTwoAssert(usize, wanted));
+}
+
+// Thread cache capacity for a class; half of it moves per refill or flush
+inline fn cacheLimit(index: usize) u32 {
+    return @intCast(std.math.clamp(THREAD_CACHE_BYTES / @as(usize, class_sizes[index]), 2, 256));
+}
+
+// Find the class serving a request, or null if it needs a span
+fn classFor(size: usize, alignment: usize) ?usize {
+    if (size > MAX_SMALL_SIZE or alignment > MAX_OBJECT_ALIGNMENT) return null;
+
+    var index = sizeClass(size);
+    while (classAlignment(index) < alignment) {
+        index += 1;
+        if (index == CLASS_COUNT) return null;
+    }
+    return index;
+}
+
+// A free object, linked through its first word
+const FreeObject = struct {
+    next: ?*FreeObject,
+};
+
+// Header at the start of every slab
+const Slab = struct {
+    next: ?*Slab, // Partial or released list link
+    prev: ?*Slab, // Partial list back link
+    free_list: ?*FreeObject, // Objects returned to this slab
+    carve: usize, // Address of the next never-used object
+    data: usize, // Address of the first object
+    free_count: u32, // Free objects, listed or not yet carved
+    capacity: u32, // Objects in the slab
+    class_index: u8, // Size class served
+    in_partial: bool, // Linked into the class's partial list
+
+    fn reset(self: *Slab) void {
+        self.free_list = null;
+        self.carve = self.data;
+        self.free_count = self.capacity;
+    }
+};
+
+// Shared state of one size class
+const SizeClass = struct {
+    mutex: std.Thread.Mutex align(64) = .{},
+    partial: ?*Slab = null, // Slabs with free objects
+    released: ?*Slab = null, // Empty slabs whose pages were returned to the OS
+    empty_count: usize = 0, // Fully free slabs still in the partial list
+};
+
+// Per-thread free objects of one class
+const ClassCache = struct {
+    head: ?*FreeObject = null,
+    count: u32 = 0,
+};
+
+const ThreadCache = struct {
+    classes: [CLASS_COUNT]ClassCache = [_]ClassCache{.{}} ** CLASS_COUNT,
+    registered: bool = false,
+    exiting: bool = false, // Exit flush done; nothing may stay cached
+};
+
+// A large span parked for reuse
+const CachedSpan = struct {
+    addr: usize = 0,
+    len: usize = 0,
+    resident: bool = false,
+};
+
+const SpanCache = struct {
+    mutex: std.Thread.Mutex = .{},
+    spans: [SPAN_CACHE_ENTRIES]CachedSpan = [_]CachedSpan{.{}} ** SPAN_CACHE_ENTRIES,
+    resident_bytes: usize = 0,
+};
+
+const PageMapLeaf = [1 << PAGE_MAP_LEAF_BITS]std.atomic.Value(usize);
+
+// Slab allocator statistics
+pub const SlabStats = extern struct {
+    bytes_mapped: usize = 0, // Address space obtained with mmap
+    bytes_released: usize = 0, // Bytes returned to the OS with madvise
+    slabs: usize = 0, // Slabs created
+    released_slabs: usize = 0, // Slabs currently released
+    large_allocations: usize = 0, // Live span allocations
+    cached_spans: usize = 0, // Spans parked in the span cache
+};
+
+// Global state
+var size_classes: [CLASS_COUNT]SizeClass = [_]SizeClass{.{}} ** CLASS_COUNT;
+var span_cache: SpanCache = .{};
+var page_map_root = [_]std.atomic.Value(?*PageMapLeaf){std.atomic.Value(?*PageMapLeaf).init(null)} ** (1 << PAGE_MAP_ROOT_BITS);
+var page_map_mutex: std.Thread.Mutex = .{};
+threadlocal var thread_cache: ThreadCache = .{};
+
+var flush_key: c.pthread_key_t = undefined;
+var flush_key_once = std.once(createFlushKey);
+
+var stat_bytes_mapped = std.atomic.Value(usize).init(0);
+var stat_bytes_released = std.atomic.Value(usize).init(0);
+var stat_slabs = std.atomic.Value(usize).init(0);
+var stat_released_slabs = std.atomic.Value(usize).init(0);
+var stat_large = std.atomic.Value(usize).init(0);
+
+// ===== OS memory =====
+
+fn mapPages(len: usize) ?usize {
+    const result = c.mmap(null, len, c.PROT_READ | c.PROT_WRITE, c.MAP_PRIVATE | c.MAP_ANONYMOUS, -1, 0);
+    const addr = @intFromPtr(result);
+    if (addr == 0 or addr == std.math.maxInt(usize)) return null;
+    _ = stat_bytes_mapped.fetchAdd(len, .monotonic);
+    return addr;
+}
+
+fn unmapPages(addr: usize, len: usize) void {
+    _ = c.munmap(@ptrFromInt(addr), len);
+    _ = stat_bytes_mapped.fetchSub(len, .monotonic);
+}
+
+// Map len bytes aligned to alignment, trimming the excess
+fn mapAligned(len: usize, alignment: usize) ?usize {
+    if (alignment <= std.heap.pageSize()) return mapPages(len);
+
+    const raw = mapPages(len + alignment) orelse return null;
+    const addr = std.mem.alignForward(usize, raw, alignment);
+    if (addr > raw) unmapPages(raw, addr - raw);
+    const tail = raw + len + alignment - (addr + len);
+    if (tail > 0) unmapPages(addr + len, tail);
+    return addr;
+}
+
+// Give pages back to the OS but keep the address range
+fn releasePages(addr: usize, len: usize) void {
+    const page = std.heap.pageSize();
+    const start = std.mem.alignForward(usize, addr, page);
+    const end = std.mem.alignBackward(usize, addr + len, page);
+    if (end <= start) return;
+    _ = c.madvise(@ptrFromInt(start), end - start, c.MADV_DONTNEED);
+    _ = stat_bytes_released.fetchAdd(end - start, .monotonic);
+}
+
+// ===== Page map =====
+
+fn pageMapGet(addr: usize) usize {
+    const unit = addr >> PAGE_MAP_SHIFT;
+    if ((unit >> (PAGE_MAP_ROOT_BITS + PAGE_MAP_LEAF_BITS)) != 0) return 0;
+    const leaf = page_map_root[unit >> PAGE_MAP_LEAF_BITS].load(.acquire) orelse return 0;
+    return leaf[unit & ((1 << PAGE_MAP_LEAF_BITS) - 1)].load(.acquire);
+}
+
+fn pageMapSet(addr: usize, len: usize, value: usize) bool {
+    var unit = addr >> PAGE_MAP_SHIFT;
+    const end = (addr + len - 1) >> PAGE_MAP_SHIFT;
+    if ((end >> (PAGE_MAP_ROOT_BITS + PAGE_MAP_LEAF_BITS)) != 0) return false;
+
+    while (unit <= end) : (unit += 1) {
+        const root_index = unit >> PAGE_MAP_LEAF_BITS;
+        var leaf = page_map_root[root_index].load(.acquire);
+        if (leaf == null) {
+            page_map_mutex.lock();
+            defer page_map_mutex.unlock();
+            leaf = page_map_root[root_index].load(.acquire);
+            if (leaf == null) {
+                // Fresh anonymous pages read as zero, i.e. empty entries
+                const leaf_addr = mapPages(@sizeOf(PageMapLeaf)) orelse return false;
+                leaf = @ptrFromInt(leaf_addr);
+                page_map_root[root_index].store(leaf, .release);
+            }
+        }
+        leaf.?[unit & ((1 << PAGE_MAP_LEAF_BITS) - 1)].store(value, .release);
+    }
+    return true;
+}
+
+// ===== Slabs (class mutex held) =====
+
+fn pushPartial(class: *SizeClass, slab: *Slab) void {
+    slab.prev = null;
+    slab.next = class.partial;
+    if (class.partial) |head| head.prev = slab;
+    class.partial = slab;
+    slab.in_partial = true;
+}
+
+fn removePartial(class: *SizeClass, slab: *Slab) void {
+    if (slab.prev) |prev| prev.next = slab.next else class.partial = slab.next;
+    if (slab.next) |next| next.prev = slab.prev;
+    slab.next = null;
+    slab.prev = null;
+    slab.in_partial = false;
+}
+
+// Get an empty slab for a class: a released one, or a new mapping
+fn newSlab(index: usize, class: *SizeClass) ?*Slab {
+    if (class.released) |slab| {
+        class.released = slab.next;
+        _ = stat_released_slabs.fetchSub(1, .monotonic);
+        return slab;
+    }
+
+    const size = slabSize(index);
+    const addr = mapAligned(size, size) orelse return null;
+    const slab: *Slab = @ptrFromInt(addr);
+    const object_size: usize = class_sizes[index];
+    const data = std.mem.alignForward(usize, addr + @sizeOf(Slab), classAlignment(index));
+
+    slab.* = .{
+        .next = null,
+        .prev = null,
+        .free_list = null,
+        .carve = data,
+        .data = data,
+        .free_count = @intCast((addr + size - data) / object_size),
+        .capacity = @intCast((addr + size - data) / object_size),
+        .class_index = @intCast(index),
+        .in_partial = false,
+    };
+
+    if (!pageMapSet(addr, size, addr)) {
+        unmapPages(addr, size);
+        return null;
+    }
+    _ = stat_slabs.fetchAdd(1, .monotonic);
+    return slab;
+}
+
+// Return an entirely free slab's pages to the OS
+fn releaseSlab(index: usize, class: *SizeClass, slab: *Slab) void {
+    const addr = @intFromPtr(slab);
+    releasePages(addr + @sizeOf(Slab), slabSize(index) - @sizeOf(Slab));
+    slab.reset();
+    slab.next = class.released;
+    class.released = slab;
+    _ = stat_released_slabs.fetchAdd(1, .monotonic);
+}
+
+// Move up to half a cache's worth of objects from the class into a thread cache
+fn refill(index: usize, cache: *ClassCache) bool {
+    const class = &size_classes[index];
+    const object_size: usize = class_sizes[index];
+    const batch = cacheLimit(index) / 2;
+
+    class.mutex.lock();
+    defer class.mutex.unlock();
+
+    while (cache.count < batch) {
+        const slab = class.partial orelse blk: {
+            const fresh = newSlab(index, class) orelse break;
+            pushPartial(class, fresh);
+            class.empty_count += 1;
+            break :blk fresh;
+        };
+
+        if (slab.free_count == slab.capacity) class.empty_count -= 1;
+
+        while (cache.count < batch and slab.free_count > 0) {
+            var object: *FreeObject = undefined;
+            if (slab.free_list) |listed| {
+                slab.free_list = listed.next;
+                object = listed;
+            } else {
+                object = @ptrFromInt(slab.carve);
+                slab.carve += object_size;
+            }
+            slab.free_count -= 1;
+            object.next = cache.head;
+            cache.head = object;
+            cache.count += 1;
+        }
+
+        if (slab.free_count == 0) removePartial(class, slab);
+    }
+
+    return cache.count > 0;
+}
+
+// Return objects from a thread cache to their slabs until keep remain
+fn flush(index: usize, cache: *ClassCache, keep: u32) void {
+    const class = &size_classes[index];
+    const mask = ~(slabSize(index) - 1);
+
+    class.mutex.lock();
+    defer class.mutex.unlock();
+
+    while (cache.count > keep) {
+        const object = cache.head.?;
+        cache.head = object.next;
+        cache.count -= 1;
+
+        const slab: *Slab = @ptrFromInt(@intFromPtr(object) & mask);
+        object.next = slab.free_list;
+        slab.free_list = object;
+        slab.free_count += 1;
+
+        if (!slab.in_partial) pushPartial(class, slab);
+
+        if (slab.free_count == slab.capacity) {
+            if (class.empty_count >= EMPTY_SLABS_KEPT) {
+                removePartial(class, slab);
+                releaseSlab(index, class, slab);
+            } else {
+                class.empty_count += 1;
+            }
+        }
+    }
+}
+
+// ===== Thread caches =====
+
+fn createFlushKey() void {
+    _ = c.pthread_key_create(&flush_key, &flushThreadCache);
+}
+
+// Thread exit: hand every cached object back to its slab. Later destructors
+// may still allocate or free; those go straight to the slabs.
+fn flushThreadCache(_: ?*anyopaque) callconv(.C) void {
+    thread_cache.exiting = true;
+    threadFlush();
+}
+
+fn threadFlush() void {
+    for (&thread_cache.classes, 0..) |*cache, index| {
+        if (cache.count > 0) flush(index, cache, 0);
+    }
+}
+
+fn registerThread() void {
+    flush_key_once.call();
+    _ = c.pthread_setspecific(flush_key, &thread_cache);
+    thread_cache.registered = true;
+}
+
+inline fn allocSmall(index: usize) ?*anyopaque {
+    const cache = &thread_cache.classes[index];
+    if (cache.head == null) {
+        if (!thread_cache.registered) registerThread();
+        if (!refill(index, cache)) return null;
+    }
+    const object = cache.head.?;
+    cache.head = object.next;
+    cache.count -= 1;
+
+    // Past the exit flush, return the rest of the refill batch at once
+    if (thread_cache.exiting and cache.count > 0) flush(index, cache, 0);
+    return object;
+}
+
+inline fn freeSmall(index: usize, ptr: *anyopaque) void {
+    if (!thread_cache.registered) registerThread();
+
+    const cache = &thread_cache.classes[index];
+    const object: *FreeObject = @ptrCast(@alignCast(ptr));
+    object.next = cache.head;
+    cache.head = object;
+    cache.count += 1;
+
+    if (thread_cache.exiting) {
+        flush(index, cache, 0);
+        return;
+    }
+
+    const limit = cacheLimit(index);
+    if (cache.count > limit) flush(index, cache, limit / 2);
+}
+
+// ===== Large spans =====
+
+fn allocLarge(size: usize, alignment: usize) ?*anyopaque {
+    // Whole map units, so no other mapping can start inside the span's units
+    const len = std.mem.alignForward(usize, size, SPAN_ALIGNMENT);
+    const span_alignment = @max(alignment, SPAN_ALIGNMENT);
+
+    // Reuse a released span of the same length
+    span_cache.mutex.lock();
+    for (&span_cache.spans) |*span| {
+        if (span.len == len and span.addr % span_alignment == 0) {
+            const addr = span.addr;
+            if (span.resident) span_cache.resident_bytes -= len;
+            span.* = .{};
+            span_cache.mutex.unlock();
+            _ = stat_large.fetchAdd(1, .monotonic);
+            return @ptrFromInt(addr);
+        }
+    }
+    span_cache.mutex.unlock();
+
+    const addr = mapAligned(len, span_alignment) orelse return null;
+    if (!pageMapSet(addr, 1, len | LARGE_SPAN_TAG)) {
+        unmapPages(addr, len);
+        return null;
+    }
+    _ = stat_large.fetchAdd(1, .monotonic);
+    return @ptrFromInt(addr);
+}
+
+fn freeLarge(addr: usize, len: usize) void {
+    _ = stat_large.fetchSub(1, .monotonic);
+
+    span_cache.mutex.lock();
+    for (&span_cache.spans) |*span| {
+        if (span.len == 0) {
+            // Keep recently freed spans resident up to a budget
+            const resident = span_cache.resident_bytes + len <= SPAN_CACHE_COMMITTED;
+            if (resident) {
+                span_cache.resident_bytes += len;
+            } else {
+                releasePages(addr, len);
+            }
+            span.* = .{ .addr = addr, .len = len, .resident = resident };
+            span_cache.mutex.unlock();
+            return;
+        }
+    }
+    span_cache.mutex.unlock();
+
+    _ = pageMapSet(addr, 1, 0);
+    unmapPages(addr, len);
+}
+
+// ===== Byte-level API =====
+
+// Allocate size bytes aligned to alignment (a power of two)
+pub fn allocBytes(size: usize, alignment: usize) ?*anyopaque {
+    if (classFor(size, alignment)) |index| {
+        return allocSmall(index);
+    }
+    return allocLarge(size, alignment);
+}
+
+// Usable size of an allocation, or null if it did not come from this allocator
+pub fn usableSize(ptr: *anyopaque) ?usize {
+    const entry = pageMapGet(@intFromPtr(ptr));
+    if (entry == 0) return null;
+    if (entry & LARGE_SPAN_TAG != 0) return entry & ~LARGE_SPAN_TAG;
+    const slab: *Slab = @ptrFromInt(entry);
+    return class_sizes[slab.class_index];
+}
+
+// Free an allocation; the owner is found from the pointer
+pub fn freeBytes(ptr: *anyopaque) void {
+    const entry = pageMapGet(@intFromPtr(ptr));
+    if (entry == 0) {
+        // Not ours: memory from the system allocator that preceded us
+        c.free(ptr);
+        return;
+    }
+    if (entry & LARGE_SPAN_TAG != 0) {
+        freeLarge(@intFromPtr(ptr), entry & ~LARGE_SPAN_TAG);
+        return;
+    }
+    const slab: *Slab = @ptrFromInt(entry);
+    freeSmall(slab.class_index, ptr);
+}
+
+// Return the calling thread's cached objects to their slabs
+pub fn flushThread() void {
+    threadFlush();
+}
+
+// Get allocator statistics
+pub fn getStats() SlabStats {
+    var cached: usize = 0;
+    span_cache.mutex.lock();
+    for (span_cache.spans) |span| {
+        if (span.len != 0) cached += 1;
+    }
+    span_cache.mutex.unlock();
+
+    return .{
+        .bytes_mapped = stat_bytes_mapped.load(.monotonic),
+        .bytes_released = stat_bytes_released.load(.monotonic),
+        .slabs = stat_slabs.load(.monotonic),
+        .released_slabs = stat_released_slabs.load(.monotonic),
+        .large_allocations = stat_large.load(.monotonic),
+        .cached_spans = cached,
+    };
+}
+
+// Slab allocator implementation
+pub const SlabAllocator = struct {
+    // Base allocator interface
+    allocator: Allocator,
+
+    // Initialize the slab allocator
+    pub fn init() SlabAllocator {
+        return .{
+            .allocator = .{
+                .vtable = &slabVTable,
+                .strategy = .panic,
+                .out_of_mem_fn = null,
+                .context = null,
+                .track_stats = false,
+                .stats = .{},
+            },
+        };
+    }
+
+    fn alloc(allocator: *Allocator, size: usize, alignment: usize, options: c_int) ?*anyopaque {
+        if (size == 0) return null;
+
+        const actual_alignment = if (alignment == 0) DEFAULT_ALIGNMENT else alignment;
+        if (!std.math.isPowerOfTwo(actual_alignment)) {
+            std.debug.print("Warning: alignment {d} is not a power of 2\n", .{actual_alignment});
+            return allocator_core.handleAllocationFailure(allocator, size);
+        }
+
+        const ptr = allocBytes(size, actual_alignment) orelse
+            return allocator_core.handleAllocationFailure(allocator, size);
+
+        if (AllocOptions.fromC(options).zero) {
+            @memset(@as([*]u8, @ptrCast(ptr))[0..size], 0);
+        }
+
+        if (allocator.track_stats) {
+            allocator.stats.bytes_allocated += size;
+            allocator.stats.bytes_reserved += size;
+            if (allocator.stats.bytes_allocated > allocator.stats.max_bytes_allocated) {
+                allocator.stats.max_bytes_allocated = allocator.stats.bytes_allocated;
+            }
+            allocator.stats.allocation_count += 1;
+            allocator.stats.total_allocations += 1;
+        }
+
+        return ptr;
+    }
+
+    fn realloc(allocator: *Allocator, ptr: ?*anyopaque, old_size: usize, new_size: usize, alignment: usize, options: c_int) ?*anyopaque {
+        if (ptr == null) {
+            return alloc(allocator, new_size, alignment, options);
+        }
+        if (new_size == 0) {
+            free(allocator, ptr, old_size, alignment);
+            return null;
+        }
+
+        // Stay in place while the new size fits the object or span
+        if (usableSize(ptr.?)) |usable| {
+            const actual_alignment = if (alignment == 0) DEFAULT_ALIGNMENT else alignment;
+            const shrinks_far = usable > MAX_SMALL_SIZE and new_size <= usable / 2;
+            if (new_size <= usable and !shrinks_far and @intFromPtr(ptr.?) % actual_alignment == 0) {
+                if (AllocOptions.fromC(options).zero and new_size > old_size) {
+                    @memset(@as([*]u8, @ptrCast(ptr.?))[old_size..new_size], 0);
+                }
+                if (allocator.track_stats) {
+                    allocator.stats.bytes_allocated = allocator.stats.bytes_allocated -| old_size + new_size;
+                }
+                return ptr;
+            }
+        }
+
+        const new_ptr = alloc(allocator, new_size, alignment, options) orelse return null;
+        const copy_size = @min(old_size, new_size);
+        @memcpy(@as([*]u8, @ptrCast(new_ptr))[0..copy_size], @as([*]u8, @ptrCast(ptr.?))[0..copy_size]);
+        free(allocator, ptr, old_size, alignment);
+        return new_ptr;
+    }
+
+    fn free(allocator: *Allocator, ptr: ?*anyopaque, size: usize, alignment: usize) void {
+        _ = alignment;
+        if (ptr == null) return;
+
+        if (allocator.track_stats) {
+            allocator.stats.bytes_allocated -|= size;
+            allocator.stats.bytes_reserved -|= size;
+            allocator.stats.allocation_count -|= 1;
+            allocator.stats.total_frees += 1;
+        }
+
+        freeBytes(ptr.?);
+    }
+
+    fn destroy(allocator: *Allocator) void {
+        // Global allocator: slabs live for the whole process
+        _ = allocator;
+    }
+};
+
+// Allocator vtable for slab allocator
+const slabVTable = allocator_core.AllocatorVTable{
+    .allocFn = SlabAllocator.alloc,
+    .reallocFn = SlabAllocator.realloc,
+    .freeFn = SlabAllocator.free,
+    .destroyFn = SlabAllocator.destroy,
+};
+
+// Exported C API functions
+export fn goo_slab_allocator_get_stats() SlabStats {
+    return getStats();
+}
+
+export fn goo_slab_allocator_thread_flush() void {
+    flushThread();
+}
+
+export fn goo_slab_usable_size(ptr: ?*anyopaque) usize {
+    if (ptr) |p| return usableSize(p) orelse 0;
+    return 0;
+}
+
+// ===== Tests =====
+
+const testing = std.testing;
+
+fn freeAll(ptrs: []const *anyopaque) void {
+    for (ptrs) |ptr| freeBytes(ptr);
+}
+
+fn allocAll(ptrs: []*anyopaque, size: usize) void {
+    for (ptrs) |*ptr| ptr.* = allocBytes(size, DEFAULT_ALIGNMENT).?;
+}
+
+test "objects freed on another thread are reused after it exits" {
+    const size = 96;
+    var first: [512]*anyopaque = undefined;
+    allocAll(&first, size);
+    flushThread();
+
+    // Free everything from a thread that exits, so only its exit flush
+    // returns the objects to the slabs
+    const freer = try std.Thread.spawn(.{}, freeAll, .{@as([]const *anyopaque, &first)});
+    freer.join();
+
+    const slabs_before = getStats().slabs;
+    var second: [512]*anyopaque = undefined;
+    const allocator = try std.Thread.spawn(.{}, allocAll, .{ @as([]*anyopaque, &second), size });
+    allocator.join();
+    try testing.expectEqual(slabs_before, getStats().slabs);
+
+    // Every object handed out again was one the exiting thread freed
+    for (second) |ptr| {
+        try testing.expect(std.mem.indexOfScalar(*anyopaque, &first, ptr) != null);
+    }
+    freeAll(&second);
+    flushThread();
+}
+
+fn lateFreeAfterExitFlush(index_out: *usize, cached_out: *u32) void {
+    const early = allocBytes(256, DEFAULT_ALIGNMENT).?;
+    const late = allocBytes(256, DEFAULT_ALIGNMENT).?;
+    freeBytes(early);
+
+    // What the thread-exit destructor does, then a free from a later destructor
+    flushThreadCache(null);
+    freeBytes(late);
+    const extra = allocBytes(256, DEFAULT_ALIGNMENT).?;
+    freeBytes(extra);
+
+    const index = classFor(256, DEFAULT_ALIGNMENT).?;
+    index_out.* = index;
+    cached_out.* = thread_cache.classes[index].count;
+}
+
+test "frees after the thread-exit flush are not left in the cache" {
+    var index: usize = 0;
+    var cached: u32 = 1;
+    const thread = try std.Thread.spawn(.{}, lateFreeAfterExitFlush, .{ &index, &cached });
+    thread.join();
+    try testing.expectEqual(@as(u32, 0), cached);
+}
+
+test "freed large spans are reused" {
+    const size = 3 * MAX_SMALL_SIZE + 100;
+    const first = allocBytes(size, DEFAULT_ALIGNMENT).?;
+    try testing.expect(usableSize(first).? >= size);
+    @memset(@as([*]u8, @ptrCast(first))[0..size], 0xab);
+
+    const cached_before = getStats().cached_spans;
+    freeBytes(first);
+    try testing.expectEqual(cached_before + 1, getStats().cached_spans);
+
+    const mapped_before = getStats().bytes_mapped;
+    const second = allocBytes(size, DEFAULT_ALIGNMENT).?;
+    try testing.expectEqual(first, second);
+    try testing.expectEqual(mapped_before, getStats().bytes_mapped);
+    try testing.expectEqual(cached_before, getStats().cached_spans);
+    freeBytes(second);
+}
+
+test "empty slabs beyond the reserve are released and usable again" {
+    // 16 KB objects: seven per 128 KB slab
+    const size = 16 * 1024;
+    var ptrs: [64]*anyopaque = undefined;
+    allocAll(&ptrs, size);
+    for (ptrs) |ptr| @memset(@as([*]u8, @ptrCast(ptr))[0..size], 0xcd);
+
+    const before = getStats();
+    freeAll(&ptrs);
+    flushThread();
+    const after = getStats();
+    try testing.expect(after.released_slabs >= before.released_slabs + 2);
+    try testing.expect(after.bytes_released > before.bytes_released);
+
+    // Released slabs come back first and their pages read as zero
+    allocAll(&ptrs, size);
+    try testing.expect(getStats().released_slabs < after.released_slabs);
+    var zeroed = false;
+    for (ptrs) |ptr| {
+        const bytes = @as([*]const u8, @ptrCast(ptr))[0..size];
+        if (std.mem.allEqual(u8, bytes[@sizeOf(FreeObject)..], 0)) zeroed = true;
+        @memset(@as([*]u8, @ptrCast(ptr))[0..size], 0xef);
+    }
+    try testing.expect(zeroed);
+    freeAll(&ptrs);
+    flushThread();
+}
+
+test "pointers from malloc are handed back to libc" {
+    const foreign = c.malloc(64).?;
+    try testing.expectEqual(@as(?usize, null), usableSize(foreign));
+
+    // Must not land in a thread cache or touch any slab
+    var cached_before: u32 = 0;
+    for (thread_cache.classes) |cache| cached_before += cache.count;
+    freeBytes(foreign);
+    var cached_after: u32 = 0;
+    for (thread_cache.classes) |cache| cached_after += cache.count;
+    try testing.expectEqual(cached_before, cached_after);
+}
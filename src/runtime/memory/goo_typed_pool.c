@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "goo_integration.h"
+#include "goo_concurrent_pool.h"
+#include "goo_typed_pool.h"
+
+#define TYPE_POOL_GRANULE 16
+#define TYPE_POOL_CLASSES (GOO_TYPED_POOL_MAX_SIZE / TYPE_POOL_GRANULE)
+
+// Where a pool-class typed object came from
+#define TYPED_SOURCE_POOL 1
+#define TYPED_SOURCE_HEAP 2
+
+// Header in front of pool-class typed objects, so a heap fallback is never
+// freed into a pool. 16 bytes keeps the payload aligned like the chunk
+typedef struct TypedHeader {
+    size_t source;
+    size_t size_class;
+} TypedHeader;
+
+// One thread-safe pool per 16-byte size class, created on first use
+static _Atomic(GooConcurrentPool*) type_pools[TYPE_POOL_CLASSES];
+static pthread_mutex_t type_pools_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Get or create the pool serving objects of obj_size bytes
+GooConcurrentPool* goo_runtime_get_type_pool(size_t obj_size, const char* type_name) {
+    if (obj_size == 0 || obj_size > GOO_TYPED_POOL_MAX_SIZE) {
+        return NULL;
+    }
+
+    size_t size_class = (obj_size - 1) / TYPE_POOL_GRANULE;
+
+    // Fast path: the pool already exists
+    GooConcurrentPool* pool = atomic_load_explicit(&type_pools[size_class], memory_order_acquire);
+    if (pool) {
+        return pool;
+    }
+
+    pthread_mutex_lock(&type_pools_mutex);
+
+    pool = atomic_load_explicit(&type_pools[size_class], memory_order_relaxed);
+    if (!pool) {
+        size_t chunk_size = (size_class + 1) * TYPE_POOL_GRANULE + sizeof(TypedHeader);
+        pool = goo_concurrent_pool_create(NULL, chunk_size, 8);
+        if (!pool) {
+            fprintf(stderr, "Failed to create pool for type %s\n", type_name ? type_name : "unknown");
+        } else {
+            atomic_store_explicit(&type_pools[size_class], pool, memory_order_release);
+        }
+    }
+
+    pthread_mutex_unlock(&type_pools_mutex);
+    return pool;
+}
+
+bool goo_typed_pool_serves(size_t size, const char* type_name) {
+    return size > 0 && size <= GOO_TYPED_POOL_MAX_SIZE && type_name != NULL;
+}
+
+void* goo_typed_pool_alloc(size_t size, const char* type_name) {
+    // Fall back to malloc, which any thread may free, when the pool can't be
+    // created or is exhausted
+    GooConcurrentPool* pool = goo_runtime_get_type_pool(size, type_name);
+    TypedHeader* header = pool ? goo_concurrent_pool_alloc(pool) : NULL;
+    size_t source = TYPED_SOURCE_POOL;
+    if (!header) {
+        header = malloc(sizeof(TypedHeader) + size);
+        source = TYPED_SOURCE_HEAP;
+    }
+    if (!header) {
+        return NULL;
+    }
+    header->source = source;
+    header->size_class = (size - 1) / TYPE_POOL_GRANULE;
+    return header + 1;
+}
+
+void goo_typed_pool_free(void* ptr) {
+    TypedHeader* header = (TypedHeader*)ptr - 1;
+    if (header->source == TYPED_SOURCE_POOL) {
+        GooConcurrentPool* pool = atomic_load_explicit(&type_pools[header->size_class],
+                                                       memory_order_acquire);
+        goo_concurrent_pool_free(pool, header);
+    } else {
+        free(header);
+    }
+}
+
+void goo_typed_pool_shutdown(void) {
+    pthread_mutex_lock(&type_pools_mutex);
+    for (int i = 0; i < TYPE_POOL_CLASSES; i++) {
+        goo_concurrent_pool_destroy(atomic_exchange(&type_pools[i], NULL));
+    }
+    pthread_mutex_unlock(&type_pools_mutex);
+}
@@ -0,0 +1,30 @@
+#ifndef GOO_TYPED_POOL_H
+#define GOO_TYPED_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size-class pools behind goo_runtime_typed_alloc.
+//
+// Typed objects of up to GOO_TYPED_POOL_MAX_SIZE bytes come from one
+// concurrent pool per 16-byte size class. Each object carries a small header
+// recording where it came from, so an object that fell back to malloc (pool
+// creation failed or the pool was exhausted) is never freed into a pool.
+// goo_runtime_get_type_pool is declared with the rest of the typed-allocation
+// API in goo_integration.h.
+
+#define GOO_TYPED_POOL_MAX_SIZE 1024
+
+// Whether an object of this size and type is served by the pools
+bool goo_typed_pool_serves(size_t size, const char* type_name);
+
+// Allocate from the size-class pool, falling back to malloc
+void* goo_typed_pool_alloc(size_t size, const char* type_name);
+
+// Free an object from goo_typed_pool_alloc; any thread may free it
+void goo_typed_pool_free(void* ptr);
+
+// Destroy all size-class pools. No thread may still hold pool objects
+void goo_typed_pool_shutdown(void);
+
+#endif // GOO_TYPED_POOL_H
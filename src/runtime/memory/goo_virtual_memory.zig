@@ -0,0 +1,213 @@
+const std = @import("std");
+const c = @cImport({
+    @cDefine("_GNU_SOURCE", "1");
+    @cInclude("sys/mman.h");
+});
+
+// Reserved virtual address ranges for mmap-backed arenas and regions.
+//
+// A range reserves its whole address span up front with PROT_NONE and
+// commits it on demand in large granules, so a multi-GB arena is one
+// contiguous mapping the kernel can back with 2 MB pages. Resetting discards
+// pages with MADV_DONTNEED instead of freeing and reallocating blocks.
+
+pub const HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+const NORMAL_COMMIT_GRANULE = 64 * 1024; // Commit step without huge pages
+const MAP_HUGE_2MB: c_int = 21 << 26; // log2(2 MB) << MAP_HUGE_SHIFT
+
+// How a range is backed
+pub const PageMode = enum(c_int) {
+    normal = 0, // 4 KB pages
+    transparent_huge = 1, // MADV_HUGEPAGE on committed memory
+    explicit_huge = 2, // MAP_HUGETLB 2 MB pages, falling back to transparent
+};
+
+pub const VirtualRange = struct {
+    base: usize, // Start of the reservation (2 MB aligned)
+    reserved: usize, // Bytes of address space reserved
+    committed: usize, // Bytes from base that are readable and writable
+    granule: usize, // Commit step
+    mode: PageMode, // Backing actually in use
+
+    // Reserve size bytes of address space
+    pub fn reserve(size: usize, mode: PageMode) ?VirtualRange {
+        const reserved = std.mem.alignForward(usize, @max(size, 1), HUGE_PAGE_SIZE);
+
+        // hugetlb pages are taken from the pool at map time; no commit step.
+        // Without a configured pool this fails and transparent pages are used.
+        if (@hasDecl(c, "MAP_HUGETLB")) {
+            if (mode == .explicit_huge) {
+                const flags = c.MAP_PRIVATE | c.MAP_ANONYMOUS | c.MAP_HUGETLB | MAP_HUGE_2MB;
+                if (mapRange(reserved, c.PROT_READ | c.PROT_WRITE, flags)) |base| {
+                    return .{
+                        .base = base,
+                        .reserved = reserved,
+                        .committed = reserved,
+                        .granule = HUGE_PAGE_SIZE,
+                        .mode = .explicit_huge,
+                    };
+                }
+            }
+        }
+
+        // Over-reserve by one huge page so the base can be aligned to one
+        const raw = mapRange(reserved + HUGE_PAGE_SIZE, c.PROT_NONE, c.MAP_PRIVATE | c.MAP_ANONYMOUS | c.MAP_NORESERVE) orelse return null;
+        const base = std.mem.alignForward(usize, raw, HUGE_PAGE_SIZE);
+        if (base > raw) _ = c.munmap(@ptrFromInt(raw), base - raw);
+        const tail = raw + reserved + HUGE_PAGE_SIZE - (base + reserved);
+        if (tail > 0) _ = c.munmap(@ptrFromInt(base + reserved), tail);
+
+        const actual_mode: PageMode = if (mode == .normal) .normal else .transparent_huge;
+        return .{
+            .base = base,
+            .reserved = reserved,
+            .committed = 0,
+            .granule = if (actual_mode == .normal) NORMAL_COMMIT_GRANULE else HUGE_PAGE_SIZE,
+            .mode = actual_mode,
+        };
+    }
+
+    // Make the first end bytes of the range usable
+    pub fn commit(self: *VirtualRange, end: usize) bool {
+        if (end <= self.committed) return true;
+        if (end > self.reserved) return false;
+
+        const new_committed = @min(std.mem.alignForward(usize, end, self.granule), self.reserved);
+        const start = self.base + self.committed;
+        const len = new_committed - self.committed;
+
+        if (c.mprotect(@ptrFromInt(start), len, c.PROT_READ | c.PROT_WRITE) != 0) return false;
+        if (@hasDecl(c, "MADV_HUGEPAGE")) {
+            if (self.mode == .transparent_huge) {
+                _ = c.madvise(@ptrFromInt(start), len, c.MADV_HUGEPAGE);
+            }
+        }
+
+        self.committed = new_committed;
+        return true;
+    }
+
+    // Bump-allocate from offset used.*, committing as needed
+    pub fn bump(self: *VirtualRange, used: *usize, size: usize, alignment: usize) ?*anyopaque {
+        const start = std.mem.alignForward(usize, self.base + used.*, alignment);
+        const end = start + size - self.base;
+        if (!self.commit(end)) return null;
+
+        used.* = end;
+        return @ptrFromInt(start);
+    }
+
+    // Give the pages in [from, to) back to the OS; they stay committed and read as zero
+    pub fn discard(self: *VirtualRange, from: usize, to: usize) void {
+        const page = if (self.mode == .explicit_huge) HUGE_PAGE_SIZE else std.heap.pageSize();
+        const start = std.mem.alignForward(usize, from, page);
+        const end = @min(std.mem.alignForward(usize, to, page), self.committed);
+        if (end <= start) return;
+
+        _ = c.madvise(@ptrFromInt(self.base + start), end - start, c.MADV_DONTNEED);
+    }
+
+    // Whether addr lies in the reservation
+    pub fn contains(self: *const VirtualRange, addr: usize) bool {
+        return addr >= self.base and addr - self.base < self.reserved;
+    }
+
+    // Unmap the whole range
+    pub fn release(self: *VirtualRange) void {
+        _ = c.munmap(@ptrFromInt(self.base), self.reserved);
+        self.committed = 0;
+    }
+};
+
+fn mapRange(len: usize, prot: c_int, flags: c_int) ?usize {
+    const result = c.mmap(null, len, prot, flags, -1, 0);
+    const addr = @intFromPtr(result);
+    if (addr == 0 or addr == std.math.maxInt(usize)) return null;
+    return addr;
+}
+
+// Pages of [from, to) that are resident, as reported by mincore
+fn residentPages(range: *const VirtualRange, from: usize, to: usize) usize {
+    const page = std.heap.pageSize();
+    var vec: [1024]u8 = undefined;
+    const pages = (to - from) / page;
+    std.debug.assert(pages <= vec.len);
+    if (c.mincore(@ptrFromInt(range.base + from), to - from, &vec) != 0) return std.math.maxInt(usize);
+
+    var count: usize = 0;
+    for (vec[0..pages]) |state| count += state & 1;
+    return count;
+}
+
+test "ranges commit on demand in granules" {
+    var range = VirtualRange.reserve(8 * 1024 * 1024, .normal).?;
+    defer range.release();
+
+    try std.testing.expect(range.base % HUGE_PAGE_SIZE == 0);
+    try std.testing.expectEqual(8 * 1024 * 1024, range.reserved);
+    try std.testing.expectEqual(0, range.committed);
+
+    var used: usize = 0;
+    const first: [*]u8 = @ptrCast(range.bump(&used, 100, 16).?);
+    try std.testing.expectEqual(range.base, @intFromPtr(first));
+    try std.testing.expectEqual(NORMAL_COMMIT_GRANULE, range.committed);
+    @memset(first[0..100], 0xAA);
+
+    // A bump that crosses the granule commits up to the next one only
+    const second: [*]u8 = @ptrCast(range.bump(&used, NORMAL_COMMIT_GRANULE, 16).?);
+    try std.testing.expectEqual(2 * NORMAL_COMMIT_GRANULE, range.committed);
+    second[NORMAL_COMMIT_GRANULE - 1] = 1;
+
+    // Nothing past the reservation is committed
+    try std.testing.expect(range.bump(&used, range.reserved, 16) == null);
+    try std.testing.expectEqual(2 * NORMAL_COMMIT_GRANULE, range.committed);
+    try std.testing.expect(!range.commit(range.reserved + 1));
+
+    // Committing does not touch pages; they become resident when written
+    try std.testing.expect(range.commit(1024 * 1024));
+    try std.testing.expectEqual(1024 * 1024, range.committed);
+    try std.testing.expectEqual(0, residentPages(&range, 2 * NORMAL_COMMIT_GRANULE, 1024 * 1024));
+
+    try std.testing.expect(range.commit(range.reserved));
+    try std.testing.expectEqual(range.reserved, range.committed);
+}
+
+test "huge page ranges commit in 2 MB granules" {
+    var range = VirtualRange.reserve(3 * 1024 * 1024, .transparent_huge).?;
+    defer range.release();
+
+    try std.testing.expectEqual(PageMode.transparent_huge, range.mode);
+    try std.testing.expectEqual(2 * HUGE_PAGE_SIZE, range.reserved);
+    try std.testing.expectEqual(0, range.committed);
+
+    var used: usize = 0;
+    _ = range.bump(&used, 1, 1).?;
+    try std.testing.expectEqual(HUGE_PAGE_SIZE, range.committed);
+    _ = range.bump(&used, HUGE_PAGE_SIZE, 1).?;
+    try std.testing.expectEqual(2 * HUGE_PAGE_SIZE, range.committed);
+}
+
+test "discarded pages go back to the OS and read as zero" {
+    var range = VirtualRange.reserve(HUGE_PAGE_SIZE, .normal).?;
+    defer range.release();
+
+    const page = std.heap.pageSize();
+    const size = 1024 * 1024;
+    try std.testing.expect(range.commit(size));
+    const bytes: [*]u8 = @ptrFromInt(range.base);
+    @memset(bytes[0..size], 0xAA);
+    try std.testing.expectEqual(size / page, residentPages(&range, 0, size));
+
+    // The partial page at the start is kept and the end is clipped to what
+    // is committed
+    range.discard(NORMAL_COMMIT_GRANULE + 1, 4 * size);
+    const kept = NORMAL_COMMIT_GRANULE + page;
+    try std.testing.expectEqual(kept / page, residentPages(&range, 0, size));
+    for (bytes[0..kept]) |byte| try std.testing.expectEqual(0xAA, byte);
+    for (bytes[kept..size]) |byte| try std.testing.expectEqual(0, byte);
+
+    // Discarded pages stay committed
+    try std.testing.expectEqual(size, range.committed);
+    bytes[size - 1] = 7;
+    try std.testing.expectEqual(7, bytes[size - 1]);
+}
@@ -9,6 +9,7 @@
 #include <string.h>
 #include "memory/memory.h"
 #include "runtime.h"
+#include "scope/scope.h"
 
 // Structure to hold cleanup data passed to the callback
 typedef struct {
@@ -51,23 +52,8 @@ void goo_memory_cleanup_callback(void* data) {
 bool goo_scope_register_memory_cleanup(void* ptr, size_t size, size_t alignment) {
     if (!ptr) return false;
     
-    // Allocate cleanup data
-    GooMemoryCleanupData* cleanup_data = (GooMemoryCleanupData*)malloc(sizeof(GooMemoryCleanupData));
-    if (!cleanup_data) return false;
-    
-    // Initialize cleanup data
-    cleanup_data->ptr = ptr;
-    cleanup_data->size = size;
-    cleanup_data->alignment = alignment;
-    
-    // Register with the runtime scope system
-    bool result = goo_scope_register_cleanup(cleanup_data, goo_memory_cleanup_callback);
-    if (!result) {
-        free(cleanup_data);
-        return false;
-    }
-    
-    return true;
+    // The scope system stores memory entries inline; no cleanup data is needed
+    return goo_scope_register_memory(ptr, size, alignment);
 }
 
 /**
@@ -572,6 +572,470 @@ pub const ParallelReduce = struct {
     }
 };
 
+// Parallel algorithms
+//
+// Each algorithm splits its input into blocks, runs the per-block work on the
+// thread pool, and combines per-block results with a short sequential pass.
+pub const algorithms = struct {
+    // Inputs smaller than this are processed on the calling thread
+    pub const sequential_cutoff: usize = 4096;
+    const blocks_per_thread: usize = 4;
+    const min_merge_segment: usize = 1024;
+
+    // First element of block b when count elements are split into n near-equal blocks
+    fn blockBegin(b: usize, n: usize, count: usize) usize {
+        const base = count / n;
+        const extra = count % n;
+        return b * base + @min(b, extra);
+    }
+
+    fn blockCount(pool: *ThreadPool, count: usize, per_thread: usize) usize {
+        if (count < sequential_cutoff) return 1;
+        const target = @max(pool.threads.len, 1) * per_thread;
+        return @max(@min(target, count / sequential_cutoff), 1);
+    }
+
+    // Run body(ctx, block) for every block on the pool and wait for all of them
+    fn runBlocks(
+        pool: *ThreadPool,
+        num_blocks: usize,
+        ctx: anytype,
+        comptime body: fn (@TypeOf(ctx), usize) void,
+    ) !void {
+        const Ctx = @TypeOf(ctx);
+        const BlockTask = struct {
+            ctx: Ctx,
+            block: usize,
+
+            fn executeFn(data: *anyopaque) void {
+                const self = @as(*@This(), @ptrCast(@alignCast(data)));
+                body(self.ctx, self.block);
+            }
+        };
+
+        if (num_blocks <= 1) {
+            if (num_blocks == 1) body(ctx, 0);
+            return;
+        }
+
+        const tasks = try global_allocator.alloc(BlockTask, num_blocks);
+        defer global_allocator.free(tasks);
+
+        for (tasks, 0..) |*block_task, b| {
+            block_task.* = .{ .ctx = ctx, .block = b };
+            const task = try Task.create(BlockTask.executeFn, block_task);
+            // The pool copies the task when it is submitted
+            defer task.destroy();
+            if (!pool.submit(task)) {
+                body(ctx, b);
+            }
+        }
+
+        pool.waitAll();
+    }
+
+    /// Sort items in parallel: blocks are sorted independently, then merged
+    /// pairwise with merge-path partitioning so every round uses all workers.
+    pub fn sort(
+        comptime T: type,
+        pool: *ThreadPool,
+        items: []T,
+        context: anytype,
+        comptime lessThan: fn (@TypeOf(context), T, T) bool,
+    ) !void {
+        const Context = @TypeOf(context);
+        const num_runs = blockCount(pool, items.len, blocks_per_thread);
+        if (num_runs <= 1) {
+            std.sort.pdq(T, items, context, lessThan);
+            return;
+        }
+
+        const scratch = try global_allocator.alloc(T, items.len);
+        defer global_allocator.free(scratch);
+
+        const SortCtx = struct {
+            src: []T,
+            dst: []T,
+            context: Context,
+            width: usize,
+            segments: usize,
+
+            fn sortRun(self: *@This(), run: usize) void {
+                const begin = @min(run * self.width, self.src.len);
+                const end = @min(begin + self.width, self.src.len);
+                std.sort.pdq(T, self.src[begin..end], self.context, lessThan);
+            }
+
+            // Number of elements taken from a among the first k merged elements
+            fn coRank(self: *@This(), k: usize, a: []const T, b: []const T) usize {
+                var lo: usize = if (k > b.len) k - b.len else 0;
+                var hi: usize = @min(k, a.len);
+                while (lo < hi) {
+                    const mid = lo + (hi - lo) / 2;
+                    if (!lessThan(self.context, b[k - mid - 1], a[mid])) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            }
+
+            fn mergeSegment(self: *@This(), unit: usize) void {
+                const pair = unit / self.segments;
+                const seg = unit % self.segments;
+                const a_begin = pair * 2 * self.width;
+                if (a_begin >= self.src.len) return;
+                const a_end = @min(a_begin + self.width, self.src.len);
+                const b_end = @min(a_end + self.width, self.src.len);
+                const a = self.src[a_begin..a_end];
+                const b = self.src[a_end..b_end];
+
+                const k0 = blockBegin(seg, self.segments, a.len + b.len);
+                const k1 = blockBegin(seg + 1, self.segments, a.len + b.len);
+                var i = self.coRank(k0, a, b);
+                const i_end = self.coRank(k1, a, b);
+                var j = k0 - i;
+                const j_end = k1 - i_end;
+
+                var out = a_begin + k0;
+                while (i < i_end and j < j_end) : (out += 1) {
+                    if (lessThan(self.context, b[j], a[i])) {
+                        self.dst[out] = b[j];
+                        j += 1;
+                    } else {
+                        self.dst[out] = a[i];
+                        i += 1;
+                    }
+                }
+                while (i < i_end) : ({ i += 1; out += 1; }) self.dst[out] = a[i];
+                while (j < j_end) : ({ j += 1; out += 1; }) self.dst[out] = b[j];
+            }
+        };
+
+        var ctx = SortCtx{
+            .src = items,
+            .dst = scratch,
+            .context = context,
+            .width = (items.len + num_runs - 1) / num_runs,
+            .segments = 1,
+        };
+
+        try runBlocks(pool, num_runs, &ctx, SortCtx.sortRun);
+
+        const target_units = @max(pool.threads.len, 1) * 2;
+        while (ctx.width < items.len) {
+            const pairs = (items.len + 2 * ctx.width - 1) / (2 * ctx.width);
+            const wanted = (target_units + pairs - 1) / pairs;
+            ctx.segments = @max(@min(wanted, (2 * ctx.width) / min_merge_segment), 1);
+
+            try runBlocks(pool, pairs * ctx.segments, &ctx, SortCtx.mergeSegment);
+
+            std.mem.swap([]T, &ctx.src, &ctx.dst);
+            ctx.width *= 2;
+        }
+
+        if (ctx.src.ptr != items.ptr) {
+            @memcpy(items, ctx.src);
+        }
+    }
+
+    /// LSD radix sort over 8-bit digits for unsigned integer keys.
+    pub fn radixSort(comptime T: type, pool: *ThreadPool, keys: []T) !void {
+        comptime std.debug.assert(@typeInfo(T).int.signedness == .unsigned);
+        if (keys.len < 2) return;
+
+        const buckets = 256;
+        const num_blocks = blockCount(pool, keys.len, 1);
+        const scratch = try global_allocator.alloc(T, keys.len);
+        defer global_allocator.free(scratch);
+        const offsets = try global_allocator.alloc(usize, num_blocks * buckets);
+        defer global_allocator.free(offsets);
+
+        const RadixCtx = struct {
+            src: []T,
+            dst: []T,
+            offsets: []usize,
+            num_blocks: usize,
+            shift: std.math.Log2Int(T),
+
+            fn countBlock(self: *@This(), b: usize) void {
+                const counts = self.offsets[b * buckets ..][0..buckets];
+                @memset(counts, 0);
+                const begin = blockBegin(b, self.num_blocks, self.src.len);
+                const end = blockBegin(b + 1, self.num_blocks, self.src.len);
+                for (self.src[begin..end]) |k| {
+                    counts[@as(u8, @truncate(k >> self.shift))] += 1;
+                }
+            }
+
+            fn scatterBlock(self: *@This(), b: usize) void {
+                var local: [buckets]usize = undefined;
+                @memcpy(&local, self.offsets[b * buckets ..][0..buckets]);
+                const begin = blockBegin(b, self.num_blocks, self.src.len);
+                const end = blockBegin(b + 1, self.num_blocks, self.src.len);
+                for (self.src[begin..end]) |k| {
+                    const d = @as(u8, @truncate(k >> self.shift));
+                    self.dst[local[d]] = k;
+                    local[d] += 1;
+                }
+            }
+        };
+
+        var ctx = RadixCtx{
+            .src = keys,
+            .dst = scratch,
+            .offsets = offsets,
+            .num_blocks = num_blocks,
+            .shift = 0,
+        };
+
+        var shift: usize = 0;
+        while (shift < @bitSizeOf(T)) : (shift += 8) {
+            ctx.shift = @intCast(shift);
+            try runBlocks(pool, num_blocks, &ctx, RadixCtx.countBlock);
+
+            // Digit-major, block-minor offsets; skip the pass if all keys share a digit
+            var sum: usize = 0;
+            var skip = false;
+            for (0..buckets) |d| {
+                var digit_total: usize = 0;
+                for (0..num_blocks) |b| {
+                    const c = offsets[b * buckets + d];
+                    offsets[b * buckets + d] = sum;
+                    sum += c;
+                    digit_total += c;
+                }
+                if (digit_total == keys.len) {
+                    skip = true;
+                    break;
+                }
+            }
+            if (skip) continue;
+
+            try runBlocks(pool, num_blocks, &ctx, RadixCtx.scatterBlock);
+            std.mem.swap([]T, &ctx.src, &ctx.dst);
+        }
+
+        if (ctx.src.ptr != keys.ptr) {
+            @memcpy(keys, ctx.src);
+        }
+    }
+
+    fn scan(
+        comptime T: type,
+        pool: *ThreadPool,
+        input: []const T,
+        output: []T,
+        identity: T,
+        comptime op: fn (T, T) T,
+        comptime inclusive: bool,
+    ) !void {
+        std.debug.assert(output.len == input.len);
+        const num_blocks = blockCount(pool, input.len, blocks_per_thread);
+        const carry = try global_allocator.alloc(T, num_blocks);
+        defer global_allocator.free(carry);
+
+        const ScanCtx = struct {
+            input: []const T,
+            output: []T,
+            carry: []T,
+            identity: T,
+
+            fn reduceBlock(self: *@This(), b: usize) void {
+                const begin = blockBegin(b, self.carry.len, self.input.len);
+                const end = blockBegin(b + 1, self.carry.len, self.input.len);
+                var acc = self.identity;
+                for (self.input[begin..end]) |v| acc = op(acc, v);
+                self.carry[b] = acc;
+            }
+
+            fn applyBlock(self: *@This(), b: usize) void {
+                const begin = blockBegin(b, self.carry.len, self.input.len);
+                const end = blockBegin(b + 1, self.carry.len, self.input.len);
+                var acc = self.carry[b];
+                for (begin..end) |i| {
+                    const v = self.input[i];
+                    if (inclusive) {
+                        acc = op(acc, v);
+                        self.output[i] = acc;
+                    } else {
+                        self.output[i] = acc;
+                        acc = op(acc, v);
+                    }
+                }
+            }
+        };
+
+        var ctx = ScanCtx{ .input = input, .output = output, .carry = carry, .identity = identity };
+
+        if (num_blocks > 1) {
+            try runBlocks(pool, num_blocks, &ctx, ScanCtx.reduceBlock);
+            var acc = identity;
+            for (carry) |*c| {
+                const sum = c.*;
+                c.* = acc;
+                acc = op(acc, sum);
+            }
+        } else {
+            carry[0] = identity;
+        }
+
+        try runBlocks(pool, num_blocks, &ctx, ScanCtx.applyBlock);
+    }
+
+    /// output[i] = input[0] op ... op input[i]. output may alias input.
+    pub fn inclusiveScan(comptime T: type, pool: *ThreadPool, input: []const T, output: []T, identity: T, comptime op: fn (T, T) T) !void {
+        try scan(T, pool, input, output, identity, op, true);
+    }
+
+    /// output[0] = identity, output[i] = input[0] op ... op input[i-1]. output may alias input.
+    pub fn exclusiveScan(comptime T: type, pool: *ThreadPool, input: []const T, output: []T, identity: T, comptime op: fn (T, T) T) !void {
+        try scan(T, pool, input, output, identity, op, false);
+    }
+
+    /// Move items satisfying pred to the front, preserving relative order on
+    /// both sides. Returns the number of items satisfying pred.
+    pub fn stablePartition(
+        comptime T: type,
+        pool: *ThreadPool,
+        items: []T,
+        context: anytype,
+        comptime pred: fn (@TypeOf(context), T) bool,
+    ) !usize {
+        const Context = @TypeOf(context);
+        const num_blocks = blockCount(pool, items.len, blocks_per_thread);
+        const scratch = try global_allocator.alloc(T, items.len);
+        defer global_allocator.free(scratch);
+        const flags = try global_allocator.alloc(bool, items.len);
+        defer global_allocator.free(flags);
+        const offsets = try global_allocator.alloc(usize, num_blocks * 2);
+        defer global_allocator.free(offsets);
+
+        const PartitionCtx = struct {
+            items: []T,
+            scratch: []T,
+            flags: []bool,
+            true_offsets: []usize,
+            false_offsets: []usize,
+            context: Context,
+
+            fn countBlock(self: *@This(), b: usize) void {
+                const begin = blockBegin(b, self.true_offsets.len, self.items.len);
+                const end = blockBegin(b + 1, self.true_offsets.len, self.items.len);
+                var trues: usize = 0;
+                for (begin..end) |i| {
+                    self.flags[i] = pred(self.context, self.items[i]);
+                    trues += @intFromBool(self.flags[i]);
+                }
+                self.true_offsets[b] = trues;
+            }
+
+            fn scatterBlock(self: *@This(), b: usize) void {
+                const begin = blockBegin(b, self.true_offsets.len, self.items.len);
+                const end = blockBegin(b + 1, self.true_offsets.len, self.items.len);
+                var t = self.true_offsets[b];
+                var f = self.false_offsets[b];
+                for (begin..end) |i| {
+                    if (self.flags[i]) {
+                        self.scratch[t] = self.items[i];
+                        t += 1;
+                    } else {
+                        self.scratch[f] = self.items[i];
+                        f += 1;
+                    }
+                }
+            }
+
+            fn copyBlock(self: *@This(), b: usize) void {
+                const begin = blockBegin(b, self.true_offsets.len, self.items.len);
+                const end = blockBegin(b + 1, self.true_offsets.len, self.items.len);
+                @memcpy(self.items[begin..end], self.scratch[begin..end]);
+            }
+        };
+
+        var ctx = PartitionCtx{
+            .items = items,
+            .scratch = scratch,
+            .flags = flags,
+            .true_offsets = offsets[0..num_blocks],
+            .false_offsets = offsets[num_blocks..],
+            .context = context,
+        };
+
+        try runBlocks(pool, num_blocks, &ctx, PartitionCtx.countBlock);
+
+        var total_true: usize = 0;
+        for (ctx.true_offsets) |c| total_true += c;
+        var true_prefix: usize = 0;
+        for (0..num_blocks) |b| {
+            const trues = ctx.true_offsets[b];
+            ctx.true_offsets[b] = true_prefix;
+            ctx.false_offsets[b] = total_true + (blockBegin(b, num_blocks, items.len) - true_prefix);
+            true_prefix += trues;
+        }
+
+        try runBlocks(pool, num_blocks, &ctx, PartitionCtx.scatterBlock);
+        try runBlocks(pool, num_blocks, &ctx, PartitionCtx.copyBlock);
+        return total_true;
+    }
+
+    /// Count items per bin using one private histogram per block. Items whose
+    /// bin is out of range are dropped. bins is overwritten.
+    pub fn histogram(
+        comptime T: type,
+        pool: *ThreadPool,
+        items: []const T,
+        bins: []u64,
+        context: anytype,
+        comptime binFn: fn (@TypeOf(context), T) usize,
+    ) !void {
+        const Context = @TypeOf(context);
+        const num_blocks = blockCount(pool, items.len, 1);
+        // Pad rows to a cache line so private histograms never share one
+        const stride = std.mem.alignForward(usize, bins.len, 8);
+        const local = try global_allocator.alloc(u64, num_blocks * stride);
+        defer global_allocator.free(local);
+        @memset(local, 0);
+
+        const HistogramCtx = struct {
+            items: []const T,
+            bins: []u64,
+            local: []u64,
+            stride: usize,
+            num_blocks: usize,
+            context: Context,
+
+            fn fillBlock(self: *@This(), b: usize) void {
+                const row = self.local[b * self.stride ..][0..self.bins.len];
+                const begin = blockBegin(b, self.num_blocks, self.items.len);
+                const end = blockBegin(b + 1, self.num_blocks, self.items.len);
+                for (self.items[begin..end]) |item| {
+                    const idx = binFn(self.context, item);
+                    if (idx < row.len) row[idx] += 1;
+                }
+            }
+        };
+
+        var ctx = HistogramCtx{
+            .items = items,
+            .bins = bins,
+            .local = local,
+            .stride = stride,
+            .num_blocks = num_blocks,
+            .context = context,
+        };
+
+        try runBlocks(pool, num_blocks, &ctx, HistogramCtx.fillBlock);
+
+        for (bins, 0..) |*bin, i| {
+            var sum: u64 = 0;
+            for (0..num_blocks) |b| sum += local[b * stride + i];
+            bin.* = sum;
+        }
+    }
+};
+
 // Exported C API functions
 
 export fn memoryInit() bool {
@@ -3,6 +3,9 @@
  * @brief Implementation of concurrency safety functions for the Goo language runtime
  */
 
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
 #include "../../include/goo_concurrency.h"
 
 /* Thread-local error information */
@@ -300,21 +303,50 @@ int goo_rwlock_write_release(GooRWLock* lock) {
 
 /* Lock-free queue functions */
 
+/* From memory/goo_concurrent_pool.h, whose allocator header redefines the
+ * allocation enums goo_core.h already provides */
+typedef struct GooConcurrentPool GooConcurrentPool;
+GooConcurrentPool* goo_concurrent_pool_create(GooAllocator* parent, size_t chunk_size, size_t alignment);
+void* goo_concurrent_pool_alloc(GooConcurrentPool* pool);
+void goo_concurrent_pool_free(GooConcurrentPool* pool, void* ptr);
+
+/* Queue nodes come from one process-wide pool so retired nodes can be
+ * reclaimed after their queue is destroyed */
+static GooConcurrentPool* queue_node_pool = NULL;
+static pthread_once_t queue_node_pool_once = PTHREAD_ONCE_INIT;
+
+static void queue_node_pool_init(void) {
+    queue_node_pool = goo_concurrent_pool_create(NULL, sizeof(GooQueueNode), _Alignof(GooQueueNode));
+}
+
+static GooQueueNode* queue_node_alloc(void* data) {
+    pthread_once(&queue_node_pool_once, queue_node_pool_init);
+    if (!queue_node_pool) return NULL;
+
+    GooQueueNode* node = goo_concurrent_pool_alloc(queue_node_pool);
+    if (!node) return NULL;
+
+    node->data = data;
+    atomic_init(&node->next, NULL);
+    return node;
+}
+
+static void queue_node_reclaim(void* node) {
+    goo_concurrent_pool_free(queue_node_pool, node);
+}
+
 int goo_lockfree_queue_init(GooLockFreeQueue* queue) {
     if (!queue) {
         goo_set_error(EINVAL, "Null pointer passed to goo_lockfree_queue_init");
         return EINVAL;
     }
     
-    GooQueueNode* dummy = malloc(sizeof(GooQueueNode));
+    GooQueueNode* dummy = queue_node_alloc(NULL);
     if (!dummy) {
         goo_set_error(ENOMEM, "Failed to allocate dummy node in goo_lockfree_queue_init");
         return ENOMEM;
     }
     
-    dummy->data = NULL;
-    atomic_init(&dummy->next, NULL);
-    
     atomic_init(&queue->head, dummy);
     atomic_init(&queue->tail, dummy);
     
@@ -327,11 +359,11 @@ int goo_lockfree_queue_destroy(GooLockFreeQueue* queue) {
         return EINVAL;
     }
     
-    /* Free all nodes in the queue */
+    /* No thread may still be using the queue, so nodes go straight back */
     GooQueueNode* current = atomic_load(&queue->head);
     while (current) {
         GooQueueNode* next = atomic_load(&current->next);
-        free(current);
+        queue_node_reclaim(current);
         current = next;
     }
     
@@ -347,18 +379,17 @@ int goo_lockfree_queue_push(GooLockFreeQueue* queue, void* data) {
         return EINVAL;
     }
     
-    GooQueueNode* node = malloc(sizeof(GooQueueNode));
+    GooQueueNode* node = queue_node_alloc(data);
     if (!node) {
         goo_set_error(ENOMEM, "Failed to allocate node in goo_lockfree_queue_push");
         return ENOMEM;
     }
     
-    node->data = data;
-    atomic_init(&node->next, NULL);
-    
     GooQueueNode* tail;
     GooQueueNode* next;
     
+    /* Pinned: the tail we read cannot be reclaimed under us */
+    goo_epoch_enter();
     while (1) {
         tail = atomic_load(&queue->tail);
         next = atomic_load(&tail->next);
@@ -379,6 +410,7 @@ int goo_lockfree_queue_push(GooLockFreeQueue* queue, void* data) {
     
     /* Try to update the tail */
     atomic_compare_exchange_weak(&queue->tail, &tail, node);
+    goo_epoch_exit();
     
     return 0;
 }
@@ -394,6 +426,8 @@ int goo_lockfree_queue_pop(GooLockFreeQueue* queue, void** data_out) {
     GooQueueNode* tail;
     GooQueueNode* next;
     
+    /* Pinned: head and next stay valid even if another thread pops them */
+    goo_epoch_enter();
     while (1) {
         head = atomic_load(&queue->head);
         tail = atomic_load(&queue->tail);
@@ -404,26 +438,23 @@ int goo_lockfree_queue_pop(GooLockFreeQueue* queue, void** data_out) {
             /* Is queue empty or tail falling behind? */
             if (head == tail) {
                 if (next == NULL) {
-                    /* Queue is empty */
-                    goo_set_error(ENODATA, "Queue is empty in goo_lockfree_queue_pop");
+                    /* Queue is empty; an expected outcome, not a thread error */
+                    goo_epoch_exit();
                     return ENODATA;
                 }
                 /* Tail is falling behind, try to advance it */
                 atomic_compare_exchange_weak(&queue->tail, &tail, next);
-            } else {
-                /* Try to get the data before CAS, since we're about to free head */
+            } else if (atomic_compare_exchange_weak(&queue->head, &head, next)) {
+                /* next is the new dummy; its data was set before it was linked */
                 *data_out = next->data;
-                
-                /* Try to advance head */
-                if (atomic_compare_exchange_weak(&queue->head, &head, next)) {
-                    break;
-                }
+                break;
             }
         }
     }
     
-    /* Free the old dummy node */
-    free(head);
+    /* Readers pinned before the CAS may still hold the old dummy */
+    goo_epoch_retire(head, queue_node_reclaim);
+    goo_epoch_exit();
     
     return 0;
 }
@@ -434,8 +465,10 @@ bool goo_lockfree_queue_is_empty(GooLockFreeQueue* queue) {
         return true;
     }
     
+    goo_epoch_enter();
     GooQueueNode* head = atomic_load(&queue->head);
     GooQueueNode* next = atomic_load(&head->next);
+    goo_epoch_exit();
     
     return next == NULL;
 }
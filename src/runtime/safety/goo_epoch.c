@@ -0,0 +1,236 @@
+/**
+ * @file goo_epoch.c
+ * @brief Epoch-based memory reclamation for lock-free data structures
+ *
+ * A thread pins itself before dereferencing shared nodes and unpins when
+ * done. Unlinked nodes are retired into a per-thread bag tagged with the
+ * global epoch. The epoch only advances once every pinned thread has
+ * observed the current one, so a bag retired in epoch e can be reclaimed once
+ * the global epoch reaches e + 2: no thread can still hold a reference.
+ */
+
+#include "../../include/goo_concurrency.h"
+#include <sched.h>
+
+/* Retirements between attempts to advance the epoch */
+#define EPOCH_ADVANCE_INTERVAL 64
+
+/* Bags per thread: the current epoch and the two that may still be read */
+#define EPOCH_BAGS 3
+
+typedef struct {
+    void* ptr;
+    GooReclaimFn reclaim;
+} RetiredObject;
+
+typedef struct {
+    RetiredObject* items;
+    size_t count;
+    size_t capacity;
+    uint64_t epoch;                 /* Epoch the items were retired in */
+} RetireBag;
+
+/* Per-thread record; records are reused by later threads, never freed */
+typedef struct EpochRecord {
+    _Atomic uint64_t state;         /* (epoch << 1) | 1 while pinned, 0 otherwise */
+    atomic_bool in_use;             /* Owned by a live thread */
+    struct EpochRecord* next;       /* Registry link */
+    uint32_t nesting;               /* Pin depth */
+    uint32_t since_advance;         /* Retirements since the last advance attempt */
+    RetireBag bags[EPOCH_BAGS];
+} EpochRecord;
+
+static _Atomic uint64_t global_epoch = 1;
+static _Atomic(EpochRecord*) epoch_records = NULL;
+
+static _Thread_local EpochRecord* epoch_record = NULL;
+static pthread_key_t epoch_record_key;
+static pthread_once_t epoch_record_once = PTHREAD_ONCE_INIT;
+
+/* Release the calling thread's record at thread exit; unreclaimed bags stay
+ * with the record and are reclaimed by the next thread that takes it */
+static void epoch_thread_exit(void* data) {
+    EpochRecord* record = (EpochRecord*)data;
+    record->nesting = 0;
+    atomic_store_explicit(&record->state, 0, memory_order_release);
+    epoch_record = NULL;
+    atomic_store_explicit(&record->in_use, false, memory_order_release);
+}
+
+static void epoch_init_key(void) {
+    pthread_key_create(&epoch_record_key, epoch_thread_exit);
+}
+
+static EpochRecord* epoch_acquire_record(void) {
+    pthread_once(&epoch_record_once, epoch_init_key);
+
+    /* Reuse a record released by an exited thread */
+    EpochRecord* record = atomic_load_explicit(&epoch_records, memory_order_acquire);
+    for (; record; record = record->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&record->in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong(&record->in_use, &expected, true)) {
+            break;
+        }
+    }
+
+    if (!record) {
+        record = calloc(1, sizeof(EpochRecord));
+        if (!record) {
+            goo_set_error(ENOMEM, "Failed to allocate epoch record");
+            return NULL;
+        }
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, true);
+
+        EpochRecord* head = atomic_load_explicit(&epoch_records, memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&epoch_records, &head, record,
+                                                        memory_order_release, memory_order_relaxed));
+    }
+
+    pthread_setspecific(epoch_record_key, record);
+    epoch_record = record;
+    return record;
+}
+
+static inline EpochRecord* epoch_get_record(void) {
+    return epoch_record ? epoch_record : epoch_acquire_record();
+}
+
+/* Run a bag's reclaim functions; reclaiming may retire more objects */
+static void epoch_reclaim_bag(RetireBag* bag) {
+    RetiredObject* items = bag->items;
+    size_t count = bag->count;
+    size_t capacity = bag->capacity;
+
+    bag->items = NULL;
+    bag->count = 0;
+    bag->capacity = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        items[i].reclaim(items[i].ptr);
+    }
+
+    /* Keep the array unless a nested retirement already replaced it */
+    if (!bag->items) {
+        bag->items = items;
+        bag->capacity = capacity;
+    } else {
+        free(items);
+    }
+}
+
+/* Reclaim every bag at least two epochs old */
+static void epoch_reclaim_safe(EpochRecord* record) {
+    uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_acquire);
+    for (int i = 0; i < EPOCH_BAGS; i++) {
+        RetireBag* bag = &record->bags[i];
+        if (bag->count > 0 && bag->epoch + 2 <= epoch) {
+            epoch_reclaim_bag(bag);
+        }
+    }
+}
+
+bool goo_epoch_try_advance(void) {
+    uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_relaxed);
+
+    /* Pairs with the fence in goo_epoch_enter */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    EpochRecord* record = atomic_load_explicit(&epoch_records, memory_order_acquire);
+    for (; record; record = record->next) {
+        uint64_t state = atomic_load_explicit(&record->state, memory_order_relaxed);
+        if ((state & 1) && (state >> 1) != epoch) {
+            return false;
+        }
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_compare_exchange_strong_explicit(&global_epoch, &epoch, epoch + 1,
+                                                   memory_order_release, memory_order_relaxed);
+}
+
+void goo_epoch_enter(void) {
+    EpochRecord* record = epoch_get_record();
+    if (!record) return;
+
+    if (record->nesting++ == 0) {
+        uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_relaxed);
+        atomic_store_explicit(&record->state, (epoch << 1) | 1, memory_order_relaxed);
+
+        /* The pin must be visible before any shared pointer is read */
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+void goo_epoch_exit(void) {
+    EpochRecord* record = epoch_record;
+    if (!record || record->nesting == 0) return;
+
+    if (--record->nesting == 0) {
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+    }
+}
+
+void goo_epoch_retire(void* ptr, GooReclaimFn reclaim) {
+    if (!ptr || !reclaim) return;
+
+    EpochRecord* record = epoch_get_record();
+    if (!record) return;
+
+    uint64_t epoch = atomic_load_explicit(&global_epoch, memory_order_acquire);
+    RetireBag* bag = &record->bags[epoch % EPOCH_BAGS];
+
+    /* A bag for an older epoch in this slot is at least three epochs old */
+    if (bag->epoch != epoch) {
+        if (bag->count > 0) {
+            epoch_reclaim_bag(bag);
+        }
+        bag->epoch = epoch;
+    }
+
+    if (bag->count == bag->capacity) {
+        size_t capacity = bag->capacity ? bag->capacity * 2 : EPOCH_ADVANCE_INTERVAL;
+        RetiredObject* items = realloc(bag->items, capacity * sizeof(RetiredObject));
+        if (!items) {
+            /* Leaking is the only safe option while readers may be active */
+            goo_set_error(ENOMEM, "Failed to grow epoch retire list");
+            return;
+        }
+        bag->items = items;
+        bag->capacity = capacity;
+    }
+
+    bag->items[bag->count].ptr = ptr;
+    bag->items[bag->count].reclaim = reclaim;
+    bag->count++;
+
+    if (++record->since_advance >= EPOCH_ADVANCE_INTERVAL) {
+        record->since_advance = 0;
+        goo_epoch_try_advance();
+        epoch_reclaim_safe(record);
+    }
+}
+
+int goo_epoch_synchronize(void) {
+    EpochRecord* record = epoch_get_record();
+    if (!record) return ENOMEM;
+
+    if (record->nesting > 0) {
+        goo_set_error(EDEADLK, "goo_epoch_synchronize called while pinned");
+        return EDEADLK;
+    }
+
+    /* Two advances retire everything this thread retired before the call */
+    uint64_t target = atomic_load_explicit(&global_epoch, memory_order_acquire) + 2;
+    while (atomic_load_explicit(&global_epoch, memory_order_acquire) < target) {
+        if (!goo_epoch_try_advance()) {
+            sched_yield();
+        }
+    }
+
+    epoch_reclaim_safe(record);
+    return 0;
+}
@@ -1,51 +1,72 @@
 /**
  * scope.c
- * 
+ *
  * Implementation of the scope-based resource management system for Goo.
  * This provides automatic cleanup of resources when execution exits a scope.
+ *
+ * Each thread keeps one contiguous stack of cleanup entries and a stack of
+ * scope start indices, reached through a __thread pointer. Both start in
+ * inline storage and grow geometrically, so registering a cleanup is an
+ * append and exiting a scope walks back to the saved index.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
-#include "memory/memory.h"
+#include "memory.h"
 #include "scope/scope.h"
 
-// Maximum number of scopes that can be nested
-#define MAX_SCOPE_DEPTH 128
+// Entries and scopes held before the first heap growth
+#define SCOPE_INLINE_ENTRIES 32
+#define SCOPE_INLINE_DEPTH 16
 
-// Cleanup entry structure
+// Unwind passes at thread exit for cleanups that register more cleanups
+#define SCOPE_EXIT_PASSES 4
+
+// Cleanup entry; a NULL cleanup_fn frees data as memory
 typedef struct GooCleanupEntry {
-    void* data;                  // User data for cleanup
     void (*cleanup_fn)(void*);   // Cleanup function
-    struct GooCleanupEntry* next; // Next entry in the list
+    void* data;                  // User data for cleanup, or the memory to free
+    size_t size;                 // Memory entries: allocation size
+    size_t alignment;            // Memory entries: alignment (0 for default)
 } GooCleanupEntry;
 
-// Scope structure
-typedef struct GooScope {
-    GooCleanupEntry* cleanup_list; // List of cleanup entries
-    struct GooScope* parent;       // Parent scope
-} GooScope;
+// Per-thread cleanup stack
+typedef struct GooScopeStack {
+    GooCleanupEntry* entries;    // Registered cleanups, oldest first
+    size_t count;
+    size_t capacity;
+    size_t* marks;               // Entry count when each open scope was entered
+    size_t depth;
+    size_t mark_capacity;
+    GooCleanupEntry inline_entries[SCOPE_INLINE_ENTRIES];
+    size_t inline_marks[SCOPE_INLINE_DEPTH];
+} GooScopeStack;
+
+static __thread GooScopeStack* scope_stack = NULL;
 
-// Thread-local current scope
-static pthread_key_t current_scope_key;
+// Key used only to tear a thread's stack down when the thread exits
+static pthread_key_t scope_stack_key;
 static pthread_once_t key_once = PTHREAD_ONCE_INIT;
 static bool system_initialized = false;
 
 // Forward declarations
 static void create_tls_key(void);
 static void destroy_tls_data(void* data);
-static GooScope* get_current_scope(void);
+static GooScopeStack* get_scope_stack(void);
+static bool register_entry(void (*cleanup_fn)(void*), void* data, size_t size, size_t alignment);
+static void unwind_to(GooScopeStack* stack, size_t mark);
 
 /**
  * Initialize the scope system.
  */
 bool goo_scope_init(void) {
     if (system_initialized) return true;
-    
-    // Initialize the thread-local storage key
+
+    // Initialize the thread-exit key
     pthread_once(&key_once, create_tls_key);
-    
+
     system_initialized = true;
     return true;
 }
@@ -55,13 +76,12 @@ bool goo_scope_init(void) {
  */
 void goo_scope_cleanup(void) {
     if (!system_initialized) return;
-    
+
     // Clean up the current scope
-    GooScope* scope = get_current_scope();
-    if (scope) {
+    if (scope_stack && scope_stack->depth > 0) {
         goo_scope_exit();
     }
-    
+
     system_initialized = false;
 }
 
@@ -74,21 +94,28 @@ bool goo_scope_enter(void) {
             return false;
         }
     }
-    
-    // Get the current scope
-    GooScope* current = get_current_scope();
-    
-    // Create a new scope
-    GooScope* scope = (GooScope*)malloc(sizeof(GooScope));
-    if (!scope) return false;
-    
-    // Initialize the new scope
-    scope->cleanup_list = NULL;
-    scope->parent = current;
-    
-    // Set as current scope
-    pthread_setspecific(current_scope_key, scope);
-    
+
+    GooScopeStack* stack = get_scope_stack();
+    if (!stack) return false;
+
+    // Grow the mark stack geometrically, leaving inline storage on first growth
+    if (stack->depth == stack->mark_capacity) {
+        size_t capacity = stack->mark_capacity * 2;
+        size_t* marks;
+        if (stack->marks == stack->inline_marks) {
+            marks = (size_t*)malloc(capacity * sizeof(size_t));
+            if (marks) memcpy(marks, stack->marks, stack->depth * sizeof(size_t));
+        } else {
+            marks = (size_t*)realloc(stack->marks, capacity * sizeof(size_t));
+        }
+        if (!marks) return false;
+
+        stack->marks = marks;
+        stack->mark_capacity = capacity;
+    }
+
+    // Remember where this scope's cleanups start
+    stack->marks[stack->depth++] = stack->count;
     return true;
 }
 
@@ -96,31 +123,12 @@ bool goo_scope_enter(void) {
  * Exit the current scope and clean up resources.
  */
 void goo_scope_exit(void) {
-    // Get the current scope
-    GooScope* scope = get_current_scope();
-    if (!scope) return;
-    
-    // Set the parent as current
-    pthread_setspecific(current_scope_key, scope->parent);
-    
-    // Clean up resources in reverse order of registration
-    GooCleanupEntry* entry = scope->cleanup_list;
-    while (entry) {
-        GooCleanupEntry* next = entry->next;
-        
-        // Call the cleanup function
-        if (entry->cleanup_fn && entry->data) {
-            entry->cleanup_fn(entry->data);
-        }
-        
-        // Free the entry
-        free(entry);
-        
-        entry = next;
-    }
-    
-    // Free the scope itself
-    free(scope);
+    GooScopeStack* stack = scope_stack;
+    if (!stack || stack->depth == 0) return;
+
+    // Pop the scope first so cleanups that register run in the parent
+    size_t mark = stack->marks[--stack->depth];
+    unwind_to(stack, mark);
 }
 
 /**
@@ -128,77 +136,140 @@ void goo_scope_exit(void) {
  */
 bool goo_scope_register_cleanup(void* data, void (*cleanup_fn)(void*)) {
     if (!cleanup_fn) return false;
-    
-    // Get the current scope
-    GooScope* scope = get_current_scope();
-    if (!scope) {
+
+    return register_entry(cleanup_fn, data, 0, 0);
+}
+
+/**
+ * Register memory to free when the current scope exits.
+ */
+bool goo_scope_register_memory(void* ptr, size_t size, size_t alignment) {
+    if (!ptr) return false;
+
+    return register_entry(NULL, ptr, size, alignment);
+}
+
+/**
+ * Append a cleanup entry to the current scope.
+ */
+static bool register_entry(void (*cleanup_fn)(void*), void* data, size_t size, size_t alignment) {
+    GooScopeStack* stack = scope_stack;
+    if (!stack || stack->depth == 0) {
         // No scope active, create one
         if (!goo_scope_enter()) {
             return false;
         }
-        scope = get_current_scope();
+        stack = scope_stack;
     }
-    
-    // Create a new cleanup entry
-    GooCleanupEntry* entry = (GooCleanupEntry*)malloc(sizeof(GooCleanupEntry));
-    if (!entry) return false;
-    
-    // Initialize the entry
-    entry->data = data;
+
+    // Grow the entry stack geometrically, leaving inline storage on first growth
+    if (stack->count == stack->capacity) {
+        size_t capacity = stack->capacity * 2;
+        GooCleanupEntry* entries;
+        if (stack->entries == stack->inline_entries) {
+            entries = (GooCleanupEntry*)malloc(capacity * sizeof(GooCleanupEntry));
+            if (entries) memcpy(entries, stack->entries, stack->count * sizeof(GooCleanupEntry));
+        } else {
+            entries = (GooCleanupEntry*)realloc(stack->entries, capacity * sizeof(GooCleanupEntry));
+        }
+        if (!entries) return false;
+
+        stack->entries = entries;
+        stack->capacity = capacity;
+    }
+
+    GooCleanupEntry* entry = &stack->entries[stack->count++];
     entry->cleanup_fn = cleanup_fn;
-    
-    // Add to the front of the list (will be cleaned up in reverse order)
-    entry->next = scope->cleanup_list;
-    scope->cleanup_list = entry;
-    
+    entry->data = data;
+    entry->size = size;
+    entry->alignment = alignment;
+
     return true;
 }
 
 /**
- * Create the thread-local storage key.
+ * Run and pop entries above mark, newest first. Entries a cleanup registers
+ * belong to the scope that is current once the unwound one has been popped,
+ * so they are kept rather than run here.
+ */
+static void unwind_to(GooScopeStack* stack, size_t mark) {
+    size_t top = stack->count;
+
+    for (size_t i = top; i > mark; i--) {
+        // Copy out first: a cleanup may register entries and grow the stack
+        GooCleanupEntry entry = stack->entries[i - 1];
+
+        if (!entry.data) continue;
+
+        if (entry.cleanup_fn) {
+            entry.cleanup_fn(entry.data);
+        } else if (entry.alignment > 0) {
+            goo_free_aligned(entry.data, entry.size, entry.alignment);
+        } else {
+            goo_free(entry.data, entry.size);
+        }
+    }
+
+    // Slide late registrations down over the entries just run, along with
+    // any scope a cleanup had to open to hold them
+    size_t added = stack->count - top;
+    if (added > 0) {
+        memmove(&stack->entries[mark], &stack->entries[top], added * sizeof(GooCleanupEntry));
+        for (size_t i = 0; i < stack->depth; i++) {
+            if (stack->marks[i] >= top) stack->marks[i] -= top - mark;
+        }
+    }
+    stack->count = mark + added;
+}
+
+/**
+ * Create the thread-exit key.
  */
 static void create_tls_key(void) {
-    pthread_key_create(&current_scope_key, destroy_tls_data);
+    pthread_key_create(&scope_stack_key, destroy_tls_data);
 }
 
 /**
- * Destructor for thread-local storage data.
+ * Destructor for a thread's cleanup stack.
  */
 static void destroy_tls_data(void* data) {
     if (!data) return;
-    
-    // Clean up all scopes in the thread
-    GooScope* scope = (GooScope*)data;
-    while (scope) {
-        GooScope* parent = scope->parent;
-        
-        // Clean up resources in the scope
-        GooCleanupEntry* entry = scope->cleanup_list;
-        while (entry) {
-            GooCleanupEntry* next = entry->next;
-            
-            // Call the cleanup function
-            if (entry->cleanup_fn && entry->data) {
-                entry->cleanup_fn(entry->data);
-            }
-            
-            // Free the entry
-            free(entry);
-            
-            entry = next;
-        }
-        
-        // Free the scope
-        free(scope);
-        
-        scope = parent;
+
+    // Clean up all scopes in the thread; cleanups that register more get a
+    // bounded number of further passes, like pthread key destructors
+    GooScopeStack* stack = (GooScopeStack*)data;
+    for (int pass = 0; pass < SCOPE_EXIT_PASSES && stack->count > 0; pass++) {
+        stack->depth = 0;
+        unwind_to(stack, 0);
     }
+    if (stack->count > 0) {
+        fprintf(stderr, "Warning: %zu scope cleanups still registered at thread exit\n", stack->count);
+    }
+    stack->depth = 0;
+
+    scope_stack = NULL;
+    if (stack->entries != stack->inline_entries) free(stack->entries);
+    if (stack->marks != stack->inline_marks) free(stack->marks);
+    free(stack);
 }
 
 /**
- * Get the current scope.
+ * Get the calling thread's cleanup stack, creating it on first use.
  */
-static GooScope* get_current_scope(void) {
-    if (!system_initialized) return NULL;
-    return (GooScope*)pthread_getspecific(current_scope_key);
-} 
\ No newline at end of file
+static GooScopeStack* get_scope_stack(void) {
+    if (scope_stack) return scope_stack;
+
+    GooScopeStack* stack = (GooScopeStack*)malloc(sizeof(GooScopeStack));
+    if (!stack) return NULL;
+
+    stack->entries = stack->inline_entries;
+    stack->count = 0;
+    stack->capacity = SCOPE_INLINE_ENTRIES;
+    stack->marks = stack->inline_marks;
+    stack->depth = 0;
+    stack->mark_capacity = SCOPE_INLINE_DEPTH;
+
+    pthread_setspecific(scope_stack_key, stack);
+    scope_stack = stack;
+    return stack;
+}
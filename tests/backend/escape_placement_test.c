@@ -0,0 +1,300 @@
+/**
+ * escape_placement_test.c
+ *
+ * Runs escape analysis over hand-built ASTs and checks the recorded states,
+ * then lowers allocations through codegen_memory.c and checks the emitted
+ * IR: non-escaping small blocks become allocas, non-escaping large blocks
+ * come from the call arena, and anything that escapes (including through
+ * an alias) stays on goo_alloc.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/Analysis.h>
+#include "codegen.h"
+#include "codegen_memory.h"
+#include "ast.h"
+#include "escape_analysis.h"
+
+// Identifier node as built by the parser (see ast_helpers.c)
+typedef struct {
+    GooNode base;
+    char* name;
+} TestIdentNode;
+
+// AST nodes are never freed; the test process is short-lived
+static GooNode* node_alloc(size_t size, GooNodeType type) {
+    GooNode* node = calloc(1, size);
+    if (!node) {
+        perror("calloc");
+        exit(1);
+    }
+    node->type = type;
+    return node;
+}
+
+static GooNode* ident(const char* name) {
+    TestIdentNode* node = (TestIdentNode*)node_alloc(sizeof(TestIdentNode), GOO_NODE_IDENTIFIER);
+    node->name = strdup(name);
+    return &node->base;
+}
+
+static GooNode* alloc_decl(const char* name) {
+    GooAllocExprNode* alloc = (GooAllocExprNode*)node_alloc(sizeof(GooAllocExprNode), GOO_NODE_ALLOC_EXPR);
+    alloc->type = node_alloc(sizeof(GooTypeNode), GOO_NODE_TYPE_EXPR);
+    GooVarDeclNode* decl = (GooVarDeclNode*)node_alloc(sizeof(GooVarDeclNode), GOO_NODE_VAR_DECL);
+    decl->name = strdup(name);
+    decl->init_expr = &alloc->base;
+    return &decl->base;
+}
+
+static GooNode* var_decl(const char* name, GooNode* init) {
+    GooVarDeclNode* decl = (GooVarDeclNode*)node_alloc(sizeof(GooVarDeclNode), GOO_NODE_VAR_DECL);
+    decl->name = strdup(name);
+    decl->init_expr = init;
+    return &decl->base;
+}
+
+static GooNode* call(const char* func, GooNode* arg) {
+    GooCallExprNode* node = (GooCallExprNode*)node_alloc(sizeof(GooCallExprNode), GOO_NODE_CALL_EXPR);
+    node->func = ident(func);
+    node->args = arg;
+    return &node->base;
+}
+
+static GooNode* ret(GooNode* expr) {
+    GooReturnStmtNode* node = (GooReturnStmtNode*)node_alloc(sizeof(GooReturnStmtNode), GOO_NODE_RETURN_STMT);
+    node->expr = expr;
+    return &node->base;
+}
+
+static GooNode* free_stmt(GooNode* expr) {
+    GooFreeExprNode* node = (GooFreeExprNode*)node_alloc(sizeof(GooFreeExprNode), GOO_NODE_FREE_EXPR);
+    node->expr = expr;
+    return &node->base;
+}
+
+static GooNode* go_stmt(GooNode* expr) {
+    GooGoStmtNode* node = (GooGoStmtNode*)node_alloc(sizeof(GooGoStmtNode), GOO_NODE_GO_STMT);
+    node->expr = expr;
+    return &node->base;
+}
+
+static GooNode* binary(GooNode* left, int op, GooNode* right) {
+    GooBinaryExprNode* node = (GooBinaryExprNode*)node_alloc(sizeof(GooBinaryExprNode), GOO_NODE_BINARY_EXPR);
+    node->left = left;
+    node->operator = op;
+    node->right = right;
+    return &node->base;
+}
+
+// Link statements into a function declaration; the list ends with NULL
+static GooNode* function(const char* name, ...) {
+    GooBlockStmtNode* body = (GooBlockStmtNode*)node_alloc(sizeof(GooBlockStmtNode), GOO_NODE_BLOCK_STMT);
+    GooNode** tail = &body->statements;
+
+    va_list args;
+    va_start(args, name);
+    GooNode* stmt;
+    while ((stmt = va_arg(args, GooNode*)) != NULL) {
+        *tail = stmt;
+        tail = &stmt->next;
+    }
+    va_end(args);
+
+    GooFunctionNode* func = (GooFunctionNode*)node_alloc(sizeof(GooFunctionNode), GOO_NODE_FUNCTION_DECL);
+    func->name = strdup(name);
+    func->body = &body->base;
+    return &func->base;
+}
+
+// Build the test module's AST and analyze it
+static void analyze_test_module(GooAst* ast) {
+    GooNode* functions[] = {
+        // Used only locally and freed
+        function("local_small", alloc_decl("p"), free_stmt(ident("p")), NULL),
+        function("local_large", alloc_decl("big"), free_stmt(ident("big")), NULL),
+        // q := p; return q
+        function("returns_alias", alloc_decl("p"), var_decl("q", ident("p")), ret(ident("q")), NULL),
+        function("returns_direct", alloc_decl("p"), ret(ident("p")), NULL),
+        function("passes_arg", alloc_decl("p"), call("keep", ident("p")), NULL),
+        function("spawns", alloc_decl("p"), go_stmt(call("work", ident("p"))), NULL),
+        // Pointer arithmetic copies the pointer
+        function("arith", alloc_decl("p"), var_decl("n", binary(ident("p"), '+', ident("p"))), NULL),
+        // A node the analysis can't see into may hold the pointer
+        function("opaque", alloc_decl("p"), node_alloc(sizeof(GooSIMDOpNode), GOO_NODE_SIMD_OP_DECL), NULL),
+        // Redeclaring the name mixes two values
+        function("shadowed", alloc_decl("p"), var_decl("p", ident("other")), NULL),
+    };
+
+    memset(ast, 0, sizeof(*ast));
+    GooNode** tail = &ast->declarations;
+    for (size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        *tail = functions[i];
+        tail = &functions[i]->next;
+    }
+    ast->root = ast->declarations;
+
+    optimize_escape_analysis(ast);
+}
+
+static bool expect_state(const char* function_name, const char* var_name, AllocEscapeState expected) {
+    AllocEscapeState state;
+    if (!escape_analysis_lookup(function_name, var_name, &state)) {
+        fprintf(stderr, "%s.%s was not analyzed\n", function_name, var_name);
+        return false;
+    }
+    if (state != expected) {
+        fprintf(stderr, "%s.%s: state %d, expected %d\n", function_name, var_name, state, expected);
+        return false;
+    }
+    return true;
+}
+
+static bool test_escape_states(void) {
+    printf("Testing escape states...\n");
+
+    bool ok = true;
+    ok &= expect_state("local_small", "p", ALLOC_NO_ESCAPE);
+    ok &= expect_state("local_large", "big", ALLOC_NO_ESCAPE);
+    ok &= expect_state("returns_alias", "p", ALLOC_GLOBAL_ESCAPE);
+    ok &= expect_state("returns_direct", "p", ALLOC_RETURN_ESCAPE);
+    ok &= expect_state("passes_arg", "p", ALLOC_ARG_ESCAPE);
+    ok &= expect_state("spawns", "p", ALLOC_GOROUTINE_ESCAPE);
+    ok &= expect_state("arith", "p", ALLOC_GLOBAL_ESCAPE);
+    ok &= expect_state("opaque", "p", ALLOC_GLOBAL_ESCAPE);
+    ok &= expect_state("shadowed", "p", ALLOC_GLOBAL_ESCAPE);
+
+    // Only variables bound to an allocation are recorded
+    if (escape_analysis_lookup("returns_alias", "q", NULL)) {
+        fprintf(stderr, "returns_alias.q is not an allocation but was recorded\n");
+        ok = false;
+    }
+    return ok;
+}
+
+// Runtime functions codegen_memory.c calls through the code generator
+LLVMValueRef goo_codegen_get_function(GooCodegenContext* context, const char* name) {
+    LLVMValueRef func = LLVMGetNamedFunction(context->module, name);
+    if (func) return func;
+
+    LLVMTypeRef i64_type = LLVMInt64TypeInContext(context->context);
+    LLVMTypeRef i8_ptr_type = LLVMPointerType(LLVMInt8TypeInContext(context->context), 0);
+    if (strcmp(name, "goo_alloc") == 0) {
+        return LLVMAddFunction(context->module, name, LLVMFunctionType(i8_ptr_type, &i64_type, 1, false));
+    }
+    if (strcmp(name, "goo_free") == 0) {
+        LLVMTypeRef params[2] = { i8_ptr_type, i64_type };
+        return LLVMAddFunction(context->module, name,
+                               LLVMFunctionType(LLVMInt32TypeInContext(context->context), params, 2, false));
+    }
+    return NULL;
+}
+
+// Generate one function that allocates size bytes into var_name and frees it
+static LLVMValueRef emit_function(GooCodegenContext* context, const char* name, const char* var_name,
+                                  unsigned long long size) {
+    LLVMTypeRef func_type = LLVMFunctionType(LLVMVoidTypeInContext(context->context), NULL, 0, false);
+    LLVMValueRef function = LLVMAddFunction(context->module, name, func_type);
+    LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(context->context, function, "entry");
+    LLVMPositionBuilderAtEnd(context->builder, entry);
+
+    goo_codegen_memory_function_begin(context, function, name);
+    LLVMValueRef size_val = LLVMConstInt(LLVMInt64TypeInContext(context->context), size, false);
+    LLVMValueRef ptr = goo_codegen_memory_alloc_var(context, var_name, size_val);
+    if (ptr) {
+        goo_codegen_memory_free_var(context, var_name, ptr, size_val);
+    }
+    LLVMBuildRetVoid(context->builder);
+    goo_codegen_memory_function_end(context);
+
+    return ptr ? function : NULL;
+}
+
+// Whether the printed IR of function contains text
+static bool function_contains(LLVMValueRef function, const char* text) {
+    char* ir = LLVMPrintValueToString(function);
+    bool found = strstr(ir, text) != NULL;
+    LLVMDisposeMessage(ir);
+    return found;
+}
+
+static bool test_emitted_placement(void) {
+    printf("Testing emitted allocation placement...\n");
+
+    GooCodegenContext context;
+    memset(&context, 0, sizeof(context));
+    context.context = LLVMContextCreate();
+    context.module = LLVMModuleCreateWithNameInContext("escape_placement", context.context);
+    context.builder = LLVMCreateBuilderInContext(context.context);
+    context.mode = GOO_MODE_COMPILE;
+
+    bool ok = true;
+    LLVMValueRef small = emit_function(&context, "local_small", "p", 64);
+    LLVMValueRef large = emit_function(&context, "local_large", "big", 64 * 1024);
+    LLVMValueRef alias = emit_function(&context, "returns_alias", "p", 64);
+    LLVMValueRef arg = emit_function(&context, "passes_arg", "p", 64);
+    if (!small || !large || !alias || !arg) {
+        fprintf(stderr, "Failed to emit a test function\n");
+        ok = false;
+        goto done;
+    }
+
+    char* error = NULL;
+    if (LLVMVerifyModule(context.module, LLVMReturnStatusAction, &error)) {
+        fprintf(stderr, "Emitted module is invalid: %s\n", error);
+        ok = false;
+    }
+    LLVMDisposeMessage(error);
+
+    // Small and local: one frame slot, free dropped
+    if (!function_contains(small, "alloca [64 x i8]") || function_contains(small, "@goo_alloc") ||
+        function_contains(small, "@goo_free")) {
+        fprintf(stderr, "local_small was not lowered to an alloca\n");
+        ok = false;
+    }
+
+    // Large and local: call arena, released before the return
+    if (!function_contains(large, "@goo_call_arena_mark") || !function_contains(large, "@goo_call_arena_alloc") ||
+        !function_contains(large, "@goo_call_arena_release") || function_contains(large, "@goo_alloc(")) {
+        fprintf(stderr, "local_large was not placed in the call arena\n");
+        ok = false;
+    }
+
+    // Escaping through an alias or an argument: heap, free kept
+    LLVMValueRef heap_functions[] = { alias, arg };
+    for (int i = 0; i < 2; i++) {
+        if (!function_contains(heap_functions[i], "@goo_alloc(") || !function_contains(heap_functions[i], "@goo_free(") ||
+            function_contains(heap_functions[i], "alloca") || function_contains(heap_functions[i], "goo_call_arena")) {
+            fprintf(stderr, "%s did not stay on the heap\n", LLVMGetValueName(heap_functions[i]));
+            ok = false;
+        }
+    }
+
+done:
+    LLVMDisposeBuilder(context.builder);
+    LLVMDisposeModule(context.module);
+    LLVMContextDispose(context.context);
+    return ok;
+}
+
+int main(void) {
+    GooAst ast;
+    analyze_test_module(&ast);
+
+    int failed = 0;
+    if (!test_escape_states()) failed++;
+    if (!test_emitted_placement()) failed++;
+
+    escape_analysis_clear_results();
+
+    if (failed) {
+        printf("%d escape placement test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All escape placement tests passed\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * codegen.h (test mock)
+ *
+ * Stand-in for the backend's codegen.h, which doesn't compile on its own.
+ * Declares only the context fields and entry points the parallel backend,
+ * allocation placement and safepoints use; the tests implement the entry
+ * points.
+ */
+
+#ifndef GOO_CODEGEN_H
+#define GOO_CODEGEN_H
+
+#include <stdbool.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/TargetMachine.h>
+#include "ast.h"
+
+struct GooContext {
+    bool optimize;
+    int opt_level;
+};
+
+// The real value lives in goo_runtime.h, which conflicts with ast.h
+#define GOO_MODE_PROFILE ((GooCompilationMode)(GOO_MODE_INTERPRET + 1))
+
+// Maximum number of placed allocations tracked per function
+#define GOO_MAX_PLACED_ALLOCS 256
+
+// Where an allocation was placed
+typedef enum {
+    GOO_ALLOC_PLACE_HEAP,   // Runtime allocator: outlives the call
+    GOO_ALLOC_PLACE_ARENA,  // Per-call arena: local, too large for the frame
+    GOO_ALLOC_PLACE_STACK,  // alloca: known size, dies with the call
+} GooAllocPlacement;
+
+// Allocation placement state for the function being generated
+typedef struct {
+    LLVMValueRef function;
+    const char* function_name;
+    LLVMValueRef arena_mark;
+    int loop_depth;
+    unsigned stack_allocs;
+    unsigned arena_allocs;
+    unsigned heap_allocs;
+    unsigned elided_frees;
+    struct {
+        const char* name;
+        GooAllocPlacement placement;
+    } placed[GOO_MAX_PLACED_ALLOCS];
+    int placed_count;
+} GooAllocPlacementState;
+
+struct GooCodegenContext {
+    LLVMModuleRef module;
+    LLVMBuilderRef builder;
+    LLVMContextRef context;
+    GooCompilationMode mode;
+    GooContext* goo_context;
+    GooAllocPlacementState alloc_placement;
+    bool emit_safepoints;
+};
+
+bool goo_codegen_generate_unoptimized(GooCodegenContext* context);
+bool goo_codegen_optimize(GooCodegenContext* context);
+LLVMTargetMachineRef goo_codegen_get_target_machine(GooCodegenContext* context);
+bool goo_codegen_generate_object_file(GooCodegenContext* context, const char* output_file);
+LLVMValueRef goo_codegen_get_function(GooCodegenContext* context, const char* name);
+
+#endif /* GOO_CODEGEN_H */
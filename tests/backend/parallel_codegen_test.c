@@ -0,0 +1,331 @@
+/**
+ * parallel_codegen_test.c
+ *
+ * Compiles one module with the serial backend and with the parallel backend
+ * at several job counts and optimization levels, links each object into a
+ * small driver and checks that every build prints the same results. The
+ * module covers what the partitioner has to keep together: internal
+ * functions referenced from a table, a global constructor, linkonce_odr
+ * and alwaysinline functions.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/IRReader.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include "codegen.h"
+#include "codegen_parallel.h"
+#include "passes/pass_manager.h"
+
+static const char* test_module =
+    "@counter = global i32 0\n"
+    "@.str = private unnamed_addr constant [6 x i8] c\"init\\0A\\00\"\n"
+    "@table = internal constant [2 x i32 (i32)*] [i32 (i32)* @sq, i32 (i32)* @inc]\n"
+    "@llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] "
+    "[{ i32, void ()*, i8* } { i32 65535, void ()* @init, i8* null }]\n"
+    "declare i32 @printf(i8*, ...)\n"
+    "define internal void @init() {\n"
+    "  call i32 (i8*, ...) @printf(i8* getelementptr ([6 x i8], [6 x i8]* @.str, i64 0, i64 0))\n"
+    "  store i32 5, i32* @counter\n"
+    "  ret void\n"
+    "}\n"
+    "define internal i32 @sq(i32 %x) {\n"
+    "  %r = mul i32 %x, %x\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define internal i32 @inc(i32 %x) {\n"
+    "  %r = add i32 %x, 1\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define i32 @small(i32 %x) {\n"
+    "  %r = mul i32 %x, 3\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define linkonce_odr i32 @lo(i32 %x) {\n"
+    "  %r = xor i32 %x, 7\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define internal i32 @helper(i32 %x) noinline {\n"
+    "  %p = getelementptr [2 x i32 (i32)*], [2 x i32 (i32)*]* @table, i64 0, i64 1\n"
+    "  %f = load i32 (i32)*, i32 (i32)** %p\n"
+    "  %r = call i32 %f(i32 %x)\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define i32 @ai(i32 %x) alwaysinline {\n"
+    "  %r = sub i32 %x, 2\n"
+    "  ret i32 %r\n"
+    "}\n"
+    "define i32 @loop(i32 %n, i32 %k) {\n"
+    "entry:\n"
+    "  br label %l\n"
+    "l:\n"
+    "  %i = phi i32 [0, %entry], [%i2, %l]\n"
+    "  %s = phi i32 [0, %entry], [%s2, %l]\n"
+    "  %t = mul i32 %i, %k\n"
+    "  %s2 = add i32 %s, %t\n"
+    "  %i2 = add i32 %i, 1\n"
+    "  %c = icmp slt i32 %i2, %n\n"
+    "  br i1 %c, label %l, label %e\n"
+    "e:\n"
+    "  ret i32 %s2\n"
+    "}\n"
+    "define i32 @work1(i32 %x) {\n"
+    "  %a = call i32 @helper(i32 %x)\n"
+    "  %b = call i32 @small(i32 %a)\n"
+    "  %c = call i32 @loop(i32 %b, i32 3)\n"
+    "  ret i32 %c\n"
+    "}\n"
+    "define i32 @work2(i32 %x) {\n"
+    "  %a = call i32 @helper(i32 %x)\n"
+    "  %b = call i32 @lo(i32 %a)\n"
+    "  %c = call i32 @ai(i32 %b)\n"
+    "  ret i32 %c\n"
+    "}\n"
+    "define i32 @work3(i32 %x) {\n"
+    "  %a = call i32 @small(i32 %x)\n"
+    "  %b = call i32 @loop(i32 %a, i32 %x)\n"
+    "  %c = call i32 @lo(i32 %b)\n"
+    "  %d = call i32 @ai(i32 %c)\n"
+    "  ret i32 %d\n"
+    "}\n"
+    "define i32 @work4(i32 %x) {\n"
+    "  %p = getelementptr [2 x i32 (i32)*], [2 x i32 (i32)*]* @table, i64 0, i64 0\n"
+    "  %f = load i32 (i32)*, i32 (i32)** %p\n"
+    "  %a = call i32 %f(i32 %x)\n"
+    "  %g = load i32, i32* @counter\n"
+    "  %b = add i32 %a, %g\n"
+    "  ret i32 %b\n"
+    "}\n"
+    "define i32 @run(i32 %x) {\n"
+    "  %a = call i32 @work1(i32 %x)\n"
+    "  %b = call i32 @work2(i32 %x)\n"
+    "  %c = call i32 @work3(i32 %x)\n"
+    "  %d = call i32 @work4(i32 %x)\n"
+    "  %s1 = add i32 %a, %b\n"
+    "  %s2 = add i32 %s1, %c\n"
+    "  %s3 = add i32 %s2, %d\n"
+    "  ret i32 %s3\n"
+    "}\n";
+
+static const char* test_driver =
+    "#include <stdio.h>\n"
+    "int run(int);\n"
+    "int main(void) {\n"
+    "    for (int i = 1; i < 40; i++) printf(\"%d\\n\", run(i));\n"
+    "    return 0;\n"
+    "}\n";
+
+// Objects written through the serial path; the parallel path must not use it
+static _Atomic int serial_objects;
+
+// =======================================
+// Mock codegen.c entry points
+// =======================================
+
+bool goo_codegen_generate_unoptimized(GooCodegenContext* context) {
+    LLVMMemoryBufferRef buffer = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+        test_module, strlen(test_module), "parallel_codegen_test");
+    char* error = NULL;
+    if (LLVMParseIRInContext(LLVMGetGlobalContext(), buffer, &context->module, &error)) {
+        fprintf(stderr, "Could not parse test module: %s\n", error);
+        LLVMDisposeMessage(error);
+        return false;
+    }
+    return true;
+}
+
+LLVMTargetMachineRef goo_codegen_get_target_machine(GooCodegenContext* context) {
+    (void)context;
+
+    char* triple = LLVMGetDefaultTargetTriple();
+    char* error = NULL;
+    LLVMTargetRef target;
+    if (LLVMGetTargetFromTriple(triple, &target, &error)) {
+        fprintf(stderr, "Could not get target from triple: %s\n", error);
+        LLVMDisposeMessage(error);
+        LLVMDisposeMessage(triple);
+        return NULL;
+    }
+
+    LLVMTargetMachineRef machine = LLVMCreateTargetMachine(
+        target, triple, "generic", "", LLVMCodeGenLevelDefault,
+        LLVMRelocPIC, LLVMCodeModelDefault);
+    LLVMDisposeMessage(triple);
+    return machine;
+}
+
+bool goo_codegen_optimize(GooCodegenContext* context) {
+    if (!context->goo_context->optimize) {
+        return true;
+    }
+
+    LLVMTargetMachineRef target_machine = goo_codegen_get_target_machine(context);
+    bool result = goo_run_module_optimizations(
+        context->module, (GooOptimizationLevel)context->goo_context->opt_level, target_machine);
+    if (target_machine) {
+        LLVMDisposeTargetMachine(target_machine);
+    }
+    return result;
+}
+
+bool goo_codegen_generate_object_file(GooCodegenContext* context, const char* output_file) {
+    atomic_fetch_add(&serial_objects, 1);
+
+    LLVMTargetMachineRef target_machine = goo_codegen_get_target_machine(context);
+    if (!target_machine) {
+        return false;
+    }
+
+    char* error = NULL;
+    bool result = !LLVMTargetMachineEmitToFile(target_machine, context->module,
+                                               (char*)output_file, LLVMObjectFile, &error);
+    if (!result) {
+        fprintf(stderr, "Could not emit object file: %s\n", error);
+        LLVMDisposeMessage(error);
+    }
+    LLVMDisposeTargetMachine(target_machine);
+    return result;
+}
+
+// =======================================
+// Build, link and run
+// =======================================
+
+static char work_dir[] = "/tmp/goo_parallel_codegen_XXXXXX";
+
+// Compile the module with the given job count, link it against the driver
+// and return what the program printed, or NULL on any failure
+static char* build_and_run(int jobs, int opt_level) {
+    char object[256], program[256], command[1024];
+    snprintf(object, sizeof(object), "%s/module_j%d_O%d.o", work_dir, jobs, opt_level);
+    snprintf(program, sizeof(program), "%s/program_j%d_O%d", work_dir, jobs, opt_level);
+
+    GooContext goo_context = { .optimize = opt_level > 0, .opt_level = opt_level };
+    GooCodegenContext context = { .module = NULL, .goo_context = &goo_context };
+
+    int serial_before = atomic_load(&serial_objects);
+    bool compiled = goo_codegen_compile_parallel(&context, object, jobs);
+    if (context.module) {
+        LLVMDisposeModule(context.module);
+    }
+    if (!compiled) {
+        fprintf(stderr, "Failed to compile with -j%d -O%d\n", jobs, opt_level);
+        return NULL;
+    }
+    if (jobs > 1 && atomic_load(&serial_objects) != serial_before) {
+        fprintf(stderr, "-j%d -O%d fell back to the serial backend\n", jobs, opt_level);
+        return NULL;
+    }
+
+    snprintf(command, sizeof(command), "cc -o %s %s/driver.c %s", program, work_dir, object);
+    if (system(command) != 0) {
+        fprintf(stderr, "Failed to link the -j%d -O%d object\n", jobs, opt_level);
+        return NULL;
+    }
+
+    FILE* pipe = popen(program, "r");
+    if (!pipe) {
+        fprintf(stderr, "Failed to run %s\n", program);
+        return NULL;
+    }
+    size_t capacity = 4096, length = 0;
+    char* output = malloc(capacity);
+    size_t read;
+    while (output && (read = fread(output + length, 1, capacity - length - 1, pipe)) > 0) {
+        length += read;
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            char* grown = realloc(output, capacity);
+            if (!grown) {
+                free(output);
+            }
+            output = grown;
+        }
+    }
+    if (pclose(pipe) != 0 || !output) {
+        fprintf(stderr, "%s exited with an error\n", program);
+        free(output);
+        return NULL;
+    }
+    output[length] = '\0';
+    return output;
+}
+
+static bool test_opt_level(int opt_level) {
+    static const int job_counts[] = { 2, 3, 4, 8 };
+
+    printf("Testing parallel builds at -O%d...\n", opt_level);
+
+    char* expected = build_and_run(1, opt_level);
+    if (!expected) return false;
+    if (strncmp(expected, "init\n", 5) != 0) {
+        fprintf(stderr, "Global constructor didn't run in the -j1 -O%d build\n", opt_level);
+        free(expected);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(job_counts) / sizeof(job_counts[0]); i++) {
+        char* output = build_and_run(job_counts[i], opt_level);
+        if (!output) {
+            ok = false;
+            continue;
+        }
+        if (strcmp(output, expected) != 0) {
+            fprintf(stderr, "-j%d -O%d output differs from -j1:\n%s\nexpected:\n%s\n",
+                    job_counts[i], opt_level, output, expected);
+            ok = false;
+        }
+        free(output);
+    }
+    free(expected);
+    return ok;
+}
+
+int main(void) {
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+    if (!goo_pass_manager_init()) {
+        fprintf(stderr, "Failed to initialize the pass manager\n");
+        return 1;
+    }
+
+    if (!mkdtemp(work_dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char driver[256];
+    snprintf(driver, sizeof(driver), "%s/driver.c", work_dir);
+    FILE* file = fopen(driver, "w");
+    if (!file) {
+        perror("fopen");
+        return 1;
+    }
+    fputs(test_driver, file);
+    fclose(file);
+
+    int failed = 0;
+    if (!test_opt_level(0)) failed++;
+    if (!test_opt_level(2)) failed++;
+    if (!test_opt_level(3)) failed++;
+
+    char command[512];
+    snprintf(command, sizeof(command), "rm -rf %s", work_dir);
+    if (system(command) != 0) {
+        fprintf(stderr, "Failed to remove %s\n", work_dir);
+    }
+
+    if (failed) {
+        printf("%d parallel codegen test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All parallel codegen tests passed\n");
+    return 0;
+}
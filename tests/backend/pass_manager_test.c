@@ -0,0 +1,510 @@
+/**
+ * pass_manager_test.c
+ *
+ * Runs pipelines through the backend pass manager on small parsed modules.
+ * Checks the level pipelines and the custom one, registration of Goo
+ * passes, that Goo passes run in order between the LLVM passes around them,
+ * the Goo-only and LLVM-only halves used by the parallel backend, failure
+ * handling, and that goo_configure_pass really turns the unroller and the
+ * channel pass off.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/Analysis.h>
+#include <llvm-c/IRReader.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include "passes/pass_manager.h"
+
+// f keeps its local in memory until sroa promotes it
+static const char* alloca_module =
+    "define i32 @f(i32 %x) {\n"
+    "  %p = alloca i32\n"
+    "  store i32 %x, i32* %p\n"
+    "  %v = load i32, i32* %p\n"
+    "  ret i32 %v\n"
+    "}\n";
+
+// A loop for the loop vectorizer, straight-line code for the SLP
+// vectorizer, and a fixed-count loop around an opaque call for the unroller
+static const char* tuning_module =
+    "declare void @sink(i64)\n"
+    "define void @loop(float* noalias %a, float* noalias %b, i64 %n) {\n"
+    "entry:\n"
+    "  %empty = icmp eq i64 %n, 0\n"
+    "  br i1 %empty, label %exit, label %body\n"
+    "body:\n"
+    "  %i = phi i64 [0, %entry], [%next, %body]\n"
+    "  %pa = getelementptr float, float* %a, i64 %i\n"
+    "  %pb = getelementptr float, float* %b, i64 %i\n"
+    "  %x = load float, float* %pa\n"
+    "  %y = load float, float* %pb\n"
+    "  %s = fadd float %x, %y\n"
+    "  store float %s, float* %pa\n"
+    "  %next = add i64 %i, 1\n"
+    "  %done = icmp eq i64 %next, %n\n"
+    "  br i1 %done, label %exit, label %body\n"
+    "exit:\n"
+    "  ret void\n"
+    "}\n"
+    "define void @straight(float* noalias %a, float* noalias %b) {\n"
+    "  %a1p = getelementptr float, float* %a, i64 1\n"
+    "  %a2p = getelementptr float, float* %a, i64 2\n"
+    "  %a3p = getelementptr float, float* %a, i64 3\n"
+    "  %b1p = getelementptr float, float* %b, i64 1\n"
+    "  %b2p = getelementptr float, float* %b, i64 2\n"
+    "  %b3p = getelementptr float, float* %b, i64 3\n"
+    "  %a0 = load float, float* %a\n"
+    "  %a1 = load float, float* %a1p\n"
+    "  %a2 = load float, float* %a2p\n"
+    "  %a3 = load float, float* %a3p\n"
+    "  %b0 = load float, float* %b\n"
+    "  %b1 = load float, float* %b1p\n"
+    "  %b2 = load float, float* %b2p\n"
+    "  %b3 = load float, float* %b3p\n"
+    "  %s0 = fmul float %a0, %b0\n"
+    "  %s1 = fmul float %a1, %b1\n"
+    "  %s2 = fmul float %a2, %b2\n"
+    "  %s3 = fmul float %a3, %b3\n"
+    "  store float %s0, float* %a\n"
+    "  store float %s1, float* %a1p\n"
+    "  store float %s2, float* %a2p\n"
+    "  store float %s3, float* %a3p\n"
+    "  ret void\n"
+    "}\n"
+    "define void @fixed() {\n"
+    "entry:\n"
+    "  br label %body\n"
+    "body:\n"
+    "  %i = phi i64 [0, %entry], [%next, %body]\n"
+    "  call void @sink(i64 %i)\n"
+    "  %next = add i64 %i, 1\n"
+    "  %done = icmp eq i64 %next, 4\n"
+    "  br i1 %done, label %exit, label %body\n"
+    "exit:\n"
+    "  ret void\n"
+    "}\n";
+
+// A channel with a one-slot buffer sent to outside the block that creates it
+static const char* channel_module =
+    "declare i8* @goo_channel_create(i64, i64)\n"
+    "declare void @goo_channel_send(i8*, i64)\n"
+    "define void @producer() {\n"
+    "entry:\n"
+    "  %ch = call i8* @goo_channel_create(i64 8, i64 1)\n"
+    "  br label %send\n"
+    "send:\n"
+    "  call void @goo_channel_send(i8* %ch, i64 42)\n"
+    "  ret void\n"
+    "}\n";
+
+static LLVMContextRef llvm_context;
+
+static LLVMModuleRef parse_module(const char* text) {
+    LLVMMemoryBufferRef buffer = LLVMCreateMemoryBufferWithMemoryRangeCopy(text, strlen(text), "pass_manager_test");
+    LLVMModuleRef module = NULL;
+    char* error = NULL;
+    if (LLVMParseIRInContext(llvm_context, buffer, &module, &error)) {
+        fprintf(stderr, "Could not parse test module: %s\n", error);
+        LLVMDisposeMessage(error);
+        return NULL;
+    }
+    return module;
+}
+
+static LLVMTargetMachineRef create_target_machine(void) {
+    char* triple = LLVMGetDefaultTargetTriple();
+    char* error = NULL;
+    LLVMTargetRef target;
+    if (LLVMGetTargetFromTriple(triple, &target, &error)) {
+        fprintf(stderr, "Could not get target from triple: %s\n", error);
+        LLVMDisposeMessage(error);
+        LLVMDisposeMessage(triple);
+        return NULL;
+    }
+
+    LLVMTargetMachineRef machine = LLVMCreateTargetMachine(
+        target, triple, "generic", "", LLVMCodeGenLevelDefault,
+        LLVMRelocPIC, LLVMCodeModelDefault);
+    LLVMDisposeMessage(triple);
+    return machine;
+}
+
+static int count_opcode(LLVMValueRef func, LLVMOpcode opcode) {
+    int count = 0;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetInstructionOpcode(inst) == opcode) count++;
+        }
+    }
+    return count;
+}
+
+// Instructions in func that produce or store a vector
+static int count_vector_ops(LLVMValueRef func) {
+    int count = 0;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            LLVMValueRef value = LLVMGetInstructionOpcode(inst) == LLVMStore ? LLVMGetOperand(inst, 0) : inst;
+            if (LLVMGetTypeKind(LLVMTypeOf(value)) == LLVMVectorTypeKind) count++;
+        }
+    }
+    return count;
+}
+
+static int count_allocas(LLVMModuleRef module) {
+    return count_opcode(LLVMGetNamedFunction(module, "f"), LLVMAlloca);
+}
+
+// ===== Recording Goo passes =====
+
+// Each recording pass appends its letter and the allocas it saw
+static char pass_log[64];
+
+static void log_pass(char name, LLVMModuleRef module) {
+    size_t length = strlen(pass_log);
+    if (length + 2 < sizeof(pass_log)) {
+        pass_log[length] = name;
+        pass_log[length + 1] = (char)('0' + count_allocas(module));
+        pass_log[length + 2] = '\0';
+    }
+}
+
+static bool record_a(LLVMModuleRef module) {
+    log_pass('a', module);
+    return true;
+}
+
+static bool record_b(LLVMModuleRef module) {
+    log_pass('b', module);
+    return true;
+}
+
+static bool record_fail(LLVMModuleRef module) {
+    log_pass('x', module);
+    return false;
+}
+
+static bool noop_pass(LLVMModuleRef module) {
+    (void)module;
+    return true;
+}
+
+// Parse the alloca module, run pipeline through run, and compare the log
+// and the allocas left
+static bool check_run(const char* label, bool (*run)(LLVMModuleRef, const char*), const char* pipeline,
+                      bool expected_result, const char* expected_log, int expected_allocas) {
+    LLVMModuleRef module = parse_module(alloca_module);
+    if (!module) return false;
+
+    pass_log[0] = '\0';
+    bool result = run(module, pipeline);
+    int allocas = count_allocas(module);
+    LLVMDisposeModule(module);
+
+    if (result != expected_result || strcmp(pass_log, expected_log) != 0 || allocas != expected_allocas) {
+        fprintf(stderr, "%s \"%s\": returned %d, ran \"%s\", left %d allocas; expected %d, \"%s\", %d\n",
+                label, pipeline, result, pass_log, allocas, expected_result, expected_log, expected_allocas);
+        return false;
+    }
+    return true;
+}
+
+static bool run_full(LLVMModuleRef module, const char* pipeline) {
+    return goo_run_pipeline(module, pipeline, NULL);
+}
+
+static bool run_goo(LLVMModuleRef module, const char* pipeline) {
+    return goo_run_pipeline_goo_passes(module, pipeline);
+}
+
+static bool run_llvm(LLVMModuleRef module, const char* pipeline) {
+    return goo_run_pipeline_llvm_passes(module, pipeline, NULL);
+}
+
+static bool test_level_pipelines(void) {
+    printf("Testing the optimization level pipelines...\n");
+
+    bool ok = true;
+    static const char* expected[] = { "default<O0>", "default<O1>", "default<O2>", "default<O3>" };
+    for (int level = GOO_OPT_NONE; level <= GOO_OPT_AGGRESSIVE; level++) {
+        const char* pipeline = goo_get_pipeline((GooOptimizationLevel)level);
+        if (!pipeline || strcmp(pipeline, expected[level]) != 0) {
+            fprintf(stderr, "Level %d runs \"%s\"\n", level, pipeline ? pipeline : "(null)");
+            ok = false;
+        }
+    }
+    if (goo_get_pipeline((GooOptimizationLevel)7) != NULL) {
+        fprintf(stderr, "An unknown level has a pipeline\n");
+        ok = false;
+    }
+
+    // The custom pipeline can be replaced and restored; the text is copied
+    const char* custom = goo_get_pipeline(GOO_OPT_CUSTOM);
+    if (!custom || strcmp(custom, "goo-channel-opt,default<O3>") != 0) {
+        fprintf(stderr, "The default custom pipeline is \"%s\"\n", custom ? custom : "(null)");
+        ok = false;
+    }
+    char replacement[] = "function(sroa),goo-channel-opt";
+    goo_set_custom_pipeline(replacement);
+    replacement[0] = 'X';
+    if (strcmp(goo_get_pipeline(GOO_OPT_CUSTOM), "function(sroa),goo-channel-opt") != 0) {
+        fprintf(stderr, "The custom pipeline was not copied\n");
+        ok = false;
+    }
+    goo_set_custom_pipeline(NULL);
+    if (strcmp(goo_get_pipeline(GOO_OPT_CUSTOM), "goo-channel-opt,default<O3>") != 0) {
+        fprintf(stderr, "Resetting the custom pipeline did not restore the default\n");
+        ok = false;
+    }
+
+    // Every level runs on a module and leaves it valid
+    for (int level = GOO_OPT_NONE; level <= GOO_OPT_CUSTOM; level++) {
+        LLVMModuleRef module = parse_module(tuning_module);
+        if (!module) return false;
+        bool ran = goo_run_module_optimizations(module, (GooOptimizationLevel)level, NULL);
+        bool valid = !LLVMVerifyModule(module, LLVMReturnStatusAction, NULL);
+        LLVMDisposeModule(module);
+        if (!ran || !valid) {
+            fprintf(stderr, "Level %d failed or left an invalid module\n", level);
+            ok = false;
+        }
+    }
+    LLVMModuleRef module = parse_module(alloca_module);
+    if (goo_run_module_optimizations(module, (GooOptimizationLevel)7, NULL) ||
+        goo_run_module_optimizations(NULL, GOO_OPT_MODERATE, NULL) || goo_run_pipeline(module, NULL, NULL)) {
+        fprintf(stderr, "An unknown level, a NULL module or a NULL pipeline ran\n");
+        ok = false;
+    }
+    LLVMDisposeModule(module);
+    return ok;
+}
+
+static bool test_registration(void) {
+    printf("Testing Goo pass registration...\n");
+
+    bool ok = true;
+    char name[] = "goo-record-a";
+    if (!goo_register_module_pass(name, record_a) || !goo_register_module_pass("goo-record-b", record_b) ||
+        !goo_register_module_pass("goo-record-fail", record_fail)) {
+        fprintf(stderr, "Could not register the recording passes\n");
+        return false;
+    }
+
+    // The name is copied
+    name[0] = 'X';
+    ok &= check_run("Copied name", run_full, "goo-record-a", true, "a1", 1);
+
+    // Duplicates, including the built-in pass, and empty names are rejected
+    if (goo_register_module_pass("goo-record-a", record_b) || goo_register_module_pass("goo-channel-opt", noop_pass) ||
+        goo_register_module_pass("", noop_pass) || goo_register_module_pass(NULL, noop_pass) ||
+        goo_register_module_pass("goo-no-callback", NULL)) {
+        fprintf(stderr, "A duplicate or invalid pass was registered\n");
+        ok = false;
+    }
+
+    // The table holds GOO_MAX_MODULE_PASSES in all, counting the built-in one
+    int registered = 4;
+    char filler[32];
+    while (registered < GOO_MAX_MODULE_PASSES) {
+        snprintf(filler, sizeof(filler), "goo-filler-%d", registered);
+        if (!goo_register_module_pass(filler, noop_pass)) break;
+        registered++;
+    }
+    if (registered != GOO_MAX_MODULE_PASSES || goo_register_module_pass("goo-one-too-many", noop_pass)) {
+        fprintf(stderr, "The pass table took %d passes, expected %d\n", registered, GOO_MAX_MODULE_PASSES);
+        ok = false;
+    }
+    snprintf(filler, sizeof(filler), "goo-filler-%d", GOO_MAX_MODULE_PASSES - 1);
+    ok &= check_run("Last registered pass", run_full, filler, true, "", 1);
+
+    // Cleanup forgets the registered passes but keeps the built-in one
+    goo_pass_manager_cleanup();
+    ok &= check_run("After cleanup", run_full, "goo-record-a", false, "", 1);
+    ok &= check_run("Built-in after cleanup", run_full, "goo-channel-opt", true, "", 1);
+    if (!goo_register_module_pass("goo-record-a", record_a) || !goo_register_module_pass("goo-record-b", record_b) ||
+        !goo_register_module_pass("goo-record-fail", record_fail)) {
+        fprintf(stderr, "Could not register passes again after cleanup\n");
+        ok = false;
+    }
+    return ok;
+}
+
+static bool test_pipeline_order(void) {
+    printf("Testing Goo passes between LLVM passes...\n");
+
+    bool ok = true;
+    ok &= check_run("Around sroa", run_full, "goo-record-a,function(sroa),goo-record-b", true, "a1b0", 0);
+    ok &= check_run("Before LLVM", run_full, "goo-record-a,goo-record-b,function(sroa)", true, "a1b1", 0);
+    ok &= check_run("After LLVM", run_full, "default<O2>,goo-record-b,goo-record-a", true, "b0a0", 0);
+    ok &= check_run("Repeated", run_full, "goo-record-a,goo-record-a,function(sroa),goo-record-a", true, "a1a1a0", 0);
+
+    // Commas inside nested pipelines and parameters stay with their element
+    ok &= check_run("Nested", run_full, "goo-record-a,function(sroa,early-cse<memssa>),goo-record-b",
+                    true, "a1b0", 0);
+    ok &= check_run("Module nesting", run_full, "module(function(sroa)),goo-record-b", true, "b0", 0);
+    ok &= check_run("Goo name in function()", run_goo, "function(sroa,goo-record-a,sroa)", true, "", 1);
+    ok &= check_run("Goo name in parameters", run_goo, "default<O1,goo-record-a,O2>", true, "", 1);
+
+    // Spaces and empty elements are skipped
+    ok &= check_run("Spacing", run_full, " goo-record-a , ,function(sroa) ,goo-record-b ,", true, "a1b0", 0);
+    ok &= check_run("Empty between LLVM passes", run_full, "function(sroa), ,,default<O1>,goo-record-a", true, "a0", 0);
+    ok &= check_run("Empty", run_full, "", true, "", 1);
+
+    // Goo names only count as whole top-level elements
+    ok &= check_run("Prefix", run_full, "goo-record", false, "", 1);
+    ok &= check_run("Inside function()", run_full, "function(goo-record-a)", false, "", 1);
+    return ok;
+}
+
+static bool test_split_pipelines(void) {
+    printf("Testing the Goo-only and LLVM-only halves of a pipeline...\n");
+
+    const char* pipeline = "goo-record-a,function(sroa),goo-record-b,default<O1>";
+    bool ok = true;
+    ok &= check_run("Goo passes", run_goo, pipeline, true, "a1b1", 1);
+    ok &= check_run("LLVM passes", run_llvm, pipeline, true, "", 0);
+
+    // The Goo half ignores LLVM elements, even ones LLVM would reject
+    ok &= check_run("Goo passes past bad LLVM text", run_goo, "not-a-pass,goo-record-a", true, "a1", 1);
+    ok &= check_run("LLVM passes past a failing Goo pass", run_llvm, "goo-record-fail,function(sroa)", true, "", 0);
+    return ok;
+}
+
+static bool test_failures(void) {
+    printf("Testing pipeline failures...\n");
+
+    bool ok = true;
+
+    // A failing Goo pass stops the pipeline before the passes after it
+    ok &= check_run("Failing Goo pass", run_full, "goo-record-fail,function(sroa),goo-record-b", false, "x1", 1);
+    ok &= check_run("Failing Goo pass late", run_full, "function(sroa),goo-record-fail,goo-record-a", false, "x0", 0);
+
+    // Bad LLVM text fails before the Goo passes after it
+    ok &= check_run("Bad LLVM text", run_full, "goo-record-a,not-a-pass,goo-record-b", false, "a1", 1);
+    ok &= check_run("Bad LLVM parameters", run_full, "default<O9>", false, "", 1);
+    return ok;
+}
+
+static bool test_tuning(void) {
+    printf("Testing pass configuration...\n");
+
+    LLVMTargetMachineRef machine = create_target_machine();
+    if (!machine) return false;
+
+    // LLVM 14 picks both vectorizers for default<On> from the level itself,
+    // so only the unrolling switch changes what default<O2> does there
+    static const struct {
+        const char* label;
+        bool unroll;
+        int sink_calls;         // Calls left in @fixed
+    } cases[] = {
+        { "Unrolling", true, 4 },
+        { "No unrolling", false, 1 },
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        goo_configure_pass(GOO_PASS_GROUP_LOOP, "loop-unroll", cases[i].unroll);
+
+        LLVMModuleRef module = parse_module(tuning_module);
+        if (!module || !goo_run_module_optimizations(module, GOO_OPT_MODERATE, machine)) {
+            fprintf(stderr, "%s: the pipeline failed\n", cases[i].label);
+            ok = false;
+            if (module) LLVMDisposeModule(module);
+            continue;
+        }
+
+        // The target machine gives the vectorizers a vector width
+        int loop_vectors = count_vector_ops(LLVMGetNamedFunction(module, "loop"));
+        int straight_vectors = count_vector_ops(LLVMGetNamedFunction(module, "straight"));
+        int sink_calls = count_opcode(LLVMGetNamedFunction(module, "fixed"), LLVMCall);
+        if (loop_vectors == 0 || straight_vectors == 0 || sink_calls != cases[i].sink_calls) {
+            fprintf(stderr, "%s: %d vector ops in the loop, %d in straight-line code, %d calls in the fixed loop\n",
+                    cases[i].label, loop_vectors, straight_vectors, sink_calls);
+            ok = false;
+        }
+        LLVMDisposeModule(module);
+    }
+    goo_configure_pass(GOO_PASS_GROUP_LOOP, "loop-unroll", true);
+    LLVMDisposeTargetMachine(machine);
+
+    // Unknown names and groups are rejected; known passes are described
+    if (goo_configure_pass(GOO_PASS_GROUP_LOOP, "slp-vectorize", false) ||
+        goo_configure_pass((GooPassGroup)42, "gvn", false) || goo_configure_pass(GOO_PASS_GROUP_SCALAR, NULL, false)) {
+        fprintf(stderr, "An unknown pass was configured\n");
+        ok = false;
+    }
+    const char* description = goo_get_pass_description(GOO_PASS_GROUP_CUSTOM, "channel-opt");
+    if (!description || !*description || goo_get_pass_description(GOO_PASS_GROUP_SCALAR, "no-such-pass")) {
+        fprintf(stderr, "Pass descriptions are wrong\n");
+        ok = false;
+    }
+    return ok;
+}
+
+// Buffer size the create call in @producer passes
+static long long channel_buffer_size(LLVMModuleRef module) {
+    LLVMValueRef create = LLVMGetFirstInstruction(LLVMGetEntryBasicBlock(LLVMGetNamedFunction(module, "producer")));
+    return LLVMConstIntGetSExtValue(LLVMGetOperand(create, 1));
+}
+
+static bool test_channel_pass(void) {
+    printf("Testing the built-in channel pass...\n");
+
+    bool ok = true;
+    static const struct {
+        bool enabled;
+        GooOptimizationLevel level;
+        long long buffer_size;
+    } cases[] = {
+        { true, GOO_OPT_CUSTOM, 16 },
+        { false, GOO_OPT_CUSTOM, 1 },
+        { true, GOO_OPT_AGGRESSIVE, 1 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        goo_configure_pass(GOO_PASS_GROUP_CUSTOM, "channel-opt", cases[i].enabled);
+        LLVMModuleRef module = parse_module(channel_module);
+        if (!module) return false;
+        bool ran = goo_run_module_optimizations(module, cases[i].level, NULL);
+        long long buffer_size = channel_buffer_size(module);
+        LLVMDisposeModule(module);
+        if (!ran || buffer_size != cases[i].buffer_size) {
+            fprintf(stderr, "Channel pass %s at level %d left a buffer of %lld, expected %lld\n",
+                    cases[i].enabled ? "enabled" : "disabled", cases[i].level, buffer_size, cases[i].buffer_size);
+            ok = false;
+        }
+    }
+    goo_configure_pass(GOO_PASS_GROUP_CUSTOM, "channel-opt", true);
+    return ok;
+}
+
+int main(void) {
+    if (!goo_pass_manager_init()) {
+        fprintf(stderr, "Failed to initialize the pass manager\n");
+        return 1;
+    }
+    llvm_context = LLVMContextCreate();
+
+    int failed = 0;
+    if (!test_level_pipelines()) failed++;
+    if (!test_registration()) failed++;
+    if (!test_pipeline_order()) failed++;
+    if (!test_split_pipelines()) failed++;
+    if (!test_failures()) failed++;
+    if (!test_tuning()) failed++;
+    if (!test_channel_pass()) failed++;
+
+    goo_pass_manager_cleanup();
+    LLVMContextDispose(llvm_context);
+
+    if (failed) {
+        printf("%d pass manager test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All pass manager tests passed\n");
+    return 0;
+}
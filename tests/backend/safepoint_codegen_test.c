@@ -0,0 +1,353 @@
+/**
+ * safepoint_codegen_test.c
+ *
+ * Emits a hot loop through codegen_safepoint.c and checks the IR: one poll
+ * after the prologue and one on the back-edge, each a relaxed thread-local
+ * load with a cold, weighted call to goo_safepoint_yield. The loop is then
+ * optimized at O2 and compiled for the host to check the poll survives in
+ * the loop and stays a single thread-local load.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/Analysis.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/PassBuilder.h>
+#include "codegen.h"
+#include "codegen_safepoint.h"
+
+static void context_init(GooCodegenContext* context, const char* name, bool emit_safepoints) {
+    memset(context, 0, sizeof(*context));
+    context->context = LLVMContextCreate();
+    context->module = LLVMModuleCreateWithNameInContext(name, context->context);
+    context->builder = LLVMCreateBuilderInContext(context->context);
+    context->mode = GOO_MODE_COMPILE;
+    context->emit_safepoints = emit_safepoints;
+}
+
+static void context_dispose(GooCodegenContext* context) {
+    LLVMDisposeBuilder(context->builder);
+    LLVMDisposeModule(context->module);
+    LLVMContextDispose(context->context);
+}
+
+// i64 hot_loop(i64 n): sums 0..n-1 the way codegen lowers a for loop,
+// with a prologue safepoint and a back-edge safepoint
+static LLVMValueRef emit_hot_loop(GooCodegenContext* context) {
+    LLVMTypeRef i64_type = LLVMInt64TypeInContext(context->context);
+    LLVMValueRef function = LLVMAddFunction(context->module, "hot_loop",
+                                            LLVMFunctionType(i64_type, &i64_type, 1, false));
+    LLVMValueRef n = LLVMGetParam(function, 0);
+    LLVMBasicBlockRef entry = LLVMAppendBasicBlockInContext(context->context, function, "entry");
+    LLVMBasicBlockRef cond = LLVMAppendBasicBlockInContext(context->context, function, "for.cond");
+    LLVMBasicBlockRef body = LLVMAppendBasicBlockInContext(context->context, function, "for.body");
+    LLVMBasicBlockRef exit = LLVMAppendBasicBlockInContext(context->context, function, "for.end");
+
+    LLVMPositionBuilderAtEnd(context->builder, entry);
+    LLVMValueRef i = LLVMBuildAlloca(context->builder, i64_type, "i");
+    LLVMValueRef sum = LLVMBuildAlloca(context->builder, i64_type, "sum");
+    LLVMBuildStore(context->builder, LLVMConstInt(i64_type, 0, false), i);
+    LLVMBuildStore(context->builder, LLVMConstInt(i64_type, 0, false), sum);
+    goo_codegen_safepoint(context);
+    LLVMBuildBr(context->builder, cond);
+
+    LLVMPositionBuilderAtEnd(context->builder, cond);
+    LLVMValueRef index = LLVMBuildLoad2(context->builder, i64_type, i, "index");
+    LLVMBuildCondBr(context->builder, LLVMBuildICmp(context->builder, LLVMIntSLT, index, n, "more"),
+                    body, exit);
+
+    LLVMPositionBuilderAtEnd(context->builder, body);
+    LLVMValueRef value = LLVMBuildLoad2(context->builder, i64_type, i, "value");
+    LLVMValueRef total = LLVMBuildLoad2(context->builder, i64_type, sum, "total");
+    LLVMBuildStore(context->builder, LLVMBuildAdd(context->builder, total, value, "total.next"), sum);
+    LLVMBuildStore(context->builder,
+                   LLVMBuildAdd(context->builder, value, LLVMConstInt(i64_type, 1, false), "value.next"), i);
+    goo_codegen_safepoint(context);
+    LLVMBuildBr(context->builder, cond);
+
+    LLVMPositionBuilderAtEnd(context->builder, exit);
+    LLVMBuildRet(context->builder, LLVMBuildLoad2(context->builder, i64_type, sum, "result"));
+    return function;
+}
+
+static bool module_is_valid(LLVMModuleRef module) {
+    char* error = NULL;
+    bool valid = !LLVMVerifyModule(module, LLVMReturnStatusAction, &error);
+    if (!valid) {
+        fprintf(stderr, "Emitted module is invalid: %s\n", error);
+    }
+    LLVMDisposeMessage(error);
+    return valid;
+}
+
+// Number of times text appears in the printed IR of value
+static int count_in(LLVMValueRef value, const char* text) {
+    char* ir = LLVMPrintValueToString(value);
+    int count = 0;
+    for (const char* at = strstr(ir, text); at; at = strstr(at + 1, text)) {
+        count++;
+    }
+    LLVMDisposeMessage(ir);
+    return count;
+}
+
+#define MAX_BLOCKS 64
+
+// Whether block lies on a cycle of the CFG, i.e. inside a loop
+static bool in_loop(LLVMBasicBlockRef block) {
+    LLVMBasicBlockRef stack[MAX_BLOCKS], seen[MAX_BLOCKS];
+    int depth = 0, seen_count = 0;
+    stack[depth++] = block;
+    while (depth > 0) {
+        LLVMValueRef terminator = LLVMGetBasicBlockTerminator(stack[--depth]);
+        for (unsigned s = 0; terminator && s < LLVMGetNumSuccessors(terminator); s++) {
+            LLVMBasicBlockRef next = LLVMGetSuccessor(terminator, s);
+            if (next == block) return true;
+            bool visited = false;
+            for (int i = 0; i < seen_count; i++) {
+                visited |= seen[i] == next;
+            }
+            if (!visited && seen_count < MAX_BLOCKS) {
+                seen[seen_count++] = next;
+                stack[depth++] = next;
+            }
+        }
+    }
+    return false;
+}
+
+// Check one poll: load -> icmp ne 0 -> weighted condbr to a block that
+// only calls the yield and rejoins the fast path
+static bool check_poll(GooCodegenContext* context, LLVMValueRef load, LLVMValueRef yield_func) {
+    if (LLVMGetOrdering(load) != LLVMAtomicOrderingMonotonic || LLVMGetAlignment(load) != 4) {
+        fprintf(stderr, "Safepoint load is not a relaxed, aligned atomic\n");
+        return false;
+    }
+    LLVMValueRef check = LLVMGetNextInstruction(load);
+    LLVMValueRef branch = check ? LLVMGetNextInstruction(check) : NULL;
+    if (!check || LLVMGetICmpPredicate(check) != LLVMIntNE || LLVMGetOperand(check, 0) != load ||
+        !branch || !LLVMIsABranchInst(branch) || !LLVMIsConditional(branch)) {
+        fprintf(stderr, "Safepoint load is not followed by a test and a branch\n");
+        return false;
+    }
+
+    LLVMValueRef prof = LLVMGetMetadata(branch, LLVMGetMDKindIDInContext(context->context, "prof", 4));
+    if (!prof || count_in(branch, "!prof") != 1) {
+        fprintf(stderr, "Safepoint branch has no branch weights\n");
+        return false;
+    }
+    char* weights = LLVMPrintValueToString(prof);
+    bool weighted = strstr(weights, "\"branch_weights\", i32 1, i32 2000") != NULL;
+    LLVMDisposeMessage(weights);
+    if (!weighted) {
+        fprintf(stderr, "Safepoint branch is not weighted 1:2000 toward the fast path\n");
+        return false;
+    }
+
+    LLVMBasicBlockRef yield_block = LLVMGetSuccessor(branch, 0);
+    LLVMBasicBlockRef continue_block = LLVMGetSuccessor(branch, 1);
+    LLVMValueRef call = LLVMGetFirstInstruction(yield_block);
+    LLVMValueRef rejoin = call ? LLVMGetNextInstruction(call) : NULL;
+    if (!call || !LLVMIsACallInst(call) || LLVMGetCalledValue(call) != yield_func ||
+        !rejoin || LLVMGetNextInstruction(rejoin) || !LLVMIsABranchInst(rejoin) || LLVMIsConditional(rejoin) ||
+        LLVMGetSuccessor(rejoin, 0) != continue_block) {
+        fprintf(stderr, "Slow path does more than call goo_safepoint_yield and rejoin\n");
+        return false;
+    }
+    return true;
+}
+
+static bool test_emitted_polls(void) {
+    printf("Testing safepoint polls in an emitted hot loop...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "safepoint_polls", true);
+    goo_codegen_safepoint_declare_runtime(&context);
+    goo_codegen_safepoint_declare_runtime(&context);
+    LLVMValueRef function = emit_hot_loop(&context);
+
+    bool ok = module_is_valid(context.module);
+    LLVMValueRef flag = LLVMGetNamedGlobal(context.module, "goo_preempt_requested");
+    LLVMValueRef yield_func = LLVMGetNamedFunction(context.module, "goo_safepoint_yield");
+    unsigned cold = LLVMGetEnumAttributeKindForName("cold", 4);
+    if (!flag || !LLVMIsThreadLocal(flag) || LLVMGetThreadLocalMode(flag) != LLVMInitialExecTLSModel ||
+        LLVMGetInitializer(flag) || LLVMGetNamedGlobal(context.module, "goo_preempt_requested.1")) {
+        fprintf(stderr, "goo_preempt_requested is not one external initial-exec thread local\n");
+        ok = false;
+    }
+    if (!yield_func || !LLVMGetEnumAttributeAtIndex(yield_func, LLVMAttributeFunctionIndex, cold) ||
+        LLVMGetNamedFunction(context.module, "goo_safepoint_yield.1")) {
+        fprintf(stderr, "goo_safepoint_yield is not declared once and cold\n");
+        ok = false;
+    }
+    if (!ok) goto done;
+
+    // Walk the loads of the flag: one in the entry block, one on the back-edge
+    int polls = 0, prologue_polls = 0, back_edge_polls = 0;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(function); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            if (!LLVMIsALoadInst(inst) || LLVMGetOperand(inst, 0) != flag) continue;
+            polls++;
+            if (!check_poll(&context, inst, yield_func)) {
+                ok = false;
+                continue;
+            }
+            if (block == LLVMGetEntryBasicBlock(function)) {
+                prologue_polls++;
+            } else if (in_loop(block)) {
+                back_edge_polls++;
+            }
+        }
+    }
+    if (polls != 2 || prologue_polls != 1 || back_edge_polls != 1) {
+        fprintf(stderr, "Found %d polls (%d in the prologue, %d on the back-edge), expected 1 of each\n",
+                polls, prologue_polls, back_edge_polls);
+        ok = false;
+    }
+    if (count_in(function, "call void @goo_safepoint_yield()") != 2) {
+        fprintf(stderr, "Expected two calls to goo_safepoint_yield\n");
+        ok = false;
+    }
+
+done:
+    context_dispose(&context);
+    return ok;
+}
+
+static bool test_polls_omitted(void) {
+    printf("Testing that safepoints can be turned off...\n");
+
+    bool ok = true;
+
+    // emit_safepoints off: the loop is emitted without polls
+    GooCodegenContext context;
+    context_init(&context, "safepoints_off", false);
+    goo_codegen_safepoint_declare_runtime(&context);
+    LLVMValueRef function = emit_hot_loop(&context);
+    if (!module_is_valid(context.module) || count_in(function, "goo_preempt_requested") != 0 ||
+        count_in(function, "goo_safepoint_yield") != 0 || LLVMCountBasicBlocks(function) != 4) {
+        fprintf(stderr, "Safepoints were emitted with emit_safepoints off\n");
+        ok = false;
+    }
+    context_dispose(&context);
+
+    // Runtime not declared: nothing to poll
+    context_init(&context, "safepoints_undeclared", true);
+    function = emit_hot_loop(&context);
+    if (!module_is_valid(context.module) || LLVMCountBasicBlocks(function) != 4) {
+        fprintf(stderr, "Safepoints were emitted without the runtime declarations\n");
+        ok = false;
+    }
+    context_dispose(&context);
+
+    // A block that already ends in a return gets no poll after it
+    context_init(&context, "safepoint_terminated", true);
+    goo_codegen_safepoint_declare_runtime(&context);
+    function = LLVMAddFunction(context.module, "returns",
+                               LLVMFunctionType(LLVMVoidTypeInContext(context.context), NULL, 0, false));
+    LLVMPositionBuilderAtEnd(context.builder, LLVMAppendBasicBlockInContext(context.context, function, "entry"));
+    LLVMBuildRetVoid(context.builder);
+    goo_codegen_safepoint(&context);
+    if (!module_is_valid(context.module) || LLVMCountBasicBlocks(function) != 1) {
+        fprintf(stderr, "A safepoint was emitted after a terminator\n");
+        ok = false;
+    }
+    context_dispose(&context);
+
+    return ok;
+}
+
+static bool test_compiled_poll(void) {
+    printf("Testing the optimized and compiled poll...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "safepoint_compiled", true);
+    goo_codegen_safepoint_declare_runtime(&context);
+    LLVMValueRef function = emit_hot_loop(&context);
+
+    bool ok = true;
+    char* triple = LLVMGetDefaultTargetTriple();
+    char* error = NULL;
+    LLVMTargetRef target;
+    LLVMTargetMachineRef machine = NULL;
+    LLVMMemoryBufferRef assembly = NULL;
+    if (LLVMGetTargetFromTriple(triple, &target, &error)) {
+        fprintf(stderr, "No target for %s: %s\n", triple, error);
+        ok = false;
+        goto done;
+    }
+    machine = LLVMCreateTargetMachine(target, triple, "generic", "", LLVMCodeGenLevelDefault,
+                                      LLVMRelocPIC, LLVMCodeModelDefault);
+    LLVMSetTarget(context.module, triple);
+
+    // The relaxed atomic load must not be hoisted out of the loop or folded away
+    LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
+    LLVMErrorRef pass_error = LLVMRunPasses(context.module, "default<O2>", machine, options);
+    LLVMDisposePassBuilderOptions(options);
+    if (pass_error) {
+        char* message = LLVMGetErrorMessage(pass_error);
+        fprintf(stderr, "O2 pipeline failed: %s\n", message);
+        LLVMDisposeErrorMessage(message);
+        ok = false;
+        goto done;
+    }
+    if (!module_is_valid(context.module) ||
+        count_in(function, "load atomic i32, i32* @goo_preempt_requested monotonic") < 1) {
+        fprintf(stderr, "The poll did not survive O2\n");
+        ok = false;
+        goto done;
+    }
+    bool polled_in_loop = false;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(function); block; block = LLVMGetNextBasicBlock(block)) {
+        if (in_loop(block) && count_in(LLVMBasicBlockAsValue(block), "@goo_preempt_requested") > 0) {
+            polled_in_loop = true;
+        }
+    }
+    if (!polled_in_loop) {
+        fprintf(stderr, "After O2 no block inside the loop polls the flag\n");
+        ok = false;
+    }
+
+    if (LLVMTargetMachineEmitToMemoryBuffer(machine, context.module, LLVMAssemblyFile, &error, &assembly)) {
+        fprintf(stderr, "Failed to compile the hot loop: %s\n", error);
+        ok = false;
+        goto done;
+    }
+
+#if defined(__x86_64__)
+    // Initial-exec TLS: the flag is read straight off %fs
+    const char* text = LLVMGetBufferStart(assembly);
+    if (!strstr(text, "goo_preempt_requested@GOTTPOFF") || !strstr(text, "%fs:")) {
+        fprintf(stderr, "The compiled poll is not an initial-exec %%fs load:\n%s\n", text);
+        ok = false;
+    }
+#endif
+
+done:
+    if (assembly) LLVMDisposeMemoryBuffer(assembly);
+    if (machine) LLVMDisposeTargetMachine(machine);
+    LLVMDisposeMessage(error);
+    LLVMDisposeMessage(triple);
+    context_dispose(&context);
+    return ok;
+}
+
+int main(void) {
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+
+    int failed = 0;
+    if (!test_emitted_polls()) failed++;
+    if (!test_polls_omitted()) failed++;
+    if (!test_compiled_poll()) failed++;
+
+    if (failed) {
+        printf("%d safepoint codegen test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All safepoint codegen tests passed\n");
+    return 0;
+}
@@ -0,0 +1,959 @@
+/**
+ * simd_codegen_test.c
+ *
+ * Lowers comptime SIMD declarations through codegen_simd.c and checks the
+ * IR: native vector types, internal always-inlined helpers, and the vector
+ * instructions and intrinsics each operation uses. A chain of operations is
+ * then optimized to check the helpers inline and the values stay in vector
+ * registers. Finally the lowered operations are JIT-compiled and run
+ * against scalar references, including saturation, the division guards,
+ * NaN-skipping reductions and masked accesses next to a guard page.
+ */
+
+/* Ensure mmap's MAP_ANONYMOUS is available */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <llvm-c/Core.h>
+#include <llvm-c/Analysis.h>
+#include <llvm-c/ExecutionEngine.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/Transforms/PassBuilder.h>
+#include "codegen.h"
+#include "codegen_simd.h"
+
+static void context_init(GooCodegenContext* context, const char* name) {
+    memset(context, 0, sizeof(*context));
+    context->context = LLVMContextCreate();
+    context->module = LLVMModuleCreateWithNameInContext(name, context->context);
+    context->builder = LLVMCreateBuilderInContext(context->context);
+    context->mode = GOO_MODE_COMPILE;
+}
+
+static void context_dispose(GooCodegenContext* context) {
+    LLVMDisposeBuilder(context->builder);
+    if (context->module) LLVMDisposeModule(context->module);
+    LLVMContextDispose(context->context);
+}
+
+static GooSIMDTypeNode simd_type(const char* name, GooVectorDataType data_type, int width,
+                                 bool is_safe, size_t alignment) {
+    GooSIMDTypeNode type_node;
+    memset(&type_node, 0, sizeof(type_node));
+    type_node.name = (char*)name;
+    type_node.data_type = data_type;
+    type_node.vector_width = width;
+    type_node.simd_type = GOO_SIMD_AUTO;
+    type_node.is_safe = is_safe;
+    type_node.alignment = alignment;
+    return type_node;
+}
+
+static GooSIMDOpNode simd_op(const char* name, GooVectorOp op, bool is_masked, bool is_fused) {
+    GooSIMDOpNode op_node;
+    memset(&op_node, 0, sizeof(op_node));
+    op_node.name = (char*)name;
+    op_node.op = op;
+    op_node.is_masked = is_masked;
+    op_node.is_fused = is_fused;
+    return op_node;
+}
+
+static bool module_is_valid(LLVMModuleRef module) {
+    char* error = NULL;
+    bool valid = !LLVMVerifyModule(module, LLVMReturnStatusAction, &error);
+    if (!valid) {
+        fprintf(stderr, "Emitted module is invalid: %s\n", error);
+    }
+    LLVMDisposeMessage(error);
+    return valid;
+}
+
+static bool run_passes(LLVMModuleRef module, const char* pipeline) {
+    LLVMPassBuilderOptionsRef options = LLVMCreatePassBuilderOptions();
+    LLVMErrorRef error = LLVMRunPasses(module, pipeline, NULL, options);
+    LLVMDisposePassBuilderOptions(options);
+    if (error) {
+        char* message = LLVMGetErrorMessage(error);
+        fprintf(stderr, "Pipeline %s failed: %s\n", pipeline, message);
+        LLVMDisposeErrorMessage(message);
+        return false;
+    }
+    return true;
+}
+
+static const char* callee_name(LLVMValueRef call) {
+    size_t length;
+    LLVMValueRef callee = LLVMGetCalledValue(call);
+    return callee ? LLVMGetValueName2(callee, &length) : "";
+}
+
+// Calls in func to the function named name, or to any function when name is NULL
+static int count_calls(LLVMValueRef func, const char* name) {
+    int count = 0;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetInstructionOpcode(inst) == LLVMCall && (!name || strcmp(callee_name(inst), name) == 0)) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static int count_opcode(LLVMValueRef func, LLVMOpcode opcode) {
+    int count = 0;
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetInstructionOpcode(inst) == opcode) count++;
+        }
+    }
+    return count;
+}
+
+// First instruction of opcode in func, or NULL
+static LLVMValueRef find_opcode(LLVMValueRef func, LLVMOpcode opcode) {
+    for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(func); block; block = LLVMGetNextBasicBlock(block)) {
+        for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+            if (LLVMGetInstructionOpcode(inst) == opcode) return inst;
+        }
+    }
+    return NULL;
+}
+
+static bool is_inlined_helper(GooCodegenContext* context, LLVMValueRef func, const char* name) {
+    size_t length;
+    unsigned kind = LLVMGetEnumAttributeKindForName("alwaysinline", 12);
+    if (!func || strcmp(LLVMGetValueName2(func, &length), name) != 0 ||
+        LLVMGetLinkage(func) != LLVMInternalLinkage ||
+        !LLVMGetEnumAttributeAtIndex(func, LLVMAttributeFunctionIndex, kind)) {
+        fprintf(stderr, "%s is missing or not an internal always-inlined helper\n", name);
+        return false;
+    }
+    (void)context;
+    return true;
+}
+
+static bool is_vector_of(LLVMTypeRef type, LLVMTypeKind elem_kind, unsigned bits, unsigned width) {
+    if (!type || LLVMGetTypeKind(type) != LLVMVectorTypeKind || LLVMGetVectorSize(type) != width) {
+        return false;
+    }
+    LLVMTypeRef elem = LLVMGetElementType(type);
+    return LLVMGetTypeKind(elem) == elem_kind &&
+           (elem_kind != LLVMIntegerTypeKind || LLVMGetIntTypeWidth(elem) == bits);
+}
+
+static bool test_vector_types(void) {
+    printf("Testing native vector types...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "simd_types");
+    bool ok = true;
+
+    static const struct {
+        GooVectorDataType data_type;
+        int width;
+        LLVMTypeKind elem_kind;
+        unsigned bits;
+    } cases[] = {
+        { GOO_VEC_FLOAT, 4, LLVMFloatTypeKind, 32 },
+        { GOO_VEC_DOUBLE, 3, LLVMDoubleTypeKind, 64 },
+        { GOO_VEC_INT8, 16, LLVMIntegerTypeKind, 8 },
+        { GOO_VEC_UINT16, 8, LLVMIntegerTypeKind, 16 },
+        { GOO_VEC_INT32, 1, LLVMIntegerTypeKind, 32 },
+        { GOO_VEC_UINT64, 64, LLVMIntegerTypeKind, 64 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        GooSIMDTypeNode type_node = simd_type("Vec", cases[i].data_type, cases[i].width, false, 0);
+        LLVMTypeRef vec_type = goo_codegen_simd_vector_type(&context, &type_node);
+        if (!is_vector_of(vec_type, cases[i].elem_kind, cases[i].bits, (unsigned)cases[i].width)) {
+            fprintf(stderr, "Vector type %zu is not a %u-lane vector of the element type\n",
+                    i, (unsigned)cases[i].width);
+            ok = false;
+        }
+    }
+
+    // Widths outside 1..64 and unknown element types are rejected
+    GooSIMDTypeNode empty = simd_type("Empty", GOO_VEC_FLOAT, 0, false, 0);
+    GooSIMDTypeNode wide = simd_type("Wide", GOO_VEC_FLOAT, 65, false, 0);
+    GooSIMDTypeNode unknown = simd_type("Unknown", (GooVectorDataType)99, 4, false, 0);
+    if (goo_codegen_simd_vector_type(&context, &empty) || goo_codegen_simd_vector_type(&context, &wide) ||
+        goo_codegen_simd_vector_type(&context, &unknown)) {
+        fprintf(stderr, "An unsupported SIMD type got a vector type\n");
+        ok = false;
+    }
+
+    context_dispose(&context);
+    return ok;
+}
+
+static bool check_memory_helper(LLVMValueRef func, LLVMOpcode opcode, unsigned alignment) {
+    LLVMValueRef access = find_opcode(func, opcode);
+    LLVMTypeRef type = access ? LLVMTypeOf(opcode == LLVMLoad ? access : LLVMGetOperand(access, 0)) : NULL;
+    if (!access || LLVMGetTypeKind(type) != LLVMVectorTypeKind || LLVMGetAlignment(access) != alignment ||
+        count_opcode(func, opcode) != 1 || count_calls(func, NULL) != 0) {
+        fprintf(stderr, "Helper does not do one vector %s aligned to %u\n",
+                opcode == LLVMLoad ? "load" : "store", alignment);
+        return false;
+    }
+    return true;
+}
+
+static bool test_type_helpers(void) {
+    printf("Testing the generated type helpers...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "simd_helpers");
+    bool ok = true;
+
+    GooSIMDTypeNode float4 = simd_type("Float4", GOO_VEC_FLOAT, 4, false, 16);
+    LLVMTypeRef float4_type = goo_codegen_simd_vector_type(&context, &float4);
+    GooSIMDTypeHelpers helpers;
+    goo_codegen_simd_emit_type_helpers(&context, &float4, float4_type, &helpers);
+
+    ok &= is_inlined_helper(&context, helpers.load, "Float4Load");
+    ok &= is_inlined_helper(&context, helpers.store, "Float4Store");
+    ok &= is_inlined_helper(&context, helpers.masked_load, "Float4MaskedLoad");
+    ok &= is_inlined_helper(&context, helpers.masked_store, "Float4MaskedStore");
+    ok &= is_inlined_helper(&context, helpers.reduce_add, "Float4ReduceAdd");
+    ok &= is_inlined_helper(&context, helpers.reduce_min, "Float4ReduceMin");
+    ok &= is_inlined_helper(&context, helpers.reduce_max, "Float4ReduceMax");
+    if (!ok) {
+        context_dispose(&context);
+        return false;
+    }
+
+    // Plain accesses use the declared alignment
+    ok &= check_memory_helper(helpers.load, LLVMLoad, 16);
+    ok &= check_memory_helper(helpers.store, LLVMStore, 16);
+
+    // Masked accesses go through the intrinsics; the mask is <4 x i32>
+    LLVMTypeRef masked_params[3];
+    LLVMGetParamTypes(LLVMGlobalGetValueType(helpers.masked_load), masked_params);
+    if (count_calls(helpers.masked_load, "llvm.masked.load.v4f32.p0v4f32") != 1 ||
+        count_calls(helpers.masked_store, "llvm.masked.store.v4f32.p0v4f32") != 1 ||
+        !is_vector_of(masked_params[1], LLVMIntegerTypeKind, 32, 4) ||
+        count_opcode(helpers.masked_load, LLVMLoad) != 0 || count_opcode(helpers.masked_store, LLVMStore) != 0) {
+        fprintf(stderr, "Masked helpers do not use llvm.masked.load/store with an integer mask\n");
+        ok = false;
+    }
+
+    // Power-of-two float sums are a shuffle tree; min and max skip NaN
+    if (count_opcode(helpers.reduce_add, LLVMShuffleVector) != 2 ||
+        count_opcode(helpers.reduce_add, LLVMFAdd) != 2 || count_calls(helpers.reduce_add, NULL) != 0 ||
+        count_calls(helpers.reduce_min, "llvm.vector.reduce.fmin.v4f32") != 1 ||
+        count_calls(helpers.reduce_max, "llvm.vector.reduce.fmax.v4f32") != 1) {
+        fprintf(stderr, "Float4 reductions are not lowered as expected\n");
+        ok = false;
+    }
+
+    // Other widths and element types
+    GooSIMDTypeNode float3 = simd_type("Float3", GOO_VEC_FLOAT, 3, false, 0);
+    GooSIMDTypeNode int16x8 = simd_type("Int16x8", GOO_VEC_INT16, 8, false, 0);
+    GooSIMDTypeNode uint8x16 = simd_type("UInt8x16", GOO_VEC_UINT8, 16, false, 0);
+    GooSIMDTypeHelpers float3_helpers, int16_helpers, uint8_helpers;
+    goo_codegen_simd_emit_type_helpers(&context, &float3, goo_codegen_simd_vector_type(&context, &float3),
+                                       &float3_helpers);
+    goo_codegen_simd_emit_type_helpers(&context, &int16x8, goo_codegen_simd_vector_type(&context, &int16x8),
+                                       &int16_helpers);
+    goo_codegen_simd_emit_type_helpers(&context, &uint8x16, goo_codegen_simd_vector_type(&context, &uint8x16),
+                                       &uint8_helpers);
+
+    if (count_calls(float3_helpers.reduce_add, "llvm.vector.reduce.fadd.v3f32") != 1 ||
+        count_calls(int16_helpers.reduce_add, "llvm.vector.reduce.add.v8i16") != 1 ||
+        count_calls(int16_helpers.reduce_min, "llvm.vector.reduce.smin.v8i16") != 1 ||
+        count_calls(uint8_helpers.reduce_max, "llvm.vector.reduce.umax.v16i8") != 1 ||
+        count_calls(uint8_helpers.reduce_min, "llvm.vector.reduce.umin.v16i8") != 1) {
+        fprintf(stderr, "Integer and odd-width reductions use the wrong intrinsics\n");
+        ok = false;
+    }
+
+    // Without a declared alignment, accesses are aligned to the element
+    ok &= check_memory_helper(int16_helpers.load, LLVMLoad, 2);
+    ok &= check_memory_helper(float3_helpers.store, LLVMStore, 4);
+
+    // A second declaration of the same type emits nothing
+    GooSIMDTypeHelpers again;
+    goo_codegen_simd_emit_type_helpers(&context, &float4, float4_type, &again);
+    if (again.load || again.store || again.masked_load || again.masked_store ||
+        again.reduce_add || again.reduce_min || again.reduce_max) {
+        fprintf(stderr, "Helpers were emitted twice\n");
+        ok = false;
+    }
+
+    ok &= module_is_valid(context.module);
+    context_dispose(&context);
+    return ok;
+}
+
+typedef struct {
+    const char* name;
+    int type;                       // Index into the declared types
+    GooVectorOp op;
+    bool masked;
+    bool fused;
+    unsigned params;                // 0 when no function is emitted
+    const char* calls[2];           // Intrinsics the function must call
+    LLVMOpcode opcode;              // An instruction it must contain, or 0
+    bool no_calls;                  // Lowered to plain instructions only
+} OpCase;
+
+static bool check_operation(GooCodegenContext* context, const OpCase* test, GooSIMDTypeNode* type_node,
+                            LLVMTypeRef vec_type) {
+    GooSIMDOpNode op_node = simd_op(test->name, test->op, test->masked, test->fused);
+    LLVMValueRef func = goo_codegen_simd_emit_operation(context, &op_node, type_node, vec_type);
+
+    if (test->params == 0) {
+        if (func) {
+            fprintf(stderr, "%s should not have been lowered\n", test->name);
+            return false;
+        }
+        return true;
+    }
+    if (!is_inlined_helper(context, func, test->name)) return false;
+
+    LLVMTypeRef func_type = LLVMGlobalGetValueType(func);
+    if (LLVMCountParamTypes(func_type) != test->params || LLVMGetReturnType(func_type) != vec_type) {
+        fprintf(stderr, "%s takes %u parameters, expected %u\n", test->name,
+                LLVMCountParamTypes(func_type), test->params);
+        return false;
+    }
+    for (int i = 0; i < 2 && test->calls[i]; i++) {
+        if (count_calls(func, test->calls[i]) != 1) {
+            fprintf(stderr, "%s does not call %s\n", test->name, test->calls[i]);
+            return false;
+        }
+    }
+    if ((test->opcode && count_opcode(func, test->opcode) == 0) ||
+        (test->no_calls && count_calls(func, NULL) != 0)) {
+        fprintf(stderr, "%s is not lowered to the expected instructions\n", test->name);
+        return false;
+    }
+
+    // Masked ops blend the result with a under the mask just before returning
+    LLVMValueRef ret = LLVMGetLastInstruction(LLVMGetLastBasicBlock(func));
+    LLVMValueRef result = LLVMGetNumOperands(ret) > 0 ? LLVMGetOperand(ret, 0) : NULL;
+    if (test->masked) {
+        LLVMTypeRef params[5];
+        LLVMGetParamTypes(func_type, params);
+        unsigned elem_bits = LLVMGetTypeKind(LLVMGetElementType(vec_type)) == LLVMIntegerTypeKind ?
+            LLVMGetIntTypeWidth(LLVMGetElementType(vec_type)) :
+            LLVMGetTypeKind(LLVMGetElementType(vec_type)) == LLVMFloatTypeKind ? 32 : 64;
+        if (!is_vector_of(params[test->params - 1], LLVMIntegerTypeKind, elem_bits, LLVMGetVectorSize(vec_type)) ||
+            !result || !LLVMIsAInstruction(result) || LLVMGetInstructionOpcode(result) != LLVMSelect ||
+            LLVMGetOperand(result, 2) != LLVMGetParam(func, 0)) {
+            fprintf(stderr, "%s does not blend its result under the mask\n", test->name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_operations(void) {
+    printf("Testing the lowered operations...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "simd_ops");
+
+    GooSIMDTypeNode types[] = {
+        simd_type("Float4", GOO_VEC_FLOAT, 4, false, 16),
+        simd_type("Int32x4", GOO_VEC_INT32, 4, false, 16),
+        simd_type("SafeInt32x4", GOO_VEC_INT32, 4, true, 16),
+        simd_type("SafeUInt8x16", GOO_VEC_UINT8, 16, true, 16),
+        simd_type("UInt32x4", GOO_VEC_UINT32, 4, false, 16),
+        simd_type("Double2", GOO_VEC_DOUBLE, 2, false, 16),
+    };
+    LLVMTypeRef vec_types[sizeof(types) / sizeof(types[0])];
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        vec_types[i] = goo_codegen_simd_vector_type(&context, &types[i]);
+    }
+
+    static const OpCase cases[] = {
+        { "Float4Add", 0, GOO_VECTOR_ADD, false, false, 2, { NULL }, LLVMFAdd, true },
+        { "Float4Sub", 0, GOO_VECTOR_SUB, false, false, 2, { NULL }, LLVMFSub, true },
+        { "Float4Mul", 0, GOO_VECTOR_MUL, false, false, 2, { NULL }, LLVMFMul, true },
+        { "Float4Div", 0, GOO_VECTOR_DIV, false, false, 2, { NULL }, LLVMFDiv, true },
+        { "Float4Fma", 0, GOO_VECTOR_FMA, false, false, 3, { "llvm.fma.v4f32" }, 0, false },
+        { "Float4FusedMul", 0, GOO_VECTOR_MUL, false, true, 3, { "llvm.fma.v4f32" }, 0, false },
+        { "Float4Abs", 0, GOO_VECTOR_ABS, false, false, 1, { "llvm.fabs.v4f32" }, 0, false },
+        { "Float4Sqrt", 0, GOO_VECTOR_SQRT, false, false, 1, { "llvm.sqrt.v4f32" }, 0, false },
+        { "Float4MaskedAdd", 0, GOO_VECTOR_ADD, true, false, 3, { NULL }, LLVMFAdd, true },
+        { "Float4MaskedFma", 0, GOO_VECTOR_FMA, true, false, 4, { "llvm.fma.v4f32" }, 0, false },
+        { "Float4Custom", 0, GOO_VECTOR_CUSTOM, false, false, 0, { NULL }, 0, false },
+        { "Int32x4Add", 1, GOO_VECTOR_ADD, false, false, 2, { NULL }, LLVMAdd, true },
+        { "Int32x4Mul", 1, GOO_VECTOR_MUL, false, false, 2, { NULL }, LLVMMul, true },
+        { "Int32x4Fma", 1, GOO_VECTOR_FMA, false, false, 3, { NULL }, LLVMMul, true },
+        { "Int32x4Div", 1, GOO_VECTOR_DIV, false, false, 2, { NULL }, LLVMSDiv, true },
+        { "Int32x4Abs", 1, GOO_VECTOR_ABS, false, false, 1, { "llvm.abs.v4i32" }, 0, false },
+        { "Int32x4Sqrt", 1, GOO_VECTOR_SQRT, false, false, 0, { NULL }, 0, false },
+        { "Int32x4MaskedSub", 1, GOO_VECTOR_SUB, true, false, 3, { NULL }, LLVMSub, true },
+        { "SafeInt32x4Add", 2, GOO_VECTOR_ADD, false, false, 2, { "llvm.sadd.sat.v4i32" }, 0, false },
+        { "SafeInt32x4Sub", 2, GOO_VECTOR_SUB, false, false, 2, { "llvm.ssub.sat.v4i32" }, 0, false },
+        { "SafeInt32x4Mul", 2, GOO_VECTOR_MUL, false, false, 2, { "llvm.smul.fix.sat.v4i32" }, 0, false },
+        { "SafeInt32x4Fma", 2, GOO_VECTOR_FMA, false, false, 3,
+          { "llvm.smul.fix.sat.v4i32", "llvm.sadd.sat.v4i32" }, 0, false },
+        { "SafeUInt8x16Add", 3, GOO_VECTOR_ADD, false, false, 2, { "llvm.uadd.sat.v16i8" }, 0, false },
+        { "SafeUInt8x16Sub", 3, GOO_VECTOR_SUB, false, false, 2, { "llvm.usub.sat.v16i8" }, 0, false },
+        { "SafeUInt8x16Mul", 3, GOO_VECTOR_MUL, false, false, 2, { "llvm.umul.fix.sat.v16i8" }, 0, false },
+        { "SafeUInt8x16MaskedAdd", 3, GOO_VECTOR_ADD, true, false, 3, { "llvm.uadd.sat.v16i8" }, 0, false },
+        { "UInt32x4Div", 4, GOO_VECTOR_DIV, false, false, 2, { NULL }, LLVMUDiv, true },
+        { "Double2Sqrt", 5, GOO_VECTOR_SQRT, false, false, 1, { "llvm.sqrt.v2f64" }, 0, false },
+        { "Double2MaskedMul", 5, GOO_VECTOR_MUL, true, false, 3, { NULL }, LLVMFMul, true },
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ok &= check_operation(&context, &cases[i], &types[cases[i].type], vec_types[cases[i].type]);
+    }
+
+    // Unsigned ABS is the identity
+    GooSIMDOpNode abs_node = simd_op("UInt32x4Abs", GOO_VECTOR_ABS, false, false);
+    LLVMValueRef abs_func = goo_codegen_simd_emit_operation(&context, &abs_node, &types[4], vec_types[4]);
+    LLVMValueRef ret = abs_func ? LLVMGetLastInstruction(LLVMGetEntryBasicBlock(abs_func)) : NULL;
+    if (!ret || LLVMGetOperand(ret, 0) != LLVMGetParam(abs_func, 0)) {
+        fprintf(stderr, "Unsigned ABS does not return its operand\n");
+        ok = false;
+    }
+
+    // Signed division guards the zero divisor and MIN / -1 with selects
+    LLVMValueRef div = LLVMGetNamedFunction(context.module, "Int32x4Div");
+    if (div && count_opcode(div, LLVMSelect) < 4) {
+        fprintf(stderr, "Int32x4Div has %d selects, expected the zero and overflow guards\n",
+                count_opcode(div, LLVMSelect));
+        ok = false;
+    }
+
+    ok &= module_is_valid(context.module);
+    context_dispose(&context);
+    return ok;
+}
+
+static LLVMValueRef call_function(GooCodegenContext* context, LLVMValueRef func, LLVMValueRef* args,
+                                  unsigned arg_count, const char* label) {
+    return LLVMBuildCall2(context->builder, LLVMGlobalGetValueType(func), func, args, arg_count, label);
+}
+
+// Load a mask vector of mask_type from an element pointer
+static LLVMValueRef load_mask(GooCodegenContext* context, LLVMValueRef ptr, LLVMTypeRef mask_type) {
+    LLVMValueRef vec_ptr = LLVMBuildBitCast(context->builder, ptr, LLVMPointerType(mask_type, 0), "mask.ptr");
+    LLVMValueRef mask = LLVMBuildLoad2(context->builder, mask_type, vec_ptr, "mask");
+    LLVMSetAlignment(mask, 1);
+    return mask;
+}
+
+static LLVMTypeRef mask_type_of(GooCodegenContext* context, LLVMTypeRef vec_type) {
+    LLVMTypeRef elem = LLVMGetElementType(vec_type);
+    unsigned bits = LLVMGetTypeKind(elem) == LLVMIntegerTypeKind ? LLVMGetIntTypeWidth(elem) :
+                    LLVMGetTypeKind(elem) == LLVMFloatTypeKind ? 32 : 64;
+    return LLVMVectorType(LLVMIntTypeInContext(context->context, bits), LLVMGetVectorSize(vec_type));
+}
+
+// void name(elem* a, elem* b, elem* c, mask* m, elem* out): out = op(a[, b][, c][, m])
+static void emit_op_wrapper(GooCodegenContext* context, const char* name, GooSIMDTypeHelpers* helpers,
+                            LLVMValueRef op, LLVMTypeRef vec_type, bool masked) {
+    LLVMTypeRef elem_ptr = LLVMPointerType(LLVMGetElementType(vec_type), 0);
+    LLVMTypeRef mask_type = mask_type_of(context, vec_type);
+    LLVMTypeRef params[] = { elem_ptr, elem_ptr, elem_ptr, LLVMPointerType(LLVMGetElementType(mask_type), 0),
+                             elem_ptr };
+    LLVMValueRef func = LLVMAddFunction(context->module, name,
+        LLVMFunctionType(LLVMVoidTypeInContext(context->context), params, 5, false));
+    LLVMPositionBuilderAtEnd(context->builder, LLVMAppendBasicBlockInContext(context->context, func, "entry"));
+
+    unsigned op_params = LLVMCountParamTypes(LLVMGlobalGetValueType(op));
+    LLVMValueRef args[4];
+    for (unsigned i = 0; i < op_params; i++) {
+        LLVMValueRef ptr = LLVMGetParam(func, i);
+        if (masked && i == op_params - 1) {
+            args[i] = load_mask(context, LLVMGetParam(func, 3), mask_type);
+        } else {
+            args[i] = call_function(context, helpers->load, &ptr, 1, "operand");
+        }
+    }
+    LLVMValueRef result = call_function(context, op, args, op_params, "result");
+    LLVMValueRef store_args[] = { LLVMGetParam(func, 4), result };
+    call_function(context, helpers->store, store_args, 2, "");
+    LLVMBuildRetVoid(context->builder);
+}
+
+// elem name(elem* a): reduce(load(a))
+static void emit_reduce_wrapper(GooCodegenContext* context, const char* name, GooSIMDTypeHelpers* helpers,
+                                LLVMValueRef reduce, LLVMTypeRef vec_type) {
+    LLVMTypeRef elem = LLVMGetElementType(vec_type);
+    LLVMTypeRef elem_ptr = LLVMPointerType(elem, 0);
+    LLVMValueRef func = LLVMAddFunction(context->module, name, LLVMFunctionType(elem, &elem_ptr, 1, false));
+    LLVMPositionBuilderAtEnd(context->builder, LLVMAppendBasicBlockInContext(context->context, func, "entry"));
+
+    LLVMValueRef ptr = LLVMGetParam(func, 0);
+    LLVMValueRef vec = call_function(context, helpers->load, &ptr, 1, "vec");
+    LLVMBuildRet(context->builder, call_function(context, reduce, &vec, 1, "sum"));
+}
+
+// void name(elem* p, mask* m, elem* passthru, elem* out): out = masked_load(p, m, passthru)
+// void name(elem* p, mask* m, elem* v, elem* unused): masked_store(p, v, m)
+static void emit_masked_wrappers(GooCodegenContext* context, GooSIMDTypeHelpers* helpers, LLVMTypeRef vec_type) {
+    LLVMTypeRef elem_ptr = LLVMPointerType(LLVMGetElementType(vec_type), 0);
+    LLVMTypeRef mask_type = mask_type_of(context, vec_type);
+    LLVMTypeRef params[] = { elem_ptr, LLVMPointerType(LLVMGetElementType(mask_type), 0), elem_ptr, elem_ptr };
+    LLVMTypeRef func_type = LLVMFunctionType(LLVMVoidTypeInContext(context->context), params, 4, false);
+
+    LLVMValueRef func = LLVMAddFunction(context->module, "run_masked_load", func_type);
+    LLVMPositionBuilderAtEnd(context->builder, LLVMAppendBasicBlockInContext(context->context, func, "entry"));
+    LLVMValueRef passthru_ptr = LLVMGetParam(func, 2);
+    LLVMValueRef load_args[] = {
+        LLVMGetParam(func, 0),
+        load_mask(context, LLVMGetParam(func, 1), mask_type),
+        call_function(context, helpers->load, &passthru_ptr, 1, "passthru"),
+    };
+    LLVMValueRef store_args[] = { LLVMGetParam(func, 3), call_function(context, helpers->masked_load, load_args, 3, "vec") };
+    call_function(context, helpers->store, store_args, 2, "");
+    LLVMBuildRetVoid(context->builder);
+
+    func = LLVMAddFunction(context->module, "run_masked_store", func_type);
+    LLVMPositionBuilderAtEnd(context->builder, LLVMAppendBasicBlockInContext(context->context, func, "entry"));
+    LLVMValueRef value_ptr = LLVMGetParam(func, 2);
+    LLVMValueRef masked_store_args[] = {
+        LLVMGetParam(func, 0),
+        call_function(context, helpers->load, &value_ptr, 1, "vec"),
+        load_mask(context, LLVMGetParam(func, 1), mask_type),
+    };
+    call_function(context, helpers->masked_store, masked_store_args, 3, "");
+    LLVMBuildRetVoid(context->builder);
+}
+
+static bool test_inlined_chain(void) {
+    printf("Testing that chained operations inline into vector code...\n");
+
+    GooCodegenContext context;
+    context_init(&context, "simd_chain");
+
+    GooSIMDTypeNode float4 = simd_type("Float4", GOO_VEC_FLOAT, 4, false, 16);
+    LLVMTypeRef vec_type = goo_codegen_simd_vector_type(&context, &float4);
+    GooSIMDTypeHelpers helpers;
+    goo_codegen_simd_emit_type_helpers(&context, &float4, vec_type, &helpers);
+    GooSIMDOpNode fma_node = simd_op("Float4Fma", GOO_VECTOR_FMA, false, false);
+    GooSIMDOpNode add_node = simd_op("Float4MaskedAdd", GOO_VECTOR_ADD, true, false);
+    GooSIMDOpNode sqrt_node = simd_op("Float4Sqrt", GOO_VECTOR_SQRT, false, false);
+    LLVMValueRef fma = goo_codegen_simd_emit_operation(&context, &fma_node, &float4, vec_type);
+    LLVMValueRef add = goo_codegen_simd_emit_operation(&context, &add_node, &float4, vec_type);
+    LLVMValueRef sqrt_func = goo_codegen_simd_emit_operation(&context, &sqrt_node, &float4, vec_type);
+
+    // void chain(float* x, float* y, i32* m, float* out):
+    //   out = sqrt(masked_add(fma(x, y, y), x, m)) + reduce_add(x)
+    LLVMTypeRef float_ptr = LLVMPointerType(LLVMFloatTypeInContext(context.context), 0);
+    LLVMTypeRef mask_type = mask_type_of(&context, vec_type);
+    LLVMTypeRef params[] = { float_ptr, float_ptr, LLVMPointerType(LLVMGetElementType(mask_type), 0), float_ptr };
+    LLVMValueRef chain = LLVMAddFunction(context.module, "chain",
+        LLVMFunctionType(LLVMVoidTypeInContext(context.context), params, 4, false));
+    LLVMPositionBuilderAtEnd(context.builder, LLVMAppendBasicBlockInContext(context.context, chain, "entry"));
+    LLVMValueRef x_ptr = LLVMGetParam(chain, 0), y_ptr = LLVMGetParam(chain, 1);
+    LLVMValueRef x = call_function(&context, helpers.load, &x_ptr, 1, "x");
+    LLVMValueRef y = call_function(&context, helpers.load, &y_ptr, 1, "y");
+    LLVMValueRef fma_args[] = { x, y, y };
+    LLVMValueRef t = call_function(&context, fma, fma_args, 3, "t");
+    LLVMValueRef add_args[] = { t, x, load_mask(&context, LLVMGetParam(chain, 2), mask_type) };
+    LLVMValueRef u = call_function(&context, add, add_args, 3, "u");
+    LLVMValueRef v = call_function(&context, sqrt_func, &u, 1, "v");
+    LLVMValueRef sum = call_function(&context, helpers.reduce_add, &x, 1, "sum");
+    LLVMValueRef splat = LLVMBuildInsertElement(context.builder, LLVMGetUndef(vec_type), sum,
+                                                LLVMConstInt(LLVMInt32TypeInContext(context.context), 0, false), "splat");
+    LLVMValueRef w = LLVMBuildFAdd(context.builder, v, splat, "w");
+    LLVMValueRef store_args[] = { LLVMGetParam(chain, 3), w };
+    call_function(&context, helpers.store, store_args, 2, "");
+    LLVMBuildRetVoid(context.builder);
+
+    bool ok = module_is_valid(context.module) && run_passes(context.module, "always-inline,default<O2>");
+    if (ok) {
+        // Only intrinsic calls remain and nothing is spilled to the stack:
+        // two vector loads in, one vector store out
+        int non_intrinsic = 0;
+        for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(chain); block; block = LLVMGetNextBasicBlock(block)) {
+            for (LLVMValueRef inst = LLVMGetFirstInstruction(block); inst; inst = LLVMGetNextInstruction(inst)) {
+                if (LLVMGetInstructionOpcode(inst) == LLVMCall && strncmp(callee_name(inst), "llvm.", 5) != 0) {
+                    non_intrinsic++;
+                }
+            }
+        }
+        LLVMValueRef store = find_opcode(chain, LLVMStore);
+        if (non_intrinsic != 0 || count_opcode(chain, LLVMAlloca) != 0 ||
+            count_opcode(chain, LLVMStore) != 1 || !store ||
+            LLVMGetTypeKind(LLVMTypeOf(LLVMGetOperand(store, 0))) != LLVMVectorTypeKind ||
+            count_calls(chain, "llvm.fma.v4f32") != 1 || count_calls(chain, "llvm.sqrt.v4f32") != 1) {
+            char* ir = LLVMPrintValueToString(chain);
+            fprintf(stderr, "The optimized chain still calls helpers or goes through memory:\n%s\n", ir);
+            LLVMDisposeMessage(ir);
+            ok = false;
+        }
+        if (LLVMGetNamedFunction(context.module, "Float4Fma")) {
+            fprintf(stderr, "Inlined helpers were not removed\n");
+            ok = false;
+        }
+    }
+
+    context_dispose(&context);
+    return ok;
+}
+
+// ===== Execution =====
+
+typedef void (*OpFunc)(const void* a, const void* b, const void* c, const void* mask, void* out);
+
+enum {
+    SAFE_INT8,
+    SAFE_UINT8,
+    INT32,
+    UINT32,
+    FLOAT4,
+    FLOAT8,
+    FLOAT3,
+    JIT_TYPE_COUNT
+};
+
+typedef struct {
+    LLVMExecutionEngineRef engine;
+    GooCodegenContext context;
+} Jit;
+
+static const struct {
+    const char* name;
+    GooVectorDataType data_type;
+    int width;
+    bool is_safe;
+} jit_types[JIT_TYPE_COUNT] = {
+    [SAFE_INT8] = { "SafeInt8x16", GOO_VEC_INT8, 16, true },
+    [SAFE_UINT8] = { "SafeUInt8x16", GOO_VEC_UINT8, 16, true },
+    [INT32] = { "Int32x4", GOO_VEC_INT32, 4, false },
+    [UINT32] = { "UInt32x4", GOO_VEC_UINT32, 4, false },
+    [FLOAT4] = { "Float4", GOO_VEC_FLOAT, 4, false },
+    [FLOAT8] = { "Float8", GOO_VEC_FLOAT, 8, false },
+    [FLOAT3] = { "Float3", GOO_VEC_FLOAT, 3, false },
+};
+
+static const struct {
+    const char* name;
+    int type;
+    GooVectorOp op;
+    bool masked;
+} jit_ops[] = {
+    { "SafeInt8x16Add", SAFE_INT8, GOO_VECTOR_ADD, false },
+    { "SafeInt8x16Sub", SAFE_INT8, GOO_VECTOR_SUB, false },
+    { "SafeInt8x16Mul", SAFE_INT8, GOO_VECTOR_MUL, false },
+    { "SafeInt8x16Fma", SAFE_INT8, GOO_VECTOR_FMA, false },
+    { "SafeUInt8x16Add", SAFE_UINT8, GOO_VECTOR_ADD, false },
+    { "SafeUInt8x16Sub", SAFE_UINT8, GOO_VECTOR_SUB, false },
+    { "SafeUInt8x16Mul", SAFE_UINT8, GOO_VECTOR_MUL, false },
+    { "Int32x4Div", INT32, GOO_VECTOR_DIV, false },
+    { "Int32x4Abs", INT32, GOO_VECTOR_ABS, false },
+    { "UInt32x4Div", UINT32, GOO_VECTOR_DIV, false },
+    { "Float4MaskedAdd", FLOAT4, GOO_VECTOR_ADD, true },
+    { "Float4Fma", FLOAT4, GOO_VECTOR_FMA, false },
+};
+
+static bool jit_create(Jit* jit) {
+    GooCodegenContext* context = &jit->context;
+    context_init(context, "simd_jit");
+
+    GooSIMDTypeNode type_nodes[JIT_TYPE_COUNT];
+    LLVMTypeRef vec_types[JIT_TYPE_COUNT];
+    GooSIMDTypeHelpers helpers[JIT_TYPE_COUNT];
+    char name[64];
+    for (int i = 0; i < JIT_TYPE_COUNT; i++) {
+        type_nodes[i] = simd_type(jit_types[i].name, jit_types[i].data_type, jit_types[i].width,
+                                  jit_types[i].is_safe, 0);
+        vec_types[i] = goo_codegen_simd_vector_type(context, &type_nodes[i]);
+        goo_codegen_simd_emit_type_helpers(context, &type_nodes[i], vec_types[i], &helpers[i]);
+
+        snprintf(name, sizeof(name), "run_%sReduceAdd", jit_types[i].name);
+        emit_reduce_wrapper(context, name, &helpers[i], helpers[i].reduce_add, vec_types[i]);
+        snprintf(name, sizeof(name), "run_%sReduceMin", jit_types[i].name);
+        emit_reduce_wrapper(context, name, &helpers[i], helpers[i].reduce_min, vec_types[i]);
+        snprintf(name, sizeof(name), "run_%sReduceMax", jit_types[i].name);
+        emit_reduce_wrapper(context, name, &helpers[i], helpers[i].reduce_max, vec_types[i]);
+    }
+    for (size_t i = 0; i < sizeof(jit_ops) / sizeof(jit_ops[0]); i++) {
+        int type = jit_ops[i].type;
+        GooSIMDOpNode op_node = simd_op(jit_ops[i].name, jit_ops[i].op, jit_ops[i].masked, false);
+        LLVMValueRef op = goo_codegen_simd_emit_operation(context, &op_node, &type_nodes[type], vec_types[type]);
+        if (!op) return false;
+        snprintf(name, sizeof(name), "run_%s", jit_ops[i].name);
+        emit_op_wrapper(context, name, &helpers[type], op, vec_types[type], jit_ops[i].masked);
+    }
+    emit_masked_wrappers(context, &helpers[FLOAT4], vec_types[FLOAT4]);
+
+    if (!module_is_valid(context->module) || !run_passes(context->module, "always-inline,default<O2>")) {
+        return false;
+    }
+
+    struct LLVMMCJITCompilerOptions options;
+    LLVMInitializeMCJITCompilerOptions(&options, sizeof(options));
+    char* error = NULL;
+    if (LLVMCreateMCJITCompilerForModule(&jit->engine, context->module, &options, sizeof(options), &error)) {
+        fprintf(stderr, "Failed to create the JIT: %s\n", error);
+        LLVMDisposeMessage(error);
+        return false;
+    }
+    context->module = NULL;     // Owned by the engine now
+    return true;
+}
+
+static void* jit_function(Jit* jit, const char* name) {
+    void* func = (void*)(uintptr_t)LLVMGetFunctionAddress(jit->engine, name);
+    if (!func) {
+        fprintf(stderr, "JIT has no function %s\n", name);
+    }
+    return func;
+}
+
+static void jit_dispose(Jit* jit) {
+    if (jit->engine) LLVMDisposeExecutionEngine(jit->engine);
+    context_dispose(&jit->context);
+}
+
+static int clamp(int value, int min, int max) {
+    return value < min ? min : value > max ? max : value;
+}
+
+// Every int8 and uint8 pair against clamped scalar arithmetic
+static bool check_saturating(Jit* jit) {
+    OpFunc signed_ops[] = {
+        (OpFunc)jit_function(jit, "run_SafeInt8x16Add"), (OpFunc)jit_function(jit, "run_SafeInt8x16Sub"),
+        (OpFunc)jit_function(jit, "run_SafeInt8x16Mul"), (OpFunc)jit_function(jit, "run_SafeInt8x16Fma"),
+    };
+    OpFunc unsigned_ops[] = {
+        (OpFunc)jit_function(jit, "run_SafeUInt8x16Add"), (OpFunc)jit_function(jit, "run_SafeUInt8x16Sub"),
+        (OpFunc)jit_function(jit, "run_SafeUInt8x16Mul"),
+    };
+    for (int i = 0; i < 4; i++) if (!signed_ops[i]) return false;
+    for (int i = 0; i < 3; i++) if (!unsigned_ops[i]) return false;
+
+    for (int a = 0; a < 256; a++) {
+        for (int b0 = 0; b0 < 256; b0 += 16) {
+            int8_t sa[16], sb[16], sc[16], out[16];
+            uint8_t ua[16], ub[16], uout[16];
+            for (int lane = 0; lane < 16; lane++) {
+                sa[lane] = (int8_t)a;
+                sb[lane] = (int8_t)(b0 + lane);
+                sc[lane] = (int8_t)(a * 7 + lane * 13);
+                ua[lane] = (uint8_t)a;
+                ub[lane] = (uint8_t)(b0 + lane);
+            }
+
+            for (int op = 0; op < 4; op++) {
+                signed_ops[op](sa, sb, sc, NULL, out);
+                for (int lane = 0; lane < 16; lane++) {
+                    int x = sa[lane], y = sb[lane];
+                    int expected = op == 0 ? clamp(x + y, -128, 127) :
+                                   op == 1 ? clamp(x - y, -128, 127) :
+                                   op == 2 ? clamp(x * y, -128, 127) :
+                                             clamp(clamp(x * y, -128, 127) + sc[lane], -128, 127);
+                    if (out[lane] != expected) {
+                        fprintf(stderr, "SafeInt8x16 op %d on %d, %d gave %d, expected %d\n",
+                                op, x, y, out[lane], expected);
+                        return false;
+                    }
+                }
+            }
+            for (int op = 0; op < 3; op++) {
+                unsigned_ops[op](ua, ub, NULL, NULL, uout);
+                for (int lane = 0; lane < 16; lane++) {
+                    int x = ua[lane], y = ub[lane];
+                    int expected = op == 0 ? clamp(x + y, 0, 255) :
+                                   op == 1 ? clamp(x - y, 0, 255) : clamp(x * y, 0, 255);
+                    if (uout[lane] != expected) {
+                        fprintf(stderr, "SafeUInt8x16 op %d on %d, %d gave %d, expected %d\n",
+                                op, x, y, uout[lane], expected);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_division(Jit* jit) {
+    OpFunc sdiv = (OpFunc)jit_function(jit, "run_Int32x4Div");
+    OpFunc udiv = (OpFunc)jit_function(jit, "run_UInt32x4Div");
+    OpFunc abs_op = (OpFunc)jit_function(jit, "run_Int32x4Abs");
+    if (!sdiv || !udiv || !abs_op) return false;
+
+    // A zero divisor gives 0 and MIN / -1 gives MAX
+    int32_t sa[4] = { 7, -7, 5, INT32_MIN }, sb[4] = { 2, 2, 0, -1 }, sout[4];
+    int32_t sexpected[4] = { 3, -3, 0, INT32_MAX };
+    sdiv(sa, sb, NULL, NULL, sout);
+    uint32_t ua[4] = { 7, 0xffffffffu, 0xffffffffu, 5 }, ub[4] = { 2, 0, 2, 5 }, uout[4];
+    uint32_t uexpected[4] = { 3, 0, 0x7fffffffu, 1 };
+    udiv(ua, ub, NULL, NULL, uout);
+    if (memcmp(sout, sexpected, sizeof(sout)) != 0 || memcmp(uout, uexpected, sizeof(uout)) != 0) {
+        fprintf(stderr, "Integer division gave %d %d %d %d and %u %u %u %u\n",
+                sout[0], sout[1], sout[2], sout[3], uout[0], uout[1], uout[2], uout[3]);
+        return false;
+    }
+
+    // INT_MIN stays INT_MIN
+    int32_t abs_in[4] = { -5, 5, 0, INT32_MIN }, abs_out[4], abs_expected[4] = { 5, 5, 0, INT32_MIN };
+    abs_op(abs_in, NULL, NULL, NULL, abs_out);
+    if (memcmp(abs_out, abs_expected, sizeof(abs_out)) != 0) {
+        fprintf(stderr, "Int32x4Abs gave %d %d %d %d\n", abs_out[0], abs_out[1], abs_out[2], abs_out[3]);
+        return false;
+    }
+    return true;
+}
+
+static bool check_float_ops(Jit* jit) {
+    OpFunc masked_add = (OpFunc)jit_function(jit, "run_Float4MaskedAdd");
+    OpFunc fma_op = (OpFunc)jit_function(jit, "run_Float4Fma");
+    if (!masked_add || !fma_op) return false;
+
+    // Any nonzero mask lane is set
+    float a[4] = { 1, 2, 3, 4 }, b[4] = { 10, 20, 30, 40 }, out[4];
+    int32_t mask[4] = { 0, -1, 0, 7 };
+    float expected[4] = { 1, 22, 3, 44 };
+    masked_add(a, b, NULL, mask, out);
+    if (memcmp(out, expected, sizeof(out)) != 0) {
+        fprintf(stderr, "Float4MaskedAdd gave %g %g %g %g\n", out[0], out[1], out[2], out[3]);
+        return false;
+    }
+
+    // One rounding: (1 + 2^-12)^2 - (1 + 2^-11) is 2^-24 fused and 0 unfused
+    float x = 1.0f + 0x1p-12f;
+    float fa[4] = { x, 1.5f, -2.0f, 3.0f }, fb[4] = { x, 2.0f, 0.25f, 1e-8f };
+    float fc[4] = { -(1.0f + 0x1p-11f), 1.0f, 0.5f, 1.0f };
+    fma_op(fa, fb, fc, NULL, out);
+    for (int lane = 0; lane < 4; lane++) {
+        if (out[lane] != fmaf(fa[lane], fb[lane], fc[lane])) {
+            fprintf(stderr, "Float4Fma lane %d gave %a, expected %a\n", lane, out[lane],
+                    fmaf(fa[lane], fb[lane], fc[lane]));
+            return false;
+        }
+    }
+    if (out[0] != 0x1p-24f) {
+        fprintf(stderr, "Float4Fma rounded twice: %a\n", out[0]);
+        return false;
+    }
+    return true;
+}
+
+static bool check_reductions(Jit* jit) {
+    typedef float (*FloatReduce)(const float*);
+    typedef int32_t (*IntReduce)(const int32_t*);
+    typedef uint8_t (*ByteReduce)(const uint8_t*);
+
+    FloatReduce sum8 = (FloatReduce)jit_function(jit, "run_Float8ReduceAdd");
+    FloatReduce sum3 = (FloatReduce)jit_function(jit, "run_Float3ReduceAdd");
+    FloatReduce min4 = (FloatReduce)jit_function(jit, "run_Float4ReduceMin");
+    FloatReduce max4 = (FloatReduce)jit_function(jit, "run_Float4ReduceMax");
+    IntReduce imin = (IntReduce)jit_function(jit, "run_Int32x4ReduceMin");
+    IntReduce imax = (IntReduce)jit_function(jit, "run_Int32x4ReduceMax");
+    IntReduce isum = (IntReduce)jit_function(jit, "run_Int32x4ReduceAdd");
+    ByteReduce umax = (ByteReduce)jit_function(jit, "run_SafeUInt8x16ReduceMax");
+    ByteReduce umin = (ByteReduce)jit_function(jit, "run_SafeUInt8x16ReduceMin");
+    if (!sum8 || !sum3 || !min4 || !max4 || !imin || !imax || !isum || !umax || !umin) return false;
+
+    float eight[8] = { 1, 2, 3, 4, 5, 6, 7, 8 }, three[3] = { 0.5f, 0.25f, 2 };
+    float with_nan[4] = { NAN, 3, 1, 2 };
+    int32_t ints[4] = { -5, 3, 100, -2 };
+    uint8_t bytes[16] = { 100, 200, 3, 50 };
+    for (int i = 4; i < 16; i++) bytes[i] = 10;
+
+    // NaN lanes are skipped, as in goo_vectorization_reduce; unsigned lanes
+    // compare unsigned
+    if (sum8(eight) != 36 || sum3(three) != 2.75f || min4(with_nan) != 1 || max4(with_nan) != 3 ||
+        imin(ints) != -5 || imax(ints) != 100 || isum(ints) != 96 || umax(bytes) != 200 || umin(bytes) != 3) {
+        fprintf(stderr, "Reductions gave sum %g %g, min/max %g %g, int %d %d %d, byte %u %u\n",
+                sum8(eight), sum3(three), min4(with_nan), max4(with_nan),
+                imin(ints), imax(ints), isum(ints), umax(bytes), umin(bytes));
+        return false;
+    }
+    return true;
+}
+
+// Masked accesses at the very end of a page: inactive lanes lie on a
+// PROT_NONE page and must never be touched
+static bool check_masked_memory(Jit* jit) {
+    typedef void (*MaskedFunc)(float* p, const int32_t* mask, float* v, float* out);
+    MaskedFunc masked_load = (MaskedFunc)jit_function(jit, "run_masked_load");
+    MaskedFunc masked_store = (MaskedFunc)jit_function(jit, "run_masked_store");
+    if (!masked_load || !masked_store) return false;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint8_t* mapping = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED || mprotect(mapping + page, page, PROT_NONE) != 0) {
+        fprintf(stderr, "Could not map a guard page\n");
+        return false;
+    }
+
+    bool ok = true;
+    float* tail = (float*)(mapping + page) - 2;
+    tail[0] = 1;
+    tail[1] = 2;
+    int32_t mask[4] = { -1, 1, 0, 0 };
+    float passthru[4] = { -1, -2, -3, -4 }, out[4];
+    float expected[4] = { 1, 2, -3, -4 };
+    masked_load(tail, mask, passthru, out);
+    if (memcmp(out, expected, sizeof(out)) != 0) {
+        fprintf(stderr, "Masked load gave %g %g %g %g\n", out[0], out[1], out[2], out[3]);
+        ok = false;
+    }
+
+    float values[4] = { 10, 20, 30, 40 };
+    masked_store(tail, mask, values, NULL);
+    if (tail[0] != 10 || tail[1] != 20) {
+        fprintf(stderr, "Masked store wrote %g %g\n", tail[0], tail[1]);
+        ok = false;
+    }
+
+    // Unset lanes in the middle keep their old values
+    float middle[4] = { 1, 2, 3, 4 };
+    int32_t alternate[4] = { 0, -1, 0, -1 };
+    masked_store(middle, alternate, values, NULL);
+    if (middle[0] != 1 || middle[1] != 20 || middle[2] != 3 || middle[3] != 40) {
+        fprintf(stderr, "Masked store gave %g %g %g %g\n", middle[0], middle[1], middle[2], middle[3]);
+        ok = false;
+    }
+
+    munmap(mapping, 2 * page);
+    return ok;
+}
+
+static bool test_execution(void) {
+    printf("Testing the lowered operations on the JIT...\n");
+
+    Jit jit;
+    memset(&jit, 0, sizeof(jit));
+    bool ok = jit_create(&jit);
+    if (ok) {
+        ok = check_saturating(&jit);
+        ok &= check_division(&jit);
+        ok &= check_float_ops(&jit);
+        ok &= check_reductions(&jit);
+        ok &= check_masked_memory(&jit);
+    }
+    jit_dispose(&jit);
+    return ok;
+}
+
+int main(void) {
+    LLVMLinkInMCJIT();
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+
+    int failed = 0;
+    if (!test_vector_types()) failed++;
+    if (!test_type_helpers()) failed++;
+    if (!test_operations()) failed++;
+    if (!test_inlined_chain()) failed++;
+    if (!test_execution()) failed++;
+
+    if (failed) {
+        printf("%d SIMD codegen test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All SIMD codegen tests passed\n");
+    return 0;
+}
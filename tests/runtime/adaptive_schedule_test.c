@@ -0,0 +1,444 @@
+/**
+ * adaptive_schedule_test.c
+ *
+ * Tests for the feedback-driven scheduler in goo_adaptive_schedule.c. Loop
+ * executions are simulated with a makespan model, so the learning phases can
+ * be checked deterministically: probing picks the fastest strategy, tuning
+ * hill-climbs the chunk size in either direction, and a converged site
+ * relearns when the makespan drifts. goo_parallel_for with GOO_SCHEDULE_AUTO
+ * is then run on the real worker pool and must feed the scheduler.
+ */
+
+#include "goo_adaptive_schedule.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ITERATIONS (1u << 14)
+#define PARTICIPANTS 4
+#define MAX_CALLS 64
+
+// Simulated loop: cost per iteration, cost of claiming a chunk, and how much
+// static and guided scheduling lose to imbalance
+typedef struct {
+    double iteration_ns;
+    double claim_ns;
+    double static_penalty;
+    double guided_penalty;
+} LoopModel;
+
+static double model_makespan(const LoopModel* model, GooScheduleType schedule, int chunk) {
+    double work = ITERATIONS * model->iteration_ns / PARTICIPANTS;
+    if (schedule == GOO_SCHEDULE_STATIC) {
+        return work * model->static_penalty;
+    }
+    // Claims are shared by the participants; the last chunk finishes alone
+    double claims = (double)ITERATIONS / chunk * model->claim_ns / PARTICIPANTS;
+    double tail = chunk * model->iteration_ns;
+    double makespan = work + claims + tail;
+    return schedule == GOO_SCHEDULE_GUIDED ? makespan * model->guided_penalty : makespan;
+}
+
+// Run one simulated execution through plan and record
+static bool run_once(const void* site, const LoopModel* model, double slowdown, GooAdaptivePlan* plan) {
+    if (!goo_adaptive_schedule_plan(site, ITERATIONS, PARTICIPANTS, plan)) {
+        return false;
+    }
+    double elapsed = model_makespan(model, plan->schedule, plan->chunk_size) * slowdown;
+    goo_adaptive_schedule_record(site, plan, ITERATIONS, PARTICIPANTS, (uint64_t)elapsed);
+    return true;
+}
+
+// Run until the site converges; returns the number of executions, or -1
+static int run_until_converged(const void* site, const LoopModel* model) {
+    GooAdaptivePlan plan;
+    GooAdaptiveSiteStats stats;
+    for (int calls = 1; calls <= MAX_CALLS; calls++) {
+        if (!run_once(site, model, 1.0, &plan) || !goo_adaptive_schedule_lookup(site, &stats)) {
+            return -1;
+        }
+        if (stats.phase == GOO_ADAPTIVE_CONVERGED) {
+            return calls;
+        }
+    }
+    return -1;
+}
+
+// Best makespan over every power-of-two multiple or fraction of chunk
+static double best_reachable(const LoopModel* model, GooScheduleType schedule, int chunk) {
+    double best = model_makespan(model, schedule, chunk);
+    for (int c = chunk / 2; c >= 1; c /= 2) {
+        best = fmin(best, model_makespan(model, schedule, c));
+    }
+    for (int c = chunk * 2; c <= (int)ITERATIONS; c *= 2) {
+        best = fmin(best, model_makespan(model, schedule, c));
+    }
+    return best;
+}
+
+// Sites are only compared by address
+static char site_a, site_b, site_c, site_d;
+
+static bool test_probing_order(void) {
+    printf("Testing that probing tries each strategy once...\n");
+
+    goo_adaptive_schedule_reset();
+    LoopModel model = { .iteration_ns = 10, .claim_ns = 2000, .static_penalty = 2.0, .guided_penalty = 1.5 };
+    static const GooScheduleType expected[] = { GOO_SCHEDULE_STATIC, GOO_SCHEDULE_DYNAMIC, GOO_SCHEDULE_GUIDED };
+
+    for (int i = 0; i < 3; i++) {
+        GooAdaptivePlan plan;
+        if (!run_once(&site_a, &model, 1.0, &plan)) {
+            fprintf(stderr, "Probe %d was not planned\n", i);
+            return false;
+        }
+        if (plan.schedule != expected[i] || plan.chunk_size < 1 || plan.chunk_size > (int)ITERATIONS) {
+            fprintf(stderr, "Probe %d ran schedule %d chunk %d\n", i, plan.schedule, plan.chunk_size);
+            return false;
+        }
+        // Later probes size chunks from the measured cost: about 20 us each
+        if (i > 0) {
+            double chunk_ns = plan.chunk_size * model.iteration_ns;
+            if (chunk_ns < GOO_ADAPTIVE_TARGET_CHUNK_NS / 4 || chunk_ns > GOO_ADAPTIVE_TARGET_CHUNK_NS * 4) {
+                fprintf(stderr, "Probe %d chunk of %d iterations takes %.0f ns\n", i, plan.chunk_size, chunk_ns);
+                return false;
+            }
+        }
+    }
+
+    GooAdaptiveSiteStats stats;
+    if (!goo_adaptive_schedule_lookup(&site_a, &stats) || stats.calls != 3 || stats.samples != 3 ||
+        stats.phase != GOO_ADAPTIVE_TUNING || stats.schedule != GOO_SCHEDULE_DYNAMIC) {
+        fprintf(stderr, "After probing: phase %d schedule %d, expected tuning dynamic\n",
+                stats.phase, stats.schedule);
+        return false;
+    }
+    return true;
+}
+
+static bool test_static_converges_at_once(void) {
+    printf("Testing that a static winner converges without tuning...\n");
+
+    goo_adaptive_schedule_reset();
+    LoopModel model = { .iteration_ns = 10, .claim_ns = 2000, .static_penalty = 1.0, .guided_penalty = 1.5 };
+    int calls = run_until_converged(&site_a, &model);
+
+    GooAdaptiveSiteStats stats;
+    goo_adaptive_schedule_lookup(&site_a, &stats);
+    if (calls != 3 || stats.schedule != GOO_SCHEDULE_STATIC) {
+        fprintf(stderr, "Static winner converged after %d calls with schedule %d\n", calls, stats.schedule);
+        return false;
+    }
+
+    GooAdaptivePlan plan;
+    goo_adaptive_schedule_plan(&site_a, ITERATIONS, PARTICIPANTS, &plan);
+    if (plan.schedule != GOO_SCHEDULE_STATIC) {
+        fprintf(stderr, "Converged site planned schedule %d\n", plan.schedule);
+        return false;
+    }
+    return true;
+}
+
+// Tuning must end near the best chunk size, growing or shrinking from the probe
+static bool check_tuning(const void* site, const LoopModel* model, bool expect_growth) {
+    GooAdaptivePlan plan;
+    for (int i = 0; i < 3; i++) {
+        run_once(site, model, 1.0, &plan);
+    }
+    int probe_chunk = plan.chunk_size;
+
+    int calls = run_until_converged(site, model);
+    GooAdaptiveSiteStats stats;
+    goo_adaptive_schedule_lookup(site, &stats);
+    if (calls < 0 || stats.schedule != GOO_SCHEDULE_DYNAMIC) {
+        fprintf(stderr, "Tuning did not converge on dynamic scheduling\n");
+        return false;
+    }
+    if (expect_growth ? stats.chunk_size <= probe_chunk : stats.chunk_size >= probe_chunk) {
+        fprintf(stderr, "Chunk went from %d to %d, expected it to %s\n", probe_chunk, stats.chunk_size,
+                expect_growth ? "grow" : "shrink");
+        return false;
+    }
+
+    double learned = model_makespan(model, stats.schedule, stats.chunk_size);
+    double best = best_reachable(model, stats.schedule, probe_chunk);
+    if (learned > best * 1.05) {
+        fprintf(stderr, "Learned chunk %d gives %.0f ns, best reachable is %.0f ns\n",
+                stats.chunk_size, learned, best);
+        return false;
+    }
+
+    goo_adaptive_schedule_plan(site, ITERATIONS, PARTICIPANTS, &plan);
+    if (plan.schedule != stats.schedule || plan.chunk_size != stats.chunk_size) {
+        fprintf(stderr, "Converged site did not plan its learned parameters\n");
+        return false;
+    }
+    return true;
+}
+
+static bool test_tuning(void) {
+    printf("Testing chunk size tuning in both directions...\n");
+
+    goo_adaptive_schedule_reset();
+    // Expensive claims: the best chunk is larger than the probe's
+    LoopModel grow = { .iteration_ns = 10, .claim_ns = 5000, .static_penalty = 8.0, .guided_penalty = 1.5 };
+    // Cheap claims: the best chunk is smaller
+    LoopModel shrink = { .iteration_ns = 10, .claim_ns = 20, .static_penalty = 2.0, .guided_penalty = 1.5 };
+    return check_tuning(&site_a, &grow, true) && check_tuning(&site_b, &shrink, false);
+}
+
+static bool test_drift_relearns(void) {
+    printf("Testing that a drifting site relearns...\n");
+
+    goo_adaptive_schedule_reset();
+    LoopModel model = { .iteration_ns = 10, .claim_ns = 2000, .static_penalty = 2.0, .guided_penalty = 1.5 };
+    if (run_until_converged(&site_a, &model) < 0) {
+        fprintf(stderr, "Site did not converge\n");
+        return false;
+    }
+
+    // Small noise must not restart learning
+    GooAdaptivePlan plan;
+    GooAdaptiveSiteStats stats;
+    for (int i = 0; i < 10; i++) {
+        run_once(&site_a, &model, i % 2 ? 1.2 : 1.0, &plan);
+    }
+    goo_adaptive_schedule_lookup(&site_a, &stats);
+    if (stats.phase != GOO_ADAPTIVE_CONVERGED) {
+        fprintf(stderr, "20%% noise restarted learning\n");
+        return false;
+    }
+
+    // The workload got three times slower
+    for (int i = 0; i < 10 && stats.phase == GOO_ADAPTIVE_CONVERGED; i++) {
+        run_once(&site_a, &model, 3.0, &plan);
+        goo_adaptive_schedule_lookup(&site_a, &stats);
+    }
+    if (stats.phase != GOO_ADAPTIVE_PROBING) {
+        fprintf(stderr, "A 3x slowdown did not restart learning\n");
+        return false;
+    }
+    goo_adaptive_schedule_plan(&site_a, ITERATIONS, PARTICIPANTS, &plan);
+    if (plan.schedule != GOO_SCHEDULE_STATIC) {
+        fprintf(stderr, "Relearning did not start with the first probe\n");
+        return false;
+    }
+    return true;
+}
+
+static bool test_ignored_samples(void) {
+    printf("Testing that stale and short samples are ignored...\n");
+
+    goo_adaptive_schedule_reset();
+    GooAdaptivePlan first, second;
+    GooAdaptiveSiteStats stats;
+
+    // Two executions planned together: only the first result moves probing on
+    goo_adaptive_schedule_plan(&site_a, ITERATIONS, PARTICIPANTS, &first);
+    goo_adaptive_schedule_plan(&site_a, ITERATIONS, PARTICIPANTS, &second);
+    goo_adaptive_schedule_record(&site_a, &first, ITERATIONS, PARTICIPANTS, 2000000);
+    goo_adaptive_schedule_record(&site_a, &second, ITERATIONS, PARTICIPANTS, 2000000);
+    GooAdaptivePlan next;
+    goo_adaptive_schedule_plan(&site_a, ITERATIONS, PARTICIPANTS, &next);
+    if (next.schedule != GOO_SCHEDULE_DYNAMIC) {
+        fprintf(stderr, "A stale sample advanced probing past dynamic\n");
+        return false;
+    }
+
+    // Too short to learn from: not even counted as a sample
+    goo_adaptive_schedule_lookup(&site_a, &stats);
+    uint64_t samples = stats.samples;
+    goo_adaptive_schedule_record(&site_a, &next, ITERATIONS, PARTICIPANTS, GOO_ADAPTIVE_MIN_SAMPLE_NS - 1);
+    goo_adaptive_schedule_lookup(&site_a, &stats);
+    if (stats.samples != samples) {
+        fprintf(stderr, "A sample shorter than the minimum was counted\n");
+        return false;
+    }
+
+    // Unknown sites and invalid arguments
+    goo_adaptive_schedule_record(&site_c, &next, ITERATIONS, PARTICIPANTS, 2000000);
+    if (goo_adaptive_schedule_lookup(&site_c, &stats) ||
+        goo_adaptive_schedule_plan(&site_d, 0, PARTICIPANTS, &next) ||
+        goo_adaptive_schedule_plan(&site_d, ITERATIONS, 0, &next) ||
+        goo_adaptive_schedule_plan(NULL, ITERATIONS, PARTICIPANTS, &next) ||
+        goo_adaptive_schedule_lookup(&site_d, &stats)) {
+        fprintf(stderr, "An unknown site or invalid plan was accepted\n");
+        return false;
+    }
+
+    // A chunk never exceeds the loop
+    if (!goo_adaptive_schedule_plan(&site_d, 3, PARTICIPANTS, &next) || next.chunk_size < 1 || next.chunk_size > 3) {
+        fprintf(stderr, "Three-iteration loop got chunk %d\n", next.chunk_size);
+        return false;
+    }
+    return true;
+}
+
+static bool test_site_table(void) {
+    printf("Testing the call site table limit...\n");
+
+    goo_adaptive_schedule_reset();
+    static char many_sites[GOO_ADAPTIVE_MAX_SITES + 1];
+    GooAdaptivePlan plan;
+    for (int i = 0; i < GOO_ADAPTIVE_MAX_SITES; i++) {
+        if (!goo_adaptive_schedule_plan(&many_sites[i], ITERATIONS, PARTICIPANTS, &plan)) {
+            fprintf(stderr, "Site %d of %d could not be tracked\n", i, GOO_ADAPTIVE_MAX_SITES);
+            return false;
+        }
+    }
+    if (goo_adaptive_schedule_plan(&many_sites[GOO_ADAPTIVE_MAX_SITES], ITERATIONS, PARTICIPANTS, &plan)) {
+        fprintf(stderr, "A site past the table limit was tracked\n");
+        return false;
+    }
+
+    GooAdaptiveSiteStats stats[GOO_ADAPTIVE_MAX_SITES];
+    if (goo_adaptive_schedule_snapshot(stats, GOO_ADAPTIVE_MAX_SITES) != GOO_ADAPTIVE_MAX_SITES ||
+        goo_adaptive_schedule_snapshot(stats, 10) != 10) {
+        fprintf(stderr, "Snapshot did not return every tracked site\n");
+        return false;
+    }
+    // Every tracked site is still found by lookup
+    for (int i = 0; i < GOO_ADAPTIVE_MAX_SITES; i++) {
+        if (!goo_adaptive_schedule_lookup(&many_sites[i], &stats[0]) || stats[0].calls != 1) {
+            fprintf(stderr, "Site %d was lost from a full table\n", i);
+            return false;
+        }
+    }
+
+    goo_adaptive_schedule_reset();
+    if (goo_adaptive_schedule_snapshot(stats, GOO_ADAPTIVE_MAX_SITES) != 0 ||
+        !goo_adaptive_schedule_plan(&many_sites[GOO_ADAPTIVE_MAX_SITES], ITERATIONS, PARTICIPANTS, &plan)) {
+        fprintf(stderr, "Reset did not free the table\n");
+        return false;
+    }
+    return true;
+}
+
+#define FEEDBACK_THREADS 4
+#define FEEDBACK_ROUNDS 500
+
+// Plans and records from several threads at once on shared and private sites
+static void* feedback_worker(void* arg) {
+    LoopModel model = { .iteration_ns = 10, .claim_ns = 2000, .static_penalty = 2.0, .guided_penalty = 1.5 };
+    GooAdaptivePlan plan;
+    for (int round = 0; round < FEEDBACK_ROUNDS; round++) {
+        run_once(&site_a, &model, 1.0 + (round % 7) * 0.1, &plan);
+        run_once(arg, &model, 1.0, &plan);
+    }
+    return NULL;
+}
+
+static bool test_concurrent_feedback(void) {
+    printf("Testing concurrent planning and recording...\n");
+
+    goo_adaptive_schedule_reset();
+    static char private_sites[FEEDBACK_THREADS];
+    pthread_t threads[FEEDBACK_THREADS];
+    for (int i = 0; i < FEEDBACK_THREADS; i++) {
+        pthread_create(&threads[i], NULL, feedback_worker, &private_sites[i]);
+    }
+    for (int i = 0; i < FEEDBACK_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    GooAdaptiveSiteStats stats;
+    if (!goo_adaptive_schedule_lookup(&site_a, &stats) ||
+        stats.calls != FEEDBACK_THREADS * FEEDBACK_ROUNDS || stats.samples != stats.calls) {
+        fprintf(stderr, "Shared site counted %llu calls, expected %d\n",
+                (unsigned long long)stats.calls, FEEDBACK_THREADS * FEEDBACK_ROUNDS);
+        return false;
+    }
+    for (int i = 0; i < FEEDBACK_THREADS; i++) {
+        if (!goo_adaptive_schedule_lookup(&private_sites[i], &stats) ||
+            stats.phase != GOO_ADAPTIVE_CONVERGED || stats.schedule != GOO_SCHEDULE_DYNAMIC) {
+            fprintf(stderr, "Private site %d did not converge on its own\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+#define AUTO_LOOP_LENGTH 200000
+#define AUTO_LOOP_RUNS 30
+
+static _Atomic uint8_t auto_seen[AUTO_LOOP_LENGTH];
+
+// Enough work per index for the loop to be measurable
+static void auto_body(uint64_t index, void* arg) {
+    (void)arg;
+    volatile uint64_t x = index;
+    for (int i = 0; i < 20; i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    atomic_fetch_add_explicit(&auto_seen[index], 1, memory_order_relaxed);
+}
+
+static bool test_parallel_for_feedback(void) {
+    printf("Testing that auto-scheduled loops feed the scheduler...\n");
+
+    goo_adaptive_schedule_reset();
+    for (int run = 0; run < AUTO_LOOP_RUNS; run++) {
+        memset(auto_seen, 0, sizeof(auto_seen));
+        if (!goo_parallel_for(0, AUTO_LOOP_LENGTH, 1, auto_body, NULL, GOO_SCHEDULE_AUTO, 0, PARTICIPANTS)) {
+            fprintf(stderr, "Auto-scheduled loop failed\n");
+            return false;
+        }
+        for (int i = 0; i < AUTO_LOOP_LENGTH; i++) {
+            if (atomic_load_explicit(&auto_seen[i], memory_order_relaxed) != 1) {
+                fprintf(stderr, "Run %d: index %d ran %u times\n", run, i, auto_seen[i]);
+                return false;
+            }
+        }
+    }
+
+    GooAdaptiveSiteStats stats;
+    if (!goo_adaptive_schedule_lookup((const void*)auto_body, &stats) || stats.calls != AUTO_LOOP_RUNS) {
+        fprintf(stderr, "Auto-scheduled loop was not tracked once per run\n");
+        return false;
+    }
+    if (stats.samples != AUTO_LOOP_RUNS || stats.ns_per_iteration <= 0.0) {
+        fprintf(stderr, "Auto-scheduled loop recorded %llu timings for %d runs\n",
+                (unsigned long long)stats.samples, AUTO_LOOP_RUNS);
+        return false;
+    }
+
+    // An explicit schedule or chunk size bypasses the scheduler
+    goo_parallel_for(0, AUTO_LOOP_LENGTH, 1, auto_body, NULL, GOO_SCHEDULE_DYNAMIC, 0, PARTICIPANTS);
+    goo_parallel_for(0, AUTO_LOOP_LENGTH, 1, auto_body, NULL, GOO_SCHEDULE_AUTO, 64, PARTICIPANTS);
+    goo_adaptive_schedule_lookup((const void*)auto_body, &stats);
+    if (stats.calls != AUTO_LOOP_RUNS || stats.samples != AUTO_LOOP_RUNS) {
+        fprintf(stderr, "A loop with explicit parameters was planned adaptively\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!test_probing_order()) failed++;
+    if (!test_static_converges_at_once()) failed++;
+    if (!test_tuning()) failed++;
+    if (!test_drift_relearns()) failed++;
+    if (!test_ignored_samples()) failed++;
+    if (!test_site_table()) failed++;
+    if (!test_concurrent_feedback()) failed++;
+
+    if (!goo_parallel_init(PARTICIPANTS)) {
+        fprintf(stderr, "Failed to start the worker pool\n");
+        return 1;
+    }
+    if (!test_parallel_for_feedback()) failed++;
+    goo_parallel_cleanup();
+
+    if (failed) {
+        printf("%d adaptive scheduling tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All adaptive scheduling tests passed\n");
+    return 0;
+}
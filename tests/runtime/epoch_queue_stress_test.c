@@ -0,0 +1,202 @@
+/**
+ * epoch_queue_stress_test.c
+ *
+ * Stress test for the lock-free queue and epoch-based reclamation. Producers
+ * and consumers hammer one queue while popped nodes are retired and reused;
+ * meant to be run under ASan and TSan as well as plainly.
+ */
+
+#include "goo_concurrency.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 200000
+
+static GooLockFreeQueue queue;
+static _Atomic uint64_t consumed;
+static _Atomic uint8_t seen[PRODUCERS][ITEMS_PER_PRODUCER];
+static _Atomic int failures;
+
+// Items encode the producer and its sequence number; never NULL
+static void* encode_item(int producer, int seq) {
+    return (void*)(uintptr_t)(((uint64_t)producer << 32 | (uint64_t)seq) + 1);
+}
+
+static void decode_item(void* item, int* producer, int* seq) {
+    uint64_t value = (uint64_t)(uintptr_t)item - 1;
+    *producer = (int)(value >> 32);
+    *seq = (int)(value & 0xffffffffu);
+}
+
+static void* producer_main(void* arg) {
+    int producer = (int)(intptr_t)arg;
+    for (int seq = 0; seq < ITEMS_PER_PRODUCER; seq++) {
+        if (goo_lockfree_queue_push(&queue, encode_item(producer, seq)) != 0) {
+            fprintf(stderr, "Failed to push item %d from producer %d\n", seq, producer);
+            atomic_fetch_add(&failures, 1);
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+static void* consumer_main(void* arg) {
+    (void)arg;
+    const uint64_t total = (uint64_t)PRODUCERS * ITEMS_PER_PRODUCER;
+
+    // Items from one producer must reach any one consumer in push order
+    int last_seq[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; i++) last_seq[i] = -1;
+
+    while (atomic_load(&consumed) < total && atomic_load(&failures) == 0) {
+        void* item;
+        int result = goo_lockfree_queue_pop(&queue, &item);
+        if (result == ENODATA) continue;
+        if (result != 0) {
+            fprintf(stderr, "Failed to pop: error %d\n", result);
+            atomic_fetch_add(&failures, 1);
+            break;
+        }
+
+        int producer, seq;
+        decode_item(item, &producer, &seq);
+        if (producer < 0 || producer >= PRODUCERS || seq < 0 || seq >= ITEMS_PER_PRODUCER) {
+            fprintf(stderr, "Popped corrupt item %p\n", item);
+            atomic_fetch_add(&failures, 1);
+            break;
+        }
+        if (atomic_exchange(&seen[producer][seq], 1) != 0) {
+            fprintf(stderr, "Item %d from producer %d popped twice\n", seq, producer);
+            atomic_fetch_add(&failures, 1);
+        }
+        if (seq <= last_seq[producer]) {
+            fprintf(stderr, "Item %d from producer %d popped after item %d\n",
+                    seq, producer, last_seq[producer]);
+            atomic_fetch_add(&failures, 1);
+        }
+        last_seq[producer] = seq;
+        atomic_fetch_add(&consumed, 1);
+    }
+
+    // Reclaim what this thread retired before it exits
+    goo_epoch_synchronize();
+    return NULL;
+}
+
+static bool test_concurrent_push_pop(void) {
+    printf("Testing %d producers and %d consumers on one queue...\n", PRODUCERS, CONSUMERS);
+
+    if (goo_lockfree_queue_init(&queue) != 0) {
+        fprintf(stderr, "Failed to initialize queue\n");
+        return false;
+    }
+
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, consumer_main, NULL);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, producer_main, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+
+    for (int p = 0; p < PRODUCERS; p++) {
+        for (int seq = 0; seq < ITEMS_PER_PRODUCER; seq++) {
+            if (!atomic_load(&seen[p][seq])) {
+                fprintf(stderr, "Item %d from producer %d was lost\n", seq, p);
+                atomic_fetch_add(&failures, 1);
+                break;
+            }
+        }
+    }
+
+    if (!goo_lockfree_queue_is_empty(&queue)) {
+        fprintf(stderr, "Queue not empty after all items were consumed\n");
+        atomic_fetch_add(&failures, 1);
+    }
+
+    goo_epoch_synchronize();
+    goo_lockfree_queue_destroy(&queue);
+    return atomic_load(&failures) == 0;
+}
+
+// Nodes retired while a reader is pinned must survive until it unpins
+static _Atomic int reclaimed;
+
+static void count_reclaim(void* ptr) {
+    free(ptr);
+    atomic_fetch_add(&reclaimed, 1);
+}
+
+static _Atomic int reader_state;  // 1 = pinned, 2 = may unpin
+
+static void* pinned_reader_main(void* arg) {
+    (void)arg;
+    goo_epoch_enter();
+    atomic_store(&reader_state, 1);
+    while (atomic_load(&reader_state) != 2) {
+    }
+    goo_epoch_exit();
+    return NULL;
+}
+
+static bool test_retire_waits_for_pinned_reader(void) {
+    printf("Testing that retirement waits for pinned readers...\n");
+
+    pthread_t reader;
+    atomic_store(&reader_state, 0);
+    pthread_create(&reader, NULL, pinned_reader_main, NULL);
+    while (atomic_load(&reader_state) != 1) {
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        goo_epoch_retire(malloc(16), count_reclaim);
+    }
+    for (int i = 0; i < 10; i++) {
+        goo_epoch_try_advance();
+    }
+
+    // The reader pinned before the retirements, so at most one advance succeeds
+    bool ok = true;
+    if (atomic_load(&reclaimed) != 0) {
+        fprintf(stderr, "%d objects reclaimed while a reader was pinned\n", atomic_load(&reclaimed));
+        ok = false;
+    }
+
+    atomic_store(&reader_state, 2);
+    pthread_join(reader, NULL);
+
+    if (goo_epoch_synchronize() != 0 || atomic_load(&reclaimed) != 1000) {
+        fprintf(stderr, "Expected 1000 objects reclaimed after synchronize, got %d\n",
+                atomic_load(&reclaimed));
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!test_retire_waits_for_pinned_reader()) failed++;
+    if (!test_concurrent_push_pop()) failed++;
+
+    if (failed) {
+        printf("%d epoch test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All epoch tests passed\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * goroutine_pool_mock.c
+ *
+ * Fixed-size stand-in for the goroutine thread pool, for tests that link
+ * runtime pieces without goo_runtime.c. GOO_MOCK_POOL_WORKERS threads run
+ * spawned tasks in FIFO order under the same panic recovery as goo_run_task;
+ * panics without a supervisor are only printed.
+ */
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "goo_runtime.h"
+
+#ifndef GOO_MOCK_POOL_WORKERS
+#define GOO_MOCK_POOL_WORKERS 2
+#endif
+
+// Panic recovery state (normally goo_runtime.c)
+__thread jmp_buf* goo_recover_point = NULL;
+__thread void* goo_panic_value = NULL;
+
+typedef struct MockTask {
+    GooTask task;
+    struct MockTask* next;
+} MockTask;
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+static MockTask* queue_head = NULL;
+static MockTask* queue_tail = NULL;
+static bool pool_started = false;
+
+static void run_task(GooTask* task) {
+    jmp_buf recover_buf;
+    jmp_buf* old_recover_point = goo_recover_point;
+
+    if (setjmp(recover_buf) == 0) {
+        goo_recover_point = &recover_buf;
+        task->func(task->arg);
+    } else if (task->supervisor) {
+        goo_supervise_handle_error(task->supervisor, task, goo_panic_value);
+    } else {
+        fprintf(stderr, "Unhandled panic in goroutine: %p\n", goo_panic_value);
+    }
+
+    goo_recover_point = old_recover_point;
+}
+
+static void* worker_main(void* arg) {
+    (void)arg;
+
+    while (true) {
+        pthread_mutex_lock(&pool_mutex);
+        while (!queue_head) {
+            pthread_cond_wait(&pool_cond, &pool_mutex);
+        }
+        MockTask* item = queue_head;
+        queue_head = item->next;
+        if (!queue_head) queue_tail = NULL;
+        pthread_mutex_unlock(&pool_mutex);
+
+        run_task(&item->task);
+        free(item);
+    }
+
+    return NULL;
+}
+
+bool goo_goroutine_spawn(GooTaskFunc func, void* arg, GooSupervisor* supervisor) {
+    MockTask* item = (MockTask*)malloc(sizeof(MockTask));
+    if (!item) {
+        perror("Failed to allocate memory for task");
+        return false;
+    }
+
+    item->task.func = func;
+    item->task.arg = arg;
+    item->task.supervisor = supervisor;
+    item->next = NULL;
+
+    pthread_mutex_lock(&pool_mutex);
+
+    // Workers live for the rest of the process
+    if (!pool_started) {
+        for (int i = 0; i < GOO_MOCK_POOL_WORKERS; i++) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, worker_main, NULL) != 0) {
+                pthread_mutex_unlock(&pool_mutex);
+                free(item);
+                fprintf(stderr, "Error: Failed to start mock pool worker\n");
+                return false;
+            }
+            pthread_detach(thread);
+        }
+        pool_started = true;
+    }
+
+    if (queue_tail) {
+        queue_tail->next = item;
+    } else {
+        queue_head = item;
+    }
+    queue_tail = item;
+
+    pthread_cond_signal(&pool_cond);
+    pthread_mutex_unlock(&pool_mutex);
+    return true;
+}
@@ -0,0 +1,663 @@
+/**
+ * heap_profile_test.c
+ *
+ * Tests for the sampling heap profiler. Allocation sites feed the profiler
+ * through the same countdown the allocator core uses; the estimates must
+ * match the bytes really allocated, frees must retire samples, and the
+ * folded, pprof and signal-triggered dumps must agree with the totals.
+ * Pointers are never dereferenced by the profiler, so the sites use fake
+ * addresses. Link with -rdynamic so the folded output can name the sites.
+ */
+
+/* Ensure clock_gettime and mkstemp are available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_heap_profile.h"
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SAMPLE_RATE (64 * 1024)
+#define SITE_A_SIZE 256
+#define SITE_A_COUNT (1 << 18)          // 64 MB in small objects
+#define SITE_B_SIZE SAMPLE_RATE
+#define SITE_B_COUNT (1 << 10)          // 64 MB in objects the size of the rate
+#define SITE_BYTES (64.0 * 1024 * 1024)
+#define ESTIMATE_TOLERANCE 0.2
+#define INTERVAL_DRAWS 20000
+#define PROFILE_THREADS 4
+#define THREAD_ALLOCATIONS (1 << 16)
+#define SIGNAL_TIMEOUT_NS 5000000000ull
+
+// Bytes this thread may still allocate before the next sample, as in
+// goo_allocator_core.zig
+static __thread int64_t profile_countdown = 0;
+
+static void track_alloc(void* ptr, size_t size) {
+    if (__atomic_load_n(&goo_heap_profile_rate, __ATOMIC_RELAXED) == 0) return;
+
+    profile_countdown -= (int64_t)size;
+    if (profile_countdown < 0) {
+        profile_countdown = goo_heap_profile_sample(ptr, size);
+    }
+}
+
+static void track_free(void* ptr) {
+    if (__atomic_load_n(&goo_heap_profile_live_count, __ATOMIC_RELAXED) == 0) return;
+    goo_heap_profile_free(ptr);
+}
+
+static void* site_a_pointer(size_t i) {
+    return (void*)(uintptr_t)(0x100000000ull + i * SITE_A_SIZE);
+}
+
+static void* site_b_pointer(size_t i) {
+    return (void*)(uintptr_t)(0x200000000ull + i * SITE_B_SIZE);
+}
+
+// Exported and never inlined so both show up by name in the stacks
+__attribute__((noinline)) void heap_profile_site_a(void) {
+    for (size_t i = 0; i < SITE_A_COUNT; i++) {
+        track_alloc(site_a_pointer(i), SITE_A_SIZE);
+    }
+}
+
+__attribute__((noinline)) void heap_profile_site_b(void) {
+    for (size_t i = 0; i < SITE_B_COUNT; i++) {
+        track_alloc(site_b_pointer(i), SITE_B_SIZE);
+    }
+}
+
+static bool within(double estimate, double actual, double tolerance) {
+    return fabs(estimate - actual) <= actual * tolerance;
+}
+
+// Write a profile to a temporary file and read it back
+static char* capture_profile(GooHeapProfileFormat format, size_t* length) {
+    char path[] = "/tmp/goo_heap_profile_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return NULL;
+    unlink(path);
+
+    char* data = NULL;
+    if (goo_heap_profile_write_fd(fd, format)) {
+        off_t size = lseek(fd, 0, SEEK_END);
+        data = malloc((size_t)size + 1);
+        if (data && pread(fd, data, (size_t)size, 0) == size) {
+            data[size] = '\0';
+            *length = (size_t)size;
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+    close(fd);
+    return data;
+}
+
+// Sum the values of folded lines whose stack mentions frame; -1 if malformed.
+// Stacks run from the root, so main must come before frame.
+static double folded_bytes(const char* folded, const char* frame, int* lines) {
+    double total = 0;
+    *lines = 0;
+
+    for (const char* line = folded; *line; ) {
+        const char* end = strchr(line, '\n');
+        if (!end) return -1;
+        const char* space = end;
+        while (space > line && space[-1] != ' ') space--;
+        if (space == line || space == end) return -1;
+
+        char* number_end;
+        long long value = strtoll(space, &number_end, 10);
+        if (number_end != end || value <= 0) return -1;
+
+        size_t stack_length = (size_t)(space - 1 - line);
+        if (stack_length == 0 || line[0] == ';' || line[stack_length - 1] == ';') return -1;
+        for (size_t i = 1; i < stack_length; i++) {
+            if (line[i] == ';' && line[i - 1] == ';') return -1;
+        }
+
+        const char* hit = strstr(line, frame);
+        if (hit && (size_t)(hit - line) < stack_length) {
+            const char* root = strstr(line, "main;");
+            if (!root || root > hit) return -1;
+            total += (double)value;
+            (*lines)++;
+        }
+        line = end + 1;
+    }
+    return total;
+}
+
+static bool test_disabled(void) {
+    printf("Testing that a zero rate samples nothing...\n");
+
+    goo_heap_profile_set_rate(0);
+    if (goo_heap_profile_get_rate() != 0) {
+        fprintf(stderr, "Rate is %zu, expected 0\n", goo_heap_profile_get_rate());
+        return false;
+    }
+    for (int i = 0; i < 1000; i++) {
+        if (goo_heap_profile_sample(site_a_pointer((size_t)i), 1 << 20) < INT64_MAX / 4) {
+            fprintf(stderr, "A disabled profiler scheduled another sample\n");
+            return false;
+        }
+    }
+    GooHeapProfileStats stats = goo_heap_profile_get_stats();
+    if (stats.samples != 0 || stats.live_samples != 0 || stats.stacks != 0) {
+        fprintf(stderr, "A disabled profiler took %llu samples\n", (unsigned long long)stats.samples);
+        return false;
+    }
+    return true;
+}
+
+static bool test_intervals(void) {
+    printf("Testing that sample intervals are exponential...\n");
+
+    // With no pointer the profiler only draws the next interval
+    goo_heap_profile_set_rate(SAMPLE_RATE);
+    double sum = 0;
+    int below_mean = 0;
+    for (int i = 0; i < INTERVAL_DRAWS; i++) {
+        int64_t interval = goo_heap_profile_sample(NULL, 1);
+        if (interval < 1) {
+            fprintf(stderr, "Drew an interval of %lld bytes\n", (long long)interval);
+            return false;
+        }
+        sum += (double)interval;
+        if (interval < SAMPLE_RATE) below_mean++;
+    }
+
+    // An exponential distribution has 1 - 1/e of its mass below the mean
+    double mean = sum / INTERVAL_DRAWS;
+    double fraction = (double)below_mean / INTERVAL_DRAWS;
+    if (!within(mean, SAMPLE_RATE, 0.05) || fabs(fraction - (1 - exp(-1.0))) > 0.02) {
+        fprintf(stderr, "Intervals average %.0f bytes with %.3f below the rate, expected %d and %.3f\n",
+                mean, fraction, SAMPLE_RATE, 1 - exp(-1.0));
+        return false;
+    }
+
+    GooHeapProfileStats stats = goo_heap_profile_get_stats();
+    if (stats.samples != 0) {
+        fprintf(stderr, "Drawing intervals recorded %llu samples\n", (unsigned long long)stats.samples);
+        return false;
+    }
+    return true;
+}
+
+static bool test_estimates(void) {
+    printf("Testing the allocation estimates per site...\n");
+
+    goo_heap_profile_set_rate(SAMPLE_RATE);
+    heap_profile_site_a();
+    heap_profile_site_b();
+
+    GooHeapProfileStats stats = goo_heap_profile_get_stats();
+    double expected_samples = 2 * SITE_BYTES / SAMPLE_RATE;
+    if (stats.samples < expected_samples / 2 || stats.samples > expected_samples * 2 ||
+        stats.live_samples != stats.samples || stats.dropped_samples != 0 || stats.stacks < 2) {
+        fprintf(stderr, "%llu samples (%llu live, %llu dropped) in %zu stacks, expected about %.0f\n",
+                (unsigned long long)stats.samples, (unsigned long long)stats.live_samples,
+                (unsigned long long)stats.dropped_samples, stats.stacks, expected_samples);
+        return false;
+    }
+    if (!within((double)stats.alloc_bytes, 2 * SITE_BYTES, ESTIMATE_TOLERANCE) ||
+        stats.inuse_bytes != stats.alloc_bytes) {
+        fprintf(stderr, "Estimated %llu bytes allocated and %llu in use, expected %.0f\n",
+                (unsigned long long)stats.alloc_bytes, (unsigned long long)stats.inuse_bytes,
+                2 * SITE_BYTES);
+        return false;
+    }
+
+    // Each site is estimated on its own, whatever its object size
+    size_t length;
+    char* folded = capture_profile(GOO_HEAP_PROFILE_FOLDED_ALLOC, &length);
+    if (!folded) {
+        fprintf(stderr, "Could not write the folded profile\n");
+        return false;
+    }
+    int lines_a, lines_b;
+    double bytes_a = folded_bytes(folded, "heap_profile_site_a", &lines_a);
+    double bytes_b = folded_bytes(folded, "heap_profile_site_b", &lines_b);
+    free(folded);
+    if (lines_a == 0 || lines_b == 0 ||
+        !within(bytes_a, SITE_BYTES, ESTIMATE_TOLERANCE) || !within(bytes_b, SITE_BYTES, ESTIMATE_TOLERANCE)) {
+        fprintf(stderr, "Folded profile estimates %.0f bytes at site a and %.0f at site b, expected %.0f\n",
+                bytes_a, bytes_b, SITE_BYTES);
+        return false;
+    }
+    return true;
+}
+
+static bool test_frees(void) {
+    printf("Testing that frees retire samples...\n");
+
+    GooHeapProfileStats before = goo_heap_profile_get_stats();
+    for (size_t i = 0; i < SITE_A_COUNT; i++) {
+        track_free(site_a_pointer(i));
+    }
+    GooHeapProfileStats after = goo_heap_profile_get_stats();
+
+    // Pointers that were never sampled, and frees of retired samples, change nothing
+    for (size_t i = 0; i < SITE_A_COUNT; i++) {
+        track_free(site_a_pointer(i));
+        track_free((void*)(uintptr_t)(0x300000000ull + i * 64));
+    }
+    GooHeapProfileStats again = goo_heap_profile_get_stats();
+    if (again.live_samples != after.live_samples || again.inuse_bytes != after.inuse_bytes) {
+        fprintf(stderr, "Freeing unsampled pointers retired %llu samples\n",
+                (unsigned long long)(after.live_samples - again.live_samples));
+        return false;
+    }
+
+    if (after.samples != before.samples || after.alloc_bytes != before.alloc_bytes ||
+        after.live_samples >= before.live_samples ||
+        !within((double)after.inuse_bytes, SITE_BYTES, ESTIMATE_TOLERANCE)) {
+        fprintf(stderr, "After freeing site a: %llu live samples of %llu, %llu bytes in use\n",
+                (unsigned long long)after.live_samples, (unsigned long long)after.samples,
+                (unsigned long long)after.inuse_bytes);
+        return false;
+    }
+
+    size_t length;
+    char* folded = capture_profile(GOO_HEAP_PROFILE_FOLDED_INUSE, &length);
+    if (!folded) {
+        fprintf(stderr, "Could not write the folded profile\n");
+        return false;
+    }
+    int lines_a, lines_b;
+    double bytes_a = folded_bytes(folded, "heap_profile_site_a", &lines_a);
+    double bytes_b = folded_bytes(folded, "heap_profile_site_b", &lines_b);
+    free(folded);
+    if (lines_a != 0 || bytes_a != 0 || !within(bytes_b, (double)after.inuse_bytes, 0.001)) {
+        fprintf(stderr, "In-use profile shows %.0f bytes at freed site a and %.0f at site b\n",
+                bytes_a, bytes_b);
+        return false;
+    }
+    return true;
+}
+
+// ===== pprof =====
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} PbReader;
+
+static bool pb_varint(PbReader* r, uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64 && r->p < r->end; shift += 7) {
+        uint8_t byte = *r->p++;
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Next field: varints set value, length-delimited fields set sub
+static bool pb_field(PbReader* r, int* field, uint64_t* value, PbReader* sub) {
+    uint64_t key;
+    if (!pb_varint(r, &key)) return false;
+    *field = (int)(key >> 3);
+    sub->p = sub->end = NULL;
+
+    switch (key & 7) {
+        case 0:
+            return pb_varint(r, value);
+        case 2:
+            if (!pb_varint(r, value) || *value > (uint64_t)(r->end - r->p)) return false;
+            sub->p = r->p;
+            sub->end = r->p + *value;
+            r->p += *value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+#define PPROF_MAX_STRINGS 512
+#define PPROF_MAX_LOCATIONS 4096
+
+typedef struct {
+    PbReader strings[PPROF_MAX_STRINGS];
+    int string_count;
+    uint64_t sample_types[4][2];
+    int sample_type_count;
+    uint64_t location_ids[PPROF_MAX_LOCATIONS];
+    uint64_t location_addresses[PPROF_MAX_LOCATIONS];
+    int location_count;
+    int mapping_count;
+    int sample_count;
+    double values[4];
+    uint64_t period;
+    uint64_t default_sample_type;
+} Pprof;
+
+static bool string_is(const Pprof* profile, uint64_t index, const char* text) {
+    if (index >= (uint64_t)profile->string_count) return false;
+    const PbReader* s = &profile->strings[index];
+    return (size_t)(s->end - s->p) == strlen(text) && memcmp(s->p, text, strlen(text)) == 0;
+}
+
+static bool has_location(const Pprof* profile, uint64_t id) {
+    for (int i = 0; i < profile->location_count; i++) {
+        if (profile->location_ids[i] == id) return true;
+    }
+    return false;
+}
+
+static bool parse_sample(Pprof* profile, PbReader sample) {
+    int field;
+    uint64_t value;
+    PbReader sub;
+    while (sample.p < sample.end) {
+        if (!pb_field(&sample, &field, &value, &sub)) return false;
+        if (!sub.p) continue;
+        // Packed location ids are checked once all locations are known
+        for (int i = 0; sub.p < sub.end; i++) {
+            uint64_t item;
+            if (!pb_varint(&sub, &item)) return false;
+            if (field == 2 && i < 4) profile->values[i] += (double)item;
+            if (field == 2 && i >= 4) return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_pprof(const uint8_t* data, size_t length, Pprof* profile) {
+    memset(profile, 0, sizeof(*profile));
+    PbReader r = { data, data + length };
+    int field;
+    uint64_t value;
+    PbReader sub;
+
+    while (r.p < r.end) {
+        if (!pb_field(&r, &field, &value, &sub)) return false;
+        switch (field) {
+            case 1:     // sample_type
+                if (profile->sample_type_count == 4) return false;
+                while (sub.p < sub.end) {
+                    int type_field;
+                    PbReader unused;
+                    if (!pb_field(&sub, &type_field, &value, &unused)) return false;
+                    if (type_field == 1 || type_field == 2) {
+                        profile->sample_types[profile->sample_type_count][type_field - 1] = value;
+                    }
+                }
+                profile->sample_type_count++;
+                break;
+            case 2:     // sample
+                if (!parse_sample(profile, sub)) return false;
+                profile->sample_count++;
+                break;
+            case 3:     // mapping
+                profile->mapping_count++;
+                break;
+            case 4: {   // location
+                uint64_t id = 0, address = 0;
+                while (sub.p < sub.end) {
+                    int location_field;
+                    PbReader unused;
+                    if (!pb_field(&sub, &location_field, &value, &unused)) return false;
+                    if (location_field == 1) id = value;
+                    if (location_field == 3) address = value;
+                }
+
+                // Each frame address gets one location with its own id
+                if (id == 0 || address == 0 || has_location(profile, id)) return false;
+                for (int i = 0; i < profile->location_count; i++) {
+                    if (profile->location_addresses[i] == address) return false;
+                }
+                if (profile->location_count < PPROF_MAX_LOCATIONS) {
+                    profile->location_ids[profile->location_count] = id;
+                    profile->location_addresses[profile->location_count++] = address;
+                }
+                break;
+            }
+            case 6:     // string_table
+                if (profile->string_count == PPROF_MAX_STRINGS) return false;
+                profile->strings[profile->string_count++] = sub;
+                break;
+            case 12:
+                profile->period = value;
+                break;
+            case 14:
+                profile->default_sample_type = value;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+// Every location id a sample references must be defined
+static bool check_sample_locations(Pprof* profile, const uint8_t* data, size_t length) {
+    PbReader r = { data, data + length };
+    int field;
+    uint64_t value;
+    PbReader sample;
+
+    while (r.p < r.end) {
+        if (!pb_field(&r, &field, &value, &sample)) return false;
+        if (field != 2) continue;
+
+        PbReader sub;
+        while (sample.p < sample.end) {
+            int sample_field;
+            if (!pb_field(&sample, &sample_field, &value, &sub)) return false;
+            if (sample_field != 1) continue;
+            int ids = 0;
+            while (sub.p < sub.end) {
+                if (!pb_varint(&sub, &value)) return false;
+                if (!has_location(profile, value)) return false;
+                ids++;
+            }
+            if (ids == 0) return false;
+        }
+    }
+    return true;
+}
+
+static bool test_pprof(void) {
+    printf("Testing the pprof profile...\n");
+
+    size_t length;
+    uint8_t* data = (uint8_t*)capture_profile(GOO_HEAP_PROFILE_PPROF, &length);
+    if (!data) {
+        fprintf(stderr, "Could not write the pprof profile\n");
+        return false;
+    }
+
+    static Pprof profile;
+    GooHeapProfileStats stats = goo_heap_profile_get_stats();
+    bool ok = parse_pprof(data, length, &profile);
+    if (!ok) {
+        fprintf(stderr, "pprof profile is not valid protobuf\n");
+    }
+
+    static const char* const types[4][2] = {
+        { "alloc_objects", "count" }, { "alloc_space", "bytes" },
+        { "inuse_objects", "count" }, { "inuse_space", "bytes" },
+    };
+    if (ok && (profile.string_count == 0 || !string_is(&profile, 0, "") || profile.sample_type_count != 4)) {
+        fprintf(stderr, "pprof profile has %d sample types and %d strings\n",
+                profile.sample_type_count, profile.string_count);
+        ok = false;
+    }
+    for (int i = 0; ok && i < 4; i++) {
+        if (!string_is(&profile, profile.sample_types[i][0], types[i][0]) ||
+            !string_is(&profile, profile.sample_types[i][1], types[i][1])) {
+            fprintf(stderr, "pprof sample type %d is not %s/%s\n", i, types[i][0], types[i][1]);
+            ok = false;
+        }
+    }
+    if (ok && (profile.period != SAMPLE_RATE || !string_is(&profile, profile.default_sample_type, "inuse_space"))) {
+        fprintf(stderr, "pprof period is %llu\n", (unsigned long long)profile.period);
+        ok = false;
+    }
+    if (ok && ((size_t)profile.sample_count != stats.stacks || profile.location_count == 0 ||
+               profile.mapping_count == 0 || !check_sample_locations(&profile, data, length))) {
+        fprintf(stderr, "pprof profile has %d samples for %zu stacks, %d locations, %d mappings\n",
+                profile.sample_count, stats.stacks, profile.location_count, profile.mapping_count);
+        ok = false;
+    }
+
+    // Values are rounded per stack
+    double slack = (double)stats.stacks;
+    if (ok && (fabs(profile.values[1] - (double)stats.alloc_bytes) > slack + 1 ||
+               fabs(profile.values[3] - (double)stats.inuse_bytes) > slack + 1 ||
+               profile.values[0] < (double)stats.samples || profile.values[2] > profile.values[0])) {
+        fprintf(stderr, "pprof totals: %.0f alloc bytes, %.0f inuse bytes; stats say %llu and %llu\n",
+                profile.values[1], profile.values[3],
+                (unsigned long long)stats.alloc_bytes, (unsigned long long)stats.inuse_bytes);
+        ok = false;
+    }
+
+    free(data);
+    return ok;
+}
+
+static bool test_signal_dump(void) {
+    printf("Testing a dump triggered by a signal...\n");
+
+    char path[] = "/tmp/goo_heap_profile_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        fprintf(stderr, "Could not create a temporary file\n");
+        return false;
+    }
+    close(fd);
+
+    if (!goo_heap_profile_dump_on_signal(SIGUSR2, path, GOO_HEAP_PROFILE_FOLDED_INUSE)) {
+        unlink(path);
+        return false;
+    }
+    raise(SIGUSR2);
+
+    // The writer thread truncates and rewrites the file
+    struct timespec started, now;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    char text[4096] = "";
+    bool found = false;
+    do {
+        struct timespec delay = { 0, 10000000 };
+        nanosleep(&delay, NULL);
+        FILE* file = fopen(path, "r");
+        if (file) {
+            size_t n = fread(text, 1, sizeof(text) - 1, file);
+            text[n] = '\0';
+            fclose(file);
+        }
+        found = strstr(text, "heap_profile_site_b") != NULL && strchr(text, '\n') != NULL;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while (!found && (uint64_t)(now.tv_sec - started.tv_sec) * 1000000000ull +
+                       (uint64_t)now.tv_nsec - (uint64_t)started.tv_nsec < SIGNAL_TIMEOUT_NS);
+
+    unlink(path);
+    if (!found) {
+        fprintf(stderr, "SIGUSR2 did not produce a profile\n");
+        return false;
+    }
+    return true;
+}
+
+static void* profile_worker(void* arg) {
+    uintptr_t base = 0x1000000000ull * (1 + (uintptr_t)arg);
+
+    for (size_t i = 0; i < THREAD_ALLOCATIONS; i++) {
+        track_alloc((void*)(base + i * 1024), 1024);
+        if (i >= 64) {
+            track_free((void*)(base + (i - 64) * 1024));
+        }
+    }
+    for (size_t i = THREAD_ALLOCATIONS - 64; i < THREAD_ALLOCATIONS; i++) {
+        track_free((void*)(base + i * 1024));
+    }
+    return NULL;
+}
+
+static bool test_threads_and_reset(void) {
+    printf("Testing concurrent sampling and reset...\n");
+
+    goo_heap_profile_reset();
+    GooHeapProfileStats stats = goo_heap_profile_get_stats();
+    if (stats.samples != 0 || stats.live_samples != 0 || stats.stacks != 0 || stats.alloc_bytes != 0) {
+        fprintf(stderr, "Reset left %llu samples in %zu stacks\n",
+                (unsigned long long)stats.samples, stats.stacks);
+        return false;
+    }
+
+    // Pointers sampled before the reset are unknown now
+    for (size_t i = 0; i < SITE_B_COUNT; i++) {
+        track_free(site_b_pointer(i));
+    }
+
+    pthread_t threads[PROFILE_THREADS];
+    for (int i = 0; i < PROFILE_THREADS; i++) {
+        pthread_create(&threads[i], NULL, profile_worker, (void*)(uintptr_t)i);
+    }
+    for (int i = 0; i < PROFILE_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    stats = goo_heap_profile_get_stats();
+    double allocated = (double)PROFILE_THREADS * THREAD_ALLOCATIONS * 1024;
+    if (stats.samples == 0 || stats.live_samples != 0 || stats.inuse_bytes != 0 ||
+        !within((double)stats.alloc_bytes, allocated, 0.25)) {
+        fprintf(stderr, "Threads left %llu of %llu samples live; %llu bytes estimated, expected %.0f\n",
+                (unsigned long long)stats.live_samples, (unsigned long long)stats.samples,
+                (unsigned long long)stats.alloc_bytes, allocated);
+        return false;
+    }
+
+    goo_heap_profile_reset();
+    return true;
+}
+
+static bool test_write_errors(void) {
+    printf("Testing write errors...\n");
+
+    if (goo_heap_profile_write("/nonexistent-dir/profile.pb", GOO_HEAP_PROFILE_PPROF)) {
+        fprintf(stderr, "Writing to a missing directory succeeded\n");
+        return false;
+    }
+    if (goo_heap_profile_write_fd(STDOUT_FILENO, (GooHeapProfileFormat)42)) {
+        fprintf(stderr, "Writing an unknown format succeeded\n");
+        return false;
+    }
+    if (goo_heap_profile_dump_on_signal(SIGUSR2, NULL, GOO_HEAP_PROFILE_PPROF)) {
+        fprintf(stderr, "Dumping on a signal without a path succeeded\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!test_disabled()) failed++;
+    if (!test_intervals()) failed++;
+    if (!test_estimates()) failed++;
+    if (!test_frees()) failed++;
+    if (!test_pprof()) failed++;
+    if (!test_signal_dump()) failed++;
+    if (!test_threads_and_reset()) failed++;
+    if (!test_write_errors()) failed++;
+
+    if (failed) {
+        printf("%d heap profile tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All heap profile tests passed\n");
+    return 0;
+}
@@ -0,0 +1,237 @@
+/**
+ * lang_string_test.c
+ *
+ * Tests for GooString: the inline/heap boundary, destroy on interned
+ * strings, and the lock-free intern table under concurrent inserts of the
+ * same keys. goo_alloc and friends are stubbed with counting versions.
+ */
+
+/* Ensure pthread barriers are available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "lang/goo_lang_memory.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_THREADS 8
+#define INTERN_ROUNDS 20
+#define INTERN_KEYS 500
+
+static _Atomic int live_allocations;
+
+void* goo_alloc(size_t size) {
+    atomic_fetch_add(&live_allocations, 1);
+    return malloc(size);
+}
+
+void* goo_realloc(void* ptr, size_t old_size, size_t new_size) {
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+void goo_free(void* ptr, size_t size) {
+    (void)size;
+    atomic_fetch_sub(&live_allocations, 1);
+    free(ptr);
+}
+
+void goo_runtime_out_of_memory(size_t size) {
+    fprintf(stderr, "Out of memory allocating %zu bytes\n", size);
+    exit(1);
+}
+
+static void fill_key(char* bytes, size_t length, char seed) {
+    for (size_t i = 0; i < length; i++) {
+        bytes[i] = (char)('a' + (seed + i) % 26);
+    }
+    bytes[length] = '\0';
+}
+
+static bool check_string(const GooString* str, const char* bytes, size_t length, bool inline_data) {
+    const char* data = goo_string_data(str);
+    bool is_inline = data == str->small.data;
+    if (goo_string_length(str) != length || memcmp(data, bytes, length) != 0 || data[length] != '\0') {
+        fprintf(stderr, "String of %zu bytes has the wrong contents\n", length);
+        return false;
+    }
+    if (is_inline != inline_data || ((str->small.flags & GOO_STRING_FLAG_HEAP) != 0) == inline_data) {
+        fprintf(stderr, "String of %zu bytes should be stored %s\n", length,
+                inline_data ? "inline" : "on the heap");
+        return false;
+    }
+    return true;
+}
+
+static bool test_inline_boundary(void) {
+    printf("Testing the inline/heap boundary...\n");
+
+    char bytes[64];
+    static const size_t lengths[] = { 0, 1, GOO_STRING_INLINE_CAPACITY, GOO_STRING_INLINE_CAPACITY + 1, 40 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        size_t length = lengths[i];
+        bool inline_data = length <= GOO_STRING_INLINE_CAPACITY;
+        fill_key(bytes, length, (char)i);
+
+        atomic_store(&live_allocations, 0);
+        GooString* str = goo_string_create_n(bytes, length);
+        if (!str || !check_string(str, bytes, length, inline_data)) {
+            return false;
+        }
+        int expected = inline_data ? 1 : 2;
+        if (atomic_load(&live_allocations) != expected) {
+            fprintf(stderr, "String of %zu bytes took %d allocations, expected %d\n",
+                    length, atomic_load(&live_allocations), expected);
+            return false;
+        }
+
+        GooString* copy = goo_string_create(bytes);
+        if (!copy || !goo_string_equals(str, copy)) {
+            fprintf(stderr, "Equal strings of %zu bytes compare unequal\n", length);
+            return false;
+        }
+        goo_string_destroy(copy);
+        goo_string_destroy(str);
+        if (atomic_load(&live_allocations) != 0) {
+            fprintf(stderr, "Destroying strings of %zu bytes leaked %d allocations\n",
+                    length, atomic_load(&live_allocations));
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_destroy_interned(void) {
+    printf("Testing goo_string_destroy on interned strings...\n");
+
+    char bytes[64];
+    static const size_t lengths[] = { 5, GOO_STRING_INLINE_CAPACITY, GOO_STRING_INLINE_CAPACITY + 1, 50 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        size_t length = lengths[i];
+        fill_key(bytes, length, (char)(7 + i));
+
+        atomic_store(&live_allocations, 0);
+        GooString* interned = goo_string_intern(bytes);
+        if (!interned || !goo_string_is_interned(interned) ||
+            !check_string(interned, bytes, length, length <= GOO_STRING_INLINE_CAPACITY)) {
+            fprintf(stderr, "Interning %zu bytes failed\n", length);
+            return false;
+        }
+
+        // Destroy must leave the canonical string alone
+        goo_string_destroy(interned);
+        if (atomic_load(&live_allocations) != 0 ||
+            !check_string(interned, bytes, length, length <= GOO_STRING_INLINE_CAPACITY) ||
+            goo_string_intern_n(bytes, length) != interned) {
+            fprintf(stderr, "Destroying an interned string of %zu bytes changed it\n", length);
+            return false;
+        }
+
+        // Interned and created strings still compare by contents
+        GooString* created = goo_string_create(bytes);
+        if (!goo_string_equals(created, interned) || !goo_string_equals(interned, created)) {
+            fprintf(stderr, "Interned and created strings of %zu bytes compare unequal\n", length);
+            return false;
+        }
+        goo_string_destroy(created);
+    }
+
+    GooString* a = goo_string_intern("interned-a");
+    GooString* b = goo_string_intern("interned-b");
+    if (goo_string_equals(a, b)) {
+        fprintf(stderr, "Different interned strings compare equal\n");
+        return false;
+    }
+    return true;
+}
+
+// Each round, all threads intern the same fresh keys in the same order
+// from a common start, so most inserts race for the same bucket
+static GooString* interned[INTERN_THREADS][INTERN_ROUNDS][INTERN_KEYS];
+static pthread_barrier_t intern_barrier;
+
+static void make_key(char* bytes, int round, int key) {
+    // Short keys stay inline; every third key is long enough for the heap
+    if (key % 3 == 0) {
+        snprintf(bytes, 64, "a-much-longer-interned-key-%d-%d", round, key);
+    } else {
+        snprintf(bytes, 64, "k%d-%d", round, key);
+    }
+}
+
+static void* intern_worker(void* arg) {
+    int thread = (int)(intptr_t)arg;
+    char bytes[64];
+
+    for (int round = 0; round < INTERN_ROUNDS; round++) {
+        pthread_barrier_wait(&intern_barrier);
+        for (int key = 0; key < INTERN_KEYS; key++) {
+            make_key(bytes, round, key);
+            interned[thread][round][key] = goo_string_intern(bytes);
+        }
+    }
+    return NULL;
+}
+
+static bool test_concurrent_intern(void) {
+    printf("Testing concurrent interning of the same keys...\n");
+
+    pthread_t threads[INTERN_THREADS];
+    pthread_barrier_init(&intern_barrier, NULL, INTERN_THREADS);
+    for (int i = 0; i < INTERN_THREADS; i++) {
+        pthread_create(&threads[i], NULL, intern_worker, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < INTERN_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&intern_barrier);
+
+    char bytes[64];
+    for (int round = 0; round < INTERN_ROUNDS; round++) {
+        for (int key = 0; key < INTERN_KEYS; key++) {
+            GooString* canonical = interned[0][round][key];
+            make_key(bytes, round, key);
+            if (!canonical || strcmp(goo_string_data(canonical), bytes) != 0) {
+                fprintf(stderr, "Key %d-%d was interned wrongly\n", round, key);
+                return false;
+            }
+            for (int thread = 1; thread < INTERN_THREADS; thread++) {
+                if (interned[thread][round][key] != canonical) {
+                    fprintf(stderr, "Key %d-%d was interned as two different strings\n",
+                            round, key);
+                    return false;
+                }
+            }
+            if (goo_string_intern(bytes) != canonical) {
+                fprintf(stderr, "Key %d-%d interned again gave a new string\n", round, key);
+                return false;
+            }
+            if (key > 0 && canonical == interned[0][round][key - 1]) {
+                fprintf(stderr, "Keys %d-%d and %d-%d share a string\n",
+                        round, key - 1, round, key);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!test_inline_boundary()) failed++;
+    if (!test_destroy_interned()) failed++;
+    if (!test_concurrent_intern()) failed++;
+
+    if (failed) {
+        printf("%d string tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All string tests passed\n");
+    return 0;
+}
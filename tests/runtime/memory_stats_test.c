@@ -0,0 +1,383 @@
+/**
+ * memory_stats_test.c
+ *
+ * Tests for the per-thread memory statistics: totals summed from every
+ * thread's counter block while the threads run and after they exit, the
+ * per-allocator and per-size-class breakdowns, realloc, peak merging,
+ * resets and disabled tracking.
+ */
+
+/* Ensure pthread barriers are available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_memory.h"
+#include "goo_memory_stats.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STATS_THREADS 8
+#define STATS_ROUNDS 20000
+#define PEAK_ALLOCATIONS 2000
+#define PEAK_SIZE 64
+
+// Defined in goo_memory_stats.c; no header declares them yet
+bool goo_memory_get_stats(size_t* total_allocated, size_t* peak_allocated, size_t* allocation_count);
+bool goo_memory_reset_stats(void);
+bool goo_memory_set_tracking(bool enable);
+
+static bool check_live(const char* what, size_t bytes, size_t count) {
+    size_t total, peak, allocations;
+    if (!goo_memory_get_stats(&total, &peak, &allocations)) {
+        fprintf(stderr, "%s: goo_memory_get_stats failed\n", what);
+        return false;
+    }
+    if (total != bytes || allocations != count) {
+        fprintf(stderr, "%s: %zu live bytes in %zu allocations, expected %zu in %zu\n",
+                what, total, allocations, bytes, count);
+        return false;
+    }
+    return true;
+}
+
+typedef struct {
+    pthread_barrier_t* started;     // Reached once the thread holds live allocations
+    pthread_barrier_t* checked;     // Released once main has read the totals
+    int allocator_id;
+    int index;
+} StatsWorker;
+
+// Allocate and free in a loop, keeping (index + 1) allocations of 100 bytes
+// live until main has checked them
+static void* stats_worker(void* arg) {
+    StatsWorker* worker = (StatsWorker*)arg;
+
+    for (int i = 0; i < STATS_ROUNDS; i++) {
+        size_t size = (size_t)(i % 512) + 1;
+        goo_memory_stats_track_alloc_for(worker->allocator_id, size);
+        goo_memory_stats_track_free_for(worker->allocator_id, size);
+    }
+    for (int i = 0; i <= worker->index; i++) {
+        goo_memory_stats_track_alloc(100);
+    }
+
+    pthread_barrier_wait(worker->started);
+    pthread_barrier_wait(worker->checked);
+    return NULL;
+}
+
+static bool test_concurrent_totals(void) {
+    printf("Testing totals across running and exited threads...\n");
+
+    int allocator_id = goo_memory_stats_register_allocator("stats-test-threads");
+    if (allocator_id <= 0) {
+        fprintf(stderr, "Registering an allocator returned %d\n", allocator_id);
+        return false;
+    }
+
+    GooMemoryStatsSnapshot before;
+    goo_memory_stats_snapshot(&before);
+    if (!check_live("Before the threads", 0, 0)) return false;
+
+    pthread_barrier_t started, checked;
+    pthread_barrier_init(&started, NULL, STATS_THREADS + 1);
+    pthread_barrier_init(&checked, NULL, STATS_THREADS + 1);
+
+    pthread_t threads[STATS_THREADS];
+    StatsWorker workers[STATS_THREADS];
+    for (int i = 0; i < STATS_THREADS; i++) {
+        workers[i] = (StatsWorker){ &started, &checked, allocator_id, i };
+        pthread_create(&threads[i], NULL, stats_worker, &workers[i]);
+    }
+
+    // Live allocations: 1 + 2 + ... + STATS_THREADS of 100 bytes each
+    size_t live_count = (size_t)STATS_THREADS * (STATS_THREADS + 1) / 2;
+    pthread_barrier_wait(&started);
+    bool ok = check_live("With the threads running", live_count * 100, live_count);
+
+    GooMemoryStatsSnapshot running;
+    goo_memory_stats_snapshot(&running);
+    if (running.thread_count < STATS_THREADS) {
+        fprintf(stderr, "Snapshot counted %d threads, expected at least %d\n",
+                running.thread_count, STATS_THREADS);
+        ok = false;
+    }
+
+    pthread_barrier_wait(&checked);
+    for (int i = 0; i < STATS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&started);
+    pthread_barrier_destroy(&checked);
+    if (!ok) return false;
+
+    // Exited threads leave their counts behind
+    if (!check_live("After the threads exited", live_count * 100, live_count)) return false;
+
+    GooMemoryStatsSnapshot after;
+    goo_memory_stats_snapshot(&after);
+    if (after.thread_count >= running.thread_count) {
+        fprintf(stderr, "Snapshot still counts %d threads after they exited\n", after.thread_count);
+        return false;
+    }
+
+    GooAllocatorStatsEntry* entry = &after.allocators[allocator_id];
+    uint64_t rounds = (uint64_t)STATS_THREADS * STATS_ROUNDS;
+    if (entry->allocations - before.allocators[allocator_id].allocations != rounds ||
+        entry->frees - before.allocators[allocator_id].frees != rounds ||
+        entry->bytes_allocated != entry->bytes_freed) {
+        fprintf(stderr, "Allocator '%s' counted %llu allocations and %llu frees, expected %llu\n",
+                entry->name, (unsigned long long)entry->allocations,
+                (unsigned long long)entry->frees, (unsigned long long)rounds);
+        return false;
+    }
+    if (after.total_allocations - before.total_allocations != rounds + live_count ||
+        after.total_frees - before.total_frees != rounds) {
+        fprintf(stderr, "Snapshot totals are off\n");
+        return false;
+    }
+
+    // Frees of another thread's allocations still balance the totals
+    for (size_t i = 0; i < live_count; i++) {
+        goo_memory_stats_track_free(100);
+    }
+    return check_live("After freeing the thread allocations", 0, 0);
+}
+
+static bool test_allocator_breakdown(void) {
+    printf("Testing the per-allocator breakdown...\n");
+
+    int first = goo_memory_stats_register_allocator("stats-test-arena");
+    if (first <= 0 || goo_memory_stats_register_allocator("stats-test-arena") != first) {
+        fprintf(stderr, "Registering the same name twice gave different ids\n");
+        return false;
+    }
+    int second = goo_memory_stats_register_allocator("stats-test-slab");
+    if (second <= 0 || second == first) {
+        fprintf(stderr, "A second allocator got id %d (first is %d)\n", second, first);
+        return false;
+    }
+
+    GooMemoryStatsSnapshot before, after;
+    goo_memory_stats_snapshot(&before);
+    goo_memory_stats_track_alloc_for(first, 1000);
+    goo_memory_stats_track_alloc_for(first, 24);
+    goo_memory_stats_track_free_for(first, 24);
+    goo_memory_stats_track_alloc_for(second, 4096);
+    // Unknown ids are counted as the default allocator
+    goo_memory_stats_track_alloc_for(GOO_STATS_MAX_ALLOCATORS, 7);
+    goo_memory_stats_track_alloc_for(-3, 9);
+    goo_memory_stats_snapshot(&after);
+
+    if (strcmp(after.allocators[first].name, "stats-test-arena") != 0 ||
+        strcmp(after.allocators[second].name, "stats-test-slab") != 0 ||
+        strcmp(after.allocators[0].name, "default") != 0) {
+        fprintf(stderr, "Allocator names are wrong\n");
+        return false;
+    }
+
+    struct {
+        int id;
+        uint64_t bytes_allocated, bytes_freed, allocations, frees;
+    } expected[] = {
+        { first, 1024, 24, 2, 1 },
+        { second, 4096, 0, 1, 0 },
+        { 0, 16, 0, 2, 0 },
+    };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        GooAllocatorStatsEntry* now = &after.allocators[expected[i].id];
+        GooAllocatorStatsEntry* then = &before.allocators[expected[i].id];
+        if (now->bytes_allocated - then->bytes_allocated != expected[i].bytes_allocated ||
+            now->bytes_freed - then->bytes_freed != expected[i].bytes_freed ||
+            now->allocations - then->allocations != expected[i].allocations ||
+            now->frees - then->frees != expected[i].frees) {
+            fprintf(stderr, "Allocator '%s' has the wrong counts\n", now->name);
+            return false;
+        }
+    }
+
+    goo_memory_stats_track_free_for(first, 1000);
+    goo_memory_stats_track_free_for(second, 4096);
+    goo_memory_stats_track_free(7);
+    goo_memory_stats_track_free(9);
+    if (!check_live("After the breakdown", 0, 0)) return false;
+
+    // Fill the table; the next name is refused
+    int id = 0;
+    char name[32];
+    for (int i = 0; id >= 0 && i < GOO_STATS_MAX_ALLOCATORS; i++) {
+        snprintf(name, sizeof(name), "stats-test-fill-%d", i);
+        id = goo_memory_stats_register_allocator(name);
+    }
+    if (id != -1 || goo_memory_stats_register_allocator("stats-test-one-too-many") != -1) {
+        fprintf(stderr, "A full allocator table accepted another name\n");
+        return false;
+    }
+    if (goo_memory_stats_register_allocator("stats-test-arena") != first) {
+        fprintf(stderr, "A full allocator table lost an existing name\n");
+        return false;
+    }
+    return true;
+}
+
+static bool test_size_classes(void) {
+    printf("Testing the size-class breakdown...\n");
+
+    static const struct {
+        size_t size;
+        int size_class;
+    } cases[] = {
+        { 0, 0 }, { 1, 0 }, { 8, 0 }, { 9, 1 }, { 16, 1 }, { 17, 2 },
+        { 4096, 9 }, { 4097, 10 },
+        { (size_t)8 << (GOO_STATS_SIZE_CLASSES - 2), GOO_STATS_SIZE_CLASSES - 2 },
+        { ((size_t)8 << (GOO_STATS_SIZE_CLASSES - 2)) + 1, GOO_STATS_SIZE_CLASSES - 1 },
+        { (size_t)1 << 40, GOO_STATS_SIZE_CLASSES - 1 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        GooMemoryStatsSnapshot before, after;
+        goo_memory_stats_snapshot(&before);
+        goo_memory_stats_track_alloc(cases[i].size);
+        goo_memory_stats_track_free(cases[i].size);
+        goo_memory_stats_snapshot(&after);
+
+        for (int c = 0; c < GOO_STATS_SIZE_CLASSES; c++) {
+            uint64_t allocations = after.size_classes[c].allocations - before.size_classes[c].allocations;
+            uint64_t frees = after.size_classes[c].frees - before.size_classes[c].frees;
+            uint64_t wanted = c == cases[i].size_class ? 1 : 0;
+            if (allocations != wanted || frees != wanted) {
+                fprintf(stderr, "Size %zu was counted in class %d, expected class %d\n",
+                        cases[i].size, c, cases[i].size_class);
+                return false;
+            }
+        }
+
+        size_t max_size = after.size_classes[cases[i].size_class].max_size;
+        size_t min_size = cases[i].size_class == 0 ? 0 : after.size_classes[cases[i].size_class - 1].max_size;
+        if (cases[i].size > max_size || (cases[i].size > 0 && cases[i].size <= min_size)) {
+            fprintf(stderr, "Size %zu is outside its class bounds (%zu, %zu]\n",
+                    cases[i].size, min_size, max_size);
+            return false;
+        }
+    }
+
+    GooMemoryStatsSnapshot snapshot;
+    goo_memory_stats_snapshot(&snapshot);
+    if (snapshot.size_classes[GOO_STATS_SIZE_CLASSES - 1].max_size != SIZE_MAX) {
+        fprintf(stderr, "The last size class is bounded\n");
+        return false;
+    }
+    return true;
+}
+
+static bool test_realloc(void) {
+    printf("Testing realloc tracking...\n");
+
+    goo_memory_stats_track_alloc(100);
+    goo_memory_stats_track_realloc(100, 300);
+    if (!check_live("After growing", 300, 1)) return false;
+    goo_memory_stats_track_realloc(300, 300);
+    goo_memory_stats_track_realloc(300, 40);
+    if (!check_live("After shrinking", 40, 1)) return false;
+    goo_memory_stats_track_free(40);
+    return check_live("After freeing", 0, 0);
+}
+
+static bool test_peak_and_reset(void) {
+    printf("Testing peak merging and reset...\n");
+
+    if (!goo_memory_reset_stats()) {
+        fprintf(stderr, "Reset failed\n");
+        return false;
+    }
+    size_t total, peak, count;
+    goo_memory_get_stats(&total, &peak, &count);
+    if (total != 0 || peak != 0 || count != 0) {
+        fprintf(stderr, "Reset left %zu bytes, peak %zu, %zu allocations\n", total, peak, count);
+        return false;
+    }
+
+    // Growth is merged into the peak periodically, so the peak survives the
+    // frees even though nothing was read in between
+    for (int i = 0; i < PEAK_ALLOCATIONS; i++) {
+        goo_memory_stats_track_alloc(PEAK_SIZE);
+    }
+    for (int i = 0; i < PEAK_ALLOCATIONS; i++) {
+        goo_memory_stats_track_free(PEAK_SIZE);
+    }
+    goo_memory_get_stats(&total, &peak, &count);
+    if (total != 0 || count != 0 || peak < (size_t)PEAK_SIZE * (PEAK_ALLOCATIONS / 2) ||
+        peak > (size_t)PEAK_SIZE * PEAK_ALLOCATIONS) {
+        fprintf(stderr, "Peak is %zu after %d allocations of %d bytes\n",
+                peak, PEAK_ALLOCATIONS, PEAK_SIZE);
+        return false;
+    }
+
+    // Reset clears the peak; live allocations from before it are not counted
+    goo_memory_stats_track_alloc(500);
+    goo_memory_reset_stats();
+    goo_memory_stats_track_alloc(200);
+    goo_memory_get_stats(&total, &peak, &count);
+    if (total != 200 || peak != 200 || count != 1) {
+        fprintf(stderr, "After reset: %zu bytes, peak %zu, %zu allocations\n", total, peak, count);
+        return false;
+    }
+    goo_memory_stats_track_free(200);
+    goo_memory_stats_track_free(500);
+    goo_memory_reset_stats();
+    return check_live("After the peak test", 0, 0);
+}
+
+static bool test_tracking_disabled(void) {
+    printf("Testing that disabled tracking counts nothing...\n");
+
+    GooMemoryStatsSnapshot before, after;
+    goo_memory_stats_snapshot(&before);
+
+    goo_memory_set_tracking(false);
+    goo_memory_stats_track_alloc(64);
+    goo_memory_stats_track_alloc_for(0, 64);
+    goo_memory_stats_track_realloc(64, 128);
+    bool stats_refused = !goo_memory_get_stats(NULL, NULL, NULL);
+    goo_memory_set_tracking(true);
+
+    goo_memory_stats_snapshot(&after);
+    if (!stats_refused) {
+        fprintf(stderr, "goo_memory_get_stats succeeded with tracking off\n");
+        return false;
+    }
+    if (after.total_allocations != before.total_allocations || after.total_allocated != before.total_allocated) {
+        fprintf(stderr, "Allocations were counted with tracking off\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!goo_memory_stats_init()) {
+        fprintf(stderr, "Failed to initialize memory statistics\n");
+        return 1;
+    }
+
+    if (!test_concurrent_totals()) failed++;
+    if (!test_allocator_breakdown()) failed++;
+    if (!test_size_classes()) failed++;
+    if (!test_realloc()) failed++;
+    if (!test_peak_and_reset()) failed++;
+    if (!test_tracking_disabled()) failed++;
+
+    goo_memory_stats_cleanup();
+
+    if (failed) {
+        printf("%d memory statistics tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All memory statistics tests passed\n");
+    return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * goo_runtime.h (test mock)
+ *
+ * Stand-in for include/goo_runtime.h, whose enums conflict with
+ * goo/core/types.h. Declares only the task, supervision and thread pool
+ * pieces the task group and preemption code use; goroutine_pool_mock.c
+ * and the tests implement them.
+ */
+
+#ifndef GOO_RUNTIME_H
+#define GOO_RUNTIME_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+typedef struct GooSupervisor GooSupervisor;
+
+// Function type for goroutines and supervised tasks
+typedef void (*GooTaskFunc)(void*);
+
+// Task structure for the thread pool
+typedef struct GooTask {
+    GooTaskFunc func;
+    void* arg;
+    GooSupervisor* supervisor;
+} GooTask;
+
+bool goo_goroutine_spawn(GooTaskFunc func, void* arg, GooSupervisor* supervisor);
+
+void goo_supervise_handle_error(GooSupervisor* supervisor, GooTask* failed_task, void* error_info);
+
+// Start a spare worker if goroutines are queued behind a preempted one
+void goo_thread_pool_handoff(void);
+
+#endif // GOO_RUNTIME_H
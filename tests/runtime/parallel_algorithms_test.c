@@ -0,0 +1,416 @@
+/**
+ * parallel_algorithms_test.c
+ *
+ * Tests for goo_parallel_algorithms.c against the real worker pool. Every
+ * algorithm is compared with a serial reference (qsort, a plain loop) over
+ * empty, single-element, cutoff-boundary and large non-power-of-two inputs,
+ * so both the sequential path and the blocked parallel path are covered.
+ */
+
+#include "goo_parallel.h"
+#include "goo_parallel_algorithms.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_THREADS 4
+
+static const size_t sizes[] = {
+    0, 1, 2, 3, 1000,
+    GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF - 1,
+    GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF,
+    GOO_PARALLEL_ALGO_SEQUENTIAL_CUTOFF + 1,
+    65537, 300007,
+};
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+#define MAX_SIZE 300007
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// 12-byte element: not a power of two, and the index makes the order total
+typedef struct {
+    int32_t key;
+    uint32_t index;
+    uint32_t check;
+} Record;
+
+static int compare_records(const void *a, const void *b) {
+    const Record *x = (const Record*)a;
+    const Record *y = (const Record*)b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// Keys only: distinct records compare equal
+static int compare_record_keys(const void *a, const void *b) {
+    const Record *x = (const Record*)a;
+    const Record *y = (const Record*)b;
+    return x->key < y->key ? -1 : x->key > y->key;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static bool test_sort(void) {
+    printf("Testing goo_parallel_sort against qsort...\n");
+
+    Record *values = malloc(MAX_SIZE * sizeof(Record));
+    Record *expected = malloc(MAX_SIZE * sizeof(Record));
+    bool ok = values && expected;
+
+    // Wide keys, then keys with many duplicates
+    static const uint32_t key_ranges[] = { 0, 5 };
+    for (size_t r = 0; ok && r < 2; r++) {
+        for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+            size_t n = sizes[s];
+            for (size_t i = 0; i < n; i++) {
+                uint64_t x = next_random();
+                int32_t key = key_ranges[r] ? (int32_t)(x % key_ranges[r]) : (int32_t)x;
+                values[i] = (Record){ .key = key, .index = (uint32_t)i, .check = (uint32_t)(x >> 32) };
+            }
+            memcpy(expected, values, n * sizeof(Record));
+            qsort(expected, n, sizeof(Record), compare_records);
+
+            if (!goo_parallel_sort(values, n, sizeof(Record), compare_records) ||
+                memcmp(values, expected, n * sizeof(Record)) != 0) {
+                fprintf(stderr, "Sort of %zu records (key range %u) differs from qsort\n",
+                        n, key_ranges[r]);
+                ok = false;
+            }
+        }
+    }
+
+    // Already sorted and reversed inputs
+    for (size_t pass = 0; ok && pass < 2; pass++) {
+        size_t n = 65537;
+        for (size_t i = 0; i < n; i++) {
+            int32_t key = pass == 0 ? (int32_t)i : (int32_t)(n - i);
+            values[i] = (Record){ .key = key, .index = (uint32_t)i };
+        }
+        memcpy(expected, values, n * sizeof(Record));
+        qsort(expected, n, sizeof(Record), compare_records);
+        if (!goo_parallel_sort(values, n, sizeof(Record), compare_records) ||
+            memcmp(values, expected, n * sizeof(Record)) != 0) {
+            fprintf(stderr, "Sort of %s input differs from qsort\n", pass == 0 ? "sorted" : "reversed");
+            ok = false;
+        }
+    }
+
+    // Ties between distinct records: the merges must still keep every
+    // record exactly once
+    uint8_t *seen = calloc(MAX_SIZE, 1);
+    ok = ok && seen;
+    for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+        size_t n = sizes[s];
+        for (size_t i = 0; i < n; i++) {
+            values[i] = (Record){ .key = (int32_t)(next_random() % 3), .index = (uint32_t)i };
+        }
+        if (!goo_parallel_sort(values, n, sizeof(Record), compare_record_keys)) {
+            fprintf(stderr, "Sort of %zu records with ties failed\n", n);
+            ok = false;
+            break;
+        }
+        memset(seen, 0, n);
+        for (size_t i = 0; ok && i < n; i++) {
+            if ((i > 0 && values[i - 1].key > values[i].key) || values[i].index >= n ||
+                seen[values[i].index]++) {
+                fprintf(stderr, "Sort of %zu records with ties lost or reordered records\n", n);
+                ok = false;
+            }
+        }
+    }
+
+    free(seen);
+    free(values);
+    free(expected);
+    return ok;
+}
+
+static bool test_radix_sort(void) {
+    printf("Testing the radix sorts against qsort...\n");
+
+    uint32_t *keys32 = malloc(MAX_SIZE * sizeof(uint32_t));
+    uint32_t *expected32 = malloc(MAX_SIZE * sizeof(uint32_t));
+    uint64_t *keys64 = malloc(MAX_SIZE * sizeof(uint64_t));
+    uint64_t *expected64 = malloc(MAX_SIZE * sizeof(uint64_t));
+    bool ok = keys32 && expected32 && keys64 && expected64;
+
+    // Full-width keys, then keys that share every digit but the lowest, so
+    // most passes are skipped
+    for (size_t pattern = 0; ok && pattern < 2; pattern++) {
+        for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+            size_t n = sizes[s];
+            for (size_t i = 0; i < n; i++) {
+                uint64_t x = next_random();
+                keys64[i] = pattern == 0 ? x : 0xabcdef0123456700ull | (x & 0xff);
+                keys32[i] = (uint32_t)keys64[i];
+            }
+            memcpy(expected32, keys32, n * sizeof(uint32_t));
+            memcpy(expected64, keys64, n * sizeof(uint64_t));
+            qsort(expected32, n, sizeof(uint32_t), compare_u32);
+            qsort(expected64, n, sizeof(uint64_t), compare_u64);
+
+            if (!goo_parallel_radix_sort_u32(keys32, n) ||
+                memcmp(keys32, expected32, n * sizeof(uint32_t)) != 0) {
+                fprintf(stderr, "Radix sort of %zu u32 keys (pattern %zu) differs from qsort\n", n, pattern);
+                ok = false;
+            }
+            if (!goo_parallel_radix_sort_u64(keys64, n) ||
+                memcmp(keys64, expected64, n * sizeof(uint64_t)) != 0) {
+                fprintf(stderr, "Radix sort of %zu u64 keys (pattern %zu) differs from qsort\n", n, pattern);
+                ok = false;
+            }
+        }
+    }
+
+    free(keys32);
+    free(expected32);
+    free(keys64);
+    free(expected64);
+    return ok;
+}
+
+// Affine maps x -> a * x + b (mod 2^32) under composition: associative but
+// not commutative, so a scan that combines blocks out of order is caught
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} Affine;
+
+static void compose_affine(void *result, const void *lhs, const void *rhs) {
+    const Affine *f = (const Affine*)lhs;
+    const Affine *g = (const Affine*)rhs;
+    Affine composed = { g->a * f->a, g->a * f->b + g->b };
+    *(Affine*)result = composed;
+}
+
+static bool test_scan(void) {
+    printf("Testing prefix scans against a serial scan...\n");
+
+    Affine *in = malloc(MAX_SIZE * sizeof(Affine));
+    Affine *out = malloc(MAX_SIZE * sizeof(Affine));
+    Affine *inclusive = malloc(MAX_SIZE * sizeof(Affine));
+    Affine *exclusive = malloc(MAX_SIZE * sizeof(Affine));
+    int64_t *in64 = malloc(MAX_SIZE * sizeof(int64_t));
+    int64_t *out64 = malloc(MAX_SIZE * sizeof(int64_t));
+    int64_t *inclusive64 = malloc(MAX_SIZE * sizeof(int64_t));
+    int64_t *exclusive64 = malloc(MAX_SIZE * sizeof(int64_t));
+    bool ok = in && out && inclusive && exclusive && in64 && out64 && inclusive64 && exclusive64;
+    const Affine identity = { 1, 0 };
+
+    for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+        size_t n = sizes[s];
+        Affine acc = identity;
+        int64_t acc64 = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t x = next_random();
+            in[i] = (Affine){ (uint32_t)x | 1, (uint32_t)(x >> 32) };
+            in64[i] = (int64_t)(x % 2001) - 1000;
+            exclusive[i] = acc;
+            compose_affine(&acc, &acc, &in[i]);
+            inclusive[i] = acc;
+            exclusive64[i] = acc64;
+            acc64 += in64[i];
+            inclusive64[i] = acc64;
+        }
+        size_t bytes = n * sizeof(Affine);
+        size_t bytes64 = n * sizeof(int64_t);
+
+        if (!goo_parallel_inclusive_scan(in, out, n, sizeof(Affine), compose_affine, &identity) ||
+            memcmp(out, inclusive, bytes) != 0) {
+            fprintf(stderr, "Inclusive scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+        if (!goo_parallel_exclusive_scan(in, out, n, sizeof(Affine), compose_affine, &identity) ||
+            memcmp(out, exclusive, bytes) != 0) {
+            fprintf(stderr, "Exclusive scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+        if (!goo_parallel_inclusive_scan_i64(in64, out64, n) || memcmp(out64, inclusive64, bytes64) != 0) {
+            fprintf(stderr, "Inclusive i64 scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+        if (!goo_parallel_exclusive_scan_i64(in64, out64, n) || memcmp(out64, exclusive64, bytes64) != 0) {
+            fprintf(stderr, "Exclusive i64 scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+
+        // In place: out aliases in
+        memcpy(out, in, bytes);
+        memcpy(out64, in64, bytes64);
+        if (!goo_parallel_exclusive_scan(out, out, n, sizeof(Affine), compose_affine, &identity) ||
+            memcmp(out, exclusive, bytes) != 0 ||
+            !goo_parallel_inclusive_scan_i64(out64, out64, n) || memcmp(out64, inclusive64, bytes64) != 0) {
+            fprintf(stderr, "In-place scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+        memcpy(out, in, bytes);
+        memcpy(out64, in64, bytes64);
+        if (!goo_parallel_inclusive_scan(out, out, n, sizeof(Affine), compose_affine, &identity) ||
+            memcmp(out, inclusive, bytes) != 0 ||
+            !goo_parallel_exclusive_scan_i64(out64, out64, n) || memcmp(out64, exclusive64, bytes64) != 0) {
+            fprintf(stderr, "In-place scan of %zu elements differs from the serial scan\n", n);
+            ok = false;
+        }
+    }
+
+    free(in);
+    free(out);
+    free(inclusive);
+    free(exclusive);
+    free(in64);
+    free(out64);
+    free(inclusive64);
+    free(exclusive64);
+    return ok;
+}
+
+static bool divisible(const void *elem, void *context) {
+    const Record *record = (const Record*)elem;
+    return (uint32_t)record->key % *(uint32_t*)context == 0;
+}
+
+static bool test_stable_partition(void) {
+    printf("Testing goo_parallel_stable_partition against a serial partition...\n");
+
+    Record *values = malloc(MAX_SIZE * sizeof(Record));
+    Record *expected = malloc(MAX_SIZE * sizeof(Record));
+    bool ok = values && expected;
+
+    // Divisor 3: mixed; 1: every element matches; large: almost none do
+    static const uint32_t divisors[] = { 3, 1, 0x7fffffff };
+    for (size_t d = 0; ok && d < 3; d++) {
+        uint32_t divisor = divisors[d];
+        for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+            size_t n = sizes[s];
+            for (size_t i = 0; i < n; i++) {
+                values[i] = (Record){ .key = (int32_t)(next_random() & 0x3fffffff), .index = (uint32_t)i };
+            }
+
+            size_t expected_split = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (divisible(&values[i], &divisor)) expected[expected_split++] = values[i];
+            }
+            size_t tail = expected_split;
+            for (size_t i = 0; i < n; i++) {
+                if (!divisible(&values[i], &divisor)) expected[tail++] = values[i];
+            }
+
+            size_t split = (size_t)-1;
+            if (!goo_parallel_stable_partition(values, n, sizeof(Record), divisible, &divisor, &split) ||
+                split != expected_split || memcmp(values, expected, n * sizeof(Record)) != 0) {
+                fprintf(stderr, "Partition of %zu records by %u differs from the serial partition\n",
+                        n, divisor);
+                ok = false;
+            }
+        }
+    }
+
+    free(values);
+    free(expected);
+    return ok;
+}
+
+static size_t bin_of(const void *elem, void *context) {
+    (void)context;
+    return *(const uint32_t*)elem;
+}
+
+static bool test_histogram(void) {
+    printf("Testing goo_parallel_histogram against a serial histogram...\n");
+
+    uint32_t *values = malloc(MAX_SIZE * sizeof(uint32_t));
+    uint64_t *bins = malloc(3001 * sizeof(uint64_t));
+    uint64_t *expected = malloc(3001 * sizeof(uint64_t));
+    bool ok = values && bins && expected;
+
+    // One bin, a few, and more than one merge chunk; some values fall past
+    // the last bin and must be dropped
+    static const size_t bin_counts[] = { 1, 7, 3001 };
+    for (size_t c = 0; ok && c < 3; c++) {
+        size_t num_bins = bin_counts[c];
+        for (size_t s = 0; ok && s < SIZE_COUNT; s++) {
+            size_t n = sizes[s];
+            memset(expected, 0, num_bins * sizeof(uint64_t));
+            for (size_t i = 0; i < n; i++) {
+                values[i] = (uint32_t)(next_random() % (num_bins + num_bins / 4 + 1));
+                if (values[i] < num_bins) expected[values[i]]++;
+            }
+            memset(bins, 0xff, num_bins * sizeof(uint64_t));
+
+            if (!goo_parallel_histogram(values, n, sizeof(uint32_t), bin_of, NULL, bins, num_bins) ||
+                memcmp(bins, expected, num_bins * sizeof(uint64_t)) != 0) {
+                fprintf(stderr, "Histogram of %zu values into %zu bins differs from the serial one\n",
+                        n, num_bins);
+                ok = false;
+            }
+        }
+    }
+
+    free(values);
+    free(bins);
+    free(expected);
+    return ok;
+}
+
+static bool test_invalid_arguments(void) {
+    printf("Testing rejection of invalid arguments...\n");
+
+    int64_t value = 1;
+    uint64_t bin = 0;
+    uint32_t divisor = 1;
+    const Affine identity = { 1, 0 };
+    if (goo_parallel_sort(NULL, 4, sizeof(int), compare_u32) ||
+        goo_parallel_sort(&value, 1, 0, compare_u32) ||
+        goo_parallel_radix_sort_u32(NULL, 4) ||
+        goo_parallel_inclusive_scan(&value, &value, 1, sizeof(Affine), NULL, &identity) ||
+        goo_parallel_exclusive_scan(&value, &value, 1, sizeof(Affine), compose_affine, NULL) ||
+        goo_parallel_inclusive_scan_i64(NULL, &value, 1) ||
+        goo_parallel_stable_partition(&value, 1, sizeof(Record), NULL, &divisor, NULL) ||
+        goo_parallel_histogram(&value, 1, sizeof(uint32_t), bin_of, NULL, &bin, 0)) {
+        fprintf(stderr, "An invalid call was accepted\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!goo_parallel_init(POOL_THREADS)) {
+        fprintf(stderr, "Failed to start the worker pool\n");
+        return 1;
+    }
+
+    if (!test_sort()) failed++;
+    if (!test_radix_sort()) failed++;
+    if (!test_scan()) failed++;
+    if (!test_stable_partition()) failed++;
+    if (!test_histogram()) failed++;
+    if (!test_invalid_arguments()) failed++;
+
+    goo_parallel_cleanup();
+
+    if (failed) {
+        printf("%d parallel algorithm tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All parallel algorithm tests passed\n");
+    return 0;
+}
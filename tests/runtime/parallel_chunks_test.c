@@ -0,0 +1,274 @@
+/**
+ * parallel_chunks_test.c
+ *
+ * Tests for the block loop in goo_parallel.c and the vectorized loops built
+ * on it, against the real worker pool. Every index of an unaligned range
+ * must be processed exactly once, interior block boundaries must fall on the
+ * grain, and the first and last blocks must be clamped to the range.
+ */
+
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_vectorization.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// goo_parallel.h cannot be included next to goo_vectorization.h: both
+// declare GooScheduleType
+bool goo_parallel_init(int num_threads);
+void goo_parallel_cleanup(void);
+bool goo_parallel_for_chunks(uint64_t start, uint64_t end, uint64_t grain,
+                             void (*body)(uint64_t, uint64_t, void*), void *context,
+                             int num_threads);
+
+#define POOL_THREADS 4
+#define MAX_INDEX 200000
+#define VECTOR_LENGTH (1u << 20)
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint64_t grain;
+    bool serial;                    // One thread: the whole range is one block
+    _Atomic uint8_t seen[MAX_INDEX];
+    _Atomic int bad_blocks;
+} ChunkCheck;
+
+static ChunkCheck check;
+
+static void record_block(uint64_t begin, uint64_t end, void *arg) {
+    ChunkCheck *c = (ChunkCheck*)arg;
+    bool first = begin == c->start;
+    bool last = end == c->end;
+
+    // Clamped to the range, and only the first and last blocks may start or
+    // end off the grain. On the pool every block lies within one grain
+    if (begin < c->start || end > c->end || begin >= end ||
+        (!first && begin % c->grain != 0) || (!last && end % c->grain != 0) ||
+        (!c->serial && begin / c->grain != (end - 1) / c->grain)) {
+        atomic_fetch_add(&c->bad_blocks, 1);
+        return;
+    }
+    for (uint64_t i = begin; i < end; i++) {
+        atomic_fetch_add_explicit(&c->seen[i], 1, memory_order_relaxed);
+    }
+}
+
+static bool run_chunks(uint64_t start, uint64_t end, uint64_t grain, int num_threads) {
+    check.start = start;
+    check.end = end;
+    check.grain = grain;
+    check.serial = num_threads == 1;
+    atomic_store(&check.bad_blocks, 0);
+    for (uint64_t i = 0; i < MAX_INDEX; i++) {
+        atomic_store_explicit(&check.seen[i], 0, memory_order_relaxed);
+    }
+
+    if (!goo_parallel_for_chunks(start, end, grain, record_block, &check, num_threads)) {
+        fprintf(stderr, "goo_parallel_for_chunks(%llu, %llu, %llu) failed\n",
+                (unsigned long long)start, (unsigned long long)end, (unsigned long long)grain);
+        return false;
+    }
+    if (atomic_load(&check.bad_blocks) != 0) {
+        fprintf(stderr, "[%llu, %llu) grain %llu: %d blocks were misaligned or unclamped\n",
+                (unsigned long long)start, (unsigned long long)end, (unsigned long long)grain,
+                atomic_load(&check.bad_blocks));
+        return false;
+    }
+    for (uint64_t i = 0; i < MAX_INDEX; i++) {
+        uint8_t expected = i >= start && i < end ? 1 : 0;
+        uint8_t seen = atomic_load_explicit(&check.seen[i], memory_order_relaxed);
+        if (seen != expected) {
+            fprintf(stderr, "[%llu, %llu) grain %llu: index %llu processed %u times\n",
+                    (unsigned long long)start, (unsigned long long)end,
+                    (unsigned long long)grain, (unsigned long long)i, seen);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_chunk_boundaries(void) {
+    printf("Testing grain-aligned blocks over unaligned ranges...\n");
+
+    static const struct {
+        uint64_t start, end, grain;
+        int num_threads;
+    } cases[] = {
+        { 13, 10007, 64, POOL_THREADS },       // Unaligned at both ends
+        { 0, 4096, 64, POOL_THREADS },         // Aligned at both ends
+        { 64, 1001, 64, POOL_THREADS },        // Aligned start, unaligned end
+        { 3, 1024, 64, 0 },                    // Unaligned start, aligned end
+        { 63, 65, 64, POOL_THREADS },          // Two one-element blocks
+        { 5, 60, 64, POOL_THREADS },           // Inside a single block
+        { 999, 199999, 1000, POOL_THREADS },   // Many blocks, one index short of each end
+        { 7, 1030, 16, 1 },                    // Serial path
+        { 11, 12, 1, POOL_THREADS },           // One element, grain 1
+        { 500, 500, 64, POOL_THREADS },        // Empty range
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!run_chunks(cases[i].start, cases[i].end, cases[i].grain, cases[i].num_threads)) {
+            return false;
+        }
+    }
+
+    if (goo_parallel_for_chunks(0, 10, 0, record_block, &check, POOL_THREADS) ||
+        goo_parallel_for_chunks(0, 10, 4, NULL, &check, POOL_THREADS)) {
+        fprintf(stderr, "Zero grain or missing body was accepted\n");
+        return false;
+    }
+    return true;
+}
+
+typedef struct {
+    _Atomic int started;
+    _Atomic int timed_out;
+    pthread_t first_thread;
+    _Atomic bool other_thread;
+} SpreadCheck;
+
+// The first block waits until a block runs on another thread, so the loop
+// only finishes promptly if the pool workers take part
+static void spread_block(uint64_t begin, uint64_t end, void *arg) {
+    (void)end;
+    SpreadCheck *s = (SpreadCheck*)arg;
+    if (begin == 0) {
+        s->first_thread = pthread_self();
+        atomic_store(&s->started, 1);
+        struct timespec started;
+        clock_gettime(CLOCK_MONOTONIC, &started);
+        while (!atomic_load(&s->other_thread)) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if (now.tv_sec - started.tv_sec > 5) {
+                atomic_store(&s->timed_out, 1);
+                return;
+            }
+        }
+        return;
+    }
+    while (!atomic_load(&s->started)) {
+        // The first block publishes its thread before anyone compares
+    }
+    if (!pthread_equal(pthread_self(), s->first_thread)) {
+        atomic_store(&s->other_thread, true);
+    }
+}
+
+static bool test_blocks_use_pool(void) {
+    printf("Testing that blocks run on more than one thread...\n");
+
+    SpreadCheck spread = { 0 };
+    if (!goo_parallel_for_chunks(0, 64 * 64, 64, spread_block, &spread, POOL_THREADS)) {
+        fprintf(stderr, "goo_parallel_for_chunks failed\n");
+        return false;
+    }
+    if (atomic_load(&spread.timed_out) || !atomic_load(&spread.other_thread)) {
+        fprintf(stderr, "All blocks ran on the calling thread\n");
+        return false;
+    }
+    return true;
+}
+
+// In-place add of one, so an element processed twice or not at all shows up
+static bool run_vectorized_loop(int32_t *values, int32_t *ones, size_t start, size_t end,
+                                int chunk_size) {
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        values[i] = (int32_t)i;
+    }
+
+    GooVectorOperation op = {
+        .base = {
+            .src1 = values,
+            .src2 = ones,
+            .dst = values,
+            .elem_size = sizeof(int32_t),
+            .length = VECTOR_LENGTH,
+            .op = GOO_VECTOR_ADD,
+        },
+        .simd_type = GOO_SIMD_AUTO,
+        .data_type = GOO_VEC_INT32,
+    };
+    GooParallelLoop loop = {
+        .vectorize = true,
+        .start = start,
+        .end = end,
+        .step = 1,
+        .chunk_size = chunk_size,
+        .num_threads = POOL_THREADS,
+        .vector_body = &op,
+    };
+
+    if (!goo_vectorization_apply_to_loop(&loop, GOO_VEC_INT32, GOO_SIMD_AUTO)) {
+        fprintf(stderr, "goo_vectorization_apply_to_loop(%zu, %zu) failed\n", start, end);
+        return false;
+    }
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        int32_t expected = (int32_t)i + (i >= start && i < end ? 1 : 0);
+        if (values[i] != expected) {
+            fprintf(stderr, "Vectorized loop [%zu, %zu) chunk %d: element %zu is %d, expected %d\n",
+                    start, end, chunk_size, i, values[i], expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_vectorized_loop(void) {
+    printf("Testing vectorized loops on the worker pool...\n");
+
+    int32_t *values = malloc(VECTOR_LENGTH * sizeof(int32_t));
+    int32_t *ones = malloc(VECTOR_LENGTH * sizeof(int32_t));
+    if (!values || !ones) {
+        fprintf(stderr, "Failed to allocate vector buffers\n");
+        free(values);
+        free(ones);
+        return false;
+    }
+    for (size_t i = 0; i < VECTOR_LENGTH; i++) {
+        ones[i] = 1;
+    }
+
+    // Large enough to leave the calling thread; block sizes from the L2
+    // default, from an odd chunk size and from a tiny one
+    bool ok = run_vectorized_loop(values, ones, 3, VECTOR_LENGTH - 5, 0) &&
+              run_vectorized_loop(values, ones, 17, VECTOR_LENGTH - 1, 1000) &&
+              run_vectorized_loop(values, ones, 1, VECTOR_LENGTH, 3) &&
+              run_vectorized_loop(values, ones, 0, VECTOR_LENGTH, 0) &&
+              run_vectorized_loop(values, ones, 5, 1000, 0);
+
+    free(values);
+    free(ones);
+    return ok;
+}
+
+int main(void) {
+    int failed = 0;
+
+    goo_vectorization_init(GOO_SIMD_AUTO);
+    if (!goo_parallel_init(POOL_THREADS)) {
+        fprintf(stderr, "Failed to start the worker pool\n");
+        return 1;
+    }
+
+    if (!test_chunk_boundaries()) failed++;
+    if (!test_blocks_use_pool()) failed++;
+    if (!test_vectorized_loop()) failed++;
+
+    goo_parallel_cleanup();
+
+    if (failed) {
+        printf("%d parallel block tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All parallel block tests passed\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * parallel_for_stress_test.c
+ *
+ * Stress test for goo_parallel_for with per-loop work distribution. Several
+ * application threads run loops at once, and loop bodies start nested loops
+ * on the same pool; every index of every loop must run exactly once. Meant
+ * to be run under TSan as well as plainly.
+ */
+
+#include "goo_parallel.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_THREADS 4
+#define CALLERS 4
+#define CALLER_ROUNDS 200
+#define LOOP_SPAN 5000
+#define OUTER_ROWS 24
+#define INNER_COLUMNS 700
+
+static const GooScheduleType schedules[] = {
+    GOO_SCHEDULE_STATIC, GOO_SCHEDULE_DYNAMIC, GOO_SCHEDULE_GUIDED, GOO_SCHEDULE_AUTO
+};
+#define SCHEDULE_COUNT (sizeof(schedules) / sizeof(schedules[0]))
+
+typedef struct {
+    uint64_t start;
+    uint64_t step;
+    _Atomic uint8_t seen[LOOP_SPAN];
+    _Atomic int out_of_range;
+} LoopCheck;
+
+static void count_index(uint64_t index, void* arg) {
+    LoopCheck* check = (LoopCheck*)arg;
+    if (index < check->start || index >= check->start + LOOP_SPAN ||
+        (index - check->start) % check->step != 0) {
+        atomic_fetch_add(&check->out_of_range, 1);
+        return;
+    }
+    atomic_fetch_add_explicit(&check->seen[index - check->start], 1, memory_order_relaxed);
+}
+
+// Every index start + k * step below start + LOOP_SPAN ran exactly once
+static bool verify_loop(LoopCheck* check, const char* what) {
+    if (atomic_load(&check->out_of_range) != 0) {
+        fprintf(stderr, "%s: %d indices outside the loop\n", what, atomic_load(&check->out_of_range));
+        return false;
+    }
+    for (uint64_t i = 0; i < LOOP_SPAN; i++) {
+        uint8_t expected = i % check->step == 0 ? 1 : 0;
+        uint8_t seen = atomic_load_explicit(&check->seen[i], memory_order_relaxed);
+        if (seen != expected) {
+            fprintf(stderr, "%s: index %llu ran %u times\n", what,
+                    (unsigned long long)(check->start + i), seen);
+            return false;
+        }
+    }
+    return true;
+}
+
+static _Atomic int caller_failures;
+
+// One application thread running loops with every schedule, chunk size and
+// step while the other callers do the same
+static void* caller_main(void* arg) {
+    int caller = (int)(intptr_t)arg;
+    LoopCheck* check = malloc(sizeof(LoopCheck));
+    if (!check) {
+        atomic_fetch_add(&caller_failures, 1);
+        return NULL;
+    }
+
+    for (int round = 0; round < CALLER_ROUNDS; round++) {
+        memset(check, 0, sizeof(*check));
+        check->start = (uint64_t)(caller * 1000003 + round * 17);
+        check->step = (uint64_t)(1 + (caller + round) % 3);
+        GooScheduleType schedule = schedules[(caller + round) % SCHEDULE_COUNT];
+        int chunk_size = round % 4 == 0 ? 0 : 1 + round % 7;
+        int num_threads = round % 3 == 0 ? 0 : 1 + round % POOL_THREADS;
+
+        if (!goo_parallel_for(check->start, check->start + LOOP_SPAN, check->step,
+                              count_index, check, schedule, chunk_size, num_threads) ||
+            !verify_loop(check, "Concurrent loop")) {
+            atomic_fetch_add(&caller_failures, 1);
+            break;
+        }
+    }
+
+    free(check);
+    return NULL;
+}
+
+static bool test_concurrent_loops(void) {
+    printf("Testing concurrent goo_parallel_for calls...\n");
+
+    pthread_t callers[CALLERS];
+    for (int i = 0; i < CALLERS; i++) {
+        pthread_create(&callers[i], NULL, caller_main, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < CALLERS; i++) {
+        pthread_join(callers[i], NULL);
+    }
+    return atomic_load(&caller_failures) == 0;
+}
+
+typedef struct {
+    uint64_t row;
+    _Atomic uint8_t (*cells)[INNER_COLUMNS];
+} InnerLoop;
+
+static _Atomic uint8_t nested_cells[OUTER_ROWS][INNER_COLUMNS];
+static _Atomic int nested_failures;
+
+static void inner_body(uint64_t column, void* arg) {
+    InnerLoop* inner = (InnerLoop*)arg;
+    atomic_fetch_add_explicit(&inner->cells[inner->row][column], 1, memory_order_relaxed);
+}
+
+// Each row runs its own loop on the pool the outer loop is already using
+static void outer_body(uint64_t row, void* arg) {
+    (void)arg;
+    InnerLoop inner = { .row = row, .cells = nested_cells };
+    GooScheduleType schedule = schedules[row % SCHEDULE_COUNT];
+    if (!goo_parallel_for(0, INNER_COLUMNS, 1, inner_body, &inner, schedule,
+                          (int)(row % 5), POOL_THREADS)) {
+        atomic_fetch_add(&nested_failures, 1);
+    }
+}
+
+static bool test_nested_loops(void) {
+    printf("Testing nested goo_parallel_for calls...\n");
+
+    for (int round = 0; round < 50; round++) {
+        memset(nested_cells, 0, sizeof(nested_cells));
+        if (!goo_parallel_for(0, OUTER_ROWS, 1, outer_body, NULL,
+                              schedules[round % SCHEDULE_COUNT], 1, POOL_THREADS)) {
+            fprintf(stderr, "Outer loop failed\n");
+            return false;
+        }
+        if (atomic_load(&nested_failures) != 0) {
+            fprintf(stderr, "%d inner loops failed\n", atomic_load(&nested_failures));
+            return false;
+        }
+        for (int row = 0; row < OUTER_ROWS; row++) {
+            for (int column = 0; column < INNER_COLUMNS; column++) {
+                uint8_t seen = atomic_load_explicit(&nested_cells[row][column],
+                                                    memory_order_relaxed);
+                if (seen != 1) {
+                    fprintf(stderr, "Nested loop: cell (%d, %d) ran %u times\n",
+                            row, column, seen);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Nested loops started from several application threads at once
+static void* nested_caller_main(void* arg) {
+    LoopCheck* check = (LoopCheck*)arg;
+    if (!goo_parallel_for(check->start, check->start + LOOP_SPAN, check->step,
+                          count_index, check, GOO_SCHEDULE_DYNAMIC, 3, POOL_THREADS)) {
+        atomic_fetch_add(&check->out_of_range, 1);
+    }
+    return NULL;
+}
+
+static void spawn_body(uint64_t index, void* arg) {
+    LoopCheck* checks = (LoopCheck*)arg;
+    pthread_t thread;
+    pthread_create(&thread, NULL, nested_caller_main, &checks[index]);
+    pthread_join(thread, NULL);
+}
+
+static bool test_loops_from_loop_bodies(void) {
+    printf("Testing loops started from threads inside loop bodies...\n");
+
+    LoopCheck* checks = calloc(POOL_THREADS, sizeof(LoopCheck));
+    if (!checks) {
+        fprintf(stderr, "Failed to allocate loop checks\n");
+        return false;
+    }
+    for (int i = 0; i < POOL_THREADS; i++) {
+        checks[i].start = (uint64_t)i * LOOP_SPAN;
+        checks[i].step = 1;
+    }
+
+    bool ok = goo_parallel_for(0, POOL_THREADS, 1, spawn_body, checks,
+                               GOO_SCHEDULE_STATIC, 1, POOL_THREADS);
+    for (int i = 0; ok && i < POOL_THREADS; i++) {
+        ok = verify_loop(&checks[i], "Loop from a loop body");
+    }
+
+    free(checks);
+    return ok;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!goo_parallel_init(POOL_THREADS)) {
+        fprintf(stderr, "Failed to start the worker pool\n");
+        return 1;
+    }
+
+    if (!test_concurrent_loops()) failed++;
+    if (!test_nested_loops()) failed++;
+    if (!test_loops_from_loop_bodies()) failed++;
+
+    goo_parallel_cleanup();
+
+    if (failed) {
+        printf("%d parallel loop stress tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All parallel loop stress tests passed\n");
+    return 0;
+}
@@ -0,0 +1,31 @@
+/**
+ * parallel_serial_mock.c
+ *
+ * Serial stand-in for the worker pool, for tests that link the
+ * vectorization runtime without goo_parallel.c. Blocks run in order on the
+ * calling thread with the same grain-aligned boundaries the pool uses.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+bool goo_parallel_for_chunks(uint64_t start, uint64_t end, uint64_t grain,
+                             void (*body)(uint64_t, uint64_t, void*), void *context,
+                             int num_threads) {
+    (void)num_threads;
+
+    if (body == NULL || grain == 0) {
+        fprintf(stderr, "Error: Invalid arguments to goo_parallel_for_chunks\n");
+        return false;
+    }
+
+    uint64_t begin = start;
+    while (begin < end) {
+        uint64_t next = (begin / grain + 1) * grain;
+        if (next > end) next = end;
+        body(begin, next, context);
+        begin = next;
+    }
+    return true;
+}
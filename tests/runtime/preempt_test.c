@@ -0,0 +1,226 @@
+/**
+ * preempt_test.c
+ *
+ * Tests for the preemption monitor. A worker runs a hot loop that polls
+ * goo_preempt_requested the way compiled safepoints do; the monitor must
+ * set the flag once the goroutine has outrun its slice, and every yield
+ * must show up in goo_preempt_stats. Idle workers and a zero slice must
+ * never be flagged. goo_thread_pool_handoff is stubbed with a counter.
+ */
+
+/* Ensure clock_gettime is available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_preempt.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define TIME_SLICE_US 2000
+#define WANTED_YIELDS 5
+#define HOT_LOOP_TIMEOUT_NS 5000000000ull
+
+static _Atomic int handoffs;
+
+void goo_thread_pool_handoff(void) {
+    atomic_fetch_add(&handoffs, 1);
+}
+
+static uint64_t elapsed_ns(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - since->tv_sec) * 1000000000ull +
+           (uint64_t)now.tv_nsec - (uint64_t)since->tv_nsec;
+}
+
+typedef struct {
+    uint64_t run_ns;                // Stop after this long, or 0 for WANTED_YIELDS
+    int flags_seen;                 // Times the safepoint found the flag set
+    bool flag_cleared;              // Every yield cleared the flag
+    bool registered;
+    volatile uint64_t sum;
+} HotLoop;
+
+// A goroutine on a registered worker: a tight loop with a back-edge safepoint
+static void* hot_loop_worker(void* arg) {
+    HotLoop* loop = (HotLoop*)arg;
+    loop->flag_cleared = true;
+    loop->registered = goo_preempt_register_worker();
+
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    goo_preempt_task_begin();
+
+    uint64_t limit = loop->run_ns ? loop->run_ns : HOT_LOOP_TIMEOUT_NS;
+    for (uint64_t i = 0; ; i++) {
+        loop->sum += i;
+
+        // The poll codegen emits: a relaxed load and a rarely taken branch
+        if (atomic_load_explicit(&goo_preempt_requested, memory_order_relaxed)) {
+            loop->flags_seen++;
+            goo_safepoint_yield();
+            if (atomic_load_explicit(&goo_preempt_requested, memory_order_relaxed)) {
+                loop->flag_cleared = false;
+            }
+        }
+        if (i % 4096 == 0 &&
+            ((!loop->run_ns && loop->flags_seen >= WANTED_YIELDS) || elapsed_ns(&started) > limit)) {
+            break;
+        }
+    }
+
+    goo_preempt_task_end();
+    goo_preempt_unregister_worker();
+    return NULL;
+}
+
+static void run_hot_loop(HotLoop* loop) {
+    pthread_t worker;
+    pthread_create(&worker, NULL, hot_loop_worker, loop);
+    pthread_join(worker, NULL);
+}
+
+static bool test_hot_loop_preempted(void) {
+    printf("Testing that a hot loop is asked to yield...\n");
+
+    uint64_t requests_before, yields_before;
+    goo_preempt_stats(&requests_before, &yields_before);
+    int handoffs_before = atomic_load(&handoffs);
+
+    HotLoop loop = { 0 };
+    run_hot_loop(&loop);
+
+    uint64_t requests, yields;
+    goo_preempt_stats(&requests, &yields);
+    if (!loop.registered) {
+        fprintf(stderr, "Worker could not register with the monitor\n");
+        return false;
+    }
+    if (loop.flags_seen < WANTED_YIELDS) {
+        fprintf(stderr, "Monitor set the flag %d times in 5 s, expected %d\n",
+                loop.flags_seen, WANTED_YIELDS);
+        return false;
+    }
+    if (!loop.flag_cleared) {
+        fprintf(stderr, "goo_safepoint_yield left the flag set\n");
+        return false;
+    }
+    if (requests - requests_before < (uint64_t)loop.flags_seen) {
+        fprintf(stderr, "Stats show %llu requests for %d flags seen\n",
+                (unsigned long long)(requests - requests_before), loop.flags_seen);
+        return false;
+    }
+    if (yields - yields_before != (uint64_t)loop.flags_seen) {
+        fprintf(stderr, "Stats show %llu yields, the loop took %d\n",
+                (unsigned long long)(yields - yields_before), loop.flags_seen);
+        return false;
+    }
+    if (atomic_load(&handoffs) - handoffs_before != loop.flags_seen) {
+        fprintf(stderr, "Yields handed off %d times, expected %d\n",
+                atomic_load(&handoffs) - handoffs_before, loop.flags_seen);
+        return false;
+    }
+    return true;
+}
+
+typedef struct {
+    _Atomic int stage;              // 1: registered and idle, 2: told to exit
+    int flag;
+} IdleWorker;
+
+// A registered worker with no goroutine running
+static void* idle_worker(void* arg) {
+    IdleWorker* idle = (IdleWorker*)arg;
+    goo_preempt_register_worker();
+    atomic_store(&idle->stage, 1);
+    while (atomic_load(&idle->stage) != 2) {
+        sched_yield();
+    }
+    idle->flag = atomic_load_explicit(&goo_preempt_requested, memory_order_relaxed);
+    goo_preempt_unregister_worker();
+    return NULL;
+}
+
+static void sleep_us(long us) {
+    struct timespec delay = { .tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000 };
+    nanosleep(&delay, NULL);
+}
+
+static bool test_idle_worker_not_flagged(void) {
+    printf("Testing that idle workers are not asked to yield...\n");
+
+    uint64_t requests_before, requests;
+    goo_preempt_stats(&requests_before, NULL);
+
+    IdleWorker idle = { 0 };
+    pthread_t worker;
+    pthread_create(&worker, NULL, idle_worker, &idle);
+    while (atomic_load(&idle.stage) != 1) {
+        sched_yield();
+    }
+    sleep_us(10 * TIME_SLICE_US);
+    atomic_store(&idle.stage, 2);
+    pthread_join(worker, NULL);
+
+    goo_preempt_stats(&requests, NULL);
+    if (requests != requests_before || idle.flag != 0) {
+        fprintf(stderr, "Idle worker was flagged (%llu requests)\n",
+                (unsigned long long)(requests - requests_before));
+        return false;
+    }
+    return true;
+}
+
+static bool test_zero_slice_disables(void) {
+    printf("Testing that a zero time slice disables preemption...\n");
+
+    goo_preempt_set_time_slice(0);
+    if (goo_preempt_get_time_slice() != 0) {
+        fprintf(stderr, "Time slice is %d, expected 0\n", goo_preempt_get_time_slice());
+        return false;
+    }
+
+    uint64_t requests_before, requests;
+    goo_preempt_stats(&requests_before, NULL);
+    HotLoop loop = { .run_ns = 20ull * TIME_SLICE_US * 1000 };
+    run_hot_loop(&loop);
+    goo_preempt_stats(&requests, NULL);
+
+    goo_preempt_set_time_slice(TIME_SLICE_US);
+    if (requests != requests_before || loop.flags_seen != 0) {
+        fprintf(stderr, "Loop was flagged %d times with preemption off\n", loop.flags_seen);
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    if (!goo_preempt_init(TIME_SLICE_US)) {
+        fprintf(stderr, "Failed to start the preemption monitor\n");
+        return 1;
+    }
+    if (goo_preempt_get_time_slice() != TIME_SLICE_US) {
+        fprintf(stderr, "Time slice is %d, expected %d\n", goo_preempt_get_time_slice(), TIME_SLICE_US);
+        failed++;
+    }
+
+    if (!test_hot_loop_preempted()) failed++;
+    if (!test_idle_worker_not_flagged()) failed++;
+    if (!test_zero_slice_disables()) failed++;
+
+    goo_preempt_shutdown();
+
+    if (failed) {
+        printf("%d preemption tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All preemption tests passed\n");
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * scope_stack_test.c
+ *
+ * Tests for the per-thread scope cleanup stack: growth past the inline
+ * entry and scope storage, cleanups that register more cleanups while the
+ * stack unwinds, and the teardown that runs when a thread exits with scopes
+ * still open. goo_free is stubbed with a counting free.
+ */
+
+#include "scope/scope.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// More than the 32 inline entries and 16 inline scopes
+#define MANY_ENTRIES 100
+#define MANY_SCOPES 40
+
+static _Atomic int freed_count;
+static int order[MANY_ENTRIES * 2];
+static int order_count;
+
+void goo_free(void* ptr, size_t size) {
+    (void)size;
+    free(ptr);
+    atomic_fetch_add(&freed_count, 1);
+}
+
+void goo_free_aligned(void* ptr, size_t size, size_t alignment) {
+    (void)size;
+    (void)alignment;
+    free(ptr);
+    atomic_fetch_add(&freed_count, 1);
+}
+
+static void record_cleanup(void* data) {
+    order[order_count++] = (int)(intptr_t)data;
+}
+
+static bool test_entry_growth(void) {
+    printf("Testing growth past the inline entries...\n");
+    order_count = 0;
+    atomic_store(&freed_count, 0);
+
+    goo_scope_enter();
+    for (int i = 1; i <= MANY_ENTRIES; i++) {
+        if (!goo_scope_register_cleanup((void*)(intptr_t)i, record_cleanup) ||
+            !goo_scope_register_memory(malloc(16), 16, i % 2 ? 0 : 16)) {
+            fprintf(stderr, "Failed to register entry %d\n", i);
+            return false;
+        }
+    }
+    goo_scope_exit();
+
+    if (order_count != MANY_ENTRIES || atomic_load(&freed_count) != MANY_ENTRIES) {
+        fprintf(stderr, "Ran %d cleanups and %d frees, expected %d each\n",
+                order_count, atomic_load(&freed_count), MANY_ENTRIES);
+        return false;
+    }
+    for (int i = 0; i < MANY_ENTRIES; i++) {
+        if (order[i] != MANY_ENTRIES - i) {
+            fprintf(stderr, "Cleanup %d ran at position %d\n", order[i], i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_scope_growth(void) {
+    printf("Testing growth past the inline scopes...\n");
+    order_count = 0;
+
+    // One cleanup per scope; each exit must run exactly its own
+    for (int i = 1; i <= MANY_SCOPES; i++) {
+        goo_scope_enter();
+        goo_scope_register_cleanup((void*)(intptr_t)i, record_cleanup);
+    }
+    for (int i = MANY_SCOPES; i >= 1; i--) {
+        goo_scope_exit();
+        if (order_count != MANY_SCOPES - i + 1 || order[order_count - 1] != i) {
+            fprintf(stderr, "Exiting scope %d ran %d cleanups\n", i, order_count);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void register_from_cleanup(void* data) {
+    record_cleanup(data);
+    goo_scope_register_cleanup((void*)(intptr_t)((int)(intptr_t)data + 1000), record_cleanup);
+}
+
+static bool test_register_during_unwind(void) {
+    printf("Testing registration from a running cleanup...\n");
+    order_count = 0;
+
+    goo_scope_enter();
+    goo_scope_register_cleanup((void*)(intptr_t)1, record_cleanup);
+
+    goo_scope_enter();
+    goo_scope_register_cleanup((void*)(intptr_t)2, record_cleanup);
+    goo_scope_register_cleanup((void*)(intptr_t)3, register_from_cleanup);
+    goo_scope_register_cleanup((void*)(intptr_t)4, record_cleanup);
+    goo_scope_exit();
+
+    // The late entry went to the outer scope and has not run yet
+    if (order_count != 3 || order[0] != 4 || order[1] != 3 || order[2] != 2) {
+        fprintf(stderr, "Inner exit ran %d cleanups\n", order_count);
+        return false;
+    }
+
+    goo_scope_exit();
+    if (order_count != 5 || order[3] != 1003 || order[4] != 1) {
+        fprintf(stderr, "Outer exit ran %d cleanups in the wrong order\n", order_count);
+        return false;
+    }
+
+    // A following scope starts clean
+    goo_scope_enter();
+    goo_scope_register_cleanup((void*)(intptr_t)5, record_cleanup);
+    goo_scope_exit();
+    if (order_count != 6 || order[5] != 5) {
+        fprintf(stderr, "Scope after the unwind ran %d cleanups\n", order_count);
+        return false;
+    }
+    return true;
+}
+
+static _Atomic int thread_cleanups;
+
+static void count_thread_cleanup(void* data) {
+    (void)data;
+    atomic_fetch_add(&thread_cleanups, 1);
+}
+
+static void register_at_exit(void* data) {
+    count_thread_cleanup(data);
+    goo_scope_register_cleanup(data, count_thread_cleanup);
+}
+
+static void* thread_main(void* arg) {
+    (void)arg;
+
+    // Leave nested scopes, heap-grown storage and a re-registering cleanup open
+    for (int i = 0; i < MANY_SCOPES; i++) {
+        goo_scope_enter();
+        goo_scope_register_cleanup(arg, count_thread_cleanup);
+        goo_scope_register_memory(malloc(32), 32, 0);
+    }
+    goo_scope_register_cleanup(arg, register_at_exit);
+    return NULL;
+}
+
+static bool test_thread_exit(void) {
+    printf("Testing cleanup at thread exit...\n");
+    atomic_store(&thread_cleanups, 0);
+    atomic_store(&freed_count, 0);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, thread_main, (void*)(intptr_t)1) != 0) {
+        fprintf(stderr, "Failed to create thread\n");
+        return false;
+    }
+    pthread_join(thread, NULL);
+
+    if (atomic_load(&thread_cleanups) != MANY_SCOPES + 2 ||
+        atomic_load(&freed_count) != MANY_SCOPES) {
+        fprintf(stderr, "Thread exit ran %d cleanups and %d frees\n",
+                atomic_load(&thread_cleanups), atomic_load(&freed_count));
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    int failures = 0;
+
+    if (!goo_scope_init()) {
+        fprintf(stderr, "Failed to initialize the scope system\n");
+        return 1;
+    }
+
+    if (!test_entry_growth()) failures++;
+    if (!test_scope_growth()) failures++;
+    if (!test_register_during_unwind()) failures++;
+    if (!test_thread_exit()) failures++;
+
+    goo_scope_cleanup();
+
+    if (failures > 0) {
+        printf("%d scope stack tests failed\n", failures);
+        return 1;
+    }
+
+    printf("All scope stack tests passed\n");
+    return 0;
+}
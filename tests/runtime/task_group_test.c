@@ -0,0 +1,449 @@
+/**
+ * task_group_test.c
+ *
+ * Tests for task groups and futures on a two-worker mock pool: joins and
+ * timed joins, cancellation of futures and group trees, in-flight limits,
+ * bounded spawns from inside children when every worker is spawning, and
+ * child panics reaching the supervisor of the owning task.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_task_group.h"
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Pool size in goroutine_pool_mock.c
+#define POOL_WORKERS 2
+
+// Joins that should finish long before this count as a hang
+#define HANG_TIMEOUT_MS 5000
+
+// Panic recovery state (goroutine_pool_mock.c)
+extern __thread jmp_buf* goo_recover_point;
+extern __thread void* goo_panic_value;
+
+// What the task group runtime does on a goroutine panic
+static void raise_panic(void* value) {
+    goo_panic_value = value;
+    longjmp(*goo_recover_point, 1);
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// A gate tasks block on until the test opens it
+typedef struct Gate {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool open;
+    int waiting;
+} Gate;
+
+static void gate_init(Gate* gate) {
+    pthread_mutex_init(&gate->mutex, NULL);
+    pthread_cond_init(&gate->cond, NULL);
+    gate->open = false;
+    gate->waiting = 0;
+}
+
+static void gate_open(Gate* gate) {
+    pthread_mutex_lock(&gate->mutex);
+    gate->open = true;
+    pthread_cond_broadcast(&gate->cond);
+    pthread_mutex_unlock(&gate->mutex);
+}
+
+static void gate_wait_for(Gate* gate, int waiting) {
+    pthread_mutex_lock(&gate->mutex);
+    while (gate->waiting < waiting) {
+        pthread_cond_wait(&gate->cond, &gate->mutex);
+    }
+    pthread_mutex_unlock(&gate->mutex);
+}
+
+static void gate_destroy(Gate* gate) {
+    pthread_cond_destroy(&gate->cond);
+    pthread_mutex_destroy(&gate->mutex);
+}
+
+static void* gated_task(void* arg) {
+    Gate* gate = (Gate*)arg;
+    pthread_mutex_lock(&gate->mutex);
+    gate->waiting++;
+    pthread_cond_broadcast(&gate->cond);
+    while (!gate->open) {
+        pthread_cond_wait(&gate->cond, &gate->mutex);
+    }
+    gate->waiting--;
+    pthread_mutex_unlock(&gate->mutex);
+    return arg;
+}
+
+static void* square_task(void* arg) {
+    intptr_t value = (intptr_t)arg;
+    return (void*)(value * value);
+}
+
+static bool test_join(void) {
+    printf("Testing future join...\n");
+    GooTaskGroup* group = goo_task_group_create(NULL, 0);
+    GooFuture* futures[16];
+
+    for (intptr_t i = 0; i < 16; i++) {
+        futures[i] = goo_task_group_spawn(group, square_task, (void*)i);
+        if (!futures[i]) {
+            fprintf(stderr, "Failed to spawn task %d\n", (int)i);
+            return false;
+        }
+    }
+
+    bool ok = true;
+    for (intptr_t i = 0; i < 16; i++) {
+        void* result = NULL;
+        if (goo_future_join(futures[i], &result) != GOO_FUTURE_COMPLETED ||
+            (intptr_t)result != i * i) {
+            fprintf(stderr, "Task %d did not complete with %d\n", (int)i, (int)(i * i));
+            ok = false;
+        }
+        goo_future_release(futures[i]);
+    }
+
+    if (!goo_task_group_wait(group) || goo_task_group_in_flight(group) != 0) {
+        fprintf(stderr, "Group did not finish cleanly\n");
+        ok = false;
+    }
+    goo_task_group_destroy(group);
+    return ok;
+}
+
+static bool test_join_timeout(void) {
+    printf("Testing future join timeout...\n");
+    Gate gate;
+    gate_init(&gate);
+    GooTaskGroup* group = goo_task_group_create(NULL, 0);
+    GooFuture* future = goo_task_group_spawn(group, gated_task, &gate);
+
+    bool ok = true;
+    void* result = NULL;
+    if (goo_future_join_timeout(future, 50, &result) != GOO_FUTURE_PENDING || result != NULL) {
+        fprintf(stderr, "Join on a blocked task did not time out\n");
+        ok = false;
+    }
+
+    gate_open(&gate);
+    if (goo_future_join_timeout(future, HANG_TIMEOUT_MS, &result) != GOO_FUTURE_COMPLETED ||
+        result != &gate) {
+        fprintf(stderr, "Join after opening the gate did not complete\n");
+        ok = false;
+    }
+
+    goo_future_release(future);
+    goo_task_group_destroy(group);
+    gate_destroy(&gate);
+    return ok;
+}
+
+static _Atomic int cancelled_ran;
+
+static void* mark_ran(void* arg) {
+    (void)arg;
+    atomic_fetch_add(&cancelled_ran, 1);
+    return NULL;
+}
+
+static _Atomic int waiting_for_cancel;
+
+static void* wait_for_cancel(void* arg) {
+    atomic_fetch_add(&waiting_for_cancel, 1);
+    while (!goo_task_cancelled()) {
+        sleep_ms(1);
+    }
+    return arg;
+}
+
+static bool test_cancellation(void) {
+    printf("Testing cancellation...\n");
+    bool ok = true;
+    atomic_store(&cancelled_ran, 0);
+
+    // Occupy every worker so the next future is still queued when cancelled
+    Gate gate;
+    gate_init(&gate);
+    GooTaskGroup* blockers = goo_task_group_create(NULL, 0);
+    for (int i = 0; i < POOL_WORKERS; i++) {
+        goo_future_release(goo_task_group_spawn(blockers, gated_task, &gate));
+    }
+    gate_wait_for(&gate, POOL_WORKERS);
+
+    GooTaskGroup* group = goo_task_group_create(NULL, 0);
+    GooFuture* queued = goo_task_group_spawn(group, mark_ran, NULL);
+    goo_future_cancel(queued);
+    gate_open(&gate);
+
+    if (goo_future_join_timeout(queued, HANG_TIMEOUT_MS, NULL) != GOO_FUTURE_CANCELLED ||
+        atomic_load(&cancelled_ran) != 0) {
+        fprintf(stderr, "Cancelled future still ran\n");
+        ok = false;
+    }
+    goo_future_release(queued);
+    goo_task_group_destroy(blockers);
+    gate_destroy(&gate);
+
+    // Cancelling a parent reaches running children of descendant groups
+    GooTaskGroup* child = goo_task_group_create(group, 0);
+    atomic_store(&waiting_for_cancel, 0);
+    GooFuture* running = goo_task_group_spawn(child, wait_for_cancel, group);
+    while (atomic_load(&waiting_for_cancel) == 0) {
+        sleep_ms(1);
+    }
+    goo_task_group_cancel(group);
+
+    if (goo_future_join_timeout(running, HANG_TIMEOUT_MS, NULL) != GOO_FUTURE_COMPLETED) {
+        fprintf(stderr, "Running child did not observe the parent's cancellation\n");
+        ok = false;
+    }
+    if (!goo_task_group_is_cancelled(child)) {
+        fprintf(stderr, "Child group not cancelled with its parent\n");
+        ok = false;
+    }
+    if (goo_task_group_spawn(child, mark_ran, NULL) != NULL) {
+        fprintf(stderr, "Spawn into a cancelled group succeeded\n");
+        ok = false;
+    }
+
+    goo_future_release(running);
+    goo_task_group_destroy(child);
+    goo_task_group_destroy(group);
+    return ok;
+}
+
+typedef struct SpawnArgs {
+    GooTaskGroup* group;
+    Gate* gate;
+    _Atomic bool returned;
+} SpawnArgs;
+
+static void* blocking_spawn_main(void* arg) {
+    SpawnArgs* args = (SpawnArgs*)arg;
+    GooFuture* future = goo_task_group_spawn(args->group, gated_task, args->gate);
+    atomic_store(&args->returned, true);
+    goo_future_release(future);
+    return NULL;
+}
+
+static _Atomic int running_now;
+static _Atomic int running_peak;
+
+static void* track_concurrency(void* arg) {
+    (void)arg;
+    int now = atomic_fetch_add(&running_now, 1) + 1;
+    int peak = atomic_load(&running_peak);
+    while (now > peak && !atomic_compare_exchange_weak(&running_peak, &peak, now)) {
+    }
+    sleep_ms(2);
+    atomic_fetch_sub(&running_now, 1);
+    return NULL;
+}
+
+static bool test_backpressure(void) {
+    printf("Testing in-flight limits...\n");
+    bool ok = true;
+    Gate gate;
+    gate_init(&gate);
+    GooTaskGroup* group = goo_task_group_create(NULL, 1);
+
+    GooFuture* first = goo_task_group_spawn(group, gated_task, &gate);
+    if (goo_task_group_try_spawn(group, gated_task, &gate) != NULL ||
+        goo_task_group_in_flight(group) != 1) {
+        fprintf(stderr, "try_spawn ignored the in-flight limit\n");
+        ok = false;
+    }
+
+    // A blocking spawn from outside the pool waits for the slot
+    SpawnArgs args = { group, &gate, false };
+    pthread_t spawner;
+    pthread_create(&spawner, NULL, blocking_spawn_main, &args);
+    sleep_ms(50);
+    if (atomic_load(&args.returned)) {
+        fprintf(stderr, "Blocking spawn returned while the group was full\n");
+        ok = false;
+    }
+
+    gate_open(&gate);
+    pthread_join(spawner, NULL);
+    goo_future_release(first);
+    goo_task_group_wait(group);
+    goo_task_group_destroy(group);
+    gate_destroy(&gate);
+
+    // Concurrency never exceeds the limit
+    atomic_store(&running_now, 0);
+    atomic_store(&running_peak, 0);
+    group = goo_task_group_create(NULL, POOL_WORKERS - 1);
+    for (int i = 0; i < 20; i++) {
+        goo_future_release(goo_task_group_spawn(group, track_concurrency, NULL));
+    }
+    goo_task_group_destroy(group);
+
+    if (atomic_load(&running_peak) > POOL_WORKERS - 1) {
+        fprintf(stderr, "%d children ran at once with a limit of %d\n",
+                atomic_load(&running_peak), POOL_WORKERS - 1);
+        ok = false;
+    }
+    return ok;
+}
+
+static Gate parents_spawning;
+
+// Holds a slot, waits until every worker runs a parent, then spawns into the full group
+static void* spawn_child_task(void* arg) {
+    GooTaskGroup* group = (GooTaskGroup*)arg;
+
+    pthread_mutex_lock(&parents_spawning.mutex);
+    parents_spawning.waiting++;
+    pthread_cond_broadcast(&parents_spawning.cond);
+    while (parents_spawning.waiting < POOL_WORKERS) {
+        pthread_cond_wait(&parents_spawning.cond, &parents_spawning.mutex);
+    }
+    pthread_mutex_unlock(&parents_spawning.mutex);
+
+    void* result = NULL;
+    GooFuture* child = goo_task_group_spawn(group, square_task, (void*)(intptr_t)7);
+    if (!child || goo_future_join(child, &result) != GOO_FUTURE_COMPLETED) {
+        return NULL;
+    }
+    goo_future_release(child);
+    return result;
+}
+
+static bool test_spawn_from_full_pool(void) {
+    printf("Testing bounded spawn from every pool worker...\n");
+    bool ok = true;
+    gate_init(&parents_spawning);
+
+    // Each parent holds one of the group's slots and one of the workers
+    GooTaskGroup* group = goo_task_group_create(NULL, POOL_WORKERS);
+    GooFuture* parents[POOL_WORKERS];
+    for (int i = 0; i < POOL_WORKERS; i++) {
+        parents[i] = goo_task_group_spawn(group, spawn_child_task, group);
+    }
+
+    for (int i = 0; i < POOL_WORKERS; i++) {
+        void* result = NULL;
+        GooFutureState state = goo_future_join_timeout(parents[i], HANG_TIMEOUT_MS, &result);
+        if (state == GOO_FUTURE_PENDING) {
+            // The pool is wedged; nothing can be cleaned up
+            fprintf(stderr, "Parent %d deadlocked spawning into a full group\n", i);
+            exit(1);
+        }
+        if (state != GOO_FUTURE_COMPLETED || (intptr_t)result != 49) {
+            fprintf(stderr, "Parent %d did not get its child's result\n", i);
+            ok = false;
+        }
+        goo_future_release(parents[i]);
+    }
+
+    goo_task_group_destroy(group);
+    gate_destroy(&parents_spawning);
+    return ok;
+}
+
+// Supervisor stand-in; only the pointer is compared
+static int fake_supervisor;
+static void owner_task(void* arg) { (void)arg; }
+
+static pthread_mutex_t report_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int report_count;
+static GooTask reported_task;
+static void* reported_error;
+
+void goo_supervise_handle_error(GooSupervisor* supervisor, GooTask* failed_task, void* error_info) {
+    pthread_mutex_lock(&report_mutex);
+    report_count++;
+    reported_task = *failed_task;
+    reported_task.supervisor = supervisor;
+    reported_error = error_info;
+    pthread_mutex_unlock(&report_mutex);
+}
+
+static int panic_value;
+
+static void* panicking_task(void* arg) {
+    (void)arg;
+    raise_panic(&panic_value);
+    return NULL;
+}
+
+static bool test_panic_reaches_supervisor(void) {
+    printf("Testing child panics reach the supervisor...\n");
+    bool ok = true;
+    GooSupervisor* supervisor = (GooSupervisor*)&fake_supervisor;
+    int owner_arg = 0;
+
+    // The supervised task's group has the owner; the panic is one level down
+    GooTaskGroup* owned = goo_task_group_create(NULL, 0);
+    goo_task_group_set_supervisor(owned, supervisor);
+    goo_task_group_set_owner(owned, owner_task, &owner_arg);
+    GooTaskGroup* nested = goo_task_group_create(owned, 0);
+
+    GooFuture* sibling = goo_task_group_spawn(nested, wait_for_cancel, NULL);
+    GooFuture* failing = goo_task_group_spawn(nested, panicking_task, NULL);
+
+    if (goo_future_join_timeout(failing, HANG_TIMEOUT_MS, NULL) != GOO_FUTURE_FAILED ||
+        goo_future_error(failing) != &panic_value) {
+        fprintf(stderr, "Panicking child did not fail with its panic value\n");
+        ok = false;
+    }
+    if (goo_future_join_timeout(sibling, HANG_TIMEOUT_MS, NULL) == GOO_FUTURE_PENDING) {
+        fprintf(stderr, "Sibling not cancelled by the failure\n");
+        ok = false;
+    }
+    if (goo_task_group_wait(nested) || goo_task_group_error(nested) != &panic_value) {
+        fprintf(stderr, "Group did not record the failure\n");
+        ok = false;
+    }
+
+    pthread_mutex_lock(&report_mutex);
+    if (report_count != 1 || reported_task.supervisor != supervisor ||
+        reported_task.func != owner_task || reported_task.arg != &owner_arg ||
+        reported_error != &panic_value) {
+        fprintf(stderr, "Supervisor saw %d reports, expected one for the owning task\n",
+                report_count);
+        ok = false;
+    }
+    pthread_mutex_unlock(&report_mutex);
+
+    goo_future_release(sibling);
+    goo_future_release(failing);
+    goo_task_group_destroy(nested);
+    goo_task_group_destroy(owned);
+    return ok;
+}
+
+int main(void) {
+    int failures = 0;
+
+    if (!test_join()) failures++;
+    if (!test_join_timeout()) failures++;
+    if (!test_cancellation()) failures++;
+    if (!test_backpressure()) failures++;
+    if (!test_spawn_from_full_pool()) failures++;
+    if (!test_panic_reaches_supervisor()) failures++;
+
+    if (failures > 0) {
+        printf("%d task group tests failed\n", failures);
+        return 1;
+    }
+
+    printf("All task group tests passed\n");
+    return 0;
+}
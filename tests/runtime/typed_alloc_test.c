@@ -0,0 +1,222 @@
+/**
+ * typed_alloc_test.c
+ *
+ * Tests for the size-class pools behind goo_runtime_typed_alloc. Threads
+ * allocate typed objects of every size class and free each other's objects;
+ * objects that fell back to malloc because no pool could be created must be
+ * freed back to malloc and never handed out by a pool. Meant to be run under
+ * ASan and TSan as well as plainly.
+ */
+
+/* Ensure pthread barriers are available */
+#define _POSIX_C_SOURCE 200809L
+
+#include "goo_integration.h"
+#include "goo_concurrent_pool.h"
+#include "goo_typed_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THREADS 8
+#define ROUNDS 50
+#define OBJECTS_PER_ROUND 256
+#define FALLBACK_SIZE 40
+#define FALLBACK_ALLOCS (4 * GOO_MAGAZINE_ROUNDS)
+
+static void* objects[THREADS][OBJECTS_PER_ROUND];
+static pthread_barrier_t round_barrier;
+static _Atomic int failures;
+
+static size_t object_size(int index) {
+    return 1 + (size_t)(index * 37) % GOO_TYPED_POOL_MAX_SIZE;
+}
+
+static bool check_fill(const unsigned char* object, size_t size, unsigned char fill) {
+    for (size_t i = 0; i < size; i++) {
+        if (object[i] != fill) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Each round, every thread fills a batch and then frees its neighbour's
+static void* typed_worker(void* arg) {
+    int thread = (int)(intptr_t)arg;
+    int neighbour = (thread + 1) % THREADS;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        unsigned char fill = (unsigned char)(thread * ROUNDS + round);
+        for (int i = 0; i < OBJECTS_PER_ROUND; i++) {
+            size_t size = object_size(i);
+            unsigned char* object = goo_typed_pool_alloc(size, "TestObject");
+            if (!object || ((uintptr_t)object & 7) != 0) {
+                atomic_fetch_add(&failures, 1);
+                objects[thread][i] = NULL;
+                continue;
+            }
+            memset(object, fill, size);
+            objects[thread][i] = object;
+        }
+
+        pthread_barrier_wait(&round_barrier);
+
+        unsigned char neighbour_fill = (unsigned char)(neighbour * ROUNDS + round);
+        for (int i = 0; i < OBJECTS_PER_ROUND; i++) {
+            unsigned char* object = objects[neighbour][i];
+            if (!object) {
+                continue;
+            }
+            if (!check_fill(object, object_size(i), neighbour_fill)) {
+                atomic_fetch_add(&failures, 1);
+            }
+            goo_typed_pool_free(object);
+        }
+
+        pthread_barrier_wait(&round_barrier);
+    }
+
+    return NULL;
+}
+
+static bool test_concurrent_alloc_free(void) {
+    printf("Testing typed alloc/free across threads...\n");
+
+    pthread_t threads[THREADS];
+    pthread_barrier_init(&round_barrier, NULL, THREADS);
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, typed_worker, (void*)(intptr_t)i);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&round_barrier);
+
+    if (atomic_load(&failures) != 0) {
+        fprintf(stderr, "%d typed objects were missing, misaligned or overwritten\n",
+                atomic_load(&failures));
+        return false;
+    }
+    return true;
+}
+
+static bool test_size_classes(void) {
+    printf("Testing size-class pool lookup...\n");
+
+    GooConcurrentPool* pool = goo_runtime_get_type_pool(17, "A");
+    if (!pool || goo_runtime_get_type_pool(32, "B") != pool) {
+        fprintf(stderr, "Sizes in one 16-byte class got different pools\n");
+        return false;
+    }
+    if (goo_runtime_get_type_pool(33, "C") == pool) {
+        fprintf(stderr, "Sizes in different classes share a pool\n");
+        return false;
+    }
+    if (goo_concurrent_pool_chunk_size(pool) < 32) {
+        fprintf(stderr, "Pool chunks are smaller than the size class\n");
+        return false;
+    }
+    if (goo_runtime_get_type_pool(0, "D") || goo_runtime_get_type_pool(GOO_TYPED_POOL_MAX_SIZE + 1, "E")) {
+        fprintf(stderr, "Sizes outside the pool range got a pool\n");
+        return false;
+    }
+    if (goo_typed_pool_serves(16, NULL) || goo_typed_pool_serves(GOO_TYPED_POOL_MAX_SIZE + 1, "F")) {
+        fprintf(stderr, "Untyped or oversized objects are served by the pools\n");
+        return false;
+    }
+    return true;
+}
+
+static void* free_on_other_thread(void* object) {
+    goo_typed_pool_free(object);
+    return NULL;
+}
+
+static bool test_malloc_fallback(void) {
+    printf("Testing the malloc fallback when no pool can be created...\n");
+
+    // Take every pool slot so the size-class pool cannot be created
+    GooConcurrentPool* fillers[GOO_CONCURRENT_POOL_MAX];
+    int filler_count = 0;
+    while (filler_count < GOO_CONCURRENT_POOL_MAX) {
+        GooConcurrentPool* filler = goo_concurrent_pool_create(NULL, 16, 8);
+        if (!filler) {
+            break;
+        }
+        fillers[filler_count++] = filler;
+    }
+
+    bool ok = true;
+    unsigned char* fallback = goo_typed_pool_alloc(FALLBACK_SIZE, "Fallback");
+    if (!fallback) {
+        fprintf(stderr, "Typed allocation failed instead of falling back to malloc\n");
+        ok = false;
+    } else if (goo_runtime_get_type_pool(FALLBACK_SIZE, "Fallback") != NULL) {
+        fprintf(stderr, "A pool was created although every slot was taken\n");
+        ok = false;
+    } else {
+        memset(fallback, 0x5a, FALLBACK_SIZE);
+    }
+
+    for (int i = 0; i < filler_count; i++) {
+        goo_concurrent_pool_destroy(fillers[i]);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    // The pool can be created now; objects from it and from malloc coexist
+    unsigned char* pooled = goo_typed_pool_alloc(FALLBACK_SIZE, "Fallback");
+    if (!pooled || !goo_runtime_get_type_pool(FALLBACK_SIZE, "Fallback")) {
+        fprintf(stderr, "Size-class pool was not created once slots were free\n");
+        return false;
+    }
+    if (!check_fill(fallback, FALLBACK_SIZE, 0x5a)) {
+        fprintf(stderr, "Fallback object was overwritten\n");
+        return false;
+    }
+
+    // Free the fallback from another thread; it must go back to malloc,
+    // so the pool never hands it out
+    pthread_t thread;
+    pthread_create(&thread, NULL, free_on_other_thread, fallback);
+    pthread_join(thread, NULL);
+    goo_typed_pool_free(pooled);
+
+    void* reused[FALLBACK_ALLOCS];
+    for (int i = 0; i < FALLBACK_ALLOCS; i++) {
+        reused[i] = goo_typed_pool_alloc(FALLBACK_SIZE, "Fallback");
+        if (reused[i] == (void*)fallback) {
+            fprintf(stderr, "Pool handed out an object that came from malloc\n");
+            ok = false;
+        }
+    }
+    for (int i = 0; i < FALLBACK_ALLOCS; i++) {
+        goo_typed_pool_free(reused[i]);
+    }
+    return ok;
+}
+
+int main(void) {
+    int failed = 0;
+
+    // The fallback test needs every pool slot free, so it runs first
+    if (!test_malloc_fallback()) failed++;
+    if (!test_size_classes()) failed++;
+    if (!test_concurrent_alloc_free()) failed++;
+
+    goo_typed_pool_shutdown();
+
+    if (failed) {
+        printf("%d typed allocation tests failed\n", failed);
+        return 1;
+    }
+
+    printf("All typed allocation tests passed\n");
+    return 0;
+}
@@ -0,0 +1,613 @@
+/**
+ * vectorization_test.c
+ *
+ * Randomized comparison of the SIMD kernels against the scalar reference.
+ * Every SIMD level must give bit-identical results to GOO_SIMD_SCALAR;
+ * levels above the host's fall back to its best kernels, so they are run too.
+ */
+
+#include "goo_vectorization.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LENGTH 1000
+
+typedef struct {
+    GooVectorDataType type;
+    const char* name;
+    size_t size;
+} TypeInfo;
+
+static const TypeInfo types[] = {
+    { GOO_VEC_INT8, "i8", 1 },     { GOO_VEC_UINT8, "u8", 1 },
+    { GOO_VEC_INT16, "i16", 2 },   { GOO_VEC_UINT16, "u16", 2 },
+    { GOO_VEC_INT32, "i32", 4 },   { GOO_VEC_UINT32, "u32", 4 },
+    { GOO_VEC_INT64, "i64", 8 },   { GOO_VEC_UINT64, "u64", 8 },
+    { GOO_VEC_FLOAT, "f32", 4 },   { GOO_VEC_DOUBLE, "f64", 8 },
+};
+#define TYPE_COUNT (sizeof(types) / sizeof(types[0]))
+
+static const struct {
+    GooSIMDType level;
+    const char* name;
+} levels[] = {
+    { GOO_SIMD_SSE2, "SSE2" },
+    { GOO_SIMD_SSE4, "SSE4" },
+    { GOO_SIMD_AVX, "AVX" },
+    { GOO_SIMD_AVX2, "AVX2" },
+    { GOO_SIMD_AVX512, "AVX-512" },
+    { GOO_SIMD_NEON, "NEON" },
+};
+#define LEVEL_COUNT (sizeof(levels) / sizeof(levels[0]))
+
+static GooSIMDType host_level;
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545f4914f6cdd1dull;
+}
+
+static bool is_float_type(GooVectorDataType type) {
+    return type == GOO_VEC_FLOAT || type == GOO_VEC_DOUBLE;
+}
+
+static bool is_signed_type(GooVectorDataType type) {
+    return type == GOO_VEC_INT8 || type == GOO_VEC_INT16 ||
+           type == GOO_VEC_INT32 || type == GOO_VEC_INT64;
+}
+
+// Random element with edge values (0, 1, -1, MIN, MAX, tiny, huge) mixed in.
+// Divisors are never zero or near zero so the scalar path's warnings stay quiet
+static void random_element(const TypeInfo* info, void* out, bool divisor) {
+    uint64_t r = next_random();
+    bool edge = (r & 7) == 0;
+    int which = (int)((r >> 3) % 5);
+
+    if (is_float_type(info->type)) {
+        static const double edges[] = { 0.0, -0.0, 1e-30, -1e30, 1.0 };
+        double value = edge ? edges[which] : (double)(int32_t)(r >> 32) / 1024.0;
+        if (divisor && fabs(value) < 1e-6) value = 1.0;
+        if (info->type == GOO_VEC_FLOAT) {
+            float f = (float)value;
+            memcpy(out, &f, sizeof(f));
+        } else {
+            memcpy(out, &value, sizeof(value));
+        }
+        return;
+    }
+
+    uint64_t bits = r >> 8;
+    if (edge) {
+        unsigned width = (unsigned)info->size * 8;
+        uint64_t all = width == 64 ? ~0ull : (1ull << width) - 1;
+        uint64_t sign = 1ull << (width - 1);
+        bool is_signed = is_signed_type(info->type);
+        switch (which) {
+            case 0: bits = 0; break;
+            case 1: bits = 1; break;
+            case 2: bits = all; break;                        // -1 or unsigned MAX
+            case 3: bits = is_signed ? sign : 0; break;       // MIN
+            default: bits = is_signed ? sign - 1 : all; break; // MAX
+        }
+    }
+    if (divisor && (bits & (info->size == 8 ? ~0ull : (1ull << (info->size * 8)) - 1)) == 0) {
+        bits = 1;
+    }
+    memcpy(out, &bits, info->size);  // Little-endian truncation
+}
+
+static void fill_random(const TypeInfo* info, void* buf, size_t length, bool divisor) {
+    for (size_t i = 0; i < length; i++) {
+        random_element(info, (char*)buf + i * info->size, divisor);
+    }
+}
+
+// Elements match when bit-identical, or both NaN
+static bool elements_equal(const TypeInfo* info, const void* a, const void* b) {
+    if (memcmp(a, b, info->size) == 0) return true;
+    if (info->type == GOO_VEC_FLOAT) {
+        float x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        return isnan(x) && isnan(y);
+    }
+    if (info->type == GOO_VEC_DOUBLE) {
+        double x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        return isnan(x) && isnan(y);
+    }
+    return false;
+}
+
+static bool run_op(GooSIMDType level, const TypeInfo* info, GooVectorOp op,
+                   void* a, void* b, void* dst, size_t length) {
+    GooVectorOperation vec_op = {
+        .base = {
+            .src1 = a,
+            .src2 = b,
+            .dst = dst,
+            .elem_size = info->size,
+            .length = length,
+            .op = op,
+        },
+        .simd_type = level,
+        .data_type = info->type,
+    };
+    return goo_vectorization_execute(&vec_op);
+}
+
+static const char* op_name(GooVectorOp op) {
+    switch (op) {
+        case GOO_VECTOR_ADD: return "add";
+        case GOO_VECTOR_SUB: return "sub";
+        case GOO_VECTOR_MUL: return "mul";
+        case GOO_VECTOR_DIV: return "div";
+        case GOO_VECTOR_FMA: return "fma";
+        default: return "op";
+    }
+}
+
+// Run op at every level and compare with the scalar reference. dst starts
+// as a copy of dst_init at byte offset dst_offset (0-63); with in_place, a
+// is dst itself
+static bool compare_levels_at(const TypeInfo* info, GooVectorOp op, void* a, void* b,
+                              const void* dst_init, size_t length, size_t dst_offset,
+                              bool in_place) {
+    static unsigned char expected_buf[MAX_LENGTH * 8 + 64];
+    static unsigned char actual_buf[MAX_LENGTH * 8 + 64];
+    unsigned char* expected = expected_buf + dst_offset;
+    unsigned char* actual = actual_buf + dst_offset;
+    size_t bytes = length * info->size;
+
+    memcpy(expected, dst_init, bytes);
+    if (!run_op(GOO_SIMD_SCALAR, info, op, in_place ? expected : a, b, expected, length)) {
+        fprintf(stderr, "Scalar %s %s failed at length %zu\n", info->name, op_name(op), length);
+        return false;
+    }
+
+    for (size_t l = 0; l < LEVEL_COUNT; l++) {
+        memcpy(actual, dst_init, bytes);
+        if (!run_op(levels[l].level, info, op, in_place ? actual : a, b, actual, length)) {
+            fprintf(stderr, "%s %s %s failed at length %zu\n",
+                    levels[l].name, info->name, op_name(op), length);
+            return false;
+        }
+        for (size_t i = 0; i < length; i++) {
+            if (!elements_equal(info, expected + i * info->size, actual + i * info->size)) {
+                fprintf(stderr, "%s %s %s differs from scalar at index %zu of %zu "
+                        "(dst offset %zu%s)\n", levels[l].name, info->name, op_name(op),
+                        i, length, dst_offset, in_place ? ", in place" : "");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool compare_levels(const TypeInfo* info, GooVectorOp op, void* a, void* b,
+                           const void* dst_init, size_t length) {
+    return compare_levels_at(info, op, a, b, dst_init, length, 0, false);
+}
+
+// Lengths 1-67 cover every head/tail shape; a few random ones up to 1000
+static size_t test_length(int iteration) {
+    return iteration < 67 ? (size_t)iteration + 1 : 1 + (size_t)(next_random() % MAX_LENGTH);
+}
+#define LENGTH_ITERATIONS 87
+
+static bool test_elementwise_ops(void) {
+    printf("Testing add/sub/mul/div against scalar...\n");
+    static const GooVectorOp ops[] = { GOO_VECTOR_ADD, GOO_VECTOR_SUB, GOO_VECTOR_MUL, GOO_VECTOR_DIV };
+    static unsigned char a[MAX_LENGTH * 8], b[MAX_LENGTH * 8], dst[MAX_LENGTH * 8];
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+            for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+                size_t length = test_length(iteration);
+                fill_random(&types[t], a, length, false);
+                fill_random(&types[t], b, length, ops[o] == GOO_VECTOR_DIV);
+                memset(dst, 0, length * types[t].size);
+                if (!compare_levels(&types[t], ops[o], a, b, dst, length)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Zero and near-zero divisors and MIN / -1 take the guarded scalar blocks
+static bool test_guarded_division(void) {
+    printf("Testing guarded division (expect division warnings)...\n");
+    static unsigned char a[64 * 8], b[64 * 8], dst[64 * 8];
+    const size_t length = 40;
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        const TypeInfo* info = &types[t];
+        fill_random(info, a, length, false);
+        fill_random(info, b, length, true);
+        memset(b + 5 * info->size, 0, info->size);
+        memset(b + 33 * info->size, 0, info->size);
+        if (info->type == GOO_VEC_FLOAT) {
+            float tiny = 1e-20f;
+            memcpy(b + 21 * info->size, &tiny, sizeof(tiny));
+        } else if (info->type == GOO_VEC_DOUBLE) {
+            double tiny = -1e-20;
+            memcpy(b + 21 * info->size, &tiny, sizeof(tiny));
+        } else if (is_signed_type(info->type)) {
+            uint64_t min = 1ull << (info->size * 8 - 1);
+            memcpy(a + 17 * info->size, &min, info->size);
+            memset(b + 17 * info->size, 0xff, info->size);
+        }
+        memset(dst, 0, length * info->size);
+        if (!compare_levels(info, GOO_VECTOR_DIV, a, b, dst, length)) return false;
+    }
+    return true;
+}
+
+// Small integer-valued floats keep sums and dot products exact whatever the
+// summation order; NaNs are mixed in when asked. Integers use full range
+static void fill_small(const TypeInfo* info, void* buf, size_t length, bool with_nan) {
+    for (size_t i = 0; i < length; i++) {
+        void* out = (char*)buf + i * info->size;
+        if (!is_float_type(info->type)) {
+            random_element(info, out, false);
+            continue;
+        }
+        uint64_t r = next_random();
+        double value = (double)((int)(r % 129) - 64);
+        if (with_nan && (r >> 8) % 16 == 0) value = NAN;
+        if (info->type == GOO_VEC_FLOAT) {
+            float f = (float)value;
+            memcpy(out, &f, sizeof(f));
+        } else {
+            memcpy(out, &value, sizeof(value));
+        }
+    }
+}
+
+// Scalar-only buffers for the reference run
+static unsigned char ref_buf[MAX_LENGTH * 8 + 64];
+static unsigned char out_buf[MAX_LENGTH * 8 + 64];
+
+// Run body at the scalar level into ref_buf, then at each host level into
+// out_buf, comparing bytes elements at a time. The reductions, compares,
+// blends, gathers and scatters run at the level set by
+// goo_vectorization_init, so levels above the host's are skipped here
+#define FOR_EACH_HOST_LEVEL(level_index)                                     \
+    for (size_t level_index = 0; level_index < LEVEL_COUNT; level_index++)   \
+        if (levels[level_index].level <= host_level)
+
+static bool results_match(const TypeInfo* info, const void* expected, const void* actual,
+                          size_t count, const char* what, const char* level, size_t length) {
+    for (size_t i = 0; i < count; i++) {
+        if (!elements_equal(info, (const char*)expected + i * info->size,
+                            (const char*)actual + i * info->size)) {
+            fprintf(stderr, "%s %s %s differs from scalar at index %zu (length %zu)\n",
+                    level, info->name, what, i, length);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool test_reductions(void) {
+    printf("Testing reductions and dot products against scalar...\n");
+    static const char* names[] = { "sum", "min", "max" };
+    static unsigned char a[MAX_LENGTH * 8], b[MAX_LENGTH * 8];
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        const TypeInfo* info = &types[t];
+        // Sums are written as 64-bit integers for integer types
+        const TypeInfo sum_info = is_float_type(info->type) ? *info :
+            (TypeInfo){ GOO_VEC_UINT64, info->name, 8 };
+
+        for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+            size_t length = test_length(iteration);
+            for (int op = GOO_VEC_REDUCE_SUM; op <= GOO_VEC_REDUCE_MAX; op++) {
+                const TypeInfo* result_info = op == GOO_VEC_REDUCE_SUM ? &sum_info : info;
+                fill_small(info, a, length, op != GOO_VEC_REDUCE_SUM);
+
+                uint64_t expected = 0;
+                goo_vectorization_init(GOO_SIMD_SCALAR);
+                goo_vectorization_reduce((GooVectorReduceOp)op, a, length, info->type, &expected);
+
+                FOR_EACH_HOST_LEVEL(l) {
+                    uint64_t actual = 0;
+                    goo_vectorization_init(levels[l].level);
+                    goo_vectorization_reduce((GooVectorReduceOp)op, a, length, info->type, &actual);
+                    if (!results_match(result_info, &expected, &actual, 1, names[op],
+                                       levels[l].name, length)) {
+                        return false;
+                    }
+                }
+            }
+
+            fill_small(info, a, length, false);
+            fill_small(info, b, length, false);
+            uint64_t expected = 0;
+            goo_vectorization_init(GOO_SIMD_SCALAR);
+            goo_vectorization_dot(a, b, length, info->type, &expected);
+            FOR_EACH_HOST_LEVEL(l) {
+                uint64_t actual = 0;
+                goo_vectorization_init(levels[l].level);
+                goo_vectorization_dot(a, b, length, info->type, &actual);
+                if (!results_match(&sum_info, &expected, &actual, 1, "dot", levels[l].name, length)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool test_fma(void) {
+    printf("Testing fused multiply-add against scalar...\n");
+    static unsigned char a[MAX_LENGTH * 8], b[MAX_LENGTH * 8], dst[MAX_LENGTH * 8];
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        if (!is_float_type(types[t].type)) continue;
+        for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+            size_t length = test_length(iteration);
+            fill_random(&types[t], a, length, false);
+            fill_random(&types[t], b, length, false);
+            fill_random(&types[t], dst, length, false);
+            if (!compare_levels(&types[t], GOO_VECTOR_FMA, a, b, dst, length)) return false;
+        }
+    }
+    return true;
+}
+
+static bool test_compare_and_blend(void) {
+    printf("Testing compare, blend and masked execution against scalar...\n");
+    static unsigned char a[MAX_LENGTH * 8], b[MAX_LENGTH * 8], mask_data[MAX_LENGTH * 8];
+    static unsigned char dst[MAX_LENGTH * 8];
+    static const char* names[] = { "eq", "ne", "lt", "le", "gt", "ge" };
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        const TypeInfo* info = &types[t];
+        for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+            size_t length = test_length(iteration);
+            size_t bytes = length * info->size;
+
+            // Half the elements equal so EQ and NE both see matches
+            fill_small(info, a, length, true);
+            fill_small(info, b, length, true);
+            for (size_t i = 0; i < length; i++) {
+                if (next_random() & 1) {
+                    memcpy(b + i * info->size, a + i * info->size, info->size);
+                }
+            }
+
+            for (int cmp = GOO_VEC_CMP_EQ; cmp <= GOO_VEC_CMP_GE; cmp++) {
+                GooVectorMask mask = { ref_buf, bytes, info->type };
+                goo_vectorization_init(GOO_SIMD_SCALAR);
+                goo_vectorization_compare((GooVectorCompareOp)cmp, a, b, length, info->type, &mask);
+
+                FOR_EACH_HOST_LEVEL(l) {
+                    mask.mask_data = out_buf;
+                    goo_vectorization_init(levels[l].level);
+                    goo_vectorization_compare((GooVectorCompareOp)cmp, a, b, length, info->type, &mask);
+                    if (memcmp(ref_buf, out_buf, bytes) != 0) {
+                        fprintf(stderr, "%s %s compare %s differs from scalar (length %zu)\n",
+                                levels[l].name, info->name, names[cmp], length);
+                        return false;
+                    }
+                }
+            }
+
+            // Mask elements are all zeros or all ones
+            for (size_t i = 0; i < length; i++) {
+                memset(mask_data + i * info->size, (next_random() & 1) ? 0xff : 0, info->size);
+            }
+            GooVectorMask mask = { mask_data, bytes, info->type };
+
+            goo_vectorization_init(GOO_SIMD_SCALAR);
+            goo_vectorization_blend(a, b, &mask, ref_buf, length, info->type);
+            FOR_EACH_HOST_LEVEL(l) {
+                goo_vectorization_init(levels[l].level);
+                goo_vectorization_blend(a, b, &mask, out_buf, length, info->type);
+                if (!results_match(info, ref_buf, out_buf, length, "blend", levels[l].name, length)) {
+                    return false;
+                }
+            }
+
+            // Masked add keeps dst where the mask is clear
+            fill_random(info, a, length, false);
+            fill_random(info, b, length, false);
+            fill_random(info, dst, length, false);
+            GooVectorOperation vec_op = {
+                .base = { a, b, ref_buf, info->size, length, GOO_VECTOR_ADD, NULL },
+                .simd_type = GOO_SIMD_SCALAR,
+                .data_type = info->type,
+                .mask = &mask,
+            };
+            memcpy(ref_buf, dst, bytes);
+            goo_vectorization_execute(&vec_op);
+            FOR_EACH_HOST_LEVEL(l) {
+                memcpy(out_buf, dst, bytes);
+                vec_op.base.dst = out_buf;
+                vec_op.simd_type = levels[l].level;
+                goo_vectorization_execute(&vec_op);
+                if (!results_match(info, ref_buf, out_buf, length, "masked add", levels[l].name, length)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool test_gather_scatter(void) {
+    printf("Testing gather and scatter against scalar (expect out-of-bounds errors)...\n");
+    static unsigned char base[MAX_LENGTH * 8], src[MAX_LENGTH * 8];
+    static int32_t indices[MAX_LENGTH];
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        const TypeInfo* info = &types[t];
+        for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+            size_t length = test_length(iteration);
+            size_t base_length = 1 + (size_t)(next_random() % MAX_LENGTH);
+            fill_random(info, base, base_length, false);
+            fill_random(info, src, length, false);
+            for (size_t i = 0; i < length; i++) {
+                indices[i] = (int32_t)(next_random() % base_length);
+            }
+
+            goo_vectorization_init(GOO_SIMD_SCALAR);
+            goo_vectorization_gather(base, base_length, indices, length, info->type, ref_buf);
+            FOR_EACH_HOST_LEVEL(l) {
+                goo_vectorization_init(levels[l].level);
+                goo_vectorization_gather(base, base_length, indices, length, info->type, out_buf);
+                if (!results_match(info, ref_buf, out_buf, length, "gather", levels[l].name, length)) {
+                    return false;
+                }
+            }
+
+            // Duplicate indices are likely; the highest source index wins
+            memcpy(ref_buf, base, base_length * info->size);
+            goo_vectorization_init(GOO_SIMD_SCALAR);
+            goo_vectorization_scatter(src, indices, length, info->type, ref_buf, base_length);
+            FOR_EACH_HOST_LEVEL(l) {
+                memcpy(out_buf, base, base_length * info->size);
+                goo_vectorization_init(levels[l].level);
+                goo_vectorization_scatter(src, indices, length, info->type, out_buf, base_length);
+                if (!results_match(info, ref_buf, out_buf, base_length, "scatter",
+                                   levels[l].name, length)) {
+                    return false;
+                }
+            }
+        }
+
+        // One bad index fails the whole call before anything is written
+        size_t length = 100;
+        for (size_t i = 0; i < length; i++) indices[i] = (int32_t)i;
+        indices[63] = (t & 1) ? -1 : (int32_t)length;
+        FOR_EACH_HOST_LEVEL(l) {
+            goo_vectorization_init(levels[l].level);
+            memset(out_buf, 0x5a, length * info->size);
+            if (goo_vectorization_gather(base, length, indices, length, info->type, out_buf) ||
+                goo_vectorization_scatter(src, indices, length, info->type, out_buf, length)) {
+                fprintf(stderr, "%s %s gather/scatter accepted an out-of-bounds index\n",
+                        levels[l].name, info->name);
+                return false;
+            }
+            for (size_t i = 0; i < length * info->size; i++) {
+                if (out_buf[i] != 0x5a) {
+                    fprintf(stderr, "%s %s gather/scatter wrote despite a bad index\n",
+                            levels[l].name, info->name);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Buffers at any element-aligned offset from a vector boundary, and in-place
+// operation (dst == src1). The scalar path reads typed elements, so offsets
+// stay multiples of the element size
+static bool test_unaligned_and_in_place(void) {
+    printf("Testing unaligned and in-place operation against scalar...\n");
+    static const GooVectorOp ops[] = {
+        GOO_VECTOR_ADD, GOO_VECTOR_SUB, GOO_VECTOR_MUL, GOO_VECTOR_DIV, GOO_VECTOR_FMA
+    };
+    static unsigned char a_buf[MAX_LENGTH * 8 + 64], b_buf[MAX_LENGTH * 8 + 64];
+    static unsigned char init[MAX_LENGTH * 8];
+
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        const TypeInfo* info = &types[t];
+        for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+            if (ops[o] == GOO_VECTOR_FMA && !is_float_type(info->type)) continue;
+
+            for (int iteration = 0; iteration < LENGTH_ITERATIONS; iteration++) {
+                size_t length = test_length(iteration);
+                size_t element_mask = ~(info->size - 1);
+                unsigned char* a = a_buf + (next_random() % 64 & element_mask);
+                unsigned char* b = b_buf + (next_random() % 64 & element_mask);
+                size_t dst_offset = next_random() % 64 & element_mask;
+                bool in_place = (iteration & 1) != 0;
+
+                fill_random(info, a, length, false);
+                fill_random(info, b, length, ops[o] == GOO_VECTOR_DIV);
+                if (in_place) {
+                    memcpy(init, a, length * info->size);
+                } else {
+                    fill_random(info, init, length, false);
+                }
+                if (!compare_levels_at(info, ops[o], a, b, init, length, dst_offset, in_place)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Runtime detection must match the compiler's CPU probe, which also checks
+// that the OS saves the wider register state
+static bool test_runtime_detection(void) {
+    printf("Testing runtime SIMD detection...\n");
+
+    if (goo_vectorization_detect_simd() != host_level) {
+        fprintf(stderr, "SIMD detection is not stable across calls\n");
+        return false;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    GooSIMDType expected = GOO_SIMD_SCALAR;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        expected = GOO_SIMD_AVX512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        expected = GOO_SIMD_AVX2;
+    } else if (__builtin_cpu_supports("avx")) {
+        expected = GOO_SIMD_AVX;
+    } else if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sse4.2")) {
+        expected = GOO_SIMD_SSE4;
+    } else if (__builtin_cpu_supports("sse2")) {
+        expected = GOO_SIMD_SSE2;
+    }
+    if (host_level != expected) {
+        fprintf(stderr, "Detected SIMD level %d, CPU probe says %d\n", host_level, expected);
+        return false;
+    }
+#elif defined(__aarch64__)
+    if (host_level != GOO_SIMD_NEON) {
+        fprintf(stderr, "Detected SIMD level %d on AArch64, expected NEON\n", host_level);
+        return false;
+    }
+#endif
+    return true;
+}
+
+int main(void) {
+    int failed = 0;
+
+    goo_vectorization_init(GOO_SIMD_AUTO);
+    host_level = goo_vectorization_detect_simd();
+    printf("Host SIMD level: %d\n", host_level);
+
+    if (!test_runtime_detection()) failed++;
+    if (!test_elementwise_ops()) failed++;
+    if (!test_guarded_division()) failed++;
+    if (!test_unaligned_and_in_place()) failed++;
+    if (!test_reductions()) failed++;
+    if (!test_fma()) failed++;
+    if (!test_compare_and_blend()) failed++;
+    if (!test_gather_scatter()) failed++;
+    goo_vectorization_init(GOO_SIMD_AUTO);
+
+    if (failed) {
+        printf("%d vectorization test(s) failed\n", failed);
+        return 1;
+    }
+    printf("All vectorization tests passed\n");
+    return 0;
+}